@@ -0,0 +1,1153 @@
+/*****************************************************************************
+*
+* (C) Copyright Broadcom Corporation 2015
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+*
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "configure_bst_thresholds.h"
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+#include "get_bst_tracking.h"
+#include "get_bst_feature.h"
+#include "get_bst_thresholds.h"
+#include "get_bst_report.h"
+#include "get_bst_history.h"
+#include "bst_json_encoder.h"
+#include "bst_json_memory.h"
+#include "bst_json_emitter.h"
+#include "bst_cbor_encoder.h"
+#include "bst.h"
+#include "broadview.h"
+#include "bst_app.h"
+
+/* size of the buffer the cells are formatted into */
+#define _BSTBENCH_CELL_BUFFER_SIZE      (4 * 1024 * 1024)
+
+/* a cell of the ingress-port-priority-group realm, as the encoder used to format it */
+#define _BSTBENCH_CELL_TEMPLATE         " [  %d , %" PRIu64 " , %" PRIu64 " ] ,"
+
+/******************************************************************
+ * @brief  Time elapsed since 'start', in seconds
+ *********************************************************************/
+
+static double bench_elapsed(const struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - start->tv_sec) +
+           (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/******************************************************************
+ * @brief  Capabilities of a fully populated switch, every realm at the
+ *         limits the agent is built with
+ *********************************************************************/
+
+static void bench_asic_init(BVIEW_ASIC_CAPABILITIES_t *asic)
+{
+    memset(asic, 0, sizeof (BVIEW_ASIC_CAPABILITIES_t));
+    asic->numPorts = BVIEW_ASIC_MAX_PORTS;
+    asic->numPriorityGroups = BVIEW_ASIC_MAX_PRIORITY_GROUPS;
+    asic->numServicePools = BVIEW_ASIC_MAX_SERVICE_POOLS;
+    asic->numCommonPools = BVIEW_ASIC_MAX_COMMON_POOLS;
+    asic->numUnicastQueues = BVIEW_ASIC_MAX_UC_QUEUES;
+    asic->numUnicastQueueGroups = BVIEW_ASIC_MAX_UC_QUEUE_GROUPS;
+    asic->numMulticastQueues = BVIEW_ASIC_MAX_MC_QUEUES;
+    asic->numCpuQueues = BVIEW_ASIC_MAX_CPU_QUEUES;
+    asic->numRqeQueues = BVIEW_ASIC_MAX_RQE_QUEUES;
+    asic->cellToByteConv = 208;
+}
+
+/******************************************************************
+ * @brief  Fills every counter of a snapshot with a non zero value,
+ *         queues are spread over the ports
+ *********************************************************************/
+
+static void bench_snapshot_fill(BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                                const BVIEW_ASIC_CAPABILITIES_t *asic)
+{
+    const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout = snapshot->layout;
+    uint64_t *words = (uint64_t *) snapshot->data;
+    uint64_t seed = 88172645463325252ULL;
+    unsigned int i;
+
+    for (i = 0; i < layout->size / sizeof (uint64_t); i++)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        /* counters of a loaded switch, a few bytes up to a few megabytes */
+        words[i] = 1 + (seed % (1ULL << (4 + (seed >> 59))));
+    }
+
+    for (i = 0; i < layout->numUnicastQueues; i++)
+    {
+        BVIEW_BST_SNAPSHOT_EUCQ_DATA(snapshot, i)->port = 1 + (i / 8) % asic->numPorts;
+    }
+
+    for (i = 0; i < layout->numMulticastQueues; i++)
+    {
+        BVIEW_BST_SNAPSHOT_EMCQ_DATA(snapshot, i)->port = 1 + (i / 8) % asic->numPorts;
+    }
+}
+
+/* units the counters are reported in, as set with -u */
+typedef enum _bench_units_
+{
+    BSTBENCH_UNITS_BYTES = 0,
+    BSTBENCH_UNITS_CELLS,
+    BSTBENCH_UNITS_PERCENT
+} BSTBENCH_UNITS_t;
+
+static BSTBENCH_UNITS_t bench_units = BSTBENCH_UNITS_BYTES;
+
+/* entries of each realm the reports are limited to, as set with -k */
+static int bench_top_k = 0;
+
+/* reciprocals of the max buffers of the reports in percent */
+static BSTJSON_MAX_BUF_RECIPROCALS_t bench_reciprocals;
+
+/* where a streamed report goes */
+typedef struct _bench_stream_
+{
+    FILE *fp;
+    size_t bytes;
+    unsigned int windows;
+    struct timespec start;
+    /* seconds till the first window is out */
+    double first;
+} BENCH_STREAM_t;
+
+/******************************************************************
+ * @brief  Report options asking for every realm
+ *********************************************************************/
+
+static void bench_options_init(BSTJSON_REPORT_OPTIONS_t *options,
+                               BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBuffers,
+                               const BSTJSON_NOTATION_t *notation)
+{
+    memset(options, 0, sizeof (BSTJSON_REPORT_OPTIONS_t));
+    options->includeDevice = true;
+    options->includeIngressPortPriorityGroup = true;
+    options->includeIngressPortServicePool = true;
+    options->includeIngressServicePool = true;
+    options->includeEgressPortServicePool = true;
+    options->includeEgressServicePool = true;
+    options->includeEgressUcQueue = true;
+    options->includeEgressUcQueueGroup = true;
+    options->includeEgressMcQueue = true;
+    options->includeEgressCpuQueue = true;
+    options->includeEgressRqeQueue = true;
+    options->bst_max_buffers_ptr = maxBuffers;
+    options->notation = notation;
+    options->filter.topK = bench_top_k;
+
+    if (BSTBENCH_UNITS_CELLS == bench_units)
+    {
+        options->statUnitsInCells = true;
+    }
+    else if (BSTBENCH_UNITS_PERCENT == bench_units)
+    {
+        uint64_t *words = (uint64_t *) maxBuffers;
+        unsigned int i;
+
+        /* the same limit for a run of entries, as configured on most switches */
+        for (i = 0; i < sizeof (BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t) / sizeof (uint64_t); i++)
+        {
+            words[i] = (1ULL << 20) * (1 + (i / 64) % 4);
+        }
+        options->statsInPercentage = true;
+
+        /* as the agent does whenever it reads the max buffers */
+        bstjson_max_buf_reciprocals_update(maxBuffers, &bench_reciprocals);
+        options->bst_max_buffers_reciprocals = &bench_reciprocals;
+    }
+}
+
+/******************************************************************
+ * @brief  Encodes full "get-bst-report" responses of the snapshot and
+ *         prints the output rate
+ *********************************************************************/
+
+static int bench_report(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                        const BVIEW_ASIC_CAPABILITIES_t *asic,
+                        const BSTJSON_NOTATION_t *notation,
+                        unsigned int iterations, const char *dumpFile)
+{
+    BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBuffers;
+    BSTJSON_REPORT_OPTIONS_t options;
+    BVIEW_TIME_t reportTime = 1442000000;
+    struct timespec start;
+    uint8_t *json = NULL;
+    size_t bytes = 0, total = 0;
+    unsigned int i;
+    double secs;
+    FILE *fp;
+
+    maxBuffers = calloc(1, sizeof (BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t));
+    if (NULL == maxBuffers)
+        return 1;
+
+    bench_options_init(&options, maxBuffers, notation);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations; i++)
+    {
+        if (BVIEW_STATUS_SUCCESS != bstjson_encode_get_bst_report(0, 1, NULL, snapshot, &options,
+                                                                  asic, &reportTime, &json))
+        {
+            fprintf(stderr, "report could not be encoded \n");
+            free(maxBuffers);
+            return 1;
+        }
+        bytes = strlen((char *) json);
+        total += bytes;
+
+        if ((i + 1 < iterations) || (NULL == dumpFile))
+            bstjson_memory_free(json);
+    }
+    secs = bench_elapsed(&start);
+
+    printf("full report  : %zu bytes, %u reports in %.3f s, %.1f MB/s \n",
+           bytes, iterations, secs, (double) total / secs / 1e6);
+
+    if (NULL != dumpFile)
+    {
+        fp = fopen(dumpFile, "w");
+        if (NULL != fp)
+        {
+            fwrite(json, 1, bytes, fp);
+            fclose(fp);
+        }
+        bstjson_memory_free(json);
+    }
+
+    free(maxBuffers);
+    return 0;
+}
+
+/******************************************************************
+ * @brief  Takes a window of a streamed report
+ *********************************************************************/
+
+static BVIEW_STATUS bench_stream_flush(void *cookie, const char *data, int length)
+{
+    BENCH_STREAM_t *stream = (BENCH_STREAM_t *) cookie;
+
+    if (0 == stream->windows)
+        stream->first = bench_elapsed(&stream->start);
+
+    stream->windows++;
+    stream->bytes += length;
+
+    if ((NULL != stream->fp) && ((size_t) length != fwrite(data, 1, length, stream->fp)))
+        return BVIEW_STATUS_FAILURE;
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Streams full "get-bst-report" responses of the snapshot and
+ *         prints the output rate and how soon the first window is out
+ *********************************************************************/
+
+static int bench_stream(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                        const BVIEW_ASIC_CAPABILITIES_t *asic,
+                        const BSTJSON_NOTATION_t *notation,
+                        unsigned int iterations, const char *dumpFile)
+{
+    BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBuffers;
+    BSTJSON_REPORT_OPTIONS_t options;
+    BVIEW_TIME_t reportTime = 1442000000;
+    BENCH_STREAM_t stream;
+    struct timespec start;
+    size_t total = 0;
+    double first = 0, secs;
+    unsigned int i;
+    BVIEW_STATUS rv;
+
+    maxBuffers = calloc(1, sizeof (BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t));
+    if (NULL == maxBuffers)
+        return 1;
+
+    bench_options_init(&options, maxBuffers, notation);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations; i++)
+    {
+        memset(&stream, 0, sizeof (stream));
+        if ((i + 1 == iterations) && (NULL != dumpFile))
+            stream.fp = fopen(dumpFile, "w");
+        clock_gettime(CLOCK_MONOTONIC, &stream.start);
+
+        rv = bstjson_encode_get_bst_report_stream(0, 1, NULL, snapshot, &options, asic,
+                                                  &reportTime, bench_stream_flush, &stream);
+        if (NULL != stream.fp)
+            fclose(stream.fp);
+
+        if (BVIEW_STATUS_SUCCESS != rv)
+        {
+            fprintf(stderr, "report could not be streamed \n");
+            free(maxBuffers);
+            return 1;
+        }
+        total += stream.bytes;
+        first += stream.first;
+    }
+    secs = bench_elapsed(&start);
+
+    printf("streamed     : %zu bytes in %u windows, %.1f MB/s, first window after %.1f us \n",
+           stream.bytes, stream.windows, (double) total / secs / 1e6,
+           first / iterations * 1e6);
+
+    free(maxBuffers);
+    return 0;
+}
+
+/******************************************************************
+ * @brief  Sets up a previous snapshot which differs from 'snapshot' in
+ *         'changes' counters spread over the realms
+ *
+ * @retval   the counters of the previous snapshot, to be freed
+ *********************************************************************/
+
+static uint64_t *bench_snapshot_previous(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                                         unsigned int changes,
+                                         BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous)
+{
+    const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout = snapshot->layout;
+    uint64_t seed = 2463534242ULL;
+    unsigned int numWords = layout->size / sizeof (uint64_t);
+    uint64_t *words;
+    unsigned int i;
+
+    words = malloc(layout->size);
+    if (NULL == words)
+        return NULL;
+
+    memcpy(words, snapshot->data, layout->size);
+    for (i = 0; i < changes; i++)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        words[seed % numWords] += 1 + i;
+    }
+    previous->layout = layout;
+    previous->data = (uint8_t *) words;
+
+    return words;
+}
+
+/******************************************************************
+ * @brief  Encodes incremental "get-bst-report" responses, against a
+ *         previous snapshot in which 'changes' counters differ, and
+ *         prints the time per report
+ *********************************************************************/
+
+static int bench_incremental(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                             const BVIEW_ASIC_CAPABILITIES_t *asic,
+                             const BSTJSON_NOTATION_t *notation,
+                             unsigned int iterations, unsigned int changes,
+                             const char *dumpFile)
+{
+    BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBuffers;
+    BVIEW_BST_ASIC_SNAPSHOT_DATA_t previous;
+    BSTJSON_REPORT_OPTIONS_t options;
+    BVIEW_TIME_t reportTime = 1442000000;
+    struct timespec start;
+    uint8_t *json = NULL;
+    uint64_t *words;
+    size_t bytes = 0;
+    unsigned int i;
+    double secs;
+    FILE *fp;
+
+    maxBuffers = calloc(1, sizeof (BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t));
+    words = bench_snapshot_previous(snapshot, changes, &previous);
+    if ((NULL == maxBuffers) || (NULL == words))
+    {
+        free(maxBuffers);
+        free(words);
+        return 1;
+    }
+
+    bench_options_init(&options, maxBuffers, notation);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations; i++)
+    {
+        if (BVIEW_STATUS_SUCCESS != bstjson_encode_get_bst_report(0, 1, &previous, snapshot, &options,
+                                                                  asic, &reportTime, &json))
+        {
+            fprintf(stderr, "incremental report could not be encoded \n");
+            free(maxBuffers);
+            free(words);
+            return 1;
+        }
+        bytes = strlen((char *) json);
+
+        if ((i + 1 < iterations) || (NULL == dumpFile))
+            bstjson_memory_free(json);
+    }
+    secs = bench_elapsed(&start);
+
+    printf("incremental  : %u counters changed, %zu bytes, %.1f us per report \n",
+           changes, bytes, secs / iterations * 1e6);
+
+    if (NULL != dumpFile)
+    {
+        fp = fopen(dumpFile, "w");
+        if (NULL != fp)
+        {
+            fwrite(json, 1, bytes, fp);
+            fclose(fp);
+        }
+        bstjson_memory_free(json);
+    }
+
+    free(maxBuffers);
+    free(words);
+    return 0;
+}
+
+/******************************************************************
+ * @brief  Converts the egress-uc-queue counters of the snapshot to the
+ *         units set with -u, a counter at a time and a realm at a time,
+ *         checks that both agree and prints the time per counter
+ *********************************************************************/
+
+static int bench_convert(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                         const BVIEW_ASIC_CAPABILITIES_t *asic,
+                         unsigned int iterations)
+{
+    const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout = snapshot->layout;
+    BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBuffers;
+    BVIEW_BST_ASIC_SNAPSHOT_DATA_t values;
+    BSTJSON_REPORT_OPTIONS_t options;
+    struct timespec start;
+    uint64_t value = 0, perCounter = 0, perRealm = 0;
+    double secsCounter, secsRealm;
+    unsigned int i, queue;
+    void *data = NULL;
+
+    if (BSTBENCH_UNITS_BYTES == bench_units)
+        return 0;
+
+    maxBuffers = calloc(1, sizeof (BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t));
+    if ((NULL == maxBuffers) ||
+        (0 != posix_memalign(&data, BVIEW_BST_SNAPSHOT_ALIGN, layout->size)))
+    {
+        free(maxBuffers);
+        return 1;
+    }
+    values.layout = layout;
+    values.data = data;
+
+    bench_options_init(&options, maxBuffers, NULL);
+    memset(&options.includeIngressPortPriorityGroup, 0,
+           sizeof (bool) * (&options.includeDevice - &options.includeIngressPortPriorityGroup));
+    options.includeEgressUcQueue = true;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations; i++)
+    {
+        for (queue = 0; queue < layout->numUnicastQueues; queue++)
+        {
+            value = BVIEW_BST_SNAPSHOT_EUCQ_DATA(snapshot, queue)->ucBufferCount;
+            bst_json_convert_data(&options, asic, &value, maxBuffers->eUcQ.data[queue].ucMaxBuf);
+            perCounter += value;
+        }
+    }
+    secsCounter = bench_elapsed(&start);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations; i++)
+    {
+        bstjson_convert_snapshot(snapshot, NULL, &options, asic, &values);
+        for (queue = 0; queue < layout->numUnicastQueues; queue++)
+        {
+            perRealm += BVIEW_BST_SNAPSHOT_EUCQ_DATA(&values, queue)->ucBufferCount;
+        }
+    }
+    secsRealm = bench_elapsed(&start);
+
+    printf("conversion   : %.2f ns per counter a counter at a time, %.2f ns a realm at a time%s \n",
+           secsCounter / iterations / layout->numUnicastQueues * 1e9,
+           secsRealm / iterations / layout->numUnicastQueues * 1e9,
+           (perCounter == perRealm) ? "" : ", MISMATCH");
+
+    free(maxBuffers);
+    free(data);
+    return (perCounter == perRealm) ? 0 : 1;
+}
+
+/******************************************************************
+ * @brief  Formats the ingress-port-priority-group cells of the snapshot
+ *         with snprintf() and with the emitter, checks that both produce
+ *         the same output and prints the output rates
+ *********************************************************************/
+
+static int bench_cells(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                       unsigned int iterations)
+{
+    const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout = snapshot->layout;
+    const BVIEW_BST_INGRESS_PORT_PG_ENTRY_t *entry;
+    struct timespec start;
+    char *formatted, *emitted;
+    int used[2] = { 0, 0 };
+    unsigned int i, port, pg;
+    int actLen, len;
+    char *dst;
+    double secs[2];
+
+    formatted = malloc(_BSTBENCH_CELL_BUFFER_SIZE);
+    emitted = malloc(_BSTBENCH_CELL_BUFFER_SIZE);
+    if ((NULL == formatted) || (NULL == emitted))
+    {
+        free(formatted);
+        free(emitted);
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations; i++)
+    {
+        dst = formatted;
+        len = _BSTBENCH_CELL_BUFFER_SIZE;
+        for (port = 0; port < layout->numPorts; port++)
+        {
+            for (pg = 0; pg < layout->numPriorityGroups; pg++)
+            {
+                entry = BVIEW_BST_SNAPSHOT_IPPG_DATA(snapshot, port, pg);
+                actLen = snprintf(dst, len, _BSTBENCH_CELL_TEMPLATE, pg,
+                                  entry->umShareBufferCount, entry->umHeadroomBufferCount);
+                dst += actLen;
+                len -= actLen;
+            }
+        }
+        used[0] = _BSTBENCH_CELL_BUFFER_SIZE - len;
+    }
+    secs[0] = bench_elapsed(&start);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations; i++)
+    {
+        dst = emitted;
+        len = _BSTBENCH_CELL_BUFFER_SIZE;
+        for (port = 0; port < layout->numPorts; port++)
+        {
+            for (pg = 0; pg < layout->numPriorityGroups; pg++)
+            {
+                entry = BVIEW_BST_SNAPSHOT_IPPG_DATA(snapshot, port, pg);
+                actLen = bstjson_emit_literal(dst, len, " [  ", 4);
+                actLen += bstjson_emit_int(dst + actLen, len - actLen, pg);
+                actLen += bstjson_emit_literal(dst + actLen, len - actLen, " , ", 3);
+                actLen += bstjson_emit_u64(dst + actLen, len - actLen, entry->umShareBufferCount);
+                actLen += bstjson_emit_literal(dst + actLen, len - actLen, " , ", 3);
+                actLen += bstjson_emit_u64(dst + actLen, len - actLen, entry->umHeadroomBufferCount);
+                actLen += bstjson_emit_literal(dst + actLen, len - actLen, " ] ,", 4);
+                dst += actLen;
+                len -= actLen;
+            }
+        }
+        used[1] = _BSTBENCH_CELL_BUFFER_SIZE - len;
+    }
+    secs[1] = bench_elapsed(&start);
+
+    if ((used[0] != used[1]) || (0 != memcmp(formatted, emitted, used[0])))
+    {
+        fprintf(stderr, "emitter output differs from snprintf() output \n");
+        free(formatted);
+        free(emitted);
+        return 1;
+    }
+
+    printf("ippg cells   : %d bytes, snprintf %.1f MB/s, emitter %.1f MB/s \n", used[0],
+           (double) used[0] * iterations / secs[0] / 1e6,
+           (double) used[1] * iterations / secs[1] / 1e6);
+
+    free(formatted);
+    free(emitted);
+    return 0;
+}
+
+/* the values of a report, one per line, to compare a JSON and a CBOR
+   report without minding how either lays them out */
+typedef struct _bench_values_
+{
+    char *buf;
+    size_t len;
+    size_t size;
+} BENCH_VALUES_t;
+
+/* what a CBOR item is to the report */
+typedef enum _bench_cbor_item_
+{
+    BENCH_CBOR_VALUE = 0,
+    BENCH_CBOR_REPORT,
+    BENCH_CBOR_REALM_DATA,
+    BENCH_CBOR_REALM_ID
+} BENCH_CBOR_ITEM_t;
+
+/* where a streamed CBOR report is gathered */
+typedef struct _bench_capture_
+{
+    uint8_t *buf;
+    size_t len;
+    size_t size;
+} BENCH_CAPTURE_t;
+
+/******************************************************************
+ * @brief  Appends a value to the values of a report
+ *********************************************************************/
+
+static int bench_values_add(BENCH_VALUES_t *values, const char *str, size_t len)
+{
+    if (values->len + len + 1 > values->size)
+        return 1;
+
+    memcpy(values->buf + values->len, str, len);
+    values->len += len;
+    values->buf[values->len++] = '\n';
+    return 0;
+}
+
+/******************************************************************
+ * @brief  Takes the values of a JSON report, the strings and numbers
+ *         which are not keys, "jsonrpc" aside
+ *********************************************************************/
+
+static int bench_json_values(const char *json, BENCH_VALUES_t *values)
+{
+    const char *p = json, *start, *next;
+    bool skip = false;
+
+    while ('\0' != *p)
+    {
+        if ('"' == *p)
+        {
+            start = ++p;
+            while (('\0' != *p) && ('"' != *p))
+                p++;
+            if ('\0' == *p)
+                return 1;
+
+            for (next = p + 1; ' ' == *next; next++)
+                ;
+            if (':' == *next)
+            {
+                /* a key, the version of the protocol is not in the CBOR report */
+                skip = ((p - start) == 7) && (0 == strncmp(start, "jsonrpc", 7));
+            }
+            else if (true == skip)
+            {
+                skip = false;
+            }
+            else if (0 != bench_values_add(values, start, p - start))
+            {
+                return 1;
+            }
+            p++;
+        }
+        else if (isdigit((unsigned char) *p))
+        {
+            start = p;
+            while (isdigit((unsigned char) *p) || ('.' == *p))
+                p++;
+            if (0 != bench_values_add(values, start, p - start))
+                return 1;
+        }
+        else
+        {
+            p++;
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************
+ * @brief  Takes the values of a CBOR item, realm ids by their name in
+ *         the JSON report
+ *********************************************************************/
+
+static int bench_cbor_values(const uint8_t **p, const uint8_t *end,
+                             BENCH_CBOR_ITEM_t item, BENCH_VALUES_t *values)
+{
+    char number[32];
+    const char *name;
+    unsigned int major, info, i;
+    uint64_t arg = 0, key = 0;
+
+    if (*p >= end)
+        return 1;
+
+    major = **p >> 5;
+    info = **p & 0x1F;
+    (*p)++;
+
+    if (31 == info)
+    {
+        if (BSTCBOR_MAJOR_ARRAY != major)
+            return 1;
+        for (i = 0; (*p < end) && (BSTCBOR_BREAK != **p); i++)
+        {
+            if (0 != bench_cbor_values(p, end,
+                                       (BENCH_CBOR_REPORT == item) ? BENCH_CBOR_REALM_DATA :
+                                       ((BENCH_CBOR_REALM_DATA == item) && (0 == i)) ?
+                                       BENCH_CBOR_REALM_ID : BENCH_CBOR_VALUE, values))
+                return 1;
+        }
+        if (*p >= end)
+            return 1;
+        (*p)++;
+        return 0;
+    }
+
+    if (info < 24)
+    {
+        arg = info;
+    }
+    else if (info <= 27)
+    {
+        if ((size_t) (end - *p) < (1U << (info - 24)))
+            return 1;
+        for (i = 0; i < (1U << (info - 24)); i++)
+            arg = (arg << 8) | *(*p)++;
+    }
+    else
+    {
+        return 1;
+    }
+
+    switch (major)
+    {
+        case BSTCBOR_MAJOR_UINT:
+            if (BENCH_CBOR_REALM_ID == item)
+            {
+                name = bstcbor_realm_name((BVIEW_BST_SNAPSHOT_REALM_t) arg);
+                return (NULL == name) ? 1 : bench_values_add(values, name, strlen(name));
+            }
+            snprintf(number, sizeof (number), "%" PRIu64, arg);
+            return bench_values_add(values, number, strlen(number));
+
+        case BSTCBOR_MAJOR_TEXT:
+            if ((uint64_t) (end - *p) < arg)
+                return 1;
+            *p += arg;
+            return bench_values_add(values, (const char *) (*p - arg), arg);
+
+        case BSTCBOR_MAJOR_ARRAY:
+            for (i = 0; i < arg; i++)
+            {
+                if (0 != bench_cbor_values(p, end,
+                                           ((BENCH_CBOR_REALM_DATA == item) && (0 == i)) ?
+                                           BENCH_CBOR_REALM_ID : BENCH_CBOR_VALUE, values))
+                    return 1;
+            }
+            return 0;
+
+        case BSTCBOR_MAJOR_MAP:
+            for (i = 0; i < arg; i++)
+            {
+                /* the keys are unsigned, none is a value */
+                if ((*p >= end) || ((**p >> 5) != BSTCBOR_MAJOR_UINT) || ((**p & 0x1F) >= 24))
+                    return 1;
+                key = *(*p)++ & 0x1F;
+                if (0 != bench_cbor_values(p, end,
+                                           (BSTCBOR_KEY_REPORT == key) ? BENCH_CBOR_REPORT :
+                                           (BSTCBOR_KEY_REALM == key) ? BENCH_CBOR_REALM_ID :
+                                           BENCH_CBOR_VALUE, values))
+                    return 1;
+            }
+            return 0;
+
+        default:
+            return 1;
+    }
+}
+
+/******************************************************************
+ * @brief  Checks that a CBOR report carries the values of a JSON
+ *         report, in the same order
+ *********************************************************************/
+
+static int bench_cbor_check(const char *json, const uint8_t *cbor, int length)
+{
+    BENCH_VALUES_t fromJson, fromCbor;
+    const uint8_t *p = cbor;
+    size_t size = strlen(json) + 1;
+    int rv = 1;
+
+    fromJson.buf = malloc(size);
+    fromCbor.buf = malloc(size);
+    fromJson.len = fromCbor.len = 0;
+    fromJson.size = fromCbor.size = size;
+
+    if ((NULL != fromJson.buf) && (NULL != fromCbor.buf) &&
+        (0 == bench_json_values(json, &fromJson)) &&
+        (0 == bench_cbor_values(&p, cbor + length, BENCH_CBOR_VALUE, &fromCbor)) &&
+        (p == cbor + length) &&
+        (fromJson.len == fromCbor.len) &&
+        (0 == memcmp(fromJson.buf, fromCbor.buf, fromJson.len)))
+    {
+        rv = 0;
+    }
+
+    free(fromJson.buf);
+    free(fromCbor.buf);
+    return rv;
+}
+
+/******************************************************************
+ * @brief  Gathers the windows of a streamed CBOR report
+ *********************************************************************/
+
+static BVIEW_STATUS bench_capture_flush(void *cookie, const char *data, int length)
+{
+    BENCH_CAPTURE_t *capture = (BENCH_CAPTURE_t *) cookie;
+
+    if (capture->len + length > capture->size)
+        return BVIEW_STATUS_FAILURE;
+
+    memcpy(capture->buf + capture->len, data, length);
+    capture->len += length;
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Encodes full "get-bst-report" responses of the snapshot in
+ *         CBOR, checks that full, incremental and streamed ones carry
+ *         what the JSON ones do and prints size and time of both
+ *********************************************************************/
+
+static int bench_cbor(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                      const BVIEW_ASIC_CAPABILITIES_t *asic,
+                      const BSTJSON_NOTATION_t *notation,
+                      unsigned int iterations, unsigned int changes,
+                      const char *dumpFile)
+{
+    BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBuffers;
+    BVIEW_BST_ASIC_SNAPSHOT_DATA_t previous;
+    BSTJSON_REPORT_OPTIONS_t options;
+    BVIEW_TIME_t reportTime = 1442000000;
+    BENCH_CAPTURE_t capture;
+    struct timespec start;
+    uint8_t *json = NULL, *cbor = NULL;
+    uint64_t *words;
+    size_t jsonBytes = 0;
+    int length = 0, rv = 1;
+    double secsJson, secsCbor;
+    unsigned int i;
+    FILE *fp;
+
+    memset(&capture, 0, sizeof (capture));
+    maxBuffers = calloc(1, sizeof (BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t));
+    words = bench_snapshot_previous(snapshot, changes, &previous);
+    if ((NULL == maxBuffers) || (NULL == words))
+        goto done;
+
+    bench_options_init(&options, maxBuffers, notation);
+
+    /* a full and an incremental report, in both formats */
+    for (i = 0; i < 2; i++)
+    {
+        if ((BVIEW_STATUS_SUCCESS != bstjson_encode_get_bst_report(0, 1, (0 == i) ? NULL : &previous,
+                                                                   snapshot, &options, asic,
+                                                                   &reportTime, &json)) ||
+            (BVIEW_STATUS_SUCCESS != bstcbor_encode_get_bst_report(0, 1, (0 == i) ? NULL : &previous,
+                                                                   snapshot, &options, asic,
+                                                                   &reportTime, &cbor, &length)))
+        {
+            fprintf(stderr, "report could not be encoded \n");
+            goto done;
+        }
+        if (0 != bench_cbor_check((char *) json, cbor, length))
+        {
+            fprintf(stderr, "%s cbor report differs from the json report \n",
+                    (0 == i) ? "full" : "incremental");
+            goto done;
+        }
+        if (0 == i)
+            jsonBytes = strlen((char *) json);
+        bstjson_memory_free(json);
+        bstjson_memory_free(cbor);
+        json = cbor = NULL;
+    }
+
+    /* a streamed report is the same as the one encoded at once */
+    if (BVIEW_STATUS_SUCCESS != bstcbor_encode_get_bst_report(0, 1, NULL, snapshot, &options, asic,
+                                                              &reportTime, &cbor, &length))
+        goto done;
+    capture.size = length;
+    capture.buf = malloc(capture.size);
+    if ((NULL == capture.buf) ||
+        (BVIEW_STATUS_SUCCESS != bstcbor_encode_get_bst_report_stream(0, 1, NULL, snapshot, &options,
+                                                                      asic, &reportTime,
+                                                                      bench_capture_flush, &capture)) ||
+        (capture.len != (size_t) length) || (0 != memcmp(capture.buf, cbor, length)))
+    {
+        fprintf(stderr, "streamed cbor report differs from the one encoded at once \n");
+        goto done;
+    }
+    bstjson_memory_free(cbor);
+    cbor = NULL;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations; i++)
+    {
+        if (BVIEW_STATUS_SUCCESS != bstjson_encode_get_bst_report(0, 1, NULL, snapshot, &options,
+                                                                  asic, &reportTime, &json))
+            goto done;
+        bstjson_memory_free(json);
+        json = NULL;
+    }
+    secsJson = bench_elapsed(&start);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < iterations; i++)
+    {
+        if (BVIEW_STATUS_SUCCESS != bstcbor_encode_get_bst_report(0, 1, NULL, snapshot, &options,
+                                                                  asic, &reportTime, &cbor, &length))
+            goto done;
+
+        if ((i + 1 < iterations) || (NULL == dumpFile))
+        {
+            bstjson_memory_free(cbor);
+            cbor = NULL;
+        }
+    }
+    secsCbor = bench_elapsed(&start);
+
+    printf("cbor report  : %d bytes, %.1f%% of the %zu bytes of json, %.1f us per report, "
+           "%.1f us for json \n", length, 100.0 * length / jsonBytes, jsonBytes,
+           secsCbor / iterations * 1e6, secsJson / iterations * 1e6);
+
+    if (NULL != dumpFile)
+    {
+        fp = fopen(dumpFile, "w");
+        if (NULL != fp)
+        {
+            fwrite(cbor, 1, length, fp);
+            fclose(fp);
+        }
+    }
+    rv = 0;
+
+done:
+    if (NULL != json)
+        bstjson_memory_free(json);
+    if (NULL != cbor)
+        bstjson_memory_free(cbor);
+    free(capture.buf);
+    free(maxBuffers);
+    free(words);
+    return rv;
+}
+
+/******************************************************************
+ * @brief  Measures the rate the report encoders produce JSON at, for
+ *         a fully populated snapshot.
+ *
+ *         usage: bst_json_bench [-n iterations] [-o report.json]
+ *                               [-s stream.json] [-c changes]
+ *                               [-i incremental.json] [-t]
+ *                               [-u bytes|cells|percent]
+ *                               [-b report.cbor] [-p workers]
+ *                               [-k top-k]
+ *
+ *         -o writes the last report encoded, to compare the output of
+ *         two builds of the encoders. -s does the same for the last
+ *         report streamed, -i for the last incremental report and
+ *         -b for the last report encoded in CBOR. Each run checks that
+ *         the CBOR reports carry the values of the JSON ones.
+ *
+ *         -c sets the number of counters which differ between the
+ *         snapshots of the incremental reports (64 by default).
+ *
+ *         -u sets the units the counters are reported in.
+ *
+ *         -t encodes with the port notation rendered for the unit, as
+ *         the application does, instead of translating every port.
+ *
+ *         -p encodes the realms of the reports on that many workers,
+ *         besides the thread of the benchmark.
+ *
+ *         -k limits each realm of the reports to the entries of the
+ *         highest occupancy, as "top-k" does in "get-bst-report".
+ *
+ *********************************************************************/
+
+int main(int argc, char *argv[])
+{
+    BVIEW_ASIC_CAPABILITIES_t asic;
+    BVIEW_BST_SNAPSHOT_LAYOUT_t layout;
+    BVIEW_BST_REPORT_SNAPSHOT_t *record = NULL;
+    BSTJSON_NOTATION_t *notation = NULL;
+    const char *dumpFile = NULL;
+    const char *streamFile = NULL;
+    const char *incrementalFile = NULL;
+    const char *cborFile = NULL;
+    unsigned int changes = 64;
+    bool useNotation = false;
+    unsigned int iterations = 200;
+    int workers = 0;
+    int opt, rv;
+
+    while (-1 != (opt = getopt(argc, argv, "n:o:s:c:i:tu:b:p:k:")))
+    {
+        switch (opt)
+        {
+            case 'n':
+                iterations = (unsigned int) atoi(optarg);
+                break;
+            case 'o':
+                dumpFile = optarg;
+                break;
+            case 's':
+                streamFile = optarg;
+                break;
+            case 'c':
+                changes = (unsigned int) atoi(optarg);
+                break;
+            case 'i':
+                incrementalFile = optarg;
+                break;
+            case 'b':
+                cborFile = optarg;
+                break;
+            case 't':
+                useNotation = true;
+                break;
+            case 'p':
+                workers = atoi(optarg);
+                break;
+            case 'k':
+                bench_top_k = atoi(optarg);
+                break;
+            case 'u':
+                if (0 == strcmp(optarg, "cells"))
+                    bench_units = BSTBENCH_UNITS_CELLS;
+                else if (0 == strcmp(optarg, "percent"))
+                    bench_units = BSTBENCH_UNITS_PERCENT;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n iterations] [-o report.json] [-s stream.json] "
+                        "[-c changes] [-i incremental.json] [-t] [-u bytes|cells|percent] "
+                        "[-b report.cbor] [-p workers] [-k top-k] \n", argv[0]);
+                return 1;
+        }
+    }
+
+    if (0 == iterations)
+        iterations = 1;
+
+    bench_asic_init(&asic);
+    if ((BVIEW_STATUS_SUCCESS != bst_snapshot_layout_init(&asic, &layout)) ||
+        (BVIEW_STATUS_SUCCESS != bst_snapshot_alloc(0, &layout, &record)) ||
+        (BVIEW_STATUS_SUCCESS != bstjson_memory_init()) ||
+        (BVIEW_STATUS_SUCCESS != bstjson_parallel_init(workers)))
+    {
+        fprintf(stderr, "benchmark could not be set up \n");
+        return 1;
+    }
+
+    bench_snapshot_fill(&record->snapshot_data, &asic);
+
+    if (useNotation)
+    {
+        notation = calloc(1, sizeof (BSTJSON_NOTATION_t));
+        if ((NULL == notation) ||
+            (BVIEW_STATUS_SUCCESS != bstjson_notation_build(0, &asic, notation)))
+        {
+            fprintf(stderr, "port notation could not be rendered \n");
+            return 1;
+        }
+    }
+
+    printf("%d ports, %" PRIu64 " bytes of stats, %d workers \n", asic.numPorts,
+           (uint64_t) layout.size, workers);
+
+    rv = bench_report(&record->snapshot_data, &asic, notation, iterations, dumpFile);
+    if (0 == rv)
+        rv = bench_stream(&record->snapshot_data, &asic, notation, iterations, streamFile);
+    if (0 == rv)
+        rv = bench_incremental(&record->snapshot_data, &asic, notation, iterations, changes,
+                               incrementalFile);
+    if (0 == rv)
+        rv = bench_cbor(&record->snapshot_data, &asic, notation, iterations, changes, cborFile);
+    if (0 == rv)
+        rv = bench_convert(&record->snapshot_data, &asic, iterations);
+    if (0 == rv)
+        rv = bench_cells(&record->snapshot_data, iterations);
+
+    bstjson_parallel_deinit();
+    free(notation);
+    free(record->buffer);
+    free(record);
+    return rv;
+}
+
+/* The benchmark links the encoders of the bst application without the
+ * south bound plugin, whatever they call of it is provided here.
+ */
+
+BVIEW_STATUS sbapi_system_asic_translate_to_notation(int asic, char *asicStr)
+{
+    sprintf(asicStr, "%d", asic + 1);
+    return BVIEW_STATUS_SUCCESS;
+}
+
+BVIEW_STATUS sbapi_system_port_translate_to_notation(int asic, int port, char *portStr)
+{
+    sprintf(portStr, "%d", port);
+    return BVIEW_STATUS_SUCCESS;
+}
+
+BVIEW_STATUS sbapi_bst_snapshot_published_put(int asic,
+                                              const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot)
+{
+    return BVIEW_STATUS_UNSUPPORTED;
+}
+
+BVIEW_STATUS sbapi_bst_snapshot_published_get(int asic,
+                                              const BVIEW_BST_ASIC_SNAPSHOT_DATA_t **snapshot,
+                                              BVIEW_TIME_t *time)
+{
+    return BVIEW_STATUS_UNSUPPORTED;
+}
+
+BVIEW_STATUS sbapi_bst_snapshot_incremental_get(int asic, BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                                                BVIEW_TIME_t *time, uint64_t *generation)
+{
+    return BVIEW_STATUS_UNSUPPORTED;
+}
+
+BVIEW_STATUS sbapi_bst_snapshot_get(int asic, BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                                    BVIEW_TIME_t *time)
+{
+    return BVIEW_STATUS_UNSUPPORTED;
+}
@@ -0,0 +1,125 @@
+/*****************************************************************************
+*
+* (C) Copyright Broadcom Corporation 2015
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+*
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+
+#include "bst_shm_reader.h"
+
+/* realm of the device buffer count, see BVIEW_BST_SNAPSHOT_REALM_t */
+#define _BSTSHM_REALM_DEVICE    0
+
+/******************************************************************
+ * @brief  Reads the stats the agent publishes for a unit, once per
+ *         interval, without going through the REST server.
+ *
+ *         usage: bst_shm_example [unit] [interval in seconds]
+ *
+ *         The agent publishes them once bst_shm_publish is set to true
+ *         in its broadview config, and the reader must be in the group
+ *         of the agent.
+ *
+ *********************************************************************/
+
+int main(int argc, char *argv[])
+{
+    BST_SHM_READER_t reader;
+    const BVIEW_BST_SHM_LAYOUT_t *layout;
+    const uint8_t *data;
+    uint64_t *snapshot;
+    uint64_t generation = 0, lastGeneration = 0;
+    uint64_t deviceCount = 0;
+    time_t reportTime;
+    unsigned int i, nonZero;
+    uint32_t seq;
+    int unit = 0, interval = 1;
+    BVIEW_STATUS rv;
+
+    if (argc > 1)
+        unit = atoi(argv[1]);
+    if (argc > 2)
+        interval = atoi(argv[2]);
+
+    rv = bst_shm_reader_open(unit, &reader);
+    if (BVIEW_STATUS_SUCCESS != rv)
+    {
+        fprintf(stderr, "BST stats of unit %d are not published (%d) \n", unit, rv);
+        return 1;
+    }
+
+    layout = bst_shm_reader_layout(&reader);
+    printf("unit %d : %u ports, %" PRIu64 " bytes of stats \n", unit, layout->numPorts, layout->size);
+
+    snapshot = (uint64_t *) malloc(layout->size);
+    if (NULL == snapshot)
+    {
+        bst_shm_reader_close(&reader);
+        return 1;
+    }
+
+    while (1)
+    {
+        /* a single counter is read in place, without copying the snapshot */
+        do
+        {
+            data = bst_shm_reader_begin(&reader, &seq);
+            if (NULL == data)
+                break;
+            memcpy(&deviceCount, data + layout->offset[_BSTSHM_REALM_DEVICE], sizeof (deviceCount));
+        } while (bst_shm_reader_retry(&reader, seq));
+
+        /* the whole snapshot is copied to be looked at at leisure */
+        rv = bst_shm_reader_read(&reader, snapshot, &generation, &reportTime);
+        if (BVIEW_STATUS_FAILURE == rv)
+        {
+            /* the agent restarted, pick up its new region */
+            bst_shm_reader_close(&reader);
+            if (BVIEW_STATUS_SUCCESS != bst_shm_reader_open(unit, &reader))
+                break;
+            layout = bst_shm_reader_layout(&reader);
+            free(snapshot);
+            snapshot = (uint64_t *) malloc(layout->size);
+            if (NULL == snapshot)
+                break;
+            lastGeneration = 0;
+            continue;
+        }
+
+        if ((BVIEW_STATUS_SUCCESS == rv) && (generation != lastGeneration))
+        {
+            nonZero = 0;
+            for (i = 0; i < layout->size / sizeof (uint64_t); i++)
+            {
+                if (0 != snapshot[i])
+                    nonZero++;
+            }
+            printf("generation %" PRIu64 " at %s", generation, ctime(&reportTime));
+            printf("  device buffer count %" PRIu64 ", %u non zero counters \n", deviceCount, nonZero);
+            lastGeneration = generation;
+        }
+
+        sleep(interval);
+    }
+
+    free(snapshot);
+    bst_shm_reader_close(&reader);
+    return 0;
+}
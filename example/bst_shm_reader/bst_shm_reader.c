@@ -0,0 +1,226 @@
+/*****************************************************************************
+*
+* (C) Copyright Broadcom Corporation 2015
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+*
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+***************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "bst_shm_reader.h"
+
+/******************************************************************
+ * @brief  Maps the shared memory region of a unit
+ *
+ * @param[in]   unit        Unit whose stats are read
+ * @param[out]  reader      Reader of the region
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  region mapped
+ * @retval   BVIEW_STATUS_NOTREADY  the agent has not created the region
+ * @retval   BVIEW_STATUS_UNSUPPORTED  region of an other version
+ * @retval   BVIEW_STATUS_FAILURE  region can not be mapped
+ *
+ * @note     Release with bst_shm_reader_close().
+ *********************************************************************/
+
+BVIEW_STATUS bst_shm_reader_open(int unit, BST_SHM_READER_t *reader)
+{
+    char name[BVIEW_BST_SHM_NAME_MAX] = { 0 };
+    const BVIEW_BST_SHM_HEADER_t *header;
+    struct stat info;
+    void *map;
+    int fd;
+
+    if (NULL == reader)
+        return BVIEW_STATUS_INVALID_PARAMETER;
+
+    memset(reader, 0, sizeof (BST_SHM_READER_t));
+    snprintf(name, sizeof (name), BVIEW_BST_SHM_NAME_FORMAT, unit);
+
+    fd = shm_open(name, O_RDONLY, 0);
+    if (-1 == fd)
+        return (ENOENT == errno) ? BVIEW_STATUS_NOTREADY : BVIEW_STATUS_FAILURE;
+
+    if ((0 != fstat(fd, &info)) ||
+        (info.st_size < (off_t) sizeof (BVIEW_BST_SHM_HEADER_t)))
+    {
+        close(fd);
+        return BVIEW_STATUS_NOTREADY;
+    }
+
+    map = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == map)
+        return BVIEW_STATUS_FAILURE;
+
+    header = (const BVIEW_BST_SHM_HEADER_t *) map;
+
+    /* the descriptor is complete once the magic is there */
+    if (BVIEW_BST_SHM_MAGIC != __atomic_load_n(&header->magic, __ATOMIC_ACQUIRE))
+    {
+        munmap(map, (size_t) info.st_size);
+        return BVIEW_STATUS_NOTREADY;
+    }
+
+    if ((BVIEW_BST_SHM_VERSION != header->version) ||
+        (sizeof (BVIEW_BST_SHM_HEADER_t) != header->headerSize) ||
+        (header->dataOffset + header->layout.size > (uint64_t) info.st_size))
+    {
+        munmap(map, (size_t) info.st_size);
+        return BVIEW_STATUS_UNSUPPORTED;
+    }
+
+    reader->header = header;
+    reader->size = (size_t) info.st_size;
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Unmaps the region
+ *
+ * @param[in]   reader      Reader of the region
+ *
+ * @retval   none
+ *
+ * @note
+ *********************************************************************/
+
+void bst_shm_reader_close(BST_SHM_READER_t *reader)
+{
+    if ((NULL == reader) || (NULL == reader->header))
+        return;
+
+    munmap((void *) reader->header, reader->size);
+    memset(reader, 0, sizeof (BST_SHM_READER_t));
+}
+
+/******************************************************************
+ * @brief  Layout of the snapshot data of the region
+ *
+ * @param[in]   reader      Reader of the region
+ *
+ * @retval   layout descriptor of the region
+ *
+ * @note     The descriptor does not change while the region is mapped.
+ *********************************************************************/
+
+const BVIEW_BST_SHM_LAYOUT_t *bst_shm_reader_layout(const BST_SHM_READER_t *reader)
+{
+    return &reader->header->layout;
+}
+
+/******************************************************************
+ * @brief  Starts reading the snapshot data in place
+ *
+ * @param[in]   reader      Reader of the region
+ * @param[out]  seq         Sequence to hand to bst_shm_reader_retry()
+ *
+ * @retval   pointer to the snapshot data, NULL if the agent retired
+ *           the region and it has to be opened again
+ *
+ * @note     Waits while the agent publishes. Values read from the data
+ *           are only valid if bst_shm_reader_retry() returns false.
+ *********************************************************************/
+
+const uint8_t *bst_shm_reader_begin(const BST_SHM_READER_t *reader, uint32_t *seq)
+{
+    const BVIEW_BST_SHM_HEADER_t *header = reader->header;
+
+    while ((*seq = __atomic_load_n(&header->seq, __ATOMIC_ACQUIRE)) & 1)
+    {
+        sched_yield();
+    }
+
+    if (BVIEW_BST_SHM_MAGIC != __atomic_load_n(&header->magic, __ATOMIC_ACQUIRE))
+        return NULL;
+
+    return BVIEW_BST_SHM_DATA(header);
+}
+
+/******************************************************************
+ * @brief  Checks whether the data read since bst_shm_reader_begin()
+ *         has to be discarded and read again
+ *
+ * @param[in]   reader      Reader of the region
+ * @param[in]   seq         Sequence returned by bst_shm_reader_begin()
+ *
+ * @retval   true if the data read must be discarded
+ *
+ * @note
+ *********************************************************************/
+
+bool bst_shm_reader_retry(const BST_SHM_READER_t *reader, uint32_t seq)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return (__atomic_load_n(&reader->header->seq, __ATOMIC_RELAXED) != seq);
+}
+
+/******************************************************************
+ * @brief  Copies the latest snapshot of the region
+ *
+ * @param[in]   reader      Reader of the region
+ * @param[out]  data        Buffer of at least the layout size
+ * @param[out]  generation  Generation of the snapshot, may be NULL
+ * @param[out]  reportTime  Collection time of the snapshot, may be NULL
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  snapshot copied
+ * @retval   BVIEW_STATUS_NOTREADY  nothing published yet
+ * @retval   BVIEW_STATUS_FAILURE  region retired, open it again
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  invalid input parameter
+ *
+ * @note
+ *********************************************************************/
+
+BVIEW_STATUS bst_shm_reader_read(const BST_SHM_READER_t *reader, void *data,
+                                 uint64_t *generation, time_t *reportTime)
+{
+    const BVIEW_BST_SHM_HEADER_t *header;
+    const uint8_t *src;
+    uint64_t gen;
+    int64_t tv;
+    uint32_t seq;
+
+    if ((NULL == reader) || (NULL == reader->header) || (NULL == data))
+        return BVIEW_STATUS_INVALID_PARAMETER;
+
+    header = reader->header;
+
+    do
+    {
+        src = bst_shm_reader_begin(reader, &seq);
+        if (NULL == src)
+            return BVIEW_STATUS_FAILURE;
+
+        gen = header->generation;
+        tv = header->time;
+        memcpy(data, src, header->layout.size);
+    } while (bst_shm_reader_retry(reader, seq));
+
+    if (0 == gen)
+        return BVIEW_STATUS_NOTREADY;
+
+    if (NULL != generation)
+        *generation = gen;
+    if (NULL != reportTime)
+        *reportTime = (time_t) tv;
+
+    return BVIEW_STATUS_SUCCESS;
+}
@@ -0,0 +1,114 @@
+/*****************************************************************************
+*
+* (C) Copyright Broadcom Corporation 2015
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+*
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+***************************************************************************/
+
+#ifndef INCLUDE_BST_SHM_READER_H
+#define	INCLUDE_BST_SHM_READER_H
+
+#ifdef	__cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "broadview.h"
+#include "bst_shm.h"
+
+/* a mapped shared memory region of a unit */
+typedef struct _bst_shm_reader_
+{
+    const BVIEW_BST_SHM_HEADER_t *header;
+    /* size of the mapping */
+    size_t size;
+} BST_SHM_READER_t;
+
+/* Function Prototypes */
+
+/******************************************************************
+ * @brief  Maps the shared memory region of a unit
+ *
+ * @param[in]   unit        Unit whose stats are read
+ * @param[out]  reader      Reader of the region
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  region mapped
+ * @retval   BVIEW_STATUS_NOTREADY  the agent has not created the region
+ * @retval   BVIEW_STATUS_UNSUPPORTED  region of an other version
+ * @retval   BVIEW_STATUS_FAILURE  region can not be mapped
+ *
+ * @note     Release with bst_shm_reader_close().
+ *********************************************************************/
+BVIEW_STATUS bst_shm_reader_open(int unit, BST_SHM_READER_t *reader);
+
+/******************************************************************
+ * @brief  Unmaps the region
+ *
+ *********************************************************************/
+void bst_shm_reader_close(BST_SHM_READER_t *reader);
+
+/******************************************************************
+ * @brief  Layout of the snapshot data of the region
+ *
+ *********************************************************************/
+const BVIEW_BST_SHM_LAYOUT_t *bst_shm_reader_layout(const BST_SHM_READER_t *reader);
+
+/******************************************************************
+ * @brief  Starts reading the snapshot data in place
+ *
+ * @param[in]   reader      Reader of the region
+ * @param[out]  seq         Sequence to hand to bst_shm_reader_retry()
+ *
+ * @retval   pointer to the snapshot data, NULL if the agent retired
+ *           the region and it has to be opened again
+ *
+ * @note     Waits while the agent publishes. Values read from the data
+ *           are only valid if bst_shm_reader_retry() returns false.
+ *********************************************************************/
+const uint8_t *bst_shm_reader_begin(const BST_SHM_READER_t *reader, uint32_t *seq);
+
+/******************************************************************
+ * @brief  Checks whether the data read since bst_shm_reader_begin()
+ *         has to be discarded and read again
+ *
+ *********************************************************************/
+bool bst_shm_reader_retry(const BST_SHM_READER_t *reader, uint32_t seq);
+
+/******************************************************************
+ * @brief  Copies the latest snapshot of the region
+ *
+ * @param[in]   reader      Reader of the region
+ * @param[out]  data        Buffer of at least the layout size
+ * @param[out]  generation  Generation of the snapshot, may be NULL
+ * @param[out]  reportTime  Collection time of the snapshot, may be NULL
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  snapshot copied
+ * @retval   BVIEW_STATUS_NOTREADY  nothing published yet
+ * @retval   BVIEW_STATUS_FAILURE  region retired, open it again
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  invalid input parameter
+ *
+ *********************************************************************/
+BVIEW_STATUS bst_shm_reader_read(const BST_SHM_READER_t *reader, void *data,
+                                 uint64_t *generation, time_t *reportTime);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* INCLUDE_BST_SHM_READER_H */
@@ -0,0 +1,131 @@
+/*****************************************************************************
+*
+* (C) Copyright Broadcom Corporation 2015
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+*
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+
+#include "bst_udp_receiver.h"
+
+/* realm of the device buffer count, see BVIEW_BST_SNAPSHOT_REALM_t */
+#define _BSTUDP_REALM_DEVICE    0
+
+/* milli seconds between the lines printed */
+#define _BSTUDP_REPORT_INTERVAL 1000
+
+/******************************************************************
+ * @brief  Milli seconds of a monotonic clock
+ *
+ *********************************************************************/
+
+static uint64_t bst_udp_example_now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t) now.tv_sec * 1000) + ((uint64_t) now.tv_nsec / 1000000);
+}
+
+/******************************************************************
+ * @brief  Receives the datagrams the agent exports the stats of a
+ *         unit in, and reports once a second how many came in, how
+ *         many were lost and which realms are in sync.
+ *
+ *         usage: bst_udp_example [port] [unit]
+ *
+ *********************************************************************/
+
+int main(int argc, char *argv[])
+{
+    BST_UDP_RECEIVER_t *receiver;
+    BST_UDP_RECEIVER_STATS_t last;
+    const BST_UDP_RECEIVER_UNIT_t *ptr;
+    const uint64_t *device;
+    uint64_t datagrams, lost, next;
+    uint32_t counters;
+    unsigned int realm, synced;
+    int port = 9071, unit = 0;
+    BVIEW_STATUS rv;
+
+    if (argc > 1)
+        port = atoi(argv[1]);
+    if (argc > 2)
+        unit = atoi(argv[2]);
+
+    if ((0 > unit) || (BST_UDP_RECEIVER_MAX_UNITS <= unit))
+    {
+        fprintf(stderr, "unit %d is not received \n", unit);
+        return 1;
+    }
+
+    /* too large for the stack */
+    receiver = (BST_UDP_RECEIVER_t *) malloc(sizeof (BST_UDP_RECEIVER_t));
+    if (NULL == receiver)
+        return 1;
+
+    rv = bst_udp_receiver_open(port, receiver);
+    if (BVIEW_STATUS_SUCCESS != rv)
+    {
+        fprintf(stderr, "Failed to bind udp port %d (%d) \n", port, rv);
+        free(receiver);
+        return 1;
+    }
+    printf("receiving the stats of unit %d on udp port %d \n", unit, port);
+
+    memset(&last, 0, sizeof (last));
+    next = bst_udp_example_now() + _BSTUDP_REPORT_INTERVAL;
+    ptr = &receiver->unit[unit];
+
+    while (1)
+    {
+        rv = bst_udp_receiver_receive(receiver, _BSTUDP_REPORT_INTERVAL);
+        if (BVIEW_STATUS_FAILURE == rv)
+            break;
+
+        if (bst_udp_example_now() < next)
+            continue;
+        next += _BSTUDP_REPORT_INTERVAL;
+
+        synced = 0;
+        for (realm = 0; realm < BST_UDP_RECEIVER_MAX_REALMS; realm++)
+        {
+            if (NULL != bst_udp_receiver_realm(receiver, unit, realm, NULL))
+                synced++;
+        }
+
+        datagrams = receiver->stats.datagrams - last.datagrams;
+        lost = receiver->stats.lost - last.lost;
+        printf("sample %" PRIu32 " : %" PRIu64 " datagrams, %" PRIu64 " records, %"
+               PRIu64 " lost (%.2f%%), %" PRIu64 " late, %u realms in sync \n",
+               ptr->snapshot, datagrams, receiver->stats.records - last.records, lost,
+               (0 == datagrams + lost) ? 0.0 : (100.0 * lost) / (datagrams + lost),
+               receiver->stats.late - last.late, synced);
+
+        device = bst_udp_receiver_realm(receiver, unit, _BSTUDP_REALM_DEVICE, &counters);
+        if ((NULL != device) && (0 < counters))
+            printf("  device buffer count %" PRIu64 " \n", device[0]);
+
+        last = receiver->stats;
+    }
+
+    bst_udp_receiver_close(receiver);
+    free(receiver);
+    return 0;
+}
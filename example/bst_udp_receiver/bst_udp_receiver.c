@@ -0,0 +1,352 @@
+/*****************************************************************************
+*
+* (C) Copyright Broadcom Corporation 2015
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+*
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "bst_udp_receiver.h"
+
+/* datagrams further behind are from an agent which restarted */
+#define _BSTUDP_MAX_REORDER     1024
+
+/******************************************************************
+ * @brief  Converts a 64 bit value from network byte order
+ *
+ *********************************************************************/
+
+static uint64_t bst_udp_receiver_ntoh64(uint64_t value)
+{
+    if (1 == ntohl(1))
+        return value;
+    return (((uint64_t) ntohl((uint32_t) value)) << 32) | ntohl((uint32_t) (value >> 32));
+}
+
+/******************************************************************
+ * @brief  Binds a receiver to the port of the collector
+ *
+ * @param[in]   port        UDP port the agent exports to
+ * @param[out]  receiver    Receiver
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  receiver bound
+ * @retval   BVIEW_STATUS_FAILURE  port can not be bound
+ *
+ * @note     Release with bst_udp_receiver_close(). A port of 0 gives a
+ *           receiver without a socket, for bst_udp_receiver_apply().
+ *********************************************************************/
+
+BVIEW_STATUS bst_udp_receiver_open(int port, BST_UDP_RECEIVER_t *receiver)
+{
+    struct sockaddr_in addr;
+    int size = 4 * 1024 * 1024;
+
+    if (NULL == receiver)
+        return BVIEW_STATUS_INVALID_PARAMETER;
+
+    memset(receiver, 0, sizeof (BST_UDP_RECEIVER_t));
+    receiver->fd = -1;
+    if (0 == port)
+        return BVIEW_STATUS_SUCCESS;
+
+    receiver->fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (0 > receiver->fd)
+        return BVIEW_STATUS_FAILURE;
+
+    /* room for the bursts of a resync while the samples are looked at */
+    (void) setsockopt(receiver->fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof (size));
+
+    memset(&addr, 0, sizeof (addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((uint16_t) port);
+    if (0 != bind(receiver->fd, (struct sockaddr *) &addr, sizeof (addr)))
+    {
+        close(receiver->fd);
+        receiver->fd = -1;
+        return BVIEW_STATUS_FAILURE;
+    }
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Closes the receiver and frees the counters
+ *
+ * @param[in]   receiver    Receiver
+ *
+ * @retval   none
+ *
+ * @note
+ *********************************************************************/
+
+void bst_udp_receiver_close(BST_UDP_RECEIVER_t *receiver)
+{
+    int unit, realm;
+
+    if (NULL == receiver)
+        return;
+
+    for (unit = 0; unit < BST_UDP_RECEIVER_MAX_UNITS; unit++)
+    {
+        for (realm = 0; realm < BST_UDP_RECEIVER_MAX_REALMS; realm++)
+        {
+            free(receiver->unit[unit].realm[realm].values);
+        }
+    }
+    if (0 <= receiver->fd)
+        close(receiver->fd);
+
+    memset(receiver, 0, sizeof (BST_UDP_RECEIVER_t));
+    receiver->fd = -1;
+}
+
+/******************************************************************
+ * @brief  Waits for a datagram and applies it
+ *
+ * @param[in]   receiver    Receiver
+ * @param[in]   timeout     Milli seconds to wait at most
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  a datagram was applied or discarded
+ * @retval   BVIEW_STATUS_TIMEOUT  no datagram in time
+ * @retval   BVIEW_STATUS_FAILURE  the socket failed
+ *
+ * @note
+ *********************************************************************/
+
+BVIEW_STATUS bst_udp_receiver_receive(BST_UDP_RECEIVER_t *receiver, int timeout)
+{
+    struct pollfd pfd;
+    ssize_t length;
+    int ready;
+
+    if ((NULL == receiver) || (0 > receiver->fd))
+        return BVIEW_STATUS_INVALID_PARAMETER;
+
+    pfd.fd = receiver->fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    ready = poll(&pfd, 1, timeout);
+    if (0 == ready)
+        return BVIEW_STATUS_TIMEOUT;
+    if (0 > ready)
+        return (EINTR == errno) ? BVIEW_STATUS_TIMEOUT : BVIEW_STATUS_FAILURE;
+
+    length = recv(receiver->fd, receiver->buffer, sizeof (receiver->buffer), MSG_DONTWAIT);
+    if (0 > length)
+        return ((EAGAIN == errno) || (EINTR == errno)) ? BVIEW_STATUS_TIMEOUT : BVIEW_STATUS_FAILURE;
+
+    /* a datagram which is not valid is counted, the next one may be */
+    (void) bst_udp_receiver_apply(receiver, receiver->buffer, (size_t) length);
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Applies a datagram to the counters
+ *
+ * @param[in]   receiver    Receiver
+ * @param[in]   datagram    Datagram as received
+ * @param[in]   length      Length of the datagram
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  datagram applied, or discarded as late
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  datagram not valid
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  no room for the counters of the realm
+ *
+ * @note     A gap in the sequence of a unit takes its realms out of sync
+ *           until they are sent in full again. A realm is sent in full
+ *           from index 0 on, in datagrams flagged as resync, the last
+ *           of them flagged as the last one of the realm.
+ *********************************************************************/
+
+BVIEW_STATUS bst_udp_receiver_apply(BST_UDP_RECEIVER_t *receiver,
+                                    const void *datagram, size_t length)
+{
+    BVIEW_BST_UDP_HEADER_t header;
+    BVIEW_BST_UDP_RECORD_t record;
+    BST_UDP_RECEIVER_UNIT_t *unit;
+    BST_UDP_RECEIVER_REALM_t *realm;
+    const uint8_t *records;
+    uint32_t sequence, snapshot, counters, index, first = 0;
+    int32_t gap;
+    unsigned int i, count;
+
+    if ((NULL == receiver) || (NULL == datagram) ||
+        (length < sizeof (BVIEW_BST_UDP_HEADER_t)))
+    {
+        if (NULL != receiver)
+            receiver->stats.invalid++;
+        return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    memcpy(&header, datagram, sizeof (header));
+    records = (const uint8_t *) datagram + sizeof (header);
+    count = ntohs(header.records);
+    counters = ntohl(header.counters);
+
+    if ((BVIEW_BST_UDP_MAGIC != ntohl(header.magic)) ||
+        (BVIEW_BST_UDP_VERSION != header.version) ||
+        (BST_UDP_RECEIVER_MAX_UNITS <= header.unit) ||
+        (BST_UDP_RECEIVER_MAX_REALMS <= header.realm) ||
+        (length != sizeof (header) + (count * sizeof (BVIEW_BST_UDP_RECORD_t))))
+    {
+        receiver->stats.invalid++;
+        return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    /* every record must fit the realm before any of them is applied */
+    for (i = 0; i < count; i++)
+    {
+        memcpy(&record, records + (i * sizeof (record)), sizeof (record));
+        index = ntohl(record.index);
+        if (index >= counters)
+        {
+            receiver->stats.invalid++;
+            return BVIEW_STATUS_INVALID_PARAMETER;
+        }
+        if (0 == i)
+            first = index;
+    }
+
+    unit = &receiver->unit[header.unit];
+    realm = &unit->realm[header.realm];
+    sequence = ntohl(header.sequence);
+    snapshot = ntohl(header.snapshot);
+
+    if (true == unit->seen)
+    {
+        gap = (int32_t) (sequence - unit->sequence);
+        if (-_BSTUDP_MAX_REORDER > gap)
+        {
+            /* the sequence started over, nothing is known to be lost */
+            gap = 0;
+            for (i = 0; i < BST_UDP_RECEIVER_MAX_REALMS; i++)
+            {
+                unit->realm[i].synced = false;
+                unit->realm[i].resyncing = false;
+            }
+        }
+        else if (0 > gap)
+        {
+            /* a duplicate, or overtaken by newer values */
+            receiver->stats.late++;
+            return BVIEW_STATUS_SUCCESS;
+        }
+        if (0 < gap)
+        {
+            /* the lost datagrams may have been of any realm */
+            receiver->stats.lost += (uint64_t) gap;
+            for (i = 0; i < BST_UDP_RECEIVER_MAX_REALMS; i++)
+            {
+                unit->realm[i].synced = false;
+                unit->realm[i].resyncing = false;
+            }
+        }
+    }
+    unit->seen = true;
+    unit->sequence = sequence + 1;
+    unit->snapshot = snapshot;
+    unit->timestamp = bst_udp_receiver_ntoh64(header.timestamp);
+
+    if (realm->counters != counters)
+    {
+        /* first datagram of the realm, or the agent restarted */
+        free(realm->values);
+        realm->values = NULL;
+        realm->counters = 0;
+        realm->synced = false;
+        realm->resyncing = false;
+        if (0 != counters)
+        {
+            realm->values = (uint64_t *) calloc(counters, sizeof (uint64_t));
+            if (NULL == realm->values)
+                return BVIEW_STATUS_OUTOFMEMORY;
+        }
+        realm->counters = counters;
+    }
+
+    if (0 != (header.flags & BVIEW_BST_UDP_FLAG_RESYNC))
+    {
+        if ((0 < count) && (0 == first))
+        {
+            realm->resyncing = true;
+            realm->resyncSnapshot = snapshot;
+        }
+        else if (realm->resyncSnapshot != snapshot)
+        {
+            /* the start of this resync was missed */
+            realm->resyncing = false;
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        memcpy(&record, records + (i * sizeof (record)), sizeof (record));
+        realm->values[ntohl(record.index)] = bst_udp_receiver_ntoh64(record.value);
+    }
+    receiver->stats.datagrams++;
+    receiver->stats.records += count;
+
+    if ((0 != (header.flags & BVIEW_BST_UDP_FLAG_RESYNC)) &&
+        (0 != (header.flags & BVIEW_BST_UDP_FLAG_LAST)) &&
+        (true == realm->resyncing) && (realm->resyncSnapshot == snapshot))
+    {
+        realm->resyncing = false;
+        if (false == realm->synced)
+        {
+            realm->synced = true;
+            receiver->stats.resyncs++;
+        }
+    }
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Counters of a realm of a unit
+ *
+ * @param[in]   receiver    Receiver
+ * @param[in]   unit        Unit
+ * @param[in]   realm       Realm, see BVIEW_BST_SNAPSHOT_REALM_t
+ * @param[out]  counters    Number of counters of the realm
+ *
+ * @retval   the counters of the realm, NULL unless it is in sync
+ *
+ * @note
+ *********************************************************************/
+
+const uint64_t *bst_udp_receiver_realm(const BST_UDP_RECEIVER_t *receiver,
+                                       int unit, int realm, uint32_t *counters)
+{
+    const BST_UDP_RECEIVER_REALM_t *ptr;
+
+    if ((NULL == receiver) || (0 > unit) || (BST_UDP_RECEIVER_MAX_UNITS <= unit) ||
+        (0 > realm) || (BST_UDP_RECEIVER_MAX_REALMS <= realm))
+        return NULL;
+
+    ptr = &receiver->unit[unit].realm[realm];
+    if (false == ptr->synced)
+        return NULL;
+
+    if (NULL != counters)
+        *counters = ptr->counters;
+    return ptr->values;
+}
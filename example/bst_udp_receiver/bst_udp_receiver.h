@@ -0,0 +1,161 @@
+/*****************************************************************************
+*
+* (C) Copyright Broadcom Corporation 2015
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+*
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+***************************************************************************/
+
+#ifndef INCLUDE_BST_UDP_RECEIVER_H
+#define	INCLUDE_BST_UDP_RECEIVER_H
+
+#ifdef	__cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "broadview.h"
+#include "bst_udp.h"
+
+/* units and realms the datagrams are reassembled for */
+#define BST_UDP_RECEIVER_MAX_UNITS      8
+#define BST_UDP_RECEIVER_MAX_REALMS     16
+
+/* largest datagram taken */
+#define BST_UDP_RECEIVER_MAX_DATAGRAM   65536
+
+/* counters of a realm as the datagrams left them */
+typedef struct _bst_udp_receiver_realm_
+{
+    uint64_t *values;
+    uint32_t counters;
+    /* every counter is known and no datagram was lost since */
+    bool synced;
+    /* a resync of the realm is being received, for this sample */
+    bool resyncing;
+    uint32_t resyncSnapshot;
+} BST_UDP_RECEIVER_REALM_t;
+
+/* datagrams of a unit */
+typedef struct _bst_udp_receiver_unit_
+{
+    /* a datagram of the unit was received */
+    bool seen;
+    /* sequence the next datagram is expected with */
+    uint32_t sequence;
+    /* sample of the last datagram, and its collection time */
+    uint32_t snapshot;
+    uint64_t timestamp;
+    BST_UDP_RECEIVER_REALM_t realm[BST_UDP_RECEIVER_MAX_REALMS];
+} BST_UDP_RECEIVER_UNIT_t;
+
+/* counters of a receiver */
+typedef struct _bst_udp_receiver_stats_
+{
+    uint64_t datagrams;
+    uint64_t records;
+    /* datagrams missing from the sequence */
+    uint64_t lost;
+    /* datagrams behind the sequence, discarded */
+    uint64_t late;
+    /* datagrams which are not valid */
+    uint64_t invalid;
+    /* realms brought back in sync */
+    uint64_t resyncs;
+} BST_UDP_RECEIVER_STATS_t;
+
+/* a receiver of the datagrams of the agent */
+typedef struct _bst_udp_receiver_
+{
+    /* socket bound to the port of the collector, -1 if none */
+    int fd;
+    BST_UDP_RECEIVER_UNIT_t unit[BST_UDP_RECEIVER_MAX_UNITS];
+    BST_UDP_RECEIVER_STATS_t stats;
+    uint8_t buffer[BST_UDP_RECEIVER_MAX_DATAGRAM];
+} BST_UDP_RECEIVER_t;
+
+/* Function Prototypes */
+
+/******************************************************************
+ * @brief  Binds a receiver to the port of the collector
+ *
+ * @param[in]   port        UDP port the agent exports to
+ * @param[out]  receiver    Receiver
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  receiver bound
+ * @retval   BVIEW_STATUS_FAILURE  port can not be bound
+ *
+ * @note     Release with bst_udp_receiver_close(). A port of 0 gives a
+ *           receiver without a socket, for bst_udp_receiver_apply().
+ *********************************************************************/
+BVIEW_STATUS bst_udp_receiver_open(int port, BST_UDP_RECEIVER_t *receiver);
+
+/******************************************************************
+ * @brief  Closes the receiver and frees the counters
+ *
+ *********************************************************************/
+void bst_udp_receiver_close(BST_UDP_RECEIVER_t *receiver);
+
+/******************************************************************
+ * @brief  Waits for a datagram and applies it
+ *
+ * @param[in]   receiver    Receiver
+ * @param[in]   timeout     Milli seconds to wait at most
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  a datagram was applied or discarded
+ * @retval   BVIEW_STATUS_TIMEOUT  no datagram in time
+ * @retval   BVIEW_STATUS_FAILURE  the socket failed
+ *
+ *********************************************************************/
+BVIEW_STATUS bst_udp_receiver_receive(BST_UDP_RECEIVER_t *receiver, int timeout);
+
+/******************************************************************
+ * @brief  Applies a datagram to the counters
+ *
+ * @param[in]   receiver    Receiver
+ * @param[in]   datagram    Datagram as received
+ * @param[in]   length      Length of the datagram
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  datagram applied, or discarded as late
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  datagram not valid
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  no room for the counters of the realm
+ *
+ * @note     A gap in the sequence of a unit takes its realms out of sync
+ *           until they are sent in full again.
+ *********************************************************************/
+BVIEW_STATUS bst_udp_receiver_apply(BST_UDP_RECEIVER_t *receiver,
+                                    const void *datagram, size_t length);
+
+/******************************************************************
+ * @brief  Counters of a realm of a unit
+ *
+ * @param[in]   receiver    Receiver
+ * @param[in]   unit        Unit
+ * @param[in]   realm       Realm, see BVIEW_BST_SNAPSHOT_REALM_t
+ * @param[out]  counters    Number of counters of the realm
+ *
+ * @retval   the counters of the realm, NULL unless it is in sync
+ *
+ *********************************************************************/
+const uint64_t *bst_udp_receiver_realm(const BST_UDP_RECEIVER_t *receiver,
+                                       int unit, int realm, uint32_t *counters);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* INCLUDE_BST_UDP_RECEIVER_H */
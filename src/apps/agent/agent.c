@@ -85,6 +85,15 @@ void broadview_debug_dump(struct ds *ds, int argc, const char *argv[])
   const char *bview_client_ip;
   int  bview_client_port = 0;
   int  agent_port = 0;
+  int  compression_level = 0;
+  int  compression_min_size = 0;
+  const char *async_encoding;
+  int  rest_workers = 0;
+  bool bst_shm_publish = false;
+  REST_QUEUE_STATS_t rest_stats;
+  REST_COLLECTOR_STATS_t collector_stats;
+  REST_EVENT_STATS_t event_stats;
+  int subscriber;
 #if BROADVIEW_ENABLE_FEATURE_SUPPORTED
   bool enabled = false;
 #endif
@@ -115,6 +124,26 @@ void broadview_debug_dump(struct ds *ds, int argc, const char *argv[])
 	SYSTEM_BROADVIEW_CONFIG_MAP_AGENT_PORT,
 	SYSTEM_CONFIG_PROPERTY_LOCAL_PORT_DEFAULT);
 
+    /* compression of the responses */
+    compression_level = smap_get_int(&(sys->broadview_config),
+	SYSTEM_CONFIG_PROPERTY_COMPRESSION_LEVEL,
+	SYSTEM_CONFIG_PROPERTY_COMPRESSION_LEVEL_DEFAULT);
+    compression_min_size = smap_get_int(&(sys->broadview_config),
+	SYSTEM_CONFIG_PROPERTY_COMPRESSION_MIN_SIZE,
+	SYSTEM_CONFIG_PROPERTY_COMPRESSION_MIN_SIZE_DEFAULT);
+    async_encoding = smap_get(&(sys->broadview_config),
+	SYSTEM_CONFIG_PROPERTY_ASYNC_ENCODING);
+    if (async_encoding == NULL)
+    {
+      async_encoding = SYSTEM_CONFIG_PROPERTY_ASYNC_ENCODING_DEFAULT;
+    }
+    rest_workers = smap_get_int(&(sys->broadview_config),
+	SYSTEM_CONFIG_PROPERTY_REST_WORKERS,
+	SYSTEM_CONFIG_PROPERTY_REST_WORKERS_DEFAULT);
+    bst_shm_publish = smap_get_bool(&(sys->broadview_config),
+	SYSTEM_CONFIG_PROPERTY_BST_SHM_PUBLISH,
+	SYSTEM_CONFIG_PROPERTY_BST_SHM_PUBLISH_DEFAULT);
+
     ds_put_format(ds, "BroadView Config Dump: \n" );
 #if BROADVIEW_ENABLE_FEATURE_SUPPORTED
     ds_put_format(ds, "   Enable: %s\n", ((enabled))?"true":"false");
@@ -122,6 +151,94 @@ void broadview_debug_dump(struct ds *ds, int argc, const char *argv[])
     ds_put_format(ds, "   Client ip: %s\n", bview_client_ip);
     ds_put_format(ds, "   Client port: %d\n", bview_client_port);
     ds_put_format(ds, "   Agent port: %d\n", agent_port);
+    ds_put_format(ds, "   Compression level: %d\n", compression_level);
+    ds_put_format(ds, "   Compression min size: %d\n", compression_min_size);
+    ds_put_format(ds, "   Async content encoding: %s\n", async_encoding);
+    ds_put_format(ds, "   REST workers: %d\n", rest_workers);
+    ds_put_format(ds, "   BST shared memory: %s\n", ((bst_shm_publish))?"true":"false");
+  }
+
+  /* where the REST requests wait */
+  if (BVIEW_STATUS_SUCCESS == rest_queue_stats_get(&rest_stats))
+  {
+    ds_put_format(ds, "BroadView REST Requests: \n" );
+    ds_put_format(ds, "   Workers: %d\n", rest_stats.workers);
+    ds_put_format(ds, "   Connections: %d\n", rest_stats.connections);
+    ds_put_format(ds, "   Connections with buffered input: %d\n", rest_stats.buffered);
+    ds_put_format(ds, "   Queued for a worker: %d (max %d)\n",
+	rest_stats.queued, rest_stats.queuedMax);
+    ds_put_format(ds, "   Being dispatched: %d\n", rest_stats.dispatching);
+    ds_put_format(ds, "   Waiting for an answer: %d\n", rest_stats.pending);
+    ds_put_format(ds, "   Requests: %llu\n", (unsigned long long) rest_stats.requests);
+    ds_put_format(ds, "   Wait for a worker: avg %llu us, max %llu us\n",
+	(unsigned long long) ((0 != rest_stats.requests) ?
+	  (rest_stats.waitTotal / rest_stats.requests) : 0),
+	(unsigned long long) rest_stats.waitMax);
+  }
+
+  /* the asynchronous reports and their connection to the collector */
+  if (BVIEW_STATUS_SUCCESS == rest_collector_stats_get(&collector_stats))
+  {
+    ds_put_format(ds, "BroadView Asynchronous Reports: \n" );
+    ds_put_format(ds, "   Collector connected: %s\n",
+	(collector_stats.connected) ? "true" : "false");
+    ds_put_format(ds, "   Reconnect backoff: %d ms\n", collector_stats.backoff);
+    ds_put_format(ds, "   Queued: %d (max %d), %d bytes\n", collector_stats.queued,
+	collector_stats.queuedMax, collector_stats.queuedBytes);
+    ds_put_format(ds, "   Posted: %llu, sent: %llu, %llu bytes\n",
+	(unsigned long long) collector_stats.posted,
+	(unsigned long long) collector_stats.sent,
+	(unsigned long long) collector_stats.bytes);
+    ds_put_format(ds, "   Dropped on a full queue: %llu\n",
+	(unsigned long long) collector_stats.dropped);
+    ds_put_format(ds, "   Dropped for an absent default collector: %llu\n",
+	(unsigned long long) collector_stats.discarded);
+    ds_put_format(ds, "   Replaced by a newer report of the same kind: %llu\n",
+	(unsigned long long) collector_stats.coalesced);
+    ds_put_format(ds, "   Connects: %llu, failed: %llu, closed by the collector: %llu, "
+	"failed sends: %llu\n",
+	(unsigned long long) collector_stats.connects,
+	(unsigned long long) collector_stats.connectFailures,
+	(unsigned long long) collector_stats.disconnects,
+	(unsigned long long) collector_stats.sendFailures);
+  }
+
+  /* the collectors subscribed to the periodic reports */
+  for (subscriber = 0; subscriber < BVIEW_REST_MAX_SUBSCRIBERS; subscriber++)
+  {
+    if (BVIEW_STATUS_SUCCESS != rest_subscriber_stats_get(subscriber, &collector_stats))
+    {
+      continue;
+    }
+    ds_put_format(ds, "BroadView Subscriber %d: \n", subscriber);
+    ds_put_format(ds, "   Collector connected: %s\n",
+	(collector_stats.connected) ? "true" : "false");
+    ds_put_format(ds, "   Queued: %d (max %d), %d bytes\n", collector_stats.queued,
+	collector_stats.queuedMax, collector_stats.queuedBytes);
+    ds_put_format(ds, "   Posted: %llu, sent: %llu, %llu bytes, dropped: %llu, "
+	"replaced: %llu\n",
+	(unsigned long long) collector_stats.posted,
+	(unsigned long long) collector_stats.sent,
+	(unsigned long long) collector_stats.bytes,
+	(unsigned long long) collector_stats.dropped,
+	(unsigned long long) collector_stats.coalesced);
+    ds_put_format(ds, "   Connects: %llu, failed: %llu\n",
+	(unsigned long long) collector_stats.connects,
+	(unsigned long long) collector_stats.connectFailures);
+  }
+
+  /* the clients streaming the reports as events */
+  if (BVIEW_STATUS_SUCCESS == rest_event_stats_get(&event_stats))
+  {
+    ds_put_format(ds, "BroadView Event Streams: \n" );
+    ds_put_format(ds, "   Streams: %d, opened: %llu, closed: %llu\n", event_stats.streams,
+	(unsigned long long) event_stats.opened,
+	(unsigned long long) event_stats.closed);
+    ds_put_format(ds, "   Events: %llu, queued: %llu, sent: %llu, dropped: %llu\n",
+	(unsigned long long) event_stats.posted,
+	(unsigned long long) event_stats.queued,
+	(unsigned long long) event_stats.sent,
+	(unsigned long long) event_stats.dropped);
   }
 }
 
@@ -172,6 +289,16 @@ static void update_broadview_config(const struct ovsrec_system *sys)
   bool client_ip_changed = false;
   bool client_port_changed = false;
   bool agent_port_changed = false;
+  int  compression_level = 0;
+  int  compression_min_size = 0;
+  char *async_encoding;
+  int  compression_level_curr = 0;
+  int  compression_min_size_curr = 0;
+  char async_encoding_curr[BVIEW_MAX_ENCODING_NAME_LENGTH] = {0};
+  int  rest_workers = 0;
+  int  rest_workers_curr = 0;
+  bool bst_shm_publish = false;
+  bool bst_shm_publish_curr = false;
 
 #if BROADVIEW_ENABLE_FEATURE_SUPPORTED
   bool enabled = false;
@@ -207,6 +334,30 @@ static void update_broadview_config(const struct ovsrec_system *sys)
 	SYSTEM_BROADVIEW_CONFIG_MAP_AGENT_PORT,
 	SYSTEM_CONFIG_PROPERTY_LOCAL_PORT_DEFAULT);
 
+    /* See if user set the compression of the responses */
+    compression_level = smap_get_int(&(sys->broadview_config),
+	SYSTEM_CONFIG_PROPERTY_COMPRESSION_LEVEL,
+	SYSTEM_CONFIG_PROPERTY_COMPRESSION_LEVEL_DEFAULT);
+    compression_min_size = smap_get_int(&(sys->broadview_config),
+	SYSTEM_CONFIG_PROPERTY_COMPRESSION_MIN_SIZE,
+	SYSTEM_CONFIG_PROPERTY_COMPRESSION_MIN_SIZE_DEFAULT);
+    async_encoding = (char *)smap_get(&(sys->broadview_config),
+	SYSTEM_CONFIG_PROPERTY_ASYNC_ENCODING);
+    if (async_encoding == NULL)
+    {
+      async_encoding = SYSTEM_CONFIG_PROPERTY_ASYNC_ENCODING_DEFAULT;
+    }
+
+    /* See if user set the number of workers of the REST requests */
+    rest_workers = smap_get_int(&(sys->broadview_config),
+	SYSTEM_CONFIG_PROPERTY_REST_WORKERS,
+	SYSTEM_CONFIG_PROPERTY_REST_WORKERS_DEFAULT);
+
+    /* See if user wants the BST stats published in shared memory */
+    bst_shm_publish = smap_get_bool(&(sys->broadview_config),
+	SYSTEM_CONFIG_PROPERTY_BST_SHM_PUBLISH,
+	SYSTEM_CONFIG_PROPERTY_BST_SHM_PUBLISH_DEFAULT);
+
     /* Check if the client ip is changed or not */ 
     if (strlen(bview_client_ip) < BVIEW_MAX_IP_ADDR_LENGTH) 
     { 
@@ -255,6 +406,40 @@ static void update_broadview_config(const struct ovsrec_system *sys)
     {
       rest_server_port_dynamic_update(agent_port);   
     }
+
+    /* Check if the compression is changed or not */
+    if (strlen(async_encoding) < BVIEW_MAX_ENCODING_NAME_LENGTH)
+    {
+      system_agent_compression_get(&compression_level_curr,
+	  &compression_min_size_curr, async_encoding_curr);
+      if ((compression_level != compression_level_curr) ||
+	  (compression_min_size != compression_min_size_curr) ||
+	  (strcmp(async_encoding, async_encoding_curr) != 0))
+      {
+	system_agent_compression_set(compression_level, compression_min_size,
+	    async_encoding);
+	rest_compression_config_modify(compression_level, compression_min_size,
+	    async_encoding);
+      }
+    }
+
+    /* Check if the number of workers is changed or not */
+    if ((1 <= rest_workers) && (REST_MAX_WORKERS >= rest_workers))
+    {
+      system_agent_rest_workers_get(&rest_workers_curr);
+      if (rest_workers != rest_workers_curr)
+      {
+	system_agent_rest_workers_set(rest_workers);
+	rest_workers_config_modify(rest_workers);
+      }
+    }
+
+    /* The BST app opens or removes the regions with its next collection */
+    system_agent_bst_shm_publish_get(&bst_shm_publish_curr);
+    if (bst_shm_publish != bst_shm_publish_curr)
+    {
+      system_agent_bst_shm_publish_set(bst_shm_publish);
+    }
   }
 }
 
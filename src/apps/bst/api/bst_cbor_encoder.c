@@ -0,0 +1,862 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <inttypes.h>
+
+#include "broadview.h"
+#include "cJSON.h"
+
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+
+#include "bst.h"
+
+#include "bst_json_memory.h"
+#include "bst_json_encoder.h"
+#include "bst_cbor_encoder.h"
+
+/* most counters a row has, the index aside */
+#define _BSTCBOR_MAX_COLUMNS            3
+
+/* no port in the entries of a realm */
+#define _BSTCBOR_NO_PORT                (-1)
+
+/* how the entries of a realm are reported, see bst_cbor_encoder.h */
+typedef struct _bst_cbor_realm_
+{
+    const char *name;
+    /* counters of an entry, in the order of the row */
+    int numColumns;
+    int columns[_BSTCBOR_MAX_COLUMNS];
+    /* counter of an entry which is the port of a queue */
+    int portColumn;
+    /* counters which leave an entry out of an incremental snapshot when
+       they are all zero, bit n for the n-th counter */
+    unsigned int zeroFields;
+} BSTCBOR_REALM_t;
+
+static const BSTCBOR_REALM_t _bstcbor_realms[BVIEW_BST_SNAPSHOT_REALM_MAX] = {
+    [BVIEW_BST_SNAPSHOT_DEVICE] = { "device", 1, { 0 }, _BSTCBOR_NO_PORT, 0x1 },
+    [BVIEW_BST_SNAPSHOT_IPPG] = { "ingress-port-priority-group", 2, { 0, 1 }, _BSTCBOR_NO_PORT, 0x3 },
+    [BVIEW_BST_SNAPSHOT_IPSP] = { "ingress-port-service-pool", 1, { 0 }, _BSTCBOR_NO_PORT, 0x1 },
+    [BVIEW_BST_SNAPSHOT_ISP] = { "ingress-service-pool", 1, { 0 }, _BSTCBOR_NO_PORT, 0x1 },
+    [BVIEW_BST_SNAPSHOT_EPSP] = { "egress-port-service-pool", 3, { 0, 1, 2 }, _BSTCBOR_NO_PORT, 0xF },
+    [BVIEW_BST_SNAPSHOT_ESP] = { "egress-service-pool", 3, { 0, 1, 2 }, _BSTCBOR_NO_PORT, 0x7 },
+    [BVIEW_BST_SNAPSHOT_EUCQ] = { "egress-uc-queue", 2, { 1, 0 }, 1, 0x1 },
+    [BVIEW_BST_SNAPSHOT_EUCQG] = { "egress-uc-queue-group", 1, { 0 }, _BSTCBOR_NO_PORT, 0x1 },
+    [BVIEW_BST_SNAPSHOT_EMCQ] = { "egress-mc-queue", 3, { 2, 0, 1 }, 2, 0x3 },
+    [BVIEW_BST_SNAPSHOT_CPUQ] = { "egress-cpu-queue", 2, { 0, 1 }, _BSTCBOR_NO_PORT, 0x3 },
+    [BVIEW_BST_SNAPSHOT_RQEQ] = { "egress-rqe-queue", 2, { 0, 1 }, _BSTCBOR_NO_PORT, 0x3 }
+};
+
+/* realms in the order of the JSON report, the device aside */
+static const BVIEW_BST_SNAPSHOT_REALM_t _bstcbor_realm_order[] = {
+    BVIEW_BST_SNAPSHOT_IPPG,
+    BVIEW_BST_SNAPSHOT_IPSP,
+    BVIEW_BST_SNAPSHOT_ISP,
+    BVIEW_BST_SNAPSHOT_CPUQ,
+    BVIEW_BST_SNAPSHOT_EMCQ,
+    BVIEW_BST_SNAPSHOT_EPSP,
+    BVIEW_BST_SNAPSHOT_RQEQ,
+    BVIEW_BST_SNAPSHOT_ESP,
+    BVIEW_BST_SNAPSHOT_EUCQ,
+    BVIEW_BST_SNAPSHOT_EUCQG
+};
+
+/* appends a data item head */
+#define _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, major, value) \
+    _JSONENCODE_OUTPUT_AND_ADVANCE(_bstcbor_output_head((out), (major), (value)))
+
+/* appends a single byte, an indefinite array start or a break */
+#define _CBORENCODE_OUTPUT_BYTE_AND_ADVANCE(out, byte) \
+    do { \
+        char xbyte = (char) (byte); \
+        _JSONENCODE_OUTPUT_AND_ADVANCE(bstjson_output_literal((out), &xbyte, 1)); \
+    } while(0)
+
+/* appends a text string */
+#define _CBORENCODE_OUTPUT_TEXT_AND_ADVANCE(out, str, len) \
+    do { \
+        int xlen = (len); \
+        _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE((out), BSTCBOR_MAJOR_TEXT, (uint64_t) xlen); \
+        _JSONENCODE_OUTPUT_AND_ADVANCE(bstjson_output_literal((out), (str), xlen)); \
+    } while(0)
+
+/******************************************************************
+ * @brief  Gets the name a realm has in the JSON report
+ *
+ * @param[in]   realm       Realm
+ *
+ * @retval   name of the realm, NULL for an unknown realm
+ *********************************************************************/
+const char *bstcbor_realm_name(BVIEW_BST_SNAPSHOT_REALM_t realm)
+{
+    if ((realm < 0) || (realm >= BVIEW_BST_SNAPSHOT_REALM_MAX))
+        return NULL;
+
+    return _bstcbor_realms[realm].name;
+}
+
+/******************************************************************
+ * @brief  Appends the head of a data item, its major type and the
+ *         value or length that goes with it
+ *
+ *********************************************************************/
+static inline BVIEW_STATUS _bstcbor_output_head(BSTJSON_OUTPUT_t *out,
+                                                unsigned int major, uint64_t value)
+{
+    uint8_t head[9];
+    int len = 0, i = 0;
+
+    if (value < 24)
+    {
+        head[0] = (uint8_t) ((major << 5) | value);
+        len = 1;
+    }
+    else
+    {
+        if (value <= 0xFF)
+            len = 2;
+        else if (value <= 0xFFFF)
+            len = 3;
+        else if (value <= 0xFFFFFFFFULL)
+            len = 5;
+        else
+            len = 9;
+
+        /* 24 to 27 for 1, 2, 4 and 8 bytes that follow */
+        head[0] = (uint8_t) ((major << 5) | (24 + __builtin_ctz(len - 1)));
+        for (i = len - 1; i > 0; i--)
+        {
+            head[i] = (uint8_t) value;
+            value >>= 8;
+        }
+    }
+
+    /* most of the heads fit in the window, keep it NUL terminated as
+       bstjson_output_literal() does */
+    if (len < out->rem)
+    {
+        memcpy(out->cur, head, len);
+        out->cur += len;
+        out->rem -= len;
+        out->cur[0] = 0;
+        return BVIEW_STATUS_SUCCESS;
+    }
+
+    return bstjson_output_literal(out, (const char *) head, len);
+}
+
+/******************************************************************
+ * @brief  Appends the notation of a port as a text string
+ *
+ *********************************************************************/
+static BVIEW_STATUS _bstcbor_output_port(BSTJSON_OUTPUT_t *out, int asicId,
+                                         const BSTJSON_REPORT_OPTIONS_t *options,
+                                         int port)
+{
+    const BSTJSON_NOTATION_t *notation = options->notation;
+    char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
+
+    /* the table has the port quoted for JSON, take the quotes off unless
+       something in between is escaped */
+    if ((NULL != notation) && (port > 0) && (port <= notation->numPorts) &&
+        (notation->port[port].length >= 2) &&
+        (NULL == memchr(notation->port[port].str, '\\', notation->port[port].length)))
+    {
+        _CBORENCODE_OUTPUT_TEXT_AND_ADVANCE(out, &notation->port[port].str[1],
+                                            notation->port[port].length - 2);
+        return BVIEW_STATUS_SUCCESS;
+    }
+
+    JSON_PORT_MAP_TO_NOTATION(port, asicId, &portStr[0]);
+    _CBORENCODE_OUTPUT_TEXT_AND_ADVANCE(out, &portStr[0], (int) strlen(portStr));
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Gets how many ports and indices the entries of a realm
+ *         are reported for
+ *
+ * @param[out]  numPorts    ports of a port realm, 0 for the others
+ * @param[out]  count       indices of a port, or entries of the realm
+ * @param[out]  stride      entries of a port in the snapshot
+ *
+ *********************************************************************/
+static void _bstcbor_realm_dims(BVIEW_BST_SNAPSHOT_REALM_t realm,
+                                const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout,
+                                int *numPorts, int *count, int *stride)
+{
+    *numPorts = 0;
+    *stride = 0;
+
+    switch (realm)
+    {
+        case BVIEW_BST_SNAPSHOT_IPPG:
+            *numPorts = asic->numPorts;
+            *count = asic->numPriorityGroups;
+            *stride = layout->numPriorityGroups;
+            break;
+        case BVIEW_BST_SNAPSHOT_IPSP:
+            *numPorts = asic->numPorts;
+            *count = asic->numServicePools;
+            *stride = layout->numIngressServicePools;
+            break;
+        case BVIEW_BST_SNAPSHOT_EPSP:
+            *numPorts = asic->numPorts;
+            *count = asic->numServicePools;
+            *stride = layout->numServicePools;
+            break;
+        case BVIEW_BST_SNAPSHOT_ISP:
+        case BVIEW_BST_SNAPSHOT_ESP:
+            *count = asic->numServicePools;
+            break;
+        case BVIEW_BST_SNAPSHOT_EUCQ:
+            *count = asic->numUnicastQueues;
+            break;
+        case BVIEW_BST_SNAPSHOT_EUCQG:
+            *count = asic->numUnicastQueueGroups;
+            break;
+        case BVIEW_BST_SNAPSHOT_EMCQ:
+            *count = asic->numMulticastQueues;
+            break;
+        case BVIEW_BST_SNAPSHOT_CPUQ:
+            *count = asic->numCpuQueues;
+            break;
+        case BVIEW_BST_SNAPSHOT_RQEQ:
+            *count = asic->numRqeQueues;
+            break;
+        default:
+            *count = 0;
+            break;
+    }
+}
+
+/******************************************************************
+ * @brief  Tells whether an entry of a realm goes into the report,
+ *         as the JSON encoders decide it
+ *
+ * @param[in]   entry       Entry, in the realm
+ * @param[in]   index       Priority group, pool or queue of the entry
+ *
+ *********************************************************************/
+static inline bool _bstcbor_entry_included(const BSTCBOR_REALM_t *desc,
+                                           BVIEW_BST_SNAPSHOT_REALM_t realm,
+                                           const BSTJSON_CHANGES_t *changes,
+                                           const uint64_t *counters,
+                                           const BSTJSON_REPORT_OPTIONS_t *options,
+                                           int entry, int index)
+{
+    unsigned int fields = desc->zeroFields;
+    int field = 0;
+
+    /* a trigger report without the snapshot has the entry that triggered */
+    if ((index != options->triggerInfo.queue) &&
+        (false == options->sendSnapShotOnTrigger) &&
+        (true == options->reportTrigger))
+    {
+        return false;
+    }
+
+    if (NULL != changes)
+    {
+        return BSTJSON_CHANGES_TEST(changes, realm, entry);
+    }
+
+    if (false == options->sendIncrementalReport)
+    {
+        return true;
+    }
+
+    for (field = 0; 0 != fields; field++, fields >>= 1)
+    {
+        if ((0 != (fields & 0x1)) && (0 != counters[field]))
+            return true;
+    }
+
+    return false;
+}
+
+/******************************************************************
+ * @brief  Appends a row, the index of an entry and its counters
+ *
+ *********************************************************************/
+static inline BVIEW_STATUS _bstcbor_output_row(BSTJSON_OUTPUT_t *out, int asicId,
+                                               const BSTCBOR_REALM_t *desc,
+                                               const uint64_t *current,
+                                               const uint64_t *values,
+                                               const BSTJSON_REPORT_OPTIONS_t *options,
+                                               int index)
+{
+    BVIEW_STATUS status;
+    int column = 0, field = 0;
+
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_ARRAY, 1 + desc->numColumns);
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, index);
+
+    for (column = 0; column < desc->numColumns; column++)
+    {
+        field = desc->columns[column];
+        if (field == desc->portColumn)
+        {
+            status = _bstcbor_output_port(out, asicId, options, (int) current[field]);
+            _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+            continue;
+        }
+        _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, values[field]);
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Encodes a realm of the report, but the device
+ *
+ *********************************************************************/
+static BVIEW_STATUS _cborencode_report_realm(BSTJSON_OUTPUT_t *out, int asicId,
+                                             BVIEW_BST_SNAPSHOT_REALM_t realm,
+                                             const BSTJSON_CHANGES_t *changes,
+                                             const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                             const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
+                                             const BSTJSON_REPORT_OPTIONS_t *options,
+                                             const BVIEW_ASIC_CAPABILITIES_t *asic)
+{
+    const BSTCBOR_REALM_t *desc = &_bstcbor_realms[realm];
+    const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout = current->layout;
+    const uint64_t *cur = (const uint64_t *) (current->data + layout->offset[realm]);
+    const uint64_t *val = (const uint64_t *) (values->data + layout->offset[realm]);
+    unsigned int countersPerEntry = layout->entrySize[realm] / sizeof (uint64_t);
+    int numPorts = 0, count = 0, stride = 0;
+    int port = 0, index = 0, entry = 0, next = 0;
+    bool includePort = false;
+    BVIEW_STATUS status;
+
+    _bstcbor_realm_dims(realm, asic, layout, &numPorts, &count, &stride);
+
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_ARRAY, 2);
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, realm);
+    _CBORENCODE_OUTPUT_BYTE_AND_ADVANCE(out, BSTCBOR_ARRAY_INDEFINITE);
+
+    if (0 == numPorts)
+    {
+        for (index = 0; index < count; index++)
+        {
+            /* in an incremental report, go straight to the next one that changed */
+            if (NULL != changes)
+            {
+                index = bstjson_changes_next(changes, realm, index);
+                if ((index < 0) || (index >= count))
+                    break;
+            }
+
+            if (false == _bstcbor_entry_included(desc, realm, changes,
+                                                 &cur[index * countersPerEntry],
+                                                 options, index, index))
+                continue;
+
+            status = _bstcbor_output_row(out, asicId, desc, &cur[index * countersPerEntry],
+                                         &val[index * countersPerEntry], options, index);
+            _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+        }
+    }
+    else
+    {
+        for (port = 1; port <= numPorts; port++)
+        {
+            /* in an incremental report, go straight to the next port that changed */
+            if (NULL != changes)
+            {
+                next = bstjson_changes_next(changes, realm, (port - 1) * stride);
+                if (next < 0)
+                    break;
+                port = next / stride + 1;
+                if (port > numPorts)
+                    break;
+            }
+
+            if ((port != options->triggerInfo.port) &&
+                (false == options->sendSnapShotOnTrigger) &&
+                (true == options->reportTrigger))
+                continue;
+
+            includePort = false;
+            for (index = 0; index < count; index++)
+            {
+                entry = (port - 1) * stride + index;
+                if (false == _bstcbor_entry_included(desc, realm, changes,
+                                                     &cur[entry * countersPerEntry],
+                                                     options, entry, index))
+                    continue;
+
+                /* the port goes in ahead of its first row */
+                if (false == includePort)
+                {
+                    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_ARRAY, 2);
+                    status = _bstcbor_output_port(out, asicId, options, port);
+                    _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+                    _CBORENCODE_OUTPUT_BYTE_AND_ADVANCE(out, BSTCBOR_ARRAY_INDEFINITE);
+                    includePort = true;
+                }
+
+                status = _bstcbor_output_row(out, asicId, desc, &cur[entry * countersPerEntry],
+                                             &val[entry * countersPerEntry], options, index);
+                _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+            }
+
+            if (true == includePort)
+            {
+                _CBORENCODE_OUTPUT_BYTE_AND_ADVANCE(out, BSTCBOR_BREAK);
+            }
+        }
+    }
+
+    _CBORENCODE_OUTPUT_BYTE_AND_ADVANCE(out, BSTCBOR_BREAK);
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Encodes the realms of a report, once the snapshots are
+ *         compared and the counters converted.
+ *
+ *********************************************************************/
+static BVIEW_STATUS _cborencode_report_realms_converted(BSTJSON_OUTPUT_t *out,
+                                                        int asicId,
+                                                        const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                                        const BSTJSON_CHANGES_t *changes,
+                                                        const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                        const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
+                                                        const BSTJSON_REPORT_OPTIONS_t *options,
+                                                        const BVIEW_ASIC_CAPABILITIES_t *asic)
+{
+    bool include[BVIEW_BST_SNAPSHOT_REALM_MAX] = { false };
+    uint64_t data = 0;
+    unsigned int i = 0;
+    BVIEW_STATUS status;
+
+    /* the device, unless it is the same as in the last report */
+    if ((true == options->includeDevice) &&
+        ((NULL == previous) ||
+         (BVIEW_BST_SNAPSHOT_DEVICE_DATA(current)->bufferCount !=
+          BVIEW_BST_SNAPSHOT_DEVICE_DATA(previous)->bufferCount)))
+    {
+        data = BVIEW_BST_SNAPSHOT_DEVICE_DATA(current)->bufferCount;
+        bst_json_convert_data(options, asic, &data, options->bst_max_buffers_ptr->device.data.maxBuf);
+
+        _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_ARRAY, 2);
+        _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BVIEW_BST_SNAPSHOT_DEVICE);
+        _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, data);
+    }
+
+    bstjson_realms_included(options, include);
+
+    for (i = 0; i < sizeof (_bstcbor_realm_order) / sizeof (_bstcbor_realm_order[0]); i++)
+    {
+        if (false == include[_bstcbor_realm_order[i]])
+            continue;
+
+        status = _cborencode_report_realm(out, asicId, _bstcbor_realm_order[i], changes,
+                                          current, values, options, asic);
+        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Encodes the "get-bst-report" REST API in CBOR into an
+ *         output, for both the buffered and the streamed report.
+ *
+ *********************************************************************/
+static BVIEW_STATUS _cborencode_get_bst_report(BSTJSON_OUTPUT_t *out,
+                                               int asicId,
+                                               const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                               const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                               const BSTJSON_REPORT_OPTIONS_t *options,
+                                               const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                               const BVIEW_TIME_t *time)
+{
+    BVIEW_STATUS status;
+    time_t report_time;
+    struct tm *timeinfo;
+    char timeString[64];
+    char asicIdStr[JSON_MAX_NODE_LENGTH] = { 0 };
+    const char *method = NULL;
+    int realm = 0, keys = 5;
+    bool hasPort = false, hasIndex = false;
+
+    /* obtain the time */
+    memset(&timeString, 0, sizeof (timeString));
+    report_time = *(time_t *) time;
+    timeinfo = localtime(&report_time);
+    strftime(timeString, 64, "%Y-%m-%d - %H:%M:%S ", timeinfo);
+
+    /* convert asicId to external  notation */
+    _JSONENCODE_ASIC_NOTATION_GET(options, asicId, &asicIdStr[0]);
+
+    if (true == options->reportTrigger)
+    {
+        method = "trigger-report";
+
+        for (realm = 0; realm < BVIEW_BST_SNAPSHOT_REALM_MAX; realm++)
+        {
+            if (0 == strcmp(options->triggerInfo.realm, _bstcbor_realms[realm].name))
+                break;
+        }
+        if (BVIEW_BST_SNAPSHOT_REALM_MAX == realm)
+        {
+            return BVIEW_STATUS_INVALID_PARAMETER;
+        }
+
+        /* the port and the index that triggered, as far as the realm has them */
+        hasPort = ((BVIEW_BST_SNAPSHOT_IPPG == realm) ||
+                   (BVIEW_BST_SNAPSHOT_IPSP == realm) ||
+                   (BVIEW_BST_SNAPSHOT_EPSP == realm));
+        hasIndex = (BVIEW_BST_SNAPSHOT_DEVICE != realm);
+        keys += 2 + (true == hasPort) + (true == hasIndex);
+    }
+    else
+    {
+        method = (true == options->reportThreshold) ? "get-bst-thresholds" : "get-bst-report";
+    }
+
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_MAP, keys);
+
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BSTCBOR_KEY_METHOD);
+    _CBORENCODE_OUTPUT_TEXT_AND_ADVANCE(out, method, (int) strlen(method));
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BSTCBOR_KEY_ASIC_ID);
+    _CBORENCODE_OUTPUT_TEXT_AND_ADVANCE(out, &asicIdStr[0], (int) strlen(asicIdStr));
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BSTCBOR_KEY_VERSION);
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BVIEW_JSON_VERSION);
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BSTCBOR_KEY_TIME_STAMP);
+    _CBORENCODE_OUTPUT_TEXT_AND_ADVANCE(out, &timeString[0], (int) strlen(timeString));
+
+    if (true == options->reportTrigger)
+    {
+        _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BSTCBOR_KEY_REALM);
+        _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, realm);
+        _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BSTCBOR_KEY_COUNTER);
+        _CBORENCODE_OUTPUT_TEXT_AND_ADVANCE(out, options->triggerInfo.counter,
+                                            (int) strlen(options->triggerInfo.counter));
+        if (true == hasPort)
+        {
+            _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BSTCBOR_KEY_PORT);
+            status = _bstcbor_output_port(out, asicId, options, options->triggerInfo.port);
+            _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+        }
+        if (true == hasIndex)
+        {
+            _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BSTCBOR_KEY_INDEX);
+            _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT,
+                                                (uint64_t) options->triggerInfo.queue);
+        }
+    }
+
+    /* the report goes last, its length is not known up front */
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BSTCBOR_KEY_REPORT);
+    _CBORENCODE_OUTPUT_BYTE_AND_ADVANCE(out, BSTCBOR_ARRAY_INDEFINITE);
+
+    status = bstjson_encode_report_realms(out, asicId, previous, current, options, asic,
+                                          _cborencode_report_realms_converted);
+    _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+
+    _CBORENCODE_OUTPUT_BYTE_AND_ADVANCE(out, BSTCBOR_BREAK);
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Creates a CBOR buffer using the supplied data for the
+ *         "get-bst-report" REST API.
+ *
+ * @param[in]   asicId      ASIC for which this data is being encoded.
+ * @param[in]   method      Method ID (from original request) that needs
+ *                          to be encoded.
+ * @param[in]   previous    Stats of the last report, NULL for a snapshot
+ * @param[in]   current     Stats to be reported
+ * @param[in]   options     Realms and units to be reported
+ * @param[in]   asic        Capabilities of the ASIC
+ * @param[in]   time        Time the stats are collected at
+ * @param[out]  pBuffer     Filled-in CBOR buffer
+ * @param[out]  pLength     Bytes in the buffer
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  Data is encoded successfully
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  No available memory to create the buffer
+ *
+ * @note     The report is binary, its length is the one returned, not
+ *           the one strlen() finds. The returned buffer should be freed
+ *           using the bstjson_memory_free().
+ *********************************************************************/
+BVIEW_STATUS bstcbor_encode_get_bst_report(int asicId,
+                                           int method,
+                                           const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                           const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                           const BSTJSON_REPORT_OPTIONS_t *options,
+                                           const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                           const BVIEW_TIME_t *time,
+                                           uint8_t **pBuffer,
+                                           int *pLength
+                                           )
+{
+    char *cborBuf;
+    BVIEW_STATUS status;
+    BSTJSON_OUTPUT_t out;
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-CBOR-Encoder : Request for Get-Bst-Report \n");
+
+    /* Validate Input Parameters */
+    _JSONENCODE_ASSERT (options != NULL);
+    _JSONENCODE_ASSERT (current != NULL);
+    _JSONENCODE_ASSERT (time != NULL);
+    _JSONENCODE_ASSERT (asic != NULL);
+    _JSONENCODE_ASSERT (pBuffer != NULL);
+    _JSONENCODE_ASSERT (pLength != NULL);
+
+    status = bstjson_memory_allocate(BSTJSON_MEMSIZE_REPORT, (uint8_t **) & cborBuf);
+    _JSONENCODE_ASSERT (status == BVIEW_STATUS_SUCCESS);
+
+    bstjson_output_init(&out, cborBuf, BSTJSON_MEMSIZE_REPORT, NULL, NULL);
+
+    status = _cborencode_get_bst_report(&out, asicId, previous, current, options, asic, time);
+    if (status != BVIEW_STATUS_SUCCESS)
+    {
+        bstjson_memory_free((uint8_t *) cborBuf);
+        return status;
+    }
+
+    *pBuffer = (uint8_t *) cborBuf;
+    *pLength = BSTJSON_OUTPUT_LENGTH(&out);
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-CBOR-Encoder : Request for Get-Bst-Report Complete [%d] bytes \n", *pLength);
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Encodes the "get-bst-report" REST API in CBOR a window at
+ *         a time, handing every window to the flush function as it
+ *         fills up.
+ *
+ * @param[in]   asicId      ASIC for which this data is being encoded.
+ * @param[in]   method      Method ID (from original request) that needs
+ *                          to be encoded.
+ * @param[in]   previous    Stats of the last report, NULL for a snapshot
+ * @param[in]   current     Stats to be reported
+ * @param[in]   options     Realms and units to be reported
+ * @param[in]   asic        Capabilities of the ASIC
+ * @param[in]   time        Time the stats are collected at
+ * @param[in]   flush       Takes the encoded report, a window at a time
+ * @param[in]   cookie      Passed to flush()
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  the whole report is handed to flush()
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter
+ * @retval   other  as returned by flush(), the encoding stops there
+ *
+ *********************************************************************/
+BVIEW_STATUS bstcbor_encode_get_bst_report_stream(int asicId,
+                                                  int method,
+                                                  const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                                  const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                  const BSTJSON_REPORT_OPTIONS_t *options,
+                                                  const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                                  const BVIEW_TIME_t *time,
+                                                  BSTJSON_OUTPUT_FLUSH_t flush,
+                                                  void *cookie
+                                                  )
+{
+    char window[BSTJSON_OUTPUT_WINDOW_SIZE];
+    BVIEW_STATUS status;
+    BSTJSON_OUTPUT_t out;
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-CBOR-Encoder : Request for streamed Get-Bst-Report \n");
+
+    /* Validate Input Parameters */
+    _JSONENCODE_ASSERT (options != NULL);
+    _JSONENCODE_ASSERT (current != NULL);
+    _JSONENCODE_ASSERT (time != NULL);
+    _JSONENCODE_ASSERT (asic != NULL);
+    _JSONENCODE_ASSERT (flush != NULL);
+
+    bstjson_output_init(&out, &window[0], sizeof (window), flush, cookie);
+
+    status = _cborencode_get_bst_report(&out, asicId, previous, current, options, asic, time);
+    _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+
+    /* the last window */
+    status = bstjson_output_finish(&out);
+    _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-CBOR-Encoder : Request for streamed Get-Bst-Report Complete [%d] bytes \n", BSTJSON_OUTPUT_LENGTH(&out));
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Encodes the "window-report" asynchronous report in CBOR
+ *         into an output.
+ *
+ *********************************************************************/
+static BVIEW_STATUS _cborencode_window_report(BSTJSON_OUTPUT_t *out,
+                                              int asicId,
+                                              const BVIEW_BST_ASIC_SNAPSHOT_DATA_t **aggregates,
+                                              unsigned int samples,
+                                              const BSTJSON_REPORT_OPTIONS_t *options,
+                                              const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                              const BVIEW_TIME_t *startTime,
+                                              const BVIEW_TIME_t *endTime)
+{
+    const char *method = "window-report";
+    BVIEW_STATUS status;
+    time_t report_time;
+    struct tm *timeinfo;
+    char startString[64];
+    char endString[64];
+    char asicIdStr[JSON_MAX_NODE_LENGTH] = { 0 };
+    unsigned int i = 0;
+
+    /* obtain the times */
+    memset(&startString, 0, sizeof (startString));
+    report_time = *(time_t *) startTime;
+    timeinfo = localtime(&report_time);
+    strftime(startString, 64, "%Y-%m-%d - %H:%M:%S ", timeinfo);
+
+    memset(&endString, 0, sizeof (endString));
+    report_time = *(time_t *) endTime;
+    timeinfo = localtime(&report_time);
+    strftime(endString, 64, "%Y-%m-%d - %H:%M:%S ", timeinfo);
+
+    /* convert asicId to external  notation */
+    _JSONENCODE_ASIC_NOTATION_GET(options, asicId, &asicIdStr[0]);
+
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_MAP, 9);
+
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BSTCBOR_KEY_METHOD);
+    _CBORENCODE_OUTPUT_TEXT_AND_ADVANCE(out, method, (int) strlen(method));
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BSTCBOR_KEY_ASIC_ID);
+    _CBORENCODE_OUTPUT_TEXT_AND_ADVANCE(out, &asicIdStr[0], (int) strlen(asicIdStr));
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BSTCBOR_KEY_VERSION);
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BVIEW_JSON_VERSION);
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BSTCBOR_KEY_TIME_STAMP);
+    _CBORENCODE_OUTPUT_TEXT_AND_ADVANCE(out, &endString[0], (int) strlen(endString));
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BSTCBOR_KEY_WINDOW_START);
+    _CBORENCODE_OUTPUT_TEXT_AND_ADVANCE(out, &startString[0], (int) strlen(startString));
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BSTCBOR_KEY_SAMPLES);
+    _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, samples);
+
+    /* the peak, the min and the mean, each as a report */
+    for (i = 0; i < 3; i++)
+    {
+        _CBORENCODE_OUTPUT_HEAD_AND_ADVANCE(out, BSTCBOR_MAJOR_UINT, BSTCBOR_KEY_PEAK + i);
+        _CBORENCODE_OUTPUT_BYTE_AND_ADVANCE(out, BSTCBOR_ARRAY_INDEFINITE);
+
+        status = bstjson_encode_report_realms(out, asicId, NULL, aggregates[i], options, asic,
+                                              _cborencode_report_realms_converted);
+        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+
+        _CBORENCODE_OUTPUT_BYTE_AND_ADVANCE(out, BSTCBOR_BREAK);
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Creates a CBOR buffer using the supplied data for the
+ *         "window-report" asynchronous report.
+ *
+ * @param[in]   asicId      ASIC for which this data is being encoded.
+ * @param[in]   peak        Highest value of every counter in the window
+ * @param[in]   min         Lowest value of every counter in the window
+ * @param[in]   mean        Mean value of every counter in the window
+ * @param[in]   samples     Number of samples taken in the window
+ * @param[in]   options     Realms and units to be reported
+ * @param[in]   asic        Capabilities of the ASIC
+ * @param[in]   startTime   Time of the first sample of the window
+ * @param[in]   endTime     Time the window is closed at
+ * @param[out]  pBuffer     Filled-in CBOR buffer
+ * @param[out]  pLength     Bytes in the buffer
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  Data is encoded successfully
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  No available memory to create the buffer
+ *
+ * @note     The aggregates are the ones of bstjson_encode_window_report(),
+ *           but a window that does not fit in the buffer is not reported.
+ *           The returned buffer should be freed using the
+ *           bstjson_memory_free().
+ *********************************************************************/
+BVIEW_STATUS bstcbor_encode_window_report(int asicId,
+                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *peak,
+                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *min,
+                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *mean,
+                                          unsigned int samples,
+                                          const BSTJSON_REPORT_OPTIONS_t *options,
+                                          const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                          const BVIEW_TIME_t *startTime,
+                                          const BVIEW_TIME_t *endTime,
+                                          uint8_t **pBuffer,
+                                          int *pLength
+                                          )
+{
+    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *aggregates[3];
+    char *cborBuf;
+    BVIEW_STATUS status;
+    BSTJSON_OUTPUT_t out;
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-CBOR-Encoder : Request for Window-Report \n");
+
+    /* Validate Input Parameters */
+    _JSONENCODE_ASSERT (peak != NULL);
+    _JSONENCODE_ASSERT (min != NULL);
+    _JSONENCODE_ASSERT (mean != NULL);
+    _JSONENCODE_ASSERT (options != NULL);
+    _JSONENCODE_ASSERT (asic != NULL);
+    _JSONENCODE_ASSERT (startTime != NULL);
+    _JSONENCODE_ASSERT (endTime != NULL);
+    _JSONENCODE_ASSERT (pBuffer != NULL);
+    _JSONENCODE_ASSERT (pLength != NULL);
+
+    aggregates[0] = peak;
+    aggregates[1] = min;
+    aggregates[2] = mean;
+
+    status = bstjson_memory_allocate(BSTJSON_MEMSIZE_REPORT, (uint8_t **) & cborBuf);
+    _JSONENCODE_ASSERT (status == BVIEW_STATUS_SUCCESS);
+
+    bstjson_output_init(&out, cborBuf, BSTJSON_MEMSIZE_REPORT, NULL, NULL);
+
+    status = _cborencode_window_report(&out, asicId, aggregates, samples, options, asic,
+                                       startTime, endTime);
+    if (status != BVIEW_STATUS_SUCCESS)
+    {
+        bstjson_memory_free((uint8_t *) cborBuf);
+        return status;
+    }
+
+    *pBuffer = (uint8_t *) cborBuf;
+    *pLength = BSTJSON_OUTPUT_LENGTH(&out);
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-CBOR-Encoder : Request for Window-Report Complete [%d] bytes \n", *pLength);
+
+    return BVIEW_STATUS_SUCCESS;
+}
@@ -0,0 +1,143 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_BSTCBORENCODER_H
+#define INCLUDE_BSTCBORENCODER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "broadview.h"
+
+#include "bst.h"
+#include "bst_json_encoder.h"
+
+/* A report in CBOR (RFC 7049) carries what the JSON report carries, with
+ * integers in place of the names:
+ *
+ *   report  = { 0: method, 1: asic-id, 2: version, 3: time-stamp,
+ *               [5: realm, 6: counter, 7: port, 8: index,]  trigger only
+ *               4: [* realm-data] }
+ *   realm-data = [realm-id, 0 / counter]                    device
+ *              / [realm-id, [* row]]                        pools, queues
+ *              / [realm-id, [* [port, [* row]]]]            port realms
+ *   row     = [index, counter...]
+ *
+ * The map has a definite length, the report array and the arrays of rows
+ * are indefinite so that a report can be streamed. The realm ids are the
+ * ones of BVIEW_BST_SNAPSHOT_REALM_t. The method, asic-id, time-stamp and
+ * counter are text as in the JSON report, and so are ports, in its
+ * notation; everything else is an unsigned integer. The counters of a
+ * row are, by their position:
+ *
+ *   ingress-port-priority-group  um-share, um-headroom
+ *   ingress-port-service-pool    um-share
+ *   ingress-service-pool         um-share
+ *   egress-port-service-pool     uc-share, um-share, mc-share
+ *   egress-service-pool          um-share, mc-share, mc-share-queue-entries
+ *   egress-uc-queue              port, uc
+ *   egress-uc-queue-group        uc
+ *   egress-mc-queue              port, mc, mc-queue-entries
+ *   egress-cpu-queue             cpu-buffer, cpu-queue-entries
+ *   egress-rqe-queue             rqe-buffer, rqe-queue-entries
+ *
+ * A window report has the aggregates of the window in place of the
+ * report, each an array of realm-data as the report is:
+ *
+ *   window  = { 0: "window-report", 1: asic-id, 2: version, 3: time-stamp,
+ *               9: window-start, 10: samples,
+ *               11: [* realm-data], 12: [* realm-data], 13: [* realm-data] }
+ *
+ * for the peak, the min and the mean of every counter.
+ */
+
+/* keys of the report map */
+typedef enum _bst_cbor_key_
+{
+    BSTCBOR_KEY_METHOD = 0,
+    BSTCBOR_KEY_ASIC_ID,
+    BSTCBOR_KEY_VERSION,
+    BSTCBOR_KEY_TIME_STAMP,
+    BSTCBOR_KEY_REPORT,
+    BSTCBOR_KEY_REALM,
+    BSTCBOR_KEY_COUNTER,
+    BSTCBOR_KEY_PORT,
+    BSTCBOR_KEY_INDEX,
+    BSTCBOR_KEY_WINDOW_START,
+    BSTCBOR_KEY_SAMPLES,
+    BSTCBOR_KEY_PEAK,
+    BSTCBOR_KEY_MIN,
+    BSTCBOR_KEY_MEAN
+} BSTCBOR_KEY_t;
+
+/* major types */
+#define BSTCBOR_MAJOR_UINT              0
+#define BSTCBOR_MAJOR_TEXT              3
+#define BSTCBOR_MAJOR_ARRAY             4
+#define BSTCBOR_MAJOR_MAP               5
+
+/* starts an indefinite array, and ends it */
+#define BSTCBOR_ARRAY_INDEFINITE        0x9F
+#define BSTCBOR_BREAK                   0xFF
+
+/* Prototypes */
+
+const char *bstcbor_realm_name(BVIEW_BST_SNAPSHOT_REALM_t realm);
+
+BVIEW_STATUS bstcbor_encode_get_bst_report(int asicId,
+                                           int method,
+                                           const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                           const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                           const BSTJSON_REPORT_OPTIONS_t *options,
+                                           const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                           const BVIEW_TIME_t *reportTime,
+                                           uint8_t **pBuffer,
+                                           int *pLength
+                                           );
+
+BVIEW_STATUS bstcbor_encode_get_bst_report_stream(int asicId,
+                                                  int method,
+                                                  const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                                  const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                  const BSTJSON_REPORT_OPTIONS_t *options,
+                                                  const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                                  const BVIEW_TIME_t *reportTime,
+                                                  BSTJSON_OUTPUT_FLUSH_t flush,
+                                                  void *cookie
+                                                  );
+
+BVIEW_STATUS bstcbor_encode_window_report(int asicId,
+                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *peak,
+                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *min,
+                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *mean,
+                                          unsigned int samples,
+                                          const BSTJSON_REPORT_OPTIONS_t *options,
+                                          const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                          const BVIEW_TIME_t *startTime,
+                                          const BVIEW_TIME_t *endTime,
+                                          uint8_t **pBuffer,
+                                          int *pLength
+                                          );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BSTCBORENCODER_H */
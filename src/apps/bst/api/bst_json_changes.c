@@ -0,0 +1,410 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "broadview.h"
+#include "cJSON.h"
+
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+
+#include "bst.h"
+
+#include "bst_json_encoder.h"
+
+/* counters compared at a time, a cache line */
+#define _BSTJSON_CHANGES_BLOCK          8
+
+/* counters of an entry a report carries, bit n for the n-th counter.
+   The port of a queue is not reported as a change */
+static const unsigned int _bstjson_changes_fields[BVIEW_BST_SNAPSHOT_REALM_MAX] = {
+    [BVIEW_BST_SNAPSHOT_DEVICE] = 0x1,
+    [BVIEW_BST_SNAPSHOT_IPPG] = 0x3,
+    [BVIEW_BST_SNAPSHOT_IPSP] = 0x1,
+    [BVIEW_BST_SNAPSHOT_ISP] = 0x1,
+    [BVIEW_BST_SNAPSHOT_EPSP] = 0xF,
+    [BVIEW_BST_SNAPSHOT_ESP] = 0x7,
+    [BVIEW_BST_SNAPSHOT_EUCQ] = 0x1,
+    [BVIEW_BST_SNAPSHOT_EUCQG] = 0x1,
+    [BVIEW_BST_SNAPSHOT_EMCQ] = 0x3,
+    [BVIEW_BST_SNAPSHOT_CPUQ] = 0x3,
+    [BVIEW_BST_SNAPSHOT_RQEQ] = 0x3
+};
+
+/******************************************************************
+ * @brief  Tells which realms of a snapshot a report carries
+ *
+ * @param[in]   options     Options of the report
+ * @param[out]  include     true for each realm the report carries
+ *
+ * @note     The device realm is left out, it is encoded on its own.
+ *********************************************************************/
+void bstjson_realms_included(const BSTJSON_REPORT_OPTIONS_t *options,
+                             bool include[BVIEW_BST_SNAPSHOT_REALM_MAX])
+{
+    memset(include, 0, BVIEW_BST_SNAPSHOT_REALM_MAX * sizeof (bool));
+
+    include[BVIEW_BST_SNAPSHOT_IPPG] = options->includeIngressPortPriorityGroup;
+    include[BVIEW_BST_SNAPSHOT_IPSP] = options->includeIngressPortServicePool;
+    include[BVIEW_BST_SNAPSHOT_ISP] = options->includeIngressServicePool;
+    include[BVIEW_BST_SNAPSHOT_EPSP] = options->includeEgressPortServicePool;
+    include[BVIEW_BST_SNAPSHOT_ESP] = options->includeEgressServicePool;
+    include[BVIEW_BST_SNAPSHOT_EUCQ] = options->includeEgressUcQueue;
+    include[BVIEW_BST_SNAPSHOT_EUCQG] = options->includeEgressUcQueueGroup;
+    include[BVIEW_BST_SNAPSHOT_EMCQ] = options->includeEgressMcQueue;
+    include[BVIEW_BST_SNAPSHOT_CPUQ] = options->includeEgressCpuQueue;
+    include[BVIEW_BST_SNAPSHOT_RQEQ] = options->includeEgressRqeQueue;
+}
+
+/******************************************************************
+ * @brief  Checks whether any counter of a block differs between two
+ *         snapshots
+ *
+ * @param[in]   previous    _BSTJSON_CHANGES_BLOCK counters
+ * @param[in]   current     _BSTJSON_CHANGES_BLOCK counters
+ *
+ * @retval   0 if the blocks are equal
+ *********************************************************************/
+
+static inline int _bstjson_changes_block_differs(const uint64_t *previous,
+                                                 const uint64_t *current)
+{
+#if defined(__AVX2__)
+    __m256i acc;
+
+    acc = _mm256_or_si256(_mm256_xor_si256(_mm256_loadu_si256((const __m256i *) previous),
+                                           _mm256_loadu_si256((const __m256i *) current)),
+                          _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) (previous + 4)),
+                                           _mm256_loadu_si256((const __m256i *) (current + 4))));
+
+    return !_mm256_testz_si256(acc, acc);
+#elif defined(__SSE2__)
+    __m128i acc;
+
+    acc = _mm_or_si128(_mm_xor_si128(_mm_loadu_si128((const __m128i *) previous),
+                                     _mm_loadu_si128((const __m128i *) current)),
+                       _mm_xor_si128(_mm_loadu_si128((const __m128i *) (previous + 2)),
+                                     _mm_loadu_si128((const __m128i *) (current + 2))));
+    acc = _mm_or_si128(acc,
+                       _mm_xor_si128(_mm_loadu_si128((const __m128i *) (previous + 4)),
+                                     _mm_loadu_si128((const __m128i *) (current + 4))));
+    acc = _mm_or_si128(acc,
+                       _mm_xor_si128(_mm_loadu_si128((const __m128i *) (previous + 6)),
+                                     _mm_loadu_si128((const __m128i *) (current + 6))));
+
+    return (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi8(acc, _mm_setzero_si128())));
+#else
+    uint64_t acc = 0;
+    int i;
+
+    for (i = 0; i < _BSTJSON_CHANGES_BLOCK; i++)
+        acc |= previous[i] ^ current[i];
+
+    return (0 != acc);
+#endif
+}
+
+/******************************************************************
+ * @brief  Sets the bits of the entries of a realm which changed
+ *
+ * @param[in]   previous    Previous snapshot
+ * @param[in]   current     Current snapshot
+ * @param[in]   realm       Realm to compare
+ * @param[out]  changes     Bitmap, the words of the realm cleared
+ *
+ *********************************************************************/
+
+static void _bstjson_changes_realm(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                   const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                   BVIEW_BST_SNAPSHOT_REALM_t realm,
+                                   BSTJSON_CHANGES_t *changes)
+{
+    const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout = current->layout;
+    const uint64_t *prev = (const uint64_t *) (previous->data + layout->offset[realm]);
+    const uint64_t *cur = (const uint64_t *) (current->data + layout->offset[realm]);
+    unsigned int countersPerEntry = layout->entrySize[realm] / sizeof (uint64_t);
+    unsigned int numCounters = changes->entries[realm] * countersPerEntry;
+    unsigned int fields = _bstjson_changes_fields[realm];
+    uint64_t *bits = &changes->bits[changes->base[realm]];
+    unsigned int block = 0, counter = 0, end = 0, entry = 0;
+
+    for (block = 0; block < numCounters; block += _BSTJSON_CHANGES_BLOCK)
+    {
+        end = block + _BSTJSON_CHANGES_BLOCK;
+
+        /* most blocks are unchanged, skip them a cache line at a time */
+        if (end <= numCounters)
+        {
+            if (0 == _bstjson_changes_block_differs(&prev[block], &cur[block]))
+                continue;
+        }
+        else
+        {
+            end = numCounters;
+        }
+
+        for (counter = block; counter < end; counter++)
+        {
+            if ((prev[counter] == cur[counter]) ||
+                (0 == (fields & (1U << (counter % countersPerEntry)))))
+                continue;
+
+            entry = counter / countersPerEntry;
+            bits[entry / 64] |= (1ULL << (entry % 64));
+        }
+    }
+}
+
+/******************************************************************
+ * @brief  Tells whether two snapshots can be compared entry by entry
+ *
+ * @param[in]   a           Layout of one snapshot
+ * @param[in]   b           Layout of the other snapshot
+ *
+ * @retval   true   every realm has the same entries at the same offsets
+ * @retval   false  otherwise
+ *
+ * @note     Layouts of the same size may still place the realms
+ *           differently, so every realm is checked.
+ *********************************************************************/
+static bool _bstjson_changes_layout_same(const BVIEW_BST_SNAPSHOT_LAYOUT_t *a,
+                                         const BVIEW_BST_SNAPSHOT_LAYOUT_t *b)
+{
+    int realm = 0;
+
+    if (a == b)
+    {
+        return true;
+    }
+    if ((NULL == a) || (NULL == b) || (a->size != b->size))
+    {
+        return false;
+    }
+
+    for (realm = 0; realm < BVIEW_BST_SNAPSHOT_REALM_MAX; realm++)
+    {
+        if ((a->entries[realm] != b->entries[realm]) ||
+            (a->entrySize[realm] != b->entrySize[realm]) ||
+            (a->offset[realm] != b->offset[realm]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/******************************************************************
+ * @brief  Finds the entries of two snapshots that changed, for the
+ *         realms an incremental report carries
+ *
+ * @param[in]   previous    Previous snapshot
+ * @param[in]   current     Current snapshot
+ * @param[in]   options     Options of the report
+ * @param[out]  changes     Bitmap of the entries that changed
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  bitmap computed
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  invalid input parameter, or
+ *                                           snapshots of different layout
+ *
+ * @note     The snapshots are compared a cache line at a time, so the
+ *           cost is about the size of the realms compared plus the
+ *           number of changes. The device realm is not compared.
+ *********************************************************************/
+BVIEW_STATUS bstjson_changes_compute(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                     const BSTJSON_REPORT_OPTIONS_t *options,
+                                     BSTJSON_CHANGES_t *changes)
+{
+    bool include[BVIEW_BST_SNAPSHOT_REALM_MAX] = { false };
+    unsigned int base = 0, words = 0;
+    int realm = 0;
+
+    _JSONENCODE_ASSERT (previous != NULL);
+    _JSONENCODE_ASSERT (current != NULL);
+    _JSONENCODE_ASSERT (options != NULL);
+    _JSONENCODE_ASSERT (changes != NULL);
+
+    if (false == _bstjson_changes_layout_same(previous->layout, current->layout))
+    {
+        return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    bstjson_realms_included(options, include);
+
+    for (realm = 0; realm < BVIEW_BST_SNAPSHOT_REALM_MAX; realm++)
+    {
+        changes->base[realm] = base;
+        changes->entries[realm] = (true == include[realm]) ? current->layout->entries[realm] : 0;
+
+        words = (changes->entries[realm] + 63) / 64;
+        if ((base + words) > BSTJSON_CHANGES_MAX_WORDS)
+        {
+            return BVIEW_STATUS_INVALID_PARAMETER;
+        }
+
+        memset(&changes->bits[base], 0, words * sizeof (uint64_t));
+        if (0 != words)
+        {
+            _bstjson_changes_realm(previous, current, realm, changes);
+        }
+        base += words;
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Marks all the entries of the realms a report carries, as
+ *         if each of them changed
+ *
+ * @param[in]   current     Snapshot to report
+ * @param[in]   options     Options of the report
+ * @param[in]   nonZeroOnly leave out the entries whose reported
+ *                          counters are all 0
+ * @param[out]  changes     Bitmap of the entries to report
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  bitmap set
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  invalid input parameter
+ *
+ * @note     A snapshot report goes through the same bitmap as an
+ *           incremental one when its entries are filtered.
+ *********************************************************************/
+BVIEW_STATUS bstjson_changes_all(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                 const BSTJSON_REPORT_OPTIONS_t *options,
+                                 bool nonZeroOnly,
+                                 BSTJSON_CHANGES_t *changes)
+{
+    bool include[BVIEW_BST_SNAPSHOT_REALM_MAX] = { false };
+    const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout;
+    const uint64_t *cur;
+    unsigned int base = 0, words = 0, entry = 0, field = 0, countersPerEntry = 0;
+    uint64_t *bits;
+    int realm = 0;
+
+    _JSONENCODE_ASSERT (current != NULL);
+    _JSONENCODE_ASSERT (options != NULL);
+    _JSONENCODE_ASSERT (changes != NULL);
+
+    layout = current->layout;
+    bstjson_realms_included(options, include);
+
+    for (realm = 0; realm < BVIEW_BST_SNAPSHOT_REALM_MAX; realm++)
+    {
+        changes->base[realm] = base;
+        changes->entries[realm] = (true == include[realm]) ? layout->entries[realm] : 0;
+
+        words = (changes->entries[realm] + 63) / 64;
+        if ((base + words) > BSTJSON_CHANGES_MAX_WORDS)
+        {
+            return BVIEW_STATUS_INVALID_PARAMETER;
+        }
+
+        bits = &changes->bits[base];
+        memset(bits, 0, words * sizeof (uint64_t));
+        base += words;
+
+        cur = (const uint64_t *) (current->data + layout->offset[realm]);
+        countersPerEntry = layout->entrySize[realm] / sizeof (uint64_t);
+
+        for (entry = 0; entry < changes->entries[realm]; entry++)
+        {
+            if (true == nonZeroOnly)
+            {
+                /* the same counters an incremental report compares */
+                for (field = 0; field < countersPerEntry; field++)
+                {
+                    if ((0 != (_bstjson_changes_fields[realm] & (1U << field))) &&
+                        (0 != cur[entry * countersPerEntry + field]))
+                        break;
+                }
+                if (field == countersPerEntry)
+                    continue;
+            }
+
+            bits[entry / 64] |= (1ULL << (entry % 64));
+        }
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Finds the next entry of a realm that changed
+ *
+ * @param[in]   changes     Bitmap from bstjson_changes_compute()
+ * @param[in]   realm       Realm
+ * @param[in]   from        Entry to start at
+ *
+ * @retval   index of the first entry at or after 'from' that changed,
+ *           -1 if there is none
+ *********************************************************************/
+int bstjson_changes_next(const BSTJSON_CHANGES_t *changes,
+                         BVIEW_BST_SNAPSHOT_REALM_t realm, int from)
+{
+    const uint64_t *bits = &changes->bits[changes->base[realm]];
+    unsigned int words = (changes->entries[realm] + 63) / 64;
+    unsigned int word = 0;
+    uint64_t val = 0;
+
+    if (from < 0)
+        from = 0;
+
+    if ((unsigned int) from >= changes->entries[realm])
+        return -1;
+
+    word = from / 64;
+    val = bits[word] & (~0ULL << (from % 64));
+
+    while (0 == val)
+    {
+        if (++word >= words)
+            return -1;
+        val = bits[word];
+    }
+
+    return (int) (word * 64 + __builtin_ctzll(val));
+}
+
+/******************************************************************
+ * @brief  Counts the entries of a realm which changed
+ *
+ * @param[in]   changes     Bitmap from bstjson_changes_compute()
+ * @param[in]   realm       Realm
+ *
+ * @retval   number of entries which changed, 0 for a realm not compared
+ *********************************************************************/
+unsigned int bstjson_changes_count(const BSTJSON_CHANGES_t *changes,
+                                   BVIEW_BST_SNAPSHOT_REALM_t realm)
+{
+    const uint64_t *bits = &changes->bits[changes->base[realm]];
+    unsigned int words = (changes->entries[realm] + 63) / 64;
+    unsigned int word = 0, count = 0;
+
+    for (word = 0; word < words; word++)
+        count += (unsigned int) __builtin_popcountll(bits[word]);
+
+    return count;
+}
@@ -0,0 +1,551 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "broadview.h"
+#include "cJSON.h"
+
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+
+#include "bst.h"
+
+#include "bst_json_encoder.h"
+
+/* values up to which a reciprocal and one correction give the exact
+   quotient, and the same percentage as bst_json_convert_data() */
+#define _BSTJSON_CONVERT_EXACT_LIMIT    (1ULL << 50)
+
+/* counter of an entry which is reported as is */
+#define _BSTJSON_CONVERT_AS_IS          (-1)
+
+/* how the counters of a report are converted */
+typedef enum _bst_json_convert_mode_
+{
+    _BSTJSON_CONVERT_NONE = 0,
+    _BSTJSON_CONVERT_CELLS,
+    _BSTJSON_CONVERT_PERCENT
+} _BSTJSON_CONVERT_MODE_t;
+
+/* where the max buffers of the counters of a realm are */
+typedef struct _bst_json_convert_realm_
+{
+    /* offset of the realm in the max buffers snapshot */
+    size_t offset;
+    /* size of an entry of the realm in the max buffers snapshot */
+    size_t entrySize;
+    /* entries of a port in the max buffers snapshot, 0 if not per port */
+    unsigned int portEntries;
+    /* offset of the max buffer of each counter in its entry */
+    int field[4];
+} _BSTJSON_CONVERT_REALM_t;
+
+#define _BSTJSON_MAXBUF(_realm, _type, _ports, _f0, _f1, _f2, _f3)      \
+    { offsetof(BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t, _realm),        \
+      sizeof(_type), (_ports), { (_f0), (_f1), (_f2), (_f3) } }
+
+#define _BSTJSON_FIELD(_type, _field)   ((int) offsetof(_type, _field))
+
+static const _BSTJSON_CONVERT_REALM_t _bstjson_convert_realms[BVIEW_BST_SNAPSHOT_REALM_MAX] = {
+    [BVIEW_BST_SNAPSHOT_DEVICE] =
+        _BSTJSON_MAXBUF(device, BVIEW_SYSTEM_DEVICE_MAX_BUF_t, 0,
+                        _BSTJSON_FIELD(BVIEW_SYSTEM_DEVICE_MAX_BUF_t, maxBuf),
+                        _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS),
+    [BVIEW_BST_SNAPSHOT_IPPG] =
+        _BSTJSON_MAXBUF(iPortPg, BVIEW_SYSTEM_INGRESS_PORT_PG_MAX_BUF_t, BVIEW_ASIC_MAX_PRIORITY_GROUPS,
+                        _BSTJSON_FIELD(BVIEW_SYSTEM_INGRESS_PORT_PG_MAX_BUF_t, umShareMaxBuf),
+                        _BSTJSON_FIELD(BVIEW_SYSTEM_INGRESS_PORT_PG_MAX_BUF_t, umHeadroomMaxBuf),
+                        _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS),
+    [BVIEW_BST_SNAPSHOT_IPSP] =
+        _BSTJSON_MAXBUF(iPortSp, BVIEW_SYSTEM_INGRESS_PORT_SP_MAX_BUF_t, BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS,
+                        _BSTJSON_FIELD(BVIEW_SYSTEM_INGRESS_PORT_SP_MAX_BUF_t, umShareMaxBuf),
+                        _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS),
+    [BVIEW_BST_SNAPSHOT_ISP] =
+        _BSTJSON_MAXBUF(iSp, BVIEW_SYSTEM_INGRESS_SP_MAX_BUF_t, 0,
+                        _BSTJSON_FIELD(BVIEW_SYSTEM_INGRESS_SP_MAX_BUF_t, umShareMaxBuf),
+                        _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS),
+    [BVIEW_BST_SNAPSHOT_EPSP] =
+        _BSTJSON_MAXBUF(ePortSp, BVIEW_SYSTEM_EGRESS_PORT_SP_MAX_BUF_t, BVIEW_ASIC_MAX_SERVICE_POOLS,
+                        _BSTJSON_FIELD(BVIEW_SYSTEM_EGRESS_PORT_SP_MAX_BUF_t, ucShareMaxBuf),
+                        _BSTJSON_FIELD(BVIEW_SYSTEM_EGRESS_PORT_SP_MAX_BUF_t, umShareMaxBuf),
+                        _BSTJSON_FIELD(BVIEW_SYSTEM_EGRESS_PORT_SP_MAX_BUF_t, mcShareMaxBuf),
+                        _BSTJSON_CONVERT_AS_IS),
+    [BVIEW_BST_SNAPSHOT_ESP] =
+        _BSTJSON_MAXBUF(eSp, BVIEW_SYSTEM_EGRESS_SP_MAX_BUF_t, 0,
+                        _BSTJSON_FIELD(BVIEW_SYSTEM_EGRESS_SP_MAX_BUF_t, umShareMaxBuf),
+                        _BSTJSON_FIELD(BVIEW_SYSTEM_EGRESS_SP_MAX_BUF_t, mcShareMaxBuf),
+                        _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS),
+    [BVIEW_BST_SNAPSHOT_EUCQ] =
+        _BSTJSON_MAXBUF(eUcQ, BVIEW_SYSTEM_EGRESS_UC_QUEUE_MAX_BUF_t, 0,
+                        _BSTJSON_FIELD(BVIEW_SYSTEM_EGRESS_UC_QUEUE_MAX_BUF_t, ucMaxBuf),
+                        _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS),
+    [BVIEW_BST_SNAPSHOT_EUCQG] =
+        _BSTJSON_MAXBUF(eUcQg, BVIEW_SYSTEM_EGRESS_UC_QUEUEGROUPS_MAX_BUF_t, 0,
+                        _BSTJSON_FIELD(BVIEW_SYSTEM_EGRESS_UC_QUEUEGROUPS_MAX_BUF_t, ucMaxBuf),
+                        _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS),
+    [BVIEW_BST_SNAPSHOT_EMCQ] =
+        _BSTJSON_MAXBUF(eMcQ, BVIEW_SYSTEM_EGRESS_MC_QUEUE_MAX_BUF_t, 0,
+                        _BSTJSON_FIELD(BVIEW_SYSTEM_EGRESS_MC_QUEUE_MAX_BUF_t, mcMaxBuf),
+                        _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS),
+    [BVIEW_BST_SNAPSHOT_CPUQ] =
+        _BSTJSON_MAXBUF(cpqQ, BVIEW_SYSTEM_EGRESS_CPU_QUEUE_MAX_BUF_t, 0,
+                        _BSTJSON_FIELD(BVIEW_SYSTEM_EGRESS_CPU_QUEUE_MAX_BUF_t, cpuMaxBuf),
+                        _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS),
+    [BVIEW_BST_SNAPSHOT_RQEQ] =
+        _BSTJSON_MAXBUF(rqeQ, BVIEW_SYSTEM_EGRESS_RQE_QUEUE_MAX_BUF_t, 0,
+                        _BSTJSON_FIELD(BVIEW_SYSTEM_EGRESS_RQE_QUEUE_MAX_BUF_t, rqeMaxBuf),
+                        _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS, _BSTJSON_CONVERT_AS_IS)
+};
+
+/******************************************************************
+ * @brief  Entries per port of a realm in the snapshot, 0 for a realm
+ *         which is not kept per port
+ *********************************************************************/
+
+static unsigned int _bstjson_convert_per_port(const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout,
+                                              BVIEW_BST_SNAPSHOT_REALM_t realm)
+{
+    switch (realm)
+    {
+        case BVIEW_BST_SNAPSHOT_IPPG:
+            return layout->numPriorityGroups;
+        case BVIEW_BST_SNAPSHOT_IPSP:
+            return layout->numIngressServicePools;
+        case BVIEW_BST_SNAPSHOT_EPSP:
+            return layout->numServicePools;
+        default:
+            return 0;
+    }
+}
+
+/******************************************************************
+ * @brief  How the options ask the counters to be converted
+ *********************************************************************/
+
+static _BSTJSON_CONVERT_MODE_t _bstjson_convert_mode(const BSTJSON_REPORT_OPTIONS_t *options,
+                                                     const BVIEW_ASIC_CAPABILITIES_t *asic)
+{
+    /* percentages are for the stats, thresholds are in bytes or cells */
+    if ((false == options->reportThreshold) && (true == options->statsInPercentage))
+        return _BSTJSON_CONVERT_PERCENT;
+
+    /* a cell of 0 or 1 byte leaves the counters as they are */
+    if ((true == options->statUnitsInCells) && (asic->cellToByteConv > 1))
+        return _BSTJSON_CONVERT_CELLS;
+
+    return _BSTJSON_CONVERT_NONE;
+}
+
+/******************************************************************
+ * @brief  Divides a counter by the cell size, with the reciprocal
+ *         of the cell size
+ *********************************************************************/
+
+static inline uint64_t _bstjson_convert_cells(uint64_t value, uint64_t cellSize, double reciprocal)
+{
+    uint64_t quotient;
+
+    if (value >= _BSTJSON_CONVERT_EXACT_LIMIT)
+        return value / cellSize;
+
+    /* the estimate is off by one at most */
+    quotient = (uint64_t) ((double) value * reciprocal);
+    if (quotient * cellSize > value)
+        quotient--;
+    else if ((quotient + 1) * cellSize <= value)
+        quotient++;
+
+    return quotient;
+}
+
+/******************************************************************
+ * @brief  Percentage of a counter of its max buffer, rounded half up,
+ *         as bst_json_convert_data() takes it
+ *********************************************************************/
+
+static inline uint64_t _bstjson_convert_percent(uint64_t value, uint64_t maxBuf)
+{
+    if (0 == maxBuf)
+        return 0;
+
+    return round_int(((double) (value * 100)) / ((double) maxBuf));
+}
+
+/******************************************************************
+ * @brief  Percentage of a counter of its max buffer with the
+ *         reciprocal of the max buffer, without a branch
+ *
+ * @note   The result equals _bstjson_convert_percent() for a counter
+ *         below _BSTJSON_CONVERT_EXACT_LIMIT / 100 and a max buffer
+ *         below _BSTJSON_CONVERT_EXACT_LIMIT, a reciprocal of 0 stands
+ *         for a max buffer of 0.
+ *********************************************************************/
+
+static inline uint64_t _bstjson_convert_percent_fast(uint64_t value, uint64_t maxBuf,
+                                                     double reciprocal)
+{
+    /* floor((2 * scaled + maxBuf) / (2 * maxBuf)), the estimate is off by one at most */
+    uint64_t dividend = 200 * value + maxBuf;
+    uint64_t divisor = 2 * maxBuf;
+    /* both fit in 63 bits, the signed conversions need no fixup */
+    uint64_t quotient = (uint64_t) (int64_t) ((double) (int64_t) (100 * value) * reciprocal + 0.5);
+
+    quotient -= (uint64_t) (quotient * divisor > dividend);
+    quotient += (uint64_t) ((quotient + 1) * divisor <= dividend);
+
+    /* a max buffer of 0 gives 0 */
+    return quotient & (0 - (uint64_t) (0 != maxBuf));
+}
+
+/******************************************************************
+ * @brief  Reciprocals of the max buffers of a report, NULL if the
+ *         percentages are to be divided
+ *********************************************************************/
+
+static inline const BSTJSON_MAX_BUF_RECIPROCALS_t *
+_bstjson_convert_reciprocals(const BSTJSON_REPORT_OPTIONS_t *options)
+{
+    const BSTJSON_MAX_BUF_RECIPROCALS_t *reciprocals = options->bst_max_buffers_reciprocals;
+
+    if ((NULL == reciprocals) || (false == reciprocals->valid) || (false == reciprocals->exact))
+        return NULL;
+
+    return reciprocals;
+}
+
+/******************************************************************
+ * @brief  Converts a run of entries of a realm, all of the same port
+ *
+ * @param[in]   mode        Conversion
+ * @param[in]   current     Snapshot the counters are taken from
+ * @param[in]   options     Options of the report
+ * @param[in]   asic        Capabilities of the ASIC
+ * @param[in]   realm       Realm of the entries
+ * @param[in]   first       First entry
+ * @param[in]   count       Number of entries
+ * @param[out]  values      Snapshot the converted counters go to
+ *
+ *********************************************************************/
+
+static void _bstjson_convert_entries(_BSTJSON_CONVERT_MODE_t mode,
+                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                     const BSTJSON_REPORT_OPTIONS_t *options,
+                                     const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                     BVIEW_BST_SNAPSHOT_REALM_t realm,
+                                     unsigned int first, unsigned int count,
+                                     BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values)
+{
+    const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout = current->layout;
+    const _BSTJSON_CONVERT_REALM_t *desc = &_bstjson_convert_realms[realm];
+    unsigned int countersPerEntry = layout->entrySize[realm] / sizeof (uint64_t);
+    unsigned int maxStride = desc->entrySize / sizeof (uint64_t);
+    const uint64_t *in = (const uint64_t *) (current->data + layout->offset[realm]) + first * countersPerEntry;
+    uint64_t *out = (uint64_t *) (values->data + layout->offset[realm]) + first * countersPerEntry;
+    const uint64_t *maxBuf = NULL;
+    const BSTJSON_MAX_BUF_RECIPROCALS_t *reciprocals = NULL;
+    uint64_t cellSize = 0, large = 0, value = 0;
+    double cellReciprocal = 0.0;
+    unsigned int perPort = 0, entry = 0, field = 0;
+
+    /* counters reported as is are copied with the others, then overwritten */
+    memcpy(out, in, count * layout->entrySize[realm]);
+
+    if (_BSTJSON_CONVERT_CELLS == mode)
+    {
+        cellSize = (uint64_t) asic->cellToByteConv;
+        cellReciprocal = 1.0 / (double) cellSize;
+    }
+    else
+    {
+        /* the max buffers are kept per port at the widest the agent supports */
+        perPort = _bstjson_convert_per_port(layout, realm);
+        maxBuf = (const uint64_t *) ((const uint8_t *) options->bst_max_buffers_ptr + desc->offset) +
+                 ((0 == perPort) ? first : (first / perPort) * desc->portEntries + first % perPort) * maxStride;
+        reciprocals = _bstjson_convert_reciprocals(options);
+    }
+
+    /* a counter at a time over the run, so each loop is a plain strided walk */
+    for (field = 0; field < countersPerEntry; field++)
+    {
+        if (_BSTJSON_CONVERT_AS_IS == desc->field[field])
+            continue;
+
+        if (_BSTJSON_CONVERT_CELLS == mode)
+        {
+            for (entry = 0; entry < count; entry++)
+            {
+                out[entry * countersPerEntry + field] =
+                    _bstjson_convert_cells(in[entry * countersPerEntry + field], cellSize, cellReciprocal);
+            }
+        }
+        else
+        {
+            const uint64_t *limit = maxBuf + desc->field[field] / sizeof (uint64_t);
+
+            if (NULL != reciprocals)
+            {
+                const double *inverse = reciprocals->value +
+                                        (limit - (const uint64_t *) options->bst_max_buffers_ptr);
+
+                large = 0;
+                for (entry = 0; entry < count; entry++)
+                {
+                    value = in[entry * countersPerEntry + field];
+                    large |= value;
+                    out[entry * countersPerEntry + field] =
+                        _bstjson_convert_percent_fast(value, limit[entry * maxStride],
+                                                      inverse[entry * maxStride]);
+                }
+
+                /* no counter of the run is that large on any switch, the
+                   check is once per run to keep the loop above straight */
+                if (large < _BSTJSON_CONVERT_EXACT_LIMIT / 100)
+                    continue;
+            }
+
+            for (entry = 0; entry < count; entry++)
+            {
+                out[entry * countersPerEntry + field] =
+                    _bstjson_convert_percent(in[entry * countersPerEntry + field],
+                                             limit[entry * maxStride]);
+            }
+        }
+    }
+}
+
+/******************************************************************
+ * @brief  Takes the reciprocals of the max buffers of a unit, for the
+ *         reports in percent
+ *
+ * @param[in]   maxBuffers  Max buffers, as read from the south bound
+ * @param[in,out] reciprocals Reciprocals of the max buffers, zeroed
+ *                          before the first call
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  reciprocals are up to date
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  invalid input parameter
+ *
+ * @note     Called whenever the max buffers are read again. They are
+ *           only divided when they differ from the last ones, so a
+ *           report converts its counters without any division.
+ *********************************************************************/
+BVIEW_STATUS bstjson_max_buf_reciprocals_update(const BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBuffers,
+                                               BSTJSON_MAX_BUF_RECIPROCALS_t *reciprocals)
+{
+    const uint64_t *words;
+    unsigned int i = 0;
+
+    _JSONENCODE_ASSERT (maxBuffers != NULL);
+    _JSONENCODE_ASSERT (reciprocals != NULL);
+
+    if ((true == reciprocals->valid) &&
+        (0 == memcmp(&reciprocals->maxBuffers, maxBuffers, sizeof (reciprocals->maxBuffers))))
+        return BVIEW_STATUS_SUCCESS;
+
+    memcpy(&reciprocals->maxBuffers, maxBuffers, sizeof (reciprocals->maxBuffers));
+    reciprocals->valid = true;
+
+    words = (const uint64_t *) maxBuffers;
+    reciprocals->exact = true;
+
+    for (i = 0; i < BSTJSON_MAX_BUF_WORDS; i++)
+    {
+        reciprocals->value[i] = (0 == words[i]) ? 0.0 : 1.0 / (double) words[i];
+        if (words[i] >= _BSTJSON_CONVERT_EXACT_LIMIT)
+            reciprocals->exact = false;
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Tells whether the counters of a report need to be
+ *         converted before they are encoded
+ *
+ * @param[in]   options     Options of the report
+ * @param[in]   asic        Capabilities of the ASIC
+ *
+ * @retval   true   the report is in cells or in percent
+ * @retval   false  the counters are reported as collected
+ *********************************************************************/
+bool bstjson_convert_needed(const BSTJSON_REPORT_OPTIONS_t *options,
+                            const BVIEW_ASIC_CAPABILITIES_t *asic)
+{
+    return (_BSTJSON_CONVERT_NONE != _bstjson_convert_mode(options, asic));
+}
+
+/******************************************************************
+ * @brief  Converts the counters of a snapshot to the units of a
+ *         report, a realm at a time, before the report is encoded
+ *
+ * @param[in]   current     Snapshot to convert
+ * @param[in]   changes     Entries which changed, NULL to convert all
+ *                          entries of the realms the report carries
+ * @param[in]   options     Options of the report
+ * @param[in]   asic        Capabilities of the ASIC
+ * @param[out]  values      Snapshot of the layout of 'current' which
+ *                          takes the converted counters
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  counters converted
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  invalid input parameter
+ *
+ * @note     Only the entries the report carries are converted, the
+ *           others are left as they are in 'values'. Counters which
+ *           are reported as is, such as the port of a queue, are
+ *           copied. The device realm is converted while encoded.
+ *********************************************************************/
+BVIEW_STATUS bstjson_convert_snapshot(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                      const BSTJSON_CHANGES_t *changes,
+                                      const BSTJSON_REPORT_OPTIONS_t *options,
+                                      const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                      BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values)
+{
+    bool include[BVIEW_BST_SNAPSHOT_REALM_MAX] = { false };
+    _BSTJSON_CONVERT_MODE_t mode;
+    const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout;
+    unsigned int perPort = 0, entry = 0;
+    int realm = 0, next = 0;
+
+    _JSONENCODE_ASSERT (current != NULL);
+    _JSONENCODE_ASSERT (options != NULL);
+    _JSONENCODE_ASSERT (asic != NULL);
+    _JSONENCODE_ASSERT (values != NULL);
+    _JSONENCODE_ASSERT (values->layout == current->layout);
+
+    mode = _bstjson_convert_mode(options, asic);
+    if (_BSTJSON_CONVERT_NONE == mode)
+    {
+        return BVIEW_STATUS_SUCCESS;
+    }
+
+    if ((_BSTJSON_CONVERT_PERCENT == mode) && (NULL == options->bst_max_buffers_ptr))
+    {
+        return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    layout = current->layout;
+    bstjson_realms_included(options, include);
+
+    for (realm = BVIEW_BST_SNAPSHOT_IPPG; realm < BVIEW_BST_SNAPSHOT_REALM_MAX; realm++)
+    {
+        if (false == include[realm])
+            continue;
+
+        /* an incremental report carries the entries which changed */
+        if (NULL != changes)
+        {
+            for (next = bstjson_changes_next(changes, realm, 0); next >= 0;
+                 next = bstjson_changes_next(changes, realm, next + 1))
+            {
+                _bstjson_convert_entries(mode, current, options, asic, realm, next, 1, values);
+            }
+            continue;
+        }
+
+        /* a full report carries them all, a port at a time */
+        perPort = _bstjson_convert_per_port(layout, realm);
+        if (0 == perPort)
+            perPort = layout->entries[realm];
+        if (0 == perPort)
+            continue;
+
+        for (entry = 0; entry < layout->entries[realm]; entry += perPort)
+        {
+            _bstjson_convert_entries(mode, current, options, asic, realm, entry, perPort, values);
+        }
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Occupancy of an entry, the largest of its buffer counters
+ *
+ * @param[in]   current     Snapshot the counters are taken from
+ * @param[in]   options     Options of the report
+ * @param[in]   asic        Capabilities of the ASIC
+ * @param[in]   realm       Realm of the entry
+ * @param[in]   entry       Entry
+ * @param[in]   percent     in percent of the max buffers, rather than
+ *                          in the units of the report
+ *
+ * @retval   occupancy of the entry, 0 if the max buffers are needed
+ *           and there are none
+ *
+ * @note     Counters reported as is, such as the port of a queue, are
+ *           not buffer counters and are left out.
+ *********************************************************************/
+uint64_t bstjson_convert_level(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                               const BSTJSON_REPORT_OPTIONS_t *options,
+                               const BVIEW_ASIC_CAPABILITIES_t *asic,
+                               BVIEW_BST_SNAPSHOT_REALM_t realm,
+                               unsigned int entry, bool percent)
+{
+    const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout = current->layout;
+    const _BSTJSON_CONVERT_REALM_t *desc = &_bstjson_convert_realms[realm];
+    unsigned int countersPerEntry = layout->entrySize[realm] / sizeof (uint64_t);
+    const uint64_t *in = (const uint64_t *) (current->data + layout->offset[realm]) + entry * countersPerEntry;
+    const uint64_t *maxBuf = NULL;
+    const BSTJSON_MAX_BUF_RECIPROCALS_t *reciprocals = NULL;
+    _BSTJSON_CONVERT_MODE_t mode;
+    unsigned int perPort = 0, field = 0;
+    size_t word = 0;
+    uint64_t level = 0, value = 0;
+
+    mode = (true == percent) ? _BSTJSON_CONVERT_PERCENT : _bstjson_convert_mode(options, asic);
+
+    if (_BSTJSON_CONVERT_PERCENT == mode)
+    {
+        if (NULL == options->bst_max_buffers_ptr)
+            return 0;
+
+        perPort = _bstjson_convert_per_port(layout, realm);
+        maxBuf = (const uint64_t *) ((const uint8_t *) options->bst_max_buffers_ptr + desc->offset) +
+                 ((0 == perPort) ? entry : (entry / perPort) * desc->portEntries + entry % perPort) *
+                 (desc->entrySize / sizeof (uint64_t));
+        reciprocals = _bstjson_convert_reciprocals(options);
+    }
+
+    for (field = 0; field < countersPerEntry; field++)
+    {
+        if (_BSTJSON_CONVERT_AS_IS == desc->field[field])
+            continue;
+
+        /* percentages are of different max buffers, the others keep the order */
+        value = in[field];
+        if (_BSTJSON_CONVERT_PERCENT == mode)
+        {
+            word = desc->field[field] / sizeof (uint64_t);
+            if ((NULL != reciprocals) && (value < _BSTJSON_CONVERT_EXACT_LIMIT / 100))
+                value = _bstjson_convert_percent_fast(value, maxBuf[word],
+                            reciprocals->value[(maxBuf - (const uint64_t *) options->bst_max_buffers_ptr) + word]);
+            else
+                value = _bstjson_convert_percent(value, maxBuf[word]);
+        }
+
+        if (value > level)
+            level = value;
+    }
+
+    if (_BSTJSON_CONVERT_CELLS == mode)
+        level = level / (uint64_t) asic->cellToByteConv;
+
+    return level;
+}
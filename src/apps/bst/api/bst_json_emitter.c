@@ -0,0 +1,216 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <string.h>
+#include <stdint.h>
+
+#include "bst_json_emitter.h"
+
+/* two decimal digits for every value from 0 to 99 */
+static const char _emitDigitPairs[200] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const char _emitHexDigits[16] = "0123456789abcdef";
+
+/******************************************************************
+ * @brief  Appends a string that needs no escaping, as is
+ *
+ * @param[in]   dst         Buffer to append to
+ * @param[in]   len         Space left in the buffer
+ * @param[in]   src         Characters to append
+ * @param[in]   srcLen      Number of characters to append
+ *
+ * @retval   number of characters appended, -1 if they do not fit
+ *
+ * @note     The output is NUL terminated, like snprintf() does.
+ *********************************************************************/
+
+int bstjson_emit_literal(char *dst, int len, const char *src, int srcLen)
+{
+    if (srcLen >= len)
+    {
+        if (len > 0)
+            dst[0] = 0;
+        return -1;
+    }
+
+    memcpy(dst, src, srcLen);
+    dst[srcLen] = 0;
+    return srcLen;
+}
+
+/******************************************************************
+ * @brief  Appends an unsigned value in decimal
+ *
+ * @param[in]   dst         Buffer to append to
+ * @param[in]   len         Space left in the buffer
+ * @param[in]   value       Value to append
+ *
+ * @retval   number of characters appended, -1 if they do not fit
+ *
+ * @note     Two digits are produced per division, the output is the
+ *           same as the one of the PRIu64 conversion.
+ *********************************************************************/
+
+int bstjson_emit_u64(char *dst, int len, uint64_t value)
+{
+    char digits[BSTJSON_EMIT_U64_MAX_DIGITS];
+    char *ptr = &digits[BSTJSON_EMIT_U64_MAX_DIGITS];
+    unsigned int pair;
+
+    while (value >= 100)
+    {
+        pair = (unsigned int) (value % 100) * 2;
+        value /= 100;
+        ptr -= 2;
+        ptr[0] = _emitDigitPairs[pair];
+        ptr[1] = _emitDigitPairs[pair + 1];
+    }
+
+    if (value >= 10)
+    {
+        pair = (unsigned int) value * 2;
+        ptr -= 2;
+        ptr[0] = _emitDigitPairs[pair];
+        ptr[1] = _emitDigitPairs[pair + 1];
+    }
+    else
+    {
+        *--ptr = (char) ('0' + value);
+    }
+
+    return bstjson_emit_literal(dst, len, ptr,
+                                (int) (&digits[BSTJSON_EMIT_U64_MAX_DIGITS] - ptr));
+}
+
+/******************************************************************
+ * @brief  Appends a signed value in decimal
+ *
+ * @param[in]   dst         Buffer to append to
+ * @param[in]   len         Space left in the buffer
+ * @param[in]   value       Value to append
+ *
+ * @retval   number of characters appended, -1 if they do not fit
+ *
+ * @note     The output is the same as the one of the %d conversion.
+ *********************************************************************/
+
+int bstjson_emit_int(char *dst, int len, int value)
+{
+    int actLen;
+
+    if (value >= 0)
+        return bstjson_emit_u64(dst, len, (uint64_t) value);
+
+    actLen = bstjson_emit_literal(dst, len, "-", 1);
+    if (actLen < 0)
+        return -1;
+
+    /* negated as unsigned, so INT_MIN does not overflow */
+    actLen = bstjson_emit_u64(dst + 1, len - 1, 0 - (uint64_t) (int64_t) value);
+    if (actLen < 0)
+    {
+        dst[0] = 0;
+        return -1;
+    }
+    return actLen + 1;
+}
+
+/******************************************************************
+ * @brief  Appends a string as a JSON string, quoted and escaped
+ *
+ * @param[in]   dst         Buffer to append to
+ * @param[in]   len         Space left in the buffer
+ * @param[in]   src         NUL terminated string to append
+ *
+ * @retval   number of characters appended, -1 if they do not fit
+ *
+ * @note     Quotes, backslashes and control characters are escaped,
+ *           everything else is copied as is.
+ *********************************************************************/
+
+int bstjson_emit_string(char *dst, int len, const char *src)
+{
+    const unsigned char *ptr = (const unsigned char *) src;
+    int actLen = 0;
+    int need = 0;
+    char escape = 0;
+
+    /* opening quote, closing quote and the NUL */
+    if (len < 3)
+    {
+        if (len > 0)
+            dst[0] = 0;
+        return -1;
+    }
+
+    dst[actLen++] = '"';
+
+    for (; *ptr != 0; ptr++)
+    {
+        switch (*ptr)
+        {
+            case '"':  escape = '"';  break;
+            case '\\': escape = '\\'; break;
+            case '\b': escape = 'b';  break;
+            case '\f': escape = 'f';  break;
+            case '\n': escape = 'n';  break;
+            case '\r': escape = 'r';  break;
+            case '\t': escape = 't';  break;
+            default:   escape = (*ptr < 0x20) ? 'u' : 0; break;
+        }
+
+        need = (0 == escape) ? 1 : (('u' == escape) ? 6 : 2);
+
+        /* room has to be left for the closing quote and the NUL */
+        if (actLen + need + 2 > len)
+        {
+            dst[0] = 0;
+            return -1;
+        }
+
+        if (0 == escape)
+        {
+            dst[actLen++] = (char) *ptr;
+            continue;
+        }
+
+        dst[actLen++] = '\\';
+        dst[actLen++] = escape;
+        if ('u' == escape)
+        {
+            dst[actLen++] = '0';
+            dst[actLen++] = '0';
+            dst[actLen++] = _emitHexDigits[*ptr >> 4];
+            dst[actLen++] = _emitHexDigits[*ptr & 0xF];
+        }
+    }
+
+    dst[actLen++] = '"';
+    dst[actLen] = 0;
+    return actLen;
+}
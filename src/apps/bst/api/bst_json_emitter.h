@@ -0,0 +1,51 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_BST_JSON_EMITTER_H
+#define INCLUDE_BST_JSON_EMITTER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+/* Appenders used by the report encoders instead of snprintf for the
+ * data cells. Every appender writes at most 'len' bytes into 'dst',
+ * including a terminating NUL, and returns the number of characters
+ * appended, not counting the NUL. When the output does not fit nothing
+ * but the NUL is written and -1 is returned.
+ */
+
+/* most characters of an unsigned 64 bit value in decimal */
+#define BSTJSON_EMIT_U64_MAX_DIGITS     20
+
+int bstjson_emit_literal(char *dst, int len, const char *src, int srcLen);
+
+int bstjson_emit_u64(char *dst, int len, uint64_t value);
+
+int bstjson_emit_int(char *dst, int len, int value);
+
+int bstjson_emit_string(char *dst, int len, const char *src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BST_JSON_EMITTER_H */
@@ -16,6 +16,8 @@
   *
   ***************************************************************************/
 
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <inttypes.h>
 #include <math.h>
@@ -26,6 +28,7 @@
 #include "configure_bst_feature.h"
 #include "configure_bst_tracking.h"
 #include "get_bst_report.h"
+#include "get_bst_history.h"
 #include "configure_bst_thresholds.h"
 #include "clear_bst_statistics.h"
 #include "clear_bst_thresholds.h"
@@ -74,7 +77,9 @@ BVIEW_STATUS bstjson_encode_get_bst_feature( int asicId,
 \"send-snapshot-on-trigger\": %d,\
 \"trigger-rate-limit-interval\": %d,\
 \"async-full-reports\": %d,\
-\"stats-in-percentage\": %d\
+\"stats-in-percentage\": %d,\
+\"async-report-format\": \"%s\",\
+\"send-window-report\": %d\
 },\
 \"id\": %d\
 }";
@@ -105,7 +110,10 @@ BVIEW_STATUS bstjson_encode_get_bst_feature( int asicId,
              pData->statUnitsInCells, 
              pData->bstMaxTriggers, pData->sendSnapshotOnTrigger,
              pData->triggerTransmitInterval, (pData->sendIncrementalReport == 0)?1:0, 
-             pData->statsInPercentage, method);
+             pData->statsInPercentage,
+             (BVIEW_REST_FORMAT_CBOR == pData->asyncReportFormat) ?
+             BVIEW_REST_FORMAT_NAME_CBOR : BVIEW_REST_FORMAT_NAME_JSON,
+             pData->sendWindowReport, method);
 
     /* setup the return value */
     *pJsonBuffer = (uint8_t *) jsonBuf;
@@ -215,13 +223,11 @@ BVIEW_STATUS bstjson_encode_get_bst_tracking( int asicId,
  *
  *********************************************************************/
 
-static BVIEW_STATUS _jsonencode_report_device ( char *jsonBuf,
-                                               const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
-                                               const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
-                                               const BSTJSON_REPORT_OPTIONS_t *options,
-                                               const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                               int bufLen,
-                                               int *length)
+BVIEW_STATUS _jsonencode_report_device ( BSTJSON_OUTPUT_t *out,
+                                        const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                        const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                        const BSTJSON_REPORT_OPTIONS_t *options,
+                                        const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
 
   char *getBstDeviceReportTemplate = "{ \"realm\" : \"device\", \"data\" : % " PRIu64 "}";
@@ -229,7 +235,6 @@ static BVIEW_STATUS _jsonencode_report_device ( char *jsonBuf,
    * we jump to the logic straight-away 
    */
   uint64_t data;
-  *length = 0;
   uint64_t maxBufVal = 0;
 
   _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding device data \n");
@@ -242,25 +247,189 @@ static BVIEW_STATUS _jsonencode_report_device ( char *jsonBuf,
   }
 
   /* if there is no change in stats since we reported last time, ignore it*/
-  if  ((previous != NULL) && (current->device.bufferCount == previous->device.bufferCount))
+  if  ((previous != NULL) && (BVIEW_BST_SNAPSHOT_DEVICE_DATA(current)->bufferCount == BVIEW_BST_SNAPSHOT_DEVICE_DATA(previous)->bufferCount))
   {
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Device data %" PRIu64 " has not changed since last reading \n",
-        current->device.bufferCount);
+        BVIEW_BST_SNAPSHOT_DEVICE_DATA(current)->bufferCount);
     return BVIEW_STATUS_SUCCESS;
   }
   /* data to be sent to collector */
-  data = current->device.bufferCount;
+  data = BVIEW_BST_SNAPSHOT_DEVICE_DATA(current)->bufferCount;
   maxBufVal = options->bst_max_buffers_ptr->device.data.maxBuf;
 
   bst_json_convert_data(options, asic, &data, maxBufVal);
 
   /* encode the JSON */
-  *length = snprintf(jsonBuf, bufLen, getBstDeviceReportTemplate, data);
-  _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding device data [%d] complete \n", *length);
+  _JSONENCODE_OUTPUT_FORMATTED_AND_ADVANCE(out, getBstDeviceReportTemplate, data);
+  _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding device data complete \n");
 
   return BVIEW_STATUS_SUCCESS;
 }
 
+/******************************************************************
+ * @brief  Encodes the realms of a report, once the snapshots are
+ *         compared and the counters converted.
+ *
+ * @note   The realms of a large report are encoded on the workers
+ *         started with bstjson_parallel_init(), if there are any and
+ *         the report is not streamed.
+ *
+ *********************************************************************/
+
+static BVIEW_STATUS _jsonencode_report_realms_converted ( BSTJSON_OUTPUT_t *out,
+                                                          int asicId,
+                                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                                          const BSTJSON_CHANGES_t *changes,
+                                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
+                                                          const BSTJSON_REPORT_OPTIONS_t *options,
+                                                          const BVIEW_ASIC_CAPABILITIES_t *asic)
+{
+    BVIEW_STATUS status;
+    int tempLength = BSTJSON_OUTPUT_LENGTH(out);
+
+    /* a realm per worker, if this is worth it */
+    status = bstjson_parallel_encode_realms(out, asicId, previous, changes, current, values,
+                                            options, asic);
+    if (BVIEW_STATUS_UNSUPPORTED != status)
+    {
+        return status;
+    }
+
+    /* get the device report */
+    status = _jsonencode_report_device(out, previous, current, options, asic);
+    _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+
+    if (BSTJSON_OUTPUT_LENGTH(out) != tempLength)
+    {
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " ,");
+    }
+
+    /* if any of the ingress encodings are required, add them to report */
+    if (options->includeIngressPortPriorityGroup ||
+        options->includeIngressPortServicePool ||
+        options->includeIngressServicePool)
+    {
+        status = _jsonencode_report_ingress(out, asicId, changes, current, values, options, asic);
+        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+    }
+
+    /* if any of the egress encodings are required, add them to report */
+    if (options->includeEgressCpuQueue ||
+        options->includeEgressMcQueue ||
+        options->includeEgressPortServicePool ||
+        options->includeEgressRqeQueue ||
+        options->includeEgressServicePool ||
+        options->includeEgressUcQueue ||
+        options->includeEgressUcQueueGroup )
+    {
+        status = _jsonencode_report_egress(out, asicId, changes, current, values, options, asic);
+        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Encodes the realms requested in the options, i.e. the 
+ *         "report" array contents of a report, with the given encoder.
+ *
+ * @param[in]   out         Output the realms are appended to
+ * @param[in]   asicId      ASIC for which this data is being encoded.
+ * @param[in]   previous    Stats of the last report, NULL for a snapshot
+ * @param[in]   current     Stats to be reported
+ * @param[in]   options     Realms and units to be reported
+ * @param[in]   asic        Capabilities of the ASIC
+ * @param[in]   encode      Encodes the realms, JSON or binary
+ *
+ * @note   For an incremental report the snapshots are compared once,
+ *         up front, and the realms walk only the entries that changed.
+ *         Counters reported in cells or in percent are converted the
+ *         same way, a realm at a time, before they are encoded. The
+ *         filter of a report narrows the entries first, so the ones it
+ *         leaves out are neither converted nor encoded.
+ *
+ *********************************************************************/
+
+BVIEW_STATUS bstjson_encode_report_realms ( BSTJSON_OUTPUT_t *out,
+                                            int asicId,
+                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                            const BSTJSON_REPORT_OPTIONS_t *options,
+                                            const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                            BSTJSON_REALMS_ENCODE_t encode)
+{
+    BVIEW_STATUS status;
+    BSTJSON_CHANGES_t changes;
+    const BSTJSON_CHANGES_t *pChanges = NULL;
+    BVIEW_BST_ASIC_SNAPSHOT_DATA_t converted;
+    void *convertedData = NULL;
+
+    if (NULL != previous)
+    {
+        status = bstjson_changes_compute(previous, current, options, &changes);
+        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+        pChanges = &changes;
+    }
+
+    /* a filtered report walks the entries its filter selects, as an incremental one does */
+    if (true == bstjson_filter_active(options))
+    {
+        if (NULL == pChanges)
+        {
+            status = bstjson_changes_all(current, options, options->sendIncrementalReport, &changes);
+            _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+        }
+
+        status = bstjson_filter_apply(current, options, asic, &changes);
+        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+        pChanges = &changes;
+    }
+
+    /* counters in the units of the report, the current ones if there is nothing to convert */
+    converted = *current;
+    if (true == bstjson_convert_needed(options, asic))
+    {
+        if (0 != posix_memalign(&convertedData, BVIEW_BST_SNAPSHOT_ALIGN,
+                                (0 == current->layout->size) ? BVIEW_BST_SNAPSHOT_ALIGN : current->layout->size))
+        {
+            return BVIEW_STATUS_OUTOFMEMORY;
+        }
+        converted.data = (uint8_t *) convertedData;
+
+        status = bstjson_convert_snapshot(current, pChanges, options, asic, &converted);
+        if (BVIEW_STATUS_SUCCESS != status)
+        {
+            free(convertedData);
+            return status;
+        }
+    }
+
+    status = encode(out, asicId, previous, pChanges, current, &converted, options, asic);
+    free(convertedData);
+
+    return status;
+}
+
+/******************************************************************
+ * @brief  Encodes the realms requested in the options, i.e. the 
+ *         "report" array contents of a JSON report.
+ *
+ * @note   The encoding ends with a separator, if anything is encoded.
+ *
+ *********************************************************************/
+
+static BVIEW_STATUS _jsonencode_report_realms ( BSTJSON_OUTPUT_t *out,
+                                                int asicId,
+                                                const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                                const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                const BSTJSON_REPORT_OPTIONS_t *options,
+                                                const BVIEW_ASIC_CAPABILITIES_t *asic)
+{
+    return bstjson_encode_report_realms(out, asicId, previous, current, options, asic,
+                                        _jsonencode_report_realms_converted);
+}
+
 static BVIEW_STATUS bstjson_realm_to_indices_get(char *realm, char *index1, char *index2)
 {
   static BSTJSON_REALM_INDEX_t bst_realm_indices_map [] = {
@@ -308,8 +477,7 @@ static BVIEW_STATUS bstjson_realm_to_indices_get(char *realm, char *index1, char
 
 }
 
-BVIEW_STATUS bstjson_encode_trigger_realm_index_info(char *buffer, int asicId,
-                                                     int bufLen,int *length,
+BVIEW_STATUS bstjson_encode_trigger_realm_index_info(BSTJSON_OUTPUT_t *out, int asicId,
                                                      char *index, int port, int queue)
 {
   char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
@@ -324,11 +492,11 @@ BVIEW_STATUS bstjson_encode_trigger_realm_index_info(char *buffer, int asicId,
       /* convert the port to an external representation */
       memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
       JSON_PORT_MAP_TO_NOTATION(port, asicId, &portStr[0]);
-       *length = snprintf(buffer, bufLen, portTemplate, &portStr[0]);
+       _JSONENCODE_OUTPUT_FORMATTED_AND_ADVANCE(out, portTemplate, &portStr[0]);
     }
     else
     {
-       *length = snprintf(buffer, bufLen, indexTemplate, index, queue);
+       _JSONENCODE_OUTPUT_FORMATTED_AND_ADVANCE(out, indexTemplate, index, queue);
     }
     return BVIEW_STATUS_SUCCESS;
   }
@@ -336,38 +504,20 @@ BVIEW_STATUS bstjson_encode_trigger_realm_index_info(char *buffer, int asicId,
 
 }
 /******************************************************************
- * @brief  Creates a JSON buffer using the supplied data for the 
- *         "get-bst-report" REST API.
- *
- * @param[in]   asicId      ASIC for which this data is being encoded.
- * @param[in]   method      Method ID (from original request) that needs 
- *                          to be encoded in JSON.
- * @param[in]   pData       Data structure holding the required parameters.
- * @param[out]  pJsonBuffer Filled-in JSON buffer
- *                           
- * @retval   BVIEW_STATUS_SUCCESS  Data is encoded into JSON successfully
- * @retval   BVIEW_STATUS_RESOURCE_NOT_AVAILABLE  Internal Error
- * @retval   BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter
- * @retval   BVIEW_STATUS_OUTOFMEMORY  No available memory to create JSON buffer
+ * @brief  Encodes the "get-bst-report" REST API into an output, for
+ *         both the buffered and the streamed report.
  *
- * @note     The returned json-encoded-buffer should be freed using the  
- *           bstjson_memory_free(). Failing to do so leads to memory leaks
  *********************************************************************/
 
-BVIEW_STATUS bstjson_encode_get_bst_report ( int asicId,
-                                            int method,
-                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
-                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
-                                            const BSTJSON_REPORT_OPTIONS_t *options,
-                                            const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                            const BVIEW_TIME_t *time,
-                                            uint8_t **pJsonBuffer
-                                            )
+static BVIEW_STATUS _jsonencode_get_bst_report ( BSTJSON_OUTPUT_t *out,
+                                                int asicId,
+                                                const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                                const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                const BSTJSON_REPORT_OPTIONS_t *options,
+                                                const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                                const BVIEW_TIME_t *time)
 {
-    char *jsonBuf, *start;
     BVIEW_STATUS status;
-    int bufferLength = BSTJSON_MEMSIZE_REPORT;
-    int tempLength = 0;
 
     time_t report_time;
     struct tm *timeinfo;
@@ -397,43 +547,23 @@ BVIEW_STATUS bstjson_encode_get_bst_report ( int asicId,
 \"counter\": \"%s\",\
 ";
 
-
-    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for Get-Bst-Report \n");
-
-    /* Validate Input Parameters */
-    _JSONENCODE_ASSERT (options != NULL);
-    _JSONENCODE_ASSERT (current != NULL);
-    _JSONENCODE_ASSERT (time != NULL);
-    _JSONENCODE_ASSERT (asic != NULL);
-
     /* obtain the time */
     memset(&timeString, 0, sizeof (timeString));
     report_time = *(time_t *) time;
     timeinfo = localtime(&report_time);
     strftime(timeString, 64, "%Y-%m-%d - %H:%M:%S ", timeinfo);
 
-    /* allocate memory for JSON */
-    status = bstjson_memory_allocate(BSTJSON_MEMSIZE_REPORT, (uint8_t **) & jsonBuf);
-    _JSONENCODE_ASSERT (status == BVIEW_STATUS_SUCCESS);
-
-    start = jsonBuf;
-
-    /* clear the buffer */
-    memset(jsonBuf, 0, BSTJSON_MEMSIZE_REPORT);
-
     /* convert asicId to external  notation */
-    JSON_ASIC_ID_MAP_TO_NOTATION(asicId, &asicIdStr[0]);
+    _JSONENCODE_ASIC_NOTATION_GET(options, asicId, &asicIdStr[0]);
 
     /* fill the header */
     /* encode the JSON */
 
     if (options->reportTrigger == false)
     {
-      tempLength = snprintf(jsonBuf, bufferLength, getBstReportStart,
+      _JSONENCODE_OUTPUT_FORMATTED_AND_ADVANCE(out, getBstReportStart,
           (options->reportThreshold == true) ? "get-bst-thresholds" :"get-bst-report",
           &asicIdStr[0], BVIEW_JSON_VERSION, timeString);
-      bufferLength -= tempLength;
-      jsonBuf += tempLength;
     }
     else
     {
@@ -443,102 +573,505 @@ BVIEW_STATUS bstjson_encode_get_bst_report ( int asicId,
       {
         return BVIEW_STATUS_INVALID_PARAMETER;
       }
-      tempLength = snprintf(jsonBuf, bufferLength, getBstTriggerReportStart,
+      _JSONENCODE_OUTPUT_FORMATTED_AND_ADVANCE(out, getBstTriggerReportStart,
           "trigger-report",
           &asicIdStr[0], BVIEW_JSON_VERSION, timeString, options->triggerInfo.realm, options->triggerInfo.counter);
 
-      jsonBuf += tempLength;
-      bufferLength -= tempLength;
       if (0 != index1[0])
       {
-        status = bstjson_encode_trigger_realm_index_info(jsonBuf, asicId, bufferLength, &tempLength, &index1[0], 
+        status = bstjson_encode_trigger_realm_index_info(out, asicId, &index1[0], 
             options->triggerInfo.port, options->triggerInfo.queue);
         _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-        bufferLength -= tempLength;
-        jsonBuf += tempLength;
       }
 
 
       if (0 != index2[0])
       {
-        status = bstjson_encode_trigger_realm_index_info(jsonBuf, asicId, bufferLength, &tempLength, &index2[0], 
+        status = bstjson_encode_trigger_realm_index_info(out, asicId, &index2[0], 
             options->triggerInfo.port, options->triggerInfo.queue);
         _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-        bufferLength -= tempLength;
-        jsonBuf += tempLength;
       }
 
-      tempLength = snprintf(jsonBuf, bufferLength, "\"report\" : [" ); 
-      bufferLength -= tempLength;
-      jsonBuf += tempLength; 
+      _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, "\"report\" : [");
     }
 
-    /* get the device report */
-    status = _jsonencode_report_device(jsonBuf, previous, current, options, asic, bufferLength, &tempLength);
+    /* get the device, ingress and egress reports */
+    status = _jsonencode_report_realms(out, asicId, previous, current, options, asic);
     _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
 
-    if (tempLength)
+    /* finalizing the report */
+
+    _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
+
+    if ((out->cur > out->buffer) && (out->cur[0] == 0))
     {
+        _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
+    }
+
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " ] } ");
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Creates a JSON buffer using the supplied data for the 
+ *         "get-bst-report" REST API.
+ *
+ * @param[in]   asicId      ASIC for which this data is being encoded.
+ * @param[in]   method      Method ID (from original request) that needs 
+ *                          to be encoded in JSON.
+ * @param[in]   pData       Data structure holding the required parameters.
+ * @param[out]  pJsonBuffer Filled-in JSON buffer
+ *                           
+ * @retval   BVIEW_STATUS_SUCCESS  Data is encoded into JSON successfully
+ * @retval   BVIEW_STATUS_RESOURCE_NOT_AVAILABLE  Internal Error
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  No available memory to create JSON buffer
+ *
+ * @note     The returned json-encoded-buffer should be freed using the  
+ *           bstjson_memory_free(). Failing to do so leads to memory leaks
+ *********************************************************************/
+
+BVIEW_STATUS bstjson_encode_get_bst_report ( int asicId,
+                                            int method,
+                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                            const BSTJSON_REPORT_OPTIONS_t *options,
+                                            const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                            const BVIEW_TIME_t *time,
+                                            uint8_t **pJsonBuffer
+                                            )
+{
+    char *jsonBuf;
+    BVIEW_STATUS status;
+    BSTJSON_OUTPUT_t out;
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for Get-Bst-Report \n");
+
+    /* Validate Input Parameters */
+    _JSONENCODE_ASSERT (options != NULL);
+    _JSONENCODE_ASSERT (current != NULL);
+    _JSONENCODE_ASSERT (time != NULL);
+    _JSONENCODE_ASSERT (asic != NULL);
+
+    /* allocate memory for JSON */
+    status = bstjson_memory_allocate(BSTJSON_MEMSIZE_REPORT, (uint8_t **) & jsonBuf);
+    _JSONENCODE_ASSERT (status == BVIEW_STATUS_SUCCESS);
+
+    /* the output is kept NUL terminated, the buffer needs no clearing */
+    bstjson_output_init(&out, jsonBuf, BSTJSON_MEMSIZE_REPORT, NULL, NULL);
+
+    status = _jsonencode_get_bst_report(&out, asicId, previous, current, options, asic, time);
+    if (status != BVIEW_STATUS_SUCCESS)
+    {
+        bstjson_memory_free((uint8_t *) jsonBuf);
+        return status;
+    }
+
+    *pJsonBuffer = (uint8_t *) jsonBuf;
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for Get-Bst-Report Complete [%d] bytes \n", (int)strlen(jsonBuf));
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_DUMPJSON, "BST-JSON-Encoder : %s \n", jsonBuf);
+
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Encodes the "get-bst-report" REST API a window at a time,
+ *         handing every window to the flush function as it fills up.
+ *
+ * @param[in]   asicId      ASIC for which this data is being encoded.
+ * @param[in]   method      Method ID (from original request) that needs 
+ *                          to be encoded in JSON.
+ * @param[in]   previous    Stats of the last report, NULL for a snapshot
+ * @param[in]   current     Stats to be reported
+ * @param[in]   options     Realms and units to be reported
+ * @param[in]   asic        Capabilities of the ASIC
+ * @param[in]   time        Time the stats are collected at
+ * @param[in]   flush       Takes the encoded report, a window at a time
+ * @param[in]   cookie      Passed to flush()
+ *                           
+ * @retval   BVIEW_STATUS_SUCCESS  the whole report is handed to flush()
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter
+ * @retval   other  as returned by flush(), the encoding stops there
+ *
+ * @note     The report is the same as the one of
+ *           bstjson_encode_get_bst_report(), but needs no more memory
+ *           than BSTJSON_OUTPUT_WINDOW_SIZE whatever its size.
+ *********************************************************************/
+
+BVIEW_STATUS bstjson_encode_get_bst_report_stream ( int asicId,
+                                                   int method,
+                                                   const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                                   const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                   const BSTJSON_REPORT_OPTIONS_t *options,
+                                                   const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                                   const BVIEW_TIME_t *time,
+                                                   BSTJSON_OUTPUT_FLUSH_t flush,
+                                                   void *cookie
+                                                   )
+{
+    char window[BSTJSON_OUTPUT_WINDOW_SIZE];
+    BVIEW_STATUS status;
+    BSTJSON_OUTPUT_t out;
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for streamed Get-Bst-Report \n");
+
+    /* Validate Input Parameters */
+    _JSONENCODE_ASSERT (options != NULL);
+    _JSONENCODE_ASSERT (current != NULL);
+    _JSONENCODE_ASSERT (time != NULL);
+    _JSONENCODE_ASSERT (asic != NULL);
+    _JSONENCODE_ASSERT (flush != NULL);
+
+    bstjson_output_init(&out, &window[0], sizeof (window), flush, cookie);
+
+    status = _jsonencode_get_bst_report(&out, asicId, previous, current, options, asic, time);
+    _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+
+    /* the last window */
+    status = bstjson_output_finish(&out);
+    _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for streamed Get-Bst-Report Complete [%d] bytes \n", BSTJSON_OUTPUT_LENGTH(&out));
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Creates a JSON buffer using the supplied data for the 
+ *         "get-bst-history" REST API.
+ *
+ * @param[in]   asicId      ASIC for which this data is being encoded.
+ * @param[in]   method      Method ID (from original request) that needs 
+ *                          to be encoded in JSON.
+ * @param[in]   next        Hands out the history entries, oldest first
+ * @param[in]   cookie      Passed to next()
+ * @param[in]   options     Realms and units to be reported
+ * @param[in]   asic        Capabilities of the ASIC
+ * @param[out]  pJsonBuffer Filled-in JSON buffer
+ *                           
+ * @retval   BVIEW_STATUS_SUCCESS  Data is encoded into JSON successfully
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  No available memory to create JSON buffer
+ *
+ * @note     The first entry is reported in full, every later one with
+ *           the counters changed since the entry before it. Entries
+ *           which do not fit in the buffer are left out and the
+ *           "truncated" member is set.
+ *           The returned json-encoded-buffer should be freed using the  
+ *           bstjson_memory_free(). Failing to do so leads to memory leaks
+ *********************************************************************/
+
+BVIEW_STATUS bstjson_encode_get_bst_history ( int asicId,
+                                             int method,
+                                             BSTJSON_HISTORY_NEXT_t next,
+                                             void *cookie,
+                                             const BSTJSON_REPORT_OPTIONS_t *options,
+                                             const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                             uint8_t **pJsonBuffer
+                                             )
+{
+    char *jsonBuf, *start, *entryStart;
+    BVIEW_STATUS status;
+    BSTJSON_OUTPUT_t out;
+    /* room kept for closing the history */
+    const int trailerLength = 64;
+    int bufferLength = BSTJSON_MEMSIZE_REPORT - trailerLength;
+    int tempLength = 0;
+    bool truncated = false;
+
+    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous, *current;
+    BVIEW_TIME_t entryTime;
+    time_t report_time;
+    struct tm *timeinfo;
+    char timeString[64];
+    char asicIdStr[JSON_MAX_NODE_LENGTH] = { 0 };
+
+    char *getBstHistoryStart = " { \
+\"jsonrpc\": \"2.0\",\
+\"method\": \"get-bst-history\",\
+\"asic-id\": \"%s\",\
+\"version\": \"%d\",\
+\"history\": [ \
+";
+
+    char *getBstHistoryEntryStart = "{ \"time-stamp\": \"%s\", \"report\": [ ";
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for Get-Bst-History \n");
+
+    /* Validate Input Parameters */
+    _JSONENCODE_ASSERT (next != NULL);
+    _JSONENCODE_ASSERT (options != NULL);
+    _JSONENCODE_ASSERT (asic != NULL);
+    _JSONENCODE_ASSERT (pJsonBuffer != NULL);
+
+    /* allocate memory for JSON */
+    status = bstjson_memory_allocate(BSTJSON_MEMSIZE_REPORT, (uint8_t **) & jsonBuf);
+    _JSONENCODE_ASSERT (status == BVIEW_STATUS_SUCCESS);
+
+    start = jsonBuf;
+    /* the caller frees the buffer, even if the encoding fails */
+    *pJsonBuffer = (uint8_t *) start;
+
+    /* clear the buffer */
+    memset(jsonBuf, 0, BSTJSON_MEMSIZE_REPORT);
+
+    /* convert asicId to external  notation */
+    _JSONENCODE_ASIC_NOTATION_GET(options, asicId, &asicIdStr[0]);
+
+    /* fill the header */
+    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(tempLength, jsonBuf, bufferLength, &tempLength,
+                                                  getBstHistoryStart, &asicIdStr[0], BVIEW_JSON_VERSION);
+
+    while (next(cookie, &previous, &current, &entryTime) == BVIEW_STATUS_SUCCESS)
+    {
+        entryStart = jsonBuf;
+
+        /* obtain the time */
+        memset(&timeString, 0, sizeof (timeString));
+        report_time = *(time_t *) &entryTime;
+        timeinfo = localtime(&report_time);
+        strftime(timeString, 64, "%Y-%m-%d - %H:%M:%S ", timeinfo);
+
+        tempLength = snprintf(jsonBuf, bufferLength, getBstHistoryEntryStart, timeString);
+        if (tempLength >= bufferLength)
+        {
+            truncated = true;
+            break;
+        }
         bufferLength -= tempLength;
         jsonBuf += tempLength;
 
-        tempLength = snprintf(jsonBuf, bufferLength, " ,");
+        bstjson_output_init(&out, jsonBuf, bufferLength, NULL, NULL);
+        status = _jsonencode_report_realms(&out, asicId, previous, current, options, asic);
+        tempLength = BSTJSON_OUTPUT_LENGTH(&out);
+        if (status == BVIEW_STATUS_OUTOFMEMORY)
+        {
+            truncated = true;
+        }
+        else if (status != BVIEW_STATUS_SUCCESS)
+        {
+            return status;
+        }
+        else
+        {
+            bufferLength -= tempLength;
+            jsonBuf += tempLength;
+
+            /* drop the separator after the last realm */
+            while ((jsonBuf[-1] == ',') || (jsonBuf[-1] == ' '))
+            {
+                bufferLength++;
+                jsonBuf--;
+            }
+
+            tempLength = snprintf(jsonBuf, bufferLength, " ] },");
+            if (tempLength >= bufferLength)
+            {
+                truncated = true;
+            }
+        }
+
+        if (truncated == true)
+        {
+            /* leave the entry out altogether */
+            bufferLength += (jsonBuf - entryStart);
+            jsonBuf = entryStart;
+            *jsonBuf = 0;
+            break;
+        }
 
         bufferLength -= tempLength;
         jsonBuf += tempLength;
     }
 
-    /* if any of the ingress encodings are required, add them to report */
-    if (options->includeIngressPortPriorityGroup ||
-        options->includeIngressPortServicePool ||
-        options->includeIngressServicePool)
+    /* drop the separator after the last entry */
+    if (jsonBuf[-1] == ',')
     {
-        status = _jsonencode_report_ingress(jsonBuf, asicId, previous, current, options, asic, bufferLength, &tempLength);
-        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+        bufferLength++;
+        jsonBuf--;
+    }
 
-        /* adjust the buffer */
-        bufferLength -= (tempLength);
-        jsonBuf += (tempLength);
+    /* finalizing the history, the trailer has its room kept */
+    bufferLength += trailerLength;
+    tempLength = snprintf(jsonBuf, bufferLength, " ], \"truncated\": %s, \"id\": %d } ",
+                          (truncated == true) ? "true" : "false", method);
 
-    }
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for Get-Bst-History Complete [%d] bytes \n", (int)strlen(start));
 
-    /* if any of the egress encodings are required, add them to report */
-    if (options->includeEgressCpuQueue ||
-        options->includeEgressMcQueue ||
-        options->includeEgressPortServicePool ||
-        options->includeEgressRqeQueue ||
-        options->includeEgressServicePool ||
-        options->includeEgressUcQueue ||
-        options->includeEgressUcQueueGroup )
-    {
-        status = _jsonencode_report_egress(jsonBuf, asicId, previous, current, options, asic, bufferLength, &tempLength);
-        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_DUMPJSON, "BST-JSON-Encoder : %s \n", start);
 
-        /* adjust the buffer */
-        bufferLength -= (tempLength);
-        jsonBuf += (tempLength);
+    return BVIEW_STATUS_SUCCESS;
+}
 
-    }
+/******************************************************************
+ * @brief  Creates a JSON buffer using the supplied data for the 
+ *         "window-report" asynchronous report.
+ *
+ * @param[in]   asicId      ASIC for which this data is being encoded.
+ * @param[in]   peak        Highest value of every counter in the window
+ * @param[in]   min         Lowest value of every counter in the window
+ * @param[in]   mean        Mean value of every counter in the window
+ * @param[in]   samples     Number of samples taken in the window
+ * @param[in]   options     Realms and units to be reported
+ * @param[in]   asic        Capabilities of the ASIC
+ * @param[in]   startTime   Time of the first sample of the window
+ * @param[in]   endTime     Time the window is closed at
+ * @param[out]  pJsonBuffer Filled-in JSON buffer
+ *                           
+ * @retval   BVIEW_STATUS_SUCCESS  Data is encoded into JSON successfully
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  No available memory to create JSON buffer
+ *
+ * @note     Only the non zero counters are reported. An aggregate which
+ *           does not fit in the buffer is reported empty and the 
+ *           "truncated" member is set.
+ *           The returned json-encoded-buffer should be freed using the  
+ *           bstjson_memory_free(). Failing to do so leads to memory leaks
+ *********************************************************************/
 
-    /* finalizing the report */
+BVIEW_STATUS bstjson_encode_window_report ( int asicId,
+                                           const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *peak,
+                                           const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *min,
+                                           const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *mean,
+                                           unsigned int samples,
+                                           const BSTJSON_REPORT_OPTIONS_t *options,
+                                           const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                           const BVIEW_TIME_t *startTime,
+                                           const BVIEW_TIME_t *endTime,
+                                           uint8_t **pJsonBuffer
+                                           )
+{
+    char *jsonBuf, *start, *aggregateStart;
+    BVIEW_STATUS status;
+    BSTJSON_OUTPUT_t out;
+    /* room kept for closing the report */
+    const int trailerLength = 64;
+    int bufferLength = BSTJSON_MEMSIZE_REPORT - trailerLength;
+    int tempLength = 0;
+    int encodedLength = 0;
+    bool truncated = false;
+    unsigned int i = 0;
 
-    bufferLength -= 1;
-    jsonBuf -= 1;
+    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *aggregates[3];
+    const char *aggregateNames[3] = { "peak", "min", "mean" };
+    time_t report_time;
+    struct tm *timeinfo;
+    char startString[64];
+    char endString[64];
+    char asicIdStr[JSON_MAX_NODE_LENGTH] = { 0 };
 
-    if (jsonBuf[0] == 0)
-    {
-        bufferLength -= 1;
-        jsonBuf--;
-    }
+    char *getBstWindowReportStart = " { \
+\"jsonrpc\": \"2.0\",\
+\"method\": \"window-report\",\
+\"asic-id\": \"%s\",\
+\"version\": \"%d\",\
+\"time-stamp\": \"%s\",\
+\"window-start\": \"%s\",\
+\"samples\": %u,\
+";
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for Window-Report \n");
+
+    /* Validate Input Parameters */
+    _JSONENCODE_ASSERT (peak != NULL);
+    _JSONENCODE_ASSERT (min != NULL);
+    _JSONENCODE_ASSERT (mean != NULL);
+    _JSONENCODE_ASSERT (options != NULL);
+    _JSONENCODE_ASSERT (asic != NULL);
+    _JSONENCODE_ASSERT (startTime != NULL);
+    _JSONENCODE_ASSERT (endTime != NULL);
+    _JSONENCODE_ASSERT (pJsonBuffer != NULL);
+
+    aggregates[0] = peak;
+    aggregates[1] = min;
+    aggregates[2] = mean;
+
+    /* obtain the times */
+    memset(&startString, 0, sizeof (startString));
+    report_time = *(time_t *) startTime;
+    timeinfo = localtime(&report_time);
+    strftime(startString, 64, "%Y-%m-%d - %H:%M:%S ", timeinfo);
+
+    memset(&endString, 0, sizeof (endString));
+    report_time = *(time_t *) endTime;
+    timeinfo = localtime(&report_time);
+    strftime(endString, 64, "%Y-%m-%d - %H:%M:%S ", timeinfo);
 
-    tempLength = snprintf(jsonBuf, bufferLength, " ] } ");
+    /* allocate memory for JSON */
+    status = bstjson_memory_allocate(BSTJSON_MEMSIZE_REPORT, (uint8_t **) & jsonBuf);
+    _JSONENCODE_ASSERT (status == BVIEW_STATUS_SUCCESS);
 
+    start = jsonBuf;
+    /* the caller frees the buffer, even if the encoding fails */
     *pJsonBuffer = (uint8_t *) start;
 
-    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for Get-Bst-Report Complete [%d] bytes \n", (int)strlen(start));
+    /* clear the buffer */
+    memset(jsonBuf, 0, BSTJSON_MEMSIZE_REPORT);
 
-    _JSONENCODE_LOG(_JSONENCODE_DEBUG_DUMPJSON, "BST-JSON-Encoder : %s \n", start);
+    /* convert asicId to external  notation */
+    _JSONENCODE_ASIC_NOTATION_GET(options, asicId, &asicIdStr[0]);
+
+    /* fill the header */
+    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(tempLength, jsonBuf, bufferLength, &encodedLength,
+                                                  getBstWindowReportStart, &asicIdStr[0], BVIEW_JSON_VERSION,
+                                                  endString, startString, samples);
+
+    for (i = 0; i < 3; i++)
+    {
+        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(tempLength, jsonBuf, bufferLength, &encodedLength,
+                                                      "\"%s\": [ ", aggregateNames[i]);
+        aggregateStart = jsonBuf;
+
+        bstjson_output_init(&out, jsonBuf, bufferLength, NULL, NULL);
+        status = _jsonencode_report_realms(&out, asicId, NULL, aggregates[i], options, asic);
+        tempLength = BSTJSON_OUTPUT_LENGTH(&out);
+        if (status == BVIEW_STATUS_OUTOFMEMORY)
+        {
+            /* report the aggregate empty */
+            truncated = true;
+            tempLength = 0;
+            *jsonBuf = 0;
+        }
+        else if (status != BVIEW_STATUS_SUCCESS)
+        {
+            return status;
+        }
+
+        bufferLength -= tempLength;
+        jsonBuf += tempLength;
 
+        /* drop the separator after the last realm */
+        while ((jsonBuf > aggregateStart) &&
+               ((jsonBuf[-1] == ',') || (jsonBuf[-1] == ' ')))
+        {
+            bufferLength++;
+            jsonBuf--;
+        }
+
+        tempLength = snprintf(jsonBuf, bufferLength, " ],");
+        if (tempLength >= bufferLength)
+        {
+            /* the remaining aggregates can not be closed any more */
+            *jsonBuf = 0;
+            truncated = true;
+            break;
+        }
+        bufferLength -= tempLength;
+        jsonBuf += tempLength;
+    }
+
+    /* finalizing the report, the trailer has its room kept */
+    bufferLength += trailerLength;
+    tempLength = snprintf(jsonBuf, bufferLength, " \"truncated\": %s } ",
+                          (truncated == true) ? "true" : "false");
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for Window-Report Complete [%d] bytes \n", (int)strlen(start));
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_DUMPJSON, "BST-JSON-Encoder : %s \n", start);
 
     return BVIEW_STATUS_SUCCESS;
 }
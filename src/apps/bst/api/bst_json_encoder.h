@@ -28,6 +28,86 @@ extern "C"
 #include "json.h"
 
 #include "bst.h"
+#include "bst_json_emitter.h"
+#include "bst_json_output.h"
+
+/* most indices (priority groups, pools, queues) a realm has */
+#define BSTJSON_NOTATION_MAX_INDEX      BVIEW_ASIC_MAX_UC_QUEUES
+
+/* most workers encoding the realms of a report, besides the thread
+   asking for the report */
+#define BSTJSON_PARALLEL_MAX_WORKERS    8
+
+/* entries a report carries, at least, for its realms to be encoded on
+   the workers. Smaller ones do not make up for waking them up */
+#define BSTJSON_PARALLEL_MIN_ENTRIES    2048
+
+/* a port in external notation, quoted and escaped */
+typedef struct _bst_json_port_notation_
+{
+    /* 0 if the notation did not fit, the port is translated when encoded */
+    int length;
+    char str[JSON_MAX_NODE_LENGTH + 8];
+} BSTJSON_PORT_NOTATION_t;
+
+/* an index in decimal */
+typedef struct _bst_json_index_notation_
+{
+    int length;
+    char str[8];
+} BSTJSON_INDEX_NOTATION_t;
+
+/* external notation of the asic and of the ports of a unit, rendered
+   once so the encoders need not go through the south bound for every
+   port of every report */
+typedef struct _bst_json_notation_
+{
+    /* asic id, as is */
+    char asic[JSON_MAX_NODE_LENGTH];
+    /* ports 1 to numPorts, by port number */
+    int numPorts;
+    BSTJSON_PORT_NOTATION_t port[BVIEW_ASIC_MAX_PORTS + 1];
+    BSTJSON_INDEX_NOTATION_t index[BSTJSON_NOTATION_MAX_INDEX];
+} BSTJSON_NOTATION_t;
+
+/* words of a max buffers snapshot, every max buffer is a 64 bit word */
+#define BSTJSON_MAX_BUF_WORDS   \
+        (sizeof (BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t) / sizeof (uint64_t))
+
+/* reciprocals of the max buffers of a unit, word for word, taken once
+   when the max buffers are read so percentages need no division */
+typedef struct _bst_json_max_buf_reciprocals_
+{
+    /* max buffers the reciprocals were taken of */
+    BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t maxBuffers;
+    bool valid;
+    /* 1 / max buffer, 0 for a max buffer of 0 */
+    double value[BSTJSON_MAX_BUF_WORDS];
+    /* every max buffer is small enough for its reciprocal to give the
+       exact percentage after one correction */
+    bool exact;
+} BSTJSON_MAX_BUF_RECIPROCALS_t;
+
+/* bits a change bitmap needs for the largest snapshot, at least one
+   counter per entry and a partly used word per realm */
+#define BSTJSON_CHANGES_MAX_WORDS       \
+        (BVIEW_BST_SNAPSHOT_MAX_SIZE / (sizeof (uint64_t) * 64) + BVIEW_BST_SNAPSHOT_REALM_MAX)
+
+/* entries which changed between two snapshots, a bit per entry of each
+   realm. Only the counters a report carries count as a change */
+typedef struct _bst_json_changes_
+{
+    /* entries of each realm, 0 for a realm not compared */
+    unsigned int entries[BVIEW_BST_SNAPSHOT_REALM_MAX];
+    /* first word of each realm in bits[] */
+    unsigned int base[BVIEW_BST_SNAPSHOT_REALM_MAX];
+    uint64_t bits[BSTJSON_CHANGES_MAX_WORDS];
+} BSTJSON_CHANGES_t;
+
+/* whether an entry of a realm changed */
+#define BSTJSON_CHANGES_TEST(_changes, _realm, _entry)                           \
+        (0 != ((_changes)->bits[(_changes)->base[(_realm)] + (_entry) / 64] &    \
+               (1ULL << ((_entry) % 64))))
 
 /* reporting options */
 typedef struct _bst_reporting_options_
@@ -51,8 +131,32 @@ typedef struct _bst_reporting_options_
     bool sendIncrementalReport;
     bool statsInPercentage;
     BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *bst_max_buffers_ptr;
+    /* reciprocals of the max buffers above, NULL to divide */
+    const BSTJSON_MAX_BUF_RECIPROCALS_t *bst_max_buffers_reciprocals;
+    /* notation of the unit, NULL to translate while encoding */
+    const BSTJSON_NOTATION_t *notation;
+    /* entries of the realms reported, all of them when zeroed */
+    BVIEW_BST_REPORT_FILTER_t filter;
 } BSTJSON_REPORT_OPTIONS_t;
 
+/* hands out the entries of a history one per call, returns
+   BVIEW_STATUS_SUCCESS as long as there is an entry */
+typedef BVIEW_STATUS (*BSTJSON_HISTORY_NEXT_t) (void *cookie,
+                                                const BVIEW_BST_ASIC_SNAPSHOT_DATA_t **previous,
+                                                const BVIEW_BST_ASIC_SNAPSHOT_DATA_t **current,
+                                                BVIEW_TIME_t *time);
+
+/* encodes the realms of a report once the snapshots are compared, 'changes'
+   NULL for a snapshot, and the counters are converted into 'values' */
+typedef BVIEW_STATUS (*BSTJSON_REALMS_ENCODE_t) (BSTJSON_OUTPUT_t *out,
+                                                 int asicId,
+                                                 const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                                 const BSTJSON_CHANGES_t *changes,
+                                                 const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                 const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
+                                                 const BSTJSON_REPORT_OPTIONS_t *options,
+                                                 const BVIEW_ASIC_CAPABILITIES_t *asic);
+
 /* structure to map the realms and indices */
 
 typedef struct _bst_realm_index_ {
@@ -106,8 +210,192 @@ typedef struct _bst_realm_index_ {
         (len) -= (actLen); \
     } while(0)
 
+/* Appends the output of one of the bstjson_emit_*() functions, for the
+ * data cells of the reports where snprintf() is too slow */
+#define _JSONENCODE_EMIT_AND_ADVANCE(dst, len, lenptr, emitted) \
+    do { \
+        int xemitted = (emitted); \
+        if (xemitted < 0) { \
+            /* Out of buffer here */ \
+            _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (%s:%d) Out of Json memory while encoding \n", __func__, __LINE__); \
+            return BVIEW_STATUS_OUTOFMEMORY; \
+        } \
+        *(lenptr) += xemitted; \
+        (dst) += xemitted; \
+        (len) -= xemitted; \
+    } while(0)
+
+/* 'literal' must be a string literal */
+#define _JSONENCODE_APPEND_LITERAL_AND_ADVANCE(dst, len, lenptr, literal) \
+    _JSONENCODE_EMIT_AND_ADVANCE((dst), (len), (lenptr), \
+                                 bstjson_emit_literal((dst), (len), (literal), (int) sizeof (literal) - 1))
+
+/* appends 'str' quoted and escaped */
+#define _JSONENCODE_APPEND_STRING_AND_ADVANCE(dst, len, lenptr, str) \
+    _JSONENCODE_EMIT_AND_ADVANCE((dst), (len), (lenptr), bstjson_emit_string((dst), (len), (str)))
+
+/* appends the quoted notation of a port, from the table of the unit if
+   there is one */
+#define _JSONENCODE_APPEND_PORT_AND_ADVANCE(dst, len, lenptr, options, asicId, prt) \
+    do { \
+        const BSTJSON_NOTATION_t *xnotation = (options)->notation; \
+        int xport = (int) (prt); \
+        if ((NULL != xnotation) && (xport > 0) && (xport <= xnotation->numPorts) && \
+            (0 != xnotation->port[xport].length)) { \
+            _JSONENCODE_EMIT_AND_ADVANCE((dst), (len), (lenptr), \
+                                         bstjson_emit_literal((dst), (len), xnotation->port[xport].str, \
+                                                              xnotation->port[xport].length)); \
+        } else { \
+            char xportStr[JSON_MAX_NODE_LENGTH] = { 0 }; \
+            JSON_PORT_MAP_TO_NOTATION(xport, (asicId), &xportStr[0]); \
+            _JSONENCODE_APPEND_STRING_AND_ADVANCE((dst), (len), (lenptr), &xportStr[0]); \
+        } \
+    } while(0)
+
+/* Appends to the output of a report, see bst_json_output.h. The
+ * encoder returns whatever stops the append: the buffer running out,
+ * or the flush function failing for a streamed report */
+#define _JSONENCODE_OUTPUT_AND_ADVANCE(appended) \
+    do { \
+        BVIEW_STATUS xstatus = (appended); \
+        if (BVIEW_STATUS_SUCCESS != xstatus) { \
+            _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (%s:%d) Output stopped while encoding [%d] \n", __func__, __LINE__, xstatus); \
+            return xstatus; \
+        } \
+    } while(0)
+
+/* 'literal' must be a string literal */
+#define _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, literal) \
+    _JSONENCODE_OUTPUT_AND_ADVANCE(bstjson_output_literal((out), (literal), (int) sizeof (literal) - 1))
+
+#define _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out, value) \
+    _JSONENCODE_OUTPUT_AND_ADVANCE(bstjson_output_u64((out), (value)))
+
+#define _JSONENCODE_OUTPUT_FORMATTED_AND_ADVANCE(out, format, args...) \
+    _JSONENCODE_OUTPUT_AND_ADVANCE(bstjson_output_format((out), format, ##args))
+
+/* appends the quoted notation of a port, from the table of the unit if
+   there is one */
+#define _JSONENCODE_OUTPUT_PORT_AND_ADVANCE(out, options, asicId, prt) \
+    do { \
+        const BSTJSON_NOTATION_t *xnotation = (options)->notation; \
+        int xport = (int) (prt); \
+        if ((NULL != xnotation) && (xport > 0) && (xport <= xnotation->numPorts) && \
+            (0 != xnotation->port[xport].length)) { \
+            _JSONENCODE_OUTPUT_AND_ADVANCE(bstjson_output_literal((out), xnotation->port[xport].str, \
+                                                                  xnotation->port[xport].length)); \
+        } else { \
+            char xportStr[JSON_MAX_NODE_LENGTH] = { 0 }; \
+            JSON_PORT_MAP_TO_NOTATION(xport, (asicId), &xportStr[0]); \
+            _JSONENCODE_OUTPUT_AND_ADVANCE(bstjson_output_string((out), &xportStr[0])); \
+        } \
+    } while(0)
+
+/* appends a priority group, pool or queue number */
+#define _JSONENCODE_OUTPUT_INDEX_AND_ADVANCE(out, options, idx) \
+    do { \
+        const BSTJSON_NOTATION_t *xnotation = (options)->notation; \
+        int xindex = (idx); \
+        if ((NULL != xnotation) && (xindex >= 0) && (xindex < BSTJSON_NOTATION_MAX_INDEX)) { \
+            _JSONENCODE_OUTPUT_AND_ADVANCE(bstjson_output_literal((out), xnotation->index[xindex].str, \
+                                                                  xnotation->index[xindex].length)); \
+        } else { \
+            _JSONENCODE_OUTPUT_AND_ADVANCE(bstjson_output_int((out), xindex)); \
+        } \
+    } while(0)
+
+/* takes back the last 'count' characters appended, the window keeps
+   BSTJSON_OUTPUT_HOLD of them when it is flushed */
+#define _JSONENCODE_OUTPUT_BACKTRACK(out, count) \
+    do { \
+        (out)->cur -= (count); \
+        (out)->rem += (count); \
+    } while(0)
+
+/* copies the notation of the asic, from the table of the unit if there is one.
+   asicStr holds JSON_MAX_NODE_LENGTH characters and is always terminated */
+#define _JSONENCODE_ASIC_NOTATION_GET(options, asicId, asicStr) \
+    do { \
+        if ((NULL != (options)->notation) && (0 != (options)->notation->asic[0])) { \
+            size_t xasicLen = strnlen((options)->notation->asic, JSON_MAX_NODE_LENGTH - 1); \
+            memcpy((asicStr), (options)->notation->asic, xasicLen); \
+            (asicStr)[xasicLen] = 0; \
+        } else { \
+            JSON_ASIC_ID_MAP_TO_NOTATION((asicId), (asicStr)); \
+        } \
+    } while(0)
+
 /* Prototypes */
 
+BVIEW_STATUS bstjson_notation_build(int asicId,
+                                    const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                    BSTJSON_NOTATION_t *notation);
+
+BVIEW_STATUS bstjson_changes_compute(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                     const BSTJSON_REPORT_OPTIONS_t *options,
+                                     BSTJSON_CHANGES_t *changes);
+
+int bstjson_changes_next(const BSTJSON_CHANGES_t *changes,
+                         BVIEW_BST_SNAPSHOT_REALM_t realm, int from);
+
+unsigned int bstjson_changes_count(const BSTJSON_CHANGES_t *changes,
+                                   BVIEW_BST_SNAPSHOT_REALM_t realm);
+
+BVIEW_STATUS bstjson_changes_all(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                 const BSTJSON_REPORT_OPTIONS_t *options,
+                                 bool nonZeroOnly,
+                                 BSTJSON_CHANGES_t *changes);
+
+void bstjson_realms_included(const BSTJSON_REPORT_OPTIONS_t *options,
+                             bool include[BVIEW_BST_SNAPSHOT_REALM_MAX]);
+
+BVIEW_STATUS bstjson_max_buf_reciprocals_update(const BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBuffers,
+                                               BSTJSON_MAX_BUF_RECIPROCALS_t *reciprocals);
+
+bool bstjson_convert_needed(const BSTJSON_REPORT_OPTIONS_t *options,
+                            const BVIEW_ASIC_CAPABILITIES_t *asic);
+
+BVIEW_STATUS bstjson_convert_snapshot(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                      const BSTJSON_CHANGES_t *changes,
+                                      const BSTJSON_REPORT_OPTIONS_t *options,
+                                      const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                      BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values);
+
+uint64_t bstjson_convert_level(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                               const BSTJSON_REPORT_OPTIONS_t *options,
+                               const BVIEW_ASIC_CAPABILITIES_t *asic,
+                               BVIEW_BST_SNAPSHOT_REALM_t realm,
+                               unsigned int entry, bool percent);
+
+bool bstjson_filter_active(const BSTJSON_REPORT_OPTIONS_t *options);
+
+BVIEW_STATUS bstjson_filter_apply(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                  const BSTJSON_REPORT_OPTIONS_t *options,
+                                  const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                  BSTJSON_CHANGES_t *changes);
+
+BVIEW_STATUS bstjson_encode_report_realms(BSTJSON_OUTPUT_t *out,
+                                          int asicId,
+                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                          const BSTJSON_REPORT_OPTIONS_t *options,
+                                          const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                          BSTJSON_REALMS_ENCODE_t encode);
+
+BVIEW_STATUS bstjson_parallel_init(int workers);
+
+void bstjson_parallel_deinit(void);
+
+BVIEW_STATUS bstjson_parallel_encode_realms(BSTJSON_OUTPUT_t *out,
+                                            int asicId,
+                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                            const BSTJSON_CHANGES_t *changes,
+                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
+                                            const BSTJSON_REPORT_OPTIONS_t *options,
+                                            const BVIEW_ASIC_CAPABILITIES_t *asic);
+
 BVIEW_STATUS bstjson_encode_get_bst_feature(int asicId,
                                             int method,
                                             const BSTJSON_CONFIGURE_BST_FEATURE_t *pData,
@@ -131,26 +419,93 @@ BVIEW_STATUS bstjson_encode_get_bst_report(int asicId,
                                            uint8_t **pJsonBuffer
                                            );
 
-BVIEW_STATUS _jsonencode_report_ingress(char *buffer,
+BVIEW_STATUS bstjson_encode_get_bst_report_stream(int asicId,
+                                                  int method,
+                                                  const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                                  const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                  const BSTJSON_REPORT_OPTIONS_t *options,
+                                                  const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                                  const BVIEW_TIME_t *reportTime,
+                                                  BSTJSON_OUTPUT_FLUSH_t flush,
+                                                  void *cookie
+                                                  );
+
+BVIEW_STATUS bstjson_encode_get_bst_history(int asicId,
+                                            int method,
+                                            BSTJSON_HISTORY_NEXT_t next,
+                                            void *cookie,
+                                            const BSTJSON_REPORT_OPTIONS_t *options,
+                                            const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                            uint8_t **pJsonBuffer
+                                            );
+
+BVIEW_STATUS bstjson_encode_window_report(int asicId,
+                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *peak,
+                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *min,
+                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *mean,
+                                          unsigned int samples,
+                                          const BSTJSON_REPORT_OPTIONS_t *options,
+                                          const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                          const BVIEW_TIME_t *startTime,
+                                          const BVIEW_TIME_t *endTime,
+                                          uint8_t **pJsonBuffer
+                                          );
+
+BVIEW_STATUS bstjson_encode_get_bst_histogram(int asicId,
+                                              int method,
+                                              const BVIEW_BST_ASIC_HISTOGRAM_DATA_t *histogram,
+                                              const BSTJSON_REPORT_OPTIONS_t *options,
+                                              const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                              const BVIEW_TIME_t *startTime,
+                                              const BVIEW_TIME_t *endTime,
+                                              uint8_t **pJsonBuffer
+                                              );
+
+BVIEW_STATUS _jsonencode_report_device(BSTJSON_OUTPUT_t *out,
+                                       const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                       const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                       const BSTJSON_REPORT_OPTIONS_t *options,
+                                       const BVIEW_ASIC_CAPABILITIES_t *asic
+                                       );
+
+BVIEW_STATUS _jsonencode_report_ingress(BSTJSON_OUTPUT_t *out,
                                         int asicId,
-                                        const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                        const BSTJSON_CHANGES_t *changes,
                                         const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                        const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
                                         const BSTJSON_REPORT_OPTIONS_t *options,
-                                        const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                        int bufLen,
-                                        int *length
+                                        const BVIEW_ASIC_CAPABILITIES_t *asic
                                         );
 
-BVIEW_STATUS _jsonencode_report_egress(char *buffer,
+BVIEW_STATUS _jsonencode_report_egress(BSTJSON_OUTPUT_t *out,
                                        int asicId,
-                                       const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                       const BSTJSON_CHANGES_t *changes,
                                        const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                       const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
                                        const BSTJSON_REPORT_OPTIONS_t *options,
-                                       const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                       int bufLen,
-                                       int *length
+                                       const BVIEW_ASIC_CAPABILITIES_t *asic
                                        );
 
+BVIEW_STATUS _jsonencode_report_ingress_realm(BSTJSON_OUTPUT_t *out,
+                                              int asicId,
+                                              BVIEW_BST_SNAPSHOT_REALM_t realm,
+                                              const BSTJSON_CHANGES_t *changes,
+                                              const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                              const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
+                                              const BSTJSON_REPORT_OPTIONS_t *options,
+                                              const BVIEW_ASIC_CAPABILITIES_t *asic
+                                              );
+
+BVIEW_STATUS _jsonencode_report_egress_realm(BSTJSON_OUTPUT_t *out,
+                                             int asicId,
+                                             BVIEW_BST_SNAPSHOT_REALM_t realm,
+                                             const BSTJSON_CHANGES_t *changes,
+                                             const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                             const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
+                                             const BSTJSON_REPORT_OPTIONS_t *options,
+                                             const BVIEW_ASIC_CAPABILITIES_t *asic
+                                             );
+
 /******************************************************************* 
    Utility function to convert the data based on config 
 ********************************************************************/
@@ -158,6 +513,8 @@ BVIEW_STATUS bst_json_convert_data(const BSTJSON_REPORT_OPTIONS_t *options,
                                           const BVIEW_ASIC_CAPABILITIES_t *asic,
                                           uint64_t *value, uint64_t defVal);
 
+uint64_t round_int(double r);
+
 #ifdef __cplusplus
 }
 #endif
@@ -35,32 +35,34 @@
  *         "get-bst-report" REST API - egress CPU Queue.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_egress_cpuq ( char *buffer, int asicId,
-                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+static BVIEW_STATUS _jsonencode_report_egress_cpuq ( BSTJSON_OUTPUT_t *out, int asicId,
+                                                    const BSTJSON_CHANGES_t *changes,
                                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
                                                     const BSTJSON_REPORT_OPTIONS_t *options,
-                                                    const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                    int bufLen,
-                                                    int *length)
+                                                    const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
     int queue = 0;
     uint64_t val = 0;
-    uint64_t maxBufVal = 0;
     int sendIncrReport = options->sendIncrementalReport;
 
-    char *realmTemplate = " { \"realm\": \"egress-cpu-queue\", \"%s\": [ ";
-    char *cpuqTemplate = " [  %d , %" PRIu64 ", %" PRIu64 " ] ,";
-
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - CPU Queue data \n");
 
     /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, realmTemplate, "data");
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out,
+                                           " { \"realm\": \"egress-cpu-queue\", \"data\": [ ");
 
     /* For each queue, check if there is a difference, and create the report. */
     for (queue = 1; queue <= asic->numCpuQueues; queue++)
     {
+        /* in an incremental report, go straight to the next one that changed */
+        if (NULL != changes)
+        {
+            queue = bstjson_changes_next(changes, BVIEW_BST_SNAPSHOT_CPUQ, queue - 1) + 1;
+            if ((queue <= 0) || (queue > asic->numCpuQueues))
+                break;
+        }
+
       /* check if the trigger report request should contain snap shot */
         if ((queue-1 != options->triggerInfo.queue) && 
             (false == options->sendSnapShotOnTrigger) && 
@@ -72,37 +74,30 @@ static BVIEW_STATUS _jsonencode_report_egress_cpuq ( char *buffer, int asicId,
         /* if this queue needs not be reported, then we move to next queue */
       if (true == sendIncrReport)
       {
-        if ((NULL == previous) &&
-            (current->cpqQ.data[queue - 1].cpuBufferCount == 0) &&
-            (current->cpqQ.data[queue - 1].cpuQueueEntries == 0))
+        if ((NULL == changes) &&
+            (BVIEW_BST_SNAPSHOT_CPUQ_DATA(current, queue - 1)->cpuBufferCount == 0) &&
+            (BVIEW_BST_SNAPSHOT_CPUQ_DATA(current, queue - 1)->cpuQueueEntries == 0))
             continue;
       }
 
-        if ((previous != NULL) &&
-            (previous->cpqQ.data[queue - 1].cpuBufferCount == current->cpqQ.data[queue - 1].cpuBufferCount) &&
-            (previous->cpqQ.data[queue - 1].cpuQueueEntries == current->cpqQ.data[queue - 1].cpuQueueEntries))
-            continue;
-
-             val = current->cpqQ.data[queue - 1].cpuBufferCount;
-             maxBufVal = options->bst_max_buffers_ptr->cpqQ.data[queue - 1].cpuMaxBuf;
-             bst_json_convert_data(options, asic, &val, maxBufVal);
+             val = BVIEW_BST_SNAPSHOT_CPUQ_DATA(values, queue - 1)->cpuBufferCount;
         /* Now that this queue needs to be included in the report, add the data to report */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      cpuqTemplate, queue-1,
-                                                      val,
-                                                      current->cpqQ.data[queue - 1].cpuQueueEntries
-                                                      );
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " [  ");
+        _JSONENCODE_OUTPUT_INDEX_AND_ADVANCE(out, options, queue - 1);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " , ");
+        _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out, val);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, ", ");
+        _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out,
+                                           BVIEW_BST_SNAPSHOT_CPUQ_DATA(current, queue - 1)->cpuQueueEntries);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " ] ,");
 
     }
 
     /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+    _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
 
     /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, "] } ,");
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - CPU Queue data Complete \n");
 
@@ -114,32 +109,34 @@ static BVIEW_STATUS _jsonencode_report_egress_cpuq ( char *buffer, int asicId,
  *         "get-bst-report" REST API - egress RQE Queue.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_egress_rqeq ( char *buffer, int asicId,
-                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+static BVIEW_STATUS _jsonencode_report_egress_rqeq ( BSTJSON_OUTPUT_t *out, int asicId,
+                                                    const BSTJSON_CHANGES_t *changes,
                                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
                                                     const BSTJSON_REPORT_OPTIONS_t *options,
-                                                    const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                    int bufLen,
-                                                    int *length)
+                                                    const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
     int queue = 0;
     uint64_t val = 0;
-    uint64_t maxBufVal = 0;
     int sendIncrReport = options->sendIncrementalReport;
 
-    char *realmTemplate = " { \"realm\": \"egress-rqe-queue\", \"%s\": [ ";
-    char *cpuqTemplate = " [  %d , %" PRIu64 ", %" PRIu64 " ] ,";
-
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - RQE Queue data \n");
 
     /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, realmTemplate, "data");
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out,
+                                           " { \"realm\": \"egress-rqe-queue\", \"data\": [ ");
 
     /* For each queue, check if there is a difference, and create the report. */
     for (queue = 1; queue <= asic->numRqeQueues; queue++)
     {
+        /* in an incremental report, go straight to the next one that changed */
+        if (NULL != changes)
+        {
+            queue = bstjson_changes_next(changes, BVIEW_BST_SNAPSHOT_RQEQ, queue - 1) + 1;
+            if ((queue <= 0) || (queue > asic->numRqeQueues))
+                break;
+        }
+
       /* check if the trigger report request should contain snap shot */
         if ((queue-1 != options->triggerInfo.queue) && 
             (false == options->sendSnapShotOnTrigger) && 
@@ -151,37 +148,30 @@ static BVIEW_STATUS _jsonencode_report_egress_rqeq ( char *buffer, int asicId,
        {
         /* lets see if this queue needs to be included in the report at all */
         /* if this queue needs not be reported, then we move to next queue */
-        if ((NULL == previous) &&
-            (current->rqeQ.data[queue - 1].rqeBufferCount == 0) &&
-            (current->rqeQ.data[queue - 1].rqeQueueEntries == 0))
+        if ((NULL == changes) &&
+            (BVIEW_BST_SNAPSHOT_RQEQ_DATA(current, queue - 1)->rqeBufferCount == 0) &&
+            (BVIEW_BST_SNAPSHOT_RQEQ_DATA(current, queue - 1)->rqeQueueEntries == 0))
             continue;
       }
 
-        if ((previous != NULL) &&
-            (previous->rqeQ.data[queue - 1].rqeBufferCount == current->rqeQ.data[queue - 1].rqeBufferCount) &&
-            (previous->rqeQ.data[queue - 1].rqeQueueEntries == current->rqeQ.data[queue - 1].rqeQueueEntries))
-            continue;
-
-             val = current->rqeQ.data[queue - 1].rqeBufferCount;
-             maxBufVal = options->bst_max_buffers_ptr->rqeQ.data[queue - 1].rqeMaxBuf;
-             bst_json_convert_data(options, asic, &val, maxBufVal);
+             val = BVIEW_BST_SNAPSHOT_RQEQ_DATA(values, queue - 1)->rqeBufferCount;
         /* Now that this queue needs to be included in the report, add the data to report */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      cpuqTemplate, queue-1,
-                                                      val,
-                                                      current->rqeQ.data[queue - 1].rqeQueueEntries
-                                                      );
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " [  ");
+        _JSONENCODE_OUTPUT_INDEX_AND_ADVANCE(out, options, queue - 1);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " , ");
+        _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out, val);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, ", ");
+        _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out,
+                                           BVIEW_BST_SNAPSHOT_RQEQ_DATA(current, queue - 1)->rqeQueueEntries);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " ] ,");
 
     }
 
     /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+    _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
 
     /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, "] } ,");
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - RQE Queue data Complete \n");
 
@@ -193,34 +183,35 @@ static BVIEW_STATUS _jsonencode_report_egress_rqeq ( char *buffer, int asicId,
  *         "get-bst-report" REST API - egress Multicast Queue.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_egress_mcq ( char *buffer, int asicId,
-                                                   const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+static BVIEW_STATUS _jsonencode_report_egress_mcq ( BSTJSON_OUTPUT_t *out, int asicId,
+                                                   const BSTJSON_CHANGES_t *changes,
                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                   const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
                                                    const BSTJSON_REPORT_OPTIONS_t *options,
-                                                   const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                   int bufLen,
-                                                   int *length)
+                                                   const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
     int queue = 0;
     uint64_t val = 0;
-    uint64_t maxBufVal = 0;
     int sendIncrReport = options->sendIncrementalReport;
 
-    char *realmTemplate = " { \"realm\": \"egress-mc-queue\", \"%s\": [ ";
-    char *dataTemplate = " [  %d , \"%s\" ,  %" PRIu64 ", %" PRIu64 " ] ,";
-    char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
-
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - MC Queue data \n");
 
     /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, realmTemplate, "data");
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out,
+                                           " { \"realm\": \"egress-mc-queue\", \"data\": [ ");
 
     /* For each service pool, check if there is a difference, and create the report. */
     for (queue = 1; queue <= asic->numMulticastQueues; queue++)
     {
+        /* in an incremental report, go straight to the next one that changed */
+        if (NULL != changes)
+        {
+            queue = bstjson_changes_next(changes, BVIEW_BST_SNAPSHOT_EMCQ, queue - 1) + 1;
+            if ((queue <= 0) || (queue > asic->numMulticastQueues))
+                break;
+        }
+
       /* check if the trigger report request should contain snap shot */
         if ((queue-1 != options->triggerInfo.queue) && 
             (false == options->sendSnapShotOnTrigger) && 
@@ -233,41 +224,33 @@ static BVIEW_STATUS _jsonencode_report_egress_mcq ( char *buffer, int asicId,
       {
         /* lets see if this queue needs to be included in the report at all */
         /* if this queue needs not be reported, then we move to next queue */
-        if ((NULL == previous) &&
-            (current->eMcQ.data[queue - 1].mcBufferCount == 0) &&
-            (current->eMcQ.data[queue - 1].mcQueueEntries == 0) )
+        if ((NULL == changes) &&
+            (BVIEW_BST_SNAPSHOT_EMCQ_DATA(current, queue - 1)->mcBufferCount == 0) &&
+            (BVIEW_BST_SNAPSHOT_EMCQ_DATA(current, queue - 1)->mcQueueEntries == 0) )
             continue;
       }
-        if ((previous != NULL) &&
-            (previous->eMcQ.data[queue - 1].mcBufferCount == current->eMcQ.data[queue - 1].mcBufferCount ) &&
-            (previous->eMcQ.data[queue - 1].mcQueueEntries == current->eMcQ.data[queue - 1].mcQueueEntries))
-            continue;
-
-        /* convert the port to an external representation */
-        memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
-        JSON_PORT_MAP_TO_NOTATION(current->eMcQ.data[queue - 1].port, asicId, &portStr[0]);
 
-        val = current->eMcQ.data[queue - 1].mcBufferCount;
-        maxBufVal = options->bst_max_buffers_ptr->eMcQ.data[queue - 1].mcMaxBuf;
-        bst_json_convert_data(options, asic, &val, maxBufVal);
+        val = BVIEW_BST_SNAPSHOT_EMCQ_DATA(values, queue - 1)->mcBufferCount;
         /* Now that this pool needs to be included in the report, add the data to report */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      dataTemplate, queue-1,
-                                                      &portStr[0],
-                                                      val,
-                                                      current->eMcQ.data[queue - 1].mcQueueEntries
-                                                      );
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " [  ");
+        _JSONENCODE_OUTPUT_INDEX_AND_ADVANCE(out, options, queue - 1);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " , ");
+        _JSONENCODE_OUTPUT_PORT_AND_ADVANCE(out, options, asicId,
+                                            BVIEW_BST_SNAPSHOT_EMCQ_DATA(current, queue - 1)->port);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " ,  ");
+        _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out, val);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, ", ");
+        _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out,
+                                           BVIEW_BST_SNAPSHOT_EMCQ_DATA(current, queue - 1)->mcQueueEntries);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " ] ,");
 
     }
 
     /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+    _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
 
     /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, "] } ,");
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - MC Queue data Complete \n");
 
@@ -279,34 +262,35 @@ static BVIEW_STATUS _jsonencode_report_egress_mcq ( char *buffer, int asicId,
  *         "get-bst-report" REST API - egress UC Queue.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_egress_ucq ( char *buffer, int asicId,
-                                                   const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+static BVIEW_STATUS _jsonencode_report_egress_ucq ( BSTJSON_OUTPUT_t *out, int asicId,
+                                                   const BSTJSON_CHANGES_t *changes,
                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                   const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
                                                    const BSTJSON_REPORT_OPTIONS_t *options,
-                                                   const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                   int bufLen,
-                                                   int *length)
+                                                   const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
     int queue = 0;
     uint64_t val = 0;
-    uint64_t maxBufVal = 0;
     int sendIncrReport = options->sendIncrementalReport;
 
-    char *realmTemplate = " { \"realm\": \"egress-uc-queue\", \"%s\": [ ";
-    char *dataTemplate = " [  %d , \"%s\" , %" PRIu64 " ] ,";
-    char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
-
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - UC Queue data \n");
 
     /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, realmTemplate, "data");
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out,
+                                           " { \"realm\": \"egress-uc-queue\", \"data\": [ ");
 
     /* For each unicast queues, check if there is a difference, and create the report. */
     for (queue = 1; queue <= asic->numUnicastQueues; queue++)
     {
+        /* in an incremental report, go straight to the next one that changed */
+        if (NULL != changes)
+        {
+            queue = bstjson_changes_next(changes, BVIEW_BST_SNAPSHOT_EUCQ, queue - 1) + 1;
+            if ((queue <= 0) || (queue > asic->numUnicastQueues))
+                break;
+        }
+
       /* check if the trigger report request should contain snap shot */
         if ((queue-1 != options->triggerInfo.queue) && 
             (false == options->sendSnapShotOnTrigger) && 
@@ -320,37 +304,28 @@ static BVIEW_STATUS _jsonencode_report_egress_ucq ( char *buffer, int asicId,
       {
         /* lets see if this queue needs to be included in the report at all */
         /* if this queue needs not be reported, then we move to next queue */
-        if ((NULL == previous) &&
-            (current->eUcQ.data[queue - 1].ucBufferCount == 0))
+        if ((NULL == changes) &&
+            (BVIEW_BST_SNAPSHOT_EUCQ_DATA(current, queue - 1)->ucBufferCount == 0))
             continue;
       }
-        if ((previous != NULL) &&
-            (previous->eUcQ.data[queue - 1].ucBufferCount == current->eUcQ.data[queue - 1].ucBufferCount))
-            continue;
 
-        /* convert the port to an external representation */
-        memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
-        JSON_PORT_MAP_TO_NOTATION(current->eUcQ.data[queue - 1].port, asicId, &portStr[0]);
-
-         val = current->eUcQ.data[queue - 1].ucBufferCount;
-         maxBufVal = options->bst_max_buffers_ptr->eUcQ.data[queue - 1].ucMaxBuf;
-         bst_json_convert_data(options, asic, &val, maxBufVal);
+         val = BVIEW_BST_SNAPSHOT_EUCQ_DATA(values, queue - 1)->ucBufferCount;
         /* Now that this ucq needs to be included in the report, add the data to report */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      dataTemplate, queue-1,
-                                                      &portStr[0],
-                                                      val 
-                                                      );
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " [  ");
+        _JSONENCODE_OUTPUT_INDEX_AND_ADVANCE(out, options, queue - 1);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " , ");
+        _JSONENCODE_OUTPUT_PORT_AND_ADVANCE(out, options, asicId,
+                                            BVIEW_BST_SNAPSHOT_EUCQ_DATA(current, queue - 1)->port);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " , ");
+        _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out, val);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " ] ,");
     }
 
     /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+    _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
 
     /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, "] } ,");
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - UC Queue data Complete \n");
 
@@ -362,32 +337,34 @@ static BVIEW_STATUS _jsonencode_report_egress_ucq ( char *buffer, int asicId,
  *         "get-bst-report" REST API - egress UC Queue Group.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_egress_ucqg ( char *buffer, int asicId,
-                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+static BVIEW_STATUS _jsonencode_report_egress_ucqg ( BSTJSON_OUTPUT_t *out, int asicId,
+                                                    const BSTJSON_CHANGES_t *changes,
                                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
                                                     const BSTJSON_REPORT_OPTIONS_t *options,
-                                                    const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                    int bufLen,
-                                                    int *length)
+                                                    const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
     int qg = 0;
     uint64_t val = 0;
-    uint64_t maxBufVal = 0;
     int sendIncrReport = options->sendIncrementalReport;
 
-    char *realmTemplate = " { \"realm\": \"egress-uc-queue-group\", \"%s\": [ ";
-    char *dataTemplate = " [  %d , %" PRIu64 " ] ,";
-
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - UC Queue Group data \n");
 
     /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, realmTemplate, "data");
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out,
+                                           " { \"realm\": \"egress-uc-queue-group\", \"data\": [ ");
 
     /* For each unicast queue groups, check if there is a difference, and create the report. */
     for (qg = 1; qg <= asic->numUnicastQueueGroups; qg++)
     {
+        /* in an incremental report, go straight to the next one that changed */
+        if (NULL != changes)
+        {
+            qg = bstjson_changes_next(changes, BVIEW_BST_SNAPSHOT_EUCQG, qg - 1) + 1;
+            if ((qg <= 0) || (qg > asic->numUnicastQueueGroups))
+                break;
+        }
+
       /* check if the trigger report request should contain snap shot */
         if ((qg-1 != options->triggerInfo.queue) && 
             (false == options->sendSnapShotOnTrigger) && 
@@ -401,32 +378,25 @@ static BVIEW_STATUS _jsonencode_report_egress_ucqg ( char *buffer, int asicId,
       {
         /* lets see if this queue needs to be included in the report at all */
         /* if this queue needs not be reported, then we move to next queue */
-        if ((NULL == previous) &&
-            (current->eUcQg.data[qg - 1].ucBufferCount == 0))
+        if ((NULL == changes) &&
+            (BVIEW_BST_SNAPSHOT_EUCQG_DATA(current, qg - 1)->ucBufferCount == 0))
             continue;
      }
-        if ((previous != NULL) &&
-            (previous->eUcQg.data[qg - 1].ucBufferCount == current->eUcQg.data[qg - 1].ucBufferCount))
-            continue;
 
-              val = current->eUcQg.data[qg - 1].ucBufferCount;
-              maxBufVal = options->bst_max_buffers_ptr->eUcQg.data[qg - 1].ucMaxBuf;
-              bst_json_convert_data(options, asic, &val, maxBufVal);
+              val = BVIEW_BST_SNAPSHOT_EUCQG_DATA(values, qg - 1)->ucBufferCount;
         /* Now that this ucqg needs to be included in the report, add the data to report */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      dataTemplate, qg-1,
-                                                      val 
-                                                      );
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " [  ");
+        _JSONENCODE_OUTPUT_INDEX_AND_ADVANCE(out, options, qg - 1);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " , ");
+        _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out, val);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " ] ,");
     }
 
     /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+    _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
 
     /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, "] } ,");
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - UC Queue Group data Complete \n");
 
@@ -438,32 +408,34 @@ static BVIEW_STATUS _jsonencode_report_egress_ucqg ( char *buffer, int asicId,
  *         "get-bst-report" REST API - egress Service Pools .
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_egress_sp ( char *buffer, int asicId,
-                                                  const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+static BVIEW_STATUS _jsonencode_report_egress_sp ( BSTJSON_OUTPUT_t *out, int asicId,
+                                                  const BSTJSON_CHANGES_t *changes,
                                                   const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                  const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
                                                   const BSTJSON_REPORT_OPTIONS_t *options,
-                                                  const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                  int bufLen,
-                                                  int *length)
+                                                  const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
     int pool = 0;
     uint64_t val1 = 0, val2 = 0;
-    uint64_t maxBufVal = 0;
     int sendIncrReport = options->sendIncrementalReport;
 
-    char *realmTemplate = " { \"realm\": \"egress-service-pool\", \"%s\": [ ";
-    char *dataTemplate = " [  %d , %" PRIu64 " , %" PRIu64 ", %" PRIu64 " ] ,";
-
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - Service Pool data \n");
 
     /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, realmTemplate, "data");
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out,
+                                           " { \"realm\": \"egress-service-pool\", \"data\": [ ");
 
     /* For each service pool, check if there is a difference, and create the report. */
     for (pool = 1; pool <= asic->numServicePools; pool++)
     {
+        /* in an incremental report, go straight to the next one that changed */
+        if (NULL != changes)
+        {
+            pool = bstjson_changes_next(changes, BVIEW_BST_SNAPSHOT_ESP, pool - 1) + 1;
+            if ((pool <= 0) || (pool > asic->numServicePools))
+                break;
+        }
+
       if ((pool-1 != options->triggerInfo.queue) && 
 	  (false == options->sendSnapShotOnTrigger) && 
 	  (true == options->reportTrigger))
@@ -476,42 +448,35 @@ static BVIEW_STATUS _jsonencode_report_egress_sp ( char *buffer, int asicId,
       {
         /* lets see if this sp needs to be included in the report at all */
         /* if this sp needs not be reported, then we move to next sp */
-        if ((NULL == previous) &&
-            (current->eSp.data[pool - 1].umShareBufferCount == 0) &&
-            (current->eSp.data[pool - 1].mcShareBufferCount == 0)  &&
-            (current->eSp.data[pool - 1].mcShareQueueEntries == 0) )
+        if ((NULL == changes) &&
+            (BVIEW_BST_SNAPSHOT_ESP_DATA(current, pool - 1)->umShareBufferCount == 0) &&
+            (BVIEW_BST_SNAPSHOT_ESP_DATA(current, pool - 1)->mcShareBufferCount == 0)  &&
+            (BVIEW_BST_SNAPSHOT_ESP_DATA(current, pool - 1)->mcShareQueueEntries == 0) )
             continue;
       }
 
-        if ((previous != NULL) &&
-            (previous->eSp.data[pool - 1].umShareBufferCount == current->eSp.data[pool - 1].umShareBufferCount ) &&
-            (previous->eSp.data[pool - 1].mcShareBufferCount == current->eSp.data[pool - 1].mcShareBufferCount ) &&
-            (previous->eSp.data[pool - 1].mcShareQueueEntries == current->eSp.data[pool - 1].mcShareQueueEntries ))
-            continue;
-
-             val1 = current->eSp.data[pool - 1].umShareBufferCount;
-             maxBufVal = options->bst_max_buffers_ptr->eSp.data[pool - 1].umShareMaxBuf;
-             bst_json_convert_data(options, asic, &val1, maxBufVal);
+             val1 = BVIEW_BST_SNAPSHOT_ESP_DATA(values, pool - 1)->umShareBufferCount;
 
-             val2 = current->eSp.data[pool - 1].mcShareBufferCount;
-             maxBufVal = options->bst_max_buffers_ptr->eSp.data[pool - 1].mcShareMaxBuf;
-             bst_json_convert_data(options, asic, &val2, maxBufVal);
+             val2 = BVIEW_BST_SNAPSHOT_ESP_DATA(values, pool - 1)->mcShareBufferCount;
 
         /* Now that this pool needs to be included in the report, add the data to report */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      dataTemplate, pool-1, val1,val2,
-                                                      current->eSp.data[pool - 1].mcShareQueueEntries
-                                                      );
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " [  ");
+        _JSONENCODE_OUTPUT_INDEX_AND_ADVANCE(out, options, pool - 1);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " , ");
+        _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out, val1);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " , ");
+        _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out, val2);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, ", ");
+        _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out,
+                                           BVIEW_BST_SNAPSHOT_ESP_DATA(current, pool - 1)->mcShareQueueEntries);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " ] ,");
     }
 
     /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+    _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
 
     /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, "] } ,");
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - Service Pool data Complete \n");
 
@@ -523,34 +488,27 @@ static BVIEW_STATUS _jsonencode_report_egress_sp ( char *buffer, int asicId,
  *         "get-bst-report" REST API - egress-port-service-pool.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_egress_epsp ( char *buffer, int asicId,
-                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+static BVIEW_STATUS _jsonencode_report_egress_epsp ( BSTJSON_OUTPUT_t *out, int asicId,
+                                                    const BSTJSON_CHANGES_t *changes,
                                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
                                                     const BSTJSON_REPORT_OPTIONS_t *options,
-                                                    const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                    int bufLen,
-                                                    int *length)
+                                                    const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
     bool includePort = false;
     uint64_t val1 = 0, val2 = 0, val3 = 0;
-    uint64_t maxBufVal = 0;
     int sendIncrReport = options->sendIncrementalReport;
 
     int includeServicePool[BVIEW_ASIC_MAX_SERVICE_POOLS] = { 0 };
     int port = 0, pool = 0;
-
-    char *epspTemplate = " { \"realm\": \"egress-port-service-pool\", \"%s\": [ ";
-    char *epspPortTemplate = " { \"port\": \"%s\", \"data\": [ ";
-    char *epspServicePoolTemplate = " [  %d , %" PRIu64 " , %" PRIu64 " , %" PRIu64 " ] ,";
-    char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
+    int next = 0;
 
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - EPSP data \n");
 
     /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, epspTemplate, "data");
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out,
+                                           " { \"realm\": \"egress-port-service-pool\", \"data\": [ ");
 
     /* For each port, and for each service pool in that port, 
      *  1. attempt to see if this port needs to be reported.
@@ -558,6 +516,18 @@ static BVIEW_STATUS _jsonencode_report_egress_epsp ( char *buffer, int asicId,
      */
     for (port = 1; port <= asic->numPorts; port++)
     {
+        /* in an incremental report, go straight to the next port that changed */
+        if (NULL != changes)
+        {
+            next = bstjson_changes_next(changes, BVIEW_BST_SNAPSHOT_EPSP,
+                                        (port - 1) * current->layout->numServicePools);
+            if (next < 0)
+                break;
+            port = next / current->layout->numServicePools + 1;
+            if (port > asic->numPorts)
+                break;
+        }
+
       /* check if the trigger report request should contain snap shot */
         if ((port != options->triggerInfo.port) &&
             (false == options->sendSnapShotOnTrigger) && 
@@ -584,32 +554,26 @@ static BVIEW_STATUS _jsonencode_report_egress_epsp ( char *buffer, int asicId,
       if (true == sendIncrReport)
       {
             /* If there is no traffic reported for this priority group, ignore it */
-               if ((NULL == previous) &&
-                (current->ePortSp.data[port - 1][pool - 1].umShareBufferCount == 0) &&
-                (current->ePortSp.data[port - 1][pool - 1].ucShareBufferCount == 0) &&
-                (current->ePortSp.data[port - 1][pool - 1].mcShareBufferCount == 0) &&
-                (current->ePortSp.data[port - 1][pool - 1].mcShareQueueEntries == 0))
+               if ((NULL == changes) &&
+                (BVIEW_BST_SNAPSHOT_EPSP_DATA(current, port - 1, pool - 1)->umShareBufferCount == 0) &&
+                (BVIEW_BST_SNAPSHOT_EPSP_DATA(current, port - 1, pool - 1)->ucShareBufferCount == 0) &&
+                (BVIEW_BST_SNAPSHOT_EPSP_DATA(current, port - 1, pool - 1)->mcShareBufferCount == 0) &&
+                (BVIEW_BST_SNAPSHOT_EPSP_DATA(current, port - 1, pool - 1)->mcShareQueueEntries == 0))
             {
                 includeServicePool[pool - 1] = 0;
                 continue;
             }
       }
             /* If this is snapshot report, include the port in the data  */
-            if (previous == NULL)
+            if (NULL == changes)
             {
                 includePort = true;
                 continue;
             }
 
             /* if there is traffic reported since the last snapshot, we can't ignore this pool */
-            if ( (previous->ePortSp.data[port - 1][pool - 1].umShareBufferCount
-                  != current->ePortSp.data[port - 1][pool - 1].umShareBufferCount) ||
-                (previous->ePortSp.data[port - 1][pool - 1].ucShareBufferCount
-                 != current->ePortSp.data[port - 1][pool - 1].ucShareBufferCount) ||
-                (previous->ePortSp.data[port - 1][pool - 1].mcShareBufferCount
-                 != current->ePortSp.data[port - 1][pool - 1].mcShareBufferCount) ||
-                (previous->ePortSp.data[port - 1][pool - 1].mcShareQueueEntries
-                 != current->ePortSp.data[port - 1][pool - 1].mcShareQueueEntries) )
+            if (BSTJSON_CHANGES_TEST(changes, BVIEW_BST_SNAPSHOT_EPSP,
+                                     (port - 1) * current->layout->numServicePools + (pool - 1)))
             {
                 includePort = true;
                 continue;
@@ -625,12 +589,10 @@ static BVIEW_STATUS _jsonencode_report_egress_epsp ( char *buffer, int asicId,
             continue;
         }
 
-        /* convert the port to an external representation */
-        memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
-        JSON_PORT_MAP_TO_NOTATION(port, asicId, &portStr[0]);
-
         /* Now that this port needs to be included in the report, copy the header */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, epspPortTemplate, &portStr[0]);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " { \"port\": ");
+        _JSONENCODE_OUTPUT_PORT_AND_ADVANCE(out, options, asicId, port);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, ", \"data\": [ ");
 
         /* for each priority-group, prepare the data */
         for (pool = 1; pool <= asic->numServicePools; pool++)
@@ -639,44 +601,36 @@ static BVIEW_STATUS _jsonencode_report_egress_epsp ( char *buffer, int asicId,
             if (includeServicePool[pool - 1] == 0)
                 continue;
 
-            val1 = current->ePortSp.data[port - 1][pool - 1].ucShareBufferCount;
-            maxBufVal = options->bst_max_buffers_ptr->ePortSp.data[port - 1][pool - 1].ucShareMaxBuf;
-            bst_json_convert_data(options, asic, &val1, maxBufVal);
+            val1 = BVIEW_BST_SNAPSHOT_EPSP_DATA(values, port - 1, pool - 1)->ucShareBufferCount;
 
-            val2 = current->ePortSp.data[port - 1][pool - 1].umShareBufferCount;
-            maxBufVal = options->bst_max_buffers_ptr->ePortSp.data[port - 1][pool - 1].umShareMaxBuf;
-            bst_json_convert_data(options, asic, &val2, maxBufVal);
+            val2 = BVIEW_BST_SNAPSHOT_EPSP_DATA(values, port - 1, pool - 1)->umShareBufferCount;
 
-            val3 = current->ePortSp.data[port - 1][pool - 1].mcShareBufferCount;
-            maxBufVal = options->bst_max_buffers_ptr->ePortSp.data[port - 1][pool - 1].mcShareMaxBuf;
-            bst_json_convert_data(options, asic, &val3, maxBufVal);
+            val3 = BVIEW_BST_SNAPSHOT_EPSP_DATA(values, port - 1, pool - 1)->mcShareBufferCount;
 
             /* add the data to the report */
-            _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                          epspServicePoolTemplate, pool-1,
-                                                          val1, val2, val3,
-                                                          current->ePortSp.data[port - 1][pool - 1].mcShareQueueEntries
-                                                          );
+            _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " [  ");
+            _JSONENCODE_OUTPUT_INDEX_AND_ADVANCE(out, options, pool - 1);
+            _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " , ");
+            _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out, val1);
+            _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " , ");
+            _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out, val2);
+            _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " , ");
+            _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out, val3);
+            _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " ] ,");
         }
 
         /* adjust the buffer to remove the last ',' */
-        buffer = buffer - 1;
-        remLength += 1;
-        *length -= 1;
+        _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
 
         /* add the "] } ," for the next port */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      "] } ," );
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, "] } ,");
     }
 
     /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+    _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
 
     /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, "] } ,");
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - EPSP data Complete \n");
 
@@ -689,135 +643,127 @@ static BVIEW_STATUS _jsonencode_report_egress_epsp ( char *buffer, int asicId,
  *         "get-bst-report" REST API - egress part.
  *
  *********************************************************************/
-BVIEW_STATUS _jsonencode_report_egress ( char *buffer, int asicId,
-                                        const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+BVIEW_STATUS _jsonencode_report_egress ( BSTJSON_OUTPUT_t *out, int asicId,
+                                        const BSTJSON_CHANGES_t *changes,
                                         const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                        const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
                                         const BSTJSON_REPORT_OPTIONS_t *options,
-                                        const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                        int bufLen,
-                                        int *length)
+                                        const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
     BVIEW_STATUS status;
     int tempLength = 0;
 
-    *length = 0;
-
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS data \n");
 
     /* If CPU realm is asked for, lets encode the corresponding data */
 
     if (options->includeEgressCpuQueue)
     {
-        tempLength = 0;
-        status = _jsonencode_report_egress_cpuq(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
+        tempLength = BSTJSON_OUTPUT_LENGTH(out);
+        status = _jsonencode_report_egress_cpuq(out, asicId, changes, current, values, options, asic);
         _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+        tempLength = BSTJSON_OUTPUT_LENGTH(out) - tempLength;
     }
 
     /* If Egress Multicast queue realm is asked for, lets encode the corresponding data */
     if (options->includeEgressMcQueue)
     {
-        tempLength = 0;
-        status = _jsonencode_report_egress_mcq(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
+        tempLength = BSTJSON_OUTPUT_LENGTH(out);
+        status = _jsonencode_report_egress_mcq(out, asicId, changes, current, values, options, asic);
         _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+        tempLength = BSTJSON_OUTPUT_LENGTH(out) - tempLength;
     }
 
     /* If Egress Port - Service Pool realm is asked for, lets encode the corresponding data */
 
     if (options->includeEgressPortServicePool)
     {
-        tempLength = 0;
-        status = _jsonencode_report_egress_epsp(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
+        tempLength = BSTJSON_OUTPUT_LENGTH(out);
+        status = _jsonencode_report_egress_epsp(out, asicId, changes, current, values, options, asic);
         _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+        tempLength = BSTJSON_OUTPUT_LENGTH(out) - tempLength;
     }
 
     /* If Egress RQE queue realm is asked for, lets encode the corresponding data */
     if (options->includeEgressRqeQueue)
     {
-        tempLength = 0;
-        status = _jsonencode_report_egress_rqeq(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
+        tempLength = BSTJSON_OUTPUT_LENGTH(out);
+        status = _jsonencode_report_egress_rqeq(out, asicId, changes, current, values, options, asic);
         _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+        tempLength = BSTJSON_OUTPUT_LENGTH(out) - tempLength;
     }
 
     /* If Egress Service Pool realm is asked for, lets encode the corresponding data */
     if (options->includeEgressServicePool)
     {
-        tempLength = 0;
-        status = _jsonencode_report_egress_sp(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
+        tempLength = BSTJSON_OUTPUT_LENGTH(out);
+        status = _jsonencode_report_egress_sp(out, asicId, changes, current, values, options, asic);
         _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+        tempLength = BSTJSON_OUTPUT_LENGTH(out) - tempLength;
     }
 
     /* If Egress Unicast queue realm is asked for, lets encode the corresponding data */
     if (options->includeEgressUcQueue)
     {
-        tempLength = 0;
-        status = _jsonencode_report_egress_ucq(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
+        tempLength = BSTJSON_OUTPUT_LENGTH(out);
+        status = _jsonencode_report_egress_ucq(out, asicId, changes, current, values, options, asic);
         _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+        tempLength = BSTJSON_OUTPUT_LENGTH(out) - tempLength;
     }
 
     /* If Egress Unicast queue group realm is asked for, lets encode the corresponding data */
     if (options->includeEgressUcQueueGroup)
     {
-        tempLength = 0;
-        status = _jsonencode_report_egress_ucqg(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
+        tempLength = BSTJSON_OUTPUT_LENGTH(out);
+        status = _jsonencode_report_egress_ucqg(out, asicId, changes, current, values, options, asic);
         _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+        tempLength = BSTJSON_OUTPUT_LENGTH(out) - tempLength;
 
     }
 
     if (tempLength != 0)
     {
-        *(length) -= 1;
+        _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
     }
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS data complete \n");
 
     return BVIEW_STATUS_SUCCESS;
 }
+
+/******************************************************************
+ * @brief  Creates a JSON buffer using the supplied data for the 
+ *         "get-bst-report" REST API - a single egress realm.
+ *
+ * @note   The realm ends with a separator, as in the egress part.
+ *
+ *********************************************************************/
+BVIEW_STATUS _jsonencode_report_egress_realm ( BSTJSON_OUTPUT_t *out,
+                                              int asicId,
+                                              BVIEW_BST_SNAPSHOT_REALM_t realm,
+                                              const BSTJSON_CHANGES_t *changes,
+                                              const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                              const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
+                                              const BSTJSON_REPORT_OPTIONS_t *options,
+                                              const BVIEW_ASIC_CAPABILITIES_t *asic)
+{
+    switch (realm)
+    {
+        case BVIEW_BST_SNAPSHOT_CPUQ:
+            return _jsonencode_report_egress_cpuq(out, asicId, changes, current, values, options, asic);
+        case BVIEW_BST_SNAPSHOT_EMCQ:
+            return _jsonencode_report_egress_mcq(out, asicId, changes, current, values, options, asic);
+        case BVIEW_BST_SNAPSHOT_EPSP:
+            return _jsonencode_report_egress_epsp(out, asicId, changes, current, values, options, asic);
+        case BVIEW_BST_SNAPSHOT_RQEQ:
+            return _jsonencode_report_egress_rqeq(out, asicId, changes, current, values, options, asic);
+        case BVIEW_BST_SNAPSHOT_ESP:
+            return _jsonencode_report_egress_sp(out, asicId, changes, current, values, options, asic);
+        case BVIEW_BST_SNAPSHOT_EUCQ:
+            return _jsonencode_report_egress_ucq(out, asicId, changes, current, values, options, asic);
+        case BVIEW_BST_SNAPSHOT_EUCQG:
+            return _jsonencode_report_egress_ucqg(out, asicId, changes, current, values, options, asic);
+        default:
+            return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+}
@@ -0,0 +1,420 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <string.h>
+#include <time.h>
+#include <inttypes.h>
+
+#include "broadview.h"
+#include "cJSON.h"
+
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+
+#include "bst.h"
+
+#include "bst_json_memory.h"
+#include "bst_json_encoder.h"
+
+/* most counters an entry of a realm has */
+#define _BSTJSON_HISTOGRAM_MAX_COUNTERS   4
+
+/* description of a realm, to walk its histograms */
+typedef struct _bstjson_histogram_realm_
+{
+    BVIEW_BST_SNAPSHOT_REALM_t realm;
+    /* name of the realm in the json */
+    char *name;
+    /* name of the index of an entry, NULL if the realm has one entry */
+    char *indexName;
+    /* true if the entries are stored per port, port major */
+    bool perPort;
+    /* name of every 64 bit word of an entry, NULL for the words
+       which are not counters (e.g. the port of a queue) */
+    char *counters[_BSTJSON_HISTOGRAM_MAX_COUNTERS];
+} BSTJSON_HISTOGRAM_REALM_t;
+
+static const BSTJSON_HISTOGRAM_REALM_t histogramRealms[] = {
+    {BVIEW_BST_SNAPSHOT_DEVICE, "device", NULL, false,
+        {"buffer-count"}},
+    {BVIEW_BST_SNAPSHOT_IPPG, "ingress-port-priority-group", "priority-group", true,
+        {"um-share-buffer-count", "um-headroom-buffer-count"}},
+    {BVIEW_BST_SNAPSHOT_IPSP, "ingress-port-service-pool", "service-pool", true,
+        {"um-share-buffer-count"}},
+    {BVIEW_BST_SNAPSHOT_ISP, "ingress-service-pool", "service-pool", false,
+        {"um-share-buffer-count"}},
+    {BVIEW_BST_SNAPSHOT_EPSP, "egress-port-service-pool", "service-pool", true,
+        {"uc-share-buffer-count", "um-share-buffer-count",
+         "mc-share-buffer-count", "mc-share-queue-entries"}},
+    {BVIEW_BST_SNAPSHOT_ESP, "egress-service-pool", "service-pool", false,
+        {"um-share-buffer-count", "mc-share-buffer-count", "mc-share-queue-entries"}},
+    {BVIEW_BST_SNAPSHOT_EUCQ, "egress-uc-queue", "queue", false,
+        {"uc-buffer-count", NULL}},
+    {BVIEW_BST_SNAPSHOT_EUCQG, "egress-uc-queue-group", "queue-group", false,
+        {"uc-buffer-count"}},
+    {BVIEW_BST_SNAPSHOT_EMCQ, "egress-mc-queue", "queue", false,
+        {"mc-buffer-count", "mc-queue-entries", NULL}},
+    {BVIEW_BST_SNAPSHOT_CPUQ, "egress-cpu-queue", "queue", false,
+        {"cpu-buffer-count", "cpu-queue-entries"}},
+    {BVIEW_BST_SNAPSHOT_RQEQ, "egress-rqe-queue", "queue", false,
+        {"rqe-buffer-count", "rqe-queue-entries"}}
+};
+
+/******************************************************************
+ * @brief  checks whether the realm is requested in the options
+ *
+ *********************************************************************/
+static bool _jsonencode_histogram_realm_included (BVIEW_BST_SNAPSHOT_REALM_t realm,
+                                                  const BSTJSON_REPORT_OPTIONS_t *options)
+{
+    switch (realm)
+    {
+        case BVIEW_BST_SNAPSHOT_DEVICE:
+            return options->includeDevice;
+        case BVIEW_BST_SNAPSHOT_IPPG:
+            return options->includeIngressPortPriorityGroup;
+        case BVIEW_BST_SNAPSHOT_IPSP:
+            return options->includeIngressPortServicePool;
+        case BVIEW_BST_SNAPSHOT_ISP:
+            return options->includeIngressServicePool;
+        case BVIEW_BST_SNAPSHOT_EPSP:
+            return options->includeEgressPortServicePool;
+        case BVIEW_BST_SNAPSHOT_ESP:
+            return options->includeEgressServicePool;
+        case BVIEW_BST_SNAPSHOT_EUCQ:
+            return options->includeEgressUcQueue;
+        case BVIEW_BST_SNAPSHOT_EUCQG:
+            return options->includeEgressUcQueueGroup;
+        case BVIEW_BST_SNAPSHOT_EMCQ:
+            return options->includeEgressMcQueue;
+        case BVIEW_BST_SNAPSHOT_CPUQ:
+            return options->includeEgressCpuQueue;
+        case BVIEW_BST_SNAPSHOT_RQEQ:
+            return options->includeEgressRqeQueue;
+        default:
+            return false;
+    }
+}
+
+/******************************************************************
+ * @brief  returns the number of entries of a port in a per port realm
+ *
+ *********************************************************************/
+static unsigned int _jsonencode_histogram_port_entries (BVIEW_BST_SNAPSHOT_REALM_t realm,
+                                                        const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout)
+{
+    switch (realm)
+    {
+        case BVIEW_BST_SNAPSHOT_IPPG:
+            return layout->numPriorityGroups;
+        case BVIEW_BST_SNAPSHOT_IPSP:
+            return layout->numIngressServicePools;
+        case BVIEW_BST_SNAPSHOT_EPSP:
+            return layout->numServicePools;
+        default:
+            return 1;
+    }
+}
+
+/******************************************************************
+ * @brief  Encodes the non empty histograms of one realm.
+ *
+ * @param[in]   buffer      Buffer the realm is encoded to
+ * @param[in]   asicId      ASIC for which this data is being encoded.
+ * @param[in]   histogram   Histograms of the asic
+ * @param[in]   desc        Description of the realm
+ * @param[in]   options     Units to be reported in
+ * @param[in]   asic        Capabilities of the ASIC
+ * @param[in]   bufLen      Room left in the buffer
+ * @param[out]  length      Number of bytes encoded
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  Realm is encoded, *length is 0 if
+ *                                 none of its counters was updated
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  The realm does not fit the buffer
+ *
+ * @note     Only the buckets with a count are encoded, as
+ *           [ lowest value of the bucket , count ] pairs.
+ *********************************************************************/
+static BVIEW_STATUS _jsonencode_histogram_realm (char *buffer, int asicId,
+                                                 const BVIEW_BST_ASIC_HISTOGRAM_DATA_t *histogram,
+                                                 const BSTJSON_HISTOGRAM_REALM_t *desc,
+                                                 const BSTJSON_REPORT_OPTIONS_t *options,
+                                                 const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                                 int bufLen,
+                                                 int *length)
+{
+    const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout = histogram->layout;
+    const BVIEW_BST_HISTOGRAM_t *hist;
+    int remLength = bufLen;
+    int actualLength = 0;
+    bool realmStarted = false;
+    unsigned int words, portEntries;
+    unsigned int entry, word, bucket;
+    size_t base;
+    uint64_t low;
+
+    *length = 0;
+
+    words = layout->entrySize[desc->realm] / sizeof (uint64_t);
+    if (words > _BSTJSON_HISTOGRAM_MAX_COUNTERS)
+    {
+        words = _BSTJSON_HISTOGRAM_MAX_COUNTERS;
+    }
+    portEntries = _jsonencode_histogram_port_entries (desc->realm, layout);
+    base = layout->offset[desc->realm] / sizeof (uint64_t);
+
+    for (entry = 0; entry < layout->entries[desc->realm]; entry++)
+    {
+        for (word = 0; word < words; word++)
+        {
+            if (NULL == desc->counters[word])
+            {
+                continue;
+            }
+
+            hist = &histogram->data[base + (entry * layout->entrySize[desc->realm]) / sizeof (uint64_t) + word];
+
+            /* a counter which was not updated is left out */
+            for (bucket = 0; bucket < BVIEW_BST_HISTOGRAM_BUCKETS; bucket++)
+            {
+                if (0 != hist->count[bucket])
+                    break;
+            }
+            if (BVIEW_BST_HISTOGRAM_BUCKETS == bucket)
+            {
+                continue;
+            }
+
+            if (false == realmStarted)
+            {
+                _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
+                                                              " { \"realm\": \"%s\", \"data\": [ ", desc->name);
+                realmStarted = true;
+            }
+
+            _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, " { ");
+
+            if (true == desc->perPort)
+            {
+                /* the port in its external representation */
+                _JSONENCODE_APPEND_LITERAL_AND_ADVANCE(buffer, remLength, length, "\"port\": ");
+                _JSONENCODE_APPEND_PORT_AND_ADVANCE(buffer, remLength, length, options, asicId,
+                                                    (entry / portEntries) + 1);
+                _JSONENCODE_APPEND_LITERAL_AND_ADVANCE(buffer, remLength, length, ", ");
+            }
+
+            if (NULL != desc->indexName)
+            {
+                _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
+                                                              "\"%s\": %u, ", desc->indexName,
+                                                              (true == desc->perPort) ? (entry % portEntries) : entry);
+            }
+
+            _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
+                                                          "\"counter\": \"%s\", \"histogram\": [ ",
+                                                          desc->counters[word]);
+
+            for (; bucket < BVIEW_BST_HISTOGRAM_BUCKETS; bucket++)
+            {
+                if (0 == hist->count[bucket])
+                {
+                    continue;
+                }
+
+                low = BVIEW_BST_HISTOGRAM_BUCKET_LOW(bucket);
+                if ((true == options->statUnitsInCells) && (0 != asic->cellToByteConv))
+                {
+                    low = low / asic->cellToByteConv;
+                }
+
+                _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
+                                                              "[ %" PRIu64 " , %u ] ,", low, hist->count[bucket]);
+            }
+
+            /* adjust the buffer to remove the last ',' */
+            buffer = buffer - 1;
+            remLength += 1;
+            *length -= 1;
+
+            _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, "] } ,");
+        }
+    }
+
+    if (true == realmStarted)
+    {
+        /* adjust the buffer to remove the last ',' */
+        buffer = buffer - 1;
+        remLength += 1;
+        *length -= 1;
+
+        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, "] } ,");
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Creates a JSON buffer using the supplied data for the
+ *         "get-bst-histogram" REST API.
+ *
+ * @param[in]   asicId      ASIC for which this data is being encoded.
+ * @param[in]   method      Method ID (from original request) that needs
+ *                          to be encoded in JSON.
+ * @param[in]   histogram   Occupancy histograms of the counters
+ * @param[in]   options     Realms and units to be reported
+ * @param[in]   asic        Capabilities of the ASIC
+ * @param[in]   startTime   Start of the interval of the histograms
+ * @param[in]   endTime     Time the histograms are read at
+ * @param[out]  pJsonBuffer Filled-in JSON buffer
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  Data is encoded into JSON successfully
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  No available memory to create JSON buffer
+ *
+ * @note     Only the counters which were updated in the interval, and
+ *           only the buckets with a count, are reported. The bucket
+ *           bounds are in bytes, or in cells if so configured. A realm
+ *           which does not fit in the buffer is left out and the
+ *           "truncated" member is set.
+ *           The returned json-encoded-buffer should be freed using the
+ *           bstjson_memory_free(). Failing to do so leads to memory leaks
+ *********************************************************************/
+
+BVIEW_STATUS bstjson_encode_get_bst_histogram ( int asicId,
+                                               int method,
+                                               const BVIEW_BST_ASIC_HISTOGRAM_DATA_t *histogram,
+                                               const BSTJSON_REPORT_OPTIONS_t *options,
+                                               const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                               const BVIEW_TIME_t *startTime,
+                                               const BVIEW_TIME_t *endTime,
+                                               uint8_t **pJsonBuffer
+                                               )
+{
+    char *jsonBuf, *start, *reportStart;
+    BVIEW_STATUS status;
+    /* room kept for closing the report */
+    const int trailerLength = 64;
+    int bufferLength = BSTJSON_MEMSIZE_REPORT - trailerLength;
+    int tempLength = 0;
+    int encodedLength = 0;
+    bool truncated = false;
+    unsigned int i = 0;
+
+    time_t report_time;
+    struct tm *timeinfo;
+    char startString[64];
+    char endString[64];
+    char asicIdStr[JSON_MAX_NODE_LENGTH] = { 0 };
+
+    char *getBstHistogramStart = " { \
+\"jsonrpc\": \"2.0\",\
+\"method\": \"get-bst-histogram\",\
+\"asic-id\": \"%s\",\
+\"version\": \"%d\",\
+\"time-stamp\": \"%s\",\
+\"start-time\": \"%s\",\
+\"report\": [ \
+";
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for Get-Bst-Histogram \n");
+
+    /* Validate Input Parameters */
+    _JSONENCODE_ASSERT (histogram != NULL);
+    _JSONENCODE_ASSERT (histogram->layout != NULL);
+    _JSONENCODE_ASSERT (histogram->data != NULL);
+    _JSONENCODE_ASSERT (options != NULL);
+    _JSONENCODE_ASSERT (asic != NULL);
+    _JSONENCODE_ASSERT (startTime != NULL);
+    _JSONENCODE_ASSERT (endTime != NULL);
+    _JSONENCODE_ASSERT (pJsonBuffer != NULL);
+
+    /* obtain the times */
+    memset(&startString, 0, sizeof (startString));
+    report_time = *(time_t *) startTime;
+    timeinfo = localtime(&report_time);
+    strftime(startString, 64, "%Y-%m-%d - %H:%M:%S ", timeinfo);
+
+    memset(&endString, 0, sizeof (endString));
+    report_time = *(time_t *) endTime;
+    timeinfo = localtime(&report_time);
+    strftime(endString, 64, "%Y-%m-%d - %H:%M:%S ", timeinfo);
+
+    /* allocate memory for JSON */
+    status = bstjson_memory_allocate(BSTJSON_MEMSIZE_REPORT, (uint8_t **) & jsonBuf);
+    _JSONENCODE_ASSERT (status == BVIEW_STATUS_SUCCESS);
+
+    start = jsonBuf;
+    /* the caller frees the buffer, even if the encoding fails */
+    *pJsonBuffer = (uint8_t *) start;
+
+    /* clear the buffer */
+    memset(jsonBuf, 0, BSTJSON_MEMSIZE_REPORT);
+
+    /* convert asicId to external  notation */
+    _JSONENCODE_ASIC_NOTATION_GET(options, asicId, &asicIdStr[0]);
+
+    /* fill the header */
+    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(tempLength, jsonBuf, bufferLength, &encodedLength,
+                                                  getBstHistogramStart, &asicIdStr[0], BVIEW_JSON_VERSION,
+                                                  endString, startString);
+    reportStart = jsonBuf;
+
+    for (i = 0; i < sizeof (histogramRealms) / sizeof (histogramRealms[0]); i++)
+    {
+        if (false == _jsonencode_histogram_realm_included (histogramRealms[i].realm, options))
+        {
+            continue;
+        }
+
+        status = _jsonencode_histogram_realm (jsonBuf, asicId, histogram, &histogramRealms[i],
+                                              options, asic, bufferLength, &tempLength);
+        if (status == BVIEW_STATUS_OUTOFMEMORY)
+        {
+            /* leave the realm out, the rest would not fit either */
+            *jsonBuf = 0;
+            truncated = true;
+            break;
+        }
+        else if (status != BVIEW_STATUS_SUCCESS)
+        {
+            return status;
+        }
+
+        bufferLength -= tempLength;
+        jsonBuf += tempLength;
+    }
+
+    /* drop the separator after the last realm */
+    while ((jsonBuf > reportStart) &&
+           ((jsonBuf[-1] == ',') || (jsonBuf[-1] == ' ')))
+    {
+        bufferLength++;
+        jsonBuf--;
+    }
+
+    /* finalizing the report, the trailer has its room kept */
+    bufferLength += trailerLength;
+    tempLength = snprintf(jsonBuf, bufferLength, " ], \"truncated\": %s, \"id\": %d } ",
+                          (truncated == true) ? "true" : "false", method);
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for Get-Bst-Histogram Complete [%d] bytes \n", (int)strlen(start));
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_DUMPJSON, "BST-JSON-Encoder : %s \n", start);
+
+    return BVIEW_STATUS_SUCCESS;
+}
@@ -35,35 +35,28 @@
  *         "get-bst-report" REST API - ingress-port-port-group.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_ingress_ippg ( char *buffer, int asicId,
-                                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+static BVIEW_STATUS _jsonencode_report_ingress_ippg ( BSTJSON_OUTPUT_t *out, int asicId,
+                                                     const BSTJSON_CHANGES_t *changes,
                                                      const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
                                                      const BSTJSON_REPORT_OPTIONS_t *options,
-                                                     const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                     int bufLen,
-                                                     int *length)
+                                                     const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
     bool includePort = false;
     uint64_t val1 = 0;
     uint64_t val2 = 0;
-    uint64_t maxBufVal = 0;
     int sendIncrReport = options->sendIncrementalReport;
 
 
     int includePriorityGroups[BVIEW_ASIC_MAX_PRIORITY_GROUPS] = { 0 };
     int port = 0, priGroup = 0;
-    char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
-
-    char *ippgTemplate = " { \"realm\": \"ingress-port-priority-group\", \"%s\": [ ";
-    char *ippgPortTemplate = " { \"port\": \"%s\", \"data\": [ ";
-    char *ippgPortGroupTemplate = " [  %d , %" PRIu64 " , %" PRIu64 " ] ,";
+    int next = 0;
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding INGRESS - IPPG data \n");
 
     /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, ippgTemplate, "data");
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out,
+                                           " { \"realm\": \"ingress-port-priority-group\", \"data\": [ ");
 
     /* For each port, and for each priority group in that port, 
      *  1. attempt to see if this port needs to be reported.
@@ -71,6 +64,18 @@ static BVIEW_STATUS _jsonencode_report_ingress_ippg ( char *buffer, int asicId,
      */
     for (port = 1; port <= asic->numPorts; port++)
     {
+        /* in an incremental report, go straight to the next port that changed */
+        if (NULL != changes)
+        {
+            next = bstjson_changes_next(changes, BVIEW_BST_SNAPSHOT_IPPG,
+                                        (port - 1) * current->layout->numPriorityGroups);
+            if (next < 0)
+                break;
+            port = next / current->layout->numPriorityGroups + 1;
+            if (port > asic->numPorts)
+                break;
+        }
+
       /* check if the trigger report request should contain snap shot */
         if ((port != options->triggerInfo.port) &&
             (false == options->sendSnapShotOnTrigger) && 
@@ -97,9 +102,9 @@ static BVIEW_STATUS _jsonencode_report_ingress_ippg ( char *buffer, int asicId,
             if (true == sendIncrReport)
             {
             /* If there is no traffic reported for this priority group, ignore it */
-            if ((previous == NULL) && 
-                (current->iPortPg.data[port - 1][priGroup - 1].umShareBufferCount == 0) &&
-                (current->iPortPg.data[port - 1][priGroup - 1].umHeadroomBufferCount == 0) )
+            if ((NULL == changes) && 
+                (BVIEW_BST_SNAPSHOT_IPPG_DATA(current, port - 1, priGroup - 1)->umShareBufferCount == 0) &&
+                (BVIEW_BST_SNAPSHOT_IPPG_DATA(current, port - 1, priGroup - 1)->umHeadroomBufferCount == 0) )
             {
                 includePriorityGroups[priGroup - 1] = 0;
                 continue;
@@ -107,22 +112,15 @@ static BVIEW_STATUS _jsonencode_report_ingress_ippg ( char *buffer, int asicId,
            }
 
             /* If this is snapshot report, include the port in the data  */
-            if (previous == NULL)
+            if (NULL == changes)
             {
                 includePort = true;
                 continue;
             }
 
             /* if there is traffic reported since the last snapshot, we can't ignore this priority group */
-            if (previous->iPortPg.data[port - 1][priGroup - 1].umShareBufferCount
-                != current->iPortPg.data[port - 1][priGroup - 1].umShareBufferCount)
-            {
-                includePort = true;
-                continue;
-            }
-
-            if (previous->iPortPg.data[port - 1][priGroup - 1].umHeadroomBufferCount
-                != current->iPortPg.data[port - 1][priGroup - 1].umHeadroomBufferCount)
+            if (BSTJSON_CHANGES_TEST(changes, BVIEW_BST_SNAPSHOT_IPPG,
+                                     (port - 1) * current->layout->numPriorityGroups + (priGroup - 1)))
             {
                 includePort = true;
                 continue;
@@ -138,12 +136,10 @@ static BVIEW_STATUS _jsonencode_report_ingress_ippg ( char *buffer, int asicId,
             continue;
         }
 
-          /* convert the port to an external representation */
-          memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
-          JSON_PORT_MAP_TO_NOTATION(port, asicId, &portStr[0]);
-
           /* Now that this port needs to be included in the report, copy the header */
-          _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, ippgPortTemplate, &portStr[0]);
+          _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " { \"port\": ");
+          _JSONENCODE_OUTPUT_PORT_AND_ADVANCE(out, options, asicId, port);
+          _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, ", \"data\": [ ");
 
         /* for each priority-group, prepare the data */
         for (priGroup = 1; priGroup <= asic->numPriorityGroups; priGroup++)
@@ -152,38 +148,33 @@ static BVIEW_STATUS _jsonencode_report_ingress_ippg ( char *buffer, int asicId,
             if (includePriorityGroups[priGroup - 1] == 0)
                 continue;
 
-            val1 = current->iPortPg.data[port - 1][priGroup - 1].umShareBufferCount;
-            maxBufVal = options->bst_max_buffers_ptr->iPortPg.data[port - 1][priGroup - 1].umShareMaxBuf;
-            bst_json_convert_data(options, asic, &val1, maxBufVal);
+            val1 = BVIEW_BST_SNAPSHOT_IPPG_DATA(values, port - 1, priGroup - 1)->umShareBufferCount;
 
-            val2 = current->iPortPg.data[port - 1][priGroup - 1].umHeadroomBufferCount;
-            maxBufVal = options->bst_max_buffers_ptr->iPortPg.data[port - 1][priGroup - 1].umHeadroomMaxBuf;
-            bst_json_convert_data(options, asic, &val2, maxBufVal);
+            val2 = BVIEW_BST_SNAPSHOT_IPPG_DATA(values, port - 1, priGroup - 1)->umHeadroomBufferCount;
 
 
             /* add the data to the report */
-            _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                          ippgPortGroupTemplate, priGroup-1, val1, val2);
+            _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " [  ");
+            _JSONENCODE_OUTPUT_INDEX_AND_ADVANCE(out, options, priGroup - 1);
+            _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " , ");
+            _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out, val1);
+            _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " , ");
+            _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out, val2);
+            _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " ] ,");
         }
 
           /* adjust the buffer to remove the last ',' */
-          buffer = buffer - 1;
-          remLength += 1;
-          *length -= 1;
+          _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
 
         /* add the "] } ," for the next port */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      "] } ," );
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, "] } ,");
     }
 
     /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+    _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
 
     /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, "] } ,");
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding INGRESS - IPPG data Complete \n");
 
@@ -196,36 +187,26 @@ static BVIEW_STATUS _jsonencode_report_ingress_ippg ( char *buffer, int asicId,
  *         "get-bst-report" REST API - ingress-port-service-pool.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_ingress_ipsp ( char *buffer, int asicId,
-                                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+static BVIEW_STATUS _jsonencode_report_ingress_ipsp ( BSTJSON_OUTPUT_t *out, int asicId,
+                                                     const BSTJSON_CHANGES_t *changes,
                                                      const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
                                                      const BSTJSON_REPORT_OPTIONS_t *options,
-                                                     const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                     int bufLen,
-                                                     int *length)
+                                                     const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
     bool includePort = false;
     uint64_t val = 0;
-    uint64_t maxBufVal = 0;
     int sendIncrReport = options->sendIncrementalReport;
 
     int includeServicePool[BVIEW_ASIC_MAX_SERVICE_POOLS] = { 0 };
     int port = 0, pool = 0;
-    char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
-
-
-    char *ipspTemplate = " { \"realm\": \"ingress-port-service-pool\", \"%s\": [ ";
-    char *ipspPortTemplate = " { \"port\": \"%s\", \"data\": [ ";
-    //char *ippgPortGroupTemplate = " { \"pg\" : %d , \"um-share\": %" PRIu64 " , \"um-headroom\": %" PRIu64 " } ,";
-    //char *ippgPortGroupTemplate = " { \"pg\" : %d , \"data\": [ %" PRIu64 " , %" PRIu64 " ] } ,";
-    char *ipspServicePoolTemplate = " [  %d , %" PRIu64 " ] ,";
+    int next = 0;
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding INGRESS - IPSP data \n");
 
     /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, ipspTemplate, "data");
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out,
+                                           " { \"realm\": \"ingress-port-service-pool\", \"data\": [ ");
 
     /* For each port, and for each priority group in that port, 
      *  1. attempt to see if this port needs to be reported.
@@ -233,6 +214,18 @@ static BVIEW_STATUS _jsonencode_report_ingress_ipsp ( char *buffer, int asicId,
      */
     for (port = 1; port <= asic->numPorts; port++)
     {
+        /* in an incremental report, go straight to the next port that changed */
+        if (NULL != changes)
+        {
+            next = bstjson_changes_next(changes, BVIEW_BST_SNAPSHOT_IPSP,
+                                        (port - 1) * current->layout->numIngressServicePools);
+            if (next < 0)
+                break;
+            port = next / current->layout->numIngressServicePools + 1;
+            if (port > asic->numPorts)
+                break;
+        }
+
       /* check if the trigger report request should contain snap shot */
         if ((port != options->triggerInfo.port) &&
             (false == options->sendSnapShotOnTrigger) && 
@@ -259,8 +252,8 @@ static BVIEW_STATUS _jsonencode_report_ingress_ipsp ( char *buffer, int asicId,
             if (true == sendIncrReport)
             {
               /* If there is no traffic reported for this priority group, ignore it */
-              if ((previous == NULL) &&
-                  (current->iPortSp.data[port - 1][pool - 1].umShareBufferCount == 0))
+              if ((NULL == changes) &&
+                  (BVIEW_BST_SNAPSHOT_IPSP_DATA(current, port - 1, pool - 1)->umShareBufferCount == 0))
               {
                 includeServicePool[pool - 1] = 0;
                 continue;
@@ -268,15 +261,15 @@ static BVIEW_STATUS _jsonencode_report_ingress_ipsp ( char *buffer, int asicId,
             }
 
             /* If this is snapshot report, include the port in the data  */
-            if (previous == NULL)
+            if (NULL == changes)
             {
                 includePort = true;
                 continue;
             }
 
             /* if there is traffic reported since the last snapshot, we can't ignore this pool */
-            if (previous->iPortSp.data[port - 1][pool - 1].umShareBufferCount
-                != current->iPortSp.data[port - 1][pool - 1].umShareBufferCount)
+            if (BSTJSON_CHANGES_TEST(changes, BVIEW_BST_SNAPSHOT_IPSP,
+                                     (port - 1) * current->layout->numIngressServicePools + (pool - 1)))
             {
                 includePort = true;
                 continue;
@@ -292,12 +285,10 @@ static BVIEW_STATUS _jsonencode_report_ingress_ipsp ( char *buffer, int asicId,
             continue;
         }
 
-          /* convert the port to an external representation */
-          memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
-          JSON_PORT_MAP_TO_NOTATION(port, asicId, &portStr[0]);
-
           /* Now that this port needs to be included in the report, copy the header */
-          _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, ipspPortTemplate,  &portStr[0]);
+          _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " { \"port\": ");
+          _JSONENCODE_OUTPUT_PORT_AND_ADVANCE(out, options, asicId, port);
+          _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, ", \"data\": [ ");
 
         /* for each priority-group, prepare the data */
         for (pool = 1; pool <= asic->numServicePools; pool++)
@@ -306,33 +297,28 @@ static BVIEW_STATUS _jsonencode_report_ingress_ipsp ( char *buffer, int asicId,
             if (includeServicePool[pool - 1] == 0)
                 continue;
 
-            val = current->iPortSp.data[port - 1][pool - 1].umShareBufferCount;
-            maxBufVal = options->bst_max_buffers_ptr->iPortSp.data[port - 1][pool - 1].umShareMaxBuf;
-            bst_json_convert_data(options, asic, &val, maxBufVal);
+            val = BVIEW_BST_SNAPSHOT_IPSP_DATA(values, port - 1, pool - 1)->umShareBufferCount;
 
             /* add the data to the report */
-            _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                          ipspServicePoolTemplate, pool-1,val);
+            _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " [  ");
+            _JSONENCODE_OUTPUT_INDEX_AND_ADVANCE(out, options, pool - 1);
+            _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " , ");
+            _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out, val);
+            _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " ] ,");
         }
 
         /* adjust the buffer to remove the last ',' */
-        buffer = buffer - 1;
-        remLength += 1;
-        *length -= 1;
+        _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
 
         /* add the "] } ," for the next port */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      "] } ," );
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, "] } ,");
     }
 
     /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+    _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
 
     /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, "] } ,");
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding INGRESS - IPSP data Complete \n");
 
@@ -345,32 +331,34 @@ static BVIEW_STATUS _jsonencode_report_ingress_ipsp ( char *buffer, int asicId,
  *         "get-bst-report" REST API - ingress-service-pool.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_ingress_sp ( char *buffer, int asicId,
-                                                   const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+static BVIEW_STATUS _jsonencode_report_ingress_sp ( BSTJSON_OUTPUT_t *out, int asicId,
+                                                   const BSTJSON_CHANGES_t *changes,
                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                   const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
                                                    const BSTJSON_REPORT_OPTIONS_t *options,
-                                                   const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                   int bufLen,
-                                                   int *length)
+                                                   const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
     int pool = 0;
     uint64_t val = 0;
-    uint64_t maxBufVal = 0;
     int sendIncrReport = options->sendIncrementalReport;
 
-    char *ispTemplate = " { \"realm\": \"ingress-service-pool\", \"%s\": [ ";
-    char *ispServicePoolTemplate = " [  %d , %" PRIu64 " ] ,";
-
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding INGRESS - ISP data \n");
 
     /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, ispTemplate, "data");
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out,
+                                           " { \"realm\": \"ingress-service-pool\", \"data\": [ ");
 
     /* For each service pool, check if there is a difference, and create the report. */
     for (pool = 1; pool <= asic->numServicePools; pool++)
     {
+        /* in an incremental report, go straight to the next one that changed */
+        if (NULL != changes)
+        {
+            pool = bstjson_changes_next(changes, BVIEW_BST_SNAPSHOT_ISP, pool - 1) + 1;
+            if ((pool <= 0) || (pool > asic->numServicePools))
+                break;
+        }
+
       /* check if the trigger report request should contain snap shot */
         if ((pool-1 != options->triggerInfo.queue) && 
             (false == options->sendSnapShotOnTrigger) && 
@@ -383,32 +371,26 @@ static BVIEW_STATUS _jsonencode_report_ingress_sp ( char *buffer, int asicId,
         {
         /* lets see if this pool needs to be included in the report at all */
         /* if this pool needs not be reported, then we move to next pool */
-         if ((previous == NULL) &&
-            (current->iSp.data[pool-1].umShareBufferCount == 0))
+         if ((NULL == changes) &&
+            (BVIEW_BST_SNAPSHOT_ISP_DATA(current, pool-1)->umShareBufferCount == 0))
             continue;  
         }
 
-        if ((previous != NULL) &&
-            (previous->iSp.data[pool-1].umShareBufferCount == current->iSp.data[pool-1].umShareBufferCount))
-            continue;
-
-             val = current->iSp.data[pool-1].umShareBufferCount;
-             maxBufVal = options->bst_max_buffers_ptr->iSp.data[pool-1].umShareMaxBuf;
-             bst_json_convert_data(options, asic, &val, maxBufVal);
+             val = BVIEW_BST_SNAPSHOT_ISP_DATA(values, pool-1)->umShareBufferCount;
         /* Now that this pool needs to be included in the report, add the data to report */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      ispServicePoolTemplate, pool-1, val);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " [  ");
+        _JSONENCODE_OUTPUT_INDEX_AND_ADVANCE(out, options, pool - 1);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " , ");
+        _JSONENCODE_OUTPUT_U64_AND_ADVANCE(out, val);
+        _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, " ] ,");
 
     }
 
     /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+    _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
 
     /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    _JSONENCODE_OUTPUT_LITERAL_AND_ADVANCE(out, "] } ,");
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding INGRESS - ISP data Complete \n");
 
@@ -421,63 +403,44 @@ static BVIEW_STATUS _jsonencode_report_ingress_sp ( char *buffer, int asicId,
  *         "get-bst-report" REST API - ingress part.
  *
  *********************************************************************/
-BVIEW_STATUS _jsonencode_report_ingress ( char *buffer, 
+BVIEW_STATUS _jsonencode_report_ingress ( BSTJSON_OUTPUT_t *out, 
                                          int asicId,
-                                         const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                         const BSTJSON_CHANGES_t *changes,
                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                         const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
                                          const BSTJSON_REPORT_OPTIONS_t *options,
-                                         const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                         int bufLen,
-                                         int *length)
+                                         const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
     BVIEW_STATUS status;
     int tempLength = 0;
 
-    *length = 0;
-
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding INGRESS data \n");
 
     /* If Port-PriorityGroup realm is asked for, lets encode the corresponding data */
     if (options->includeIngressPortPriorityGroup)
     {
-        tempLength = 0;
-        status = _jsonencode_report_ingress_ippg(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
+        tempLength = BSTJSON_OUTPUT_LENGTH(out);
+        status = _jsonencode_report_ingress_ippg(out, asicId, changes, current, values, options, asic);
         _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+        tempLength = BSTJSON_OUTPUT_LENGTH(out) - tempLength;
     }
 
     /* If Port-ServicePool realm is asked for, lets encode the corresponding data */
     if (options->includeIngressPortServicePool)
     {
-        tempLength = 0;
-        status = _jsonencode_report_ingress_ipsp(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
+        tempLength = BSTJSON_OUTPUT_LENGTH(out);
+        status = _jsonencode_report_ingress_ipsp(out, asicId, changes, current, values, options, asic);
         _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+        tempLength = BSTJSON_OUTPUT_LENGTH(out) - tempLength;
     }
 
     /* If ServicePool realm is asked for, lets encode the corresponding data */
     if (options->includeIngressServicePool)
     {
-        tempLength = 0;
-        status = _jsonencode_report_ingress_sp(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
+        tempLength = BSTJSON_OUTPUT_LENGTH(out);
+        status = _jsonencode_report_ingress_sp(out, asicId, changes, current, values, options, asic);
         _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+        tempLength = BSTJSON_OUTPUT_LENGTH(out) - tempLength;
     }
 
     if (tempLength != 0)
@@ -490,7 +453,7 @@ BVIEW_STATUS _jsonencode_report_ingress ( char *buffer,
                options->includeEgressUcQueue ||
                options->includeEgressUcQueueGroup ))
         {
-            *(length) -= 1;
+            _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
         }
     }
 
@@ -499,3 +462,32 @@ BVIEW_STATUS _jsonencode_report_ingress ( char *buffer,
 
     return BVIEW_STATUS_SUCCESS;
 }
+
+/******************************************************************
+ * @brief  Creates a JSON buffer using the supplied data for the 
+ *         "get-bst-report" REST API - a single ingress realm.
+ *
+ * @note   The realm ends with a separator, as in the ingress part.
+ *
+ *********************************************************************/
+BVIEW_STATUS _jsonencode_report_ingress_realm ( BSTJSON_OUTPUT_t *out,
+                                               int asicId,
+                                               BVIEW_BST_SNAPSHOT_REALM_t realm,
+                                               const BSTJSON_CHANGES_t *changes,
+                                               const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                               const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
+                                               const BSTJSON_REPORT_OPTIONS_t *options,
+                                               const BVIEW_ASIC_CAPABILITIES_t *asic)
+{
+    switch (realm)
+    {
+        case BVIEW_BST_SNAPSHOT_IPPG:
+            return _jsonencode_report_ingress_ippg(out, asicId, changes, current, values, options, asic);
+        case BVIEW_BST_SNAPSHOT_IPSP:
+            return _jsonencode_report_ingress_ipsp(out, asicId, changes, current, values, options, asic);
+        case BVIEW_BST_SNAPSHOT_ISP:
+            return _jsonencode_report_ingress_sp(out, asicId, changes, current, values, options, asic);
+        default:
+            return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+}
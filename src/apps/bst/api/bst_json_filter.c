@@ -0,0 +1,313 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "broadview.h"
+
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+
+#include "bst.h"
+#include "bst_json_encoder.h"
+
+/* The filter of a report narrows the bitmap of the entries the realms
+ * walk, the one an incremental report is encoded from, so the encoders
+ * need not know about it. The entries left are converted and encoded as
+ * any others.
+ */
+
+/* an entry kept by the top-k selection */
+typedef struct _bst_json_filter_rank_
+{
+    uint64_t level;
+    unsigned int entry;
+} _BSTJSON_FILTER_RANK_t;
+
+/******************************************************************
+ * @brief  Tells whether a report leaves out some of its entries
+ *
+ * @param[in]   options     Options of the report
+ *
+ * @retval   true   the report carries the entries of its filter
+ * @retval   false  the report carries all its entries
+ *********************************************************************/
+bool bstjson_filter_active(const BSTJSON_REPORT_OPTIONS_t *options)
+{
+    const BVIEW_BST_REPORT_FILTER_t *filter = &options->filter;
+
+    return ((0 != filter->minValue) || (0 != filter->minPercentage) ||
+            (0 != filter->topK) || (true == filter->portRange) ||
+            (true == filter->queueRange));
+}
+
+/******************************************************************
+ * @brief  Port an entry of a realm belongs to
+ *
+ * @retval   port number, 0 for an entry which is not of a port
+ *********************************************************************/
+
+static int _bstjson_filter_port(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                BVIEW_BST_SNAPSHOT_REALM_t realm,
+                                unsigned int entry)
+{
+    const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout = current->layout;
+
+    switch (realm)
+    {
+        case BVIEW_BST_SNAPSHOT_IPPG:
+            return (int) (entry / layout->numPriorityGroups) + 1;
+        case BVIEW_BST_SNAPSHOT_IPSP:
+            return (int) (entry / layout->numIngressServicePools) + 1;
+        case BVIEW_BST_SNAPSHOT_EPSP:
+            return (int) (entry / layout->numServicePools) + 1;
+        case BVIEW_BST_SNAPSHOT_EUCQ:
+            return (int) BVIEW_BST_SNAPSHOT_EUCQ_DATA(current, entry)->port;
+        case BVIEW_BST_SNAPSHOT_EMCQ:
+            return (int) BVIEW_BST_SNAPSHOT_EMCQ_DATA(current, entry)->port;
+        default:
+            return 0;
+    }
+}
+
+/******************************************************************
+ * @brief  Tells whether the entries of a realm are queues
+ *********************************************************************/
+
+static bool _bstjson_filter_queues(BVIEW_BST_SNAPSHOT_REALM_t realm)
+{
+    switch (realm)
+    {
+        case BVIEW_BST_SNAPSHOT_EUCQ:
+        case BVIEW_BST_SNAPSHOT_EUCQG:
+        case BVIEW_BST_SNAPSHOT_EMCQ:
+        case BVIEW_BST_SNAPSHOT_CPUQ:
+        case BVIEW_BST_SNAPSHOT_RQEQ:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/******************************************************************
+ * @brief  Tells whether an entry is one the realms report, the common
+ *         pools kept with the ingress service pools are not
+ *********************************************************************/
+
+static bool _bstjson_filter_reported(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                     const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                     BVIEW_BST_SNAPSHOT_REALM_t realm,
+                                     unsigned int entry)
+{
+    switch (realm)
+    {
+        case BVIEW_BST_SNAPSHOT_IPSP:
+            return ((int) (entry % current->layout->numIngressServicePools) < asic->numServicePools);
+        case BVIEW_BST_SNAPSHOT_ISP:
+            return ((int) entry < asic->numServicePools);
+        default:
+            return true;
+    }
+}
+
+/******************************************************************
+ * @brief  Tells whether an entry is in the ranges of a filter and
+ *         at its least occupancy
+ *
+ * @param[out]  level   occupancy of the entry in the units of the
+ *                      report, if the filter needs it
+ *********************************************************************/
+
+static bool _bstjson_filter_selects(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                    const BSTJSON_REPORT_OPTIONS_t *options,
+                                    const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                    BVIEW_BST_SNAPSHOT_REALM_t realm,
+                                    unsigned int entry, uint64_t *level)
+{
+    const BVIEW_BST_REPORT_FILTER_t *filter = &options->filter;
+    int port = 0;
+
+    *level = 0;
+
+    if (false == _bstjson_filter_reported(current, asic, realm, entry))
+        return false;
+
+    if (true == filter->portRange)
+    {
+        port = _bstjson_filter_port(current, realm, entry);
+        if ((0 != port) && ((port < filter->firstPort) || (port > filter->lastPort)))
+            return false;
+    }
+
+    if ((true == filter->queueRange) && (true == _bstjson_filter_queues(realm)) &&
+        (((int) entry < filter->firstQueue) || ((int) entry > filter->lastQueue)))
+        return false;
+
+    if ((0 != filter->minPercentage) &&
+        (bstjson_convert_level(current, options, asic, realm, entry, true) <
+         (uint64_t) filter->minPercentage))
+        return false;
+
+    if ((0 != filter->minValue) || (0 != filter->topK))
+    {
+        *level = bstjson_convert_level(current, options, asic, realm, entry, false);
+        if (*level < filter->minValue)
+            return false;
+    }
+
+    return true;
+}
+
+/******************************************************************
+ * @brief  Moves the root of a min-heap down to its place
+ *********************************************************************/
+
+static void _bstjson_filter_sift_down(_BSTJSON_FILTER_RANK_t *heap, unsigned int size)
+{
+    _BSTJSON_FILTER_RANK_t root = heap[0];
+    unsigned int parent = 0, child = 0;
+
+    while ((child = 2 * parent + 1) < size)
+    {
+        if ((child + 1 < size) && (heap[child + 1].level < heap[child].level))
+            child++;
+        if (root.level <= heap[child].level)
+            break;
+        heap[parent] = heap[child];
+        parent = child;
+    }
+    heap[parent] = root;
+}
+
+/******************************************************************
+ * @brief  Moves the last entry of a min-heap up to its place
+ *********************************************************************/
+
+static void _bstjson_filter_sift_up(_BSTJSON_FILTER_RANK_t *heap, unsigned int last)
+{
+    _BSTJSON_FILTER_RANK_t leaf = heap[last];
+    unsigned int child = last, parent = 0;
+
+    while (child > 0)
+    {
+        parent = (child - 1) / 2;
+        if (heap[parent].level <= leaf.level)
+            break;
+        heap[child] = heap[parent];
+        child = parent;
+    }
+    heap[child] = leaf;
+}
+
+/******************************************************************
+ * @brief  Leaves out the entries of a report its filter does not
+ *         select
+ *
+ * @param[in]     current     Snapshot to report
+ * @param[in]     options     Options of the report, with the filter
+ * @param[in]     asic        Capabilities of the ASIC
+ * @param[in,out] changes     Entries to report, narrowed to those the
+ *                            filter selects
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  entries selected
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  invalid input parameter, or
+ *                                           percentages without the
+ *                                           max buffers
+ *
+ * @note     The occupancy of an entry is the largest of its buffer
+ *           counters. The top-k entries of a realm are kept in a
+ *           min-heap of k entries, the cost is about the number of
+ *           entries times log k. Of entries of the same occupancy, the
+ *           first ones are kept. The port range applies to the realms
+ *           of ports and to the queues of a port, the queue range to
+ *           the realms of queues.
+ *********************************************************************/
+BVIEW_STATUS bstjson_filter_apply(const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                  const BSTJSON_REPORT_OPTIONS_t *options,
+                                  const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                  BSTJSON_CHANGES_t *changes)
+{
+    const BVIEW_BST_REPORT_FILTER_t *filter;
+    _BSTJSON_FILTER_RANK_t heap[BVIEW_BST_REPORT_MAX_TOP_K];
+    unsigned int size = 0, topK = 0;
+    uint64_t *bits;
+    uint64_t level = 0;
+    int realm = 0, next = 0;
+
+    _JSONENCODE_ASSERT (current != NULL);
+    _JSONENCODE_ASSERT (options != NULL);
+    _JSONENCODE_ASSERT (asic != NULL);
+    _JSONENCODE_ASSERT (changes != NULL);
+
+    filter = &options->filter;
+    if ((filter->topK < 0) || (filter->topK > BVIEW_BST_REPORT_MAX_TOP_K))
+    {
+        return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    if ((0 != filter->minPercentage) && (NULL == options->bst_max_buffers_ptr))
+    {
+        return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    topK = (unsigned int) filter->topK;
+
+    /* the device is reported as a whole */
+    for (realm = BVIEW_BST_SNAPSHOT_IPPG; realm < BVIEW_BST_SNAPSHOT_REALM_MAX; realm++)
+    {
+        bits = &changes->bits[changes->base[realm]];
+        size = 0;
+
+        for (next = bstjson_changes_next(changes, realm, 0); next >= 0;
+             next = bstjson_changes_next(changes, realm, next + 1))
+        {
+            if (false == _bstjson_filter_selects(current, options, asic, realm, next, &level))
+            {
+                bits[next / 64] &= ~(1ULL << (next % 64));
+                continue;
+            }
+
+            if (0 == topK)
+                continue;
+
+            if (size < topK)
+            {
+                heap[size].level = level;
+                heap[size].entry = next;
+                _bstjson_filter_sift_up(heap, size++);
+                continue;
+            }
+
+            /* an entry at the occupancy of the least kept one does not displace it */
+            if (level <= heap[0].level)
+            {
+                bits[next / 64] &= ~(1ULL << (next % 64));
+                continue;
+            }
+
+            bits[heap[0].entry / 64] &= ~(1ULL << (heap[0].entry % 64));
+            heap[0].level = level;
+            heap[0].entry = next;
+            _bstjson_filter_sift_down(heap, size);
+        }
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
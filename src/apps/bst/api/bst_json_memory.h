@@ -21,6 +21,7 @@
 
 #include "broadview.h"
 #include "bst.h"
+#include "json_memory.h"
 
 
 #ifdef	__cplusplus
@@ -28,18 +29,28 @@ extern "C"
 {
 #endif
 
-/* A small implementation of a memory pool, that offers buffers in two sizes */
+/* The buffers of the bst application, in two sizes. They come from a
+   json_memory pool, which grows up to the following caps. */
+
+/* responses to the requests, at most */
+#define BSTJSON_MEMORY_MAX_RESPONSES     64
+
+/* reports encoded at a time (periodic, trigger and on-demand), at most */
+#define BSTJSON_MEMORY_MAX_REPORTS       16
 
 typedef enum _bstjson_memory_size_
 {
     BSTJSON_MEMSIZE_RESPONSE = 1024,
-    BSTJSON_MEMSIZE_REPORT = (sizeof(BVIEW_BST_ASIC_SNAPSHOT_DATA_t)+ (32*2048)),
+    /* a counter of 8 bytes takes up to 20 digits and its separators, so a
+       fully populated snapshot needs up to 4 times its size in JSON */
+    BSTJSON_MEMSIZE_REPORT = ((4 * BVIEW_BST_SNAPSHOT_MAX_SIZE) + (32*2048)),
 } BSTJSON_MEMORY_SIZE;
 
 
 BVIEW_STATUS bstjson_memory_init(void);
 BVIEW_STATUS bstjson_memory_allocate(BSTJSON_MEMORY_SIZE memSize, uint8_t **buffer);
 BVIEW_STATUS bstjson_memory_free(uint8_t *buffer);
+BVIEW_STATUS bstjson_memory_stats_get(BSTJSON_MEMORY_SIZE memSize, JSON_MEMORY_STATS_t *stats);
 void bstjson_memory_dump(void);
 
 #ifdef	__cplusplus
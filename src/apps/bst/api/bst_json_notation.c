@@ -0,0 +1,87 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <string.h>
+#include <inttypes.h>
+
+#include "broadview.h"
+#include "cJSON.h"
+
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+
+#include "bst.h"
+
+#include "bst_json_encoder.h"
+
+/******************************************************************
+ * @brief  Renders the external notation of the asic and of its ports,
+ *         for the report encoders to copy from.
+ *
+ * @param[in]   asicId      ASIC the notation is rendered for
+ * @param[in]   asic        Capabilities of the ASIC
+ * @param[out]  notation    Notation of the unit
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  notation rendered
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  invalid input parameter
+ * @retval   BVIEW_STATUS_INVALID_JSON  the south bound can not translate
+ *                                      the asic or one of the ports
+ *
+ * @note     Has to be called again whenever the south bound maps the
+ *           ports differently. Until it succeeds the table is left
+ *           without ports, and the encoders translate while encoding.
+ *********************************************************************/
+BVIEW_STATUS bstjson_notation_build(int asicId,
+                                    const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                    BSTJSON_NOTATION_t *notation)
+{
+    char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
+    int numPorts = 0, port = 0, index = 0;
+    int length = 0;
+
+    _JSONENCODE_ASSERT (asic != NULL);
+    _JSONENCODE_ASSERT (notation != NULL);
+
+    notation->numPorts = 0;
+
+    numPorts = (asic->numPorts > BVIEW_ASIC_MAX_PORTS) ? BVIEW_ASIC_MAX_PORTS : asic->numPorts;
+
+    memset(&notation->asic[0], 0, JSON_MAX_NODE_LENGTH);
+    JSON_ASIC_ID_MAP_TO_NOTATION(asicId, &notation->asic[0]);
+
+    for (port = 1; port <= numPorts; port++)
+    {
+        memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
+        JSON_PORT_MAP_TO_NOTATION(port, asicId, &portStr[0]);
+
+        length = bstjson_emit_string(&notation->port[port].str[0],
+                                     sizeof (notation->port[port].str), &portStr[0]);
+        notation->port[port].length = (length < 0) ? 0 : length;
+    }
+
+    for (index = 0; index < BSTJSON_NOTATION_MAX_INDEX; index++)
+    {
+        notation->index[index].length = bstjson_emit_int(&notation->index[index].str[0],
+                                                         sizeof (notation->index[index].str), index);
+    }
+
+    /* the ports are used once all of them are rendered */
+    notation->numPorts = numPorts;
+
+    return BVIEW_STATUS_SUCCESS;
+}
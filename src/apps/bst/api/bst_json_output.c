@@ -0,0 +1,238 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "broadview.h"
+
+#include "bst_json_emitter.h"
+#include "bst_json_output.h"
+
+/* appends what 'emitted' appends at the cursor. When it does not fit,
+   the window is flushed and 'emitted' is evaluated once more */
+#define _BSTJSON_OUTPUT_APPEND(out, emitted) \
+    do { \
+        int xemitted = (emitted); \
+        BVIEW_STATUS xrv; \
+        if (xemitted < 0) { \
+            xrv = bstjson_output_flush(out); \
+            if (BVIEW_STATUS_SUCCESS != xrv) \
+                return xrv; \
+            xemitted = (emitted); \
+            if (xemitted < 0) \
+                return BVIEW_STATUS_OUTOFMEMORY; \
+        } \
+        (out)->cur += xemitted; \
+        (out)->rem -= xemitted; \
+        return BVIEW_STATUS_SUCCESS; \
+    } while(0)
+
+/******************************************************************
+ * @brief  Sets up an output
+ *
+ * @param[in]   out         Output to set up
+ * @param[in]   buffer      Buffer, or window, the output goes to
+ * @param[in]   size        Size of the buffer
+ * @param[in]   flush       Takes the window when it is full, NULL if
+ *                          the buffer holds the whole output
+ * @param[in]   cookie      Passed to flush()
+ *
+ *********************************************************************/
+
+void bstjson_output_init(BSTJSON_OUTPUT_t *out, char *buffer, int size,
+                         BSTJSON_OUTPUT_FLUSH_t flush, void *cookie)
+{
+    out->buffer = buffer;
+    out->size = size;
+    out->cur = buffer;
+    out->rem = size;
+    out->flushed = 0;
+    out->flush = flush;
+    out->cookie = cookie;
+
+    if (size > 0)
+        buffer[0] = 0;
+}
+
+/******************************************************************
+ * @brief  Makes room in the window, by handing what is in it to the
+ *         flush function
+ *
+ * @param[in]   out         Output to make room in
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  room is made
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  the output has no flush function,
+ *                                     or nothing to flush
+ * @retval   other  as returned by the flush function
+ *
+ * @note     The last BSTJSON_OUTPUT_HOLD characters stay in the window,
+ *           so that the encoders can take them back.
+ *********************************************************************/
+
+BVIEW_STATUS bstjson_output_flush(BSTJSON_OUTPUT_t *out)
+{
+    int used = (int) (out->cur - out->buffer);
+    int keep = (used < BSTJSON_OUTPUT_HOLD) ? used : BSTJSON_OUTPUT_HOLD;
+    BVIEW_STATUS rv;
+
+    if ((NULL == out->flush) || (used <= keep))
+        return BVIEW_STATUS_OUTOFMEMORY;
+
+    rv = out->flush(out->cookie, out->buffer, used - keep);
+    if (BVIEW_STATUS_SUCCESS != rv)
+        return rv;
+
+    memmove(out->buffer, out->cur - keep, keep);
+    out->flushed += used - keep;
+    out->cur = out->buffer + keep;
+    out->rem = out->size - keep;
+    out->cur[0] = 0;
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Hands whatever is left in the window to the flush function
+ *
+ * @param[in]   out         Output to finish
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  the output is complete
+ * @retval   other  as returned by the flush function
+ *
+ * @note     An output without flush function is left as it is.
+ *********************************************************************/
+
+BVIEW_STATUS bstjson_output_finish(BSTJSON_OUTPUT_t *out)
+{
+    int used = (int) (out->cur - out->buffer);
+    BVIEW_STATUS rv;
+
+    if ((NULL == out->flush) || (0 == used))
+        return BVIEW_STATUS_SUCCESS;
+
+    rv = out->flush(out->cookie, out->buffer, used);
+    if (BVIEW_STATUS_SUCCESS != rv)
+        return rv;
+
+    out->flushed += used;
+    out->cur = out->buffer;
+    out->rem = out->size;
+    out->cur[0] = 0;
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Appends a string that needs no escaping, as is
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  appended
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  it does not fit
+ * @retval   other  as returned by the flush function
+ *********************************************************************/
+
+BVIEW_STATUS bstjson_output_literal(BSTJSON_OUTPUT_t *out, const char *src, int srcLen)
+{
+    _BSTJSON_OUTPUT_APPEND(out, bstjson_emit_literal(out->cur, out->rem, src, srcLen));
+}
+
+/******************************************************************
+ * @brief  Appends an unsigned value in decimal
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  appended
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  it does not fit
+ * @retval   other  as returned by the flush function
+ *********************************************************************/
+
+BVIEW_STATUS bstjson_output_u64(BSTJSON_OUTPUT_t *out, uint64_t value)
+{
+    _BSTJSON_OUTPUT_APPEND(out, bstjson_emit_u64(out->cur, out->rem, value));
+}
+
+/******************************************************************
+ * @brief  Appends a signed value in decimal
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  appended
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  it does not fit
+ * @retval   other  as returned by the flush function
+ *********************************************************************/
+
+BVIEW_STATUS bstjson_output_int(BSTJSON_OUTPUT_t *out, int value)
+{
+    _BSTJSON_OUTPUT_APPEND(out, bstjson_emit_int(out->cur, out->rem, value));
+}
+
+/******************************************************************
+ * @brief  Appends a string as a JSON string, quoted and escaped
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  appended
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  it does not fit
+ * @retval   other  as returned by the flush function
+ *********************************************************************/
+
+BVIEW_STATUS bstjson_output_string(BSTJSON_OUTPUT_t *out, const char *src)
+{
+    _BSTJSON_OUTPUT_APPEND(out, bstjson_emit_string(out->cur, out->rem, src));
+}
+
+/******************************************************************
+ * @brief  Appends the output of vsnprintf(), for the headers of the
+ *         reports
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  appended
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  it does not fit
+ * @retval   other  as returned by the flush function
+ *********************************************************************/
+
+BVIEW_STATUS bstjson_output_format(BSTJSON_OUTPUT_t *out, const char *format, ...)
+{
+    va_list args;
+    int actLen;
+    BVIEW_STATUS rv;
+
+    va_start(args, format);
+    actLen = vsnprintf(out->cur, out->rem, format, args);
+    va_end(args);
+
+    if ((actLen >= 0) && (actLen >= out->rem))
+    {
+        out->cur[0] = 0;
+        rv = bstjson_output_flush(out);
+        if (BVIEW_STATUS_SUCCESS != rv)
+            return rv;
+
+        va_start(args, format);
+        actLen = vsnprintf(out->cur, out->rem, format, args);
+        va_end(args);
+
+        if (actLen >= out->rem)
+        {
+            out->cur[0] = 0;
+            return BVIEW_STATUS_OUTOFMEMORY;
+        }
+    }
+
+    if (actLen < 0)
+        return BVIEW_STATUS_FAILURE;
+
+    out->cur += actLen;
+    out->rem -= actLen;
+    return BVIEW_STATUS_SUCCESS;
+}
@@ -0,0 +1,85 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_BST_JSON_OUTPUT_H
+#define INCLUDE_BST_JSON_OUTPUT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+#include "broadview.h"
+
+/* Where the report encoders append to. Without a flush function the
+ * buffer has to hold the whole document, and running out of it fails
+ * the encoding. With one, the buffer is a window which is handed to the
+ * flush function whenever it fills up, and the encoders go on at the
+ * start of it. Either way the output is kept NUL terminated.
+ */
+
+/* size of the window a streamed report is encoded in */
+#define BSTJSON_OUTPUT_WINDOW_SIZE      (16 * 1024)
+
+/* characters held back in the window when it is flushed, the encoders
+   take back the separators they appended last */
+#define BSTJSON_OUTPUT_HOLD             2
+
+/* takes the characters encoded so far out of the window */
+typedef BVIEW_STATUS (*BSTJSON_OUTPUT_FLUSH_t) (void *cookie, const char *data, int length);
+
+typedef struct _bst_json_output_
+{
+    char *buffer;
+    int size;
+    /* next character, and the room left from there */
+    char *cur;
+    int rem;
+    /* characters handed to the flush function so far */
+    int flushed;
+    BSTJSON_OUTPUT_FLUSH_t flush;
+    void *cookie;
+} BSTJSON_OUTPUT_t;
+
+/* characters appended to an output, flushed or not */
+#define BSTJSON_OUTPUT_LENGTH(out)      ((out)->flushed + (int) ((out)->cur - (out)->buffer))
+
+void bstjson_output_init(BSTJSON_OUTPUT_t *out, char *buffer, int size,
+                         BSTJSON_OUTPUT_FLUSH_t flush, void *cookie);
+
+BVIEW_STATUS bstjson_output_flush(BSTJSON_OUTPUT_t *out);
+
+BVIEW_STATUS bstjson_output_finish(BSTJSON_OUTPUT_t *out);
+
+BVIEW_STATUS bstjson_output_literal(BSTJSON_OUTPUT_t *out, const char *src, int srcLen);
+
+BVIEW_STATUS bstjson_output_u64(BSTJSON_OUTPUT_t *out, uint64_t value);
+
+BVIEW_STATUS bstjson_output_int(BSTJSON_OUTPUT_t *out, int value);
+
+BVIEW_STATUS bstjson_output_string(BSTJSON_OUTPUT_t *out, const char *src);
+
+BVIEW_STATUS bstjson_output_format(BSTJSON_OUTPUT_t *out, const char *format, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BST_JSON_OUTPUT_H */
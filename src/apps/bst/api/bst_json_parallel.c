@@ -0,0 +1,494 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "broadview.h"
+
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+
+#include "bst.h"
+#include "bst_json_encoder.h"
+
+/* The realms of a report are encoded into fragments of their own, the
+ * largest first, by the workers and by the thread which asked for the
+ * report. Once all are done, the fragments are copied into the output of
+ * the report in the order the realms are encoded one after another, so
+ * the report is the same either way. A report streamed as it is encoded
+ * is not split: the fragments would have to be held whole, and nothing
+ * would go out before the last of them is done.
+ */
+
+/* a realm of the report being encoded */
+typedef struct _bst_json_fragment_
+{
+    BVIEW_BST_SNAPSHOT_REALM_t realm;
+    /* entries to encode, an estimate of the time it takes */
+    unsigned int weight;
+    BVIEW_STATUS status;
+    /* the realm encoded, kept from one report to the next */
+    char *data;
+    int length;
+    int size;
+    /* the realm is encoded in here, and moved to data as it fills up */
+    char window[BSTJSON_OUTPUT_WINDOW_SIZE];
+} BSTJSON_FRAGMENT_t;
+
+typedef struct _bst_json_parallel_
+{
+    /* held by the report being encoded, one at a time */
+    pthread_mutex_t busy;
+    /* guards what follows */
+    pthread_mutex_t mutex;
+    pthread_cond_t work;
+    pthread_cond_t done;
+    bool stop;
+    int numWorkers;
+    pthread_t worker[BSTJSON_PARALLEL_MAX_WORKERS];
+
+    /* the report being encoded */
+    int asicId;
+    const BSTJSON_CHANGES_t *changes;
+    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous;
+    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current;
+    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values;
+    const BSTJSON_REPORT_OPTIONS_t *options;
+    const BVIEW_ASIC_CAPABILITIES_t *asic;
+
+    /* fragments to encode, the largest first, the next one to take and
+       the ones not done yet */
+    BSTJSON_FRAGMENT_t *queue[BVIEW_BST_SNAPSHOT_REALM_MAX];
+    int numQueued;
+    int next;
+    int pending;
+
+    BSTJSON_FRAGMENT_t fragment[BVIEW_BST_SNAPSHOT_REALM_MAX];
+} BSTJSON_PARALLEL_t;
+
+/* order the realms are encoded in, one after another */
+static const BVIEW_BST_SNAPSHOT_REALM_t bstJsonRealmOrder[BVIEW_BST_SNAPSHOT_REALM_MAX] = {
+    BVIEW_BST_SNAPSHOT_DEVICE,
+    BVIEW_BST_SNAPSHOT_IPPG,
+    BVIEW_BST_SNAPSHOT_IPSP,
+    BVIEW_BST_SNAPSHOT_ISP,
+    BVIEW_BST_SNAPSHOT_CPUQ,
+    BVIEW_BST_SNAPSHOT_EMCQ,
+    BVIEW_BST_SNAPSHOT_EPSP,
+    BVIEW_BST_SNAPSHOT_RQEQ,
+    BVIEW_BST_SNAPSHOT_ESP,
+    BVIEW_BST_SNAPSHOT_EUCQ,
+    BVIEW_BST_SNAPSHOT_EUCQG
+};
+
+/* workers of the application, NULL if the reports are encoded by the
+   calling thread alone */
+static BSTJSON_PARALLEL_t *bstJsonParallel = NULL;
+
+/******************************************************************
+ * @brief  Takes the encoded characters of a fragment out of its window
+ *
+ * @param[in]   cookie      Fragment
+ * @param[in]   data        Characters encoded
+ * @param[in]   length      Number of characters
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  the characters are kept
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  the fragment could not grow
+ *********************************************************************/
+static BVIEW_STATUS _bstjson_fragment_flush(void *cookie, const char *data, int length)
+{
+    BSTJSON_FRAGMENT_t *fragment = (BSTJSON_FRAGMENT_t *) cookie;
+    char *grown;
+    int size = fragment->size;
+
+    if (size - fragment->length < length)
+    {
+        while (size - fragment->length < length)
+            size = (0 == size) ? BSTJSON_OUTPUT_WINDOW_SIZE : 2 * size;
+
+        grown = realloc(fragment->data, size);
+        if (NULL == grown)
+            return BVIEW_STATUS_OUTOFMEMORY;
+        fragment->data = grown;
+        fragment->size = size;
+    }
+
+    memcpy(fragment->data + fragment->length, data, length);
+    fragment->length += length;
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Encodes a realm of the report into its fragment
+ *
+ * @param[in]   pool        Workers, with the report being encoded
+ * @param[in]   fragment    Fragment of the realm
+ *
+ * @note     The device realm ends with a separator as the other realms,
+ *           if it is encoded at all.
+ *********************************************************************/
+static void _bstjson_fragment_encode(const BSTJSON_PARALLEL_t *pool, BSTJSON_FRAGMENT_t *fragment)
+{
+    BSTJSON_OUTPUT_t out;
+    BVIEW_STATUS status;
+
+    fragment->length = 0;
+    bstjson_output_init(&out, &fragment->window[0], sizeof (fragment->window),
+                        _bstjson_fragment_flush, fragment);
+
+    switch (fragment->realm)
+    {
+        case BVIEW_BST_SNAPSHOT_DEVICE:
+            status = _jsonencode_report_device(&out, pool->previous, pool->current,
+                                               pool->options, pool->asic);
+            if ((BVIEW_STATUS_SUCCESS == status) && (0 != BSTJSON_OUTPUT_LENGTH(&out)))
+                status = bstjson_output_literal(&out, " ,", 2);
+            break;
+        case BVIEW_BST_SNAPSHOT_IPPG:
+        case BVIEW_BST_SNAPSHOT_IPSP:
+        case BVIEW_BST_SNAPSHOT_ISP:
+            status = _jsonencode_report_ingress_realm(&out, pool->asicId, fragment->realm,
+                                                      pool->changes, pool->current, pool->values,
+                                                      pool->options, pool->asic);
+            break;
+        default:
+            status = _jsonencode_report_egress_realm(&out, pool->asicId, fragment->realm,
+                                                     pool->changes, pool->current, pool->values,
+                                                     pool->options, pool->asic);
+            break;
+    }
+
+    if (BVIEW_STATUS_SUCCESS == status)
+        status = bstjson_output_finish(&out);
+
+    fragment->status = status;
+}
+
+/******************************************************************
+ * @brief  Encodes the queued fragments until none is left to take
+ *
+ * @param[in]   pool        Workers, with the report being encoded
+ *
+ * @note     Called, and returns, with the mutex held.
+ *********************************************************************/
+static void _bstjson_parallel_drain(BSTJSON_PARALLEL_t *pool)
+{
+    BSTJSON_FRAGMENT_t *fragment;
+
+    while (pool->next < pool->numQueued)
+    {
+        fragment = pool->queue[pool->next++];
+        pthread_mutex_unlock(&pool->mutex);
+
+        _bstjson_fragment_encode(pool, fragment);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (0 == --pool->pending)
+            pthread_cond_signal(&pool->done);
+    }
+}
+
+/******************************************************************
+ * @brief  Worker, encodes fragments as reports queue them
+ *
+ * @param[in]   arg         Workers
+ *
+ *********************************************************************/
+static void *_bstjson_parallel_worker(void *arg)
+{
+    BSTJSON_PARALLEL_t *pool = (BSTJSON_PARALLEL_t *) arg;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (false == pool->stop)
+    {
+        _bstjson_parallel_drain(pool);
+        if (false == pool->stop)
+            pthread_cond_wait(&pool->work, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+/******************************************************************
+ * @brief  Starts the workers which encode the realms of the reports
+ *
+ * @param[in]   workers     Number of workers, besides the threads
+ *                          asking for reports. 0 for none.
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  the workers are started
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  No memory for the workers
+ * @retval   BVIEW_STATUS_FAILURE  the workers could not be started
+ *
+ * @note     Without workers, or if they could not be started, the
+ *           realms are encoded one after another by the thread asking
+ *           for the report. At most BSTJSON_PARALLEL_MAX_WORKERS are
+ *           started.
+ *********************************************************************/
+BVIEW_STATUS bstjson_parallel_init(int workers)
+{
+    BSTJSON_PARALLEL_t *pool;
+    int i = 0;
+
+    bstjson_parallel_deinit();
+
+    if (workers <= 0)
+        return BVIEW_STATUS_SUCCESS;
+
+    if (workers > BSTJSON_PARALLEL_MAX_WORKERS)
+        workers = BSTJSON_PARALLEL_MAX_WORKERS;
+
+    pool = (BSTJSON_PARALLEL_t *) calloc(1, sizeof (BSTJSON_PARALLEL_t));
+    if (NULL == pool)
+        return BVIEW_STATUS_OUTOFMEMORY;
+
+    pthread_mutex_init(&pool->busy, NULL);
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->work, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    for (i = 0; i < workers; i++)
+    {
+        if (0 != pthread_create(&pool->worker[i], NULL, _bstjson_parallel_worker, pool))
+            break;
+        pool->numWorkers++;
+    }
+
+    bstJsonParallel = pool;
+
+    if (pool->numWorkers != workers)
+    {
+        _JSONENCODE_LOG(_JSONENCODE_DEBUG_ERROR, "BST-JSON-Encoder : started %d of %d workers \n",
+                        pool->numWorkers, workers);
+        bstjson_parallel_deinit();
+        return BVIEW_STATUS_FAILURE;
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Stops the workers started with bstjson_parallel_init()
+ *
+ * @note     No report may be encoded meanwhile.
+ *********************************************************************/
+void bstjson_parallel_deinit(void)
+{
+    BSTJSON_PARALLEL_t *pool = bstJsonParallel;
+    int i = 0;
+
+    if (NULL == pool)
+        return;
+
+    bstJsonParallel = NULL;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (i = 0; i < pool->numWorkers; i++)
+        pthread_join(pool->worker[i], NULL);
+
+    for (i = 0; i < BVIEW_BST_SNAPSHOT_REALM_MAX; i++)
+        free(pool->fragment[i].data);
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_mutex_destroy(&pool->busy);
+    free(pool);
+}
+
+/******************************************************************
+ * @brief  Copies the fragments into the output of the report
+ *
+ * @param[in]   out         Output of the report
+ * @param[in]   pool        Workers, with the fragments encoded
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  the realms are in the output
+ * @retval   other  as returned by the output
+ *
+ * @note     The last separator is taken back as the ingress and egress
+ *           parts do when encoded one after another.
+ *********************************************************************/
+static BVIEW_STATUS _bstjson_parallel_join(BSTJSON_OUTPUT_t *out, const BSTJSON_PARALLEL_t *pool)
+{
+    const BSTJSON_FRAGMENT_t *fragment;
+    BVIEW_STATUS status;
+    BVIEW_BST_SNAPSHOT_REALM_t realm;
+    bool egress = false;
+    int lastIngress = 0, lastEgress = 0;
+    int i = 0;
+
+    for (i = 0; i < BVIEW_BST_SNAPSHOT_REALM_MAX; i++)
+    {
+        realm = bstJsonRealmOrder[i];
+        fragment = &pool->fragment[realm];
+        if (0 == fragment->weight)
+            continue;
+
+        status = bstjson_output_literal(out, fragment->data, fragment->length);
+        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+
+        if ((BVIEW_BST_SNAPSHOT_IPPG == realm) || (BVIEW_BST_SNAPSHOT_IPSP == realm) ||
+            (BVIEW_BST_SNAPSHOT_ISP == realm))
+        {
+            lastIngress = fragment->length;
+        }
+        else if (BVIEW_BST_SNAPSHOT_DEVICE != realm)
+        {
+            egress = true;
+            lastEgress = fragment->length;
+        }
+    }
+
+    if (((true == egress) && (0 != lastEgress)) ||
+        ((false == egress) && (0 != lastIngress)))
+    {
+        _JSONENCODE_OUTPUT_BACKTRACK(out, 1);
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Encodes the realms of a report on the workers, once the
+ *         snapshots are compared and the counters converted.
+ *
+ * @param[in]   out         Output the realms are appended to
+ * @param[in]   asicId      ASIC for which this data is being encoded.
+ * @param[in]   previous    Stats of the last report, NULL for a snapshot
+ * @param[in]   changes     Entries which changed, NULL for a snapshot
+ * @param[in]   current     Stats to be reported
+ * @param[in]   values      Counters of current, in the units of the report
+ * @param[in]   options     Realms and units to be reported
+ * @param[in]   asic        Capabilities of the ASIC
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  the realms are encoded
+ * @retval   BVIEW_STATUS_UNSUPPORTED  nothing is encoded, the realms are
+ *           to be encoded one after another: there are no workers, they
+ *           are busy with another report, the report is streamed, it is
+ *           too small to be worth it, or a fragment could not be encoded
+ * @retval   other  as returned by the output
+ *
+ * @note     The realms are the same as the ones encoded one after
+ *           another, separators included.
+ *********************************************************************/
+BVIEW_STATUS bstjson_parallel_encode_realms(BSTJSON_OUTPUT_t *out,
+                                            int asicId,
+                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                            const BSTJSON_CHANGES_t *changes,
+                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *values,
+                                            const BSTJSON_REPORT_OPTIONS_t *options,
+                                            const BVIEW_ASIC_CAPABILITIES_t *asic)
+{
+    BSTJSON_PARALLEL_t *pool = bstJsonParallel;
+    BSTJSON_FRAGMENT_t *queue[BVIEW_BST_SNAPSHOT_REALM_MAX];
+    BSTJSON_FRAGMENT_t *fragment;
+    bool include[BVIEW_BST_SNAPSHOT_REALM_MAX] = { false };
+    unsigned int total = 0;
+    int numQueued = 0;
+    int realm = 0, i = 0, j = 0;
+    BVIEW_STATUS status = BVIEW_STATUS_SUCCESS;
+
+    /* a streamed report goes out a window at a time */
+    if ((NULL == pool) || (NULL != out->flush) ||
+        (0 != pthread_mutex_trylock(&pool->busy)))
+        return BVIEW_STATUS_UNSUPPORTED;
+
+    bstjson_realms_included(options, include);
+    include[BVIEW_BST_SNAPSHOT_DEVICE] = options->includeDevice;
+
+    /* the realms, the largest first */
+    for (realm = 0; realm < BVIEW_BST_SNAPSHOT_REALM_MAX; realm++)
+    {
+        fragment = &pool->fragment[realm];
+        fragment->realm = (BVIEW_BST_SNAPSHOT_REALM_t) realm;
+        fragment->weight = 0;
+        fragment->length = 0;
+        if (false == include[realm])
+            continue;
+
+        if (BVIEW_BST_SNAPSHOT_DEVICE == realm)
+            fragment->weight = 1;
+        else if (NULL != changes)
+            fragment->weight = 1 + bstjson_changes_count(changes, realm);
+        else
+            fragment->weight = 1 + current->layout->entries[realm];
+        total += fragment->weight;
+
+        for (i = numQueued; (i > 0) && (queue[i - 1]->weight < fragment->weight); i--)
+            queue[i] = queue[i - 1];
+        queue[i] = fragment;
+        numQueued++;
+    }
+
+    if ((numQueued < 2) || (total < BSTJSON_PARALLEL_MIN_ENTRIES))
+    {
+        pthread_mutex_unlock(&pool->busy);
+        return BVIEW_STATUS_UNSUPPORTED;
+    }
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding %d realms on %d workers \n",
+                    numQueued, pool->numWorkers);
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->asicId = asicId;
+    pool->previous = previous;
+    pool->changes = changes;
+    pool->current = current;
+    pool->values = values;
+    pool->options = options;
+    pool->asic = asic;
+    memcpy(&pool->queue[0], &queue[0], numQueued * sizeof (queue[0]));
+    pool->numQueued = numQueued;
+    pool->next = 0;
+    pool->pending = numQueued;
+    pthread_cond_broadcast(&pool->work);
+
+    /* lend a hand, then wait for the realms still being encoded */
+    _bstjson_parallel_drain(pool);
+    while (0 != pool->pending)
+        pthread_cond_wait(&pool->done, &pool->mutex);
+
+    pool->numQueued = 0;
+    pool->next = 0;
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (j = 0; j < BVIEW_BST_SNAPSHOT_REALM_MAX; j++)
+    {
+        if ((0 != pool->fragment[j].weight) && (BVIEW_STATUS_SUCCESS != pool->fragment[j].status))
+        {
+            _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) realm %d not encoded [%d] \n",
+                            j, pool->fragment[j].status);
+            status = BVIEW_STATUS_UNSUPPORTED;
+        }
+    }
+
+    if (BVIEW_STATUS_SUCCESS == status)
+        status = _bstjson_parallel_join(out, pool);
+
+    pthread_mutex_unlock(&pool->busy);
+    return status;
+}
@@ -49,7 +49,7 @@ BVIEW_STATUS bstjson_configure_bst_feature (void *cookie, char *jsonBuffer, int
     cJSON *json_id, *json_bstEnable, *json_sendAsyncReports;
     cJSON *json_collectionInterval, *json_statUnitsInCells,  *root, *params;
     cJSON *json_maxTriggerReports, *json_sendSnapshotTrigger,  *json_triggerTransmitInterval, *json_sendIncrementalReport;
-    cJSON *json_statsInPercentage;
+    cJSON *json_statsInPercentage, *json_asyncReportFormat, *json_sendWindowReport;
 
     /* Local non-command-parameter JSON variable declarations */
     char jsonrpc[JSON_MAX_NODE_LENGTH] = {0};
@@ -227,6 +227,38 @@ BVIEW_STATUS bstjson_configure_bst_feature (void *cookie, char *jsonBuffer, int
       command.configMask = (command.configMask | (1 << BST_CONFIG_PARAMS_STATS_IN_PERCENT));
     }
 
+    /* Parsing and Validating 'async-report-format' from JSON buffer */
+    json_asyncReportFormat = cJSON_GetObjectItem(params, "async-report-format");
+    if (NULL != json_asyncReportFormat)
+    {
+      JSON_VALIDATE_JSON_AS_STRING(json_asyncReportFormat, "async-report-format", BVIEW_STATUS_INVALID_JSON);
+      if (0 == strcmp(json_asyncReportFormat->valuestring, BVIEW_REST_FORMAT_NAME_JSON))
+      {
+        command.asyncReportFormat = BVIEW_REST_FORMAT_JSON;
+      }
+      else
+      {
+        /* Ensure that 'async-report-format' in the JSON is either "json" or "cbor" */
+        JSON_COMPARE_STRINGS_AND_CLEANUP ("async-report-format", json_asyncReportFormat->valuestring,
+                                          BVIEW_REST_FORMAT_NAME_CBOR);
+        command.asyncReportFormat = BVIEW_REST_FORMAT_CBOR;
+      }
+      command.configMask = (command.configMask | (1 << BST_CONFIG_PARAMS_ASYNC_REP_FORMAT));
+    }
+
+    /* Parsing and Validating 'send-window-report' from JSON buffer */
+    json_sendWindowReport = cJSON_GetObjectItem(params, "send-window-report");
+    if (NULL != json_sendWindowReport)
+    {
+      JSON_VALIDATE_JSON_POINTER(json_sendWindowReport, "send-window-report", BVIEW_STATUS_INVALID_JSON);
+      JSON_VALIDATE_JSON_AS_NUMBER(json_sendWindowReport, "send-window-report");
+      /* Copy the value */
+      command.sendWindowReport = json_sendWindowReport->valueint;
+      /* Ensure  that the number 'send-window-report' is within range of [0,1] */
+      JSON_CHECK_VALUE_AND_CLEANUP (command.sendWindowReport, 0, 1);
+      command.configMask = (command.configMask | (1 << BST_CONFIG_PARAMS_SND_WINDOW_REP));
+    }
+
     /* Send the 'command' along with 'asicId' and 'cookie' to the Application thread. */
     status = bstjson_configure_bst_feature_impl (cookie, asicId, id, &command);
 
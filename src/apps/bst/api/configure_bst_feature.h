@@ -32,6 +32,7 @@ extern "C"
 
 #include "broadview.h"
 #include "json.h"
+#include "rest_api.h"
 
 #include "cJSON.h"
 
@@ -45,7 +46,9 @@ typedef enum _bst_config_param_mask_pos_
   BST_CONFIG_PARAMS_SND_SNAP_TGR,
   BST_CONFIG_PARAMS_TGR_RL_INTVL,
   BST_CONFIG_PARAMS_ASYNC_FULL_REP,
-  BST_CONFIG_PARAMS_STATS_IN_PERCENT
+  BST_CONFIG_PARAMS_STATS_IN_PERCENT,
+  BST_CONFIG_PARAMS_ASYNC_REP_FORMAT,
+  BST_CONFIG_PARAMS_SND_WINDOW_REP
 }BST_CONFIG_PARAM_MASK_t;
 
 /* Structure to pass API parameters to the BST APP */
@@ -60,6 +63,10 @@ typedef struct _bstjson_configure_bst_feature_
     int sendSnapshotOnTrigger;
     int triggerTransmitInterval;
     int sendIncrementalReport;
+    /* format of the asynchronous reports, JSON or CBOR */
+    BVIEW_REST_FORMAT_t asyncReportFormat;
+    /* send the aggregates of the window after a periodic report */
+    int sendWindowReport;
     int configMask;
 } BSTJSON_CONFIGURE_BST_FEATURE_t;
 
@@ -0,0 +1,265 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+/* Include Header files */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "broadview.h"
+#include "json.h"
+
+#include "cJSON.h"
+#include "configure_bst_subscription.h"
+
+/******************************************************************
+ * @brief  Gets the realm of its name
+ *
+ * @param[in]    name       name of the realm, as in the reports
+ *
+ * @retval   the realm, 0 for an unknown name
+ *********************************************************************/
+int bstjson_subscription_realm_get (const char *name)
+{
+    const char *realms[] = BSTJSON_SUBSCRIPTION_REALM_NAMES;
+    int realm;
+
+    for (realm = BVIEW_BST_REALM_ID_MIN; realm < BVIEW_BST_REALM_ID_MAX; realm++)
+    {
+        if (0 == strcmp(name, realms[realm]))
+        {
+            return realm;
+        }
+    }
+
+    return 0;
+}
+
+/******************************************************************
+ * @brief  REST API Handler
+ *
+ * @param[in]    cookie     Context for the API from Web server
+ * @param[in]    jsonBuffer Raw Json Buffer
+ * @param[in]    bufLength  Json Buffer length (bytes)
+ *                           
+ * @retval   BVIEW_STATUS_SUCCESS  JSON Parsed and parameters passed to BST APP
+ * @retval   BVIEW_STATUS_INVALID_JSON  JSON is malformatted, or doesn't 
+ * 					have necessary data.
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER Invalid input parameter
+ *
+ * @note     A subscription which is not removed needs the collector,
+ *           the realms and the interval. See the _impl() function for
+ *           info passing to BST APP
+ *********************************************************************/
+BVIEW_STATUS bstjson_configure_bst_subscription (void *cookie, char *jsonBuffer, int bufLength)
+{
+
+    /* Local Variables for JSON Parsing */
+    cJSON *json_jsonrpc, *json_method, *json_asicId;
+    cJSON *json_id, *json_subscriptionId, *json_enable, *json_collectorIp;
+    cJSON *json_collectorPort, *json_format, *json_realms, *json_realm;
+    cJSON *json_collectionInterval, *json_sendIncrementalReport, *root, *params;
+
+    /* Local non-command-parameter JSON variable declarations */
+    char jsonrpc[JSON_MAX_NODE_LENGTH] = {0};
+    char method[JSON_MAX_NODE_LENGTH] = {0};
+    int asicId = 0, id = 0, index = 0, realm = 0;
+
+    /* Local variable declarations */
+    BVIEW_STATUS status = BVIEW_STATUS_SUCCESS;
+    BSTJSON_CONFIGURE_BST_SUBSCRIPTION_t command;
+
+    memset(&command, 0, sizeof (command));
+
+    /* Validating input parameters */
+
+    /* Validating 'cookie' */
+    JSON_VALIDATE_POINTER(cookie, "cookie", BVIEW_STATUS_INVALID_PARAMETER);
+
+    /* Validating 'jsonBuffer' */
+    JSON_VALIDATE_POINTER(jsonBuffer, "jsonBuffer", BVIEW_STATUS_INVALID_PARAMETER);
+
+    /* Validating 'bufLength' */
+    if (bufLength > strlen(jsonBuffer))
+    {
+        _jsonlog("Invalid value for parameter bufLength %d ", bufLength );
+        return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    /* Parse JSON to a C-JSON root */
+    root = cJSON_Parse(jsonBuffer);
+    JSON_VALIDATE_JSON_POINTER(root, "root", BVIEW_STATUS_INVALID_JSON);
+
+    /* Obtain command parameters */
+    params = cJSON_GetObjectItem(root, "params");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(params, "params", BVIEW_STATUS_INVALID_JSON);
+
+    /* Parsing and Validating 'jsonrpc' from JSON buffer */
+    json_jsonrpc = cJSON_GetObjectItem(root, "jsonrpc");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_jsonrpc, "jsonrpc", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_STRING(json_jsonrpc, "jsonrpc", BVIEW_STATUS_INVALID_JSON);
+    /* Copy the string, with a limit on max characters */
+    strncpy (&jsonrpc[0], json_jsonrpc->valuestring, JSON_MAX_NODE_LENGTH - 1);
+    /* Ensure that 'jsonrpc' in the JSON equals "2.0" */
+    JSON_COMPARE_STRINGS_AND_CLEANUP ("jsonrpc", &jsonrpc[0], "2.0");
+
+
+    /* Parsing and Validating 'method' from JSON buffer */
+    json_method = cJSON_GetObjectItem(root, "method");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_method, "method", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_STRING(json_method, "method", BVIEW_STATUS_INVALID_JSON);
+    /* Copy the string, with a limit on max characters */
+    strncpy (&method[0], json_method->valuestring, JSON_MAX_NODE_LENGTH - 1);
+    /* Ensure that 'method' in the JSON equals "configure-bst-subscription" */
+    JSON_COMPARE_STRINGS_AND_CLEANUP ("method", &method[0], "configure-bst-subscription");
+
+
+    /* Parsing and Validating 'asic-id' from JSON buffer */
+    json_asicId = cJSON_GetObjectItem(root, "asic-id");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_asicId, "asic-id", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_STRING(json_asicId, "asic-id", BVIEW_STATUS_INVALID_JSON);
+    /* Copy the 'asic-id' in external notation to our internal representation */
+    JSON_ASIC_ID_MAP_FROM_NOTATION(asicId, json_asicId->valuestring);
+
+
+    /* Parsing and Validating 'id' from JSON buffer */
+    json_id = cJSON_GetObjectItem(root, "id");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_id, "id", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_NUMBER(json_id, "id");
+    /* Copy the value */
+    id = json_id->valueint;
+    /* Ensure  that the number 'id' is within range of [1,100000] */
+    JSON_CHECK_VALUE_AND_CLEANUP (id, 1, 100000);
+
+
+    /* Parsing and Validating 'subscription-id' from JSON buffer */
+    json_subscriptionId = cJSON_GetObjectItem(params, "subscription-id");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_subscriptionId, "subscription-id", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_NUMBER(json_subscriptionId, "subscription-id");
+    /* Copy the value */
+    command.subscriptionId = json_subscriptionId->valueint;
+    /* Ensure  that the number 'subscription-id' is within range of [0,BVIEW_REST_MAX_SUBSCRIBERS-1] */
+    JSON_CHECK_VALUE_AND_CLEANUP (command.subscriptionId, 0, BVIEW_REST_MAX_SUBSCRIBERS - 1);
+
+
+    /* Parsing and Validating 'enable' from JSON buffer */
+    json_enable = cJSON_GetObjectItem(params, "enable");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_enable, "enable", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_NUMBER(json_enable, "enable");
+    /* Copy the value */
+    command.enable = json_enable->valueint;
+    /* Ensure  that the number 'enable' is within range of [0,1] */
+    JSON_CHECK_VALUE_AND_CLEANUP (command.enable, 0, 1);
+
+    if (0 == command.enable)
+    {
+        /* the subscription is removed, nothing else is needed */
+        status = bstjson_configure_bst_subscription_impl (cookie, asicId, id, &command);
+        cJSON_Delete(root);
+        return status;
+    }
+
+
+    /* Parsing and Validating 'collector-ip' from JSON buffer */
+    json_collectorIp = cJSON_GetObjectItem(params, "collector-ip");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_collectorIp, "collector-ip", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_STRING(json_collectorIp, "collector-ip", BVIEW_STATUS_INVALID_JSON);
+    /* Copy the string, with a limit on max characters */
+    strncpy (&command.collectorIp[0], json_collectorIp->valuestring, JSON_MAX_NODE_LENGTH - 1);
+
+
+    /* Parsing and Validating 'collector-port' from JSON buffer */
+    json_collectorPort = cJSON_GetObjectItem(params, "collector-port");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_collectorPort, "collector-port", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_NUMBER(json_collectorPort, "collector-port");
+    /* Copy the value */
+    command.collectorPort = json_collectorPort->valueint;
+    /* Ensure  that the number 'collector-port' is within range of [1,65535] */
+    JSON_CHECK_VALUE_AND_CLEANUP (command.collectorPort, 1, 65535);
+
+
+    /* Parsing and Validating 'realms' from JSON buffer */
+    json_realms = cJSON_GetObjectItem(params, "realms");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_realms, "realms", BVIEW_STATUS_INVALID_JSON);
+    if ((cJSON_Array != json_realms->type) || (0 == cJSON_GetArraySize(json_realms)))
+    {
+        _jsonlog("Error parsing JSON, realms not a list of realms ");
+        cJSON_Delete(root);
+        return BVIEW_STATUS_INVALID_JSON;
+    }
+    for (index = 0; index < cJSON_GetArraySize(json_realms); index++)
+    {
+        json_realm = cJSON_GetArrayItem(json_realms, index);
+        JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_realm, "realms", BVIEW_STATUS_INVALID_JSON);
+        JSON_VALIDATE_JSON_AS_STRING(json_realm, "realms", BVIEW_STATUS_INVALID_JSON);
+        /* Ensure that each of 'realms' is the name of a realm */
+        realm = bstjson_subscription_realm_get (json_realm->valuestring);
+        JSON_CHECK_VALUE_AND_CLEANUP (realm, BVIEW_BST_REALM_ID_MIN, BVIEW_BST_REALM_ID_MAX - 1);
+        command.realmMask = (command.realmMask | (1 << realm));
+    }
+
+
+    /* Parsing and Validating 'collection-interval' from JSON buffer */
+    json_collectionInterval = cJSON_GetObjectItem(params, "collection-interval");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_collectionInterval, "collection-interval", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_NUMBER(json_collectionInterval, "collection-interval");
+    /* Copy the value */
+    command.collectionInterval = json_collectionInterval->valueint;
+    /* Ensure  that the number 'collection-interval' is within range of [1,600] */
+    JSON_CHECK_VALUE_AND_CLEANUP (command.collectionInterval, 1, 600);
+
+
+    /* Parsing and Validating 'async-full-reports' from JSON buffer */
+    command.sendIncrementalReport = 1;
+    json_sendIncrementalReport = cJSON_GetObjectItem(params, "async-full-reports");
+    if (NULL != json_sendIncrementalReport)
+    {
+      JSON_VALIDATE_JSON_AS_NUMBER(json_sendIncrementalReport, "async-full-reports");
+      /* Copy the value */
+      JSON_CHECK_VALUE_AND_CLEANUP (json_sendIncrementalReport->valueint, 0, 1);
+      command.sendIncrementalReport = (0 == json_sendIncrementalReport->valueint) ? 1 : 0;
+    }
+
+
+    /* Parsing and Validating 'async-report-format' from JSON buffer */
+    command.format = BVIEW_REST_FORMAT_JSON;
+    json_format = cJSON_GetObjectItem(params, "async-report-format");
+    if (NULL != json_format)
+    {
+      JSON_VALIDATE_JSON_AS_STRING(json_format, "async-report-format", BVIEW_STATUS_INVALID_JSON);
+      if (0 != strcmp(json_format->valuestring, BVIEW_REST_FORMAT_NAME_JSON))
+      {
+        /* Ensure that 'async-report-format' in the JSON is either "json" or "cbor" */
+        JSON_COMPARE_STRINGS_AND_CLEANUP ("async-report-format", json_format->valuestring,
+                                          BVIEW_REST_FORMAT_NAME_CBOR);
+        command.format = BVIEW_REST_FORMAT_CBOR;
+      }
+    }
+
+    /* Send the 'command' along with 'asicId' and 'cookie' to the Application thread. */
+    status = bstjson_configure_bst_subscription_impl (cookie, asicId, id, &command);
+
+    /* Free up any allocated resources and return status code */
+    if (root != NULL)
+    {
+        cJSON_Delete(root);
+    }
+
+    return status;
+}
+
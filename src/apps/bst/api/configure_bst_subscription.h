@@ -0,0 +1,85 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_CONFIGURE_BST_SUBSCRIPTION_H 
+#define	INCLUDE_CONFIGURE_BST_SUBSCRIPTION_H  
+
+#ifdef	__cplusplus  
+extern "C"
+{
+#endif  
+
+
+/* Include Header files */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "broadview.h"
+#include "json.h"
+#include "rest_api.h"
+#include "bst.h"
+
+#include "cJSON.h"
+
+/* names of the realms a subscription reports, by BVIEW_BST_REALM_ID_t */
+#define BSTJSON_SUBSCRIPTION_REALM_NAMES  { NULL, \
+          "device", \
+          "egress-port-service-pool", \
+          "egress-service-pool", \
+          "egress-uc-queue", \
+          "egress-uc-queue-group", \
+          "egress-mc-queue", \
+          "egress-cpu-queue", \
+          "egress-rqe-queue", \
+          "ingress-port-priority-group", \
+          "ingress-port-service-pool", \
+          "ingress-service-pool" }
+
+/* Structure to pass API parameters to the BST APP */
+typedef struct _bstjson_configure_bst_subscription_
+{
+    /* subscription, 0 to BVIEW_REST_MAX_SUBSCRIBERS - 1 */
+    int subscriptionId;
+    /* 0 removes the subscription */
+    int enable;
+    /* collector the reports of the subscription go to */
+    char collectorIp[JSON_MAX_NODE_LENGTH];
+    int collectorPort;
+    /* format of the reports, JSON or CBOR */
+    BVIEW_REST_FORMAT_t format;
+    /* realms reported, bit n for BVIEW_BST_REALM_ID_t n */
+    int realmMask;
+    /* seconds between the reports */
+    int collectionInterval;
+    /* counters changed since the last report of the subscription, or all */
+    int sendIncrementalReport;
+} BSTJSON_CONFIGURE_BST_SUBSCRIPTION_t;
+
+
+/* Function Prototypes */
+BVIEW_STATUS bstjson_configure_bst_subscription(void *cookie, char *jsonBuffer, int bufLength);
+BVIEW_STATUS bstjson_configure_bst_subscription_impl(void *cookie, int asicId, int id, BSTJSON_CONFIGURE_BST_SUBSCRIPTION_t *pCommand);
+int bstjson_subscription_realm_get (const char *name);
+
+
+#ifdef	__cplusplus  
+}
+#endif  
+
+#endif /* INCLUDE_CONFIGURE_BST_SUBSCRIPTION_H */
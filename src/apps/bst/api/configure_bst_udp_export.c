@@ -0,0 +1,241 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+/* Include Header files */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "broadview.h"
+#include "json.h"
+
+#include "cJSON.h"
+#include "configure_bst_subscription.h"
+#include "configure_bst_udp_export.h"
+
+/******************************************************************
+ * @brief  REST API Handler
+ *
+ * @param[in]    cookie     Context for the API from Web server
+ * @param[in]    jsonBuffer Raw Json Buffer
+ * @param[in]    bufLength  Json Buffer length (bytes)
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  JSON Parsed and parameters passed to BST APP
+ * @retval   BVIEW_STATUS_INVALID_JSON  JSON is malformatted, or doesn't
+ * 					have necessary data.
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER Invalid input parameter
+ *
+ * @note     An export which is not stopped needs the collector and the
+ *           sample interval. All the realms are exported unless 'realms'
+ *           names some. See the _impl() function for info passing to
+ *           BST APP
+ *********************************************************************/
+BVIEW_STATUS bstjson_configure_bst_udp_export (void *cookie, char *jsonBuffer, int bufLength)
+{
+
+    /* Local Variables for JSON Parsing */
+    cJSON *json_jsonrpc, *json_method, *json_asicId;
+    cJSON *json_id, *json_enable, *json_collectorIp, *json_collectorPort;
+    cJSON *json_sampleInterval, *json_resyncInterval, *json_mtu;
+    cJSON *json_realms, *json_realm, *root, *params;
+
+    /* Local non-command-parameter JSON variable declarations */
+    char jsonrpc[JSON_MAX_NODE_LENGTH] = {0};
+    char method[JSON_MAX_NODE_LENGTH] = {0};
+    int asicId = 0, id = 0, index = 0, realm = 0;
+
+    /* Local variable declarations */
+    BVIEW_STATUS status = BVIEW_STATUS_SUCCESS;
+    BSTJSON_CONFIGURE_BST_UDP_EXPORT_t command;
+
+    memset(&command, 0, sizeof (command));
+
+    /* Validating input parameters */
+
+    /* Validating 'cookie' */
+    JSON_VALIDATE_POINTER(cookie, "cookie", BVIEW_STATUS_INVALID_PARAMETER);
+
+    /* Validating 'jsonBuffer' */
+    JSON_VALIDATE_POINTER(jsonBuffer, "jsonBuffer", BVIEW_STATUS_INVALID_PARAMETER);
+
+    /* Validating 'bufLength' */
+    if (bufLength > strlen(jsonBuffer))
+    {
+        _jsonlog("Invalid value for parameter bufLength %d ", bufLength );
+        return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    /* Parse JSON to a C-JSON root */
+    root = cJSON_Parse(jsonBuffer);
+    JSON_VALIDATE_JSON_POINTER(root, "root", BVIEW_STATUS_INVALID_JSON);
+
+    /* Obtain command parameters */
+    params = cJSON_GetObjectItem(root, "params");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(params, "params", BVIEW_STATUS_INVALID_JSON);
+
+    /* Parsing and Validating 'jsonrpc' from JSON buffer */
+    json_jsonrpc = cJSON_GetObjectItem(root, "jsonrpc");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_jsonrpc, "jsonrpc", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_STRING(json_jsonrpc, "jsonrpc", BVIEW_STATUS_INVALID_JSON);
+    /* Copy the string, with a limit on max characters */
+    strncpy (&jsonrpc[0], json_jsonrpc->valuestring, JSON_MAX_NODE_LENGTH - 1);
+    /* Ensure that 'jsonrpc' in the JSON equals "2.0" */
+    JSON_COMPARE_STRINGS_AND_CLEANUP ("jsonrpc", &jsonrpc[0], "2.0");
+
+
+    /* Parsing and Validating 'method' from JSON buffer */
+    json_method = cJSON_GetObjectItem(root, "method");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_method, "method", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_STRING(json_method, "method", BVIEW_STATUS_INVALID_JSON);
+    /* Copy the string, with a limit on max characters */
+    strncpy (&method[0], json_method->valuestring, JSON_MAX_NODE_LENGTH - 1);
+    /* Ensure that 'method' in the JSON equals "configure-bst-udp-export" */
+    JSON_COMPARE_STRINGS_AND_CLEANUP ("method", &method[0], "configure-bst-udp-export");
+
+
+    /* Parsing and Validating 'asic-id' from JSON buffer */
+    json_asicId = cJSON_GetObjectItem(root, "asic-id");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_asicId, "asic-id", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_STRING(json_asicId, "asic-id", BVIEW_STATUS_INVALID_JSON);
+    /* Copy the 'asic-id' in external notation to our internal representation */
+    JSON_ASIC_ID_MAP_FROM_NOTATION(asicId, json_asicId->valuestring);
+
+
+    /* Parsing and Validating 'id' from JSON buffer */
+    json_id = cJSON_GetObjectItem(root, "id");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_id, "id", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_NUMBER(json_id, "id");
+    /* Copy the value */
+    id = json_id->valueint;
+    /* Ensure  that the number 'id' is within range of [1,100000] */
+    JSON_CHECK_VALUE_AND_CLEANUP (id, 1, 100000);
+
+
+    /* Parsing and Validating 'enable' from JSON buffer */
+    json_enable = cJSON_GetObjectItem(params, "enable");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_enable, "enable", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_NUMBER(json_enable, "enable");
+    /* Copy the value */
+    command.enable = json_enable->valueint;
+    /* Ensure  that the number 'enable' is within range of [0,1] */
+    JSON_CHECK_VALUE_AND_CLEANUP (command.enable, 0, 1);
+
+    if (0 == command.enable)
+    {
+        /* the export is stopped, nothing else is needed */
+        status = bstjson_configure_bst_udp_export_impl (cookie, asicId, id, &command);
+        cJSON_Delete(root);
+        return status;
+    }
+
+
+    /* Parsing and Validating 'collector-ip' from JSON buffer */
+    json_collectorIp = cJSON_GetObjectItem(params, "collector-ip");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_collectorIp, "collector-ip", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_STRING(json_collectorIp, "collector-ip", BVIEW_STATUS_INVALID_JSON);
+    /* Copy the string, with a limit on max characters */
+    strncpy (&command.collectorIp[0], json_collectorIp->valuestring, JSON_MAX_NODE_LENGTH - 1);
+
+
+    /* Parsing and Validating 'collector-port' from JSON buffer */
+    json_collectorPort = cJSON_GetObjectItem(params, "collector-port");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_collectorPort, "collector-port", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_NUMBER(json_collectorPort, "collector-port");
+    /* Copy the value */
+    command.collectorPort = json_collectorPort->valueint;
+    /* Ensure  that the number 'collector-port' is within range of [1,65535] */
+    JSON_CHECK_VALUE_AND_CLEANUP (command.collectorPort, 1, 65535);
+
+
+    /* Parsing and Validating 'sample-interval' from JSON buffer */
+    json_sampleInterval = cJSON_GetObjectItem(params, "sample-interval");
+    JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_sampleInterval, "sample-interval", BVIEW_STATUS_INVALID_JSON);
+    JSON_VALIDATE_JSON_AS_NUMBER(json_sampleInterval, "sample-interval");
+    /* Copy the value */
+    command.sampleInterval = json_sampleInterval->valueint;
+    /* Ensure  that the number 'sample-interval' is within range of [10,1000] */
+    JSON_CHECK_VALUE_AND_CLEANUP (command.sampleInterval, 10, 1000);
+
+
+    /* Parsing and Validating 'resync-interval' from JSON buffer */
+    command.resyncInterval = BSTJSON_UDP_EXPORT_DEFAULT_RESYNC_INTERVAL;
+    json_resyncInterval = cJSON_GetObjectItem(params, "resync-interval");
+    if (NULL != json_resyncInterval)
+    {
+      JSON_VALIDATE_JSON_AS_NUMBER(json_resyncInterval, "resync-interval");
+      /* Copy the value */
+      command.resyncInterval = json_resyncInterval->valueint;
+      /* Ensure  that the number 'resync-interval' is within range of [1,65535] */
+      JSON_CHECK_VALUE_AND_CLEANUP (command.resyncInterval, 1, 65535);
+    }
+
+
+    /* Parsing and Validating 'mtu' from JSON buffer */
+    command.mtu = BSTJSON_UDP_EXPORT_DEFAULT_MTU;
+    json_mtu = cJSON_GetObjectItem(params, "mtu");
+    if (NULL != json_mtu)
+    {
+      JSON_VALIDATE_JSON_AS_NUMBER(json_mtu, "mtu");
+      /* Copy the value */
+      command.mtu = json_mtu->valueint;
+      /* Ensure  that the number 'mtu' is within range of [576,9000] */
+      JSON_CHECK_VALUE_AND_CLEANUP (command.mtu, 576, 9000);
+    }
+
+
+    /* Parsing and Validating 'realms' from JSON buffer */
+    json_realms = cJSON_GetObjectItem(params, "realms");
+    if (NULL == json_realms)
+    {
+        /* all of the realms */
+        for (realm = BVIEW_BST_REALM_ID_MIN; realm < BVIEW_BST_REALM_ID_MAX; realm++)
+        {
+            command.realmMask = (command.realmMask | (1 << realm));
+        }
+    }
+    else
+    {
+        if ((cJSON_Array != json_realms->type) || (0 == cJSON_GetArraySize(json_realms)))
+        {
+            _jsonlog("Error parsing JSON, realms not a list of realms ");
+            cJSON_Delete(root);
+            return BVIEW_STATUS_INVALID_JSON;
+        }
+        for (index = 0; index < cJSON_GetArraySize(json_realms); index++)
+        {
+            json_realm = cJSON_GetArrayItem(json_realms, index);
+            JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_realm, "realms", BVIEW_STATUS_INVALID_JSON);
+            JSON_VALIDATE_JSON_AS_STRING(json_realm, "realms", BVIEW_STATUS_INVALID_JSON);
+            /* Ensure that each of 'realms' is the name of a realm */
+            realm = bstjson_subscription_realm_get (json_realm->valuestring);
+            JSON_CHECK_VALUE_AND_CLEANUP (realm, BVIEW_BST_REALM_ID_MIN, BVIEW_BST_REALM_ID_MAX - 1);
+            command.realmMask = (command.realmMask | (1 << realm));
+        }
+    }
+
+    /* Send the 'command' along with 'asicId' and 'cookie' to the Application thread. */
+    status = bstjson_configure_bst_udp_export_impl (cookie, asicId, id, &command);
+
+    /* Free up any allocated resources and return status code */
+    if (root != NULL)
+    {
+        cJSON_Delete(root);
+    }
+
+    return status;
+}
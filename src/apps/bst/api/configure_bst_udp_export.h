@@ -0,0 +1,71 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_CONFIGURE_BST_UDP_EXPORT_H
+#define	INCLUDE_CONFIGURE_BST_UDP_EXPORT_H
+
+#ifdef	__cplusplus
+extern "C"
+{
+#endif
+
+
+/* Include Header files */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "broadview.h"
+#include "json.h"
+#include "bst.h"
+
+#include "cJSON.h"
+
+/* defaults of the optional parameters */
+#define BSTJSON_UDP_EXPORT_DEFAULT_RESYNC_INTERVAL  64
+#define BSTJSON_UDP_EXPORT_DEFAULT_MTU              1500
+
+/* Structure to pass API parameters to the BST APP */
+typedef struct _bstjson_configure_bst_udp_export_
+{
+    /* 0 stops the export */
+    int enable;
+    /* collector the datagrams go to */
+    char collectorIp[JSON_MAX_NODE_LENGTH];
+    int collectorPort;
+    /* milli seconds between the samples */
+    int sampleInterval;
+    /* datagrams of changes between the samples carrying every counter */
+    int resyncInterval;
+    /* largest IPv4 packet a datagram goes out in */
+    int mtu;
+    /* realms exported, bit n for BVIEW_BST_REALM_ID_t n */
+    int realmMask;
+} BSTJSON_CONFIGURE_BST_UDP_EXPORT_t;
+
+
+/* Function Prototypes */
+BVIEW_STATUS bstjson_configure_bst_udp_export(void *cookie, char *jsonBuffer, int bufLength);
+BVIEW_STATUS bstjson_configure_bst_udp_export_impl(void *cookie, int asicId, int id, BSTJSON_CONFIGURE_BST_UDP_EXPORT_t *pCommand);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif /* INCLUDE_CONFIGURE_BST_UDP_EXPORT_H */
@@ -0,0 +1,64 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_GET_BST_HISTORY_H 
+#define	INCLUDE_GET_BST_HISTORY_H  
+
+#ifdef	__cplusplus  
+extern "C"
+{
+#endif  
+
+
+/* Include Header files */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "broadview.h"
+#include "json.h"
+
+#include "cJSON.h"
+#include "get_bst_report.h"
+
+/* format of the 'start-time' and 'end-time' parameters, same as the report 'time-stamp' */
+#define BSTJSON_HISTORY_TIME_FORMAT   "%d-%d-%d - %d:%d:%d"
+
+/* Structure to pass API parameters to the BST APP */
+typedef struct _bstjson_get_bst_history_
+{
+    /* realms to be reported */
+    BSTJSON_GET_BST_REPORT_t realms;
+    /* time range to be reported, 0 for an open end */
+    time_t startTime;
+    time_t endTime;
+} BSTJSON_GET_BST_HISTORY_t;
+
+
+/* Function Prototypes */
+BVIEW_STATUS bstjson_get_bst_history(void *cookie, char *jsonBuffer, int bufLength);
+BVIEW_STATUS bstjson_get_bst_history_impl(void *cookie, int asicId, int id, BSTJSON_GET_BST_HISTORY_t *pCommand);
+
+
+#ifdef	__cplusplus  
+}
+#endif  
+
+#endif /* INCLUDE_GET_BST_HISTORY_H */ 
+
@@ -27,6 +27,68 @@
 #include "cJSON.h"
 #include "get_bst_report.h"
 
+/******************************************************************
+ * @brief  Parses a range of the report filter, "[first, last]"
+ *
+ * @param[in]    json_range  JSON array of the range
+ * @param[in]    name        name of the parameter, for the logs
+ * @param[in]    ports       the items are ports in the external notation
+ * @param[out]   first       first item of the range
+ * @param[out]   last        last item of the range
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  range parsed
+ * @retval   BVIEW_STATUS_INVALID_JSON  range is malformatted, or empty
+ *
+ * @note     The caller owns (and cleans up) the JSON root
+ *********************************************************************/
+static BVIEW_STATUS _jsonparse_report_range (cJSON *json_range, const char *name,
+                                             bool ports, int *first, int *last)
+{
+    cJSON *json_item;
+    int item[2];
+    int index;
+
+    if ((json_range->type != cJSON_Array) || (2 != cJSON_GetArraySize(json_range)))
+    {
+        _jsonlog("Error parsing JSON, %s not an array of two items ", name);
+        return BVIEW_STATUS_INVALID_JSON;
+    }
+
+    for (index = 0; index < 2; index++)
+    {
+        json_item = cJSON_GetArrayItem(json_range, index);
+        if (true == ports)
+        {
+            if ((json_item->type != cJSON_String) || (NULL == json_item->valuestring))
+            {
+                _jsonlog("Error parsing JSON, %s not a range of ports ", name);
+                return BVIEW_STATUS_INVALID_JSON;
+            }
+            JSON_PORT_MAP_FROM_NOTATION(item[index], json_item->valuestring);
+        }
+        else
+        {
+            if ((json_item->type != cJSON_Number) || (json_item->valueint < 0))
+            {
+                _jsonlog("Error parsing JSON, %s not a range of queues ", name);
+                return BVIEW_STATUS_INVALID_JSON;
+            }
+            item[index] = json_item->valueint;
+        }
+    }
+
+    /* Ensure that the range is not empty */
+    if (item[0] > item[1])
+    {
+        _jsonlog("The JSON %s is empty (first %d, last %d) ", name, item[0], item[1]);
+        return BVIEW_STATUS_INVALID_JSON;
+    }
+
+    *first = item[0];
+    *last = item[1];
+    return BVIEW_STATUS_SUCCESS;
+}
+
 /******************************************************************
  * @brief  REST API Handler (Generated Code)
  *
@@ -50,6 +112,9 @@ BVIEW_STATUS bstjson_get_bst_report (void *cookie, char *jsonBuffer, int bufLeng
     cJSON *json_includeIngressServicePool, *json_includeEgressPortServicePool, *json_includeEgressServicePool;
     cJSON *json_includeEgressUcQueue, *json_includeEgressUcQueueGroup, *json_includeEgressMcQueue;
     cJSON *json_includeEgressCpuQueue, *json_includeEgressRqeQueue, *json_includeDevice;
+    cJSON *json_format;
+    cJSON *json_minValue, *json_minPercentage, *json_topK;
+    cJSON *json_portRange, *json_queueRange;
     cJSON  *root, *params;
 
     /* Local non-command-parameter JSON variable declarations */
@@ -234,6 +299,85 @@ BVIEW_STATUS bstjson_get_bst_report (void *cookie, char *jsonBuffer, int bufLeng
     JSON_CHECK_VALUE_AND_CLEANUP (command.includeDevice, 0, 1);
 
 
+    /* Parsing and Validating 'format' from JSON buffer, it wins over the Accept header */
+    json_format = cJSON_GetObjectItem(params, "format");
+    if (NULL != json_format)
+    {
+      JSON_VALIDATE_JSON_AS_STRING(json_format, "format", BVIEW_STATUS_INVALID_JSON);
+      if (0 == strcmp(json_format->valuestring, BVIEW_REST_FORMAT_NAME_JSON))
+      {
+        command.format = BVIEW_REST_FORMAT_JSON;
+      }
+      else
+      {
+        /* Ensure that 'format' in the JSON is either "json" or "cbor" */
+        JSON_COMPARE_STRINGS_AND_CLEANUP ("format", json_format->valuestring, BVIEW_REST_FORMAT_NAME_CBOR);
+        command.format = BVIEW_REST_FORMAT_CBOR;
+      }
+    }
+
+
+    /* Parsing and Validating the optional filters from JSON buffer,
+       the report carries all the entries of the realms without them */
+    json_minValue = cJSON_GetObjectItem(params, "min-value");
+    if (NULL != json_minValue)
+    {
+      JSON_VALIDATE_JSON_AS_NUMBER(json_minValue, "min-value");
+      /* Ensure that the number 'min-value' is not negative */
+      if (json_minValue->valuedouble < 0)
+      {
+        _jsonlog("The JSON number out of range %f (min 0) ", json_minValue->valuedouble);
+        cJSON_Delete(root);
+        return BVIEW_STATUS_INVALID_JSON;
+      }
+      command.filter.minValue = (uint64_t) json_minValue->valuedouble;
+    }
+
+    json_minPercentage = cJSON_GetObjectItem(params, "min-percentage");
+    if (NULL != json_minPercentage)
+    {
+      JSON_VALIDATE_JSON_AS_NUMBER(json_minPercentage, "min-percentage");
+      command.filter.minPercentage = json_minPercentage->valueint;
+      /* Ensure  that the number 'min-percentage' is within range of [0,100] */
+      JSON_CHECK_VALUE_AND_CLEANUP (command.filter.minPercentage, 0, 100);
+    }
+
+    json_topK = cJSON_GetObjectItem(params, "top-k");
+    if (NULL != json_topK)
+    {
+      JSON_VALIDATE_JSON_AS_NUMBER(json_topK, "top-k");
+      command.filter.topK = json_topK->valueint;
+      /* Ensure  that the number 'top-k' is within range of [1,BVIEW_BST_REPORT_MAX_TOP_K] */
+      JSON_CHECK_VALUE_AND_CLEANUP (command.filter.topK, 1, BVIEW_BST_REPORT_MAX_TOP_K);
+    }
+
+    json_portRange = cJSON_GetObjectItem(params, "port-range");
+    if (NULL != json_portRange)
+    {
+      status = _jsonparse_report_range(json_portRange, "port-range", true,
+                                       &command.filter.firstPort, &command.filter.lastPort);
+      if (BVIEW_STATUS_SUCCESS != status)
+      {
+        cJSON_Delete(root);
+        return status;
+      }
+      command.filter.portRange = true;
+    }
+
+    json_queueRange = cJSON_GetObjectItem(params, "queue-range");
+    if (NULL != json_queueRange)
+    {
+      status = _jsonparse_report_range(json_queueRange, "queue-range", false,
+                                       &command.filter.firstQueue, &command.filter.lastQueue);
+      if (BVIEW_STATUS_SUCCESS != status)
+      {
+        cJSON_Delete(root);
+        return status;
+      }
+      command.filter.queueRange = true;
+    }
+
+
     /* Send the 'command' along with 'asicId' and 'cookie' to the Application thread. */
     status = bstjson_get_bst_report_impl (cookie, asicId, id,&command);
 
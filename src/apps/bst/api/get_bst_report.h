@@ -31,7 +31,9 @@ extern "C"
 #include <string.h>
 
 #include "broadview.h"
+#include "bst.h"
 #include "json.h"
+#include "rest_api.h"
 
 #include "cJSON.h"
 
@@ -49,6 +51,10 @@ typedef struct _bstjson_get_bst_report_
     int includeEgressCpuQueue;
     int includeEgressRqeQueue;
     int includeDevice;
+    /* format of the report, as the client accepts if it is not given */
+    BVIEW_REST_FORMAT_t format;
+    /* entries of the report, all of them if no filter is given */
+    BVIEW_BST_REPORT_FILTER_t filter;
 } BSTJSON_GET_BST_REPORT_t;
 
 
@@ -0,0 +1,56 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_STREAM_BST_REPORTS_H 
+#define	INCLUDE_STREAM_BST_REPORTS_H  
+
+#ifdef	__cplusplus  
+extern "C"
+{
+#endif  
+
+
+/* Include Header files */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "broadview.h"
+#include "json.h"
+#include "bst.h"
+
+#include "cJSON.h"
+
+/* Structure to pass API parameters to the BST APP */
+typedef struct _bstjson_stream_bst_reports_
+{
+    /* realms streamed, bit n for BVIEW_BST_REALM_ID_t n */
+    int realmMask;
+} BSTJSON_STREAM_BST_REPORTS_t;
+
+
+/* Function Prototypes */
+BVIEW_STATUS bstjson_stream_bst_reports(void *cookie, char *jsonBuffer, int bufLength);
+BVIEW_STATUS bstjson_stream_bst_reports_impl(void *cookie, int asicId, int id, BSTJSON_STREAM_BST_REPORTS_t *pCommand);
+
+
+#ifdef	__cplusplus  
+}
+#endif  
+
+#endif /* INCLUDE_STREAM_BST_REPORTS_H */
@@ -32,6 +32,11 @@
 #include "get_bst_feature.h"
 #include "get_bst_thresholds.h"
 #include "get_bst_report.h"
+#include "get_bst_history.h"
+#include "configure_bst_subscription.h"
+#include "stream_bst_reports.h"
+#include "configure_bst_udp_export.h"
+#include "get_bst_histogram.h"
 #include "bst_json_encoder.h"
 #include "bst.h"
 #include "broadview.h"
@@ -49,7 +54,12 @@ static BVIEW_REST_API_t bst_cmd_api_list[] = {
   {"configure-bst-tracking", bstjson_configure_bst_tracking},
   {"configure-bst-feature", bstjson_configure_bst_feature},
   {"configure-bst-thresholds", bstjson_configure_bst_thresholds},
+  {"configure-bst-subscription", bstjson_configure_bst_subscription},
+  {"stream-bst-reports", bstjson_stream_bst_reports},
+  {"configure-bst-udp-export", bstjson_configure_bst_udp_export},
   {"get-bst-report", bstjson_get_bst_report},
+  {"get-bst-history", bstjson_get_bst_history},
+  {"get-bst-histogram", bstjson_get_bst_histogram},
   {"get-bst-feature", bstjson_get_bst_feature},
   {"get-bst-tracking", bstjson_get_bst_tracking},
   {"get-bst-thresholds", bstjson_get_bst_thresholds},
@@ -80,6 +90,7 @@ BVIEW_STATUS bst_config_feature_set (BVIEW_BST_REQUEST_MSG_t * msg_data)
   BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
   BVIEW_BST_CONFIG_t bstMode;
   BVIEW_BST_CONFIG_PARAMS_t *ptr;
+  BVIEW_BST_UNIT_CXT_t *unitPtr;
   bool timerUpdateReqd = false;
   int tmpMask = 0;
   int interval = BVIEW_BST_DEFAULT_PLUGIN_INTERVAL;
@@ -182,6 +193,18 @@ BVIEW_STATUS bst_config_feature_set (BVIEW_BST_REQUEST_MSG_t * msg_data)
     ptr->statsInPercentage = msg_data->request.config.statsInPercentage;
   }
 
+  if (tmpMask & (1 << BST_CONFIG_PARAMS_ASYNC_REP_FORMAT))
+  {
+    /* Store the format the asynchronous reports are sent in */
+    ptr->asyncReportFormat = msg_data->request.config.asyncReportFormat;
+  }
+
+  if (tmpMask & (1 << BST_CONFIG_PARAMS_SND_WINDOW_REP))
+  {
+    /* Store whether the window reports follow the periodic ones */
+    ptr->sendWindowReport = msg_data->request.config.sendWindowReport;
+  }
+
   if ((0 == ptr->collectionInterval) || 
       (ptr->collectionInterval > BVIEW_BST_DEFAULT_PLUGIN_INTERVAL))
   {
@@ -231,6 +254,24 @@ BVIEW_STATUS bst_config_feature_set (BVIEW_BST_REQUEST_MSG_t * msg_data)
     BST_RWLOCK_UNLOCK(msg_data->unit);
     LOG_POST (BVIEW_LOG_INFO,
               "bst application: setting bst feature is successful for unit %d.\r\n", msg_data->unit);
+
+    /* the south bound does not tell when it maps the ports differently,
+       so the port notation is rendered again whenever bst is set up.
+       the reports are encoded in this thread too, so no lock is needed */
+    unitPtr = BST_UNIT_PTR_GET (msg_data->unit);
+    if ((NULL != unitPtr->notation) &&
+        (BVIEW_STATUS_SUCCESS != bstjson_notation_build (msg_data->unit,
+                                                         &unitPtr->asic_capabilities,
+                                                         unitPtr->notation)))
+    {
+      LOG_POST (BVIEW_LOG_ERROR,
+                "Failed to render the port notation of unit %d\r\n", msg_data->unit);
+    }
+
+    /* the kept responses are of the previous configuration */
+    BST_LOCK_TAKE (msg_data->unit);
+    bst_report_cache_invalidate (unitPtr->report_cache);
+    BST_LOCK_GIVE (msg_data->unit);
   }
   return rv;
 }
@@ -284,6 +325,7 @@ BVIEW_STATUS bst_config_track_set (BVIEW_BST_REQUEST_MSG_t * msg_data)
   BVIEW_BST_CONFIG_t bstMode;
   BVIEW_BST_TRACK_PARAMS_t *ptr;
   BVIEW_BST_CONFIG_PARAMS_t *config_ptr;
+  BVIEW_BST_UNIT_CXT_t *unitPtr;
   bool config_changed = false;
   bool trackIngress = true;
   bool trackEgress = true;
@@ -426,6 +468,12 @@ BVIEW_STATUS bst_config_track_set (BVIEW_BST_REQUEST_MSG_t * msg_data)
     LOG_POST (BVIEW_LOG_INFO,
               "bst application: setting bst tracking is successful"
                " for unit %d.\r\n", msg_data->unit);
+
+    /* the kept responses are of the previous configuration */
+    unitPtr = BST_UNIT_PTR_GET (msg_data->unit);
+    BST_LOCK_TAKE (msg_data->unit);
+    bst_report_cache_invalidate (unitPtr->report_cache);
+    BST_LOCK_GIVE (msg_data->unit);
   }
   return rv;
 }
@@ -481,6 +529,51 @@ BVIEW_STATUS system_switch_properties_get (BVIEW_BST_REQUEST_MSG_t * msg_data)
   return BVIEW_STATUS_SUCCESS;
 }
 
+/*********************************************************************
+* @brief : reads the max buffers of a unit again, for the reports in
+*          percent
+*
+* @param[in] unit : unit the max buffers are read for
+*
+* @retval  : BVIEW_STATUS_SUCCESS : max buffers are up to date
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+* @retval  : other : the south bound failed to provide them
+*
+* @note : the reciprocals the percentages are taken with follow the max
+*         buffers, and cached responses are dropped once they change.
+*
+*********************************************************************/
+BVIEW_STATUS bst_max_buffers_refresh (unsigned int unit)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr;
+  BVIEW_TIME_t  curr_time;
+  BVIEW_STATUS rv;
+
+  ptr = BST_UNIT_PTR_GET (unit);
+  if (NULL == ptr)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  rv = sbapi_system_max_buf_snapshot_get (unit, &ptr->bst_max_buffers,
+                                          &curr_time);
+  if (BVIEW_STATUS_SUCCESS != rv)
+    return rv;
+
+  if (NULL != ptr->max_buf_reciprocals)
+  {
+    bstjson_max_buf_reciprocals_update (&ptr->bst_max_buffers,
+                                        ptr->max_buf_reciprocals);
+  }
+
+  /* the percentages are of other max buffers now */
+  if ((NULL != ptr->report_cache) &&
+      (true == bst_report_cache_max_buffers_changed (ptr->report_cache,
+                                                     &ptr->bst_max_buffers)))
+  {
+    ptr->stats_generation++;
+  }
+  return BVIEW_STATUS_SUCCESS;
+}
+
 /*********************************************************************
 * @brief : application function to get the bst report and thresholds 
 *
@@ -500,7 +593,6 @@ BVIEW_STATUS bst_get_report (BVIEW_BST_REQUEST_MSG_t * msg_data)
   BVIEW_BST_UNIT_CXT_t *ptr;
   BVIEW_BST_TRACK_PARAMS_t *track_ptr;
   BVIEW_BST_CONFIG_PARAMS_t *config_ptr;
-  BVIEW_TIME_t  curr_time;   
  
   if (NULL == msg_data)
   {
@@ -536,11 +628,31 @@ BVIEW_STATUS bst_get_report (BVIEW_BST_REQUEST_MSG_t * msg_data)
        memory pointer directly so that we can avoid, copy */
     BST_LOCK_TAKE (msg_data->unit);
     ss = ptr->stats_current_record_ptr;
-    /* before we collect data..ensure there is no garbage.. 
-     */
-    memset (ss, 0,
-        sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
-    rv = sbapi_bst_snapshot_get (msg_data->unit, &ss->snapshot_data, &ss->tv);
+    /* references the snapshot published by the south bound when
+       available, so there is no per counter copy */
+    rv = bst_snapshot_collect (ss);
+    /* the stats collected last are in the active record, till
+       the records are rotated for this report */
+    if ((BVIEW_STATUS_SUCCESS != rv) ||
+        (false == bst_snapshot_same (ss, ptr->stats_active_record_ptr)))
+    {
+      ptr->stats_generation++;
+    }
+    if (BVIEW_STATUS_SUCCESS == rv)
+    {
+      /* every collection goes to the history as well */
+      bst_history_add (ptr->history, ss);
+      /* and the value at the end of the window counts to the window */
+      if (BVIEW_BST_STATS_PERIODIC == msg_data->report_type)
+      {
+        bst_window_sample (ptr->window, ss);
+      }
+    }
+    /* the periodic collection starts the next histogram interval */
+    if (BVIEW_BST_STATS_PERIODIC == msg_data->report_type)
+    {
+      sbapi_bst_histogram_get (msg_data->unit, NULL, NULL, true);
+    }
     BST_LOCK_GIVE (msg_data->unit);
 
     if (BVIEW_STATUS_SUCCESS != rv)
@@ -551,12 +663,13 @@ BVIEW_STATUS bst_get_report (BVIEW_BST_REQUEST_MSG_t * msg_data)
          report the error to the calling function */
     }
 
-	/* check if stats are requested in percentage format.
-	    if yes, then retrieve the default/max buffers allocated from ASIC */
-    if (true == config_ptr->statsInPercentage)
+	/* check if stats are requested in percentage format, or the entries
+	    of the report by their percentage. if yes, then retrieve the
+	    default/max buffers allocated from ASIC */
+    if ((true == config_ptr->statsInPercentage) ||
+        (0 != msg_data->request.collect.filter.minPercentage))
 	{
-       sbapi_system_max_buf_snapshot_get (msg_data->unit, &ptr->bst_max_buffers,
-                                          &curr_time);
+       bst_max_buffers_refresh (msg_data->unit);
 	}
 
     if (BVIEW_BST_CMD_API_TRIGGER_REPORT == msg_data->msg_type)
@@ -576,7 +689,7 @@ BVIEW_STATUS bst_get_report (BVIEW_BST_REQUEST_MSG_t * msg_data)
        so protect the same */
     BST_LOCK_TAKE (msg_data->unit);
     /* make sure no garbage.. */
-    memset (&ptr->threshold_record_ptr->snapshot_data, 0, sizeof(BVIEW_BST_ASIC_SNAPSHOT_DATA_t));
+    bst_snapshot_clear (ptr->threshold_record_ptr);
   
     rv = sbapi_bst_threshold_get (msg_data->unit, &ptr->threshold_record_ptr->snapshot_data, 
                                   &ptr->threshold_record_ptr->tv);
@@ -593,6 +706,148 @@ BVIEW_STATUS bst_get_report (BVIEW_BST_REQUEST_MSG_t * msg_data)
   return rv;
 }
 
+/*********************************************************************
+* @brief : application function to get the history of the bst stats
+*
+* @param[in] msg_data : pointer to the bst message request.
+*
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : Inpput paramerts are invalid. 
+* @retval  : BVIEW_STATUS_SUCCESS  : the history can be reported.
+*
+* @note : the entries of the requested time range are walked 
+*         while the response is encoded.
+*
+*********************************************************************/
+BVIEW_STATUS bst_get_history (BVIEW_BST_REQUEST_MSG_t * msg_data)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr;
+  BVIEW_BST_HISTORY_CONFIG_t *pHistory;
+
+  if (NULL == msg_data)
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  ptr = BST_UNIT_PTR_GET (msg_data->unit);
+  pHistory = &msg_data->request.history;
+
+  if ((NULL == ptr) || (NULL == ptr->history))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  /* an empty range can not be reported */
+  if ((0 != pHistory->startTime) && (0 != pHistory->endTime) &&
+      (pHistory->startTime > pHistory->endTime))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : application function to get the occupancy histograms
+*
+* @param[in] msg_data : pointer to the bst message request.
+*
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : Inpput paramerts are invalid. 
+* @retval  : BVIEW_STATUS_SUCCESS  : the histograms can be reported.
+* @retval  : other : the south bound failed to provide the histograms
+*
+* @note : the histograms cover the stats updates since the last
+*         periodic collection, the interval is not reset here.
+*
+*********************************************************************/
+BVIEW_STATUS bst_get_histogram (BVIEW_BST_REQUEST_MSG_t * msg_data)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr;
+  BVIEW_STATUS rv;
+  size_t words;
+
+  if (NULL == msg_data)
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  ptr = BST_UNIT_PTR_GET (msg_data->unit);
+
+  if (NULL == ptr)
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  /* the histograms are only needed once somebody asks for them */
+  if (NULL == ptr->histogram.data)
+  {
+    words = ptr->snapshot_layout.size / sizeof (uint64_t);
+    ptr->histogram.data = calloc (words, sizeof (BVIEW_BST_HISTOGRAM_t));
+    if (NULL == ptr->histogram.data)
+    {
+      return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+    }
+    ptr->histogram.layout = &ptr->snapshot_layout;
+  }
+
+  BST_LOCK_TAKE (msg_data->unit);
+  rv = sbapi_bst_histogram_get (msg_data->unit, &ptr->histogram,
+                                &ptr->histogram_start, false);
+  ptr->histogram_end = time (NULL);
+  BST_LOCK_GIVE (msg_data->unit);
+
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    LOG_POST (BVIEW_LOG_ERROR, "Failed to get bst histograms, err %d \r\n", rv);
+  }
+  return rv;
+}
+
+/*********************************************************************
+* @brief : application function to sample the bst stats
+*
+* @param[in] msg_data : pointer to the bst message request.
+*
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : Inpput paramerts are invalid. 
+* @retval  : BVIEW_STATUS_SUCCESS  : the sample is accounted in the window.
+*
+* @note : the sample is taken in the bst context, so it can not fall
+*         between the window report and the start of the next window.
+*
+*********************************************************************/
+BVIEW_STATUS bst_sample_collect (BVIEW_BST_REQUEST_MSG_t * msg_data)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr;
+  BVIEW_STATUS rv;
+
+  if (NULL == msg_data)
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  ptr = BST_UNIT_PTR_GET (msg_data->unit);
+
+  if ((NULL == ptr) || (NULL == ptr->sample_record_ptr) || (NULL == ptr->window))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  BST_LOCK_TAKE (msg_data->unit);
+  rv = bst_snapshot_collect (ptr->sample_record_ptr);
+  if (BVIEW_STATUS_SUCCESS == rv)
+  {
+    rv = bst_window_sample (ptr->window, ptr->sample_record_ptr);
+  }
+  /* the sample is accounted, don't hold on to the published data */
+  bst_snapshot_release (ptr->sample_record_ptr);
+  BST_LOCK_GIVE (msg_data->unit);
+
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    _BST_LOG(_BST_DEBUG_ERROR, "Failed to sample bst stats, err %d \r\n", rv);
+  }
+  return rv;
+}
+
 /*********************************************************************
 * @brief : function to add timer for the periodic stats collection 
 *
@@ -640,6 +895,12 @@ BVIEW_STATUS bst_periodic_collection_timer_add (unsigned int  unit)
     }
   }
 
+  /* the window starts with the timers, the samples taken before
+     the interval changed or the reports were turned off are gone */
+  BST_LOCK_TAKE (unit);
+  bst_window_reset (bst_info.unit[unit].window);
+  BST_LOCK_GIVE (unit);
+
   /* The timer add function expects the time in milli seconds..
      so convert the time into milli seconds. , before adding
      the timer node */
@@ -659,7 +920,29 @@ BVIEW_STATUS bst_periodic_collection_timer_add (unsigned int  unit)
       /* timer node add has failed. log the same */
       LOG_POST (BVIEW_LOG_ERROR, 
          "Failed to add periodic collection time for unit %d, err %d \r\n", unit, rv);
+      return rv;
     }
+
+  /* sample the stats in between the reports, so that the peaks
+     which come and go within an interval are reported too. There
+     is nothing to sample in between if the interval is shorter. */
+  if ((ptr->collectionInterval*BVIEW_BST_TIME_CONVERSION_FACTOR) >
+      BVIEW_BST_DEFAULT_SAMPLE_INTERVAL)
+  {
+    if (BVIEW_STATUS_SUCCESS ==  system_timer_add (bst_sample_cb,
+                  &bst_data_ptr->bst_sample_timer.bstTimer,
+                  BVIEW_BST_DEFAULT_SAMPLE_INTERVAL,
+                  PERIODIC_MODE, &bst_data_ptr->bst_sample_timer.unit))
+    {
+      bst_data_ptr->bst_sample_timer.in_use = true;
+    }
+    else
+    {
+      /* the reports go out without the window aggregates */
+      LOG_POST (BVIEW_LOG_ERROR, 
+         "Failed to add sample timer for unit %d\r\n", unit);
+    }
+  }
   return rv;
 }
 
@@ -673,7 +956,8 @@ BVIEW_STATUS bst_periodic_collection_timer_add (unsigned int  unit)
 * @retval  : BVIEW_STATUS_SUCCESS -- failed to delete the timer 
 *
 * @note  : The periodic timer is deleted when send asyncronous reporting
-*          is turned off. This timer is per unit.
+*          is turned off. This timer is per unit. The reporting window
+*          is started over.
 *
 *********************************************************************/
 BVIEW_STATUS bst_periodic_collection_timer_delete (int unit)
@@ -702,7 +986,25 @@ BVIEW_STATUS bst_periodic_collection_timer_delete (int unit)
            "Failed to delete periodic collection time for unit %d, err %d \r\n", unit, rv);
     }
   }
-  
+
+  if (true == bst_data_ptr->bst_sample_timer.in_use)
+  {
+    if (BVIEW_STATUS_SUCCESS == system_timer_delete (bst_data_ptr->bst_sample_timer.bstTimer))
+    {
+      bst_data_ptr->bst_sample_timer.in_use = false;
+    }
+    else
+    {
+      LOG_POST (BVIEW_LOG_ERROR, 
+           "Failed to delete sample timer for unit %d\r\n", unit);
+    }
+  }
+
+  /* no sample of this window is reported any more */
+  BST_LOCK_TAKE (unit);
+  bst_window_reset (bst_info.unit[unit].window);
+  BST_LOCK_GIVE (unit);
+
   return rv;
 }
 
@@ -869,8 +1171,7 @@ BVIEW_STATUS bst_clear_threshold_set (BVIEW_BST_REQUEST_MSG_t * msg_data)
   {
     BST_LOCK_TAKE (msg_data->unit);
     /* threshold clear is successful.. clear the record as well */
-    memset (ptr->threshold_record_ptr, 0, 
-        sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
+    bst_snapshot_clear (ptr->threshold_record_ptr);
     BST_LOCK_GIVE (msg_data->unit);
 
       LOG_POST (BVIEW_LOG_INFO, 
@@ -911,12 +1212,11 @@ BVIEW_STATUS bst_clear_stats_set (BVIEW_BST_REQUEST_MSG_t * msg_data)
   /* take the lock */
   BST_LOCK_TAKE (msg_data->unit);
   /* stats clear  */
-  memset (ptr->stats_backup_record_ptr, 0,
-      sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
-  memset (ptr->stats_active_record_ptr, 0,
-      sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
-  memset (ptr->stats_current_record_ptr, 0,
-      sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
+  bst_snapshot_clear (ptr->stats_backup_record_ptr);
+  bst_snapshot_clear (ptr->stats_active_record_ptr);
+  bst_snapshot_clear (ptr->stats_current_record_ptr);
+  /* the kept responses are of the stats before the clear */
+  bst_report_cache_invalidate (ptr->report_cache);
   /* release the lock */
   BST_LOCK_GIVE (msg_data->unit);
 
@@ -965,6 +1265,10 @@ BVIEW_STATUS bst_update_data (BVIEW_BST_REPORT_TYPE_t type, unsigned int unit)
     ptr->stats_active_record_ptr = ptr->stats_current_record_ptr;
     /* now make the old backup as current */
     ptr->stats_current_record_ptr = temp;
+    /* local consumers see the new active record as well, when the
+       agent config asks for the region */
+    bst_shm_config_apply (unit);
+    bst_shm_publish (ptr->shm, ptr->stats_active_record_ptr);
     /* release the lock */
     BST_LOCK_GIVE (unit);
     break;
@@ -1028,6 +1332,7 @@ BVIEW_STATUS bst_update_config_set(BVIEW_BST_REQUEST_MSG_t * msg_data)
   BVIEW_BST_TRACK_PARAMS_t *track_ptr;
   BVIEW_BST_CONFIG_PARAMS_t *ptr;
   BVIEW_BST_CONFIG_t bstMode;
+  BVIEW_BST_UNIT_CXT_t *unitPtr;
   BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
 
   if (NULL == msg_data)
@@ -1097,6 +1402,12 @@ BVIEW_STATUS bst_update_config_set(BVIEW_BST_REQUEST_MSG_t * msg_data)
     BST_RWLOCK_UNLOCK(msg_data->unit);
   }
 
+  /* the kept responses are of the previous configuration */
+  unitPtr = BST_UNIT_PTR_GET (msg_data->unit);
+  BST_LOCK_TAKE (msg_data->unit);
+  bst_report_cache_invalidate (unitPtr->report_cache);
+  BST_LOCK_GIVE (msg_data->unit);
+
   return BVIEW_STATUS_SUCCESS;
 }
 
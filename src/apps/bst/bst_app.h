@@ -26,7 +26,14 @@ extern "C" {
 #include <stdbool.h>
 #include <time.h>
 #include <signal.h>
+#include <netinet/in.h>
 #include "modulemgr.h"
+#include "bst_shm.h"
+#include "bst_udp.h"
+#include "rest_api.h"
+#include "configure_bst_subscription.h"
+#include "stream_bst_reports.h"
+#include "configure_bst_udp_export.h"
 
 
 #define MSG_QUEUE_ID_TO_BST  0x100
@@ -84,16 +91,69 @@ extern "C" {
 #define BVIEW_BST_DEFAULT_TRIGGER_INTERVAL 1 
 #define BVIEW_BST_DEFAULT_SEND_INCR_REPORT  1 
 #define BVIEW_BST_MAX_UNITS 8
+/* interval, in milli seconds, the stats are sampled at while
+   periodic reports are sent */
+#define BVIEW_BST_DEFAULT_SAMPLE_INTERVAL 100
+/* number of stats collections kept in the history of a unit */
+#define BVIEW_BST_HISTORY_DEPTH 64
+/* number of changed counters the history of a unit can hold */
+#define BVIEW_BST_HISTORY_MAX_CHANGES (64 * 1024)
 #define BVIEW_BST_TIME_CONVERSION_FACTOR 1000
+/* send the reports in chunks while they are encoded, instead of
+   encoding them whole first */
+#define BVIEW_BST_DEFAULT_STREAM_REPORTS true
+/* kind of the complete periodic reports of a unit, a newer one takes
+   the place of the one still queued for the collector. The incremental
+   and trigger reports are never replaced. */
+#define BVIEW_BST_REPORT_KIND(_unit)  (0x100 + (unsigned int) (_unit))
+
+/* answer repeated polls of unchanged stats with the response
+   encoded for the first one */
+#define BVIEW_BST_DEFAULT_REPORT_CACHE true
+/* number of encoded get-bst-report responses kept per unit */
+#define BVIEW_BST_REPORT_CACHE_ENTRIES 4
+/* largest response kept, in bytes */
+#define BVIEW_BST_REPORT_CACHE_MAX_SIZE (4 * 1024 * 1024)
+
+/* workers encoding the realms of large reports besides the bst thread,
+   at most one less than the cores online. 0 encodes them on the bst
+   thread alone */
+#define BVIEW_BST_DEFAULT_ENCODE_WORKERS 3
+
+/* format the asynchronous reports are sent in */
+#define BVIEW_BST_DEFAULT_ASYNC_REPORT_FORMAT BVIEW_REST_FORMAT_JSON
+
+/* the aggregates of the sampling window are not sent unless asked for */
+#define BVIEW_BST_DEFAULT_SEND_WINDOW_REPORT false
 
 /* Maximum number of failed Receive messages */
 #define BVIEW_BST_MAX_QUEUE_SEND_FAILS      10
 
+/* subscriptions to the periodic reports, one per REST subscriber */
+#define BVIEW_BST_MAX_SUBSCRIPTIONS BVIEW_REST_MAX_SUBSCRIBERS
+/* milli seconds between the checks for due subscriptions */
+#define BVIEW_BST_SUBSCRIPTION_TICK 1000
+
+/* filter of an event stream, the unit and the realms its client
+   asked for */
+#define BVIEW_BST_EVENT_FILTER(_unit, _realmMask)                           \
+            ((((unsigned int) (_unit)) << 16) | (((unsigned int) (_realmMask)) & 0xFFFF))
+#define BVIEW_BST_EVENT_FILTER_UNIT(_filter)     ((int) ((_filter) >> 16))
+#define BVIEW_BST_EVENT_FILTER_REALMS(_filter)   ((int) ((_filter) & 0xFFFF))
+
+/* names of the events the reports are streamed as */
+#define BVIEW_BST_EVENT_PERIODIC    "periodic"
+#define BVIEW_BST_EVENT_TRIGGER     "trigger"
+
 typedef BSTJSON_CONFIGURE_BST_TRACKING_t  BVIEW_BST_TRACK_PARAMS_t;
 typedef BSTJSON_CONFIGURE_BST_FEATURE_t   BVIEW_BST_CONFIG_PARAMS_t;
 typedef BSTJSON_REPORT_OPTIONS_t          BVIEW_BST_REPORT_OPTIONS_t;
 typedef BSTJSON_GET_BST_REPORT_t          BVIEW_BST_STAT_COLLECT_CONFIG_t;
 typedef BSTJSON_CONFIGURE_BST_THRESHOLDS_t BVIEW_BST_THRESHOLD_CONFIG_t;
+typedef BSTJSON_GET_BST_HISTORY_t         BVIEW_BST_HISTORY_CONFIG_t;
+typedef BSTJSON_CONFIGURE_BST_SUBSCRIPTION_t BVIEW_BST_SUBSCRIPTION_CONFIG_t;
+typedef BSTJSON_STREAM_BST_REPORTS_t      BVIEW_BST_EVENT_STREAM_CONFIG_t;
+typedef BSTJSON_CONFIGURE_BST_UDP_EXPORT_t BVIEW_BST_UDP_EXPORT_CONFIG_t;
 
 
 typedef enum _bst_report_type_ {
@@ -163,6 +223,8 @@ typedef enum _bst_cmd_ {
   BVIEW_BST_CMD_API_SET_THRESHOLD,
   BVIEW_BST_CMD_API_CLEAR_THRESHOLD,
   BVIEW_BST_CMD_API_CLEAR_STATS,
+  BVIEW_BST_CMD_API_SET_SUBSCRIPTION,
+  BVIEW_BST_CMD_API_SET_UDP_EXPORT,
   /* get group */
   BVIEW_BST_CMD_API_GET_REPORT,
   BVIEW_BST_CMD_API_GET_FEATURE,
@@ -172,6 +234,12 @@ typedef enum _bst_cmd_ {
   BVIEW_BST_CMD_API_CLEAR_TRIGGER_COUNT,
   BVIEW_BST_CMD_API_ENABLE_BST_ON_TRIGGER,
   BVIEW_BST_CMD_API_TRIGGER_COLLECT,
+  BVIEW_BST_CMD_API_GET_HISTORY,
+  BVIEW_BST_CMD_API_SAMPLE_COLLECT,
+  BVIEW_BST_CMD_API_GET_HISTOGRAM,
+  BVIEW_BST_CMD_API_SUBSCRIPTION_COLLECT,
+  BVIEW_BST_CMD_API_STREAM_REPORTS,
+  BVIEW_BST_CMD_API_UDP_EXPORT_COLLECT,
 
  /* update config group */
   BVIEW_BST_CMD_API_UPDATE_TRACK,
@@ -190,9 +258,175 @@ typedef enum _bst_cmd_ {
 
   typedef struct _bst_report_snapshot_data_ {
     BVIEW_TIME_t tv;
+    /* southbound cache generation the data is at, 0 if none */
+    uint64_t generation;
     BVIEW_BST_ASIC_SNAPSHOT_DATA_t snapshot_data;
+    int unit;
+    /* data owned by the record */
+    uint8_t *buffer;
+    /* southbound published snapshot the data points into while
+       referenced, NULL when the record uses its own buffer */
+    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *published;
   }BVIEW_BST_REPORT_SNAPSHOT_t;
 
+  /* peak, minimum and running sum of every counter over a reporting
+     window. The arrays are laid out like the snapshot data, one
+     accumulator per 64 bit word. */
+  typedef struct _bst_window_ {
+    const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout;
+    uint64_t *peak;
+    uint64_t *min;
+    uint64_t *sum;
+    /* number of samples taken in the window */
+    unsigned int samples;
+    /* time of the first sample */
+    BVIEW_TIME_t start;
+  }BVIEW_BST_WINDOW_t;
+
+  /* one stats collection in the history */
+  typedef struct _bst_history_entry_ {
+    BVIEW_TIME_t tv;
+    /* position of the first change of the entry in the change ring */
+    unsigned int first;
+    /* number of counters changed since the previous entry */
+    unsigned int count;
+  }BVIEW_BST_HISTORY_ENTRY_t;
+
+  /* history of the stats of a unit. Only the oldest entry is kept in
+     full, every later entry holds the 64 bit words which changed since
+     the entry before it. */
+  typedef struct _bst_history_ {
+    const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout;
+    /* data of the oldest entry */
+    uint64_t *base;
+    /* data of the newest entry, to find the changes of the next one */
+    uint64_t *last;
+    /* entries, oldest first */
+    BVIEW_BST_HISTORY_ENTRY_t entry[BVIEW_BST_HISTORY_DEPTH];
+    unsigned int head;
+    unsigned int count;
+    /* changes of all entries, word index and new value */
+    uint32_t *changeIndex;
+    uint64_t *changeValue;
+    unsigned int changeHead;
+    unsigned int changeCount;
+    /* data the entries are rebuilt into while being reported */
+    BVIEW_BST_ASIC_SNAPSHOT_DATA_t replay[2];
+  }BVIEW_BST_HISTORY_t;
+
+  /* position of a reader walking through the history */
+  typedef struct _bst_history_cursor_ {
+    BVIEW_BST_HISTORY_t *history;
+    BVIEW_TIME_t start;
+    BVIEW_TIME_t end;
+    /* next entry, relative to the oldest one */
+    unsigned int next;
+    /* whether an entry has been handed out already */
+    bool reported;
+  }BVIEW_BST_HISTORY_CURSOR_t;
+
+  /* shared memory region the latest stats of a unit are published in */
+  typedef struct _bst_shm_ {
+    char name[BVIEW_BST_SHM_NAME_MAX];
+    BVIEW_BST_SHM_HEADER_t *header;
+    /* size of the mapping */
+    size_t size;
+  }BVIEW_BST_SHM_t;
+
+  /* an encoded get-bst-report response, and what it was encoded for */
+  typedef struct _bst_report_cache_entry_ {
+    bool valid;
+    uint64_t generation;
+    BVIEW_BST_REPORT_OPTIONS_t options;
+    BVIEW_REST_FORMAT_t format;
+    uint8_t *data;
+    /* bytes of the response, -1 if it is not stored */
+    int length;
+    int size;
+    /* use of the cache the entry was last used for */
+    uint64_t lastUsed;
+  }BVIEW_BST_REPORT_CACHE_ENTRY_t;
+
+  /* responses to the polls of the current stats of a unit */
+  typedef struct _bst_report_cache_ {
+    BVIEW_BST_REPORT_CACHE_ENTRY_t entry[BVIEW_BST_REPORT_CACHE_ENTRIES];
+    /* max buffers the percentages of the responses are computed with */
+    BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t maxBuffers;
+    /* entries stored or hit so far */
+    uint64_t uses;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t invalidations;
+  }BVIEW_BST_REPORT_CACHE_t;
+
+  /* counters of a report cache */
+  typedef struct _bst_report_cache_stats_ {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t invalidations;
+    /* responses held, and their bytes */
+    unsigned int entries;
+    unsigned int bytes;
+  }BVIEW_BST_REPORT_CACHE_STATS_t;
+
+  /* a subscription to the periodic reports */
+  typedef struct _bst_subscription_ {
+    BVIEW_BST_SUBSCRIPTION_CONFIG_t config;
+    /* unit the subscription reports */
+    int unit;
+    /* time the next report is due */
+    time_t nextDue;
+    /* baseline the next incremental report is against, -1 if none */
+    int baseline;
+  }BVIEW_BST_SUBSCRIPTION_t;
+
+  /* stats a report was sent with, kept while subscriptions report
+     against them */
+  typedef struct _bst_subscription_baseline_ {
+    BVIEW_BST_REPORT_SNAPSHOT_t *record;
+    /* subscriptions referring to it */
+    unsigned int refs;
+  }BVIEW_BST_SUBSCRIPTION_BASELINE_t;
+
+  /* counters of the datagram export of a unit */
+  typedef struct _bst_udp_export_stats_ {
+    uint64_t samples;
+    uint64_t datagrams;
+    uint64_t records;
+    uint64_t bytes;
+    /* samples sent with every counter */
+    uint64_t resyncs;
+    /* datagrams the socket did not take */
+    uint64_t drops;
+  }BVIEW_BST_UDP_EXPORT_STATS_t;
+
+  /* export of the samples of a unit in datagrams, see bst_udp.h */
+  typedef struct _bst_udp_export_ {
+    BVIEW_BST_UDP_EXPORT_CONFIG_t config;
+    /* socket the datagrams go out on, -1 while stopped */
+    int fd;
+    struct sockaddr_in collector;
+    /* record the samples are collected into, and the last one sent */
+    BVIEW_BST_REPORT_SNAPSHOT_t *record;
+    BVIEW_BST_REPORT_SNAPSHOT_t *baseline;
+    /* datagram being filled, mtu less the IPv4 and UDP headers */
+    uint8_t *datagram;
+    uint32_t sequence;
+    uint32_t snapshot;
+    /* datagrams sent since every counter was */
+    unsigned int sinceResync;
+    /* the baseline holds the last sample, changes go against it */
+    bool baselineValid;
+    BVIEW_BST_UDP_EXPORT_STATS_t stats;
+  }BVIEW_BST_UDP_EXPORT_t;
+
+  /* a report sent while it is encoded, and the cache entry it is
+     kept in, NULL if it is not kept */
+  typedef struct _bst_report_stream_ {
+    BVIEW_REST_STREAM_t stream;
+    BVIEW_BST_REPORT_CACHE_ENTRY_t *cache;
+  }BVIEW_BST_REPORT_STREAM_t;
+
   typedef struct _bst_report_respose_ {
     BVIEW_BST_REPORT_SNAPSHOT_t *active;
     BVIEW_BST_REPORT_SNAPSHOT_t *backup;
@@ -218,6 +452,14 @@ typedef enum _bst_cmd_ {
       BVIEW_BST_TRACK_PARAMS_t  track;
       /* params requsted to collect in report */
       BVIEW_BST_STAT_COLLECT_CONFIG_t   collect;
+      /* params requested to report from the history */
+      BVIEW_BST_HISTORY_CONFIG_t        history;
+      /* subscription to the periodic reports */
+      BVIEW_BST_SUBSCRIPTION_CONFIG_t   subscription;
+      /* realms of the reports streamed to the client */
+      BVIEW_BST_EVENT_STREAM_CONFIG_t   stream;
+      /* export of the samples in datagrams */
+      BVIEW_BST_UDP_EXPORT_CONFIG_t     udpExport;
       /* params to config threshold */
       BVIEW_BST_DEVICE_THRESHOLD_t                       device_threshold;
       BVIEW_BST_INGRESS_PORT_PG_THRESHOLD_t              i_p_pg_threshold;
@@ -245,11 +487,14 @@ typedef enum _bst_cmd_ {
     BVIEW_ASIC_CAPABILITIES_t  *asic_capabilities;
     BVIEW_BST_REPORT_OPTIONS_t options;
     BVIEW_STATUS rv; /* return value for set request */
+    BVIEW_REST_FORMAT_t format; /* encoding of a report */
     union
     {
       BVIEW_BST_CONFIG_PARAMS_t *config;
       BVIEW_BST_TRACK_PARAMS_t  *track;
       BVIEW_BST_REPORT_RESP_t   report;
+      BVIEW_BST_HISTORY_CURSOR_t history;
+      BVIEW_BST_ASIC_HISTOGRAM_DATA_t *histogram;
     }response;
   }BVIEW_BST_RESPONSE_MSG_t;
 
@@ -262,6 +507,9 @@ typedef enum _bst_cmd_ {
   typedef struct _bst_data_ {
     BVIEW_BST_TIMER_t bst_collection_timer;
     BVIEW_BST_TIMER_t bst_trigger_timer;
+    BVIEW_BST_TIMER_t bst_sample_timer;
+    BVIEW_BST_TIMER_t bst_subscription_timer;
+    BVIEW_BST_TIMER_t bst_udp_export_timer;
     BVIEW_BST_CFG_PARAMS_t bst_config;
     BVIEW_BST_STAT_COLLECT_CONFIG_t  bst_stats_config;
   } BVIEW_BST_DATA_t;
@@ -278,6 +526,8 @@ typedef struct _bst_context_unit_info__
 
   /* place holder to store the bst max buffer settings */
   BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t bst_max_buffers;
+  /* their reciprocals, for the reports in percent, NULL to divide */
+  BSTJSON_MAX_BUF_RECIPROCALS_t *max_buf_reciprocals;
 
   /* config data */
   BVIEW_BST_DATA_t *bst_data;
@@ -291,6 +541,44 @@ typedef struct _bst_context_unit_info__
   /* asic capabilities */
   BVIEW_ASIC_CAPABILITIES_t asic_capabilities;
 
+  /* layout of the stats/threshold records, sized from asic capabilities */
+  BVIEW_BST_SNAPSHOT_LAYOUT_t snapshot_layout;
+
+  /* history of the collected stats */
+  BVIEW_BST_HISTORY_t *history;
+
+  /* record the samples are taken into and the window they feed */
+  BVIEW_BST_REPORT_SNAPSHOT_t *sample_record_ptr;
+  BVIEW_BST_WINDOW_t *window;
+
+  /* occupancy histograms of the counters, read from the south bound
+     on request, and the time range they cover */
+  BVIEW_BST_ASIC_HISTOGRAM_DATA_t histogram;
+  BVIEW_TIME_t histogram_start;
+  BVIEW_TIME_t histogram_end;
+
+  /* region the active stats record is published in, NULL if none,
+     and whether the agent config asked for it when last checked */
+  BVIEW_BST_SHM_t *shm;
+  bool shm_publish;
+
+  /* external notation of the asic and its ports, for the encoders */
+  BSTJSON_NOTATION_t *notation;
+
+  /* generation of the collected stats, advanced whenever they may
+     differ from the ones collected before */
+  uint64_t stats_generation;
+  /* responses to get-bst-report, NULL if they are not kept */
+  BVIEW_BST_REPORT_CACHE_t *report_cache;
+
+  /* record the subscriptions collect into, and the stats their
+     incremental reports are against */
+  BVIEW_BST_REPORT_SNAPSHOT_t *subscription_record_ptr;
+  BVIEW_BST_SUBSCRIPTION_BASELINE_t subscription_baseline[BVIEW_BST_MAX_SUBSCRIPTIONS];
+
+  /* export of the samples in datagrams */
+  BVIEW_BST_UDP_EXPORT_t udp_export;
+
   /* trigger callback cookie */
   int cb_cookie;
   unsigned int bst_trigger_count[BST_ID_MAX];
@@ -301,6 +589,8 @@ typedef struct _bst_context_unit_info__
 typedef struct _bst_context_info__
 {
   BVIEW_BST_UNIT_CXT_t unit[BVIEW_BST_MAX_UNITS];
+  /* subscriptions to the periodic reports */
+  BVIEW_BST_SUBSCRIPTION_t subscription[BVIEW_BST_MAX_SUBSCRIPTIONS];
   /* BST Key to Queue Message*/
   key_t key1;
   key_t trigger_key;
@@ -659,6 +949,64 @@ BVIEW_STATUS system_switch_properties_get (BVIEW_BST_REQUEST_MSG_t * msg_data);
 *********************************************************************/
 BVIEW_STATUS bst_get_report(BVIEW_BST_REQUEST_MSG_t *msg_data);
 
+/*********************************************************************
+* @brief : application function to get the history of the bst stats
+*
+* @param[in] msg_data : pointer to the bst message request.
+*
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : Inpput paramerts are invalid. 
+* @retval  : BVIEW_STATUS_SUCCESS  : the history can be reported.
+*
+* @note : the entries of the requested time range are walked 
+*         while the response is encoded.
+*
+*********************************************************************/
+BVIEW_STATUS bst_get_history(BVIEW_BST_REQUEST_MSG_t *msg_data);
+
+/*********************************************************************
+* @brief : application function to get the occupancy histograms
+*
+* @param[in] msg_data : pointer to the bst message request.
+*
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : Inpput paramerts are invalid. 
+* @retval  : BVIEW_STATUS_RESOURCE_NOT_AVAILABLE : out of memory
+* @retval  : BVIEW_STATUS_SUCCESS  : the histograms can be reported.
+* @retval  : other : the south bound failed to provide the histograms
+*
+* @note : the histograms cover the stats updates since the last
+*         periodic collection.
+*
+*********************************************************************/
+BVIEW_STATUS bst_get_histogram(BVIEW_BST_REQUEST_MSG_t *msg_data);
+
+/*********************************************************************
+* @brief : application function to sample the bst stats
+*
+* @param[in] msg_data : pointer to the bst message request.
+*
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : Inpput paramerts are invalid. 
+* @retval  : BVIEW_STATUS_SUCCESS  : the sample is accounted in the window.
+* @retval  : other : failure returned by the south bound
+*
+* @note : no response is sent for a sample.
+*
+*********************************************************************/
+BVIEW_STATUS bst_sample_collect(BVIEW_BST_REQUEST_MSG_t *msg_data);
+
+/*********************************************************************
+* @brief : function to send the aggregates of the reporting window
+*
+* @param[in] reply_data : the periodic report just sent
+*
+* @retval  : BVIEW_STATUS_SUCCESS : window report sent, or nothing to send
+* @retval  : other : encoding or sending the report failed
+*
+* @note : the window is closed and a new one is started in the 
+*         bst context, so that no sample can fall between the two.
+*
+*********************************************************************/
+BVIEW_STATUS bst_send_window_report(BVIEW_BST_RESPONSE_MSG_t *reply_data);
+
 /*********************************************************************
 * @brief : function to add timer for the periodic stats collection 
 *
@@ -712,6 +1060,40 @@ BVIEW_STATUS bst_periodic_collection_timer_delete (int unit);
 *********************************************************************/
 BVIEW_STATUS bst_send_response (BVIEW_BST_RESPONSE_MSG_t * reply_data);
 
+/*********************************************************************
+* @brief : function to encode a report and send it in chunks, as the
+*          encoder fills its window
+*
+* @param[in] reply_data : pointer to the response message
+* @param[in] previous : stats of the last report, NULL for a snapshot
+* @param[in] cache : report cache entry the report is kept in, NULL
+*                    if it is not kept
+*
+* @retval  : BVIEW_STATUS_SUCCESS : report is sent
+* @retval  : other : encoding or sending the report failed
+*
+* @note   : the requester, or the collector for a periodic or trigger
+*           report, gets the json error instead when nothing is sent
+*           yet.
+*
+*********************************************************************/
+BVIEW_STATUS bst_send_report_stream (BVIEW_BST_RESPONSE_MSG_t * reply_data,
+                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                     BVIEW_BST_REPORT_CACHE_ENTRY_t *cache);
+
+/*********************************************************************
+* @brief : function to send a window of a report being encoded
+*
+* @param[in] cookie : report stream the report goes out on
+* @param[in] data : encoded part of the report
+* @param[in] length : number of bytes in data
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the window is sent
+* @retval  : other : sending failed, the encoding stops
+*
+*********************************************************************/
+BVIEW_STATUS bst_report_stream_flush (void *cookie, const char *data, int length);
+
 /*********************************************************************
 * @brief : function to prepare the response to the request message  
 *
@@ -789,6 +1171,20 @@ BVIEW_STATUS bst_send_request(BVIEW_BST_REQUEST_MSG_t *msg_data);
 *********************************************************************/
 BVIEW_STATUS bst_periodic_collection_cb (union sigval sigval);
 
+/*********************************************************************
+*  @brief:  callback function to sample the stats between periodic reports
+*
+* @param[in]   sigval : Data passed with notification after timer expires
+*
+* @retval  : BVIEW_STATUS_SUCCESS : message is successfully posted to bst.
+* @retval  : BVIEW_STATUS_FAILURE : failed to post message to bst.
+*
+* @note : invoked in the timer context, every 
+*         BVIEW_BST_DEFAULT_SAMPLE_INTERVAL milli seconds.
+*
+*********************************************************************/
+BVIEW_STATUS bst_sample_cb (union sigval sigval);
+
 /*********************************************************************
 * @brief : set the threshold for the given realm.
 *
@@ -848,6 +1244,471 @@ BVIEW_STATUS bst_clear_stats_set (BVIEW_BST_REQUEST_MSG_t * msg_data);
 *********************************************************************/
 BVIEW_STATUS bst_update_data(BVIEW_BST_REPORT_TYPE_t type,unsigned int unit);
 
+/*********************************************************************
+* @brief : reads the max buffers of a unit again, for the reports in
+*          percent
+*
+* @param[in] unit : unit the max buffers are read for
+*
+* @retval  : BVIEW_STATUS_SUCCESS : max buffers are up to date
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+* @retval  : other : the south bound failed to provide them
+*
+* @note : the reciprocals the percentages are taken with follow the max
+*         buffers, and cached responses are dropped once they change.
+*
+*********************************************************************/
+BVIEW_STATUS bst_max_buffers_refresh (unsigned int unit);
+
+/*********************************************************************
+* @brief : computes the snapshot layout of a unit from its capabilities
+*
+* @param[in]  asic : asic capabilities of the unit
+* @param[out] layout : layout of the snapshot records of the unit
+*
+* @retval  : BVIEW_STATUS_SUCCESS : layout computed
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+* @note : every realm gets exactly as many entries as the asic reports,
+*         clamped to the BVIEW_ASIC_MAX_* limits, and starts on a
+*         cache line boundary.
+*
+*********************************************************************/
+BVIEW_STATUS bst_snapshot_layout_init (const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                       BVIEW_BST_SNAPSHOT_LAYOUT_t *layout);
+
+/*********************************************************************
+* @brief : allocates a stats/threshold record for the given layout
+*
+* @param[in]  unit   : unit the record collects data of
+* @param[in]  layout : layout of the snapshot
+* @param[out] record : newly allocated, zeroed record
+*
+* @retval  : BVIEW_STATUS_SUCCESS : record allocated
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+* @retval  : BVIEW_STATUS_RESOURCE_NOT_AVAILABLE : out of memory
+*
+* @note : the snapshot data is a single cache line aligned block of
+*         layout->size bytes. Release with bst_snapshot_free.
+*
+*********************************************************************/
+BVIEW_STATUS bst_snapshot_alloc (int unit, const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout,
+                                 BVIEW_BST_REPORT_SNAPSHOT_t **record);
+
+/*********************************************************************
+* @brief : frees a record allocated with bst_snapshot_alloc
+*
+* @param[in] record : record to be freed, may be NULL
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_snapshot_free (BVIEW_BST_REPORT_SNAPSHOT_t *record);
+
+/*********************************************************************
+* @brief : drops the published snapshot a record refers to
+*
+* @param[in] record : record, may be NULL
+*
+* @retval  : none
+*
+* @note : the record falls back to its own buffer.
+*
+*********************************************************************/
+void bst_snapshot_release (BVIEW_BST_REPORT_SNAPSHOT_t *record);
+
+/*********************************************************************
+* @brief : clears the time stamp and the data of a record
+*
+* @param[in] record : record to be cleared
+*
+* @retval  : none
+*
+* @note : only the layout->size bytes in use are touched.
+*
+*********************************************************************/
+void bst_snapshot_clear (BVIEW_BST_REPORT_SNAPSHOT_t *record);
+
+/*********************************************************************
+* @brief : collects the current stats of the unit into a record
+*
+* @param[in] record : stats record to be filled
+*
+* @retval  : BVIEW_STATUS_SUCCESS : record holds the current stats
+* @retval  : other : failure returned by the south bound
+*
+* @note : when the south bound publishes snapshots, the record just
+*         references the latest one and nothing is copied. Otherwise
+*         the record's own buffer is refreshed with the counters which
+*         changed since its last collection.
+*
+*********************************************************************/
+BVIEW_STATUS bst_snapshot_collect (BVIEW_BST_REPORT_SNAPSHOT_t *record);
+
+/*********************************************************************
+* @brief : allocates the aggregation window of a unit
+*
+* @param[in]  layout : layout of the snapshots of the unit
+* @param[out] window : newly allocated, empty window
+*
+* @retval  : BVIEW_STATUS_SUCCESS : window allocated
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+* @retval  : BVIEW_STATUS_RESOURCE_NOT_AVAILABLE : out of memory
+*
+* @note : Release with bst_window_free.
+*
+*********************************************************************/
+BVIEW_STATUS bst_window_alloc (const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout,
+                               BVIEW_BST_WINDOW_t **window);
+
+/*********************************************************************
+* @brief : frees a window allocated with bst_window_alloc
+*
+* @param[in] window : window to be freed, may be NULL
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_window_free (BVIEW_BST_WINDOW_t *window);
+
+/*********************************************************************
+* @brief : accounts a stats sample in the window
+*
+* @param[in] window : window of the unit
+* @param[in] record : stats record just sampled
+*
+* @retval  : BVIEW_STATUS_SUCCESS : sample accounted
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+*********************************************************************/
+BVIEW_STATUS bst_window_sample (BVIEW_BST_WINDOW_t *window,
+                                const BVIEW_BST_REPORT_SNAPSHOT_t *record);
+
+/*********************************************************************
+* @brief : closes the window and provides its aggregates
+*
+* @param[in]  window : window of the unit
+* @param[out] peak   : highest value of every counter
+* @param[out] min    : lowest value of every counter
+* @param[out] mean   : mean value of every counter
+*
+* @retval  : number of samples in the window, 0 if there is nothing
+*            to report
+*
+* @note : the aggregates are valid until bst_window_reset, which must
+*         follow before the next sample is accounted.
+*
+*********************************************************************/
+unsigned int bst_window_close (BVIEW_BST_WINDOW_t *window,
+                               BVIEW_BST_ASIC_SNAPSHOT_DATA_t *peak,
+                               BVIEW_BST_ASIC_SNAPSHOT_DATA_t *min,
+                               BVIEW_BST_ASIC_SNAPSHOT_DATA_t *mean);
+
+/*********************************************************************
+* @brief : starts a new, empty window
+*
+* @param[in] window : window of the unit, may be NULL
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_window_reset (BVIEW_BST_WINDOW_t *window);
+
+/*********************************************************************
+* @brief : whether two stats records hold the same stats
+*
+* @param[in] record : record
+* @param[in] other  : record to compare with
+*
+* @retval  : true if both refer to the same published snapshot
+*
+* @note : a record which copied its stats is never known to be the
+*         same as another one.
+*
+*********************************************************************/
+bool bst_snapshot_same (const BVIEW_BST_REPORT_SNAPSHOT_t *record,
+                        const BVIEW_BST_REPORT_SNAPSHOT_t *other);
+
+/*********************************************************************
+* @brief : copies the stats of a record into another one
+*
+* @param[in]  src : record holding the stats
+* @param[out] dst : record to be filled, of the same layout
+*
+* @retval  : BVIEW_STATUS_SUCCESS : dst holds the stats of src
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+* @note : dst keeps the stats in its own buffer.
+*
+*********************************************************************/
+BVIEW_STATUS bst_snapshot_copy (BVIEW_BST_REPORT_SNAPSHOT_t *dst,
+                                const BVIEW_BST_REPORT_SNAPSHOT_t *src);
+
+/*********************************************************************
+* @brief : allocates the report cache of a unit
+*
+* @param[out] cache : newly allocated, empty cache
+*
+* @retval  : BVIEW_STATUS_SUCCESS : cache allocated
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+* @retval  : BVIEW_STATUS_RESOURCE_NOT_AVAILABLE : out of memory
+*
+* @note : the buffers of the entries are allocated as responses are
+*         stored. Release with bst_report_cache_free.
+*
+*********************************************************************/
+BVIEW_STATUS bst_report_cache_alloc (BVIEW_BST_REPORT_CACHE_t **cache);
+
+/*********************************************************************
+* @brief : frees a cache allocated with bst_report_cache_alloc
+*
+* @param[in] cache : cache to be freed, may be NULL
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_report_cache_free (BVIEW_BST_REPORT_CACHE_t *cache);
+
+/*********************************************************************
+* @brief : drops every response of the cache
+*
+* @param[in] cache : cache of the unit, may be NULL
+*
+* @retval  : none
+*
+* @note : the buffers are kept for the next responses. Invoked when
+*         the configuration of the unit changes.
+*
+*********************************************************************/
+void bst_report_cache_invalidate (BVIEW_BST_REPORT_CACHE_t *cache);
+
+/*********************************************************************
+* @brief : finds the response encoded for a poll
+*
+* @param[in] cache      : cache of the unit
+* @param[in] generation : stats generation of the unit
+* @param[in] options    : options of the report
+* @param[in] format     : format of the report
+*
+* @retval  : the entry holding the response, NULL if there is none
+*
+*********************************************************************/
+const BVIEW_BST_REPORT_CACHE_ENTRY_t *
+bst_report_cache_lookup (BVIEW_BST_REPORT_CACHE_t *cache, uint64_t generation,
+                         const BVIEW_BST_REPORT_OPTIONS_t *options,
+                         BVIEW_REST_FORMAT_t format);
+
+/*********************************************************************
+* @brief : starts storing the response encoded for a poll
+*
+* @param[in] cache      : cache of the unit
+* @param[in] generation : stats generation of the unit
+* @param[in] options    : options of the report
+* @param[in] format     : format of the report
+*
+* @retval  : the entry the response is appended to, NULL if it is
+*            not stored
+*
+*********************************************************************/
+BVIEW_BST_REPORT_CACHE_ENTRY_t *
+bst_report_cache_store_start (BVIEW_BST_REPORT_CACHE_t *cache, uint64_t generation,
+                              const BVIEW_BST_REPORT_OPTIONS_t *options,
+                              BVIEW_REST_FORMAT_t format);
+
+/*********************************************************************
+* @brief : appends a part of the response to the entry being stored
+*
+* @param[in] entry  : entry from bst_report_cache_store_start, may be NULL
+* @param[in] data   : part of the response
+* @param[in] length : number of bytes in data
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_report_cache_store (BVIEW_BST_REPORT_CACHE_ENTRY_t *entry,
+                             const void *data, int length);
+
+/*********************************************************************
+* @brief : ends storing a response
+*
+* @param[in] entry : entry from bst_report_cache_store_start, may be NULL
+* @param[in] rv    : outcome of encoding the response
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_report_cache_store_end (BVIEW_BST_REPORT_CACHE_ENTRY_t *entry,
+                                 BVIEW_STATUS rv);
+
+/*********************************************************************
+* @brief : checks the max buffers percentages are reported against
+*
+* @param[in] cache      : cache of the unit
+* @param[in] maxBuffers : max buffers just read from the asic
+*
+* @retval  : true if they changed since the last check
+*
+*********************************************************************/
+bool bst_report_cache_max_buffers_changed (BVIEW_BST_REPORT_CACHE_t *cache,
+                                           const BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBuffers);
+
+/*********************************************************************
+* @brief : provides the counters of the cache
+*
+* @param[in]  cache : cache of the unit
+* @param[out] stats : counters of the cache
+*
+* @retval  : BVIEW_STATUS_SUCCESS : counters are filled in
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+*********************************************************************/
+BVIEW_STATUS bst_report_cache_stats_get (const BVIEW_BST_REPORT_CACHE_t *cache,
+                                         BVIEW_BST_REPORT_CACHE_STATS_t *stats);
+
+/*********************************************************************
+* @brief : prints the counters of the report cache of a unit
+*
+* @param[in] unit : unit
+*
+* @retval  : BVIEW_STATUS_SUCCESS : counters are printed
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+*********************************************************************/
+BVIEW_STATUS bst_report_cache_dump (int unit);
+
+/*********************************************************************
+* @brief : creates the shared memory region of a unit
+*
+* @param[in]  unit   : unit the region is created for
+* @param[in]  layout : layout of the snapshots of the unit
+* @param[out] shm    : region, mapped and described, without a snapshot
+*
+* @retval  : BVIEW_STATUS_SUCCESS : region created
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+* @retval  : BVIEW_STATUS_RESOURCE_NOT_AVAILABLE : out of memory
+* @retval  : BVIEW_STATUS_FAILURE : the region could not be created
+*
+* @note : Release with bst_shm_close.
+*
+*********************************************************************/
+BVIEW_STATUS bst_shm_open (int unit, const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout,
+                           BVIEW_BST_SHM_t **shm);
+
+/*********************************************************************
+* @brief : removes the shared memory region of a unit
+*
+* @param[in] shm : region to be removed, may be NULL
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_shm_close (BVIEW_BST_SHM_t *shm);
+
+/*********************************************************************
+* @brief : creates or removes the shared memory region of a unit as
+*          the bst_shm_publish property of the agent asks
+*
+* @param[in] unit : unit the region is checked for
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_shm_config_apply (unsigned int unit);
+
+/*********************************************************************
+* @brief : publishes a stats record in the shared memory region
+*
+* @param[in] shm    : region of the unit, may be NULL
+* @param[in] record : stats record to be published
+*
+* @retval  : BVIEW_STATUS_SUCCESS : record published, or no region
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+*********************************************************************/
+BVIEW_STATUS bst_shm_publish (BVIEW_BST_SHM_t *shm,
+                              const BVIEW_BST_REPORT_SNAPSHOT_t *record);
+
+/*********************************************************************
+* @brief : allocates the stats history of a unit
+*
+* @param[in]  layout  : layout of the snapshots of the unit
+* @param[out] history : newly allocated, empty history
+*
+* @retval  : BVIEW_STATUS_SUCCESS : history allocated
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+* @retval  : BVIEW_STATUS_RESOURCE_NOT_AVAILABLE : out of memory
+*
+* @note : Release with bst_history_free.
+*
+*********************************************************************/
+BVIEW_STATUS bst_history_alloc (const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout,
+                                BVIEW_BST_HISTORY_t **history);
+
+/*********************************************************************
+* @brief : frees a history allocated with bst_history_alloc
+*
+* @param[in] history : history to be freed, may be NULL
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_history_free (BVIEW_BST_HISTORY_t *history);
+
+/*********************************************************************
+* @brief : adds a stats collection to the history
+*
+* @param[in] history : history of the unit
+* @param[in] record  : stats record just collected
+*
+* @retval  : BVIEW_STATUS_SUCCESS : record added
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+* @note : only the counters changed since the previous entry are
+*         stored. The oldest entries are dropped when the history
+*         is out of entries or out of room for the changes.
+*
+*********************************************************************/
+BVIEW_STATUS bst_history_add (BVIEW_BST_HISTORY_t *history,
+                              const BVIEW_BST_REPORT_SNAPSHOT_t *record);
+
+/*********************************************************************
+* @brief : positions a cursor before the first entry of a time range
+*
+* @param[in]  history : history of the unit
+* @param[in]  start   : first time to be reported, 0 for the oldest entry
+* @param[in]  end     : last time to be reported, 0 for the newest entry
+* @param[out] cursor  : cursor
+*
+* @retval  : BVIEW_STATUS_SUCCESS : cursor set up
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+*********************************************************************/
+BVIEW_STATUS bst_history_cursor_init (BVIEW_BST_HISTORY_t *history,
+                                      BVIEW_TIME_t start, BVIEW_TIME_t end,
+                                      BVIEW_BST_HISTORY_CURSOR_t *cursor);
+
+/*********************************************************************
+* @brief : rebuilds the next entry of the time range of a cursor
+*
+* @param[in]  cookie   : cursor, see bst_history_cursor_init
+* @param[out] previous : entry reported before this one, NULL for the first
+* @param[out] current  : entry
+* @param[out] time     : time the entry was collected at
+*
+* @retval  : BVIEW_STATUS_SUCCESS : entry rebuilt
+* @retval  : BVIEW_STATUS_OUTOFRANGE : no more entries in the time range
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+* @note : the returned data is valid until the next call. Entries
+*         are rebuilt by replaying the changes from the oldest one,
+*         so a walk costs the changes of the whole history once.
+*
+*********************************************************************/
+BVIEW_STATUS bst_history_next (void *cookie,
+                               const BVIEW_BST_ASIC_SNAPSHOT_DATA_t **previous,
+                               const BVIEW_BST_ASIC_SNAPSHOT_DATA_t **current,
+                               BVIEW_TIME_t *time);
+
 /*************************************************************
 *@brief:  Callback function to send the trigger to bst application
 *         to send periodic collection
@@ -1038,6 +1899,151 @@ void bst_realm_to_mask (BVIEW_BST_TRACK_PARAMS_t *data,
 void bst_mask_to_realm (int trackingMask,
                         BVIEW_BST_TRACK_PARAMS_t *data);
 
+/*********************************************************************
+* @brief : application function to configure a subscription to the
+*          periodic reports
+*
+* @param[in] msg_data : pointer to the bst message request.
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the subscription is configured
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameter.
+* @retval  : other : the collector of the subscription could not be set
+*
+* @note : the reports of the unit are checked for due subscriptions
+*         while any subscription of the unit is enabled.
+*
+*********************************************************************/
+BVIEW_STATUS bst_subscription_set (BVIEW_BST_REQUEST_MSG_t *msg_data);
+
+/*********************************************************************
+* @brief : application function to send the reports of the due
+*          subscriptions of a unit
+*
+* @param[in] msg_data : pointer to the bst message request.
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the reports are sent, or none is due
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameter.
+* @retval  : other : collecting or sending the stats failed
+*
+* @note : the stats are collected once, and every report is encoded
+*         once for all the subscriptions asking for the same one.
+*         No response is sent.
+*
+*********************************************************************/
+BVIEW_STATUS bst_subscription_collect (BVIEW_BST_REQUEST_MSG_t *msg_data);
+
+/*********************************************************************
+*  @brief:  callback function to check for due subscriptions
+*
+* @param[in]   sigval : Data passed with notification after timer expires
+*
+* @retval  : BVIEW_STATUS_SUCCESS : message is successfully posted to bst.
+* @retval  : BVIEW_STATUS_FAILURE : failed to post message to bst.
+*
+* @note : invoked in the timer context, every 
+*         BVIEW_BST_SUBSCRIPTION_TICK milli seconds.
+*
+*********************************************************************/
+BVIEW_STATUS bst_subscription_cb (union sigval sigval);
+
+/*********************************************************************
+* @brief : stops the subscriptions of a unit and frees their stats
+*
+* @param[in] unit : unit
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_subscription_uninit (int unit);
+
+/*********************************************************************
+* @brief : application function to stream the reports to a client
+*
+* @param[in] msg_data : pointer to the bst message request.
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the connection streams the reports
+* @retval  : BVIEW_STATUS_RESOURCE_NOT_AVAILABLE : no room for a stream
+* @retval  : BVIEW_STATUS_FAILURE : the stream is not started
+*
+* @note : the request is answered by the stream, a failed one with
+*         an error.
+*
+*********************************************************************/
+BVIEW_STATUS bst_event_stream_start (BVIEW_BST_REQUEST_MSG_t *msg_data);
+
+/*********************************************************************
+* @brief : sends a periodic or trigger report to the event streams
+*
+* @param[in] reply_data : the report, as for the collector
+* @param[in] previous : stats the report is incremental to, if any
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the report is queued on the streams
+*            asking for it, if any
+* @retval  : BVIEW_STATUS_OUTOFMEMORY : a report is not encoded
+*
+* @note : called with the lock of the unit held.
+*
+*********************************************************************/
+BVIEW_STATUS bst_event_reports_send (BVIEW_BST_RESPONSE_MSG_t *reply_data,
+                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous);
+
+/*********************************************************************
+* @brief : application function to start, change or stop the export
+*          of the samples of a unit in datagrams
+*
+* @param[in] msg_data : pointer to the bst message request.
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the export is configured
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameter.
+* @retval  : BVIEW_STATUS_RESOURCE_NOT_AVAILABLE : out of memory
+* @retval  : other : the socket or the timer could not be set up, the
+*            export is stopped
+*
+* @note : a changed export starts over with every counter.
+*
+*********************************************************************/
+BVIEW_STATUS bst_udp_export_set (BVIEW_BST_REQUEST_MSG_t *msg_data);
+
+/*********************************************************************
+* @brief : application function to take a sample of a unit and send
+*          its changes in datagrams
+*
+* @param[in] msg_data : pointer to the bst message request.
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the sample is sent
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameter.
+* @retval  : other : collecting the stats failed
+*
+* @note : No response is sent. A datagram the socket does not take is
+*         dropped and counted, it is not retried.
+*
+*********************************************************************/
+BVIEW_STATUS bst_udp_export_collect (BVIEW_BST_REQUEST_MSG_t *msg_data);
+
+/*********************************************************************
+*  @brief:  callback function to take a sample for the export
+*
+* @param[in]   sigval : Data passed with notification after timer expires
+*
+* @retval  : BVIEW_STATUS_SUCCESS : message is successfully posted to bst.
+* @retval  : BVIEW_STATUS_FAILURE : failed to post message to bst.
+*
+* @note : invoked in the timer context, every sample interval of the
+*         export.
+*
+*********************************************************************/
+BVIEW_STATUS bst_udp_export_cb (union sigval sigval);
+
+/*********************************************************************
+* @brief : stops the export of a unit and frees its resources
+*
+* @param[in] unit : unit
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_udp_export_uninit (int unit);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,176 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "bst_json_memory.h"
+#include "configure_bst_thresholds.h"
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+#include "get_bst_tracking.h"
+#include "get_bst_feature.h"
+#include "get_bst_thresholds.h"
+#include "get_bst_report.h"
+#include "get_bst_history.h"
+#include "bst_json_encoder.h"
+#include "bst.h"
+#include "broadview.h"
+#include "bst_app.h"
+#include "rest_api.h"
+#include "openapps_log_api.h"
+
+/*********************************************************************
+* @brief : application function to stream the reports to a client
+*
+* @param[in] msg_data : pointer to the bst message request.
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the connection streams the reports
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameter.
+* @retval  : other : the stream is not started
+*
+* @note : the client gets the periodic and trigger reports of the unit
+*         from the next one on, restricted to the realms it asked for.
+*
+*********************************************************************/
+BVIEW_STATUS bst_event_stream_start (BVIEW_BST_REQUEST_MSG_t *msg_data)
+{
+  if ((NULL == msg_data) || (0 == msg_data->request.stream.realmMask))
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  return rest_event_stream_start (msg_data->cookie,
+                                  BVIEW_BST_EVENT_FILTER (msg_data->unit,
+                                                          msg_data->request.stream.realmMask));
+}
+
+/*********************************************************************
+* @brief : restricts the options of a report to the realms of a stream
+*
+* @param[in,out] options : options of the report
+* @param[in] realmMask : realms of the stream
+*
+* @retval  : true if a realm of the report is left
+*
+*********************************************************************/
+static bool bst_event_options_filter (BVIEW_BST_REPORT_OPTIONS_t *options, int realmMask)
+{
+  BVIEW_BST_TRACK_PARAMS_t realms;
+
+  memset (&realms, 0, sizeof (realms));
+  bst_mask_to_realm (realmMask, &realms);
+
+  options->includeDevice = (options->includeDevice && realms.trackDevice);
+  options->includeIngressPortPriorityGroup = (options->includeIngressPortPriorityGroup &&
+                                              realms.trackIngressPortPriorityGroup);
+  options->includeIngressPortServicePool = (options->includeIngressPortServicePool &&
+                                            realms.trackIngressPortServicePool);
+  options->includeIngressServicePool = (options->includeIngressServicePool &&
+                                        realms.trackIngressServicePool);
+  options->includeEgressPortServicePool = (options->includeEgressPortServicePool &&
+                                           realms.trackEgressPortServicePool);
+  options->includeEgressServicePool = (options->includeEgressServicePool &&
+                                       realms.trackEgressServicePool);
+  options->includeEgressUcQueue = (options->includeEgressUcQueue && realms.trackEgressUcQueue);
+  options->includeEgressUcQueueGroup = (options->includeEgressUcQueueGroup &&
+                                        realms.trackEgressUcQueueGroup);
+  options->includeEgressMcQueue = (options->includeEgressMcQueue && realms.trackEgressMcQueue);
+  options->includeEgressCpuQueue = (options->includeEgressCpuQueue && realms.trackEgressCpuQueue);
+  options->includeEgressRqeQueue = (options->includeEgressRqeQueue && realms.trackEgressRqeQueue);
+
+  return (options->includeDevice ||
+          options->includeIngressPortPriorityGroup ||
+          options->includeIngressPortServicePool ||
+          options->includeIngressServicePool ||
+          options->includeEgressPortServicePool ||
+          options->includeEgressServicePool ||
+          options->includeEgressUcQueue ||
+          options->includeEgressUcQueueGroup ||
+          options->includeEgressMcQueue ||
+          options->includeEgressCpuQueue ||
+          options->includeEgressRqeQueue);
+}
+
+/*********************************************************************
+* @brief : sends a periodic or trigger report to the event streams
+*
+* @param[in] reply_data : the report, as for the collector
+* @param[in] previous : stats the report is incremental to, if any
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the report is queued on the streams
+*            asking for it, if any
+* @retval  : BVIEW_STATUS_OUTOFMEMORY : a report is not encoded
+*
+* @note : the report is encoded once for the streams asking for the
+*         same realms, always in JSON. The streams are written by the
+*         REST thread, a slow client loses its oldest reports and does
+*         not hold the bst thread.
+*
+*********************************************************************/
+BVIEW_STATUS bst_event_reports_send (BVIEW_BST_RESPONSE_MSG_t *reply_data,
+                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous)
+{
+  unsigned int filters[BVIEW_REST_MAX_EVENT_STREAMS];
+  BVIEW_BST_REPORT_OPTIONS_t options;
+  BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
+  const char *name;
+  uint8_t *pJsonBuffer;
+  int count, i;
+
+  if ((NULL == reply_data) || (NULL == reply_data->response.report.active))
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  count = rest_event_filters_get (filters, BVIEW_REST_MAX_EVENT_STREAMS);
+
+  name = (BVIEW_BST_CMD_API_TRIGGER_REPORT == reply_data->msg_type) ?
+         BVIEW_BST_EVENT_TRIGGER : BVIEW_BST_EVENT_PERIODIC;
+
+  for (i = 0; i < count; i++)
+  {
+    if (BVIEW_BST_EVENT_FILTER_UNIT (filters[i]) != reply_data->unit)
+      continue;
+
+    options = reply_data->options;
+    if (false == bst_event_options_filter (&options, BVIEW_BST_EVENT_FILTER_REALMS (filters[i])))
+      continue;
+
+    pJsonBuffer = NULL;
+    rv = bstjson_encode_get_bst_report (reply_data->unit, reply_data->msg_type,
+                                        previous,
+                                        &reply_data->response.report.active->snapshot_data,
+                                        &options,
+                                        reply_data->asic_capabilities,
+                                        &reply_data->response.report.active->tv,
+                                        &pJsonBuffer);
+    if (BVIEW_STATUS_SUCCESS == rv)
+    {
+      rv = rest_event_send (filters[i], name, (char *) pJsonBuffer,
+                            strlen ((char *) pJsonBuffer));
+    }
+    if (NULL != pJsonBuffer)
+    {
+      bstjson_memory_free (pJsonBuffer);
+    }
+    if (BVIEW_STATUS_SUCCESS != rv)
+    {
+      LOG_POST (BVIEW_LOG_ERROR,
+          "failed to send the %s report of unit %d to the event streams, err = %d\r\n",
+          name, reply_data->unit, rv);
+    }
+  }
+
+  return rv;
+}
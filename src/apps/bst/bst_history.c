@@ -0,0 +1,387 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "configure_bst_thresholds.h"
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+#include "get_bst_tracking.h"
+#include "get_bst_feature.h"
+#include "get_bst_thresholds.h"
+#include "get_bst_report.h"
+#include "get_bst_history.h"
+#include "bst_json_encoder.h"
+#include "bst.h"
+#include "broadview.h"
+#include "bst_app.h"
+#include "openapps_log_api.h"
+
+/* number of 64 bit words in a snapshot of the layout */
+#define _BST_HISTORY_WORDS(_layout)   ((_layout)->size / sizeof (uint64_t))
+
+/* entry at the given position, relative to the oldest one */
+#define _BST_HISTORY_ENTRY(_history, _pos)  \
+        (&(_history)->entry[((_history)->head + (_pos)) % BVIEW_BST_HISTORY_DEPTH])
+
+/*********************************************************************
+* @brief : applies the changes of an entry to a copy of the data
+*
+* @param[in]     history : history of the unit
+* @param[in]     entry   : entry whose changes are applied
+* @param[in,out] data    : data of the entry before, the entry after
+*
+* @retval  : none
+*
+*********************************************************************/
+static void bst_history_apply (const BVIEW_BST_HISTORY_t *history,
+                               const BVIEW_BST_HISTORY_ENTRY_t *entry,
+                               uint64_t *data)
+{
+  unsigned int pos = entry->first;
+  unsigned int i = 0;
+
+  for (i = 0; i < entry->count; i++)
+  {
+    data[history->changeIndex[pos]] = history->changeValue[pos];
+    pos = (pos + 1) % BVIEW_BST_HISTORY_MAX_CHANGES;
+  }
+}
+
+/*********************************************************************
+* @brief : drops the oldest entry of the history
+*
+* @param[in] history : history of the unit, with at least two entries
+*
+* @retval  : none
+*
+* @note : the changes of the second oldest entry are folded into the
+*         base, which makes it the oldest one.
+*
+*********************************************************************/
+static void bst_history_drop_oldest (BVIEW_BST_HISTORY_t *history)
+{
+  BVIEW_BST_HISTORY_ENTRY_t *next = _BST_HISTORY_ENTRY (history, 1);
+
+  bst_history_apply (history, next, history->base);
+
+  history->changeHead = (history->changeHead + next->count) % BVIEW_BST_HISTORY_MAX_CHANGES;
+  history->changeCount -= next->count;
+  next->count = 0;
+
+  history->head = (history->head + 1) % BVIEW_BST_HISTORY_DEPTH;
+  history->count--;
+}
+
+/*********************************************************************
+* @brief : allocates the stats history of a unit
+*
+* @param[in]  layout  : layout of the snapshots of the unit
+* @param[out] history : newly allocated, empty history
+*
+* @retval  : BVIEW_STATUS_SUCCESS : history allocated
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+* @retval  : BVIEW_STATUS_RESOURCE_NOT_AVAILABLE : out of memory
+*
+* @note : Release with bst_history_free.
+*
+*********************************************************************/
+BVIEW_STATUS bst_history_alloc (const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout,
+                                BVIEW_BST_HISTORY_t **history)
+{
+  BVIEW_BST_HISTORY_t *ptr = NULL;
+  void *data[4] = { NULL, NULL, NULL, NULL };
+  size_t size;
+  unsigned int i = 0;
+
+  if ((NULL == layout) || (NULL == history))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  *history = NULL;
+
+  ptr = (BVIEW_BST_HISTORY_t *) malloc (sizeof (BVIEW_BST_HISTORY_t));
+  if (NULL == ptr)
+  {
+    return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+  }
+  memset (ptr, 0, sizeof (BVIEW_BST_HISTORY_t));
+
+  /* base, last and the two replay buffers */
+  size = (0 == layout->size) ? BVIEW_BST_SNAPSHOT_ALIGN : layout->size;
+  for (i = 0; i < 4; i++)
+  {
+    if (0 != posix_memalign (&data[i], BVIEW_BST_SNAPSHOT_ALIGN, size))
+    {
+      data[i] = NULL;
+      break;
+    }
+    memset (data[i], 0, size);
+  }
+
+  ptr->changeIndex = (uint32_t *) malloc (BVIEW_BST_HISTORY_MAX_CHANGES * sizeof (uint32_t));
+  ptr->changeValue = (uint64_t *) malloc (BVIEW_BST_HISTORY_MAX_CHANGES * sizeof (uint64_t));
+
+  if ((i < 4) || (NULL == ptr->changeIndex) || (NULL == ptr->changeValue))
+  {
+    for (i = 0; i < 4; i++)
+    {
+      free (data[i]);
+    }
+    free (ptr->changeIndex);
+    free (ptr->changeValue);
+    free (ptr);
+    return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+  }
+
+  ptr->layout = layout;
+  ptr->base = (uint64_t *) data[0];
+  ptr->last = (uint64_t *) data[1];
+  for (i = 0; i < 2; i++)
+  {
+    ptr->replay[i].layout = layout;
+    ptr->replay[i].data = (uint8_t *) data[2 + i];
+  }
+
+  *history = ptr;
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : frees a history allocated with bst_history_alloc
+*
+* @param[in] history : history to be freed, may be NULL
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_history_free (BVIEW_BST_HISTORY_t *history)
+{
+  if (NULL == history)
+  {
+    return;
+  }
+
+  free (history->base);
+  free (history->last);
+  free (history->replay[0].data);
+  free (history->replay[1].data);
+  free (history->changeIndex);
+  free (history->changeValue);
+  free (history);
+}
+
+/*********************************************************************
+* @brief : adds a stats collection to the history
+*
+* @param[in] history : history of the unit
+* @param[in] record  : stats record just collected
+*
+* @retval  : BVIEW_STATUS_SUCCESS : record added
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+* @note : only the counters changed since the previous entry are
+*         stored. The oldest entries are dropped when the history
+*         is out of entries or out of room for the changes.
+*
+*********************************************************************/
+BVIEW_STATUS bst_history_add (BVIEW_BST_HISTORY_t *history,
+                              const BVIEW_BST_REPORT_SNAPSHOT_t *record)
+{
+  const uint64_t *data;
+  BVIEW_BST_HISTORY_ENTRY_t *entry;
+  size_t words, word;
+  unsigned int changes = 0;
+  unsigned int pos;
+
+  if ((NULL == history) || (NULL == record) ||
+      (history->layout != record->snapshot_data.layout))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  data = (const uint64_t *) record->snapshot_data.data;
+  words = _BST_HISTORY_WORDS (history->layout);
+
+  if (0 != history->count)
+  {
+    /* count the changes first, so that room can be made for them */
+    for (word = 0; word < words; word++)
+    {
+      if (data[word] != history->last[word])
+      {
+        changes++;
+      }
+    }
+
+    if (BVIEW_BST_HISTORY_MAX_CHANGES < changes)
+    {
+      /* the changes alone do not fit, start over from this record */
+      history->count = 0;
+      history->changeHead = 0;
+      history->changeCount = 0;
+    }
+  }
+
+  if (0 == history->count)
+  {
+    memcpy (history->base, data, history->layout->size);
+    memcpy (history->last, data, history->layout->size);
+
+    entry = _BST_HISTORY_ENTRY (history, 0);
+    entry->tv = record->tv;
+    entry->first = history->changeHead;
+    entry->count = 0;
+    history->count = 1;
+    return BVIEW_STATUS_SUCCESS;
+  }
+
+  while ((BVIEW_BST_HISTORY_DEPTH == history->count) ||
+         (BVIEW_BST_HISTORY_MAX_CHANGES - history->changeCount < changes))
+  {
+    bst_history_drop_oldest (history);
+  }
+
+  entry = _BST_HISTORY_ENTRY (history, history->count);
+  entry->tv = record->tv;
+  entry->first = (history->changeHead + history->changeCount) % BVIEW_BST_HISTORY_MAX_CHANGES;
+  entry->count = changes;
+
+  pos = entry->first;
+  for (word = 0; (word < words) && (0 != changes); word++)
+  {
+    if (data[word] != history->last[word])
+    {
+      history->changeIndex[pos] = (uint32_t) word;
+      history->changeValue[pos] = data[word];
+      history->last[word] = data[word];
+      pos = (pos + 1) % BVIEW_BST_HISTORY_MAX_CHANGES;
+      changes--;
+    }
+  }
+
+  history->changeCount += entry->count;
+  history->count++;
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : positions a cursor before the first entry of a time range
+*
+* @param[in]  history : history of the unit
+* @param[in]  start   : first time to be reported, 0 for the oldest entry
+* @param[in]  end     : last time to be reported, 0 for the newest entry
+* @param[out] cursor  : cursor
+*
+* @retval  : BVIEW_STATUS_SUCCESS : cursor set up
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+*********************************************************************/
+BVIEW_STATUS bst_history_cursor_init (BVIEW_BST_HISTORY_t *history,
+                                      BVIEW_TIME_t start, BVIEW_TIME_t end,
+                                      BVIEW_BST_HISTORY_CURSOR_t *cursor)
+{
+  if ((NULL == history) || (NULL == cursor))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  memset (cursor, 0, sizeof (BVIEW_BST_HISTORY_CURSOR_t));
+  cursor->history = history;
+  cursor->start = start;
+  cursor->end = end;
+
+  /* both the replay buffers start at the oldest entry */
+  memcpy (history->replay[0].data, history->base, history->layout->size);
+  memcpy (history->replay[1].data, history->base, history->layout->size);
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : rebuilds the next entry of the time range of a cursor
+*
+* @param[in]  cookie   : cursor, see bst_history_cursor_init
+* @param[out] previous : entry reported before this one, NULL for the first
+* @param[out] current  : entry
+* @param[out] time     : time the entry was collected at
+*
+* @retval  : BVIEW_STATUS_SUCCESS : entry rebuilt
+* @retval  : BVIEW_STATUS_OUTOFRANGE : no more entries in the time range
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+* @note : the returned data is valid until the next call. Entries
+*         are rebuilt by replaying the changes from the oldest one,
+*         so a walk costs the changes of the whole history once.
+*
+*********************************************************************/
+BVIEW_STATUS bst_history_next (void *cookie,
+                               const BVIEW_BST_ASIC_SNAPSHOT_DATA_t **previous,
+                               const BVIEW_BST_ASIC_SNAPSHOT_DATA_t **current,
+                               BVIEW_TIME_t *time)
+{
+  BVIEW_BST_HISTORY_CURSOR_t *cursor = (BVIEW_BST_HISTORY_CURSOR_t *) cookie;
+  BVIEW_BST_HISTORY_t *history;
+  const BVIEW_BST_HISTORY_ENTRY_t *entry;
+
+  if ((NULL == cursor) || (NULL == cursor->history) ||
+      (NULL == previous) || (NULL == current) || (NULL == time))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  history = cursor->history;
+
+  while (cursor->next < history->count)
+  {
+    /* replay[1] trails replay[0] by one entry */
+    if (0 != cursor->next)
+    {
+      bst_history_apply (history, _BST_HISTORY_ENTRY (history, cursor->next - 1),
+                         (uint64_t *) history->replay[1].data);
+    }
+    entry = _BST_HISTORY_ENTRY (history, cursor->next);
+    bst_history_apply (history, entry, (uint64_t *) history->replay[0].data);
+    cursor->next++;
+
+    if ((0 != cursor->start) && (entry->tv < cursor->start))
+    {
+      continue;
+    }
+
+    if ((0 != cursor->end) && (entry->tv > cursor->end))
+    {
+      break;
+    }
+
+    /* the entries of the range are consecutive, so the trailing
+       buffer holds the entry reported last */
+    *previous = (true == cursor->reported) ? &history->replay[1] : NULL;
+    *current = &history->replay[0];
+    *time = entry->tv;
+    cursor->reported = true;
+    return BVIEW_STATUS_SUCCESS;
+  }
+
+  cursor->next = history->count;
+  return BVIEW_STATUS_OUTOFRANGE;
+}
@@ -24,6 +24,7 @@
 #include <pthread.h>
 #include <mqueue.h>
 #include <errno.h>
+#include <unistd.h>
 #include "bst_json_memory.h"
 #include "clear_bst_statistics.h"
 #include "clear_bst_thresholds.h"
@@ -34,7 +35,9 @@
 #include "get_bst_feature.h"
 #include "get_bst_thresholds.h"
 #include "get_bst_report.h"
+#include "get_bst_history.h"
 #include "bst_json_encoder.h"
+#include "bst_cbor_encoder.h"
 #include "bst.h"
 #include "broadview.h"
 #include "bst_app.h"
@@ -69,12 +72,20 @@ BVIEW_STATUS bst_type_api_get (int type, BVIEW_BST_API_HANDLER_t *handler)
     {BVIEW_BST_CMD_API_GET_REPORT, bst_get_report},
     {BVIEW_BST_CMD_API_GET_THRESHOLD, bst_get_report},
     {BVIEW_BST_CMD_API_TRIGGER_REPORT, bst_get_report},
+    {BVIEW_BST_CMD_API_GET_HISTORY, bst_get_history},
+    {BVIEW_BST_CMD_API_GET_HISTOGRAM, bst_get_histogram},
+    {BVIEW_BST_CMD_API_SAMPLE_COLLECT, bst_sample_collect},
+    {BVIEW_BST_CMD_API_SUBSCRIPTION_COLLECT, bst_subscription_collect},
+    {BVIEW_BST_CMD_API_UDP_EXPORT_COLLECT, bst_udp_export_collect},
     {BVIEW_BST_CMD_API_TRIGGER_COLLECT, bst_process_trigger},
     {BVIEW_BST_CMD_API_SET_FEATURE, bst_config_feature_set},
     {BVIEW_BST_CMD_API_SET_TRACK, bst_config_track_set},
     {BVIEW_BST_CMD_API_SET_THRESHOLD, bst_config_threshold_set},
     {BVIEW_BST_CMD_API_CLEAR_THRESHOLD, bst_clear_threshold_set},
     {BVIEW_BST_CMD_API_CLEAR_STATS, bst_clear_stats_set},
+    {BVIEW_BST_CMD_API_SET_SUBSCRIPTION, bst_subscription_set},
+    {BVIEW_BST_CMD_API_STREAM_REPORTS, bst_event_stream_start},
+    {BVIEW_BST_CMD_API_SET_UDP_EXPORT, bst_udp_export_set},
     {BVIEW_BST_CMD_API_CLEAR_TRIGGER_COUNT, bst_clear_trigger_count},
     {BVIEW_BST_CMD_API_ENABLE_BST_ON_TRIGGER, bst_enable_on_trigger_timer_expiry},
     {BVIEW_BST_CMD_API_UPDATE_TRACK, bst_update_config_set},
@@ -337,12 +348,22 @@ BVIEW_STATUS bst_app_main (void)
       rv = handler(&msg_data);
       
      if ((BVIEW_BST_CMD_API_UPDATE_TRACK == msg_data.msg_type)||
-         (BVIEW_BST_CMD_API_UPDATE_FEATURE == msg_data.msg_type))
+         (BVIEW_BST_CMD_API_UPDATE_FEATURE == msg_data.msg_type)||
+         (BVIEW_BST_CMD_API_SAMPLE_COLLECT == msg_data.msg_type)||
+         (BVIEW_BST_CMD_API_SUBSCRIPTION_COLLECT == msg_data.msg_type)||
+         (BVIEW_BST_CMD_API_UDP_EXPORT_COLLECT == msg_data.msg_type))
      {
        /* no need to send any json response.
          */
       continue;
      }
+
+     if ((BVIEW_BST_CMD_API_STREAM_REPORTS == msg_data.msg_type) &&
+         (BVIEW_STATUS_SUCCESS == rv))
+     {
+       /* the stream answers the request */
+       continue;
+     }
       
 
       reply_data.rv = rv;
@@ -443,6 +464,8 @@ BVIEW_STATUS bst_app_config_init (unsigned int num_units)
     ptr->config.statsInPercentage = BVIEW_BST_DEFAULT_STATS_PERCENTAGE;
     ptr->config.triggerTransmitInterval = BVIEW_BST_DEFAULT_TRIGGER_INTERVAL;
     ptr->config.sendIncrementalReport = BVIEW_BST_DEFAULT_SEND_INCR_REPORT;
+    ptr->config.asyncReportFormat = BVIEW_BST_DEFAULT_ASYNC_REPORT_FORMAT;
+    ptr->config.sendWindowReport = BVIEW_BST_DEFAULT_SEND_WINDOW_REPORT;
 
 
 
@@ -523,6 +546,12 @@ BVIEW_STATUS bst_app_config_init (unsigned int num_units)
     bst_data_ptr->bst_collection_timer.in_use = false;
     bst_data_ptr->bst_trigger_timer.in_use = false;
     bst_data_ptr->bst_trigger_timer.unit = unit_id;
+    bst_data_ptr->bst_sample_timer.in_use = false;
+    bst_data_ptr->bst_sample_timer.unit = unit_id;
+    bst_data_ptr->bst_subscription_timer.in_use = false;
+    bst_data_ptr->bst_subscription_timer.unit = unit_id;
+    bst_data_ptr->bst_udp_export_timer.in_use = false;
+    bst_data_ptr->bst_udp_export_timer.unit = unit_id;
 
     /* push default values to asic */
     bstMode.trackInit = true;
@@ -573,6 +602,31 @@ BVIEW_STATUS bst_app_config_init (unsigned int num_units)
 }
 
 
+/*********************************************************************
+* @brief : function to get the kind of an asynchronous report
+*
+* @param[in] reply_data : pointer to the response message
+*
+* @retval  : BVIEW_BST_REPORT_KIND of the unit for a complete periodic
+*            report, BVIEW_REST_REPORT_KIND_NONE otherwise
+*
+* @note   : a complete periodic report supersedes the one before, an
+*           incremental one is against the one before and a trigger
+*           report tells of an event of its own.
+*
+*********************************************************************/
+static unsigned int bst_report_kind_get (const BVIEW_BST_RESPONSE_MSG_t * reply_data)
+{
+  if ((NULL == reply_data->cookie) &&
+      (BVIEW_BST_CMD_API_GET_REPORT == reply_data->msg_type) &&
+      (false == reply_data->options.reportTrigger) &&
+      (NULL == reply_data->response.report.backup))
+  {
+    return BVIEW_BST_REPORT_KIND (reply_data->unit);
+  }
+  return BVIEW_REST_REPORT_KIND_NONE;
+}
+
 /*********************************************************************
 * @brief : function to send reponse for encoding to cjson and sending 
 *          using rest API 
@@ -594,7 +648,12 @@ BVIEW_STATUS bst_app_config_init (unsigned int num_units)
 BVIEW_STATUS bst_send_response (BVIEW_BST_RESPONSE_MSG_t * reply_data)
 {
   BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
+  BVIEW_BST_UNIT_CXT_t *ptr;
+  const BVIEW_BST_REPORT_CACHE_ENTRY_t *cached = NULL;
+  BVIEW_BST_REPORT_CACHE_ENTRY_t *entry = NULL;
   uint8_t *pJsonBuffer = NULL;
+  int length = 0;
+  bool streamed = false;
 
   if (NULL == reply_data)
     return BVIEW_STATUS_INVALID_PARAMETER;
@@ -617,7 +676,9 @@ BVIEW_STATUS bst_send_response (BVIEW_BST_RESPONSE_MSG_t * reply_data)
         (BVIEW_BST_CMD_API_SET_FEATURE == reply_data->msg_type) ||
         (BVIEW_BST_CMD_API_SET_THRESHOLD == reply_data->msg_type) ||
         (BVIEW_BST_CMD_API_CLEAR_STATS == reply_data->msg_type) ||
-        (BVIEW_BST_CMD_API_CLEAR_THRESHOLD == reply_data->msg_type))
+        (BVIEW_BST_CMD_API_CLEAR_THRESHOLD == reply_data->msg_type) ||
+        (BVIEW_BST_CMD_API_SET_SUBSCRIPTION == reply_data->msg_type) ||
+        (BVIEW_BST_CMD_API_SET_UDP_EXPORT == reply_data->msg_type))
     {
       rest_response_send_ok (reply_data->cookie);
       return BVIEW_STATUS_SUCCESS;
@@ -625,8 +686,37 @@ BVIEW_STATUS bst_send_response (BVIEW_BST_RESPONSE_MSG_t * reply_data)
 
   } 
 
+  ptr = BST_UNIT_PTR_GET (reply_data->unit);
+
   /* Take lock*/
   BST_LOCK_TAKE (reply_data->unit);
+
+  /* a poll of the stats the last polls got, with the same options,
+     gets the same response. the reports sent to the collector differ
+     from one another, they are not kept */
+  if ((BVIEW_BST_CMD_API_GET_REPORT == reply_data->msg_type) &&
+      (NULL != reply_data->cookie) && (NULL != ptr->report_cache))
+  {
+    cached = bst_report_cache_lookup (ptr->report_cache, ptr->stats_generation,
+                                      &reply_data->options, reply_data->format);
+    if (NULL != cached)
+    {
+      rv = rest_response_send_format (reply_data->cookie, (char *) cached->data,
+                                      cached->length, reply_data->format);
+      if (BVIEW_STATUS_SUCCESS != rv)
+      {
+        LOG_POST (BVIEW_LOG_ERROR,
+            " sending response failed due to error = %d\r\n",rv);
+      }
+      BST_LOCK_GIVE (reply_data->unit);
+      return rv;
+    }
+
+    /* the response is kept while it is encoded */
+    entry = bst_report_cache_store_start (ptr->report_cache, ptr->stats_generation,
+                                          &reply_data->options, reply_data->format);
+  }
+
   switch (reply_data->msg_type)
   {
     case BVIEW_BST_CMD_API_GET_TRACK:
@@ -649,6 +739,16 @@ BVIEW_STATUS bst_send_response (BVIEW_BST_RESPONSE_MSG_t * reply_data)
      case BVIEW_BST_CMD_API_GET_REPORT:
      case BVIEW_BST_CMD_API_TRIGGER_REPORT:
      case BVIEW_BST_CMD_API_GET_THRESHOLD:
+      /* the event streams get the report first, a trigger is not
+         held up by the collector */
+      if ((NULL == reply_data->cookie) &&
+          (BVIEW_BST_CMD_API_GET_THRESHOLD != reply_data->msg_type))
+      {
+        (void) bst_event_reports_send (reply_data,
+                                       (NULL == reply_data->response.report.backup) ? NULL :
+                                       &reply_data->response.report.backup->snapshot_data);
+      }
+
       /*  call json encoder api for report  */
 
       /* if this is a periodic report, the back up pointer is
@@ -656,7 +756,28 @@ BVIEW_STATUS bst_send_response (BVIEW_BST_RESPONSE_MSG_t * reply_data)
          pointer would be NULL pointer. so call 
          the encoder function accordingly */
 
-      if (NULL == reply_data->response.report.backup)
+      if (BVIEW_BST_DEFAULT_STREAM_REPORTS)
+      {
+        /* the report goes out while it is encoded */
+        rv = bst_send_report_stream (reply_data,
+                                     (NULL == reply_data->response.report.backup) ? NULL :
+                                     &reply_data->response.report.backup->snapshot_data,
+                                     entry);
+        streamed = true;
+      }
+      else if (BVIEW_REST_FORMAT_CBOR == reply_data->format)
+      {
+      /* binary, the length comes with it */
+      rv = bstcbor_encode_get_bst_report (reply_data->unit, reply_data->msg_type,
+                                          (NULL == reply_data->response.report.backup) ? NULL :
+                                          &reply_data->response.report.backup->snapshot_data,
+                                          &reply_data->response.report.active->snapshot_data,
+                                          &reply_data->options,
+                                          reply_data->asic_capabilities,
+                                          &reply_data->response.report.active->tv,
+                                          &pJsonBuffer, &length);
+      }
+      else if (NULL == reply_data->response.report.backup)
       {
       rv = bstjson_encode_get_bst_report (reply_data->unit, reply_data->msg_type,
                                           NULL, 
@@ -678,13 +799,62 @@ BVIEW_STATUS bst_send_response (BVIEW_BST_RESPONSE_MSG_t * reply_data)
       }
 
         break;
+
+    case BVIEW_BST_CMD_API_GET_HISTORY:
+      /* call json encoder api for history, which walks the entries */
+      rv = bstjson_encode_get_bst_history (reply_data->unit, reply_data->id,
+                                           bst_history_next,
+                                           &reply_data->response.history,
+                                           &reply_data->options,
+                                           reply_data->asic_capabilities,
+                                           &pJsonBuffer);
+      break;
+
+    case BVIEW_BST_CMD_API_GET_HISTOGRAM:
+      {
+        BVIEW_BST_UNIT_CXT_t *ptr = BST_UNIT_PTR_GET (reply_data->unit);
+
+        /* call json encoder api for the histograms */
+        rv = bstjson_encode_get_bst_histogram (reply_data->unit, reply_data->id,
+                                               reply_data->response.histogram,
+                                               &reply_data->options,
+                                               reply_data->asic_capabilities,
+                                               &ptr->histogram_start,
+                                               &ptr->histogram_end,
+                                               &pJsonBuffer);
+      }
+      break;
+
     default:
       break;
   }
 
-  if (NULL != pJsonBuffer && BVIEW_STATUS_SUCCESS == rv)
+  if (true == streamed)
   {
-    rv = rest_response_send(reply_data->cookie, (char *)pJsonBuffer, strlen((char *)pJsonBuffer));
+    /* the report is already out, or cut short */
+    if (BVIEW_STATUS_SUCCESS != rv)
+    {
+      LOG_POST (BVIEW_LOG_ERROR,
+          "streaming of bst report failed due to error = %d\r\n", rv);
+    }
+  }
+  else if (NULL != pJsonBuffer && BVIEW_STATUS_SUCCESS == rv)
+  {
+    if (0 == length)
+    {
+      length = strlen((char *)pJsonBuffer);
+    }
+    bst_report_cache_store (entry, pJsonBuffer, length);
+    if (NULL == reply_data->cookie)
+    {
+      rv = rest_report_send (0, bst_report_kind_get (reply_data),
+                             (char *)pJsonBuffer, length, reply_data->format);
+    }
+    else
+    {
+      rv = rest_response_send_format(reply_data->cookie, (char *)pJsonBuffer, length,
+                                     reply_data->format);
+    }
     if (BVIEW_STATUS_SUCCESS != rv)
     {
       _BST_LOG(_BST_DEBUG_ERROR, "sending response failed due to error = %d\r\n",rv);
@@ -693,7 +863,7 @@ BVIEW_STATUS bst_send_response (BVIEW_BST_RESPONSE_MSG_t * reply_data)
     }
     else
     {
-      _BST_LOG(_BST_DEBUG_TRACE,"sent response to rest, pJsonBuffer = %s, len = %d\r\n", pJsonBuffer, (int)strlen((char *)pJsonBuffer)); 
+      _BST_LOG(_BST_DEBUG_TRACE,"sent response to rest, format = %d, len = %d\r\n", reply_data->format, length); 
     }
     /* free the json buffer */
     if (NULL != pJsonBuffer)
@@ -714,11 +884,184 @@ BVIEW_STATUS bst_send_response (BVIEW_BST_RESPONSE_MSG_t * reply_data)
       bstjson_memory_free(pJsonBuffer);
     }
   }
+  /* the next polls get the response, if it is complete */
+  bst_report_cache_store_end (entry, rv);
+
   /* release the lock for success and failed cases */
   BST_LOCK_GIVE(reply_data->unit);
   return rv;
 }
 
+/*********************************************************************
+* @brief : function to send a window of a report being encoded
+*
+* @param[in] cookie : report stream the report goes out on
+* @param[in] data : encoded part of the report
+* @param[in] length : number of bytes in data
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the window is sent
+* @retval  : other : sending failed, the encoding stops
+*
+* @note   : the window is kept in the report cache as well, when the
+*           response is to be kept.
+*
+*********************************************************************/
+BVIEW_STATUS bst_report_stream_flush (void *cookie, const char *data, int length)
+{
+  BVIEW_BST_REPORT_STREAM_t *report = (BVIEW_BST_REPORT_STREAM_t *) cookie;
+  BVIEW_STATUS rv;
+
+  rv = rest_response_stream_send (&report->stream, data, length);
+  if (BVIEW_STATUS_SUCCESS == rv)
+  {
+    bst_report_cache_store (report->cache, data, length);
+  }
+  return rv;
+}
+
+/*********************************************************************
+* @brief : function to encode a report and send it in chunks, as the
+*          encoder fills its window
+*
+* @param[in] reply_data : pointer to the response message
+* @param[in] previous : stats of the last report, NULL for a snapshot
+* @param[in] cache : report cache entry the report is kept in, NULL
+*                    if it is not kept
+*
+* @retval  : BVIEW_STATUS_SUCCESS : report is sent
+* @retval  : other : encoding or sending the report failed
+*
+* @note   : the memory needed does not grow with the report, the
+*           encoder works in a window of BSTJSON_OUTPUT_WINDOW_SIZE
+*           bytes. Invoked with the unit lock held.
+*
+*********************************************************************/
+BVIEW_STATUS bst_send_report_stream (BVIEW_BST_RESPONSE_MSG_t * reply_data,
+                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                     BVIEW_BST_REPORT_CACHE_ENTRY_t *cache)
+{
+  BVIEW_BST_REPORT_STREAM_t report;
+  BVIEW_STATUS rv;
+
+  if (NULL == reply_data)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  report.cache = cache;
+  rv = rest_response_stream_open (reply_data->cookie, reply_data->format, &report.stream);
+  /* a complete periodic report replaces the one still queued */
+  report.stream.kind = bst_report_kind_get (reply_data);
+  if ((BVIEW_STATUS_SUCCESS == rv) && (BVIEW_REST_FORMAT_CBOR == reply_data->format))
+  {
+    rv = bstcbor_encode_get_bst_report_stream (reply_data->unit, reply_data->msg_type,
+                                               previous,
+                                               &reply_data->response.report.active->snapshot_data,
+                                               &reply_data->options,
+                                               reply_data->asic_capabilities,
+                                               &reply_data->response.report.active->tv,
+                                               bst_report_stream_flush, &report);
+  }
+  else if (BVIEW_STATUS_SUCCESS == rv)
+  {
+    rv = bstjson_encode_get_bst_report_stream (reply_data->unit, reply_data->msg_type,
+                                               previous,
+                                               &reply_data->response.report.active->snapshot_data,
+                                               &reply_data->options,
+                                               reply_data->asic_capabilities,
+                                               &reply_data->response.report.active->tv,
+                                               bst_report_stream_flush, &report);
+  }
+
+  /* ends the response, or answers with the error if nothing is out yet */
+  return rest_response_stream_close (&report.stream, rv, reply_data->id);
+}
+
+/*********************************************************************
+* @brief : function to send the aggregates of the reporting window
+*
+* @param[in] reply_data : the periodic report just sent
+*
+* @retval  : BVIEW_STATUS_SUCCESS : window report sent, or nothing to send
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+* @retval  : other : encoding or sending the report failed
+*
+* @note : the window is closed and a new one is started in the 
+*         bst context, so that no sample can fall between the two.
+*         The window report goes to the collector, like the periodic
+*         report it follows, in its format and with the same realms.
+*
+*********************************************************************/
+BVIEW_STATUS bst_send_window_report (BVIEW_BST_RESPONSE_MSG_t * reply_data)
+{
+  BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
+  BVIEW_BST_UNIT_CXT_t *ptr;
+  BVIEW_BST_ASIC_SNAPSHOT_DATA_t peak, min, mean;
+  BVIEW_BST_REPORT_OPTIONS_t options;
+  unsigned int samples;
+  uint8_t *pJsonBuffer = NULL;
+  int length = 0;
+
+  if ((NULL == reply_data) || (NULL == reply_data->response.report.active))
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  ptr = BST_UNIT_PTR_GET (reply_data->unit);
+  if ((NULL == ptr) || (NULL == ptr->window))
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  /* the aggregates are reported in full, skipping the zero counters */
+  options = reply_data->options;
+  options.sendIncrementalReport = true;
+
+  BST_LOCK_TAKE (reply_data->unit);
+  samples = bst_window_close (ptr->window, &peak, &min, &mean);
+  /* a window with the periodic sample alone tells nothing new */
+  if (1 < samples)
+  {
+    if (BVIEW_REST_FORMAT_CBOR == reply_data->format)
+    {
+      /* binary, the length comes with it */
+      rv = bstcbor_encode_window_report (reply_data->unit, &peak, &min, &mean,
+                                         samples, &options,
+                                         reply_data->asic_capabilities,
+                                         &ptr->window->start,
+                                         &reply_data->response.report.active->tv,
+                                         &pJsonBuffer, &length);
+    }
+    else
+    {
+      rv = bstjson_encode_window_report (reply_data->unit, &peak, &min, &mean,
+                                         samples, &options,
+                                         reply_data->asic_capabilities,
+                                         &ptr->window->start,
+                                         &reply_data->response.report.active->tv,
+                                         &pJsonBuffer);
+      if (NULL != pJsonBuffer)
+      {
+        length = strlen((char *)pJsonBuffer);
+      }
+    }
+    if (BVIEW_STATUS_SUCCESS == rv)
+    {
+      /* compressed as the periodic report is */
+      rv = rest_report_send (0, BVIEW_REST_REPORT_KIND_NONE,
+                             (char *)pJsonBuffer, length, reply_data->format);
+    }
+    if (BVIEW_STATUS_SUCCESS != rv)
+    {
+      LOG_POST (BVIEW_LOG_ERROR,
+          "sending window report failed due to error = %d\r\n", rv);
+    }
+    if (NULL != pJsonBuffer)
+    {
+      bstjson_memory_free(pJsonBuffer);
+    }
+  }
+  /* start the next window, whether or not this one made it out */
+  bst_window_reset (ptr->window);
+  BST_LOCK_GIVE (reply_data->unit);
+
+  return rv;
+}
+
 /*********************************************************************
 * @brief : function to prepare the response to the request message  
 *
@@ -749,6 +1092,7 @@ BVIEW_STATUS bst_copy_reply_params (BVIEW_BST_REQUEST_MSG_t * msg_data,
   BVIEW_BST_UNIT_CXT_t *ptr;
   BVIEW_BST_STAT_COLLECT_CONFIG_t *pCollect = &msg_data->request.collect;
   BVIEW_BST_REPORT_OPTIONS_t  *pResp; 
+  BVIEW_STATUS rv;
 
   if ((NULL == msg_data) || (NULL == reply_data))
     return BVIEW_STATUS_INVALID_PARAMETER;
@@ -777,6 +1121,9 @@ BVIEW_STATUS bst_copy_reply_params (BVIEW_BST_REQUEST_MSG_t * msg_data,
 
   /* copy the address pointer of the default values */
   reply_data->options.bst_max_buffers_ptr = &ptr->bst_max_buffers;
+  reply_data->options.bst_max_buffers_reciprocals = ptr->max_buf_reciprocals;
+  /* the port names rendered for the unit */
+  reply_data->options.notation = ptr->notation;
         /* copy the collect params into options fields of the request */
   BST_COPY_COLLECT_TO_RESP (pCollect, pResp);
 
@@ -837,6 +1184,12 @@ BVIEW_STATUS bst_copy_reply_params (BVIEW_BST_REQUEST_MSG_t * msg_data,
              Send only the counters which contain non zero values */
             reply_data->options.sendIncrementalReport = 
                  true;
+
+          /* and only the entries selected in the request, if any */
+          if (NULL != reply_data->cookie)
+          {
+            reply_data->options.filter = pCollect->filter;
+          }
         }
 
 
@@ -856,6 +1209,29 @@ BVIEW_STATUS bst_copy_reply_params (BVIEW_BST_REQUEST_MSG_t * msg_data,
       }
       break;
 
+    case BVIEW_BST_CMD_API_GET_HISTORY:
+      {
+        /* the realms come with the history request */
+        BST_COPY_COLLECT_TO_RESP (&msg_data->request.history.realms, pResp);
+        /* every entry after the first one is reported as changes */
+        reply_data->options.sendIncrementalReport = true;
+        reply_data->options.statsInPercentage = 
+          ptr->bst_data->bst_config.config.statsInPercentage;
+        bst_history_cursor_init (ptr->history,
+                                 msg_data->request.history.startTime,
+                                 msg_data->request.history.endTime,
+                                 &reply_data->response.history);
+      }
+      break;
+
+    case BVIEW_BST_CMD_API_GET_HISTOGRAM:
+      {
+        /* the realms come with the request, the bucket bounds are 
+           reported in bytes or cells as configured */
+        reply_data->response.histogram = &ptr->histogram;
+      }
+      break;
+
     case BVIEW_BST_CMD_API_GET_FEATURE:
       reply_data->response.config = &ptr->bst_data->bst_config.config;
       break;
@@ -867,9 +1243,41 @@ BVIEW_STATUS bst_copy_reply_params (BVIEW_BST_REQUEST_MSG_t * msg_data,
     default:
       break;
   }
+
+  /* the format of a report: the configured one for the collector, the
+     one asked for in the request, or the one the client accepts */
+  if ((BVIEW_BST_CMD_API_GET_REPORT == msg_data->msg_type) ||
+      (BVIEW_BST_CMD_API_TRIGGER_REPORT == msg_data->msg_type) ||
+      (BVIEW_BST_CMD_API_GET_THRESHOLD == msg_data->msg_type))
+  {
+    if (NULL == reply_data->cookie)
+    {
+      reply_data->format = ptr->bst_data->bst_config.config.asyncReportFormat;
+    }
+    else if (BVIEW_REST_FORMAT_DEFAULT != pCollect->format)
+    {
+      reply_data->format = pCollect->format;
+    }
+    else if (BVIEW_STATUS_SUCCESS != rest_response_format_get (reply_data->cookie,
+                                                                &reply_data->format))
+    {
+      reply_data->format = BVIEW_REST_FORMAT_JSON;
+    }
+  }
   /* release the lock for success and failed cases */
 
-  return bst_send_response(reply_data);
+  rv = bst_send_response(reply_data);
+
+  /* the aggregates of the window follow the periodic report, if the
+     collector asked for them */
+  if ((BVIEW_BST_CMD_API_GET_REPORT == msg_data->msg_type) &&
+      (BVIEW_BST_STATS_PERIODIC == msg_data->report_type) &&
+      (true == ptr->bst_data->bst_config.config.sendWindowReport))
+  {
+    (void) bst_send_window_report (reply_data);
+  }
+
+  return rv;
 }
 
 /*********************************************************************
@@ -946,6 +1354,37 @@ BVIEW_STATUS bst_periodic_collection_cb (union sigval sigval)
   return BVIEW_STATUS_SUCCESS;
 }
 
+/*********************************************************************
+*  @brief:  callback function to sample the stats between periodic reports
+*
+* @param[in]   sigval : Data passed with notification after timer expires
+*
+* @retval  : BVIEW_STATUS_SUCCESS : message is successfully posted to bst.
+* @retval  : BVIEW_STATUS_FAILURE : failed to post message to bst.
+*
+* @note : invoked in the timer context, the sample itself is taken in
+*         the bst context so that it is serialized with the reports.
+*
+*********************************************************************/
+BVIEW_STATUS bst_sample_cb (union sigval sigval)
+{
+  BVIEW_BST_REQUEST_MSG_t msg_data;
+  BVIEW_STATUS rv; 
+
+  memset (&msg_data, 0, sizeof (BVIEW_BST_REQUEST_MSG_t));
+  msg_data.msg_type = BVIEW_BST_CMD_API_SAMPLE_COLLECT;
+  msg_data.unit = (*(int *)sigval.sival_ptr);
+  /* Send the message to the bst application */
+  rv = bst_send_request (&msg_data);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+        "Failed to send sample message to bst application. err = %d\r\n", rv);
+    return BVIEW_STATUS_FAILURE;
+  }  
+  return BVIEW_STATUS_SUCCESS;
+}
+
 /*********************************************************************
 *  @brief:  function to clean up  bst application  
 *
@@ -992,26 +1431,49 @@ void bst_app_uninit ()
       free (bst_info.unit[id].bst_data);
     }
 
-    if (NULL != bst_info.unit[id].stats_active_record_ptr)
-    {
-      free (bst_info.unit[id].stats_active_record_ptr);
-    }
+    bst_snapshot_free (bst_info.unit[id].stats_active_record_ptr);
+    bst_info.unit[id].stats_active_record_ptr = NULL;
 
-    if (NULL != bst_info.unit[id].stats_backup_record_ptr)
-    {
-      free (bst_info.unit[id].stats_backup_record_ptr);
-    }
+    bst_snapshot_free (bst_info.unit[id].stats_backup_record_ptr);
+    bst_info.unit[id].stats_backup_record_ptr = NULL;
 
-    if (NULL != bst_info.unit[id].stats_current_record_ptr)
-    {
-      free (bst_info.unit[id].stats_current_record_ptr);
-    }
+    bst_snapshot_free (bst_info.unit[id].stats_current_record_ptr);
+    bst_info.unit[id].stats_current_record_ptr = NULL;
 
-    if (NULL != bst_info.unit[id].threshold_record_ptr)
-    {
-      free (bst_info.unit[id].threshold_record_ptr);
-    }
+    bst_snapshot_free (bst_info.unit[id].threshold_record_ptr);
+    bst_info.unit[id].threshold_record_ptr = NULL;
+
+    bst_history_free (bst_info.unit[id].history);
+    bst_info.unit[id].history = NULL;
+
+    bst_snapshot_free (bst_info.unit[id].sample_record_ptr);
+    bst_info.unit[id].sample_record_ptr = NULL;
+
+    bst_window_free (bst_info.unit[id].window);
+    bst_info.unit[id].window = NULL;
+
+    bst_subscription_uninit (id);
+
+    bst_udp_export_uninit (id);
+
+    free (bst_info.unit[id].histogram.data);
+    bst_info.unit[id].histogram.data = NULL;
+
+    bst_shm_close (bst_info.unit[id].shm);
+    bst_info.unit[id].shm = NULL;
+    bst_info.unit[id].shm_publish = false;
+
+    bst_report_cache_free (bst_info.unit[id].report_cache);
+    bst_info.unit[id].report_cache = NULL;
+
+    free (bst_info.unit[id].notation);
+    bst_info.unit[id].notation = NULL;
+
+    free (bst_info.unit[id].max_buf_reciprocals);
+    bst_info.unit[id].max_buf_reciprocals = NULL;
   }
+
+  bstjson_parallel_deinit ();
   
   /* check if the message queue already exists.
      If yes, we should delete the same */
@@ -1054,6 +1516,7 @@ BVIEW_STATUS bst_main ()
   unsigned int id = 0, num_units = 0;
   int rv = BVIEW_STATUS_SUCCESS;
   int recvMsgQid;
+  long workers = 0;
   pthread_rwlock_t *bst_configRWLock;
 
 
@@ -1070,6 +1533,9 @@ BVIEW_STATUS bst_main ()
     bst_configRWLock = &bst_info.unit[id].bst_configRWLock;
     /* Initialize Read Write lock with default attributes */
     pthread_rwlock_init (bst_configRWLock, NULL);
+
+    /* no udp export socket until the export is started */
+    bst_info.unit[id].udp_export.fd = -1;
   }
 
   /* get the number of units */
@@ -1090,27 +1556,48 @@ BVIEW_STATUS bst_main ()
     bst_info.unit[id].bst_data =
       (BVIEW_BST_DATA_t *) malloc (sizeof (BVIEW_BST_DATA_t));
 
-    /* stats records */
-    bst_info.unit[id].stats_active_record_ptr =
-      (BVIEW_BST_REPORT_SNAPSHOT_t *)
-      malloc (sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
-    bst_info.unit[id].stats_backup_record_ptr =
-      (BVIEW_BST_REPORT_SNAPSHOT_t *)
-      malloc (sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
-    bst_info.unit[id].stats_current_record_ptr =
-      (BVIEW_BST_REPORT_SNAPSHOT_t *)
-      malloc (sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
-
-    /* threshold records */
-    bst_info.unit[id].threshold_record_ptr =
-      (BVIEW_BST_REPORT_SNAPSHOT_t *)
-      malloc (sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
-
-    if ((NULL == bst_info.unit[id].bst_data) ||
-        (NULL == bst_info.unit[id].stats_active_record_ptr) ||
-        (NULL == bst_info.unit[id].stats_backup_record_ptr) ||
-        (NULL == bst_info.unit[id].stats_current_record_ptr) ||
-        (NULL == bst_info.unit[id].threshold_record_ptr))
+    if (NULL == bst_info.unit[id].bst_data)
+    {
+      /* Free the resources allocated so far */
+      bst_app_uninit ();
+
+      LOG_POST (BVIEW_LOG_EMERGENCY,
+                "Failed to allocate memory for bst application\r\n");
+      return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+    }
+
+    /* the records are sized from what the asic actually has */
+    if (BVIEW_STATUS_SUCCESS != sbapi_system_asic_capabilities_get (id,
+                                          &bst_info.unit[id].asic_capabilities))
+    {
+      /* Free the resources allocated so far */
+      bst_app_uninit ();
+
+      LOG_POST (BVIEW_LOG_EMERGENCY,
+                "Failed to Get Asic capabilities for unit %d. \r\n", id);
+      return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+    }
+
+    bst_snapshot_layout_init (&bst_info.unit[id].asic_capabilities,
+                              &bst_info.unit[id].snapshot_layout);
+
+    /* stats and threshold records */
+    if ((BVIEW_STATUS_SUCCESS != bst_snapshot_alloc (id, &bst_info.unit[id].snapshot_layout,
+                                          &bst_info.unit[id].stats_active_record_ptr)) ||
+        (BVIEW_STATUS_SUCCESS != bst_snapshot_alloc (id, &bst_info.unit[id].snapshot_layout,
+                                          &bst_info.unit[id].stats_backup_record_ptr)) ||
+        (BVIEW_STATUS_SUCCESS != bst_snapshot_alloc (id, &bst_info.unit[id].snapshot_layout,
+                                          &bst_info.unit[id].stats_current_record_ptr)) ||
+        (BVIEW_STATUS_SUCCESS != bst_snapshot_alloc (id, &bst_info.unit[id].snapshot_layout,
+                                          &bst_info.unit[id].threshold_record_ptr)) ||
+        (BVIEW_STATUS_SUCCESS != bst_history_alloc (&bst_info.unit[id].snapshot_layout,
+                                          &bst_info.unit[id].history)) ||
+        (BVIEW_STATUS_SUCCESS != bst_snapshot_alloc (id, &bst_info.unit[id].snapshot_layout,
+                                          &bst_info.unit[id].sample_record_ptr)) ||
+        (BVIEW_STATUS_SUCCESS != bst_window_alloc (&bst_info.unit[id].snapshot_layout,
+                                          &bst_info.unit[id].window)) ||
+        (BVIEW_STATUS_SUCCESS != bst_snapshot_alloc (id, &bst_info.unit[id].snapshot_layout,
+                                          &bst_info.unit[id].subscription_record_ptr)))
     {
       /* Free the resources allocated so far */
       bst_app_uninit ();
@@ -1119,27 +1606,75 @@ BVIEW_STATUS bst_main ()
                 "Failed to allocate memory for bst application\r\n");
       return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
     }
+
+    _BST_LOG(_BST_DEBUG_INFO, "unit %d snapshot record size = %zu bytes\n",
+             id, bst_info.unit[id].snapshot_layout.size);
+
+    /* let the south bound maintain report ready snapshots, the
+       records fall back to copying if this is not supported */
+    rv = sbapi_bst_snapshot_publish_start (id, &bst_info.unit[id].snapshot_layout);
+    if ((BVIEW_STATUS_SUCCESS != rv) && (BVIEW_STATUS_UNSUPPORTED != rv))
+    {
+      LOG_POST (BVIEW_LOG_ERROR,
+                "Failed to start snapshot publication for unit %d, err %d\r\n",
+                id, rv);
+    }
+
+    /* repeated polls are answered without encoding the report again,
+       they are encoded every time without the cache */
+    if ((true == BVIEW_BST_DEFAULT_REPORT_CACHE) &&
+        (BVIEW_STATUS_SUCCESS != bst_report_cache_alloc (&bst_info.unit[id].report_cache)))
+    {
+      LOG_POST (BVIEW_LOG_ERROR,
+                "Failed to allocate the report cache for unit %d\r\n", id);
+    }
+
+    /* the encoders copy the port names from here instead of asking
+       the south bound for every port of every report */
+    bst_info.unit[id].notation =
+      (BSTJSON_NOTATION_t *) malloc (sizeof (BSTJSON_NOTATION_t));
+    if (NULL != bst_info.unit[id].notation)
+    {
+      memset (bst_info.unit[id].notation, 0, sizeof (BSTJSON_NOTATION_t));
+      rv = bstjson_notation_build (id, &bst_info.unit[id].asic_capabilities,
+                                   bst_info.unit[id].notation);
+      if (BVIEW_STATUS_SUCCESS != rv)
+      {
+        /* the ports are translated while encoding till it is rebuilt */
+        LOG_POST (BVIEW_LOG_ERROR,
+                  "Failed to render the port notation of unit %d, err %d\r\n",
+                  id, rv);
+      }
+    }
+
+    /* the reports in percent divide every counter without these */
+    bst_info.unit[id].max_buf_reciprocals = (BSTJSON_MAX_BUF_RECIPROCALS_t *)
+      calloc (1, sizeof (BSTJSON_MAX_BUF_RECIPROCALS_t));
   }
 
   for (id = 0; id < num_units; id++)
   {
     memset (bst_info.unit[id].bst_data, 0, sizeof (BVIEW_BST_DATA_t));
-
-    memset (bst_info.unit[id].stats_active_record_ptr, 0,
-            sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
-    memset (bst_info.unit[id].stats_backup_record_ptr, 0,
-            sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
-    memset (bst_info.unit[id].stats_current_record_ptr, 0,
-            sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
-
-    memset (bst_info.unit[id].threshold_record_ptr, 0,
-            sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
   }
 
     bstjson_memory_init();
   LOG_POST (BVIEW_LOG_INFO,
               "bst application: bst memory allocated successfully\r\n");
 
+  /* the realms of large reports are encoded on the other cores,
+     they are encoded on the bst thread alone without the workers */
+  workers = sysconf (_SC_NPROCESSORS_ONLN) - 1;
+  if (workers > BVIEW_BST_DEFAULT_ENCODE_WORKERS)
+  {
+    workers = BVIEW_BST_DEFAULT_ENCODE_WORKERS;
+  }
+  if ((workers > 0) &&
+      (BVIEW_STATUS_SUCCESS != bstjson_parallel_init ((int) workers)))
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+              "Failed to start the report encoding workers\r\n");
+  }
+
   if (BVIEW_STATUS_SUCCESS != bst_app_config_init (num_units))
   {
     /* Free the resources allocated so far */
@@ -16,6 +16,7 @@
   *
   ***************************************************************************/
 
+#include <arpa/inet.h>
 #include "json.h"
 #include "bst_json_memory.h"
 #include "clear_bst_statistics.h"
@@ -27,6 +28,11 @@
 #include "get_bst_feature.h"
 #include "get_bst_thresholds.h"
 #include "get_bst_report.h"
+#include "get_bst_history.h"
+#include "configure_bst_subscription.h"
+#include "stream_bst_reports.h"
+#include "configure_bst_udp_export.h"
+#include "get_bst_histogram.h"
 #include "bst_json_encoder.h"
 #include "system.h"
 #include "bst.h"
@@ -205,6 +211,170 @@ BVIEW_STATUS bstjson_configure_bst_feature_impl (void *cookie, int asicId,
   return rv;
 }
 
+/*********************************************************************
+* @brief : REST API handler to configure a subscription to the
+*          periodic reports
+*
+* @param[in] cookie : pointer to the cookie
+* @param[in] asicId : asic id 
+* @param[in] id     : unit id
+* @param[in] pCommand : pointer to the input command structure
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the message is successfully posted to bst queue.
+* @retval  : BVIEW_STATUS_FAILURE : failed to post the message to bst.
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameter.
+*
+* @note    : This api posts the request to bst application to configure 
+*            the subscription. The collector of an enabled subscription
+*            must be an IPv4 address.
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS bstjson_configure_bst_subscription_impl (void *cookie, int asicId,
+                                                      int id,
+                                                      BSTJSON_CONFIGURE_BST_SUBSCRIPTION_t
+                                                      * pCommand)
+{
+  BVIEW_BST_REQUEST_MSG_t msg_data;
+  struct in_addr addr;
+  BVIEW_STATUS rv;
+
+  if (NULL == pCommand)
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  if ((0 != pCommand->enable) &&
+      (1 != inet_pton (AF_INET, pCommand->collectorIp, &addr)))
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+        "Invalid collector ip %s in request. \r\n", pCommand->collectorIp);
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  memset (&msg_data, 0, sizeof (BVIEW_BST_REQUEST_MSG_t));
+  msg_data.unit = asicId;
+  msg_data.cookie = cookie;
+  msg_data.msg_type = BVIEW_BST_CMD_API_SET_SUBSCRIPTION;
+  msg_data.id = id;
+  msg_data.request.subscription = *pCommand;
+
+  /* send message to bst application */
+  rv = bst_send_request (&msg_data);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+        "failed to post configure bst subscription to bst queue. err = %d.\r\n",rv);
+  }
+  return rv;
+}
+
+/*********************************************************************
+* @brief : REST API handler to configure the export of the samples
+*          in datagrams
+*
+* @param[in] cookie : pointer to the cookie
+* @param[in] asicId : asic id 
+* @param[in] id     : unit id
+* @param[in] pCommand : pointer to the input command structure
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the message is successfully posted to bst queue.
+* @retval  : BVIEW_STATUS_FAILURE : failed to post the message to bst.
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameter.
+*
+* @note    : This api posts the request to bst application to start,
+*            change or stop the export. The collector of an enabled
+*            export must be an IPv4 address.
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS bstjson_configure_bst_udp_export_impl (void *cookie, int asicId,
+                                                    int id,
+                                                    BSTJSON_CONFIGURE_BST_UDP_EXPORT_t
+                                                    * pCommand)
+{
+  BVIEW_BST_REQUEST_MSG_t msg_data;
+  struct in_addr addr;
+  BVIEW_STATUS rv;
+
+  if (NULL == pCommand)
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  if ((0 != pCommand->enable) &&
+      (1 != inet_pton (AF_INET, pCommand->collectorIp, &addr)))
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+        "Invalid collector ip %s in request. \r\n", pCommand->collectorIp);
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  memset (&msg_data, 0, sizeof (BVIEW_BST_REQUEST_MSG_t));
+  msg_data.unit = asicId;
+  msg_data.cookie = cookie;
+  msg_data.msg_type = BVIEW_BST_CMD_API_SET_UDP_EXPORT;
+  msg_data.id = id;
+  msg_data.request.udpExport = *pCommand;
+
+  /* send message to bst application */
+  rv = bst_send_request (&msg_data);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+        "failed to post configure bst udp export to bst queue. err = %d.\r\n",rv);
+  }
+  return rv;
+}
+
+/*********************************************************************
+* @brief : REST API handler to stream the bst reports
+*
+* @param[in] cookie : pointer to the cookie
+* @param[in] asicId : asic id 
+* @param[in] id     : unit id
+* @param[in] pCommand : pointer to the input command structure
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the message is successfully posted to bst queue.
+* @retval  : BVIEW_STATUS_FAILURE : failed to post the message to bst.
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameter.
+*
+* @note    : This api posts the request to bst application, which turns
+*            the connection into a stream of the periodic and trigger
+*            reports of the realms asked for.
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS bstjson_stream_bst_reports_impl (void *cookie, int asicId,
+                                              int id,
+                                              BSTJSON_STREAM_BST_REPORTS_t
+                                              * pCommand)
+{
+  BVIEW_BST_REQUEST_MSG_t msg_data;
+  BVIEW_STATUS rv;
+
+  if (NULL == pCommand)
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  memset (&msg_data, 0, sizeof (BVIEW_BST_REQUEST_MSG_t));
+  msg_data.unit = asicId;
+  msg_data.cookie = cookie;
+  msg_data.msg_type = BVIEW_BST_CMD_API_STREAM_REPORTS;
+  msg_data.id = id;
+  msg_data.request.stream = *pCommand;
+
+  /* send message to bst application */
+  rv = bst_send_request (&msg_data);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+        "failed to post stream bst reports to bst queue. err = %d.\r\n",rv);
+  }
+  return rv;
+}
+
 /*********************************************************************
 * @brief : REST API handler to configure the bst thresholds 
 *
@@ -609,6 +779,93 @@ BVIEW_STATUS bstjson_get_bst_report_impl (void *cookie, int asicId, int id,
   return rv;
 }
 
+/*********************************************************************
+* @brief : REST API handler to get the history of the bst stats
+*
+* @param[in] cookie : pointer to the cookie
+* @param[in] asicId : asic id 
+* @param[in] id     : unit id
+* @param[in] pCommand : pointer to the input command structure
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the message is successfully posted to bst queue.
+* @retval  : BVIEW_STATUS_FAILURE : failed to post the message to bst.
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameter.
+*
+* @note    : This api posts the request to bst application to get the 
+*            stats collected in the requested time range.
+*
+*********************************************************************/
+BVIEW_STATUS bstjson_get_bst_history_impl (void *cookie, int asicId, int id,
+                                           BSTJSON_GET_BST_HISTORY_t * pCommand)
+{
+  BVIEW_BST_REQUEST_MSG_t msg_data;
+  BVIEW_STATUS rv;
+
+  if (NULL == pCommand)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  memset (&msg_data, 0, sizeof (BVIEW_BST_REQUEST_MSG_t));
+  msg_data.unit = asicId;
+  msg_data.cookie = cookie;
+  msg_data.msg_type = BVIEW_BST_CMD_API_GET_HISTORY;
+  msg_data.id = id;
+  msg_data.request.history = *pCommand;
+
+  /* send message to bst application */
+  rv = bst_send_request (&msg_data);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+        "failed to post get bst history to bst queue. err = %d.\r\n",rv);
+  }
+  return rv;
+}
+
+/*********************************************************************
+* @brief : REST API handler to get the occupancy histograms of the
+*          bst stats
+*
+* @param[in] cookie : pointer to the cookie
+* @param[in] asicId : asic id 
+* @param[in] id     : unit id
+* @param[in] pCommand : pointer to the input command structure
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the message is successfully posted to bst queue.
+* @retval  : BVIEW_STATUS_FAILURE : failed to post the message to bst.
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameter.
+*
+* @note    : This api posts the request to bst application to get the 
+*            histograms accumulated over the current reporting interval.
+*
+*********************************************************************/
+BVIEW_STATUS bstjson_get_bst_histogram_impl (void *cookie, int asicId, int id,
+                                             BSTJSON_GET_BST_HISTOGRAM_t *
+                                             pCommand)
+{
+  BVIEW_BST_REQUEST_MSG_t msg_data;
+  BVIEW_STATUS rv;
+
+  if (NULL == pCommand)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  memset (&msg_data, 0, sizeof (BVIEW_BST_REQUEST_MSG_t));
+  msg_data.unit = asicId;
+  msg_data.cookie = cookie;
+  msg_data.msg_type = BVIEW_BST_CMD_API_GET_HISTOGRAM;
+  msg_data.id = id;
+
+  memcpy (&msg_data.request.collect, pCommand, sizeof(BSTJSON_GET_BST_HISTOGRAM_t));
+
+  /* send message to bst application */
+  rv = bst_send_request (&msg_data);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+        "failed to post get bst histogram to bst queue. err = %d.\r\n",rv);
+  }
+  return rv;
+}
+
 /*********************************************************************
 * @brief : REST API handler to get the bst threshold 
 *
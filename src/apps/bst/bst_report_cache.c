@@ -0,0 +1,407 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include "configure_bst_thresholds.h"
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+#include "get_bst_tracking.h"
+#include "get_bst_feature.h"
+#include "get_bst_thresholds.h"
+#include "get_bst_report.h"
+#include "get_bst_history.h"
+#include "bst_json_encoder.h"
+#include "bst_json_output.h"
+#include "bst.h"
+#include "broadview.h"
+#include "bst_app.h"
+#include "openapps_log_api.h"
+
+extern BVIEW_BST_CXT_t bst_info;
+
+/*********************************************************************
+* @brief : allocates the report cache of a unit
+*
+* @param[out] cache : newly allocated, empty cache
+*
+* @retval  : BVIEW_STATUS_SUCCESS : cache allocated
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+* @retval  : BVIEW_STATUS_RESOURCE_NOT_AVAILABLE : out of memory
+*
+* @note : the buffers of the entries are allocated as responses are
+*         stored. Release with bst_report_cache_free.
+*
+*********************************************************************/
+BVIEW_STATUS bst_report_cache_alloc (BVIEW_BST_REPORT_CACHE_t **cache)
+{
+  BVIEW_BST_REPORT_CACHE_t *ptr = NULL;
+
+  if (NULL == cache)
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  ptr = (BVIEW_BST_REPORT_CACHE_t *) malloc (sizeof (BVIEW_BST_REPORT_CACHE_t));
+  if (NULL == ptr)
+  {
+    *cache = NULL;
+    return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+  }
+  memset (ptr, 0, sizeof (BVIEW_BST_REPORT_CACHE_t));
+
+  *cache = ptr;
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : frees a cache allocated with bst_report_cache_alloc
+*
+* @param[in] cache : cache to be freed, may be NULL
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_report_cache_free (BVIEW_BST_REPORT_CACHE_t *cache)
+{
+  unsigned int i = 0;
+
+  if (NULL == cache)
+  {
+    return;
+  }
+
+  for (i = 0; i < BVIEW_BST_REPORT_CACHE_ENTRIES; i++)
+  {
+    free (cache->entry[i].data);
+  }
+  free (cache);
+}
+
+/*********************************************************************
+* @brief : drops every response of the cache
+*
+* @param[in] cache : cache of the unit, may be NULL
+*
+* @retval  : none
+*
+* @note : the buffers are kept for the next responses. Invoked when
+*         the configuration of the unit changes.
+*
+*********************************************************************/
+void bst_report_cache_invalidate (BVIEW_BST_REPORT_CACHE_t *cache)
+{
+  unsigned int i = 0;
+
+  if (NULL == cache)
+  {
+    return;
+  }
+
+  for (i = 0; i < BVIEW_BST_REPORT_CACHE_ENTRIES; i++)
+  {
+    cache->entry[i].valid = false;
+  }
+  cache->invalidations++;
+}
+
+/*********************************************************************
+* @brief : finds the response encoded for a poll
+*
+* @param[in] cache      : cache of the unit
+* @param[in] generation : stats generation of the unit
+* @param[in] options    : options of the report
+* @param[in] format     : format of the report
+*
+* @retval  : the entry holding the response, NULL if there is none
+*
+* @note : the options of a response are filled in a zeroed message,
+*         so that they compare as bytes. Every lookup counts as a hit
+*         or a miss.
+*
+*********************************************************************/
+const BVIEW_BST_REPORT_CACHE_ENTRY_t *
+bst_report_cache_lookup (BVIEW_BST_REPORT_CACHE_t *cache, uint64_t generation,
+                         const BVIEW_BST_REPORT_OPTIONS_t *options,
+                         BVIEW_REST_FORMAT_t format)
+{
+  BVIEW_BST_REPORT_CACHE_ENTRY_t *entry;
+  unsigned int i = 0;
+
+  if ((NULL == cache) || (NULL == options))
+  {
+    return NULL;
+  }
+
+  for (i = 0; i < BVIEW_BST_REPORT_CACHE_ENTRIES; i++)
+  {
+    entry = &cache->entry[i];
+    if ((true == entry->valid) && (generation == entry->generation) &&
+        (format == entry->format) &&
+        (0 == memcmp (&entry->options, options, sizeof (BVIEW_BST_REPORT_OPTIONS_t))))
+    {
+      entry->lastUsed = ++cache->uses;
+      cache->hits++;
+      return entry;
+    }
+  }
+
+  cache->misses++;
+  return NULL;
+}
+
+/*********************************************************************
+* @brief : starts storing the response encoded for a poll
+*
+* @param[in] cache      : cache of the unit
+* @param[in] generation : stats generation of the unit
+* @param[in] options    : options of the report
+* @param[in] format     : format of the report
+*
+* @retval  : the entry the response is appended to, NULL if it is
+*            not stored
+*
+* @note : an entry of an older generation, or else the one used
+*         least recently, is taken over. It is valid once
+*         bst_report_cache_store_end() sees the whole response.
+*
+*********************************************************************/
+BVIEW_BST_REPORT_CACHE_ENTRY_t *
+bst_report_cache_store_start (BVIEW_BST_REPORT_CACHE_t *cache, uint64_t generation,
+                              const BVIEW_BST_REPORT_OPTIONS_t *options,
+                              BVIEW_REST_FORMAT_t format)
+{
+  BVIEW_BST_REPORT_CACHE_ENTRY_t *entry = NULL, *ptr;
+  unsigned int i = 0;
+
+  if ((NULL == cache) || (NULL == options))
+  {
+    return NULL;
+  }
+
+  for (i = 0; i < BVIEW_BST_REPORT_CACHE_ENTRIES; i++)
+  {
+    ptr = &cache->entry[i];
+    if ((false == ptr->valid) || (generation != ptr->generation))
+    {
+      entry = ptr;
+      break;
+    }
+    if ((NULL == entry) || (ptr->lastUsed < entry->lastUsed))
+    {
+      entry = ptr;
+    }
+  }
+
+  entry->valid = false;
+  entry->generation = generation;
+  entry->format = format;
+  memcpy (&entry->options, options, sizeof (BVIEW_BST_REPORT_OPTIONS_t));
+  entry->length = 0;
+  entry->lastUsed = ++cache->uses;
+
+  return entry;
+}
+
+/*********************************************************************
+* @brief : appends a part of the response to the entry being stored
+*
+* @param[in] entry  : entry from bst_report_cache_store_start, may be NULL
+* @param[in] data   : part of the response
+* @param[in] length : number of bytes in data
+*
+* @retval  : none
+*
+* @note : a response which does not fit is not stored, it is sent
+*         all the same.
+*
+*********************************************************************/
+void bst_report_cache_store (BVIEW_BST_REPORT_CACHE_ENTRY_t *entry,
+                             const void *data, int length)
+{
+  uint8_t *buffer;
+  int size;
+
+  if ((NULL == entry) || (NULL == data) || (0 >= length) || (0 > entry->length))
+  {
+    return;
+  }
+
+  if (BVIEW_BST_REPORT_CACHE_MAX_SIZE - entry->length < length)
+  {
+    /* too large to be worth keeping */
+    entry->length = -1;
+    return;
+  }
+
+  if (entry->size - entry->length < length)
+  {
+    size = (0 == entry->size) ? BSTJSON_OUTPUT_WINDOW_SIZE : entry->size;
+    while (size - entry->length < length)
+    {
+      size *= 2;
+    }
+    if (size > BVIEW_BST_REPORT_CACHE_MAX_SIZE)
+    {
+      size = BVIEW_BST_REPORT_CACHE_MAX_SIZE;
+    }
+
+    buffer = (uint8_t *) realloc (entry->data, size);
+    if (NULL == buffer)
+    {
+      entry->length = -1;
+      return;
+    }
+    entry->data = buffer;
+    entry->size = size;
+  }
+
+  memcpy (entry->data + entry->length, data, length);
+  entry->length += length;
+}
+
+/*********************************************************************
+* @brief : ends storing a response
+*
+* @param[in] entry : entry from bst_report_cache_store_start, may be NULL
+* @param[in] rv    : outcome of encoding the response
+*
+* @retval  : none
+*
+* @note : the entry serves the next polls if the whole response is in.
+*
+*********************************************************************/
+void bst_report_cache_store_end (BVIEW_BST_REPORT_CACHE_ENTRY_t *entry,
+                                 BVIEW_STATUS rv)
+{
+  if (NULL == entry)
+  {
+    return;
+  }
+
+  entry->valid = ((BVIEW_STATUS_SUCCESS == rv) && (0 < entry->length));
+}
+
+/*********************************************************************
+* @brief : checks the max buffers percentages are reported against
+*
+* @param[in] cache      : cache of the unit
+* @param[in] maxBuffers : max buffers just read from the asic
+*
+* @retval  : true if they changed since the last check
+*
+* @note : the percentages of a cached response are only valid for
+*         the max buffers they were computed with.
+*
+*********************************************************************/
+bool bst_report_cache_max_buffers_changed (BVIEW_BST_REPORT_CACHE_t *cache,
+                                           const BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBuffers)
+{
+  if ((NULL == cache) || (NULL == maxBuffers))
+  {
+    return true;
+  }
+
+  if (0 == memcmp (&cache->maxBuffers, maxBuffers,
+                   sizeof (BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t)))
+  {
+    return false;
+  }
+
+  memcpy (&cache->maxBuffers, maxBuffers, sizeof (BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t));
+  return true;
+}
+
+/*********************************************************************
+* @brief : provides the counters of the cache
+*
+* @param[in]  cache : cache of the unit
+* @param[out] stats : counters of the cache
+*
+* @retval  : BVIEW_STATUS_SUCCESS : counters are filled in
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+*********************************************************************/
+BVIEW_STATUS bst_report_cache_stats_get (const BVIEW_BST_REPORT_CACHE_t *cache,
+                                         BVIEW_BST_REPORT_CACHE_STATS_t *stats)
+{
+  unsigned int i = 0;
+
+  if ((NULL == cache) || (NULL == stats))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  memset (stats, 0, sizeof (BVIEW_BST_REPORT_CACHE_STATS_t));
+  stats->hits = cache->hits;
+  stats->misses = cache->misses;
+  stats->invalidations = cache->invalidations;
+  for (i = 0; i < BVIEW_BST_REPORT_CACHE_ENTRIES; i++)
+  {
+    if (true == cache->entry[i].valid)
+    {
+      stats->entries++;
+      stats->bytes += cache->entry[i].length;
+    }
+  }
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : prints the counters of the report cache of a unit
+*
+* @param[in] unit : unit
+*
+* @retval  : BVIEW_STATUS_SUCCESS : counters are printed
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+*********************************************************************/
+BVIEW_STATUS bst_report_cache_dump (int unit)
+{
+  BVIEW_BST_REPORT_CACHE_STATS_t stats;
+  BVIEW_BST_UNIT_CXT_t *ptr;
+
+  BVIEW_STATUS rv;
+
+  if ((0 > unit) || (BVIEW_BST_MAX_UNITS <= unit))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  ptr = BST_UNIT_PTR_GET (unit);
+
+  BST_LOCK_TAKE (unit);
+  rv = bst_report_cache_stats_get (ptr->report_cache, &stats);
+  BST_LOCK_GIVE (unit);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    return rv;
+  }
+
+  printf (" Report Cache Statistics of unit %d \n\n", unit);
+  printf (" %12s %12s %14s %8s %10s\n",
+          "Hits", "Misses", "Invalidations", "Entries", "Bytes");
+  printf (" %12" PRIu64 " %12" PRIu64 " %14" PRIu64 " %8u %10u\n\n",
+          stats.hits, stats.misses, stats.invalidations, stats.entries, stats.bytes);
+
+  return BVIEW_STATUS_SUCCESS;
+}
@@ -0,0 +1,269 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "configure_bst_thresholds.h"
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+#include "get_bst_tracking.h"
+#include "get_bst_feature.h"
+#include "get_bst_thresholds.h"
+#include "get_bst_report.h"
+#include "get_bst_history.h"
+#include "bst_json_encoder.h"
+#include "bst.h"
+#include "bst_shm.h"
+#include "broadview.h"
+#include "bst_app.h"
+#include "openapps_log_api.h"
+#include "system.h"
+
+extern BVIEW_BST_CXT_t bst_info;
+
+/* the region is readable by the agent's group only, the collectors
+   reading it are expected to run in that group */
+#define _BST_SHM_MODE  0640
+
+/* the data starts on a cache line of its own */
+#define _BST_SHM_DATA_OFFSET  \
+        ((sizeof (BVIEW_BST_SHM_HEADER_t) + BVIEW_BST_SNAPSHOT_ALIGN - 1) & \
+         ~((size_t) BVIEW_BST_SNAPSHOT_ALIGN - 1))
+
+/*********************************************************************
+* @brief : creates the shared memory region of a unit
+*
+* @param[in]  unit   : unit the region is created for
+* @param[in]  layout : layout of the snapshots of the unit
+* @param[out] shm    : region, mapped and described, without a snapshot
+*
+* @retval  : BVIEW_STATUS_SUCCESS : region created
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+* @retval  : BVIEW_STATUS_RESOURCE_NOT_AVAILABLE : out of memory
+* @retval  : BVIEW_STATUS_FAILURE : the region could not be created
+*
+* @note : a region left behind by an earlier run is replaced, readers
+*         still mapping it find it retired. Release with bst_shm_close.
+*
+*********************************************************************/
+BVIEW_STATUS bst_shm_open (int unit, const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout,
+                           BVIEW_BST_SHM_t **shm)
+{
+  BVIEW_BST_SHM_t *ptr = NULL;
+  BVIEW_BST_SHM_HEADER_t *header;
+  void *map;
+  size_t size;
+  unsigned int i = 0;
+  int fd;
+
+  if ((NULL == layout) || (NULL == shm) ||
+      (BVIEW_BST_SNAPSHOT_REALM_MAX > BVIEW_BST_SHM_MAX_REALMS))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  *shm = NULL;
+
+  ptr = (BVIEW_BST_SHM_t *) malloc (sizeof (BVIEW_BST_SHM_t));
+  if (NULL == ptr)
+  {
+    return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+  }
+  memset (ptr, 0, sizeof (BVIEW_BST_SHM_t));
+  snprintf (ptr->name, sizeof (ptr->name), BVIEW_BST_SHM_NAME_FORMAT, unit);
+
+  size = _BST_SHM_DATA_OFFSET + layout->size;
+
+  /* never hand out a region of an earlier run */
+  shm_unlink (ptr->name);
+  fd = shm_open (ptr->name, O_CREAT | O_EXCL | O_RDWR, _BST_SHM_MODE);
+  if (-1 == fd)
+  {
+    free (ptr);
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  if (0 != ftruncate (fd, (off_t) size))
+  {
+    close (fd);
+    shm_unlink (ptr->name);
+    free (ptr);
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  map = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  /* the mapping stays valid without the descriptor */
+  close (fd);
+  if (MAP_FAILED == map)
+  {
+    shm_unlink (ptr->name);
+    free (ptr);
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  /* the region is zero filled, describe the layout */
+  header = (BVIEW_BST_SHM_HEADER_t *) map;
+  header->version = BVIEW_BST_SHM_VERSION;
+  header->headerSize = sizeof (BVIEW_BST_SHM_HEADER_t);
+  header->unit = unit;
+  header->dataOffset = _BST_SHM_DATA_OFFSET;
+
+  header->layout.numPorts = layout->numPorts;
+  header->layout.numPriorityGroups = layout->numPriorityGroups;
+  header->layout.numIngressServicePools = layout->numIngressServicePools;
+  header->layout.numServicePools = layout->numServicePools;
+  header->layout.numUnicastQueues = layout->numUnicastQueues;
+  header->layout.numUnicastQueueGroups = layout->numUnicastQueueGroups;
+  header->layout.numMulticastQueues = layout->numMulticastQueues;
+  header->layout.numCpuQueues = layout->numCpuQueues;
+  header->layout.numRqeQueues = layout->numRqeQueues;
+  header->layout.realms = BVIEW_BST_SNAPSHOT_REALM_MAX;
+  for (i = 0; i < BVIEW_BST_SNAPSHOT_REALM_MAX; i++)
+  {
+    header->layout.entries[i] = layout->entries[i];
+    header->layout.entrySize[i] = layout->entrySize[i];
+    header->layout.offset[i] = layout->offset[i];
+  }
+  header->layout.size = layout->size;
+
+  /* readers trust the descriptor once the magic is there */
+  __atomic_store_n (&header->magic, BVIEW_BST_SHM_MAGIC, __ATOMIC_RELEASE);
+
+  ptr->header = header;
+  ptr->size = size;
+
+  *shm = ptr;
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : removes the shared memory region of a unit
+*
+* @param[in] shm : region to be removed, may be NULL
+*
+* @retval  : none
+*
+* @note : readers still mapping the region find it retired.
+*
+*********************************************************************/
+void bst_shm_close (BVIEW_BST_SHM_t *shm)
+{
+  if (NULL == shm)
+  {
+    return;
+  }
+
+  __atomic_store_n (&shm->header->magic, 0, __ATOMIC_RELEASE);
+  munmap (shm->header, shm->size);
+  shm_unlink (shm->name);
+  free (shm);
+}
+
+/*********************************************************************
+* @brief : creates or removes the shared memory region of a unit as
+*          the bst_shm_publish property of the agent asks
+*
+* @param[in] unit : unit the region is checked for
+*
+* @retval  : none
+*
+* @note : called from the bst context with the unit lock held. A region
+*         which could not be created is tried again once the property
+*         is turned off and on.
+*
+*********************************************************************/
+void bst_shm_config_apply (unsigned int unit)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr;
+  bool publish = SYSTEM_CONFIG_PROPERTY_BST_SHM_PUBLISH_DEFAULT;
+
+  ptr = BST_UNIT_PTR_GET (unit);
+
+  (void) system_agent_bst_shm_publish_get (&publish);
+  if (publish == ptr->shm_publish)
+  {
+    return;
+  }
+  ptr->shm_publish = publish;
+
+  if (false == publish)
+  {
+    bst_shm_close (ptr->shm);
+    ptr->shm = NULL;
+    return;
+  }
+
+  /* the agent works without the region as well */
+  if (BVIEW_STATUS_SUCCESS != bst_shm_open (unit, &ptr->snapshot_layout, &ptr->shm))
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+              "Failed to create the shared memory region for unit %d\r\n", unit);
+  }
+}
+
+/*********************************************************************
+* @brief : publishes a stats record in the shared memory region
+*
+* @param[in] shm    : region of the unit, may be NULL
+* @param[in] record : stats record to be published
+*
+* @retval  : BVIEW_STATUS_SUCCESS : record published, or no region
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+* @note : called from the bst context only, so there is a single writer.
+*
+*********************************************************************/
+BVIEW_STATUS bst_shm_publish (BVIEW_BST_SHM_t *shm,
+                              const BVIEW_BST_REPORT_SNAPSHOT_t *record)
+{
+  BVIEW_BST_SHM_HEADER_t *header;
+
+  if (NULL == shm)
+  {
+    return BVIEW_STATUS_SUCCESS;
+  }
+
+  if ((NULL == record) || (NULL == record->snapshot_data.data) ||
+      (NULL == record->snapshot_data.layout) ||
+      (record->snapshot_data.layout->size != shm->header->layout.size))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  header = shm->header;
+
+  __atomic_store_n (&header->seq, header->seq + 1, __ATOMIC_RELAXED);
+  /* odd sequence must be visible before any of the data */
+  __atomic_thread_fence (__ATOMIC_SEQ_CST);
+
+  memcpy (BVIEW_BST_SHM_DATA (header), record->snapshot_data.data,
+          header->layout.size);
+  header->generation++;
+  header->time = (int64_t) record->tv;
+
+  __atomic_store_n (&header->seq, header->seq + 1, __ATOMIC_RELEASE);
+
+  return BVIEW_STATUS_SUCCESS;
+}
@@ -0,0 +1,357 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "configure_bst_thresholds.h"
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+#include "get_bst_tracking.h"
+#include "get_bst_feature.h"
+#include "get_bst_thresholds.h"
+#include "get_bst_report.h"
+#include "get_bst_history.h"
+#include "bst_json_encoder.h"
+#include "bst.h"
+#include "broadview.h"
+#include "bst_app.h"
+#include "system.h"
+#include "openapps_log_api.h"
+#include "sbplugin_redirect_bst.h"
+
+/* clamp a capability to the compile time limit of its realm */
+#define _BST_SNAPSHOT_DIM(_val, _max)   (((_val) > (_max)) ? (_max) : (_val))
+
+/*********************************************************************
+* @brief : computes the snapshot layout of a unit from its capabilities
+*
+* @param[in]  asic : asic capabilities of the unit
+* @param[out] layout : layout of the snapshot records of the unit
+*
+* @retval  : BVIEW_STATUS_SUCCESS : layout computed
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+* @note : every realm gets exactly as many entries as the asic reports,
+*         clamped to the BVIEW_ASIC_MAX_* limits, and starts on a
+*         cache line boundary.
+*
+*********************************************************************/
+BVIEW_STATUS bst_snapshot_layout_init (const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                       BVIEW_BST_SNAPSHOT_LAYOUT_t *layout)
+{
+  unsigned int realm = 0;
+  size_t offset = 0;
+
+  if ((NULL == asic) || (NULL == layout))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  memset (layout, 0, sizeof (BVIEW_BST_SNAPSHOT_LAYOUT_t));
+
+  layout->numPorts = _BST_SNAPSHOT_DIM (asic->numPorts, BVIEW_ASIC_MAX_PORTS);
+  layout->numPriorityGroups =
+    _BST_SNAPSHOT_DIM (asic->numPriorityGroups, BVIEW_ASIC_MAX_PRIORITY_GROUPS);
+  layout->numIngressServicePools =
+    _BST_SNAPSHOT_DIM (asic->numServicePools + asic->numCommonPools,
+                       BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS);
+  layout->numServicePools =
+    _BST_SNAPSHOT_DIM (asic->numServicePools, BVIEW_ASIC_MAX_SERVICE_POOLS);
+  layout->numUnicastQueues =
+    _BST_SNAPSHOT_DIM (asic->numUnicastQueues, BVIEW_ASIC_MAX_UC_QUEUES);
+  layout->numUnicastQueueGroups =
+    _BST_SNAPSHOT_DIM (asic->numUnicastQueueGroups, BVIEW_ASIC_MAX_UC_QUEUE_GROUPS);
+  layout->numMulticastQueues =
+    _BST_SNAPSHOT_DIM (asic->numMulticastQueues, BVIEW_ASIC_MAX_MC_QUEUES);
+  layout->numCpuQueues =
+    _BST_SNAPSHOT_DIM (asic->numCpuQueues, BVIEW_ASIC_MAX_CPU_QUEUES);
+  layout->numRqeQueues =
+    _BST_SNAPSHOT_DIM (asic->numRqeQueues, BVIEW_ASIC_MAX_RQE_QUEUES);
+
+  layout->entries[BVIEW_BST_SNAPSHOT_DEVICE] = 1;
+  layout->entrySize[BVIEW_BST_SNAPSHOT_DEVICE] = sizeof (BVIEW_BST_DEVICE_DATA_t);
+
+  layout->entries[BVIEW_BST_SNAPSHOT_IPPG] = layout->numPorts * layout->numPriorityGroups;
+  layout->entrySize[BVIEW_BST_SNAPSHOT_IPPG] = sizeof (BVIEW_BST_INGRESS_PORT_PG_ENTRY_t);
+
+  layout->entries[BVIEW_BST_SNAPSHOT_IPSP] = layout->numPorts * layout->numIngressServicePools;
+  layout->entrySize[BVIEW_BST_SNAPSHOT_IPSP] = sizeof (BVIEW_BST_INGRESS_PORT_SP_ENTRY_t);
+
+  layout->entries[BVIEW_BST_SNAPSHOT_ISP] = layout->numIngressServicePools;
+  layout->entrySize[BVIEW_BST_SNAPSHOT_ISP] = sizeof (BVIEW_BST_INGRESS_SP_ENTRY_t);
+
+  layout->entries[BVIEW_BST_SNAPSHOT_EPSP] = layout->numPorts * layout->numServicePools;
+  layout->entrySize[BVIEW_BST_SNAPSHOT_EPSP] = sizeof (BVIEW_BST_EGRESS_PORT_SP_ENTRY_t);
+
+  layout->entries[BVIEW_BST_SNAPSHOT_ESP] = layout->numServicePools;
+  layout->entrySize[BVIEW_BST_SNAPSHOT_ESP] = sizeof (BVIEW_BST_EGRESS_SP_ENTRY_t);
+
+  layout->entries[BVIEW_BST_SNAPSHOT_EUCQ] = layout->numUnicastQueues;
+  layout->entrySize[BVIEW_BST_SNAPSHOT_EUCQ] = sizeof (BVIEW_BST_EGRESS_UC_QUEUE_ENTRY_t);
+
+  layout->entries[BVIEW_BST_SNAPSHOT_EUCQG] = layout->numUnicastQueueGroups;
+  layout->entrySize[BVIEW_BST_SNAPSHOT_EUCQG] = sizeof (BVIEW_BST_EGRESS_UC_QUEUEGROUPS_ENTRY_t);
+
+  layout->entries[BVIEW_BST_SNAPSHOT_EMCQ] = layout->numMulticastQueues;
+  layout->entrySize[BVIEW_BST_SNAPSHOT_EMCQ] = sizeof (BVIEW_BST_EGRESS_MC_QUEUE_ENTRY_t);
+
+  layout->entries[BVIEW_BST_SNAPSHOT_CPUQ] = layout->numCpuQueues;
+  layout->entrySize[BVIEW_BST_SNAPSHOT_CPUQ] = sizeof (BVIEW_BST_EGRESS_CPU_QUEUE_ENTRY_t);
+
+  layout->entries[BVIEW_BST_SNAPSHOT_RQEQ] = layout->numRqeQueues;
+  layout->entrySize[BVIEW_BST_SNAPSHOT_RQEQ] = sizeof (BVIEW_BST_EGRESS_RQE_QUEUE_ENTRY_t);
+
+  /* place the realms back to back, each one on its own cache line */
+  for (realm = 0; realm < BVIEW_BST_SNAPSHOT_REALM_MAX; realm++)
+  {
+    layout->offset[realm] = offset;
+    offset += _BVIEW_BST_SNAPSHOT_PAD (layout->entries[realm] * layout->entrySize[realm]);
+  }
+  layout->size = offset;
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : drops the published snapshot a record refers to
+*
+* @param[in] record : record
+*
+* @retval  : none
+*
+* @note : the record falls back to its own buffer.
+*
+*********************************************************************/
+void bst_snapshot_release (BVIEW_BST_REPORT_SNAPSHOT_t *record)
+{
+  if ((NULL == record) || (NULL == record->published))
+  {
+    return;
+  }
+
+  sbapi_bst_snapshot_published_put (record->unit, record->published);
+  record->published = NULL;
+  record->snapshot_data.data = record->buffer;
+}
+
+/*********************************************************************
+* @brief : allocates a stats/threshold record for the given layout
+*
+* @param[in]  unit   : unit the record collects data of
+* @param[in]  layout : layout of the snapshot
+* @param[out] record : newly allocated, zeroed record
+*
+* @retval  : BVIEW_STATUS_SUCCESS : record allocated
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+* @retval  : BVIEW_STATUS_RESOURCE_NOT_AVAILABLE : out of memory
+*
+* @note : the snapshot data is a single cache line aligned block of
+*         layout->size bytes. Release with bst_snapshot_free.
+*
+*********************************************************************/
+BVIEW_STATUS bst_snapshot_alloc (int unit, const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout,
+                                 BVIEW_BST_REPORT_SNAPSHOT_t **record)
+{
+  BVIEW_BST_REPORT_SNAPSHOT_t *ptr = NULL;
+  void *data = NULL;
+
+  if ((NULL == layout) || (NULL == record))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  *record = NULL;
+
+  ptr = (BVIEW_BST_REPORT_SNAPSHOT_t *) malloc (sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
+  if (NULL == ptr)
+  {
+    return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+  }
+
+  /* a zero sized layout still gets a valid, aligned block */
+  if (0 != posix_memalign (&data, BVIEW_BST_SNAPSHOT_ALIGN,
+                           (0 == layout->size) ? BVIEW_BST_SNAPSHOT_ALIGN : layout->size))
+  {
+    free (ptr);
+    return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+  }
+
+  memset (ptr, 0, sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
+  ptr->unit = unit;
+  ptr->buffer = (uint8_t *) data;
+  ptr->snapshot_data.layout = layout;
+  ptr->snapshot_data.data = ptr->buffer;
+  memset (ptr->snapshot_data.data, 0, layout->size);
+
+  *record = ptr;
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : frees a record allocated with bst_snapshot_alloc
+*
+* @param[in] record : record to be freed, may be NULL
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_snapshot_free (BVIEW_BST_REPORT_SNAPSHOT_t *record)
+{
+  if (NULL == record)
+  {
+    return;
+  }
+
+  bst_snapshot_release (record);
+  free (record->buffer);
+  free (record);
+}
+
+/*********************************************************************
+* @brief : clears the time stamp and the data of a record
+*
+* @param[in] record : record to be cleared
+*
+* @retval  : none
+*
+* @note : only the layout->size bytes in use are touched.
+*
+*********************************************************************/
+void bst_snapshot_clear (BVIEW_BST_REPORT_SNAPSHOT_t *record)
+{
+  if ((NULL == record) || (NULL == record->snapshot_data.layout))
+  {
+    return;
+  }
+
+  bst_snapshot_release (record);
+  memset (&record->tv, 0, sizeof (record->tv));
+  record->generation = 0;
+  memset (record->snapshot_data.data, 0, record->snapshot_data.layout->size);
+}
+
+/*********************************************************************
+* @brief : collects the current stats of the unit into a record
+*
+* @param[in] record : stats record to be filled
+*
+* @retval  : BVIEW_STATUS_SUCCESS : record holds the current stats
+* @retval  : other : failure returned by the south bound
+*
+* @note : when the south bound publishes snapshots, the record just
+*         references the latest one and nothing is copied. Otherwise
+*         the record's own buffer is refreshed with the counters which
+*         changed since its last collection.
+*
+*********************************************************************/
+BVIEW_STATUS bst_snapshot_collect (BVIEW_BST_REPORT_SNAPSHOT_t *record)
+{
+  const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *published = NULL;
+  BVIEW_STATUS rv;
+
+  if ((NULL == record) || (NULL == record->snapshot_data.layout))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  /* whatever the record referred to is superseded now */
+  bst_snapshot_release (record);
+
+  rv = sbapi_bst_snapshot_published_get (record->unit, &published, &record->tv);
+  if (BVIEW_STATUS_SUCCESS == rv)
+  {
+    /* the published data is never modified while referenced */
+    record->published = published;
+    record->snapshot_data.data = published->data;
+    return BVIEW_STATUS_SUCCESS;
+  }
+
+  /* nothing published (yet), refresh the own buffer in place */
+  rv = sbapi_bst_snapshot_incremental_get (record->unit, &record->snapshot_data,
+                                           &record->tv, &record->generation);
+  if (BVIEW_STATUS_UNSUPPORTED == rv)
+  {
+    /* before we collect data..ensure there is no garbage.. */
+    bst_snapshot_clear (record);
+    rv = sbapi_bst_snapshot_get (record->unit, &record->snapshot_data, &record->tv);
+  }
+  else if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    /* contents are unknown, force a full copy next time */
+    record->generation = 0;
+  }
+  return rv;
+}
+
+/*********************************************************************
+* @brief : whether two stats records hold the same stats
+*
+* @param[in] record : record
+* @param[in] other  : record to compare with
+*
+* @retval  : true if both refer to the same published snapshot
+*
+* @note : a published snapshot is not refilled while a record refers
+*         to it, so records referring to it hold the same stats. A
+*         record which copied its stats is never known to be the same
+*         as another one.
+*
+*********************************************************************/
+bool bst_snapshot_same (const BVIEW_BST_REPORT_SNAPSHOT_t *record,
+                        const BVIEW_BST_REPORT_SNAPSHOT_t *other)
+{
+  if ((NULL == record) || (NULL == other) || (NULL == record->published))
+  {
+    return false;
+  }
+
+  return ((record->published == other->published) &&
+          (0 == memcmp (&record->tv, &other->tv, sizeof (record->tv))));
+}
+
+/*********************************************************************
+* @brief : copies the stats of a record into another one
+*
+* @param[in]  src : record holding the stats
+* @param[out] dst : record to be filled, of the same layout
+*
+* @retval  : BVIEW_STATUS_SUCCESS : dst holds the stats of src
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+* @note : dst keeps the stats in its own buffer, so that it does not
+*         hold on to a published snapshot of the south bound.
+*
+*********************************************************************/
+BVIEW_STATUS bst_snapshot_copy (BVIEW_BST_REPORT_SNAPSHOT_t *dst,
+                                const BVIEW_BST_REPORT_SNAPSHOT_t *src)
+{
+  if ((NULL == dst) || (NULL == src) || (NULL == src->snapshot_data.layout) ||
+      (dst->snapshot_data.layout != src->snapshot_data.layout))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  bst_snapshot_release (dst);
+  memcpy (dst->buffer, src->snapshot_data.data, src->snapshot_data.layout->size);
+  dst->tv = src->tv;
+  /* the south bound did not fill the copy, it is refreshed in full */
+  dst->generation = 0;
+  return BVIEW_STATUS_SUCCESS;
+}
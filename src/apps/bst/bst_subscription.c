@@ -0,0 +1,598 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "bst_json_memory.h"
+#include "configure_bst_thresholds.h"
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+#include "get_bst_tracking.h"
+#include "get_bst_feature.h"
+#include "get_bst_thresholds.h"
+#include "get_bst_report.h"
+#include "get_bst_history.h"
+#include "bst_json_encoder.h"
+#include "bst_cbor_encoder.h"
+#include "bst.h"
+#include "broadview.h"
+#include "bst_app.h"
+#include "system.h"
+#include "rest_api.h"
+#include "openapps_log_api.h"
+
+extern BVIEW_BST_CXT_t bst_info;
+
+/*********************************************************************
+* @brief : drops the reference of a subscription to its baseline
+*
+* @param[in] subscription : subscription
+*
+* @retval  : none
+*
+* @note : the baseline is kept for reuse once no subscription refers
+*         to it.
+*
+*********************************************************************/
+static void bst_subscription_baseline_put (BVIEW_BST_SUBSCRIPTION_t *subscription)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr = BST_UNIT_PTR_GET (subscription->unit);
+
+  if ((0 <= subscription->baseline) &&
+      (0 < ptr->subscription_baseline[subscription->baseline].refs))
+  {
+    ptr->subscription_baseline[subscription->baseline].refs--;
+  }
+  subscription->baseline = -1;
+}
+
+/*********************************************************************
+* @brief : whether two subscriptions get the same report
+*
+* @param[in] a : subscription
+* @param[in] b : subscription due at the same time, of the same unit
+*
+* @retval  : true if the report encoded for one of them serves the other
+*
+*********************************************************************/
+static bool bst_subscription_same_report (const BVIEW_BST_SUBSCRIPTION_t *a,
+                                          const BVIEW_BST_SUBSCRIPTION_t *b)
+{
+  if ((a->config.format != b->config.format) ||
+      (a->config.realmMask != b->config.realmMask) ||
+      (a->config.sendIncrementalReport != b->config.sendIncrementalReport))
+  {
+    return false;
+  }
+
+  /* the changes are reported against the same stats */
+  return ((0 == a->config.sendIncrementalReport) || (a->baseline == b->baseline));
+}
+
+/*********************************************************************
+* @brief : starts or stops checking for due subscriptions of a unit
+*
+* @param[in] unit : unit
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the timer runs while needed
+* @retval  : other : the timer could not be started or stopped
+*
+*********************************************************************/
+static BVIEW_STATUS bst_subscription_timer_update (int unit)
+{
+  BVIEW_BST_DATA_t *bst_data_ptr = BST_UNIT_DATA_PTR_GET (unit);
+  BVIEW_BST_TIMER_t *timer;
+  BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
+  bool needed = false;
+  int id;
+
+  if (NULL == bst_data_ptr)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  timer = &bst_data_ptr->bst_subscription_timer;
+
+  for (id = 0; id < BVIEW_BST_MAX_SUBSCRIPTIONS; id++)
+  {
+    if ((0 != bst_info.subscription[id].config.enable) &&
+        (unit == bst_info.subscription[id].unit))
+    {
+      needed = true;
+    }
+  }
+
+  if ((true == needed) && (false == timer->in_use))
+  {
+    rv = system_timer_add (bst_subscription_cb, &timer->bstTimer,
+                           BVIEW_BST_SUBSCRIPTION_TICK, PERIODIC_MODE, &timer->unit);
+    if (BVIEW_STATUS_SUCCESS == rv)
+    {
+      timer->in_use = true;
+    }
+    else
+    {
+      LOG_POST (BVIEW_LOG_ERROR,
+          "Failed to add subscription timer for unit %d, err %d\r\n", unit, rv);
+    }
+  }
+  else if ((false == needed) && (true == timer->in_use))
+  {
+    rv = system_timer_delete (timer->bstTimer);
+    if (BVIEW_STATUS_SUCCESS == rv)
+    {
+      timer->in_use = false;
+    }
+    else
+    {
+      LOG_POST (BVIEW_LOG_ERROR,
+          "Failed to delete subscription timer for unit %d, err %d\r\n", unit, rv);
+    }
+  }
+  return rv;
+}
+
+/*********************************************************************
+* @brief : application function to configure a subscription to the
+*          periodic reports
+*
+* @param[in] msg_data : pointer to the bst message request.
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the subscription is configured
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameter.
+* @retval  : other : the collector of the subscription could not be set
+*
+* @note : a reconfigured subscription starts over, its first report
+*         is due an interval later and it is not incremental.
+*
+*********************************************************************/
+BVIEW_STATUS bst_subscription_set (BVIEW_BST_REQUEST_MSG_t *msg_data)
+{
+  BVIEW_BST_SUBSCRIPTION_CONFIG_t *config;
+  BVIEW_BST_SUBSCRIPTION_t *subscription;
+  BVIEW_STATUS rv;
+  int oldUnit;
+
+  if (NULL == msg_data)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  config = &msg_data->request.subscription;
+  if ((0 > config->subscriptionId) ||
+      (BVIEW_BST_MAX_SUBSCRIPTIONS <= config->subscriptionId))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  subscription = &bst_info.subscription[config->subscriptionId];
+  oldUnit = subscription->unit;
+
+  if (0 != subscription->config.enable)
+  {
+    bst_subscription_baseline_put (subscription);
+  }
+
+  /* the collector goes first, the subscription is off if it fails */
+  rv = rest_subscriber_set (config->subscriptionId,
+                            (0 != config->enable) ? config->collectorIp : "",
+                            config->collectorPort);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+        "Failed to set the collector of subscription %d, err %d\r\n",
+        config->subscriptionId, rv);
+    subscription->config.enable = 0;
+    (void) rest_subscriber_set (config->subscriptionId, "", 0);
+  }
+  else
+  {
+    subscription->config = *config;
+    subscription->unit = msg_data->unit;
+    subscription->baseline = -1;
+    subscription->nextDue = time (NULL) + config->collectionInterval;
+  }
+
+  if (oldUnit != msg_data->unit)
+  {
+    (void) bst_subscription_timer_update (oldUnit);
+  }
+  /* a subscription turned off above may have been the last of the unit,
+     the timer is updated either way and the collector error kept */
+  if (BVIEW_STATUS_SUCCESS == rv)
+  {
+    rv = bst_subscription_timer_update (msg_data->unit);
+  }
+  else
+  {
+    (void) bst_subscription_timer_update (msg_data->unit);
+  }
+  return rv;
+}
+
+/*********************************************************************
+* @brief : encodes a report once and sends it to subscribers
+*
+* @param[in] unit        : unit
+* @param[in] subscription : subscription the report is encoded for
+* @param[in] subscribers : mask of the subscriptions it goes to
+* @param[in] record      : stats being reported
+*
+* @retval  : BVIEW_STATUS_SUCCESS : report sent
+* @retval  : other : encoding or sending the report failed
+*
+* @note : Invoked with the unit lock held, and the max buffers read
+*         again for a report in percent.
+*
+*********************************************************************/
+static BVIEW_STATUS bst_subscription_report (int unit,
+                                             const BVIEW_BST_SUBSCRIPTION_t *subscription,
+                                             unsigned int subscribers,
+                                             BVIEW_BST_REPORT_SNAPSHOT_t *record)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr = BST_UNIT_PTR_GET (unit);
+  BVIEW_BST_CONFIG_PARAMS_t *config = BST_CONFIG_FEATURE_PTR_GET (unit);
+  const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous = NULL;
+  BVIEW_BST_REPORT_OPTIONS_t options;
+  BVIEW_BST_TRACK_PARAMS_t realms;
+  BVIEW_BST_REPORT_STREAM_t report;
+  BVIEW_REST_FORMAT_t format = subscription->config.format;
+  unsigned int kind = BVIEW_REST_REPORT_KIND_NONE;
+  uint8_t *pBuffer = NULL;
+  int length = 0;
+  BVIEW_STATUS rv;
+
+  memset (&options, 0, sizeof (options));
+  memset (&realms, 0, sizeof (realms));
+
+  /* the realms of the subscription */
+  bst_mask_to_realm (subscription->config.realmMask, &realms);
+  BST_COPY_TRACK_TO_COLLECT (&realms, &options);
+
+  options.statUnitsInCells = config->statUnitsInCells;
+  options.statsInPercentage = config->statsInPercentage;
+  options.bst_max_buffers_ptr = &ptr->bst_max_buffers;
+  options.bst_max_buffers_reciprocals = ptr->max_buf_reciprocals;
+  options.notation = ptr->notation;
+  /* an incremental report skips the zero counters until there are
+     stats to report the changes against */
+  options.sendIncrementalReport = (0 != subscription->config.sendIncrementalReport);
+  if ((true == options.sendIncrementalReport) && (0 <= subscription->baseline))
+  {
+    previous = &ptr->subscription_baseline[subscription->baseline].record->snapshot_data;
+  }
+  /* a complete report replaces the one still queued for the collector */
+  if (false == options.sendIncrementalReport)
+  {
+    kind = BVIEW_BST_REPORT_KIND (unit);
+  }
+
+  if (BVIEW_BST_DEFAULT_STREAM_REPORTS)
+  {
+    /* the report goes out while it is encoded */
+    report.cache = NULL;
+    rv = rest_report_stream_open (subscribers, kind, format, &report.stream);
+    if ((BVIEW_STATUS_SUCCESS == rv) && (BVIEW_REST_FORMAT_CBOR == format))
+    {
+      rv = bstcbor_encode_get_bst_report_stream (unit, BVIEW_BST_CMD_API_GET_REPORT,
+                                                 previous, &record->snapshot_data,
+                                                 &options, &ptr->asic_capabilities,
+                                                 &record->tv,
+                                                 bst_report_stream_flush, &report);
+    }
+    else if (BVIEW_STATUS_SUCCESS == rv)
+    {
+      rv = bstjson_encode_get_bst_report_stream (unit, BVIEW_BST_CMD_API_GET_REPORT,
+                                                 previous, &record->snapshot_data,
+                                                 &options, &ptr->asic_capabilities,
+                                                 &record->tv,
+                                                 bst_report_stream_flush, &report);
+    }
+    return rest_response_stream_close (&report.stream, rv, 0);
+  }
+
+  if (BVIEW_REST_FORMAT_CBOR == format)
+  {
+    rv = bstcbor_encode_get_bst_report (unit, BVIEW_BST_CMD_API_GET_REPORT,
+                                        previous, &record->snapshot_data,
+                                        &options, &ptr->asic_capabilities,
+                                        &record->tv, &pBuffer, &length);
+  }
+  else
+  {
+    rv = bstjson_encode_get_bst_report (unit, BVIEW_BST_CMD_API_GET_REPORT,
+                                        previous, &record->snapshot_data,
+                                        &options, &ptr->asic_capabilities,
+                                        &record->tv, &pBuffer);
+    if (BVIEW_STATUS_SUCCESS == rv)
+    {
+      length = strlen ((char *) pBuffer);
+    }
+  }
+
+  if (BVIEW_STATUS_SUCCESS == rv)
+  {
+    rv = rest_report_send (subscribers, kind, (char *) pBuffer, length, format);
+  }
+  if (NULL != pBuffer)
+  {
+    bstjson_memory_free (pBuffer);
+  }
+  return rv;
+}
+
+/*********************************************************************
+* @brief : keeps the stats just reported as the baseline of the
+*          incremental subscriptions which got them
+*
+* @param[in] unit        : unit
+* @param[in] subscribers : mask of the incremental subscriptions
+* @param[in] record      : stats just reported
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the subscriptions refer to the stats
+* @retval  : BVIEW_STATUS_RESOURCE_NOT_AVAILABLE : out of memory, their
+*            next reports are not incremental
+*
+* @note : the stats are copied once for all of them. Invoked with the
+*         unit lock held.
+*
+*********************************************************************/
+static BVIEW_STATUS bst_subscription_baseline_set (int unit, unsigned int subscribers,
+                                                   BVIEW_BST_REPORT_SNAPSHOT_t *record)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr = BST_UNIT_PTR_GET (unit);
+  BVIEW_BST_SUBSCRIPTION_BASELINE_t *baseline = NULL;
+  int id, slot = -1;
+
+  /* the old stats are not needed any more */
+  for (id = 0; id < BVIEW_BST_MAX_SUBSCRIPTIONS; id++)
+  {
+    if (0 != (subscribers & (1 << id)))
+    {
+      bst_subscription_baseline_put (&bst_info.subscription[id]);
+    }
+  }
+
+  /* there are as many baselines as subscriptions, one is free now */
+  for (id = 0; (id < BVIEW_BST_MAX_SUBSCRIPTIONS) && (0 > slot); id++)
+  {
+    if (0 == ptr->subscription_baseline[id].refs)
+    {
+      slot = id;
+    }
+  }
+  if (0 > slot)
+  {
+    return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+  }
+
+  baseline = &ptr->subscription_baseline[slot];
+  if ((NULL == baseline->record) &&
+      (BVIEW_STATUS_SUCCESS != bst_snapshot_alloc (unit, &ptr->snapshot_layout,
+                                                   &baseline->record)))
+  {
+    return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+  }
+  (void) bst_snapshot_copy (baseline->record, record);
+
+  for (id = 0; id < BVIEW_BST_MAX_SUBSCRIPTIONS; id++)
+  {
+    if (0 != (subscribers & (1 << id)))
+    {
+      bst_info.subscription[id].baseline = slot;
+      baseline->refs++;
+    }
+  }
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : application function to send the reports of the due
+*          subscriptions of a unit
+*
+* @param[in] msg_data : pointer to the bst message request.
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the reports are sent, or none is due
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameter.
+* @retval  : other : collecting or sending the stats failed
+*
+* @note : the stats are collected once, as are the max buffers for the
+*         reports in percent. The subscriptions due are grouped by the
+*         report they get, which is encoded once per group and shared
+*         by the collectors of the group, so that the cost of encoding
+*         does not grow with the subscriptions.
+*
+*********************************************************************/
+BVIEW_STATUS bst_subscription_collect (BVIEW_BST_REQUEST_MSG_t *msg_data)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr;
+  BVIEW_BST_CONFIG_PARAMS_t *config;
+  BVIEW_BST_SUBSCRIPTION_t *subscription;
+  BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
+  unsigned int due = 0, pending, group, incremental = 0;
+  time_t now = time (NULL);
+  int unit, id, other;
+
+  if (NULL == msg_data)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  unit = msg_data->unit;
+  ptr = BST_UNIT_PTR_GET (unit);
+  if ((NULL == ptr) || (NULL == ptr->subscription_record_ptr))
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  for (id = 0; id < BVIEW_BST_MAX_SUBSCRIPTIONS; id++)
+  {
+    subscription = &bst_info.subscription[id];
+    if ((0 != subscription->config.enable) && (unit == subscription->unit) &&
+        (now >= subscription->nextDue))
+    {
+      due |= (1 << id);
+      if (0 != subscription->config.sendIncrementalReport)
+      {
+        incremental |= (1 << id);
+      }
+      /* a subscription which fell behind starts over from now */
+      subscription->nextDue += subscription->config.collectionInterval;
+      if (subscription->nextDue <= now)
+      {
+        subscription->nextDue = now + subscription->config.collectionInterval;
+      }
+    }
+  }
+
+  if (0 == due)
+  {
+    return BVIEW_STATUS_SUCCESS;
+  }
+
+  BST_LOCK_TAKE (unit);
+  rv = bst_snapshot_collect (ptr->subscription_record_ptr);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+        "Failed to collect the stats of the subscriptions of unit %d, err %d\r\n",
+        unit, rv);
+    BST_LOCK_GIVE (unit);
+    return rv;
+  }
+
+  /* the percentages are of the max buffers of now, the last ones read
+     are kept if the south bound fails to provide them */
+  config = BST_CONFIG_FEATURE_PTR_GET (unit);
+  if ((true == config->statsInPercentage) &&
+      (BVIEW_STATUS_SUCCESS != bst_max_buffers_refresh (unit)))
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+        "Failed to get the max buffers of unit %d for the subscriptions\r\n", unit);
+  }
+
+  /* one report for each group of subscriptions asking for the same */
+  pending = due;
+  for (id = 0; id < BVIEW_BST_MAX_SUBSCRIPTIONS; id++)
+  {
+    if (0 == (pending & (1 << id)))
+    {
+      continue;
+    }
+
+    group = 0;
+    for (other = id; other < BVIEW_BST_MAX_SUBSCRIPTIONS; other++)
+    {
+      if ((0 != (pending & (1 << other))) &&
+          (true == bst_subscription_same_report (&bst_info.subscription[id],
+                                                 &bst_info.subscription[other])))
+      {
+        group |= (1 << other);
+      }
+    }
+    pending &= ~group;
+
+    rv = bst_subscription_report (unit, &bst_info.subscription[id], group,
+                                  ptr->subscription_record_ptr);
+    if (BVIEW_STATUS_SUCCESS != rv)
+    {
+      LOG_POST (BVIEW_LOG_ERROR,
+          "Failed to send the report of subscriptions 0x%x of unit %d, err %d\r\n",
+          group, unit, rv);
+    }
+  }
+
+  /* the next reports of the incremental ones are against these stats */
+  if (0 != incremental)
+  {
+    if (BVIEW_STATUS_SUCCESS != bst_subscription_baseline_set (unit, incremental,
+                                                               ptr->subscription_record_ptr))
+    {
+      LOG_POST (BVIEW_LOG_ERROR,
+          "Failed to keep the stats of subscriptions 0x%x of unit %d\r\n",
+          incremental, unit);
+    }
+  }
+
+  bst_snapshot_release (ptr->subscription_record_ptr);
+  BST_LOCK_GIVE (unit);
+  return rv;
+}
+
+/*********************************************************************
+*  @brief:  callback function to check for due subscriptions
+*
+* @param[in]   sigval : Data passed with notification after timer expires
+*
+* @retval  : BVIEW_STATUS_SUCCESS : message is successfully posted to bst.
+* @retval  : BVIEW_STATUS_FAILURE : failed to post message to bst.
+*
+* @note : invoked in the timer context, the reports are sent from the
+*         bst context so that they are serialized with the others.
+*
+*********************************************************************/
+BVIEW_STATUS bst_subscription_cb (union sigval sigval)
+{
+  BVIEW_BST_REQUEST_MSG_t msg_data;
+  BVIEW_STATUS rv; 
+
+  memset (&msg_data, 0, sizeof (BVIEW_BST_REQUEST_MSG_t));
+  msg_data.msg_type = BVIEW_BST_CMD_API_SUBSCRIPTION_COLLECT;
+  msg_data.unit = (*(int *)sigval.sival_ptr);
+  /* Send the message to the bst application */
+  rv = bst_send_request (&msg_data);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+        "Failed to send subscription message to bst application. err = %d\r\n", rv);
+    return BVIEW_STATUS_FAILURE;
+  }  
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : stops the subscriptions of a unit and frees their stats
+*
+* @param[in] unit : unit
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_subscription_uninit (int unit)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr = BST_UNIT_PTR_GET (unit);
+  BVIEW_BST_DATA_t *bst_data_ptr = BST_UNIT_DATA_PTR_GET (unit);
+  int id;
+
+  if ((NULL != bst_data_ptr) && (true == bst_data_ptr->bst_subscription_timer.in_use))
+  {
+    if (BVIEW_STATUS_SUCCESS == system_timer_delete (bst_data_ptr->bst_subscription_timer.bstTimer))
+    {
+      bst_data_ptr->bst_subscription_timer.in_use = false;
+    }
+  }
+
+  for (id = 0; id < BVIEW_BST_MAX_SUBSCRIPTIONS; id++)
+  {
+    bst_snapshot_free (ptr->subscription_baseline[id].record);
+    ptr->subscription_baseline[id].record = NULL;
+    ptr->subscription_baseline[id].refs = 0;
+
+    if (unit == bst_info.subscription[id].unit)
+    {
+      bst_info.subscription[id].baseline = -1;
+    }
+  }
+
+  bst_snapshot_free (ptr->subscription_record_ptr);
+  ptr->subscription_record_ptr = NULL;
+}
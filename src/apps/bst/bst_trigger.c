@@ -30,6 +30,7 @@
 #include "get_bst_feature.h"
 #include "get_bst_thresholds.h"
 #include "get_bst_report.h"
+#include "get_bst_history.h"
 #include "bst_json_encoder.h"
 #include "bst.h"
 #include "broadview.h"
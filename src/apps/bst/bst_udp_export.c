@@ -0,0 +1,535 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "configure_bst_thresholds.h"
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+#include "get_bst_tracking.h"
+#include "get_bst_feature.h"
+#include "get_bst_thresholds.h"
+#include "get_bst_report.h"
+#include "get_bst_history.h"
+#include "bst_json_encoder.h"
+#include "bst.h"
+#include "broadview.h"
+#include "bst_app.h"
+#include "system.h"
+#include "openapps_log_api.h"
+
+extern BVIEW_BST_CXT_t bst_info;
+
+/* realm of the snapshot each realm of the request is, by BVIEW_BST_REALM_ID_t */
+static const int bst_udp_export_realms[BVIEW_BST_REALM_ID_MAX] = {
+  -1,
+  BVIEW_BST_SNAPSHOT_DEVICE,
+  BVIEW_BST_SNAPSHOT_EPSP,
+  BVIEW_BST_SNAPSHOT_ESP,
+  BVIEW_BST_SNAPSHOT_EUCQ,
+  BVIEW_BST_SNAPSHOT_EUCQG,
+  BVIEW_BST_SNAPSHOT_EMCQ,
+  BVIEW_BST_SNAPSHOT_CPUQ,
+  BVIEW_BST_SNAPSHOT_RQEQ,
+  BVIEW_BST_SNAPSHOT_IPPG,
+  BVIEW_BST_SNAPSHOT_IPSP,
+  BVIEW_BST_SNAPSHOT_ISP
+};
+
+/* a datagram being filled */
+typedef struct _bst_udp_export_datagram_ {
+  BVIEW_BST_UDP_HEADER_t header;
+  /* records in the datagram so far, and the most it takes */
+  unsigned int records;
+  unsigned int maxRecords;
+  /* datagrams sent for the sample so far */
+  unsigned int sent;
+} BVIEW_BST_UDP_EXPORT_DATAGRAM_t;
+
+/*********************************************************************
+* @brief : converts a 64 bit value to network byte order
+*
+* @param[in] value : value in host byte order
+*
+* @retval  : the value in network byte order
+*
+*********************************************************************/
+static uint64_t bst_udp_export_hton64 (uint64_t value)
+{
+  if (1 == htonl (1))
+  {
+    return value;
+  }
+  return (((uint64_t) htonl ((uint32_t) value)) << 32) | htonl ((uint32_t) (value >> 32));
+}
+
+/*********************************************************************
+* @brief : number of counters of a realm
+*
+* @param[in] layout : layout of the snapshot
+* @param[in] realm  : realm of the snapshot
+*
+* @retval  : counters of the realm, every entry is made of 64 bit counters
+*
+*********************************************************************/
+static uint32_t bst_udp_export_counters (const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout,
+                                         int realm)
+{
+  return (uint32_t) ((layout->entries[realm] * layout->entrySize[realm]) / sizeof (uint64_t));
+}
+
+/*********************************************************************
+* @brief : starts a datagram of a realm of the sample
+*
+* @param[in] datagram : datagram
+* @param[in] realm    : realm of the snapshot the records are of
+* @param[in] counters : number of counters of the realm
+* @param[in] flags    : BVIEW_BST_UDP_FLAG_RESYNC or 0
+*
+* @retval  : none
+*
+*********************************************************************/
+static void bst_udp_export_start (BVIEW_BST_UDP_EXPORT_DATAGRAM_t *datagram,
+                                  int realm, uint32_t counters, uint8_t flags)
+{
+  datagram->header.flags = flags;
+  datagram->header.realm = (uint8_t) realm;
+  datagram->header.counters = htonl (counters);
+  datagram->records = 0;
+}
+
+/*********************************************************************
+* @brief : sends the datagram filled so far
+*
+* @param[in] udp      : export of the unit
+* @param[in] datagram : datagram
+* @param[in] last     : whether it is the last one of the realm
+*
+* @retval  : none
+*
+* @note : a datagram the socket does not take is dropped, a collector
+*         sees the gap in the sequence.
+*
+*********************************************************************/
+static void bst_udp_export_send (BVIEW_BST_UDP_EXPORT_t *udp,
+                                 BVIEW_BST_UDP_EXPORT_DATAGRAM_t *datagram,
+                                 bool last)
+{
+  size_t length = sizeof (BVIEW_BST_UDP_HEADER_t) +
+                  (datagram->records * sizeof (BVIEW_BST_UDP_RECORD_t));
+
+  if (true == last)
+  {
+    datagram->header.flags |= BVIEW_BST_UDP_FLAG_LAST;
+  }
+  datagram->header.sequence = htonl (udp->sequence++);
+  datagram->header.records = htons ((uint16_t) datagram->records);
+  memcpy (udp->datagram, &datagram->header, sizeof (BVIEW_BST_UDP_HEADER_t));
+
+  if ((ssize_t) length != sendto (udp->fd, udp->datagram, length, MSG_DONTWAIT,
+                                  (struct sockaddr *) &udp->collector,
+                                  sizeof (udp->collector)))
+  {
+    udp->stats.drops++;
+  }
+  else
+  {
+    udp->stats.bytes += length;
+  }
+
+  udp->stats.datagrams++;
+  udp->stats.records += datagram->records;
+  datagram->sent++;
+  datagram->records = 0;
+}
+
+/*********************************************************************
+* @brief : adds a counter to the datagram, sending it when it is full
+*
+* @param[in] udp      : export of the unit
+* @param[in] datagram : datagram
+* @param[in] index    : counter of the realm
+* @param[in] value    : value of the counter
+*
+* @retval  : none
+*
+*********************************************************************/
+static void bst_udp_export_record (BVIEW_BST_UDP_EXPORT_t *udp,
+                                   BVIEW_BST_UDP_EXPORT_DATAGRAM_t *datagram,
+                                   uint32_t index, uint64_t value)
+{
+  BVIEW_BST_UDP_RECORD_t record;
+
+  if (datagram->records == datagram->maxRecords)
+  {
+    /* the realm goes on in the next datagram, with the same flags */
+    bst_udp_export_send (udp, datagram, false);
+  }
+
+  record.index = htonl (index);
+  record.value = bst_udp_export_hton64 (value);
+  memcpy (BVIEW_BST_UDP_RECORDS (udp->datagram) + datagram->records,
+          &record, sizeof (record));
+  datagram->records++;
+}
+
+/*********************************************************************
+* @brief : sends a realm of the sample
+*
+* @param[in] udp      : export of the unit
+* @param[in] datagram : datagram
+* @param[in] realm    : realm of the snapshot
+* @param[in] resync   : whether every counter is sent, or the changed ones
+*
+* @retval  : none
+*
+* @note : the baseline is brought up to the sample on the way.
+*
+*********************************************************************/
+static void bst_udp_export_realm (BVIEW_BST_UDP_EXPORT_t *udp,
+                                  BVIEW_BST_UDP_EXPORT_DATAGRAM_t *datagram,
+                                  int realm, bool resync)
+{
+  const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *sample = &udp->record->snapshot_data;
+  const uint64_t *values;
+  uint64_t *previous;
+  uint32_t counters, index;
+
+  counters = bst_udp_export_counters (sample->layout, realm);
+  if (0 == counters)
+  {
+    return;
+  }
+
+  values = (const uint64_t *) (sample->data + sample->layout->offset[realm]);
+  previous = (uint64_t *) (udp->baseline->snapshot_data.data +
+                           sample->layout->offset[realm]);
+
+  bst_udp_export_start (datagram, realm, counters,
+                        (true == resync) ? BVIEW_BST_UDP_FLAG_RESYNC : 0);
+
+  for (index = 0; index < counters; index++)
+  {
+    if ((false == resync) && (values[index] == previous[index]))
+    {
+      continue;
+    }
+    bst_udp_export_record (udp, datagram, index, values[index]);
+    previous[index] = values[index];
+  }
+
+  if (0 != datagram->records)
+  {
+    bst_udp_export_send (udp, datagram, true);
+  }
+}
+
+/*********************************************************************
+* @brief : stops the export of a unit
+*
+* @param[in] unit : unit
+*
+* @retval  : none
+*
+* @note : the sequence goes on if the export is started again, so that
+*          a collector does not mistake the datagrams for old ones.
+*
+*********************************************************************/
+static void bst_udp_export_stop (int unit)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr = BST_UNIT_PTR_GET (unit);
+  BVIEW_BST_DATA_t *bst_data_ptr = BST_UNIT_DATA_PTR_GET (unit);
+  BVIEW_BST_UDP_EXPORT_t *udp = &ptr->udp_export;
+
+  if ((NULL != bst_data_ptr) && (true == bst_data_ptr->bst_udp_export_timer.in_use))
+  {
+    if (BVIEW_STATUS_SUCCESS == system_timer_delete (bst_data_ptr->bst_udp_export_timer.bstTimer))
+    {
+      bst_data_ptr->bst_udp_export_timer.in_use = false;
+    }
+  }
+
+  if (0 != udp->config.enable)
+  {
+    LOG_POST (BVIEW_LOG_INFO,
+        "udp export of unit %d stopped, %" PRIu64 " samples in %" PRIu64
+        " datagrams, %" PRIu64 " dropped\r\n",
+        unit, udp->stats.samples, udp->stats.datagrams, udp->stats.drops);
+  }
+
+  if (0 <= udp->fd)
+  {
+    close (udp->fd);
+  }
+  udp->fd = -1;
+  udp->config.enable = 0;
+
+  bst_snapshot_free (udp->record);
+  udp->record = NULL;
+  bst_snapshot_free (udp->baseline);
+  udp->baseline = NULL;
+  free (udp->datagram);
+  udp->datagram = NULL;
+  udp->baselineValid = false;
+}
+
+/*********************************************************************
+* @brief : application function to start, change or stop the export
+*          of the samples of a unit in datagrams
+*
+* @param[in] msg_data : pointer to the bst message request.
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the export is configured
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameter.
+* @retval  : BVIEW_STATUS_RESOURCE_NOT_AVAILABLE : out of memory
+* @retval  : other : the socket or the timer could not be set up, the
+*            export is stopped
+*
+* @note : a changed export starts over with every counter.
+*
+*********************************************************************/
+BVIEW_STATUS bst_udp_export_set (BVIEW_BST_REQUEST_MSG_t *msg_data)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr;
+  BVIEW_BST_DATA_t *bst_data_ptr;
+  BVIEW_BST_UDP_EXPORT_CONFIG_t *config;
+  BVIEW_BST_UDP_EXPORT_t *udp;
+  BVIEW_STATUS rv;
+
+  if (NULL == msg_data)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  ptr = BST_UNIT_PTR_GET (msg_data->unit);
+  bst_data_ptr = BST_UNIT_DATA_PTR_GET (msg_data->unit);
+  if ((NULL == ptr) || (NULL == bst_data_ptr))
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  config = &msg_data->request.udpExport;
+  udp = &ptr->udp_export;
+
+  bst_udp_export_stop (msg_data->unit);
+
+  if (0 == config->enable)
+  {
+    return BVIEW_STATUS_SUCCESS;
+  }
+
+  memset (&udp->collector, 0, sizeof (udp->collector));
+  udp->collector.sin_family = AF_INET;
+  udp->collector.sin_port = htons ((uint16_t) config->collectorPort);
+  if (1 != inet_pton (AF_INET, config->collectorIp, &udp->collector.sin_addr))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  if ((BVIEW_STATUS_SUCCESS != bst_snapshot_alloc (msg_data->unit, &ptr->snapshot_layout,
+                                                   &udp->record)) ||
+      (BVIEW_STATUS_SUCCESS != bst_snapshot_alloc (msg_data->unit, &ptr->snapshot_layout,
+                                                   &udp->baseline)) ||
+      (NULL == (udp->datagram = malloc (config->mtu - BVIEW_BST_UDP_OVERHEAD))))
+  {
+    bst_udp_export_stop (msg_data->unit);
+    return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+  }
+
+  udp->fd = socket (AF_INET, SOCK_DGRAM, 0);
+  if (0 > udp->fd)
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+        "Failed to open the udp export socket of unit %d\r\n", msg_data->unit);
+    bst_udp_export_stop (msg_data->unit);
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  udp->config = *config;
+  udp->sinceResync = 0;
+  memset (&udp->stats, 0, sizeof (udp->stats));
+
+  rv = system_timer_add (bst_udp_export_cb, &bst_data_ptr->bst_udp_export_timer.bstTimer,
+                         config->sampleInterval, PERIODIC_MODE,
+                         &bst_data_ptr->bst_udp_export_timer.unit);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+        "Failed to add udp export timer for unit %d, err %d\r\n", msg_data->unit, rv);
+    bst_udp_export_stop (msg_data->unit);
+    return rv;
+  }
+  bst_data_ptr->bst_udp_export_timer.in_use = true;
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : application function to take a sample of a unit and send
+*          its changes in datagrams
+*
+* @param[in] msg_data : pointer to the bst message request.
+*
+* @retval  : BVIEW_STATUS_SUCCESS : the sample is sent
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameter.
+* @retval  : other : collecting the stats failed
+*
+* @note : The first sample, and the first one after resync-interval
+*         datagrams of changes, carries every counter of the exported
+*         realms. The
+*         others carry the counters changed since the sample before, a
+*         sample without changes goes out as a single empty datagram
+*         so that the collector still sees the loss and the time.
+*
+*********************************************************************/
+BVIEW_STATUS bst_udp_export_collect (BVIEW_BST_REQUEST_MSG_t *msg_data)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr;
+  BVIEW_BST_UDP_EXPORT_t *udp;
+  BVIEW_BST_UDP_EXPORT_DATAGRAM_t datagram;
+  struct timespec now;
+  uint64_t timestamp;
+  int realm, first = -1;
+  bool resync;
+  BVIEW_STATUS rv;
+
+  if (NULL == msg_data)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  ptr = BST_UNIT_PTR_GET (msg_data->unit);
+  if (NULL == ptr)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  udp = &ptr->udp_export;
+
+  BST_LOCK_TAKE (msg_data->unit);
+  /* a sample posted before the export was stopped */
+  if (0 == udp->config.enable)
+  {
+    BST_LOCK_GIVE (msg_data->unit);
+    return BVIEW_STATUS_SUCCESS;
+  }
+
+  rv = bst_snapshot_collect (udp->record);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    _BST_LOG(_BST_DEBUG_ERROR, "Failed to sample bst stats for the udp export, err %d \r\n", rv);
+    BST_LOCK_GIVE (msg_data->unit);
+    return rv;
+  }
+
+  clock_gettime (CLOCK_REALTIME, &now);
+  timestamp = ((uint64_t) now.tv_sec * 1000000) + ((uint64_t) now.tv_nsec / 1000);
+
+  resync = ((false == udp->baselineValid) ||
+            (udp->sinceResync >= (unsigned int) udp->config.resyncInterval));
+
+  memset (&datagram, 0, sizeof (datagram));
+  datagram.header.magic = htonl (BVIEW_BST_UDP_MAGIC);
+  datagram.header.version = BVIEW_BST_UDP_VERSION;
+  datagram.header.unit = (uint8_t) msg_data->unit;
+  datagram.header.snapshot = htonl (udp->snapshot++);
+  datagram.header.timestamp = bst_udp_export_hton64 (timestamp);
+  datagram.maxRecords = BVIEW_BST_UDP_MAX_RECORDS (udp->config.mtu);
+
+  for (realm = BVIEW_BST_REALM_ID_MIN; realm < BVIEW_BST_REALM_ID_MAX; realm++)
+  {
+    if (0 == (udp->config.realmMask & (1 << realm)))
+    {
+      continue;
+    }
+    if (0 > first)
+    {
+      first = bst_udp_export_realms[realm];
+    }
+    bst_udp_export_realm (udp, &datagram, bst_udp_export_realms[realm], resync);
+  }
+
+  if ((0 == datagram.sent) && (0 <= first))
+  {
+    bst_udp_export_start (&datagram, first,
+                          bst_udp_export_counters (udp->record->snapshot_data.layout, first),
+                          0);
+    bst_udp_export_send (udp, &datagram, true);
+  }
+
+  /* the interval counts the datagrams of the changes, so that a resync
+     larger than the interval does not take over */
+  if (true == resync)
+  {
+    udp->sinceResync = 0;
+    udp->baselineValid = true;
+    udp->stats.resyncs++;
+  }
+  else
+  {
+    udp->sinceResync += datagram.sent;
+  }
+  udp->stats.samples++;
+
+  /* the changes are in the baseline, don't hold on to the published data */
+  bst_snapshot_release (udp->record);
+  BST_LOCK_GIVE (msg_data->unit);
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+*  @brief:  callback function to take a sample for the export
+*
+* @param[in]   sigval : Data passed with notification after timer expires
+*
+* @retval  : BVIEW_STATUS_SUCCESS : message is successfully posted to bst.
+* @retval  : BVIEW_STATUS_FAILURE : failed to post message to bst.
+*
+* @note : invoked in the timer context, the sample is taken in the bst
+*         context so that it is serialized with the reports.
+*
+*********************************************************************/
+BVIEW_STATUS bst_udp_export_cb (union sigval sigval)
+{
+  BVIEW_BST_REQUEST_MSG_t msg_data;
+  BVIEW_STATUS rv;
+
+  memset (&msg_data, 0, sizeof (BVIEW_BST_REQUEST_MSG_t));
+  msg_data.msg_type = BVIEW_BST_CMD_API_UDP_EXPORT_COLLECT;
+  msg_data.unit = (*(int *)sigval.sival_ptr);
+  /* Send the message to the bst application */
+  rv = bst_send_request (&msg_data);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+        "Failed to send udp export message to bst application. err = %d\r\n", rv);
+    return BVIEW_STATUS_FAILURE;
+  }
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : stops the export of a unit and frees its resources
+*
+* @param[in] unit : unit
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_udp_export_uninit (int unit)
+{
+  bst_udp_export_stop (unit);
+}
@@ -0,0 +1,241 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "configure_bst_thresholds.h"
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+#include "get_bst_tracking.h"
+#include "get_bst_feature.h"
+#include "get_bst_thresholds.h"
+#include "get_bst_report.h"
+#include "get_bst_history.h"
+#include "bst_json_encoder.h"
+#include "bst.h"
+#include "broadview.h"
+#include "bst_app.h"
+#include "openapps_log_api.h"
+
+/* number of 64 bit words in a snapshot of the layout */
+#define _BST_WINDOW_WORDS(_layout)   ((_layout)->size / sizeof (uint64_t))
+
+/*********************************************************************
+* @brief : allocates the aggregation window of a unit
+*
+* @param[in]  layout : layout of the snapshots of the unit
+* @param[out] window : newly allocated, empty window
+*
+* @retval  : BVIEW_STATUS_SUCCESS : window allocated
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+* @retval  : BVIEW_STATUS_RESOURCE_NOT_AVAILABLE : out of memory
+*
+* @note : Release with bst_window_free.
+*
+*********************************************************************/
+BVIEW_STATUS bst_window_alloc (const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout,
+                               BVIEW_BST_WINDOW_t **window)
+{
+  BVIEW_BST_WINDOW_t *ptr = NULL;
+  void *data[3] = { NULL, NULL, NULL };
+  size_t size;
+  unsigned int i = 0;
+
+  if ((NULL == layout) || (NULL == window))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  *window = NULL;
+
+  ptr = (BVIEW_BST_WINDOW_t *) malloc (sizeof (BVIEW_BST_WINDOW_t));
+  if (NULL == ptr)
+  {
+    return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+  }
+  memset (ptr, 0, sizeof (BVIEW_BST_WINDOW_t));
+
+  /* peak, min and sum are handed out as snapshot data, so they
+     get the alignment of one */
+  size = (0 == layout->size) ? BVIEW_BST_SNAPSHOT_ALIGN : layout->size;
+  for (i = 0; i < 3; i++)
+  {
+    if (0 != posix_memalign (&data[i], BVIEW_BST_SNAPSHOT_ALIGN, size))
+    {
+      while (i-- > 0)
+      {
+        free (data[i]);
+      }
+      free (ptr);
+      return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+    }
+    memset (data[i], 0, size);
+  }
+
+  ptr->layout = layout;
+  ptr->peak = (uint64_t *) data[0];
+  ptr->min = (uint64_t *) data[1];
+  ptr->sum = (uint64_t *) data[2];
+
+  *window = ptr;
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : frees a window allocated with bst_window_alloc
+*
+* @param[in] window : window to be freed, may be NULL
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_window_free (BVIEW_BST_WINDOW_t *window)
+{
+  if (NULL == window)
+  {
+    return;
+  }
+
+  free (window->peak);
+  free (window->min);
+  free (window->sum);
+  free (window);
+}
+
+/*********************************************************************
+* @brief : accounts a stats sample in the window
+*
+* @param[in] window : window of the unit
+* @param[in] record : stats record just sampled
+*
+* @retval  : BVIEW_STATUS_SUCCESS : sample accounted
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+*********************************************************************/
+BVIEW_STATUS bst_window_sample (BVIEW_BST_WINDOW_t *window,
+                                const BVIEW_BST_REPORT_SNAPSHOT_t *record)
+{
+  const uint64_t *data;
+  size_t words, word;
+
+  if ((NULL == window) || (NULL == record) ||
+      (window->layout != record->snapshot_data.layout))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  data = (const uint64_t *) record->snapshot_data.data;
+  words = _BST_WINDOW_WORDS (window->layout);
+
+  if (0 == window->samples)
+  {
+    /* the first sample opens the window */
+    memcpy (window->peak, data, window->layout->size);
+    memcpy (window->min, data, window->layout->size);
+    memcpy (window->sum, data, window->layout->size);
+    window->start = record->tv;
+    window->samples = 1;
+    return BVIEW_STATUS_SUCCESS;
+  }
+
+  for (word = 0; word < words; word++)
+  {
+    if (data[word] > window->peak[word])
+    {
+      window->peak[word] = data[word];
+    }
+    if (data[word] < window->min[word])
+    {
+      window->min[word] = data[word];
+    }
+    window->sum[word] += data[word];
+  }
+  window->samples++;
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : closes the window and provides its aggregates
+*
+* @param[in]  window : window of the unit
+* @param[out] peak   : highest value of every counter
+* @param[out] min    : lowest value of every counter
+* @param[out] mean   : mean value of every counter
+*
+* @retval  : number of samples in the window, 0 if there is nothing
+*            to report
+*
+* @note : the aggregates are valid until bst_window_reset, which must
+*         follow before the next sample is accounted.
+*
+*********************************************************************/
+unsigned int bst_window_close (BVIEW_BST_WINDOW_t *window,
+                               BVIEW_BST_ASIC_SNAPSHOT_DATA_t *peak,
+                               BVIEW_BST_ASIC_SNAPSHOT_DATA_t *min,
+                               BVIEW_BST_ASIC_SNAPSHOT_DATA_t *mean)
+{
+  size_t words, word;
+
+  if ((NULL == window) || (NULL == peak) || (NULL == min) || (NULL == mean) ||
+      (0 == window->samples))
+  {
+    return 0;
+  }
+
+  /* the sums are not needed any more, turn them into the means */
+  if (1 < window->samples)
+  {
+    words = _BST_WINDOW_WORDS (window->layout);
+    for (word = 0; word < words; word++)
+    {
+      window->sum[word] /= window->samples;
+    }
+  }
+
+  peak->layout = window->layout;
+  peak->data = (uint8_t *) window->peak;
+  min->layout = window->layout;
+  min->data = (uint8_t *) window->min;
+  mean->layout = window->layout;
+  mean->data = (uint8_t *) window->sum;
+
+  return window->samples;
+}
+
+/*********************************************************************
+* @brief : starts a new, empty window
+*
+* @param[in] window : window of the unit, may be NULL
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_window_reset (BVIEW_BST_WINDOW_t *window)
+{
+  if (NULL == window)
+  {
+    return;
+  }
+
+  /* the accumulators are overwritten by the first sample */
+  window->samples = 0;
+  memset (&window->start, 0, sizeof (window->start));
+}
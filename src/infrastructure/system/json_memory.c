@@ -0,0 +1,619 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <inttypes.h>
+
+#include "broadview.h"
+#include "json_memory.h"
+
+#define _JSON_MEMORY_DEBUG
+#define _JSON_MEMORY_DEBUG_LEVEL        _JSON_MEMORY_DEBUG_ERROR
+
+#define _JSON_MEMORY_DEBUG_TRACE        (0x1)
+#define _JSON_MEMORY_DEBUG_INFO         (0x01 << 1)
+#define _JSON_MEMORY_DEBUG_ERROR        (0x01 << 2)
+#define _JSON_MEMORY_DEBUG_ALL          (0xFF)
+
+#ifdef _JSON_MEMORY_DEBUG
+#define _JSON_MEMORY_LOG(level, format,args...)   do { \
+            if ((level) & _JSON_MEMORY_DEBUG_LEVEL) { \
+                printf(format, ##args); \
+            } \
+        }while(0)
+#else
+#define _JSON_MEMORY_LOG(level, format,args...)
+#endif
+
+/* Utility Macros for parameter validation */
+#define _JSON_MEMORY_ASSERT_ERROR(condition, errcode) do { \
+    if (!(condition)) { \
+        _JSON_MEMORY_LOG(_JSON_MEMORY_DEBUG_ERROR, \
+                    "JSON Memory (%s:%d) Invalid Input Parameter  \n", \
+                    __func__, __LINE__); \
+        return (errcode); \
+    } \
+} while(0)
+
+#define _JSON_MEMORY_ASSERT(condition) _JSON_MEMORY_ASSERT_ERROR((condition), (BVIEW_STATUS_INVALID_PARAMETER))
+
+/* marks the buffers handed out by the pools */
+#define _JSON_MEMORY_MAGIC              0x4a534f4e
+
+/* The following precedes every buffer. It tells the free function
+ * where the buffer goes back to, and chains the free buffers.
+ */
+typedef struct _json_memory_buffer_
+{
+    uint32_t magic;
+    uint16_t pool;
+    uint16_t sizeClass;
+    bool inUse;
+    /* when it was handed out */
+    struct timespec taken;
+    struct _json_memory_buffer_ *next;
+} _JSON_MEMORY_BUFFER_t;
+
+/* keeps the buffers as aligned as malloc() does */
+#define _JSON_MEMORY_HEADER_SIZE        ((sizeof (_JSON_MEMORY_BUFFER_t) + 15) & ~((size_t) 15))
+
+#define _JSON_MEMORY_HEADER(buffer)     ((_JSON_MEMORY_BUFFER_t *) ((buffer) - _JSON_MEMORY_HEADER_SIZE))
+#define _JSON_MEMORY_DATA(header)       (((uint8_t *) (header)) + _JSON_MEMORY_HEADER_SIZE)
+
+typedef struct _json_memory_class_
+{
+    unsigned int size;
+    unsigned int maxBuffers;
+
+    /* free buffers, other than the ones cached by the threads */
+    pthread_mutex_t lock;
+    _JSON_MEMORY_BUFFER_t *freeList;
+    unsigned int numBuffers;
+
+    /* counters, updated without the lock */
+    unsigned int inUse;
+    unsigned int highWatermark;
+    uint64_t allocations;
+    uint64_t failures;
+    uint64_t frees;
+    uint64_t holdTimeUsec;
+} _JSON_MEMORY_CLASS_t;
+
+/* buffers cached by a thread, the last one it freed per pool and class.
+   The slots are taken with an atomic exchange, so that a class at its cap
+   can take the buffers back from the threads which do not use them. */
+typedef struct _json_memory_cache_
+{
+    _JSON_MEMORY_BUFFER_t *slot[JSON_MEMORY_MAX_POOLS][JSON_MEMORY_MAX_CLASSES];
+    struct _json_memory_cache_ *next;
+} _JSON_MEMORY_CACHE_t;
+
+typedef struct _json_memory_pool_
+{
+    bool valid;
+    char name[JSON_MEMORY_MAX_NAME_LENGTH];
+    int numClasses;
+    _JSON_MEMORY_CLASS_t classes[JSON_MEMORY_MAX_CLASSES];
+} _JSON_MEMORY_POOL_t;
+
+static struct _json_memory_
+{
+    _JSON_MEMORY_POOL_t pools[JSON_MEMORY_MAX_POOLS];
+    int numPools;
+
+    /* serializes the creation of the pools */
+    pthread_mutex_t lock;
+
+    /* caches of the threads, and the lock for adding and removing them */
+    _JSON_MEMORY_CACHE_t *caches;
+    pthread_mutex_t cacheLock;
+
+    /* returns the cached buffers of a thread when it exits */
+    pthread_key_t cacheKey;
+} jsonMemory = { .lock = PTHREAD_MUTEX_INITIALIZER,
+                 .cacheLock = PTHREAD_MUTEX_INITIALIZER };
+
+static pthread_once_t jsonMemoryOnce = PTHREAD_ONCE_INIT;
+
+/* cache of this thread, set up when it frees a buffer the first time */
+static __thread _JSON_MEMORY_CACHE_t *threadCache;
+
+/******************************************************************
+ * @brief  Returns a buffer to the free list of its class
+ *********************************************************************/
+static void json_memory_release(_JSON_MEMORY_BUFFER_t *header)
+{
+    _JSON_MEMORY_CLASS_t *pClass = &jsonMemory.pools[header->pool].classes[header->sizeClass];
+
+    pthread_mutex_lock(&pClass->lock);
+    header->next = pClass->freeList;
+    pClass->freeList = header;
+    pthread_mutex_unlock(&pClass->lock);
+}
+
+/******************************************************************
+ * @brief  Hands the buffers cached by an exiting thread back to the pools
+ *********************************************************************/
+static void json_memory_thread_exit(void *arg)
+{
+    _JSON_MEMORY_CACHE_t *cache = (_JSON_MEMORY_CACHE_t *) arg;
+    _JSON_MEMORY_CACHE_t **pNext;
+    _JSON_MEMORY_BUFFER_t *header;
+    int pool, sizeClass;
+
+    pthread_mutex_lock(&jsonMemory.cacheLock);
+    for (pNext = &jsonMemory.caches; NULL != *pNext; pNext = &(*pNext)->next)
+    {
+        if (*pNext == cache)
+        {
+            *pNext = cache->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&jsonMemory.cacheLock);
+
+    for (pool = 0; pool < JSON_MEMORY_MAX_POOLS; pool++)
+    {
+        for (sizeClass = 0; sizeClass < JSON_MEMORY_MAX_CLASSES; sizeClass++)
+        {
+            header = __atomic_exchange_n(&cache->slot[pool][sizeClass], NULL, __ATOMIC_ACQ_REL);
+            if (NULL != header)
+            {
+                json_memory_release(header);
+            }
+        }
+    }
+
+    threadCache = NULL;
+    free(cache);
+}
+
+/******************************************************************
+ * @brief  Sets up the cache of the calling thread
+ *********************************************************************/
+static _JSON_MEMORY_CACHE_t *json_memory_cache_get(void)
+{
+    _JSON_MEMORY_CACHE_t *cache = threadCache;
+
+    if (NULL != cache)
+        return cache;
+
+    cache = calloc(1, sizeof (_JSON_MEMORY_CACHE_t));
+    if (NULL == cache)
+        return NULL;
+
+    pthread_mutex_lock(&jsonMemory.cacheLock);
+    cache->next = jsonMemory.caches;
+    jsonMemory.caches = cache;
+    pthread_mutex_unlock(&jsonMemory.cacheLock);
+
+    pthread_setspecific(jsonMemory.cacheKey, cache);
+    threadCache = cache;
+
+    return cache;
+}
+
+/******************************************************************
+ * @brief  Takes a buffer of a class from the cache of any thread, for
+ *         when the class is at its cap
+ *********************************************************************/
+static _JSON_MEMORY_BUFFER_t *json_memory_steal(int pool, int sizeClass)
+{
+    _JSON_MEMORY_CACHE_t *cache;
+    _JSON_MEMORY_BUFFER_t *header = NULL;
+
+    pthread_mutex_lock(&jsonMemory.cacheLock);
+    for (cache = jsonMemory.caches; (NULL != cache) && (NULL == header); cache = cache->next)
+    {
+        header = __atomic_exchange_n(&cache->slot[pool][sizeClass], NULL, __ATOMIC_ACQ_REL);
+    }
+    pthread_mutex_unlock(&jsonMemory.cacheLock);
+
+    return header;
+}
+
+static void json_memory_once(void)
+{
+    pthread_key_create(&jsonMemory.cacheKey, json_memory_thread_exit);
+}
+
+/******************************************************************
+ * @brief  Microseconds since 'start'
+ *********************************************************************/
+static uint64_t json_memory_usec_since(const struct timespec *start)
+{
+    struct timespec now;
+    int64_t usec;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    usec = ((int64_t) (now.tv_sec - start->tv_sec) * 1000000) +
+           ((now.tv_nsec - start->tv_nsec) / 1000);
+
+    return (usec < 0) ? 0 : (uint64_t) usec;
+}
+
+/******************************************************************
+ * @brief  Looks up the smallest class a size fits in
+ *********************************************************************/
+static int json_memory_class_get(const _JSON_MEMORY_POOL_t *pPool, unsigned int size)
+{
+    int sizeClass;
+
+    for (sizeClass = 0; sizeClass < pPool->numClasses; sizeClass++)
+    {
+        if (size <= pPool->classes[sizeClass].size)
+            return sizeClass;
+    }
+
+    return -1;
+}
+
+/*********************************************************************
+* @brief        Creates a pool of buffers
+*
+* @param[in]    name        name of the pool
+* @param[in]    classes     size classes, in increasing size
+* @param[in]    numClasses  number of size classes
+* @param[out]   poolId      pool to allocate from
+*
+* @retval       BVIEW_STATUS_SUCCESS  pool is created, or existed already
+* @retval       BVIEW_STATUS_INVALID_PARAMETER  invalid input parameter
+* @retval       BVIEW_STATUS_TABLE_FULL  JSON_MEMORY_MAX_POOLS are created
+*
+* @note         A pool of the same name is not created again, its id is
+*               returned. No buffer is taken from the system here.
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS json_memory_pool_create(const char *name,
+                                     const JSON_MEMORY_CLASS_CONFIG_t *classes,
+                                     int numClasses, int *poolId)
+{
+    _JSON_MEMORY_POOL_t *pPool;
+    int index = 0;
+
+    _JSON_MEMORY_ASSERT(name != NULL);
+    _JSON_MEMORY_ASSERT(classes != NULL);
+    _JSON_MEMORY_ASSERT(poolId != NULL);
+    _JSON_MEMORY_ASSERT((numClasses > 0) && (numClasses <= JSON_MEMORY_MAX_CLASSES));
+
+    for (index = 0; index < numClasses; index++)
+    {
+        _JSON_MEMORY_ASSERT(classes[index].size > 0);
+        _JSON_MEMORY_ASSERT((0 == index) || (classes[index].size > classes[index - 1].size));
+    }
+
+    pthread_once(&jsonMemoryOnce, json_memory_once);
+
+    pthread_mutex_lock(&jsonMemory.lock);
+
+    /* the applications initialize their pool again on a reset, the buffers
+       they hold stay valid */
+    for (index = 0; index < jsonMemory.numPools; index++)
+    {
+        if (0 == strncmp(jsonMemory.pools[index].name, name, JSON_MEMORY_MAX_NAME_LENGTH - 1))
+        {
+            pthread_mutex_unlock(&jsonMemory.lock);
+            *poolId = index;
+            return BVIEW_STATUS_SUCCESS;
+        }
+    }
+
+    if (JSON_MEMORY_MAX_POOLS == jsonMemory.numPools)
+    {
+        pthread_mutex_unlock(&jsonMemory.lock);
+        _JSON_MEMORY_LOG(_JSON_MEMORY_DEBUG_ERROR,
+                         "JSON Memory : No room for pool %s \n", name);
+        return BVIEW_STATUS_TABLE_FULL;
+    }
+
+    pPool = &jsonMemory.pools[jsonMemory.numPools];
+    memset(pPool, 0, sizeof (_JSON_MEMORY_POOL_t));
+    strncpy(pPool->name, name, JSON_MEMORY_MAX_NAME_LENGTH - 1);
+    pPool->numClasses = numClasses;
+
+    for (index = 0; index < numClasses; index++)
+    {
+        pPool->classes[index].size = classes[index].size;
+        pPool->classes[index].maxBuffers = classes[index].maxBuffers;
+        pthread_mutex_init(&pPool->classes[index].lock, NULL);
+    }
+
+    pPool->valid = true;
+    *poolId = jsonMemory.numPools;
+    jsonMemory.numPools++;
+
+    pthread_mutex_unlock(&jsonMemory.lock);
+
+    _JSON_MEMORY_LOG(_JSON_MEMORY_DEBUG_INFO,
+                     "JSON Memory : Created pool %s [%d] with %d classes \n",
+                     name, *poolId, numClasses);
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief        Allocates a buffer from a pool
+*
+* @param[in]    poolId      pool to allocate from
+* @param[in]    size        size needed
+* @param[out]   buffer      the buffer
+*
+* @retval       BVIEW_STATUS_SUCCESS  buffer is allocated
+* @retval       BVIEW_STATUS_OUTOFMEMORY  the class is at its cap, or the
+*                                         system is out of memory
+* @retval       BVIEW_STATUS_INVALID_PARAMETER  invalid input parameter,
+*                                               or no class is large enough
+*
+* @note         The buffer is not cleared. It must be returned with
+*               json_memory_free().
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS json_memory_allocate(int poolId, unsigned int size, uint8_t **buffer)
+{
+    _JSON_MEMORY_POOL_t *pPool;
+    _JSON_MEMORY_CLASS_t *pClass;
+    _JSON_MEMORY_BUFFER_t *header = NULL;
+    unsigned int inUse, highWatermark;
+    int sizeClass;
+    bool grow = false;
+
+    _JSON_MEMORY_ASSERT(buffer != NULL);
+    _JSON_MEMORY_ASSERT((poolId >= 0) && (poolId < JSON_MEMORY_MAX_POOLS));
+
+    pPool = &jsonMemory.pools[poolId];
+    _JSON_MEMORY_ASSERT(pPool->valid == true);
+
+    sizeClass = json_memory_class_get(pPool, size);
+    _JSON_MEMORY_ASSERT(sizeClass >= 0);
+
+    pClass = &pPool->classes[sizeClass];
+
+    /* the buffer this thread freed last needs no lock */
+    if (NULL != threadCache)
+    {
+        header = __atomic_exchange_n(&threadCache->slot[poolId][sizeClass], NULL, __ATOMIC_ACQ_REL);
+    }
+
+    if (NULL == header)
+    {
+        pthread_mutex_lock(&pClass->lock);
+        if (NULL != pClass->freeList)
+        {
+            header = pClass->freeList;
+            pClass->freeList = header->next;
+        }
+        else if (pClass->numBuffers < pClass->maxBuffers)
+        {
+            /* counted now, so that the cap holds while the lock is released */
+            pClass->numBuffers++;
+            grow = true;
+        }
+        pthread_mutex_unlock(&pClass->lock);
+
+        if ((NULL == header) && (false == grow))
+        {
+            /* the free buffers may all be cached by other threads */
+            header = json_memory_steal(poolId, sizeClass);
+        }
+
+        if (true == grow)
+        {
+            header = malloc(_JSON_MEMORY_HEADER_SIZE + pClass->size);
+            if (NULL == header)
+            {
+                pthread_mutex_lock(&pClass->lock);
+                pClass->numBuffers--;
+                pthread_mutex_unlock(&pClass->lock);
+            }
+            else
+            {
+                header->magic = _JSON_MEMORY_MAGIC;
+                header->pool = (uint16_t) poolId;
+                header->sizeClass = (uint16_t) sizeClass;
+            }
+        }
+    }
+
+    if (NULL == header)
+    {
+        __atomic_add_fetch(&pClass->failures, 1, __ATOMIC_RELAXED);
+        _JSON_MEMORY_LOG(_JSON_MEMORY_DEBUG_ERROR,
+                         "JSON Memory : Failed to allocate memory size %u from pool %s \n",
+                         size, pPool->name);
+        return BVIEW_STATUS_OUTOFMEMORY;
+    }
+
+    header->inUse = true;
+    header->next = NULL;
+    clock_gettime(CLOCK_MONOTONIC, &header->taken);
+
+    __atomic_add_fetch(&pClass->allocations, 1, __ATOMIC_RELAXED);
+    inUse = __atomic_add_fetch(&pClass->inUse, 1, __ATOMIC_RELAXED);
+    highWatermark = __atomic_load_n(&pClass->highWatermark, __ATOMIC_RELAXED);
+    while ((inUse > highWatermark) &&
+           !__atomic_compare_exchange_n(&pClass->highWatermark, &highWatermark, inUse,
+                                        false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+
+    *buffer = _JSON_MEMORY_DATA(header);
+
+    _JSON_MEMORY_LOG(_JSON_MEMORY_DEBUG_TRACE,
+                     "JSON Memory : Allocated memory[ %"PRI_PTR_TO_UINT_FMT"] size %u from pool %s \n",
+                     (ptr_to_uint_t)(*buffer), pClass->size, pPool->name);
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief        Returns a buffer to its pool
+*
+* @param[in]    buffer      buffer from json_memory_allocate()
+*
+* @retval       BVIEW_STATUS_SUCCESS  buffer is returned
+* @retval       BVIEW_STATUS_INVALID_PARAMETER  invalid input parameter
+* @retval       BVIEW_STATUS_INVALID_MEMORY  the buffer is not from a pool,
+*                                            or is freed already
+*
+* @note         Any thread may return the buffer.
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS json_memory_free(uint8_t *buffer)
+{
+    _JSON_MEMORY_BUFFER_t *header;
+    _JSON_MEMORY_BUFFER_t *empty = NULL;
+    _JSON_MEMORY_CLASS_t *pClass;
+    _JSON_MEMORY_CACHE_t *cache;
+
+    _JSON_MEMORY_ASSERT(buffer != NULL);
+
+    header = _JSON_MEMORY_HEADER(buffer);
+
+    _JSON_MEMORY_ASSERT_ERROR(((_JSON_MEMORY_MAGIC == header->magic) &&
+                               (header->pool < JSON_MEMORY_MAX_POOLS) &&
+                               (header->sizeClass < JSON_MEMORY_MAX_CLASSES) &&
+                               (true == header->inUse)),
+                              BVIEW_STATUS_INVALID_MEMORY);
+
+    pClass = &jsonMemory.pools[header->pool].classes[header->sizeClass];
+
+    header->inUse = false;
+
+    __atomic_add_fetch(&pClass->holdTimeUsec, json_memory_usec_since(&header->taken), __ATOMIC_RELAXED);
+    __atomic_add_fetch(&pClass->frees, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&pClass->inUse, 1, __ATOMIC_RELAXED);
+
+    _JSON_MEMORY_LOG(_JSON_MEMORY_DEBUG_TRACE,
+                     "JSON Memory : %" PRI_PTR_TO_UINT_FMT " returned to pool %s \n",
+                     (ptr_to_uint_t) buffer, jsonMemory.pools[header->pool].name);
+
+    cache = json_memory_cache_get();
+    if ((NULL != cache) &&
+        __atomic_compare_exchange_n(&cache->slot[header->pool][header->sizeClass], &empty, header,
+                                    false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+    {
+        return BVIEW_STATUS_SUCCESS;
+    }
+
+    json_memory_release(header);
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief        Gets the counters of a size class of a pool
+*
+* @param[in]    poolId      pool
+* @param[in]    size        size the class is looked up for, as with
+*                           json_memory_allocate()
+* @param[out]   stats       counters of the class
+*
+* @retval       BVIEW_STATUS_SUCCESS  counters are filled in
+* @retval       BVIEW_STATUS_INVALID_PARAMETER  invalid input parameter
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS json_memory_stats_get(int poolId, unsigned int size,
+                                   JSON_MEMORY_STATS_t *stats)
+{
+    _JSON_MEMORY_POOL_t *pPool;
+    _JSON_MEMORY_CLASS_t *pClass;
+    uint64_t frees;
+    int sizeClass;
+
+    _JSON_MEMORY_ASSERT(stats != NULL);
+    _JSON_MEMORY_ASSERT((poolId >= 0) && (poolId < JSON_MEMORY_MAX_POOLS));
+
+    pPool = &jsonMemory.pools[poolId];
+    _JSON_MEMORY_ASSERT(pPool->valid == true);
+
+    sizeClass = json_memory_class_get(pPool, size);
+    _JSON_MEMORY_ASSERT(sizeClass >= 0);
+
+    pClass = &pPool->classes[sizeClass];
+
+    memset(stats, 0, sizeof (JSON_MEMORY_STATS_t));
+    stats->size = pClass->size;
+    stats->maxBuffers = pClass->maxBuffers;
+
+    pthread_mutex_lock(&pClass->lock);
+    stats->numBuffers = pClass->numBuffers;
+    pthread_mutex_unlock(&pClass->lock);
+
+    stats->inUse = __atomic_load_n(&pClass->inUse, __ATOMIC_RELAXED);
+    stats->highWatermark = __atomic_load_n(&pClass->highWatermark, __ATOMIC_RELAXED);
+    stats->allocations = __atomic_load_n(&pClass->allocations, __ATOMIC_RELAXED);
+    stats->failures = __atomic_load_n(&pClass->failures, __ATOMIC_RELAXED);
+
+    frees = __atomic_load_n(&pClass->frees, __ATOMIC_RELAXED);
+    if (0 != frees)
+    {
+        stats->avgHoldTimeUsec = __atomic_load_n(&pClass->holdTimeUsec, __ATOMIC_RELAXED) / frees;
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief        Prints the counters of all classes of a pool
+*
+* @param[in]    poolId      pool
+*
+* @retval       NA
+*
+* @end
+*********************************************************************/
+void json_memory_dump(int poolId)
+{
+    JSON_MEMORY_STATS_t stats;
+    _JSON_MEMORY_POOL_t *pPool;
+    int sizeClass;
+
+    if ((poolId < 0) || (poolId >= JSON_MEMORY_MAX_POOLS) ||
+        (false == jsonMemory.pools[poolId].valid))
+    {
+        return;
+    }
+
+    pPool = &jsonMemory.pools[poolId];
+
+    printf (" %s Buffer Pool Statistics \n\n", pPool->name);
+    printf (" %10s %8s %8s %8s %8s %12s %10s %12s\n",
+            "Size", "Max", "Taken", "In Use", "Peak", "Allocations", "Failures", "Hold (us)");
+
+    for (sizeClass = 0; sizeClass < pPool->numClasses; sizeClass++)
+    {
+        if (BVIEW_STATUS_SUCCESS != json_memory_stats_get(poolId, pPool->classes[sizeClass].size, &stats))
+            continue;
+
+        printf (" %10u %8u %8u %8u %8u %12" PRIu64 " %10" PRIu64 " %12" PRIu64 "\n",
+                stats.size, stats.maxBuffers, stats.numBuffers, stats.inUse,
+                stats.highWatermark, stats.allocations, stats.failures,
+                stats.avgHoldTimeUsec);
+    }
+
+    printf("\n");
+}
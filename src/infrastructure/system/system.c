@@ -190,6 +190,18 @@ static BVIEW_STATUS system_agent_config_set_defaults(BVIEW_SYSTEM_AGENT_CONFIG_t
     /* setup default local port */
     config->localPort = SYSTEM_CONFIG_PROPERTY_LOCAL_PORT_DEFAULT;
 
+    /* setup default compression of the responses */
+    config->compressionLevel = SYSTEM_CONFIG_PROPERTY_COMPRESSION_LEVEL_DEFAULT;
+    config->compressionMinSize = SYSTEM_CONFIG_PROPERTY_COMPRESSION_MIN_SIZE_DEFAULT;
+    strncpy(&config->asyncEncoding[0], SYSTEM_CONFIG_PROPERTY_ASYNC_ENCODING_DEFAULT,
+            BVIEW_MAX_ENCODING_NAME_LENGTH - 1);
+
+    /* setup default number of workers of the REST requests */
+    config->restWorkers = SYSTEM_CONFIG_PROPERTY_REST_WORKERS_DEFAULT;
+
+    /* setup default publication of the BST stats in shared memory */
+    config->bstShmPublish = SYSTEM_CONFIG_PROPERTY_BST_SHM_PUBLISH_DEFAULT;
+
     LOG_POST(BVIEW_LOG_DEBUG, "SYSTEM : Using default configuration %s:%d <-->local:%d \n",
               config->clientIp, config->clientPort, config->localPort);
 
@@ -421,3 +433,156 @@ BVIEW_STATUS system_agent_port_set(int localPort)
    return BVIEW_STATUS_SUCCESS; 
 }
 
+/*********************************************************************
+* @brief      Function used to get the compression of the responses
+*
+*
+* @param[out]  level          zlib level, 0 if not compressed
+* @param[out]  minSize        smallest response compressed, in bytes
+* @param[out]  asyncEncoding  content encoding of the asynchronous
+*                             reports
+*
+* @retval     BVIEW_STATUS_SUCCESS
+* @retval     BVIEW_STATUS_FAILURE
+*
+* @note          NA
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS system_agent_compression_get(int *level, int *minSize, char *asyncEncoding)
+{
+  /* take the lock */
+  SYSTEM_AGENT_LOCK_TAKE(system_agent_mutex);
+  *level = system_agent_cfg.compressionLevel;
+  *minSize = system_agent_cfg.compressionMinSize;
+  strncpy(asyncEncoding, &system_agent_cfg.asyncEncoding[0], BVIEW_MAX_ENCODING_NAME_LENGTH - 1);
+  /* give lock */
+  SYSTEM_AGENT_LOCK_GIVE(system_agent_mutex);
+   return BVIEW_STATUS_SUCCESS; 
+}
+
+/*********************************************************************
+* @brief      Function used to set the compression of the responses
+*
+*
+* @param[in]   level          zlib level, 0 if not compressed
+* @param[in]   minSize        smallest response compressed, in bytes
+* @param[in]   asyncEncoding  content encoding of the asynchronous
+*                             reports
+*
+* @retval     BVIEW_STATUS_SUCCESS
+* @retval     BVIEW_STATUS_FAILURE
+*
+* @note          NA
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS system_agent_compression_set(int level, int minSize, const char *asyncEncoding)
+{
+  /* take the lock */
+  SYSTEM_AGENT_LOCK_TAKE(system_agent_mutex);
+  system_agent_cfg.compressionLevel = level;
+  system_agent_cfg.compressionMinSize = minSize;
+  memset(&system_agent_cfg.asyncEncoding[0], 0, BVIEW_MAX_ENCODING_NAME_LENGTH);
+  strncpy(&system_agent_cfg.asyncEncoding[0], asyncEncoding, BVIEW_MAX_ENCODING_NAME_LENGTH - 1);
+  /* give lock */
+  SYSTEM_AGENT_LOCK_GIVE(system_agent_mutex);
+   return BVIEW_STATUS_SUCCESS; 
+}
+
+/*********************************************************************
+* @brief      Function used to get the number of workers handling the
+*             REST requests
+*
+*
+* @param[out]  workers        number of workers
+*
+* @retval     BVIEW_STATUS_SUCCESS
+* @retval     BVIEW_STATUS_FAILURE
+*
+* @note          NA
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS system_agent_rest_workers_get(int *workers)
+{
+  /* take the lock */
+  SYSTEM_AGENT_LOCK_TAKE(system_agent_mutex);
+  *workers = system_agent_cfg.restWorkers;
+  /* give lock */
+  SYSTEM_AGENT_LOCK_GIVE(system_agent_mutex);
+   return BVIEW_STATUS_SUCCESS; 
+}
+
+/*********************************************************************
+* @brief      Function used to set the number of workers handling the
+*             REST requests
+*
+*
+* @param[in]   workers        number of workers
+*
+* @retval     BVIEW_STATUS_SUCCESS
+* @retval     BVIEW_STATUS_FAILURE
+*
+* @note          NA
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS system_agent_rest_workers_set(int workers)
+{
+  /* take the lock */
+  SYSTEM_AGENT_LOCK_TAKE(system_agent_mutex);
+  system_agent_cfg.restWorkers = workers;
+  /* give lock */
+  SYSTEM_AGENT_LOCK_GIVE(system_agent_mutex);
+   return BVIEW_STATUS_SUCCESS; 
+}
+
+/*********************************************************************
+* @brief      Function used to get whether the BST stats are published
+*             in shared memory
+*
+*
+* @param[out]  publish        true if they are published
+*
+* @retval     BVIEW_STATUS_SUCCESS
+* @retval     BVIEW_STATUS_FAILURE
+*
+* @note          NA
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS system_agent_bst_shm_publish_get(bool *publish)
+{
+  /* take the lock */
+  SYSTEM_AGENT_LOCK_TAKE(system_agent_mutex);
+  *publish = system_agent_cfg.bstShmPublish;
+  /* give lock */
+  SYSTEM_AGENT_LOCK_GIVE(system_agent_mutex);
+   return BVIEW_STATUS_SUCCESS; 
+}
+
+/*********************************************************************
+* @brief      Function used to set whether the BST stats are published
+*             in shared memory
+*
+*
+* @param[in]   publish        true to publish them
+*
+* @retval     BVIEW_STATUS_SUCCESS
+* @retval     BVIEW_STATUS_FAILURE
+*
+* @note          NA
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS system_agent_bst_shm_publish_set(bool publish)
+{
+  /* take the lock */
+  SYSTEM_AGENT_LOCK_TAKE(system_agent_mutex);
+  system_agent_cfg.bstShmPublish = publish;
+  /* give lock */
+  SYSTEM_AGENT_LOCK_GIVE(system_agent_mutex);
+   return BVIEW_STATUS_SUCCESS; 
+}
+
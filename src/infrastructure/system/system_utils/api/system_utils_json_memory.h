@@ -71,7 +71,11 @@ extern "C"
 {
 #endif
 
-/* A small implementation of a memory pool, that offers buffers in two sizes */
+/* The buffers of the system utils. They come from a json_memory pool,
+   which grows up to the following cap. */
+
+/* responses to the requests and heartbeats, at most */
+#define SYSTEM_UTILS_JSON_MEMORY_MAX_RESPONSES   32
 
 typedef enum _system_utils_json_memory_size_
 {
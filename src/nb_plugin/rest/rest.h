@@ -25,21 +25,67 @@ extern "C"
 #endif
 
 #include <stdio.h>
+#include <stdint.h>
 #include <errno.h>
 #include <stdbool.h>
 #include <arpa/inet.h>
 #include <pthread.h>
+#include <zlib.h>
 
 #include "broadview.h"
+#include "rest_api.h"
 #include "rest_debug.h"
 
 #define REST_MAX_STRING_LENGTH      128
 #define REST_MAX_HTTP_BUFFER_LENGTH 2048
 
-#define REST_MAX_SESSIONS    5
+/* room for the size line of a chunk, in hex */
+#define REST_MAX_CHUNK_SIZE_LENGTH  16
+
+/* clients connected at the same time, a session per connection */
+#define REST_MAX_SESSIONS    256
+
+/* events taken from epoll at a time */
+#define REST_MAX_EVENTS      64
+
+/* seconds a request without a Content-Length is waited for, it is
+   handled with what has arrived then */
+#define REST_REQUEST_TIMEOUT      2
+
+/* seconds an idle connection is kept open for the next request */
+#define REST_KEEPALIVE_TIMEOUT    60
 
 #define REST_MAX_IP_ADDR_LENGTH    20
 
+/* threads parsing and dispatching the requests, at most */
+#define REST_MAX_WORKERS           16
+
+/* asynchronous reports queued for the collector, at most, in number
+   and in bytes */
+#define REST_COLLECTOR_MAX_REPORTS    32
+#define REST_COLLECTOR_MAX_BYTES      (16 * 1024 * 1024)
+
+/* events queued for a client of the event streams, at most, in
+   number and bytes; the oldest are dropped for newer ones */
+#define REST_EVENT_STREAM_MAX_EVENTS  16
+#define REST_EVENT_STREAM_MAX_BYTES   (4 * 1024 * 1024)
+
+/* seconds an event stream stays quiet before a comment is sent to
+   keep the connection, and the proxies on the way, from timing out */
+#define REST_EVENT_STREAM_KEEPALIVE   15
+
+/* delay before connecting to the collector again, doubled with each
+   failure, in milliseconds */
+#define REST_COLLECTOR_BACKOFF_MIN    100
+#define REST_COLLECTOR_BACKOFF_MAX    30000
+
+/* seconds a report may take to go out before the connection is dropped */
+#define REST_COLLECTOR_SEND_TIMEOUT   5
+
+/* responses compressed at the same time, each holds the zlib streams
+   of the encodings it has been used for */
+#define REST_MAX_COMPRESSORS       2
+
 /* Macro to acquire lock */
 #define REST_LOCK_TAKE(_ptr)                                                        \
         {                                                                           \
@@ -93,14 +139,62 @@ typedef struct _rest_config_
     int clientPort;
 
     int localPort;
+
+    /* zlib level of the compressed responses, 0 to not compress */
+    int compressionLevel;
+
+    /* responses smaller than this are sent as they are */
+    int compressionMinSize;
+
+    /* compression of the asynchronous reports */
+    BVIEW_REST_ENCODING_t asyncEncoding;
+
+    /* threads parsing and dispatching the requests */
+    int workers;
 } REST_CONFIG_t;
 
-/* REST session */
+/* compressor of the responses, set up once and reset for each one */
+typedef struct _rest_compressor_
+{
+    /* is this compressor in use ? */
+    bool inUse;
+
+    /* encoding of the response being compressed */
+    BVIEW_REST_ENCODING_t encoding;
+
+    /* a stream per encoding, set up the first time it is used */
+    bool initialized[BVIEW_REST_ENCODING_MAX];
+    z_stream stream[BVIEW_REST_ENCODING_MAX];
+
+    /* level the streams are set to */
+    int level[BVIEW_REST_ENCODING_MAX];
+
+    /* output, grown as needed and kept */
+    unsigned char *buffer;
+    int size;
+} REST_COMPRESSOR_t;
+
+/* REST session, a connection of a client and the request on it being
+   handled. The requests of a connection are handled one at a time, in
+   the order they arrive */
 typedef struct _rest_session_
 {
     /* is this session in use ? */
     bool inUse;
 
+    /* is a request being handled ? the connection is not read till it
+       is answered */
+    bool busy;
+
+    /* has the request been answered since the server last looked ? */
+    bool answered;
+
+    /* is the connection kept once the request is answered ? */
+    bool keepAlive;
+
+    /* is the connection read by the server ? */
+    bool watched;
+
     /* http method */
     char httpMethod[REST_MAX_STRING_LENGTH+1];
 
@@ -122,22 +216,300 @@ typedef struct _rest_session_
     /* JSON content start, filled while parsing */
     char *json;
 
+    /* format the client takes a report in, from the Accept header */
+    BVIEW_REST_FORMAT_t accept;
+
+    /* compression the client takes, from the Accept-Encoding header */
+    BVIEW_REST_ENCODING_t acceptEncoding;
+
     /* peer address */
     struct sockaddr_in peerAddr;
 
     /* time the session is created */
     time_t creationTime;
 
+    /* bytes received and not handled yet, pipelined requests */
+    char input[REST_MAX_HTTP_BUFFER_LENGTH];
+    int inputLength;
+
+    /* time of the last bytes received, or of the last answer */
+    time_t lastActivity;
+
+    /* time the request is queued for the workers, in microseconds */
+    uint64_t queuedAt;
+
 } REST_SESSION_t;
 
+/* workers parsing and dispatching the requests framed by the server,
+   so that a slow handler does not hold the connections back */
+typedef struct _rest_workers_
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+
+    /* requests waiting for a worker, oldest first, from head */
+    REST_SESSION_t *queue[REST_MAX_SESSIONS];
+    int head;
+    int count;
+
+    /* most requests waiting at once */
+    int countMax;
+
+    /* requests being parsed and dispatched */
+    int dispatching;
+
+    /* requests taken by the workers, and the time they waited, in
+       microseconds */
+    uint64_t requests;
+    uint64_t waitTotal;
+    uint64_t waitMax;
+
+    /* workers started, and the ones of them taking requests */
+    pthread_t threads[REST_MAX_WORKERS];
+    int started;
+    int active;
+} REST_WORKERS_t;
+
+/* depths of the stages a request goes through, and the workers' counters */
+typedef struct _rest_queue_stats_
+{
+    /* workers taking requests */
+    int workers;
+
+    /* connections open */
+    int connections;
+
+    /* connections with bytes received and not handled yet, partial or
+       pipelined requests */
+    int buffered;
+
+    /* requests waiting for a worker, now and at most */
+    int queued;
+    int queuedMax;
+
+    /* requests being parsed and dispatched by the workers */
+    int dispatching;
+
+    /* requests handed to the applications and not answered yet */
+    int pending;
+
+    /* requests taken by the workers, and the time they waited for one,
+       in microseconds */
+    uint64_t requests;
+    uint64_t waitTotal;
+    uint64_t waitMax;
+} REST_QUEUE_STATS_t;
+
+/* an asynchronous report, HTTP header and body, waiting for the
+   collector */
+typedef struct _rest_collector_report_
+{
+    char *data;
+    int length;
+    int size;
+
+    /* report the data is shared with, NULL if the data is its own */
+    struct _rest_collector_report_ *origin;
+    /* reports holding the data of this one, itself included */
+    int refs;
+
+    /* kind of the report, a newer one of the same kind takes its place
+       in the queue, BVIEW_REST_REPORT_KIND_NONE if it is never replaced */
+    unsigned int kind;
+
+    struct _rest_collector_report_ *next;
+} REST_COLLECTOR_REPORT_t;
+
+/* counters of the asynchronous reports */
+typedef struct _rest_collector_stats_
+{
+    /* reports queued, now and at most, and their bytes */
+    int queued;
+    int queuedMax;
+    int queuedBytes;
+
+    /* is the collector connected ? */
+    bool connected;
+
+    /* delay before connecting again, in milliseconds */
+    int backoff;
+
+    /* reports handed to the queue, sent, dropped for newer ones on a
+       full queue, and dropped as the default collector is not there */
+    uint64_t posted;
+    uint64_t sent;
+    uint64_t dropped;
+    uint64_t discarded;
+
+    /* queued reports replaced by a newer one of the same kind */
+    uint64_t coalesced;
+
+    /* bytes sent */
+    uint64_t bytes;
+
+    /* connections made, failed, closed by the collector and dropped
+       on a failed send */
+    uint64_t connects;
+    uint64_t connectFailures;
+    uint64_t disconnects;
+    uint64_t sendFailures;
+} REST_COLLECTOR_STATS_t;
+
+/* the connection to the collector the asynchronous reports go to,
+   kept open and fed from a bounded queue by its own thread */
+typedef struct _rest_collector_
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    pthread_t thread;
+
+    struct _rest_context_ *rest;
+
+    /* subscriber the collector is of, -1 for the configured collector */
+    int subscriber;
+
+    /* is the thread running ? */
+    bool started;
+
+    /* collector of a subscriber, no ip if there is none */
+    char ip[REST_MAX_IP_ADDR_LENGTH];
+    int port;
+
+    /* reports waiting, oldest first */
+    REST_COLLECTOR_REPORT_t *head;
+    REST_COLLECTOR_REPORT_t *tail;
+    int count;
+    int bytes;
+
+    /* connection to the collector, -1 if there is none */
+    int fd;
+
+    /* has the connection sent a report ? */
+    bool used;
+
+    /* false if the collector closes the connection after a report */
+    bool persistent;
+
+    /* is the collector left at the defaults and not there ? */
+    bool absent;
+
+    /* is the collector changed ? */
+    bool reset;
+
+    /* delay before connecting again, in milliseconds, and when */
+    int backoff;
+    uint64_t retryAt;
+
+    REST_COLLECTOR_STATS_t stats;
+} REST_COLLECTOR_t;
+
+/* counters of the event streams */
+typedef struct _rest_event_stats_
+{
+    /* streams open */
+    int streams;
+
+    /* streams opened, and closed as the client went away */
+    uint64_t opened;
+    uint64_t closed;
+
+    /* events produced, queued on the streams, sent and dropped for
+       newer ones on a full stream */
+    uint64_t posted;
+    uint64_t queued;
+    uint64_t sent;
+    uint64_t dropped;
+} REST_EVENT_STATS_t;
+
+/* an event, formatted once and shared by the streams it is queued on */
+typedef struct _rest_event_
+{
+    char *data;
+    int length;
+
+    /* is it a comment keeping a quiet stream open ? */
+    bool comment;
+
+    /* streams holding the event */
+    int refs;
+} REST_EVENT_t;
+
+/* a connection taken over from a session to send events on, as they
+   are produced, till the client goes away */
+typedef struct _rest_event_stream_
+{
+    bool inUse;
+
+    /* socket of the client, its own descriptor */
+    int fd;
+
+    /* events the client asked for, as the application tells them */
+    unsigned int filter;
+
+    /* events waiting, oldest first, in a ring */
+    REST_EVENT_t *events[REST_EVENT_STREAM_MAX_EVENTS];
+    int head;
+    int count;
+    int bytes;
+
+    /* bytes of the oldest event already sent */
+    int offset;
+
+    /* time of the last bytes sent, in seconds */
+    time_t lastSend;
+
+    struct sockaddr_in peerAddr;
+} REST_EVENT_STREAM_t;
+
+/* the event streams, written by their own thread so that the thread
+   producing the events is never held by a client */
+typedef struct _rest_events_
+{
+    pthread_mutex_t mutex;
+    pthread_t thread;
+
+    /* eventfd the thread is woken up with when events are queued */
+    int wakeFd;
+
+    REST_EVENT_STREAM_t streams[BVIEW_REST_MAX_EVENT_STREAMS];
+
+    /* id of the last event */
+    uint64_t sequence;
+
+    REST_EVENT_STATS_t stats;
+} REST_EVENTS_t;
+
 typedef struct _rest_context_
 {
     REST_CONFIG_t config;
 
     REST_SESSION_t sessions[REST_MAX_SESSIONS];
 
+    /* protects the state of the sessions shared with the threads
+       answering the requests */
+    pthread_mutex_t session_mutex;
+
+    /* events of the server, and the eventfd it is woken up with when
+       a request is answered */
+    int epollFd;
+    int wakeFd;
+
     pthread_mutex_t config_mutex;
 
+    REST_COMPRESSOR_t compressors[REST_MAX_COMPRESSORS];
+
+    pthread_mutex_t compress_mutex;
+
+    REST_WORKERS_t workers;
+
+    REST_COLLECTOR_t collector;
+
+    /* collectors of the subscribers, started once they are set */
+    REST_COLLECTOR_t subscribers[BVIEW_REST_MAX_SUBSCRIBERS];
+
+    /* streams of the clients taking the events as they are produced */
+    REST_EVENTS_t events;
+
 } REST_CONTEXT_t;
 
 typedef BVIEW_STATUS(*BVIEW_REST_ERROR_HANDLER_t) (int fd,
@@ -164,6 +536,9 @@ void rest_session_dump(REST_SESSION_t *session);
 /* allocations an available session (returns the index) */
 BVIEW_STATUS rest_allocate_session(REST_CONTEXT_t *context, int *sessionId);
 
+/* hands the connection of an answered request back to the server */
+void rest_session_release(REST_CONTEXT_t *context, REST_SESSION_t *session, bool keep);
+
 /* initialize sessions */
 BVIEW_STATUS rest_sessions_init(REST_CONTEXT_t *context);
 
@@ -179,12 +554,148 @@ BVIEW_STATUS rest_send_400(int fd);
 /* sends a HTTP 500 message to the client  */
 BVIEW_STATUS rest_send_500(int fd);
 
-/* sends asynchronous report to client */
-BVIEW_STATUS rest_send_async_report(REST_CONTEXT_t *rest, char *buffer, int length);
+/* sends asynchronous report to client, or to the subscribers given,
+   a bit each */
+BVIEW_STATUS rest_send_async_report(REST_CONTEXT_t *rest, unsigned int subscribers,
+                                    unsigned int kind, const char *contentType,
+                                    BVIEW_REST_ENCODING_t encoding,
+                                    char *buffer, int length);
+
+/* connects to the client the asynchronous reports go to */
+BVIEW_STATUS rest_async_connect(REST_CONTEXT_t *rest, int *fd);
+
+/* connects to the collector of a subscriber */
+BVIEW_STATUS rest_async_connect_to(const char *ip, int port, int *fd);
+
+/* starts an asynchronous report with its HTTP header, of the given
+   length, or sent in chunks if the length is negative */
+REST_COLLECTOR_REPORT_t *rest_async_report_new(const char *contentType,
+                                               BVIEW_REST_ENCODING_t encoding,
+                                               int length);
+
+/* appends a chunk to an asynchronous report, a 0 length chunk ends it */
+BVIEW_STATUS rest_async_report_chunk(REST_COLLECTOR_REPORT_t *report,
+                                     const char *buffer, int length);
+
+/* sends all of a buffer */
+BVIEW_STATUS rest_send_all(int fd, const char *buffer, int length, int flags);
+
+/* sends the header of a HTTP 200 message sent in chunks */
+BVIEW_STATUS rest_send_200_chunked(int fd, const char *contentType,
+                                   BVIEW_REST_ENCODING_t encoding);
+
+/* sends a chunk of a message, a 0 length chunk ends it */
+BVIEW_STATUS rest_send_chunk(int fd, const char *buffer, int length);
 
 BVIEW_STATUS rest_http_server_run(REST_CONTEXT_t *rest);
 BVIEW_STATUS rest_session_validate(REST_CONTEXT_t *context, REST_SESSION_t *session);
-BVIEW_STATUS rest_send_200_with_data(int fd, char *buffer, int length);
+BVIEW_STATUS rest_send_200_with_data(int fd, const char *contentType,
+                                     BVIEW_REST_ENCODING_t encoding,
+                                     char *buffer, int length);
+
+/* sets up the compressors */
+BVIEW_STATUS rest_compress_init(REST_CONTEXT_t *rest);
+
+/* takes a compressor for a response of the given size, NULL if it is
+   to be sent as it is */
+REST_COMPRESSOR_t *rest_compressor_get(REST_CONTEXT_t *rest, BVIEW_REST_ENCODING_t encoding,
+                                       int length);
+
+/* compresses the next part of a response, the output is valid till
+   the next call */
+BVIEW_STATUS rest_compress(REST_COMPRESSOR_t *compressor, const char *buffer, int length,
+                           bool finish, const char **output, int *outputLength);
+
+/* returns a compressor taken with rest_compressor_get() */
+void rest_compressor_put(REST_CONTEXT_t *rest, REST_COMPRESSOR_t *compressor);
+
+/* changes the compression of the responses */
+BVIEW_STATUS rest_compression_config_modify(int level, int minSize, const char *asyncEncoding);
+
+/* handles a request framed by the server, from a worker */
+BVIEW_STATUS rest_process_http_request(REST_CONTEXT_t *rest, REST_SESSION_t *session);
+
+/* sets up the workers handling the requests */
+BVIEW_STATUS rest_workers_init(REST_CONTEXT_t *rest);
+
+/* sets the number of workers handling the requests */
+BVIEW_STATUS rest_workers_resize(REST_CONTEXT_t *rest, int count);
+
+/* queues a framed request for the workers */
+void rest_workers_post(REST_CONTEXT_t *rest, REST_SESSION_t *session);
+
+/* gets the depths of the stages of the requests */
+BVIEW_STATUS rest_workers_stats(REST_CONTEXT_t *rest, REST_QUEUE_STATS_t *stats);
+
+/* changes the number of workers handling the requests */
+BVIEW_STATUS rest_workers_config_modify(int workers);
+
+/* gets the depths of the stages of the requests */
+BVIEW_STATUS rest_queue_stats_get(REST_QUEUE_STATS_t *stats);
+
+/* gets the time, in microseconds */
+uint64_t rest_time_usec(void);
+
+/* allocates an asynchronous report */
+REST_COLLECTOR_REPORT_t *rest_collector_report_new(int size);
+
+/* appends bytes to an asynchronous report */
+BVIEW_STATUS rest_collector_report_append(REST_COLLECTOR_REPORT_t *report,
+                                          const char *buffer, int length);
+
+/* frees an asynchronous report */
+void rest_collector_report_free(REST_COLLECTOR_REPORT_t *report);
+
+/* starts the thread sending the asynchronous reports */
+BVIEW_STATUS rest_collector_init(REST_CONTEXT_t *rest);
+
+/* queues an asynchronous report for the collector, or for the
+   subscribers given, a bit each, which take it */
+BVIEW_STATUS rest_collector_post(REST_CONTEXT_t *rest, unsigned int subscribers,
+                                 REST_COLLECTOR_REPORT_t *report);
+
+/* drops the connection to the collector, which changed */
+void rest_collector_reset(REST_CONTEXT_t *rest);
+
+/* gets the counters of the asynchronous reports */
+BVIEW_STATUS rest_collector_stats(REST_CONTEXT_t *rest, REST_COLLECTOR_STATS_t *stats);
+
+/* gets the counters of the asynchronous reports */
+BVIEW_STATUS rest_collector_stats_get(REST_COLLECTOR_STATS_t *stats);
+
+/* sets the collector of a subscriber, an empty ip removes it */
+BVIEW_STATUS rest_subscriber_collector_set(REST_CONTEXT_t *rest, int subscriber,
+                                           const char *ip, int port);
+
+/* gets the counters of the reports of a subscriber */
+BVIEW_STATUS rest_subscriber_collector_stats(REST_CONTEXT_t *rest, int subscriber,
+                                             REST_COLLECTOR_STATS_t *stats);
+
+/* gets the counters of the reports of a subscriber */
+BVIEW_STATUS rest_subscriber_stats_get(int subscriber, REST_COLLECTOR_STATS_t *stats);
+
+/* starts the thread writing the event streams */
+BVIEW_STATUS rest_events_init(REST_CONTEXT_t *rest);
+
+/* takes the connection of a session over for an event stream */
+BVIEW_STATUS rest_event_stream_add(REST_CONTEXT_t *rest, REST_SESSION_t *session,
+                                   unsigned int filter);
+
+/* gets the filters of the open event streams, each once */
+int rest_event_stream_filters(REST_CONTEXT_t *rest, unsigned int *filters, int max);
+
+/* queues an event on the streams of the filter */
+BVIEW_STATUS rest_event_post(REST_CONTEXT_t *rest, unsigned int filter,
+                             const char *name, const char *buffer, int length);
+
+/* gets the counters of the event streams */
+BVIEW_STATUS rest_event_stats(REST_CONTEXT_t *rest, REST_EVENT_STATS_t *stats);
+
+/* gets the counters of the event streams */
+BVIEW_STATUS rest_event_stats_get(REST_EVENT_STATS_t *stats);
+
+/* gets the encoding of its name, identity for an unknown one */
+BVIEW_REST_ENCODING_t rest_encoding_from_name(const char *name);
 
 /******************************************************************
  * @brief  sends a HTTP 404 message to the client 
@@ -69,6 +69,11 @@ const char json_error_async[] = "{     \
 extern pthread_mutex_t rest_server_mutex;
 static int restServerListenFd = 0; 
 
+/* content type of a response, by its format */
+#define REST_CONTENT_TYPE(_format)                                      \
+        ((BVIEW_REST_FORMAT_CBOR == (_format)) ? REST_HTTP_CONTENT_TYPE_CBOR : \
+                                                 REST_HTTP_CONTENT_TYPE_JSON)
+
 /******************************************************************
  * @brief  Initializes the REST component.  
  * 
@@ -87,10 +92,26 @@ BVIEW_STATUS rest_init(void)
     status = rest_config_init(&rest);
     _REST_ASSERT_ERROR( (status == BVIEW_STATUS_SUCCESS), BVIEW_STATUS_FAILURE);
 
+    /* Initialize the compressors of the responses */
+    status = rest_compress_init(&rest);
+    _REST_ASSERT_ERROR( (status == BVIEW_STATUS_SUCCESS), BVIEW_STATUS_FAILURE);
+
     /* Initialize the session table */
     status = rest_sessions_init(&rest);
     _REST_ASSERT_ERROR( (status == BVIEW_STATUS_SUCCESS), BVIEW_STATUS_FAILURE);
 
+    /* Start the workers handling the requests */
+    status = rest_workers_init(&rest);
+    _REST_ASSERT_ERROR( (status == BVIEW_STATUS_SUCCESS), BVIEW_STATUS_FAILURE);
+
+    /* Start the thread sending the asynchronous reports */
+    status = rest_collector_init(&rest);
+    _REST_ASSERT_ERROR( (status == BVIEW_STATUS_SUCCESS), BVIEW_STATUS_FAILURE);
+
+    /* Start the thread writing the event streams */
+    status = rest_events_init(&rest);
+    _REST_ASSERT_ERROR( (status == BVIEW_STATUS_SUCCESS), BVIEW_STATUS_FAILURE);
+
     /* Initialize and Start the webserver */
     status = rest_http_server_run(&rest);
     _REST_ASSERT_ERROR( (status == BVIEW_STATUS_SUCCESS), BVIEW_STATUS_FAILURE);
@@ -98,6 +119,29 @@ BVIEW_STATUS rest_init(void)
     return status;
 }
 
+/******************************************************************
+ * @brief  Gets the compression of a response
+ * 
+ * @note   A response to a request is compressed as the client
+ *         accepts, an asynchronous report as configured.
+ *********************************************************************/
+static BVIEW_REST_ENCODING_t rest_response_encoding(REST_SESSION_t *session)
+{
+    BVIEW_REST_ENCODING_t encoding = BVIEW_REST_ENCODING_IDENTITY;
+
+    if (NULL != session)
+    {
+      return session->acceptEncoding;
+    }
+
+    if (0 == pthread_mutex_lock(&rest.config_mutex))
+    {
+      encoding = rest.config.asyncEncoding;
+      pthread_mutex_unlock(&rest.config_mutex);
+    }
+    return encoding;
+}
+
 /******************************************************************
  * @brief  Sends response to a client 
  * 
@@ -107,7 +151,25 @@ BVIEW_STATUS rest_init(void)
  *********************************************************************/
 BVIEW_STATUS rest_response_send(void *cookie, char *pBuf, int size)
 {
-    REST_SESSION_t *session = (REST_SESSION_t *) cookie;
+    return rest_response_send_format(cookie, pBuf, size, BVIEW_REST_FORMAT_JSON);
+}
+
+/******************************************************************
+ * @brief  Sends response to a client, or an asynchronous report to
+ *         the collector or the subscribers, in the given format
+ * 
+ * @note   The subscribers are a bit each, the asynchronous report
+ *         goes to the configured collector if there are none. It
+ *         replaces the queued one of the same kind, if any.
+ *********************************************************************/
+static BVIEW_STATUS rest_response_send_to(REST_SESSION_t *session, unsigned int subscribers,
+                                          unsigned int kind, char *pBuf, int size,
+                                          BVIEW_REST_FORMAT_t format)
+{
+    REST_COMPRESSOR_t *compressor = NULL;
+    BVIEW_REST_ENCODING_t encoding = BVIEW_REST_ENCODING_IDENTITY;
+    const char *data = NULL;
+    int length = 0;
     BVIEW_STATUS status;
 
     /* if input is not valid, we still need to clean up session, if valid */
@@ -115,8 +177,8 @@ BVIEW_STATUS rest_response_send(void *cookie, char *pBuf, int size)
     {
         if (rest_session_validate(&rest, session) == BVIEW_STATUS_SUCCESS)
         {
-            close(session->connectionFd);
-            session->inUse = false;
+            /* the client gets no answer, it is not left waiting for one */
+            rest_session_release(&rest, session, false);
         }
 
         return BVIEW_STATUS_INVALID_PARAMETER;
@@ -126,27 +188,329 @@ BVIEW_STATUS rest_response_send(void *cookie, char *pBuf, int size)
       return BVIEW_STATUS_INVALID_PARAMETER;
     }
 
+    if (session != NULL)
+    {
+        status = rest_session_validate(&rest, session);
+        if (status != BVIEW_STATUS_SUCCESS)
+        {
+            return status;
+        }
+    }
+
+    /* compressed if negotiated and large enough, as it is otherwise */
+    compressor = rest_compressor_get(&rest, rest_response_encoding(session), size);
+    if ((NULL != compressor) &&
+        (BVIEW_STATUS_SUCCESS == rest_compress(compressor, pBuf, size, true, &data, &length)))
+    {
+        encoding = compressor->encoding;
+        pBuf = (char *) data;
+        size = length;
+    }
+
     /* session == NULL indicates an asynchronous send. 
      * It needs to be handled differently. 
      */
+    if (session != NULL)
+    {
+        status = rest_send_200_with_data(session->connectionFd, REST_CONTENT_TYPE(format),
+                                         encoding, pBuf, size);
+
+        rest_session_release(&rest, session, (BVIEW_STATUS_SUCCESS == status));
+    }
+    else
+    {
+        /* asynchronous data sending */
+        status = rest_send_async_report(&rest, subscribers, kind, REST_CONTENT_TYPE(format),
+                                        encoding, pBuf, size);
+    }
+
+    rest_compressor_put(&rest, compressor);
+    return status;
+}
+
+/******************************************************************
+ * @brief  Sends response to a client, in the given format
+ * 
+ * @note   As rest_response_send(), the HTTP header carries the
+ *         content type of the format. The buffer may be binary,
+ *         size is what is sent.
+ *********************************************************************/
+BVIEW_STATUS rest_response_send_format(void *cookie, char *pBuf, int size,
+                                       BVIEW_REST_FORMAT_t format)
+{
+    return rest_response_send_to((REST_SESSION_t *) cookie, 0, BVIEW_REST_REPORT_KIND_NONE,
+                                 pBuf, size, format);
+}
+
+/******************************************************************
+ * @brief  Sends an asynchronous report to subscribers
+ * 
+ * @note   The report is compressed and queued once, the subscribers
+ *         share it.
+ *********************************************************************/
+BVIEW_STATUS rest_report_send(unsigned int subscribers, unsigned int kind,
+                              char *pBuf, int size, BVIEW_REST_FORMAT_t format)
+{
+    return rest_response_send_to(NULL, subscribers, kind, pBuf, size, format);
+}
+
+/******************************************************************
+ * @brief  Gets the format a client takes a report in
+ * 
+ * @note   The cookie is the 'session', the format is the one the
+ *         Accept header of the request asked for. JSON, unless the
+ *         client named CBOR there.
+ *********************************************************************/
+BVIEW_STATUS rest_response_format_get(void *cookie, BVIEW_REST_FORMAT_t *format)
+{
+    REST_SESSION_t *session = (REST_SESSION_t *) cookie;
+    BVIEW_STATUS status;
+
+    if ((NULL == session) || (NULL == format))
+    {
+      return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    status = rest_session_validate(&rest, session);
+    if (BVIEW_STATUS_SUCCESS != status)
+    {
+      return status;
+    }
+
+    *format = (BVIEW_REST_FORMAT_CBOR == session->accept) ? BVIEW_REST_FORMAT_CBOR :
+                                                             BVIEW_REST_FORMAT_JSON;
+    return BVIEW_STATUS_SUCCESS;
+}
+
+
+/******************************************************************
+ * @brief  Starts a response which is sent in chunks
+ * 
+ * @note   The cookie is the 'session', as for rest_response_send().
+ *         The HTTP header goes out with the first chunk. An
+ *         asynchronous report is gathered, and queued for the client
+ *         once complete.
+ *********************************************************************/
+BVIEW_STATUS rest_response_stream_open(void *cookie, BVIEW_REST_FORMAT_t format,
+                                       BVIEW_REST_STREAM_t *stream)
+{
+    REST_SESSION_t *session = (REST_SESSION_t *) cookie;
+    BVIEW_STATUS status;
+
+    if (NULL == stream)
+    {
+      return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    memset(stream, 0, sizeof (BVIEW_REST_STREAM_t));
+    stream->cookie = cookie;
+    stream->fd = -1;
+    stream->format = format;
+
     if (session != NULL)
     {
         status = rest_session_validate(&rest, session);
         if (status == BVIEW_STATUS_SUCCESS)
         {
-            status = rest_send_200_with_data(session->connectionFd, pBuf, size);
+            stream->fd = session->connectionFd;
+            stream->encoding = rest_response_encoding(session);
         }
-
-        close(session->connectionFd);
-        session->inUse = false;
         return status;
     }
 
-    /* asynchronous data sending */
-    status = rest_send_async_report(&rest, pBuf, size);
+    /* the report is gathered and queued for the client on close */
+    stream->encoding = rest_response_encoding(NULL);
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Starts an asynchronous report for subscribers, which is
+ *         sent in chunks
+ * 
+ * @note   As rest_response_stream_open() with a NULL cookie. The
+ *         report is queued once complete, the subscribers share it.
+ *         It replaces the queued one of the same kind, if any.
+ *********************************************************************/
+BVIEW_STATUS rest_report_stream_open(unsigned int subscribers, unsigned int kind,
+                                     BVIEW_REST_FORMAT_t format,
+                                     BVIEW_REST_STREAM_t *stream)
+{
+    BVIEW_STATUS status;
+
+    status = rest_response_stream_open(NULL, format, stream);
+    if (BVIEW_STATUS_SUCCESS == status)
+    {
+      stream->subscribers = subscribers;
+      stream->kind = kind;
+    }
     return status;
 }
 
+/******************************************************************
+ * @brief  Sends a chunk of a response, or adds it to the
+ *         asynchronous report
+ * 
+ * @note   A 0 length chunk ends the response
+ *********************************************************************/
+static BVIEW_STATUS rest_response_stream_chunk(BVIEW_REST_STREAM_t *stream,
+                                               const char *pBuf, int size)
+{
+    if (NULL == stream->cookie)
+    {
+      return rest_async_report_chunk((REST_COLLECTOR_REPORT_t *) stream->report, pBuf, size);
+    }
+
+    return rest_send_chunk(stream->fd, pBuf, size);
+}
+
+/******************************************************************
+ * @brief  Sends the next chunk of a response
+ * 
+ * @note   The HTTP header is sent ahead of the first chunk. The
+ *         response is compressed if negotiated and the first chunk
+ *         is of the minimum size, a smaller one is the whole response.
+ *         zlib may hold a chunk back, the rest goes out on close.
+ *********************************************************************/
+BVIEW_STATUS rest_response_stream_send(BVIEW_REST_STREAM_t *stream, const char *pBuf, int size)
+{
+    REST_COMPRESSOR_t *compressor;
+    BVIEW_STATUS status;
+
+    if ((NULL == stream) || (NULL == pBuf))
+    {
+      return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    if ((-1 == stream->fd) && (NULL != stream->cookie))
+    {
+      return BVIEW_STATUS_FAILURE;
+    }
+
+    if (false == stream->started)
+    {
+      stream->compressor = rest_compressor_get(&rest, stream->encoding, size);
+      if (NULL == stream->compressor)
+      {
+        stream->encoding = BVIEW_REST_ENCODING_IDENTITY;
+      }
+
+      if (NULL == stream->cookie)
+      {
+        stream->report = rest_async_report_new(REST_CONTENT_TYPE(stream->format),
+                                               stream->encoding, -1);
+        status = (NULL != stream->report) ? BVIEW_STATUS_SUCCESS :
+                                            BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+      }
+      else
+      {
+        status = rest_send_200_chunked(stream->fd, REST_CONTENT_TYPE(stream->format),
+                                       stream->encoding);
+      }
+      if (BVIEW_STATUS_SUCCESS != status)
+      {
+        return status;
+      }
+      stream->started = true;
+    }
+
+    compressor = (REST_COMPRESSOR_t *) stream->compressor;
+    if ((NULL != compressor) && (0 < size))
+    {
+      status = rest_compress(compressor, pBuf, size, false, &pBuf, &size);
+      if (BVIEW_STATUS_SUCCESS != status)
+      {
+        return status;
+      }
+    }
+
+    /* a 0 length chunk would end the response */
+    if (0 >= size)
+    {
+      return BVIEW_STATUS_SUCCESS;
+    }
+
+    return rest_response_stream_chunk(stream, pBuf, size);
+}
+
+/******************************************************************
+ * @brief  Ends a response sent in chunks
+ * 
+ * @note   rv is the status of the response. A successful one gets the
+ *         last chunk. A failed one, which has not sent anything yet,
+ *         is answered with the JSON error code like
+ *         rest_response_send_error() does, and cut short otherwise.
+ *         A complete asynchronous report is queued for the client,
+ *         one cut short is dropped. The connection of a client is
+ *         kept if the response made it out.
+ *********************************************************************/
+BVIEW_STATUS rest_response_stream_close(BVIEW_REST_STREAM_t *stream, BVIEW_STATUS rv, int id)
+{
+    REST_SESSION_t *session;
+    BVIEW_STATUS status = rv;
+    const char *data = NULL;
+    int length = 0;
+
+    if (NULL == stream)
+    {
+      return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    session = (REST_SESSION_t *) stream->cookie;
+
+    if ((BVIEW_STATUS_SUCCESS != rv) && (false == stream->started) && (NULL != session))
+    {
+      /* the client gets the error instead, this closes the session */
+      rest_response_send_error(session, rv, id);
+      return rv;
+    }
+
+    if ((BVIEW_STATUS_SUCCESS == rv) && ((-1 != stream->fd) || (NULL == session)))
+    {
+      /* an empty response gets its header too */
+      status = rest_response_stream_send(stream, "", 0);
+
+      /* what the compressor held back */
+      if ((BVIEW_STATUS_SUCCESS == status) && (NULL != stream->compressor))
+      {
+        status = rest_compress((REST_COMPRESSOR_t *) stream->compressor, NULL, 0, true,
+                               &data, &length);
+        if ((BVIEW_STATUS_SUCCESS == status) && (0 < length))
+        {
+          status = rest_response_stream_chunk(stream, data, length);
+        }
+      }
+
+      if (BVIEW_STATUS_SUCCESS == status)
+      {
+        status = rest_response_stream_chunk(stream, NULL, 0);
+      }
+    }
+
+    rest_compressor_put(&rest, (REST_COMPRESSOR_t *) stream->compressor);
+    stream->compressor = NULL;
+
+    if (NULL != session)
+    {
+      rest_session_release(&rest, session, (BVIEW_STATUS_SUCCESS == status));
+    }
+    else if (NULL != stream->report)
+    {
+      if ((BVIEW_STATUS_SUCCESS == rv) && (BVIEW_STATUS_SUCCESS == status))
+      {
+        ((REST_COLLECTOR_REPORT_t *) stream->report)->kind = stream->kind;
+        status = rest_collector_post(&rest, stream->subscribers,
+                                     (REST_COLLECTOR_REPORT_t *) stream->report);
+      }
+      else
+      {
+        rest_collector_report_free((REST_COLLECTOR_REPORT_t *) stream->report);
+      }
+    }
+    stream->report = NULL;
+    stream->fd = -1;
+
+    return status;
+}
 
 /******************************************************************
  * @brief  Sends successful response to a client 
@@ -170,8 +534,7 @@ BVIEW_STATUS rest_response_send_ok (void *cookie)
       return ret;
 
     ret = rest_send_200(fd);
-    close(session->connectionFd);
-    session->inUse = false;
+    rest_session_release(&rest, session, (BVIEW_STATUS_SUCCESS == ret));
     return ret;
 
 }
@@ -229,8 +592,7 @@ BVIEW_STATUS rest_send_json_error(void *cookie,  BVIEW_STATUS rv, int id)
 
   /* call the api to prepare the json info and send */
     ret = rest_json_error_fn_invoke(fd, rv, id);
-    close(session->connectionFd);
-    session->inUse = false;
+    rest_session_release(&rest, session, (BVIEW_STATUS_SUCCESS == ret));
     return ret;
 }
 
@@ -299,7 +661,9 @@ BVIEW_STATUS rest_send_json_error_async(BVIEW_STATUS rv)
   snprintf(json, REST_JSON_BUFF_LEN, json_error_async, json_val, str, BVIEW_JSON_VERSION);
 
   /* call the function to send the json error */
-  ret_json = rest_send_async_report(&rest, json, strlen(json));
+  ret_json = rest_send_async_report(&rest, 0, BVIEW_REST_REPORT_KIND_NONE,
+                                    REST_HTTP_CONTENT_TYPE_JSON,
+                                    BVIEW_REST_ENCODING_IDENTITY, json, strlen(json));
   return ret_json;
 }
 
@@ -385,10 +749,192 @@ int rest_agent_config_params_modify(char *ipaddr, unsigned int clientPort)
 
      REST_LOCK_GIVE(ptr);
 
+     /* the reports go to the new client from now on */
+     rest_collector_reset(ptr);
+
      return 0;
 }
 
 
+/******************************************************************
+ * @brief  Changes the compression of the responses
+ *
+ * @param[in]   level          zlib level, 0 to not compress
+ * @param[in]   minSize        smallest response compressed, in bytes
+ * @param[in]   asyncEncoding  name of the content encoding of the
+ *                             asynchronous reports
+ *
+ * @retval   BVIEW_STATUS_SUCCESS when the configuration is changed
+ *
+ * @note     the responses being sent keep the level they started with
+ *********************************************************************/
+BVIEW_STATUS rest_compression_config_modify(int level, int minSize, const char *asyncEncoding)
+{
+  REST_CONTEXT_t *ptr;
+
+  ptr = &rest;
+
+     REST_LOCK_TAKE(ptr);
+
+     ptr->config.compressionLevel = level;
+     ptr->config.compressionMinSize = minSize;
+     ptr->config.asyncEncoding = rest_encoding_from_name(asyncEncoding);
+
+     REST_LOCK_GIVE(ptr);
+
+     return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  This function changes the number of workers handling the
+ *         requests
+ *
+ * @param[in]   workers      number of workers, 1 to REST_MAX_WORKERS
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if the workers are set
+ *
+ * @note     A pool made smaller keeps its extra workers parked
+ *********************************************************************/
+BVIEW_STATUS rest_workers_config_modify(int workers)
+{
+  REST_CONTEXT_t *ptr;
+
+  ptr = &rest;
+
+     REST_LOCK_TAKE(ptr);
+     ptr->config.workers = workers;
+     REST_LOCK_GIVE(ptr);
+
+     return rest_workers_resize(ptr, workers);
+}
+
+/******************************************************************
+ * @brief  This function gets the depths of the stages a request
+ *         goes through, framed, queued for a worker, dispatched,
+ *         answered
+ *
+ * @param[out]   stats      depths and counters
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ *
+ * @note
+ *********************************************************************/
+BVIEW_STATUS rest_queue_stats_get(REST_QUEUE_STATS_t *stats)
+{
+  if (NULL == stats)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  return rest_workers_stats(&rest, stats);
+}
+
+/******************************************************************
+ * @brief  This function gets the counters of the asynchronous
+ *         reports and of the connection they go out on
+ *
+ * @param[out]   stats      counters
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ *
+ * @note
+ *********************************************************************/
+BVIEW_STATUS rest_collector_stats_get(REST_COLLECTOR_STATS_t *stats)
+{
+  if (NULL == stats)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  return rest_collector_stats(&rest, stats);
+}
+
+/******************************************************************
+ * @brief  Sets the collector the reports of a subscriber go to
+ * 
+ * @note   An empty ip removes it
+ *********************************************************************/
+BVIEW_STATUS rest_subscriber_set(int subscriber, const char *ip, int port)
+{
+  return rest_subscriber_collector_set(&rest, subscriber, ip, port);
+}
+
+/******************************************************************
+ * @brief  Gets the counters of the reports of a subscriber
+ * 
+ * @note   
+ *********************************************************************/
+BVIEW_STATUS rest_subscriber_stats_get(int subscriber, REST_COLLECTOR_STATS_t *stats)
+{
+  if (NULL == stats)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  return rest_subscriber_collector_stats(&rest, subscriber, stats);
+}
+
+/******************************************************************
+ * @brief  Turns the connection of a request into an event stream
+ * 
+ * @note   The session is answered with the header of the stream and
+ *         released, the connection is the stream's from then on.
+ *         A failed one is answered by the caller.
+ *********************************************************************/
+BVIEW_STATUS rest_event_stream_start(void *cookie, unsigned int filter)
+{
+  BVIEW_STATUS ret;
+  REST_SESSION_t *session = (REST_SESSION_t *) cookie;
+
+  if (NULL == cookie)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  ret = rest_session_validate(&rest, session);
+  if (BVIEW_STATUS_SUCCESS != ret)
+    return ret;
+
+  ret = rest_event_stream_add(&rest, session, filter);
+  if (BVIEW_STATUS_SUCCESS == ret)
+  {
+    rest_session_release(&rest, session, false);
+  }
+  return ret;
+}
+
+/******************************************************************
+ * @brief  Gets the filters of the open event streams
+ * 
+ * @note   
+ *********************************************************************/
+int rest_event_filters_get(unsigned int *filters, int max)
+{
+  if (NULL == filters)
+    return 0;
+
+  return rest_event_stream_filters(&rest, filters, max);
+}
+
+/******************************************************************
+ * @brief  Sends an event to the streams of a filter
+ * 
+ * @note   
+ *********************************************************************/
+BVIEW_STATUS rest_event_send(unsigned int filter, const char *name,
+                             const char *pBuf, int size)
+{
+  if ((NULL == name) || (NULL == pBuf) || (0 > size))
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  return rest_event_post(&rest, filter, name, pBuf, size);
+}
+
+/******************************************************************
+ * @brief  Gets the counters of the event streams
+ * 
+ * @note   
+ *********************************************************************/
+BVIEW_STATUS rest_event_stats_get(REST_EVENT_STATS_t *stats)
+{
+  if (NULL == stats)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  return rest_event_stats(&rest, stats);
+}
+
 /******************************************************************
  * @brief  This function creates a web server socket .
  *
@@ -0,0 +1,846 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include "broadview.h"
+#include "rest.h"
+#include "rest_http.h"
+
+/******************************************************************
+ * @brief  allocates an asynchronous report
+ *
+ * @param[in]   size      bytes expected, the report grows past them
+ *
+ * @retval   the report, NULL if out of memory
+ *
+ * @note
+ *********************************************************************/
+REST_COLLECTOR_REPORT_t *rest_collector_report_new(int size)
+{
+    REST_COLLECTOR_REPORT_t *report;
+
+    report = (REST_COLLECTOR_REPORT_t *) calloc(1, sizeof (REST_COLLECTOR_REPORT_t));
+    if (NULL == report)
+        return NULL;
+
+    report->size = (size > 0) ? size : REST_MAX_HTTP_BUFFER_LENGTH;
+    report->data = (char *) malloc(report->size);
+    if (NULL == report->data)
+    {
+        free(report);
+        return NULL;
+    }
+    report->refs = 1;
+
+    return report;
+}
+
+/******************************************************************
+ * @brief  gets a report sharing the data of another one
+ *
+ * @param[in]   report    complete report
+ *
+ * @retval   the report, NULL if out of memory
+ *
+ * @note     The data is freed with the last report holding it, it is
+ *           not to be appended to any more
+ *********************************************************************/
+static REST_COLLECTOR_REPORT_t *rest_collector_report_share(REST_COLLECTOR_REPORT_t *report)
+{
+    REST_COLLECTOR_REPORT_t *share;
+
+    share = (REST_COLLECTOR_REPORT_t *) calloc(1, sizeof (REST_COLLECTOR_REPORT_t));
+    if (NULL == share)
+        return NULL;
+
+    share->data = report->data;
+    share->length = report->length;
+    share->size = report->size;
+    share->kind = report->kind;
+    share->origin = report;
+    __atomic_add_fetch(&report->refs, 1, __ATOMIC_ACQ_REL);
+
+    return share;
+}
+
+/******************************************************************
+ * @brief  appends bytes to an asynchronous report
+ *
+ * @param[in]   report    report being built
+ * @param[in]   buffer    bytes to append
+ * @param[in]   length    number of bytes
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if appended
+ * @retval   BVIEW_STATUS_RESOURCE_NOT_AVAILABLE if out of memory
+ *
+ * @note
+ *********************************************************************/
+BVIEW_STATUS rest_collector_report_append(REST_COLLECTOR_REPORT_t *report,
+                                          const char *buffer, int length)
+{
+    char *data;
+    int size = report->size;
+
+    while (report->length + length > size)
+        size *= 2;
+
+    if (size != report->size)
+    {
+        data = (char *) realloc(report->data, size);
+        if (NULL == data)
+            return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+        report->data = data;
+        report->size = size;
+    }
+
+    memcpy(&report->data[report->length], buffer, length);
+    report->length += length;
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  frees an asynchronous report
+ *
+ * @note     The data goes with the last report holding it
+ *********************************************************************/
+void rest_collector_report_free(REST_COLLECTOR_REPORT_t *report)
+{
+    REST_COLLECTOR_REPORT_t *origin;
+
+    if (NULL == report)
+        return;
+
+    origin = (NULL != report->origin) ? report->origin : report;
+    if (origin != report)
+        free(report);
+
+    if (0 == __atomic_sub_fetch(&origin->refs, 1, __ATOMIC_ACQ_REL))
+    {
+        free(origin->data);
+        free(origin);
+    }
+}
+
+/******************************************************************
+ * @brief  drops the oldest reports of a full queue
+ *
+ * @param[in]   collector    collector, locked
+ *
+ * @note     A newer report supersedes an older one, a report over
+ *           the byte bound is kept if it is the only one
+ *********************************************************************/
+static void rest_collector_trim(REST_COLLECTOR_t *collector)
+{
+    REST_COLLECTOR_REPORT_t *report;
+
+    while ((collector->count > REST_COLLECTOR_MAX_REPORTS) ||
+           ((collector->bytes > REST_COLLECTOR_MAX_BYTES) && (collector->count > 1)))
+    {
+        report = collector->head;
+        collector->head = report->next;
+        collector->count--;
+        collector->bytes -= report->length;
+        collector->stats.dropped++;
+        rest_collector_report_free(report);
+    }
+
+    if (NULL == collector->head)
+        collector->tail = NULL;
+}
+
+/******************************************************************
+ * @brief  finds the queued report a report supersedes
+ *
+ * @param[in]   collector    collector, locked
+ * @param[in]   kind         kind of the report
+ * @param[out]  prev         report before the one found, NULL if it
+ *                           is the first
+ *
+ * @retval   the queued report of the kind, NULL if there is none or
+ *           the report is of no kind
+ *********************************************************************/
+static REST_COLLECTOR_REPORT_t *rest_collector_superseded(REST_COLLECTOR_t *collector,
+                                                          unsigned int kind,
+                                                          REST_COLLECTOR_REPORT_t **prev)
+{
+    REST_COLLECTOR_REPORT_t *report;
+
+    *prev = NULL;
+    if (BVIEW_REST_REPORT_KIND_NONE == kind)
+        return NULL;
+
+    for (report = collector->head; NULL != report; report = report->next)
+    {
+        if (kind == report->kind)
+            return report;
+        *prev = report;
+    }
+
+    return NULL;
+}
+
+/******************************************************************
+ * @brief  drops all the queued reports
+ *
+ * @param[in]   collector    collector, locked
+ *
+ * @note     For the default collector, which is not there
+ *********************************************************************/
+static void rest_collector_discard(REST_COLLECTOR_t *collector)
+{
+    REST_COLLECTOR_REPORT_t *report;
+
+    while (NULL != collector->head)
+    {
+        report = collector->head;
+        collector->head = report->next;
+        collector->stats.discarded++;
+        rest_collector_report_free(report);
+    }
+
+    collector->tail = NULL;
+    collector->count = 0;
+    collector->bytes = 0;
+}
+
+/******************************************************************
+ * @brief  puts back the reports a connection failed to send
+ *
+ * @param[in]   collector    collector, locked
+ * @param[in]   batch        reports not sent, oldest first
+ *
+ * @note     They are older than the ones queued since, and are the
+ *           first dropped if the queue is full. One a report queued
+ *           since supersedes is dropped.
+ *********************************************************************/
+static void rest_collector_requeue(REST_COLLECTOR_t *collector, REST_COLLECTOR_REPORT_t *batch)
+{
+    REST_COLLECTOR_REPORT_t *first = NULL, *last = NULL, *report, *prev;
+    int count = 0, bytes = 0;
+
+    while (NULL != batch)
+    {
+        report = batch;
+        batch = report->next;
+
+        if (NULL != rest_collector_superseded(collector, report->kind, &prev))
+        {
+            collector->stats.coalesced++;
+            rest_collector_report_free(report);
+            continue;
+        }
+
+        report->next = NULL;
+        if (NULL == last)
+            first = report;
+        else
+            last->next = report;
+        last = report;
+        count++;
+        bytes += report->length;
+    }
+
+    if (NULL == first)
+        return;
+
+    batch = first;
+    last->next = collector->head;
+    if (NULL == collector->head)
+        collector->tail = last;
+    collector->head = batch;
+    collector->count += count;
+    collector->bytes += bytes;
+
+    rest_collector_trim(collector);
+}
+
+/******************************************************************
+ * @brief  reads the answers of the collector, which are not looked at
+ *
+ * @param[in]   collector    collector
+ * @param[in]   fd           connection to the collector
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if the connection is still open
+ * @retval   BVIEW_STATUS_FAILURE if the collector closed it
+ *
+ * @note     Answers left unread would stop the collector once the
+ *           socket buffers are full. A collector answering with
+ *           "Connection: close" gets one report per connection.
+ *********************************************************************/
+static BVIEW_STATUS rest_collector_drain(REST_COLLECTOR_t *collector, int fd)
+{
+    char buf[REST_MAX_HTTP_BUFFER_LENGTH + 1];
+    int length, i, nameLength = strlen(REST_HTTP_CONNECTION);
+    const char *value;
+
+    while (true)
+    {
+        length = recv(fd, buf, REST_MAX_HTTP_BUFFER_LENGTH, MSG_DONTWAIT);
+        if (0 == length)
+            return BVIEW_STATUS_FAILURE;
+
+        if (0 > length)
+        {
+            if (EINTR == errno)
+                continue;
+            if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+                return BVIEW_STATUS_SUCCESS;
+            return BVIEW_STATUS_FAILURE;
+        }
+
+        buf[length] = '\0';
+        for (i = 0; i + nameLength < length; i++)
+        {
+            if (0 != strncasecmp(&buf[i], REST_HTTP_CONNECTION, nameLength))
+                continue;
+
+            for (value = &buf[i + nameLength]; ' ' == *value; value++)
+                ;
+            if (0 == strncasecmp(value, REST_HTTP_CONNECTION_CLOSE,
+                                 strlen(REST_HTTP_CONNECTION_CLOSE)))
+                collector->persistent = false;
+        }
+    }
+}
+
+/******************************************************************
+ * @brief  closes the connection to the collector
+ *
+ * @param[in]   collector    collector, locked
+ *********************************************************************/
+static void rest_collector_disconnect(REST_COLLECTOR_t *collector)
+{
+    if (-1 != collector->fd)
+    {
+        close(collector->fd);
+        collector->fd = -1;
+    }
+}
+
+/******************************************************************
+ * @brief  waits before the next connection attempt
+ *
+ * @param[in]   collector    collector, locked
+ *
+ * @note     The delay doubles with each failure, up to
+ *           REST_COLLECTOR_BACKOFF_MAX
+ *********************************************************************/
+static void rest_collector_backoff(REST_COLLECTOR_t *collector)
+{
+    if (0 == collector->backoff)
+        collector->backoff = REST_COLLECTOR_BACKOFF_MIN;
+    else if (collector->backoff < REST_COLLECTOR_BACKOFF_MAX / 2)
+        collector->backoff *= 2;
+    else
+        collector->backoff = REST_COLLECTOR_BACKOFF_MAX;
+
+    collector->retryAt = rest_time_usec() + ((uint64_t) collector->backoff * 1000);
+}
+
+/******************************************************************
+ * @brief  connects to the collector
+ *
+ * @param[in]   collector    collector, locked
+ * @param[out]  fd           connection, -1 if the configured collector
+ *                           is left at the defaults and is not there
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if connected, or the default
+ *           collector is not there
+ * @retval   BVIEW_STATUS_FAILURE otherwise
+ *
+ * @note     The lock is given up while connecting
+ *********************************************************************/
+static BVIEW_STATUS rest_collector_connect(REST_COLLECTOR_t *collector, int *fd)
+{
+    char ip[REST_MAX_IP_ADDR_LENGTH];
+    int port = collector->port;
+    BVIEW_STATUS status;
+
+    memcpy(ip, collector->ip, sizeof (ip));
+
+    pthread_mutex_unlock(&collector->mutex);
+    if (-1 == collector->subscriber)
+        status = rest_async_connect(collector->rest, fd);
+    else
+        status = rest_async_connect_to(ip, port, fd);
+    pthread_mutex_lock(&collector->mutex);
+
+    return status;
+}
+
+/******************************************************************
+ * @brief  sends the queued reports to the collector
+ *
+ * @param[in]   arg      collector, REST_COLLECTOR_t
+ *
+ * @note     The reports queued go out back to back on the kept
+ *           connection, without waiting for the answers. A report the
+ *           connection failed to send is sent again on the next one.
+ *********************************************************************/
+static void *rest_collector_run(void *arg)
+{
+    REST_COLLECTOR_t *collector = (REST_COLLECTOR_t *) arg;
+    REST_COLLECTOR_REPORT_t *batch, *report;
+    struct timespec until;
+    BVIEW_STATUS status, drained;
+    uint64_t bytes;
+    int fd, sent;
+
+    pthread_mutex_lock(&collector->mutex);
+
+    while (true)
+    {
+        if (true == collector->reset)
+        {
+            /* the collector is another one */
+            collector->reset = false;
+            rest_collector_disconnect(collector);
+            collector->persistent = true;
+            collector->absent = false;
+            collector->backoff = 0;
+            collector->retryAt = 0;
+        }
+
+        /* the subscriber is gone, and so are its reports */
+        if ((-1 != collector->subscriber) && ('\0' == collector->ip[0]))
+            rest_collector_discard(collector);
+
+        if (NULL == collector->head)
+        {
+            pthread_cond_wait(&collector->cond, &collector->mutex);
+            continue;
+        }
+
+        if (-1 == collector->fd)
+        {
+            if (rest_time_usec() < collector->retryAt)
+            {
+                until.tv_sec = collector->retryAt / 1000000;
+                until.tv_nsec = (collector->retryAt % 1000000) * 1000;
+                pthread_cond_timedwait(&collector->cond, &collector->mutex, &until);
+                continue;
+            }
+
+            status = rest_collector_connect(collector, &fd);
+            if (true == collector->reset)
+            {
+                /* connected to the one before */
+                if (-1 != fd)
+                    close(fd);
+                continue;
+            }
+
+            if ((BVIEW_STATUS_SUCCESS != status) || (-1 == fd))
+            {
+                collector->stats.connectFailures++;
+                rest_collector_backoff(collector);
+
+                /* the collector is left at the defaults and is not there */
+                if (BVIEW_STATUS_SUCCESS == status)
+                {
+                    collector->absent = true;
+                    rest_collector_discard(collector);
+                }
+                continue;
+            }
+
+            collector->fd = fd;
+            collector->used = false;
+            collector->stats.connects++;
+            collector->absent = false;
+            collector->backoff = 0;
+            collector->retryAt = 0;
+        }
+
+        /* take the queue, it fills up again while this is sent */
+        batch = collector->head;
+        collector->head = NULL;
+        collector->tail = NULL;
+        collector->count = 0;
+        collector->bytes = 0;
+        fd = collector->fd;
+
+        pthread_mutex_unlock(&collector->mutex);
+
+        sent = 0;
+        bytes = 0;
+        status = BVIEW_STATUS_SUCCESS;
+        drained = rest_collector_drain(collector, fd);
+        while ((BVIEW_STATUS_SUCCESS == drained) && (NULL != batch))
+        {
+            report = batch;
+            status = rest_send_all(fd, report->data, report->length, MSG_NOSIGNAL);
+            if (BVIEW_STATUS_SUCCESS != status)
+                break;
+
+            batch = report->next;
+            sent++;
+            bytes += report->length;
+            rest_collector_report_free(report);
+
+            if (false == collector->persistent)
+                break;
+        }
+
+        pthread_mutex_lock(&collector->mutex);
+
+        collector->stats.sent += sent;
+        collector->stats.bytes += bytes;
+        if (sent > 0)
+            collector->used = true;
+
+        if (BVIEW_STATUS_SUCCESS != drained)
+        {
+            /* closed by the collector while idle, connect again right away
+               unless it closes the connections it takes */
+            collector->stats.disconnects++;
+            rest_collector_disconnect(collector);
+            if (false == collector->used)
+                rest_collector_backoff(collector);
+        }
+        else if (BVIEW_STATUS_SUCCESS != status)
+        {
+            _REST_LOG(_REST_DEBUG_ERROR, "REST : Failed to send a report to the collector [%d : %s] \n",
+                      errno, strerror(errno));
+            collector->stats.sendFailures++;
+            rest_collector_disconnect(collector);
+            rest_collector_backoff(collector);
+        }
+        else if (false == collector->persistent)
+        {
+            rest_collector_disconnect(collector);
+        }
+
+        rest_collector_requeue(collector, batch);
+    }
+
+    return NULL;
+}
+
+/******************************************************************
+ * @brief  sets up a collector, the thread is started with the first
+ *         collector set for it
+ *
+ * @param[in]   rest          REST context for operation
+ * @param[in]   collector     collector
+ * @param[in]   subscriber    subscriber, -1 for the configured collector
+ *********************************************************************/
+static void rest_collector_setup(REST_CONTEXT_t *rest, REST_COLLECTOR_t *collector,
+                                 int subscriber)
+{
+    memset(collector, 0, sizeof (REST_COLLECTOR_t));
+    pthread_mutex_init(&collector->mutex, NULL);
+    pthread_cond_init(&collector->cond, NULL);
+    collector->rest = rest;
+    collector->subscriber = subscriber;
+    collector->fd = -1;
+    collector->persistent = true;
+}
+
+/******************************************************************
+ * @brief  starts the thread of a collector
+ *
+ * @param[in]   collector     collector, locked
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if the thread is running
+ * @retval   BVIEW_STATUS_FAILURE if it is not started
+ *********************************************************************/
+static BVIEW_STATUS rest_collector_start(REST_COLLECTOR_t *collector)
+{
+    if (true == collector->started)
+        return BVIEW_STATUS_SUCCESS;
+
+    if (0 != pthread_create(&collector->thread, NULL, rest_collector_run, collector))
+    {
+        _REST_LOG(_REST_DEBUG_ERROR, "REST : Failed to start the collector thread [%d : %s] \n",
+                  errno, strerror(errno));
+        return BVIEW_STATUS_FAILURE;
+    }
+
+    collector->started = true;
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  sets up the connection to the collector and starts the
+ *         thread sending the asynchronous reports
+ *
+ * @param[in]   rest      REST context for operation
+ *
+ * @retval   BVIEW_STATUS_SUCCESS on successful initialization
+ * @retval   BVIEW_STATUS_FAILURE if the thread is not started
+ *
+ * @note     The collector is connected to with the first report. The
+ *           subscribers get theirs once they are set.
+ *********************************************************************/
+BVIEW_STATUS rest_collector_init(REST_CONTEXT_t *rest)
+{
+    int i;
+
+    for (i = 0; i < BVIEW_REST_MAX_SUBSCRIBERS; i++)
+        rest_collector_setup(rest, &rest->subscribers[i], i);
+
+    rest_collector_setup(rest, &rest->collector, -1);
+    return rest_collector_start(&rest->collector);
+}
+
+/******************************************************************
+ * @brief  queues an asynchronous report for a collector
+ *
+ * @param[in]   collector    collector
+ * @param[in]   report       complete report, which the queue takes
+ *
+ * @note     A report takes the place of the queued one of the same
+ *           kind, which it supersedes. A full queue drops its oldest
+ *           reports otherwise. A report for the default collector,
+ *           which is not there, is dropped till it is tried again, as
+ *           is one for a subscriber which is gone.
+ *********************************************************************/
+static void rest_collector_queue(REST_COLLECTOR_t *collector, REST_COLLECTOR_REPORT_t *report)
+{
+    REST_COLLECTOR_REPORT_t *superseded, *prev;
+
+    report->next = NULL;
+
+    pthread_mutex_lock(&collector->mutex);
+
+    collector->stats.posted++;
+
+    /* the default collector is tried again once the backoff is over */
+    if (((true == collector->absent) && (-1 == collector->fd) &&
+         (rest_time_usec() < collector->retryAt)) ||
+        ((-1 != collector->subscriber) && ('\0' == collector->ip[0])))
+    {
+        collector->stats.discarded++;
+        pthread_mutex_unlock(&collector->mutex);
+        rest_collector_report_free(report);
+        return;
+    }
+
+    superseded = rest_collector_superseded(collector, report->kind, &prev);
+    if (NULL != superseded)
+    {
+        /* the newer report goes out in its place */
+        report->next = superseded->next;
+        if (NULL == prev)
+            collector->head = report;
+        else
+            prev->next = report;
+        if (collector->tail == superseded)
+            collector->tail = report;
+        collector->bytes += report->length - superseded->length;
+        collector->stats.coalesced++;
+        rest_collector_report_free(superseded);
+    }
+    else
+    {
+        if (NULL == collector->tail)
+            collector->head = report;
+        else
+            collector->tail->next = report;
+        collector->tail = report;
+        collector->count++;
+        collector->bytes += report->length;
+    }
+
+    rest_collector_trim(collector);
+    if (collector->count > collector->stats.queuedMax)
+        collector->stats.queuedMax = collector->count;
+
+    pthread_cond_signal(&collector->cond);
+    pthread_mutex_unlock(&collector->mutex);
+}
+
+/******************************************************************
+ * @brief  queues an asynchronous report for the collector, or the
+ *         subscribers
+ *
+ * @param[in]   rest          REST context for operation
+ * @param[in]   subscribers   subscribers the report goes to, a bit
+ *                            each, the configured collector if 0
+ * @param[in]   report        complete report, HTTP header and body,
+ *                            which the queues take
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ * @retval   BVIEW_STATUS_RESOURCE_NOT_AVAILABLE if out of memory
+ *
+ * @note     The subscribers share the data of the report, it is
+ *           neither encoded nor copied once for each
+ *********************************************************************/
+BVIEW_STATUS rest_collector_post(REST_CONTEXT_t *rest, unsigned int subscribers,
+                                 REST_COLLECTOR_REPORT_t *report)
+{
+    REST_COLLECTOR_REPORT_t *share;
+    BVIEW_STATUS status = BVIEW_STATUS_SUCCESS;
+    int i;
+
+    if (0 == subscribers)
+    {
+        rest_collector_queue(&rest->collector, report);
+        return BVIEW_STATUS_SUCCESS;
+    }
+
+    for (i = 0; i < BVIEW_REST_MAX_SUBSCRIBERS; i++)
+    {
+        if (0 == (subscribers & (1U << i)))
+            continue;
+
+        share = rest_collector_report_share(report);
+        if (NULL == share)
+        {
+            status = BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+            continue;
+        }
+        rest_collector_queue(&rest->subscribers[i], share);
+    }
+
+    /* the data stays with the queues */
+    rest_collector_report_free(report);
+    return status;
+}
+
+/******************************************************************
+ * @brief  sets the collector the reports of a subscriber go to
+ *
+ * @param[in]   rest          REST context for operation
+ * @param[in]   subscriber    subscriber
+ * @param[in]   ip            ip of the collector, empty to remove it
+ * @param[in]   port          port of the collector
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if set
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER for an unknown subscriber
+ * @retval   BVIEW_STATUS_FAILURE if the thread is not started
+ *
+ * @note     The connection to the collector before is dropped, the
+ *           queued reports go to the new one
+ *********************************************************************/
+BVIEW_STATUS rest_subscriber_collector_set(REST_CONTEXT_t *rest, int subscriber,
+                                           const char *ip, int port)
+{
+    REST_COLLECTOR_t *collector;
+    BVIEW_STATUS status = BVIEW_STATUS_SUCCESS;
+
+    if ((0 > subscriber) || (BVIEW_REST_MAX_SUBSCRIBERS <= subscriber) ||
+        (NULL == ip) || (REST_MAX_IP_ADDR_LENGTH <= strlen(ip)))
+        return BVIEW_STATUS_INVALID_PARAMETER;
+
+    collector = &rest->subscribers[subscriber];
+
+    pthread_mutex_lock(&collector->mutex);
+
+    if ((0 != strcmp(collector->ip, ip)) || (collector->port != port))
+    {
+        strcpy(collector->ip, ip);
+        collector->port = port;
+        collector->reset = true;
+    }
+    if ('\0' != ip[0])
+        status = rest_collector_start(collector);
+
+    pthread_cond_signal(&collector->cond);
+    pthread_mutex_unlock(&collector->mutex);
+
+    return status;
+}
+
+/******************************************************************
+ * @brief  drops the connection to the collector, which changed
+ *
+ * @param[in]   rest      REST context for operation
+ *
+ * @note     The queued reports go to the new collector
+ *********************************************************************/
+void rest_collector_reset(REST_CONTEXT_t *rest)
+{
+    REST_COLLECTOR_t *collector = &rest->collector;
+
+    pthread_mutex_lock(&collector->mutex);
+    collector->reset = true;
+    pthread_cond_signal(&collector->cond);
+    pthread_mutex_unlock(&collector->mutex);
+}
+
+/******************************************************************
+ * @brief  gets the counters of the reports of a collector
+ *
+ * @param[in]   collector  collector
+ * @param[out]  stats      counters
+ *********************************************************************/
+static void rest_collector_counters(REST_COLLECTOR_t *collector, REST_COLLECTOR_STATS_t *stats)
+{
+    pthread_mutex_lock(&collector->mutex);
+    *stats = collector->stats;
+    stats->queued = collector->count;
+    stats->queuedBytes = collector->bytes;
+    stats->connected = (-1 != collector->fd);
+    stats->backoff = collector->backoff;
+    pthread_mutex_unlock(&collector->mutex);
+}
+
+/******************************************************************
+ * @brief  gets the counters of the asynchronous reports
+ *
+ * @param[in]   rest       REST context for operation
+ * @param[out]  stats      counters
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ *
+ * @note
+ *********************************************************************/
+BVIEW_STATUS rest_collector_stats(REST_CONTEXT_t *rest, REST_COLLECTOR_STATS_t *stats)
+{
+    rest_collector_counters(&rest->collector, stats);
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  gets the counters of the reports of a subscriber
+ *
+ * @param[in]   rest          REST context for operation
+ * @param[in]   subscriber    subscriber
+ * @param[out]  stats         counters
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER for an unknown subscriber
+ * @retval   BVIEW_STATUS_FAILURE if it has no collector
+ *
+ * @note
+ *********************************************************************/
+BVIEW_STATUS rest_subscriber_collector_stats(REST_CONTEXT_t *rest, int subscriber,
+                                             REST_COLLECTOR_STATS_t *stats)
+{
+    if ((0 > subscriber) || (BVIEW_REST_MAX_SUBSCRIBERS <= subscriber))
+        return BVIEW_STATUS_INVALID_PARAMETER;
+
+    if (false == rest->subscribers[subscriber].started)
+        return BVIEW_STATUS_FAILURE;
+
+    rest_collector_counters(&rest->subscribers[subscriber], stats);
+    return BVIEW_STATUS_SUCCESS;
+}
@@ -0,0 +1,303 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdbool.h>
+#include <zlib.h>
+
+#include "broadview.h"
+#include "rest.h"
+
+/* window of the zlib streams, 16 is added for a gzip header */
+#define REST_COMPRESS_WINDOW_BITS       15
+#define REST_COMPRESS_GZIP_BITS         16
+#define REST_COMPRESS_MEM_LEVEL         8
+
+/* room left in the output for deflate() to make progress */
+#define REST_COMPRESS_MIN_ROOM          64
+
+/******************************************************************
+ * @brief  sets up the compressors
+ *
+ * @param[in]   rest      REST context for operation
+ *
+ * @retval   BVIEW_STATUS_SUCCESS on successful initialization
+ *
+ * @note     the zlib streams are set up the first time they are used
+ *********************************************************************/
+BVIEW_STATUS rest_compress_init(REST_CONTEXT_t *rest)
+{
+    memset(&rest->compressors[0], 0, sizeof (rest->compressors));
+    pthread_mutex_init(&rest->compress_mutex, NULL);
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  gets the encoding of its name
+ *
+ * @param[in]   name      name of the encoding, as in HTTP
+ *
+ * @retval   the encoding, BVIEW_REST_ENCODING_IDENTITY for an
+ *           unknown one
+ *********************************************************************/
+BVIEW_REST_ENCODING_t rest_encoding_from_name(const char *name)
+{
+    if (NULL == name)
+        return BVIEW_REST_ENCODING_IDENTITY;
+
+    if (0 == strcasecmp(name, BVIEW_REST_ENCODING_NAME_GZIP))
+        return BVIEW_REST_ENCODING_GZIP;
+
+    if (0 == strcasecmp(name, BVIEW_REST_ENCODING_NAME_DEFLATE))
+        return BVIEW_REST_ENCODING_DEFLATE;
+
+    return BVIEW_REST_ENCODING_IDENTITY;
+}
+
+/******************************************************************
+ * @brief  makes the zlib stream of an encoding ready for a new
+ *         response, at the given level
+ *
+ * @param[in]   compressor   compressor taken
+ * @param[in]   encoding     encoding of the response
+ * @param[in]   level        zlib level
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if the stream is ready
+ * @retval   BVIEW_STATUS_OUTOFMEMORY if it could not be set up
+ *
+ * @note     a stream is set up once, and reset for the next responses
+ *********************************************************************/
+static BVIEW_STATUS rest_compressor_ready(REST_COMPRESSOR_t *compressor,
+                                         BVIEW_REST_ENCODING_t encoding, int level)
+{
+    z_stream *stream = &compressor->stream[encoding];
+    int windowBits = REST_COMPRESS_WINDOW_BITS;
+
+    if (false == compressor->initialized[encoding])
+    {
+        if (BVIEW_REST_ENCODING_GZIP == encoding)
+            windowBits += REST_COMPRESS_GZIP_BITS;
+
+        memset(stream, 0, sizeof (z_stream));
+        if (Z_OK != deflateInit2(stream, level, Z_DEFLATED, windowBits,
+                                 REST_COMPRESS_MEM_LEVEL, Z_DEFAULT_STRATEGY))
+        {
+            return BVIEW_STATUS_OUTOFMEMORY;
+        }
+        compressor->initialized[encoding] = true;
+        compressor->level[encoding] = level;
+        return BVIEW_STATUS_SUCCESS;
+    }
+
+    if (Z_OK != deflateReset(stream))
+        return BVIEW_STATUS_FAILURE;
+
+    /* nothing is compressed yet, the level can change */
+    if ((compressor->level[encoding] != level) &&
+        (Z_OK != deflateParams(stream, level, Z_DEFAULT_STRATEGY)))
+    {
+        return BVIEW_STATUS_FAILURE;
+    }
+    compressor->level[encoding] = level;
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  takes a compressor for a response
+ *
+ * @param[in]   rest      REST context for operation
+ * @param[in]   encoding  encoding of the response
+ * @param[in]   length    size of the response, or of its first chunk
+ *
+ * @retval   the compressor, NULL if the response is to be sent as
+ *           it is
+ *
+ * @note     A response is sent as it is when compression is off, when
+ *           it is smaller than the configured minimum size, or when
+ *           all compressors are taken. The compressor is returned with
+ *           rest_compressor_put().
+ *********************************************************************/
+REST_COMPRESSOR_t *rest_compressor_get(REST_CONTEXT_t *rest, BVIEW_REST_ENCODING_t encoding,
+                                       int length)
+{
+    REST_COMPRESSOR_t *compressor = NULL;
+    int level = 0, minSize = 0;
+    int i = 0;
+
+    if ((BVIEW_REST_ENCODING_GZIP != encoding) && (BVIEW_REST_ENCODING_DEFLATE != encoding))
+        return NULL;
+
+    if (0 != pthread_mutex_lock(&rest->config_mutex))
+        return NULL;
+    level = rest->config.compressionLevel;
+    minSize = rest->config.compressionMinSize;
+    pthread_mutex_unlock(&rest->config_mutex);
+
+    if ((level <= 0) || (length < minSize))
+        return NULL;
+
+    if (level > Z_BEST_COMPRESSION)
+        level = Z_BEST_COMPRESSION;
+
+    if (0 != pthread_mutex_lock(&rest->compress_mutex))
+        return NULL;
+    for (i = 0; i < REST_MAX_COMPRESSORS; i++)
+    {
+        if (false == rest->compressors[i].inUse)
+        {
+            compressor = &rest->compressors[i];
+            compressor->inUse = true;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&rest->compress_mutex);
+
+    if (NULL == compressor)
+    {
+        _REST_LOG(_REST_DEBUG_INFO, "REST : no compressor free, response sent as it is \n");
+        return NULL;
+    }
+
+    if (BVIEW_STATUS_SUCCESS != rest_compressor_ready(compressor, encoding, level))
+    {
+        rest_compressor_put(rest, compressor);
+        return NULL;
+    }
+    compressor->encoding = encoding;
+
+    return compressor;
+}
+
+/******************************************************************
+ * @brief  returns a compressor taken with rest_compressor_get()
+ *
+ * @param[in]   rest        REST context for operation
+ * @param[in]   compressor  compressor to return, may be NULL
+ *
+ * @note     its streams and output are kept for the next response
+ *********************************************************************/
+void rest_compressor_put(REST_CONTEXT_t *rest, REST_COMPRESSOR_t *compressor)
+{
+    if (NULL == compressor)
+        return;
+
+    if (0 != pthread_mutex_lock(&rest->compress_mutex))
+        return;
+    compressor->inUse = false;
+    pthread_mutex_unlock(&rest->compress_mutex);
+}
+
+/******************************************************************
+ * @brief  makes room for 'need' more bytes of output
+ *
+ * @param[in]   compressor  compressor in use
+ * @param[in]   used        bytes of output so far
+ * @param[in]   need        bytes to make room for
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if there is room
+ * @retval   BVIEW_STATUS_OUTOFMEMORY otherwise
+ *********************************************************************/
+static BVIEW_STATUS rest_compress_grow(REST_COMPRESSOR_t *compressor, int used, int need)
+{
+    unsigned char *buffer;
+    int size = compressor->size;
+
+    if (size - used >= need)
+        return BVIEW_STATUS_SUCCESS;
+
+    while (size - used < need)
+        size = (0 == size) ? need : 2 * size;
+
+    buffer = realloc(compressor->buffer, size);
+    if (NULL == buffer)
+        return BVIEW_STATUS_OUTOFMEMORY;
+
+    compressor->buffer = buffer;
+    compressor->size = size;
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  compresses the next part of a response
+ *
+ * @param[in]   compressor    compressor taken for the response
+ * @param[in]   buffer        data to compress
+ * @param[in]   length        bytes of data, may be 0
+ * @param[in]   finish        is this the last part ?
+ * @param[out]  output        compressed data, valid till the next call
+ * @param[out]  outputLength  bytes of compressed data, may be 0 for a
+ *                            part which is not the last
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if compressed
+ * @retval   BVIEW_STATUS_OUTOFMEMORY if the output could not grow
+ * @retval   BVIEW_STATUS_FAILURE otherwise
+ *
+ * @note     The parts of a response are not flushed, zlib sends out
+ *           what it has as it sees fit, and all of the rest with the
+ *           last part.
+ *********************************************************************/
+BVIEW_STATUS rest_compress(REST_COMPRESSOR_t *compressor, const char *buffer, int length,
+                           bool finish, const char **output, int *outputLength)
+{
+    z_stream *stream;
+    BVIEW_STATUS status;
+    int flush = (true == finish) ? Z_FINISH : Z_NO_FLUSH;
+    int used = 0, rv = Z_OK;
+
+    _REST_ASSERT(NULL != compressor);
+    _REST_ASSERT((NULL != buffer) || (0 == length));
+    _REST_ASSERT(NULL != output);
+    _REST_ASSERT(NULL != outputLength);
+
+    stream = &compressor->stream[compressor->encoding];
+
+    /* most parts go in a single pass */
+    status = rest_compress_grow(compressor, 0,
+                                (int) deflateBound(stream, length) + REST_COMPRESS_MIN_ROOM);
+    if (BVIEW_STATUS_SUCCESS != status)
+        return status;
+
+    stream->next_in = (Bytef *) buffer;
+    stream->avail_in = length;
+
+    do
+    {
+        status = rest_compress_grow(compressor, used, REST_COMPRESS_MIN_ROOM);
+        if (BVIEW_STATUS_SUCCESS != status)
+            return status;
+
+        stream->next_out = compressor->buffer + used;
+        stream->avail_out = compressor->size - used;
+
+        rv = deflate(stream, flush);
+        if ((Z_OK != rv) && (Z_STREAM_END != rv) && (Z_BUF_ERROR != rv))
+            return BVIEW_STATUS_FAILURE;
+
+        used = stream->next_out - compressor->buffer;
+    } while ((0 != stream->avail_in) || (0 == stream->avail_out) ||
+             ((true == finish) && (Z_STREAM_END != rv)));
+
+    *output = (const char *) compressor->buffer;
+    *outputLength = used;
+    return BVIEW_STATUS_SUCCESS;
+}
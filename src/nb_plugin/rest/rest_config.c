@@ -41,6 +41,7 @@ pthread_mutex_t rest_server_mutex;
 BVIEW_STATUS rest_config_init(REST_CONTEXT_t *rest)
 {
     pthread_mutex_t *rest_mutex = NULL;
+    char asyncEncoding[BVIEW_MAX_ENCODING_NAME_LENGTH] = { 0 };
 
     /* aim to read */
     _REST_LOG(_REST_DEBUG_TRACE, "REST : Configuring ...");
@@ -60,6 +61,14 @@ BVIEW_STATUS rest_config_init(REST_CONTEXT_t *rest)
     /* get the local port */
     system_agent_port_get(&rest->config.localPort);
 
+    /* get the compression of the responses */
+    system_agent_compression_get(&rest->config.compressionLevel,
+                                 &rest->config.compressionMinSize, &asyncEncoding[0]);
+    rest->config.asyncEncoding = rest_encoding_from_name(&asyncEncoding[0]);
+
+    /* get the number of workers handling the requests */
+    system_agent_rest_workers_get(&rest->config.workers);
+
     _REST_LOG(_REST_DEBUG_TRACE, "REST : Configuration Complete");
 
     return BVIEW_STATUS_SUCCESS;
@@ -0,0 +1,656 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <time.h>
+#include <poll.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+
+#include "broadview.h"
+#include "rest.h"
+#include "rest_http.h"
+
+/* header of an event stream, the events follow till the connection
+   is closed */
+#define REST_EVENT_STREAM_HEADER                                            \
+        "HTTP/1.1 200 OK" REST_HTTP_CRLF                                    \
+        "Content-Type: " REST_HTTP_CONTENT_TYPE_EVENT_STREAM REST_HTTP_CRLF \
+        "Cache-Control: no-cache" REST_HTTP_CRLF                            \
+        REST_HTTP_CONNECTION " " REST_HTTP_CONNECTION_KEEP_ALIVE REST_HTTP_TWIN_CRLF
+
+/* comment sent on a quiet stream */
+#define REST_EVENT_STREAM_COMMENT     ": keepalive\n\n"
+
+/* bytes of an event besides its data : id, name and line prefixes */
+#define REST_EVENT_OVERHEAD           64
+#define REST_EVENT_LINE_PREFIX        "data: "
+
+/******************************************************************
+ * @brief  allocates an event
+ *
+ * @param[in]   size      bytes of the event, at most
+ *
+ * @retval   the event, NULL if out of memory
+ *
+ * @note     Its data is filled by the caller
+ *********************************************************************/
+static REST_EVENT_t *rest_event_new(int size)
+{
+    REST_EVENT_t *event;
+
+    event = (REST_EVENT_t *) malloc(sizeof (REST_EVENT_t));
+    if (NULL == event)
+        return NULL;
+
+    event->data = (char *) malloc(size);
+    if (NULL == event->data)
+    {
+        free(event);
+        return NULL;
+    }
+    event->length = 0;
+    event->comment = false;
+    event->refs = 0;
+    return event;
+}
+
+/******************************************************************
+ * @brief  drops a stream's hold of an event
+ *
+ * @param[in]   event      event, freed with its last hold
+ *
+ * @note     called with the lock of the streams held
+ *********************************************************************/
+static void rest_event_put(REST_EVENT_t *event)
+{
+    event->refs--;
+    if (0 < event->refs)
+        return;
+
+    free(event->data);
+    free(event);
+}
+
+/******************************************************************
+ * @brief  formats an event as a server-sent event
+ *
+ * @param[in]   id        id of the event
+ * @param[in]   name      name of the event
+ * @param[in]   buffer    data of the event
+ * @param[in]   length    bytes of the data
+ *
+ * @retval   the event, NULL if out of memory
+ *
+ * @note     Each line of the data goes out as a "data:" field, the
+ *           client joins them back. Carriage returns are dropped, the
+ *           client would take them for line ends.
+ *********************************************************************/
+static REST_EVENT_t *rest_event_format(uint64_t id, const char *name,
+                                       const char *buffer, int length)
+{
+    REST_EVENT_t *event;
+    int lines = 1;
+    int i;
+    char *data;
+
+    for (i = 0; i < length; i++)
+    {
+        if ('\n' == buffer[i])
+            lines++;
+    }
+
+    event = rest_event_new(REST_EVENT_OVERHEAD + strlen(name) + length +
+                           (lines * (sizeof (REST_EVENT_LINE_PREFIX) - 1 + 1)) + 2);
+    if (NULL == event)
+        return NULL;
+
+    data = event->data;
+    data += sprintf(data, "id: %llu\nevent: %s\n" REST_EVENT_LINE_PREFIX,
+                    (unsigned long long) id, name);
+
+    for (i = 0; i < length; i++)
+    {
+        if ('\r' == buffer[i])
+            continue;
+
+        if ('\n' == buffer[i])
+        {
+            data += sprintf(data, "\n" REST_EVENT_LINE_PREFIX);
+            continue;
+        }
+        *data++ = buffer[i];
+    }
+
+    /* the blank line ends the event */
+    *data++ = '\n';
+    *data++ = '\n';
+
+    event->length = data - event->data;
+    return event;
+}
+
+/******************************************************************
+ * @brief  queues an event on a stream
+ *
+ * @param[in]   events     event streams
+ * @param[in]   stream     stream of a client
+ * @param[in]   event      event, held by the stream from here
+ *
+ * @note     A full stream drops its oldest events for the new one,
+ *           but for one partly sent, which has to go out whole.
+ *           Called with the lock of the streams held.
+ *********************************************************************/
+static void rest_event_stream_queue(REST_EVENTS_t *events, REST_EVENT_STREAM_t *stream,
+                                    REST_EVENT_t *event)
+{
+    REST_EVENT_t *dropped;
+    int first, slot;
+
+    while ((0 < stream->count) &&
+           ((REST_EVENT_STREAM_MAX_EVENTS == stream->count) ||
+            (REST_EVENT_STREAM_MAX_BYTES < (stream->bytes + event->length))))
+    {
+        first = (0 == stream->offset) ? 0 : 1;
+        if (first >= stream->count)
+            break;
+
+        slot = (stream->head + first) % REST_EVENT_STREAM_MAX_EVENTS;
+        dropped = stream->events[slot];
+
+        /* the event partly sent, if any, takes the place of the dropped one */
+        stream->events[slot] = stream->events[stream->head];
+        stream->events[stream->head] = NULL;
+        stream->head = (stream->head + 1) % REST_EVENT_STREAM_MAX_EVENTS;
+        stream->count--;
+        stream->bytes -= dropped->length;
+
+        if (false == dropped->comment)
+            events->stats.dropped++;
+        rest_event_put(dropped);
+    }
+
+    event->refs++;
+    stream->events[(stream->head + stream->count) % REST_EVENT_STREAM_MAX_EVENTS] = event;
+    stream->count++;
+    stream->bytes += event->length;
+    if (false == event->comment)
+        events->stats.queued++;
+}
+
+/******************************************************************
+ * @brief  closes a stream and drops its events
+ *
+ * @param[in]   events     event streams
+ * @param[in]   stream     stream of a client
+ *
+ * @note     called with the lock of the streams held
+ *********************************************************************/
+static void rest_event_stream_close(REST_EVENTS_t *events, REST_EVENT_STREAM_t *stream)
+{
+    _REST_LOG(_REST_DEBUG_INFO, "REST : event stream of %s closed \n",
+              inet_ntoa(stream->peerAddr.sin_addr));
+
+    while (0 < stream->count)
+    {
+        rest_event_put(stream->events[stream->head]);
+        stream->events[stream->head] = NULL;
+        stream->head = (stream->head + 1) % REST_EVENT_STREAM_MAX_EVENTS;
+        stream->count--;
+    }
+
+    close(stream->fd);
+    stream->fd = -1;
+    stream->bytes = 0;
+    stream->offset = 0;
+    stream->head = 0;
+    stream->inUse = false;
+
+    events->stats.streams--;
+    events->stats.closed++;
+}
+
+/******************************************************************
+ * @brief  sends the events of a stream, as far as the socket takes
+ *         them
+ *
+ * @param[in]   events     event streams
+ * @param[in]   stream     stream of a client
+ *
+ * @note     The socket is not waited for, the rest goes out when it
+ *           takes more. Called with the lock of the streams held.
+ *********************************************************************/
+static void rest_event_stream_flush(REST_EVENTS_t *events, REST_EVENT_STREAM_t *stream)
+{
+    REST_EVENT_t *event;
+    int sent;
+
+    while (0 < stream->count)
+    {
+        event = stream->events[stream->head];
+
+        sent = send(stream->fd, event->data + stream->offset,
+                    event->length - stream->offset, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (0 > sent)
+        {
+            if (EINTR == errno)
+                continue;
+            if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+                return;
+
+            rest_event_stream_close(events, stream);
+            return;
+        }
+
+        stream->lastSend = time(NULL);
+        stream->offset += sent;
+        if (stream->offset < event->length)
+            continue;
+
+        stream->events[stream->head] = NULL;
+        stream->head = (stream->head + 1) % REST_EVENT_STREAM_MAX_EVENTS;
+        stream->count--;
+        stream->bytes -= event->length;
+        stream->offset = 0;
+
+        if (false == event->comment)
+            events->stats.sent++;
+        rest_event_put(event);
+    }
+}
+
+/******************************************************************
+ * @brief  reads what a client sends on its stream
+ *
+ * @param[in]   events     event streams
+ * @param[in]   stream     stream of a client
+ *
+ * @note     A client sends nothing but the end of the connection, any
+ *           bytes are dropped. Called with the lock of the streams held.
+ *********************************************************************/
+static void rest_event_stream_read(REST_EVENTS_t *events, REST_EVENT_STREAM_t *stream)
+{
+    char buffer[REST_MAX_HTTP_BUFFER_LENGTH];
+    int received;
+
+    received = recv(stream->fd, buffer, sizeof (buffer), MSG_DONTWAIT);
+    if ((0 == received) ||
+        ((0 > received) && (EINTR != errno) && (EAGAIN != errno) && (EWOULDBLOCK != errno)))
+    {
+        rest_event_stream_close(events, stream);
+    }
+}
+
+/******************************************************************
+ * @brief  writes the event streams
+ *
+ * @param[in]   arg      REST context
+ *
+ * @note     The sockets of the streams are polled for the events
+ *           queued on them and the end of the connections. A stream
+ *           quiet for a while gets a comment, so that it is not taken
+ *           for a dead connection.
+ *********************************************************************/
+static void *rest_events_run(void *arg)
+{
+    REST_CONTEXT_t *rest = (REST_CONTEXT_t *) arg;
+    REST_EVENTS_t *events = &rest->events;
+    REST_EVENT_STREAM_t *stream;
+    REST_EVENT_t *comment;
+    struct pollfd fds[BVIEW_REST_MAX_EVENT_STREAMS + 1];
+    int slots[BVIEW_REST_MAX_EVENT_STREAMS + 1];
+    uint64_t wake;
+    time_t now;
+    int count, i;
+
+    while (true)
+    {
+        fds[0].fd = events->wakeFd;
+        fds[0].events = POLLIN;
+        fds[0].revents = 0;
+        count = 1;
+
+        now = time(NULL);
+
+        pthread_mutex_lock(&events->mutex);
+        for (i = 0; i < BVIEW_REST_MAX_EVENT_STREAMS; i++)
+        {
+            stream = &events->streams[i];
+            if ((false == stream->inUse) || (-1 == stream->fd))
+                continue;
+
+            if ((0 == stream->count) &&
+                (REST_EVENT_STREAM_KEEPALIVE <= (now - stream->lastSend)))
+            {
+                comment = rest_event_new(sizeof (REST_EVENT_STREAM_COMMENT));
+                if (NULL != comment)
+                {
+                    strcpy(comment->data, REST_EVENT_STREAM_COMMENT);
+                    comment->length = strlen(REST_EVENT_STREAM_COMMENT);
+                    comment->comment = true;
+                    rest_event_stream_queue(events, stream, comment);
+                }
+            }
+
+            fds[count].fd = stream->fd;
+            fds[count].events = POLLIN | ((0 < stream->count) ? POLLOUT : 0);
+            fds[count].revents = 0;
+            slots[count] = i;
+            count++;
+        }
+        pthread_mutex_unlock(&events->mutex);
+
+        if (0 > poll(fds, count, 1000))
+        {
+            if (EINTR != errno)
+            {
+                _REST_LOG(_REST_DEBUG_ERROR, "REST : Failed to poll the event streams [%d : %s] \n",
+                          errno, strerror(errno));
+                sleep(1);
+            }
+            continue;
+        }
+
+        if (0 != (fds[0].revents & POLLIN))
+        {
+            if (sizeof (wake) != read(events->wakeFd, &wake, sizeof (wake)))
+            {
+                _REST_LOG(_REST_DEBUG_ERROR, "REST : Failed to read the wake up of the event streams \n");
+            }
+        }
+
+        /* only this thread closes a stream, the polled ones are still there */
+        pthread_mutex_lock(&events->mutex);
+        for (i = 1; i < count; i++)
+        {
+            stream = &events->streams[slots[i]];
+
+            if (0 != (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)))
+            {
+                rest_event_stream_close(events, stream);
+                continue;
+            }
+
+            if (0 != (fds[i].revents & POLLIN))
+            {
+                rest_event_stream_read(events, stream);
+                if (false == stream->inUse)
+                    continue;
+            }
+
+            /* events queued since the poll go out as well */
+            if (0 < stream->count)
+                rest_event_stream_flush(events, stream);
+        }
+        pthread_mutex_unlock(&events->mutex);
+    }
+
+    return NULL;
+}
+
+/******************************************************************
+ * @brief  starts the thread writing the event streams
+ *
+ * @param[in]   rest      REST context for operation
+ *
+ * @retval   BVIEW_STATUS_SUCCESS on successful initialization
+ * @retval   BVIEW_STATUS_FAILURE if the thread is not started
+ *
+ * @note
+ *********************************************************************/
+BVIEW_STATUS rest_events_init(REST_CONTEXT_t *rest)
+{
+    REST_EVENTS_t *events = &rest->events;
+    int i;
+
+    pthread_mutex_init(&events->mutex, NULL);
+    for (i = 0; i < BVIEW_REST_MAX_EVENT_STREAMS; i++)
+        events->streams[i].fd = -1;
+
+    events->wakeFd = eventfd(0, EFD_NONBLOCK);
+    if (-1 == events->wakeFd)
+    {
+        _REST_LOG(_REST_DEBUG_ERROR, "REST : Failed to create the eventfd of the event streams [%d : %s] \n",
+                  errno, strerror(errno));
+        return BVIEW_STATUS_FAILURE;
+    }
+
+    if (0 != pthread_create(&events->thread, NULL, rest_events_run, rest))
+    {
+        _REST_LOG(_REST_DEBUG_ERROR, "REST : Failed to start the event stream thread [%d : %s] \n",
+                  errno, strerror(errno));
+        close(events->wakeFd);
+        events->wakeFd = -1;
+        return BVIEW_STATUS_FAILURE;
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  takes the connection of a session over for an event
+ *         stream
+ *
+ * @param[in]   rest      REST context for operation
+ * @param[in]   session   session of the request for the stream
+ * @param[in]   filter    events the client asked for
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if the stream is open
+ * @retval   BVIEW_STATUS_RESOURCE_NOT_AVAILABLE if there are as many
+ *           streams as there may be
+ * @retval   BVIEW_STATUS_FAILURE if the header is not sent
+ *
+ * @note     The stream has a descriptor of its own for the socket, the
+ *           session is released by the caller without keeping the
+ *           connection, which stays open for the stream.
+ *********************************************************************/
+BVIEW_STATUS rest_event_stream_add(REST_CONTEXT_t *rest, REST_SESSION_t *session,
+                                   unsigned int filter)
+{
+    REST_EVENTS_t *events = &rest->events;
+    REST_EVENT_STREAM_t *stream = NULL;
+    BVIEW_STATUS status;
+    uint64_t wake = 1;
+    int fd, i;
+
+    if (-1 == events->wakeFd)
+        return BVIEW_STATUS_FAILURE;
+
+    /* the slot is taken before the header goes out, it is not polled
+       nor given events till the stream is there */
+    pthread_mutex_lock(&events->mutex);
+    for (i = 0; i < BVIEW_REST_MAX_EVENT_STREAMS; i++)
+    {
+        if (false == events->streams[i].inUse)
+        {
+            stream = &events->streams[i];
+            stream->inUse = true;
+            stream->fd = -1;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&events->mutex);
+
+    if (NULL == stream)
+    {
+        _REST_LOG(_REST_DEBUG_ERROR, "REST : No room for another event stream \n");
+        return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+    }
+
+    fd = dup(session->connectionFd);
+    status = BVIEW_STATUS_FAILURE;
+    if (-1 != fd)
+    {
+        status = rest_send_all(fd, REST_EVENT_STREAM_HEADER,
+                               strlen(REST_EVENT_STREAM_HEADER), MSG_NOSIGNAL);
+    }
+
+    pthread_mutex_lock(&events->mutex);
+    if (BVIEW_STATUS_SUCCESS != status)
+    {
+        stream->inUse = false;
+        pthread_mutex_unlock(&events->mutex);
+        if (-1 != fd)
+            close(fd);
+        _REST_LOG(_REST_DEBUG_ERROR, "REST : Failed to start the event stream [%d : %s] \n",
+                  errno, strerror(errno));
+        return BVIEW_STATUS_FAILURE;
+    }
+
+    stream->fd = fd;
+    stream->filter = filter;
+    stream->head = 0;
+    stream->count = 0;
+    stream->bytes = 0;
+    stream->offset = 0;
+    stream->lastSend = time(NULL);
+    stream->peerAddr = session->peerAddr;
+    events->stats.streams++;
+    events->stats.opened++;
+    pthread_mutex_unlock(&events->mutex);
+
+    _REST_LOG(_REST_DEBUG_INFO, "REST : event stream of %s opened \n",
+              inet_ntoa(stream->peerAddr.sin_addr));
+
+    /* the stream is polled from now on */
+    if (sizeof (wake) != write(events->wakeFd, &wake, sizeof (wake)))
+    {
+        _REST_LOG(_REST_DEBUG_ERROR, "REST : Failed to wake up the event streams \n");
+    }
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  gets the filters of the open event streams
+ *
+ * @param[in]   rest       REST context for operation
+ * @param[out]  filters    filters, each once
+ * @param[in]   max        filters there is room for
+ *
+ * @retval   number of filters
+ *
+ * @note     An application produces an event once for each filter
+ *********************************************************************/
+int rest_event_stream_filters(REST_CONTEXT_t *rest, unsigned int *filters, int max)
+{
+    REST_EVENTS_t *events = &rest->events;
+    int count = 0;
+    int i, j;
+
+    pthread_mutex_lock(&events->mutex);
+    for (i = 0; (i < BVIEW_REST_MAX_EVENT_STREAMS) && (count < max); i++)
+    {
+        if ((false == events->streams[i].inUse) || (-1 == events->streams[i].fd))
+            continue;
+
+        for (j = 0; j < count; j++)
+        {
+            if (filters[j] == events->streams[i].filter)
+                break;
+        }
+        if (j == count)
+            filters[count++] = events->streams[i].filter;
+    }
+    pthread_mutex_unlock(&events->mutex);
+
+    return count;
+}
+
+/******************************************************************
+ * @brief  queues an event on the streams of a filter
+ *
+ * @param[in]   rest       REST context for operation
+ * @param[in]   filter     streams the event goes to
+ * @param[in]   name       name of the event
+ * @param[in]   buffer     data of the event
+ * @param[in]   length     bytes of the data
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if the event is queued, or there is
+ *           no stream for it
+ * @retval   BVIEW_STATUS_OUTOFMEMORY if it is not formatted
+ *
+ * @note     The event is formatted once and shared by the streams. The
+ *           caller does not wait for any client, the thread of the
+ *           streams sends it.
+ *********************************************************************/
+BVIEW_STATUS rest_event_post(REST_CONTEXT_t *rest, unsigned int filter,
+                             const char *name, const char *buffer, int length)
+{
+    REST_EVENTS_t *events = &rest->events;
+    REST_EVENT_t *event;
+    uint64_t id, wake = 1;
+    int i;
+
+    pthread_mutex_lock(&events->mutex);
+    id = ++events->sequence;
+    events->stats.posted++;
+    pthread_mutex_unlock(&events->mutex);
+
+    event = rest_event_format(id, name, buffer, length);
+    if (NULL == event)
+        return BVIEW_STATUS_OUTOFMEMORY;
+
+    pthread_mutex_lock(&events->mutex);
+    for (i = 0; i < BVIEW_REST_MAX_EVENT_STREAMS; i++)
+    {
+        if ((false == events->streams[i].inUse) || (-1 == events->streams[i].fd) ||
+            (filter != events->streams[i].filter))
+            continue;
+
+        rest_event_stream_queue(events, &events->streams[i], event);
+    }
+
+    /* no stream took it */
+    if (0 == event->refs)
+    {
+        event->refs = 1;
+        rest_event_put(event);
+    }
+    pthread_mutex_unlock(&events->mutex);
+
+    if (sizeof (wake) != write(events->wakeFd, &wake, sizeof (wake)))
+    {
+        _REST_LOG(_REST_DEBUG_ERROR, "REST : Failed to wake up the event streams \n");
+    }
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  gets the counters of the event streams
+ *
+ * @param[in]   rest       REST context for operation
+ * @param[out]  stats      counters
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ *
+ * @note
+ *********************************************************************/
+BVIEW_STATUS rest_event_stats(REST_CONTEXT_t *rest, REST_EVENT_STATS_t *stats)
+{
+    pthread_mutex_lock(&rest->events.mutex);
+    *stats = rest->events.stats;
+    pthread_mutex_unlock(&rest->events.mutex);
+    return BVIEW_STATUS_SUCCESS;
+}
@@ -27,6 +27,32 @@ extern "C"
 #define REST_HTTP_CRLF          "\r\n"
 #define REST_HTTP_TWIN_CRLF     "\r\n\r\n"
 #define REST_HTTP_SPACE         " "    
+
+/* content types of the formats a response is sent in */
+#define REST_HTTP_CONTENT_TYPE_JSON     "text/json"
+#define REST_HTTP_CONTENT_TYPE_CBOR     "application/cbor"
+
+/* content type of a stream of server-sent events */
+#define REST_HTTP_CONTENT_TYPE_EVENT_STREAM     "text/event-stream"
+
+/* header a client names the content types it takes in */
+#define REST_HTTP_ACCEPT        "Accept:"
+
+/* header a client names the compressions it takes in */
+#define REST_HTTP_ACCEPT_ENCODING   "Accept-Encoding:"
+
+/* header giving the length of a request body */
+#define REST_HTTP_CONTENT_LENGTH    "Content-Length:"
+
+/* header a client keeps or closes its connection with */
+#define REST_HTTP_CONNECTION                "Connection:"
+#define REST_HTTP_CONNECTION_CLOSE          "close"
+#define REST_HTTP_CONNECTION_KEEP_ALIVE     "keep-alive"
+
+/* header line of a compressed message, by its encoding */
+#define REST_HTTP_CONTENT_ENCODING(_encoding)                              \
+        ((BVIEW_REST_ENCODING_GZIP == (_encoding)) ? "Content-Encoding: gzip\r\n" : \
+         (BVIEW_REST_ENCODING_DEFLATE == (_encoding)) ? "Content-Encoding: deflate\r\n" : "")
     
     
 
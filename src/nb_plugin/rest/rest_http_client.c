@@ -20,9 +20,13 @@
 #include <string.h>
 #include <stdbool.h>
 #include <unistd.h>
+#include <errno.h>
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 
 #include "broadview.h"
@@ -34,25 +38,36 @@
  * @brief  sends a HTTP 200 message to the client 
  *
  * @param[in]   fd    socket for sending message
+ * @param[in]   contentType  content type of the data
+ * @param[in]   encoding  compression of the data
  *
  * @retval   BVIEW_STATUS_SUCCESS 
  * 
  * @note     
  *********************************************************************/
-BVIEW_STATUS rest_send_200_with_data(int fd, char *buffer, int length)
+BVIEW_STATUS rest_send_200_with_data(int fd, const char *contentType,
+                                     BVIEW_REST_ENCODING_t encoding,
+                                     char *buffer, int length)
 {
-    char *response = "HTTP/1.1 200 OK \r\n"
+    char *header = "HTTP/1.1 200 OK \r\n"
             "Server: BroadViewAgent (Unix) (Linux) \r\n"
-            "Content-Type: text/json \r\n\r\n";
+            "%s"
+            "Content-Type: %s \r\n"
+            "Content-Length: %d\r\n\r\n";
+    char response[REST_MAX_HTTP_BUFFER_LENGTH] = { 0 };
     int bytes_sent =0;
     BVIEW_STATUS  rv = BVIEW_STATUS_SUCCESS;
     int sendbuff =0;
 
+    snprintf(response, sizeof (response), header, REST_HTTP_CONTENT_ENCODING(encoding), contentType,
+             length);
+
     if (0 > send(fd, response, strlen(response), MSG_MORE))
     {
       rv = BVIEW_STATUS_FAILURE;
     }
-    bytes_sent = send(fd, buffer, length, MSG_MORE);
+    /* the connection may stay open, nothing holds the last bytes back */
+    bytes_sent = send(fd, buffer, length, 0);
     if (0 > bytes_sent)
     {
       rv = BVIEW_STATUS_FAILURE;
@@ -93,7 +108,8 @@ BVIEW_STATUS rest_send_200_with_data(int fd, char *buffer, int length)
 BVIEW_STATUS rest_send_200(int fd)
 {
     char *response = "HTTP/1.1 200 OK \r\n"
-            "Server: BroadViewAgent (Unix) (Linux) \r\n\r\n";
+            "Server: BroadViewAgent (Unix) (Linux) \r\n"
+            "Content-Length: 0\r\n\r\n";
 
     if (0 > send(fd, response, strlen(response), 0))
         return BVIEW_STATUS_FAILURE;
@@ -113,7 +129,8 @@ BVIEW_STATUS rest_send_200(int fd)
 BVIEW_STATUS rest_send_404(int fd)
 {
     char *response = "HTTP/1.1 404 Not Found \r\n"
-            "Server: BroadViewAgent (Unix) (Linux) \r\n\r\n "
+            "Server: BroadViewAgent (Unix) (Linux) \r\n"
+            "Content-Length: 42\r\n\r\n "
             "<html> <body> Unsupported </body> </html>";
 
     if (0 > send(fd, response, strlen(response), 0))
@@ -134,7 +151,8 @@ BVIEW_STATUS rest_send_404(int fd)
 BVIEW_STATUS rest_send_400(int fd)
 {
     char *response = "HTTP/1.1 400 Bad Request \r\n"
-            "Server: BroadViewAgent (Unix) (Linux) \r\n\r\n"
+            "Server: BroadViewAgent (Unix) (Linux) \r\n"
+            "Content-Length: 41\r\n\r\n"
             "<html> <body> Bad Request </body> </html>";
 
    if (0 > send(fd, response, strlen(response), 0))
@@ -155,7 +173,8 @@ BVIEW_STATUS rest_send_400(int fd)
 BVIEW_STATUS rest_send_500(int fd)
 {
     char *response = "HTTP/1.1 500 Internal Server Error \r\n"
-            "Server: BroadViewAgent (Unix) (Linux) \r\n\r\n"
+            "Server: BroadViewAgent (Unix) (Linux) \r\n"
+            "Content-Length: 51\r\n\r\n"
             "<html> <body> Internal Server Error </body> </html>";
 
    if (0 > send(fd, response, strlen(response), 0))
@@ -165,96 +184,353 @@ BVIEW_STATUS rest_send_500(int fd)
 }
 
 /******************************************************************
- * @brief  sends an asynchronous report to the client 
+ * @brief  sends all of a buffer, however many send() calls it takes
  *
- * @param[in]   rest    context for reading configuration
+ * @param[in]   fd      socket for sending message
  * @param[in]   buffer  Buffer containing data to be sent
  * @param[in]   length  number of bytes to be sent 
- * 
+ * @param[in]   flags   flags of send()
+ *
  * @retval   BVIEW_STATUS_SUCCESS if send is successful
  * 
  * @note     
  *********************************************************************/
-BVIEW_STATUS rest_send_async_report(REST_CONTEXT_t *rest, char *buffer, int length)
+BVIEW_STATUS rest_send_all(int fd, const char *buffer, int length, int flags)
 {
-    char *header = "POST /agent_response HTTP/1.1\r\n"
-            "Host: BVIEW Client\r\n"
-            "User-Agent: BroadViewAgent\r\n"
-            "Accept: text/html,application/xhtml+xml,application/xml\r\n"
-            "Content-Length: %d\r\n"
-            "\r\n";
+    int bytes_sent = 0;
 
-    char buf[REST_MAX_HTTP_BUFFER_LENGTH] = { 0 };
+    while (length > 0)
+    {
+        bytes_sent = send(fd, buffer, length, flags);
+        if (0 > bytes_sent)
+        {
+            if (EINTR == errno)
+                continue;
+            return BVIEW_STATUS_FAILURE;
+        }
+        buffer += bytes_sent;
+        length -= bytes_sent;
+    }
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  opens a connection for asynchronous reports
+ *
+ * @param[in]   ip      ip of the peer
+ * @param[in]   port    port of the peer
+ * @param[out]  fd      connected socket
+ * 
+ * @retval   BVIEW_STATUS_SUCCESS if connected
+ * @retval   BVIEW_STATUS_FAILURE otherwise, errno tells why
+ * 
+ * @note     the connection is kept for the reports that follow
+ *********************************************************************/
+static BVIEW_STATUS rest_async_open(const char *ip, int port, int *fd)
+{
     int clientFd;
     struct sockaddr_in clientAddr;
-    int temp = 0;
-    BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
-    char clientIp[BVIEW_MAX_IP_ADDR_LENGTH] = {0};
-    int clientPort = 0;
+    struct timeval timeout;
+    int flag = 1;
 
-    snprintf(buf, REST_MAX_HTTP_BUFFER_LENGTH - 1, header, length);
+    *fd = -1;
 
     /* create socket to send data to */
     clientFd = socket(AF_INET, SOCK_STREAM, 0);
-    _REST_ASSERT_NET_ERROR((clientFd != -1), "Error Creating server socket");
+    if (-1 == clientFd)
+      return BVIEW_STATUS_FAILURE;
+
+    /* setup the socket */
+    memset(&clientAddr, 0, sizeof (struct sockaddr_in));
+    clientAddr.sin_family = AF_INET;
+    clientAddr.sin_port = htons(port);
+
+    /* connect to the peer */
+    if ((0 >= inet_pton(AF_INET, ip, &clientAddr.sin_addr)) ||
+        (-1 == connect(clientFd, (struct sockaddr *) &clientAddr, sizeof (clientAddr))))
+    {
+      close(clientFd);
+      return BVIEW_STATUS_FAILURE;
+    }
+
+    /* the connection is kept, a collector gone silent must not hold
+       the reports back forever */
+    timeout.tv_sec = REST_COLLECTOR_SEND_TIMEOUT;
+    timeout.tv_usec = 0;
+    setsockopt(clientFd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof (timeout));
+    setsockopt(clientFd, SOL_SOCKET, SO_KEEPALIVE, &flag, sizeof (flag));
+    setsockopt(clientFd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof (flag));
+
+    *fd = clientFd;
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  connects to the client the asynchronous reports go to
+ *
+ * @param[in]   rest    context for reading configuration
+ * @param[out]  fd      connected socket, -1 if the client is left
+ *                      at the defaults and is not reachable
+ * 
+ * @retval   BVIEW_STATUS_SUCCESS if connected, or ignored
+ * 
+ * @note     the connection is kept for the reports that follow
+ *********************************************************************/
+BVIEW_STATUS rest_async_connect(REST_CONTEXT_t *rest, int *fd)
+{
+    char clientIp[BVIEW_MAX_IP_ADDR_LENGTH] = {0};
+    int clientPort = 0;
+    BVIEW_STATUS status;
+
+    *fd = -1;
 
     /* take lock while copying the info */
     if (0 != pthread_mutex_lock (&rest->config_mutex))
     {
       LOG_POST (BVIEW_LOG_ERROR,
           "Failed to take the lock for rest config \r\n");
-      close(clientFd);
       return BVIEW_STATUS_FAILURE;
     }
 
-    /* setup the socket */
-    memset(&clientAddr, 0, sizeof (struct sockaddr_in));
-    clientAddr.sin_family = AF_INET;
-    clientAddr.sin_port = htons(rest->config.clientPort);
+    strncpy(&clientIp[0], &rest->config.clientIp[0], BVIEW_MAX_IP_ADDR_LENGTH - 1);
+    clientPort = rest->config.clientPort;
 
-    temp = inet_pton(AF_INET, &rest->config.clientIp[0], &clientAddr.sin_addr);
     /* release the lock */
     if (0 != pthread_mutex_unlock (&rest->config_mutex))
     {
       LOG_POST (BVIEW_LOG_ERROR,
           "Failed to release the lock for rest config \r\n");
-      close(clientFd);
       return BVIEW_STATUS_FAILURE;
     }
-    _REST_ASSERT_NET_SOCKET_ERROR((temp > 0), "Error Creating server socket",clientFd);
 
-    /* copy the default ip address and port */
-    strncpy(&clientIp[0], SYSTEM_CONFIG_PROPERTY_CLIENT_IP_DEFAULT, BVIEW_MAX_IP_ADDR_LENGTH);
+    status = rest_async_open(&clientIp[0], clientPort, fd);
 
-    clientPort = SYSTEM_CONFIG_PROPERTY_CLIENT_PORT_DEFAULT;
+    if ((BVIEW_STATUS_SUCCESS != status) &&
+        (SYSTEM_CONFIG_PROPERTY_CLIENT_PORT_DEFAULT == clientPort) &&
+        (0 == strcmp(&clientIp[0], SYSTEM_CONFIG_PROPERTY_CLIENT_IP_DEFAULT)))
+    {
+      /* the default ip and port are not reachable.
+         ignore error */
+       return BVIEW_STATUS_SUCCESS;
+    }
 
+    _REST_ASSERT_NET_ERROR((BVIEW_STATUS_SUCCESS == status),
+                           "Error connecting to client for sending async reports");
+    return BVIEW_STATUS_SUCCESS;
+}
 
-    /* connect to the peer */
-    temp = connect(clientFd, (struct sockaddr *) &clientAddr, sizeof (clientAddr));
+/******************************************************************
+ * @brief  connects to the collector of a subscriber
+ *
+ * @param[in]   ip      ip of the collector
+ * @param[in]   port    port of the collector
+ * @param[out]  fd      connected socket
+ * 
+ * @retval   BVIEW_STATUS_SUCCESS if connected
+ * 
+ * @note     the connection is kept for the reports that follow
+ *********************************************************************/
+BVIEW_STATUS rest_async_connect_to(const char *ip, int port, int *fd)
+{
+    BVIEW_STATUS status;
+
+    status = rest_async_open(ip, port, fd);
+    _REST_ASSERT_NET_ERROR((BVIEW_STATUS_SUCCESS == status),
+                           "Error connecting to subscriber for sending async reports");
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  starts an asynchronous report with its HTTP header
+ *
+ * @param[in]   contentType  content type of the report
+ * @param[in]   encoding  compression of the report
+ * @param[in]   length  number of bytes of the report, negative if it
+ *                      is sent in chunks
+ * 
+ * @retval   the report, NULL if out of memory
+ * 
+ * @note     the body follows with rest_collector_report_append(), or
+ *           rest_async_report_chunk() for a report sent in chunks
+ *********************************************************************/
+REST_COLLECTOR_REPORT_t *rest_async_report_new(const char *contentType,
+                                               BVIEW_REST_ENCODING_t encoding,
+                                               int length)
+{
+    char *header = "POST /agent_response HTTP/1.1\r\n"
+            "Host: BVIEW Client\r\n"
+            "User-Agent: BroadViewAgent\r\n"
+            "Accept: text/html,application/xhtml+xml,application/xml\r\n"
+            "Content-Type: %s\r\n"
+            "%s"
+            "Content-Length: %d\r\n"
+            "\r\n";
+    char *chunkedHeader = "POST /agent_response HTTP/1.1\r\n"
+            "Host: BVIEW Client\r\n"
+            "User-Agent: BroadViewAgent\r\n"
+            "Accept: text/html,application/xhtml+xml,application/xml\r\n"
+            "Content-Type: %s\r\n"
+            "%s"
+            "Transfer-Encoding: chunked\r\n"
+            "\r\n";
+    char buf[REST_MAX_HTTP_BUFFER_LENGTH] = { 0 };
+    REST_COLLECTOR_REPORT_t *report;
+    int headerLength;
 
-    if ((-1 == temp) && (clientPort == rest->config.clientPort) &&
-        (0 == strcmp(&rest->config.clientIp[0], &clientIp[0])))
+    if (0 <= length)
     {
-      /* the default ip and port are not reachable.
-         close fd and ignore error */
-       close(clientFd);
-       return BVIEW_STATUS_SUCCESS;
+      headerLength = snprintf(buf, sizeof (buf), header, contentType,
+                              REST_HTTP_CONTENT_ENCODING(encoding), length);
+    }
+    else
+    {
+      headerLength = snprintf(buf, sizeof (buf), chunkedHeader, contentType,
+                              REST_HTTP_CONTENT_ENCODING(encoding));
+      length = 0;
     }
 
-    _REST_ASSERT_NET_SOCKET_ERROR((temp != -1), "Error connecting to client for sending async reports",clientFd);
+    report = rest_collector_report_new(headerLength + length);
+    if (NULL == report)
+      return NULL;
 
-    /* send data */
-    if (0 > send(clientFd, buf, strlen(buf),MSG_MORE))
-      rv = BVIEW_STATUS_FAILURE;
+    rest_collector_report_append(report, buf, headerLength);
+    return report;
+}
 
-    if (0 > send(clientFd, buffer, length, 0))
-      rv = BVIEW_STATUS_FAILURE;
-    
-    /* close down session */
-    close(clientFd);
+/******************************************************************
+ * @brief  sends an asynchronous report to the client 
+ *
+ * @param[in]   rest    context for reading configuration
+ * @param[in]   subscribers  subscribers the report goes to, a bit
+ *                           each, the client if 0
+ * @param[in]   kind    kind of the report, BVIEW_REST_REPORT_KIND_NONE
+ *                      if it is never replaced
+ * @param[in]   contentType  content type of the report
+ * @param[in]   encoding  compression of the report
+ * @param[in]   buffer  Buffer containing data to be sent
+ * @param[in]   length  number of bytes to be sent 
+ * 
+ * @retval   BVIEW_STATUS_SUCCESS if the report is queued
+ * 
+ * @note     the report goes out on the connection kept to the client,
+ *           or to each subscriber
+ *********************************************************************/
+BVIEW_STATUS rest_send_async_report(REST_CONTEXT_t *rest, unsigned int subscribers,
+                                    unsigned int kind, const char *contentType,
+                                    BVIEW_REST_ENCODING_t encoding,
+                                    char *buffer, int length)
+{
+    REST_COLLECTOR_REPORT_t *report;
 
-    return rv;
+    report = rest_async_report_new(contentType, encoding, length);
+    if (NULL == report)
+    {
+      return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+    }
+
+    if (BVIEW_STATUS_SUCCESS != rest_collector_report_append(report, buffer, length))
+    {
+      rest_collector_report_free(report);
+      return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+    }
+
+    report->kind = kind;
+    return rest_collector_post(rest, subscribers, report);
+}
+
+/******************************************************************
+ * @brief  appends a chunk to an asynchronous report sent in chunks
+ *
+ * @param[in]   report  report started with rest_async_report_new()
+ * @param[in]   buffer  Buffer containing data to be sent
+ * @param[in]   length  number of bytes to be sent, 0 ends the report
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if appended
+ * 
+ * @note     
+ *********************************************************************/
+BVIEW_STATUS rest_async_report_chunk(REST_COLLECTOR_REPORT_t *report,
+                                     const char *buffer, int length)
+{
+    char size[REST_MAX_CHUNK_SIZE_LENGTH] = { 0 };
+    int sizeLength;
+
+    if (0 == length)
+    {
+        return rest_collector_report_append(report, "0\r\n\r\n", 5);
+    }
+
+    sizeLength = snprintf(size, sizeof (size), "%x\r\n", length);
+
+    if ((BVIEW_STATUS_SUCCESS != rest_collector_report_append(report, size, sizeLength)) ||
+        (BVIEW_STATUS_SUCCESS != rest_collector_report_append(report, buffer, length)) ||
+        (BVIEW_STATUS_SUCCESS != rest_collector_report_append(report, "\r\n", 2)))
+    {
+        return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+    }
 
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  sends the header of a HTTP 200 message sent in chunks
+ *
+ * @param[in]   fd    socket for sending message
+ * @param[in]   contentType  content type of the data
+ * @param[in]   encoding  compression of the data
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if send is successful
+ * 
+ * @note     the data follows with rest_send_chunk()
+ *********************************************************************/
+BVIEW_STATUS rest_send_200_chunked(int fd, const char *contentType,
+                                   BVIEW_REST_ENCODING_t encoding)
+{
+    char *header = "HTTP/1.1 200 OK \r\n"
+            "Server: BroadViewAgent (Unix) (Linux) \r\n"
+            "%s"
+            "Content-Type: %s \r\n"
+            "Transfer-Encoding: chunked \r\n\r\n";
+    char response[REST_MAX_HTTP_BUFFER_LENGTH] = { 0 };
+    int length;
+
+    length = snprintf(response, sizeof (response), header, REST_HTTP_CONTENT_ENCODING(encoding),
+                      contentType);
+
+    return rest_send_all(fd, response, length, MSG_MORE);
+}
+
+/******************************************************************
+ * @brief  sends a chunk of a message sent in chunks
+ *
+ * @param[in]   fd      socket for sending message
+ * @param[in]   buffer  Buffer containing data to be sent
+ * @param[in]   length  number of bytes to be sent, 0 ends the message
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if send is successful
+ * 
+ * @note     
+ *********************************************************************/
+BVIEW_STATUS rest_send_chunk(int fd, const char *buffer, int length)
+{
+    char size[REST_MAX_CHUNK_SIZE_LENGTH] = { 0 };
+    int sizeLength;
+
+    if (0 == length)
+    {
+        return rest_send_all(fd, "0\r\n\r\n", 5, 0);
+    }
+
+    sizeLength = snprintf(size, sizeof (size), "%x\r\n", length);
+
+    if ((BVIEW_STATUS_SUCCESS != rest_send_all(fd, size, sizeLength, MSG_MORE)) ||
+        (BVIEW_STATUS_SUCCESS != rest_send_all(fd, buffer, length, MSG_MORE)) ||
+        (BVIEW_STATUS_SUCCESS != rest_send_all(fd, "\r\n", 2, 0)))
+    {
+        return BVIEW_STATUS_FAILURE;
+    }
+
+    return BVIEW_STATUS_SUCCESS;
 }
 
 /******************************************************************
@@ -270,9 +546,13 @@ BVIEW_STATUS rest_send_async_report(REST_CONTEXT_t *rest, char *buffer, int leng
  *********************************************************************/
 BVIEW_STATUS rest_send_404_with_data(int fd, char *buffer, int length)
 {
-    char *response = "HTTP/1.1 404 Not Found \r\n"
-            "Server: BroadViewAgent (Unix) (Linux) \r\n\r\n "
-             "Content-Type: text/json";
+    char *header = "HTTP/1.1 404 Not Found \r\n"
+            "Server: BroadViewAgent (Unix) (Linux) \r\n"
+            "Content-Type: text/json\r\n"
+            "Content-Length: %d\r\n\r\n";
+    char response[REST_MAX_STRING_LENGTH] = { 0 };
+
+    snprintf(response, sizeof (response), header, length);
 
     if (0 > send(fd, response, strlen(response), MSG_MORE))
       return BVIEW_STATUS_FAILURE;
@@ -296,9 +576,13 @@ BVIEW_STATUS rest_send_404_with_data(int fd, char *buffer, int length)
  *********************************************************************/
 BVIEW_STATUS rest_send_400_with_data(int fd, char *buffer, int length)
 {
-    char *response = "HTTP/1.1 400 Bad Request \r\n"
-            "Server: BroadViewAgent (Unix) (Linux) \r\n\r\n"
-             "Content-Type: text/json";
+    char *header = "HTTP/1.1 400 Bad Request \r\n"
+            "Server: BroadViewAgent (Unix) (Linux) \r\n"
+            "Content-Type: text/json\r\n"
+            "Content-Length: %d\r\n\r\n";
+    char response[REST_MAX_STRING_LENGTH] = { 0 };
+
+    snprintf(response, sizeof (response), header, length);
 
     if (0 > send(fd, response, strlen(response), MSG_MORE))
       return BVIEW_STATUS_FAILURE;
@@ -322,9 +606,13 @@ BVIEW_STATUS rest_send_400_with_data(int fd, char *buffer, int length)
  *********************************************************************/
 BVIEW_STATUS rest_send_500_with_data(int fd, char *buffer, int length)
 {
-    char *response = "HTTP/1.1 500 Internal Server Error \r\n"
-            "Server: BroadViewAgent (Unix) (Linux) \r\n\r\n"
-             "Content-Type: text/json";
+    char *header = "HTTP/1.1 500 Internal Server Error \r\n"
+            "Server: BroadViewAgent (Unix) (Linux) \r\n"
+            "Content-Type: text/json\r\n"
+            "Content-Length: %d\r\n\r\n";
+    char response[REST_MAX_STRING_LENGTH] = { 0 };
+
+    snprintf(response, sizeof (response), header, length);
 
     if (0 > send(fd, response, strlen(response), MSG_MORE))
       return BVIEW_STATUS_FAILURE;
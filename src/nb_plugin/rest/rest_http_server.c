@@ -17,7 +17,10 @@
   ***************************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
+#include <strings.h>
 #include <stdbool.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -25,6 +28,10 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <errno.h>
 
@@ -41,6 +48,32 @@
 
 #define BVIEW_REST_MAX_SUPPORTED_METHODS 4
 
+/* epoll tags of the listening socket and of the eventfd, the connections
+   are tagged with the index of their session */
+#define REST_EVENT_LISTEN   (REST_MAX_SESSIONS)
+#define REST_EVENT_WAKE     (REST_MAX_SESSIONS + 1)
+
+/******************************************************************
+ * @brief  Terminates the word the request line continues with
+ *
+ * @param[in]   line    request line, at the start of the word
+ *
+ * @retval   the word, NULL if it is empty or nothing follows it
+ *
+ * @note     Unlike strtok() this keeps no state of its own, the
+ *           workers parse requests at the same time.
+ *********************************************************************/
+static char *rest_http_word_get(char *line)
+{
+    size_t length = strcspn(line, REST_HTTP_SPACE);
+
+    if ((0 == length) || (0 == line[length]))
+        return NULL;
+
+    line[length] = 0;
+    return line;
+}
+
 /******************************************************************
  * @brief  validates a string , whether its a proper HTTP method or not 
  *
@@ -105,6 +138,116 @@ static BVIEW_STATUS rest_validate_url(char *url, char *featureName, char *restMe
   return BVIEW_STATUS_SUCCESS;
 }
 
+/******************************************************************
+ * @brief  finds the format a client takes a report in, from the
+ *         Accept header of its request
+ *
+ * @param[in]   header    start of the HTTP header
+ * @param[in]   end       end of the HTTP header
+ *
+ * @retval   BVIEW_REST_FORMAT_CBOR if CBOR is accepted
+ * @retval   BVIEW_REST_FORMAT_DEFAULT otherwise
+ * 
+ * @note     Header names and media types are not case sensitive.
+ *           A client naming both JSON and CBOR gets CBOR.
+ *********************************************************************/
+static BVIEW_REST_FORMAT_t rest_parse_accept_format(const char *header, const char *end)
+{
+    const char *line = header, *eol = NULL, *cur = NULL;
+    int typeLength = strlen(REST_HTTP_CONTENT_TYPE_CBOR);
+
+    while (line < end)
+    {
+        eol = strstr(line, REST_HTTP_CRLF);
+        if ((NULL == eol) || (eol > end))
+            eol = end;
+
+        if (0 == strncasecmp(line, REST_HTTP_ACCEPT, strlen(REST_HTTP_ACCEPT)))
+        {
+            for (cur = line + strlen(REST_HTTP_ACCEPT); cur + typeLength <= eol; cur++)
+            {
+                if (0 == strncasecmp(cur, REST_HTTP_CONTENT_TYPE_CBOR, typeLength))
+                    return BVIEW_REST_FORMAT_CBOR;
+            }
+        }
+
+        line = eol + strlen(REST_HTTP_CRLF);
+    }
+
+    return BVIEW_REST_FORMAT_DEFAULT;
+}
+
+/******************************************************************
+ * @brief  finds the compression a client takes a response with, from
+ *         the Accept-Encoding header of its request
+ *
+ * @param[in]   header    start of the HTTP header
+ * @param[in]   end       end of the HTTP header
+ *
+ * @retval   BVIEW_REST_ENCODING_GZIP if gzip (or '*') is accepted
+ * @retval   BVIEW_REST_ENCODING_DEFLATE if deflate is accepted
+ * @retval   BVIEW_REST_ENCODING_IDENTITY otherwise
+ * 
+ * @note     A coding with "q=0" is refused by the client, other
+ *           weights are not looked at. gzip is taken over deflate.
+ *********************************************************************/
+static BVIEW_REST_ENCODING_t rest_parse_accept_encoding(const char *header, const char *end)
+{
+    const char *line = header, *eol = NULL, *cur = NULL, *next = NULL, *q = NULL;
+    BVIEW_REST_ENCODING_t encoding = BVIEW_REST_ENCODING_IDENTITY;
+    BVIEW_REST_ENCODING_t coding;
+    int length = strlen(REST_HTTP_ACCEPT_ENCODING);
+
+    while (line < end)
+    {
+        eol = strstr(line, REST_HTTP_CRLF);
+        if ((NULL == eol) || (eol > end))
+            eol = end;
+
+        if (0 == strncasecmp(line, REST_HTTP_ACCEPT_ENCODING, length))
+        {
+            /* codings are separated by ',', each may have a ';q=' weight */
+            for (cur = line + length; cur < eol; cur = next + 1)
+            {
+                next = memchr(cur, ',', eol - cur);
+                if (NULL == next)
+                    next = eol;
+
+                while ((cur < next) && ((' ' == *cur) || ('\t' == *cur)))
+                    cur++;
+
+                if ((next - cur >= 4) && (0 == strncasecmp(cur, BVIEW_REST_ENCODING_NAME_GZIP, 4)))
+                    coding = BVIEW_REST_ENCODING_GZIP;
+                else if ((next - cur >= 1) && ('*' == *cur))
+                    coding = BVIEW_REST_ENCODING_GZIP;
+                else if ((next - cur >= 7) &&
+                         (0 == strncasecmp(cur, BVIEW_REST_ENCODING_NAME_DEFLATE, 7)))
+                    coding = BVIEW_REST_ENCODING_DEFLATE;
+                else
+                    continue;
+
+                /* refused with a 0 weight, "q=0", "q=0.0", ... */
+                q = memchr(cur, '=', next - cur);
+                if (NULL != q)
+                {
+                    for (q++; (q < next) && (('0' == *q) || ('.' == *q) || (' ' == *q)); q++)
+                        ;
+                    if (q == next)
+                        continue;
+                }
+
+                if ((BVIEW_REST_ENCODING_IDENTITY == encoding) ||
+                    (BVIEW_REST_ENCODING_GZIP == coding))
+                    encoding = coding;
+            }
+        }
+
+        line = eol + strlen(REST_HTTP_CRLF);
+    }
+
+    return encoding;
+}
+
 /******************************************************************
  * @brief  This function parses http request to extract relevant fields.
  *
@@ -129,7 +272,7 @@ static BVIEW_STATUS rest_parse_http_request_to_session (REST_SESSION_t *session)
 
 
     /* HTTP method will be the first word of the request */
-    httpMethod = strtok(buf, REST_HTTP_SPACE);
+    httpMethod = rest_http_word_get(buf);
     _REST_ASSERT_NET_ERROR((httpMethod != NULL), "REST : Invalid HTTP Request \n");
 
     /* validate the method */
@@ -139,7 +282,7 @@ static BVIEW_STATUS rest_parse_http_request_to_session (REST_SESSION_t *session)
     /* advance the buf, now it should point to the URL */
     buf += strlen(httpMethod) + 1;
 
-    url = strtok(buf, REST_HTTP_SPACE);
+    url = rest_http_word_get(buf);
     _REST_ASSERT_NET_ERROR((url != NULL), "REST : Invalid HTTP Request \n");
 
     /* obtain the REST method */
@@ -173,6 +316,10 @@ static BVIEW_STATUS rest_parse_http_request_to_session (REST_SESSION_t *session)
     json = strstr(buf, REST_HTTP_TWIN_CRLF);
     _REST_ASSERT_NET_ERROR((json != NULL), "REST : Invalid HTTP Request \n");
 
+    /* the format the client takes a report in */
+    session->accept = rest_parse_accept_format(buf, json);
+    session->acceptEncoding = rest_parse_accept_encoding(buf, json);
+
     /* move past the end of header, after which, json points to body */
     json += strlen(REST_HTTP_TWIN_CRLF);
 
@@ -187,114 +334,151 @@ static BVIEW_STATUS rest_parse_http_request_to_session (REST_SESSION_t *session)
 }
 
 /******************************************************************
- * @brief  This function processes incoming http request .
+ * @brief  finds the value of a header of an HTTP request
  *
- * @param[in]   rest    REST context for operation
- * @param[in]   fd      socket to read request data from
- * @param[in]   peer    The connecting peer details
+ * @param[in]   header    start of the HTTP header
+ * @param[in]   end       end of the HTTP header
+ * @param[in]   name      header name, with its ':'
+ *
+ * @retval   start of the value, blanks skipped, if the header is there
+ * @retval   NULL otherwise
+ * 
+ * @note     Header names are not case sensitive.
+ *********************************************************************/
+static const char *rest_http_header_value(const char *header, const char *end,
+                                          const char *name)
+{
+    const char *line = header, *eol = NULL, *value = NULL;
+    int length = strlen(name);
+
+    while (line < end)
+    {
+        eol = line;
+        while ((eol < end) && ('\r' != *eol) && ('\n' != *eol))
+            eol++;
+
+        if ((eol - line >= length) && (0 == strncasecmp(line, name, length)))
+        {
+            for (value = line + length; (value < eol) && ((' ' == *value) || ('\t' == *value)); value++)
+                ;
+            return value;
+        }
+
+        line = eol + strlen(REST_HTTP_CRLF);
+    }
+
+    return NULL;
+}
+
+/******************************************************************
+ * @brief  finds where the first request of the bytes received on a
+ *         connection ends
+ *
+ * @param[in]   input            bytes received
+ * @param[in]   length           number of bytes received
+ * @param[out]  requestLength    length of the request, header and body
+ * @param[out]  unframed         true if the header is complete and has
+ *                               no Content-Length
+ * @param[out]  keepAlive        true if the client keeps the connection
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if the request is complete
+ * @retval   BVIEW_STATUS_RESOURCE_NOT_AVAILABLE if more bytes are needed,
+ *           or the body of the request is not delimited
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER if the Content-Length is not
+ *           valid or the request does not fit the session buffer
+ * 
+ * @note     A request without Content-Length ends when the client closes
+ *           the connection or stops sending, as it did before the
+ *           connections were kept.
+ *********************************************************************/
+static BVIEW_STATUS rest_http_request_frame(const char *input, int length,
+                                            int *requestLength, bool *unframed,
+                                            bool *keepAlive)
+{
+    const char *end = NULL, *eol = NULL, *value = NULL;
+    int headerLength = 0, twinLength = strlen(REST_HTTP_TWIN_CRLF);
+    int i;
+    long contentLength;
+    char *stop = NULL;
+
+    *requestLength = 0;
+    *unframed = false;
+
+    for (i = 0; i + twinLength <= length; i++)
+    {
+        if (0 == memcmp(&input[i], REST_HTTP_TWIN_CRLF, twinLength))
+        {
+            end = &input[i];
+            break;
+        }
+    }
+
+    if (NULL == end)
+    {
+        return (length < REST_MAX_HTTP_BUFFER_LENGTH) ?
+                BVIEW_STATUS_RESOURCE_NOT_AVAILABLE : BVIEW_STATUS_INVALID_PARAMETER;
+    }
+    headerLength = (end - input) + twinLength;
+
+    /* HTTP/1.1 keeps the connection unless asked to close it,
+       HTTP/1.0 closes it unless asked to keep it */
+    for (eol = input; (eol < end) && ('\r' != *eol); eol++)
+        ;
+    *keepAlive = !((eol - input >= 8) && (0 == strncmp(eol - 8, "HTTP/1.0", 8)));
+
+    value = rest_http_header_value(input, end, REST_HTTP_CONNECTION);
+    if (NULL != value)
+    {
+        if (0 == strncasecmp(value, REST_HTTP_CONNECTION_CLOSE, strlen(REST_HTTP_CONNECTION_CLOSE)))
+            *keepAlive = false;
+        else if (0 == strncasecmp(value, REST_HTTP_CONNECTION_KEEP_ALIVE,
+                                  strlen(REST_HTTP_CONNECTION_KEEP_ALIVE)))
+            *keepAlive = true;
+    }
+
+    value = rest_http_header_value(input, end, REST_HTTP_CONTENT_LENGTH);
+    if (NULL == value)
+    {
+        *unframed = true;
+        return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+    }
+
+    errno = 0;
+    contentLength = strtol(value, &stop, 10);
+    if ((0 != errno) || (stop == value) || (contentLength < 0) ||
+        (contentLength > REST_MAX_HTTP_BUFFER_LENGTH - headerLength))
+    {
+        return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    if (headerLength + contentLength > length)
+        return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+
+    *requestLength = headerLength + contentLength;
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  This function processes an incoming http request .
+ *
+ * @param[in]   rest       REST context for operation
+ * @param[in]   session    session holding the request in its buffer
  * 
- * @note     All errors are processed internally. Caller ignores the RV
+ * @note     All errors are processed internally. Caller ignores the RV.
+ *           The request is answered here on errors, by the handler's
+ *           application otherwise. Called from the workers.
  *********************************************************************/
-static BVIEW_STATUS rest_process_http_request (REST_CONTEXT_t *rest,
-                                               int fd,
-                                               struct sockaddr_in peer,
-                                               socklen_t peerLen)
+BVIEW_STATUS rest_process_http_request (REST_CONTEXT_t *rest,
+                                        REST_SESSION_t *session)
 {
-    int sessionId;
     BVIEW_STATUS status, ret;
-    REST_SESSION_t *session;
-    char *buf;
-    int length = 0;
-    int temp = 0;
+    int fd = session->connectionFd;
     int id =0;
-    struct timeval timeout;
-    fd_set cset;
-    int retval = 0;
-    
 
     BVIEW_REST_API_HANDLER_t handler;
 
     _REST_LOG(_REST_DEBUG_TRACE, "Extracting data from incoming request  \n");
 
-    /* find an available session buffer for this request */
-    status = rest_allocate_session(rest, &sessionId);
-    _REST_ASSERT_NET_ERROR((status == BVIEW_STATUS_SUCCESS),
-                           "REST : No available session for incoming request \n");
-    session = &rest->sessions[sessionId];
-
-    buf = &session->buffer[0];
-
-   for (;;)
-   {
-     FD_ZERO (&cset);
-     FD_SET (fd, &cset);
-
-     timeout.tv_sec = 2;
-     timeout.tv_usec = 0;
-
-     retval = select (fd+1, &cset, NULL, NULL, &timeout);
-     if (retval < 0) 
-     {
-       /* error; log/die/whatever and close() socket */
-       _REST_LOG(_REST_DEBUG_ERROR,
-           "REST : Error select of socket failed, closing socket [%d : %s] \n",
-           errno, strerror(errno));
-       close(fd);
-       return BVIEW_STATUS_SUCCESS;
-     }
-     else if (retval == 0) 
-     {
-       /* timed out without receiving any data; log/die/whatever and close() */
-       _REST_LOG(_REST_DEBUG_ERROR,
-           "REST : Socket timed out no data, closing socket [%d : %s] \n",
-           errno, strerror(errno));
-       break;
-     }
-
-     temp = read(fd, (buf + length), (REST_MAX_HTTP_BUFFER_LENGTH - length));
-     if (temp < 0)
-     {
-       if (errno == EINTR)
-       {
-         continue; /* perfectly normal; try again */
-       }
-       else if (errno == EAGAIN) 
-       {
-         continue;
-       }
-       else
-       {
-         /* some real error; log/die/whatever and close() socket */
-         _REST_LOG(_REST_DEBUG_ERROR,
-             "REST : Socket read error, closing socket [%d : %s] \n",
-             errno, strerror(errno));
-         close(fd);
-         return BVIEW_STATUS_SUCCESS;
-       }
-     } 
-     else if (temp == 0)
-     {
-       /* the connection has been closed by your peer; clean-up and close() */
-       _REST_LOG(_REST_DEBUG_ERROR,
-           "REST : Socket closed by peer, closing socket [%d : %s] \n",
-           errno, strerror(errno));
-       break;
-     }
-     else
-     {
-       /* you got some data; do whatever with it... */
-       length += temp;
-       continue;
-     }
-   }
-
-
-    /* update the session */
-    session->connectionFd = fd;
-    session->peerAddr = peer;
-    time(&session->creationTime);
-    session->length = length;
-
     status = rest_parse_http_request_to_session(session);
 
     ret =  rest_get_id_from_request (session->json, session->length, &id);
@@ -303,8 +487,7 @@ static BVIEW_STATUS rest_process_http_request (REST_CONTEXT_t *rest,
     {
       status = BVIEW_STATUS_UNSUPPORTED;
       rest_json_error_fn_invoke(fd, status, id);
-      close(fd);
-      session->inUse = false;
+      rest_session_release(rest, session, true);
       return BVIEW_STATUS_SUCCESS;
     }
     else
@@ -313,7 +496,7 @@ static BVIEW_STATUS rest_process_http_request (REST_CONTEXT_t *rest,
       {
         /* send a 404 unsupported back to client */
         rest_send_404(fd);
-        close(fd);
+        rest_session_release(rest, session, true);
         return BVIEW_STATUS_SUCCESS;
       }
     }
@@ -322,9 +505,6 @@ static BVIEW_STATUS rest_process_http_request (REST_CONTEXT_t *rest,
 
     rest_session_dump(session);
 
-    /* mark the session as 'used' */
-    session->inUse = true;
-
     /* talk to module manager and get the handler for this request */
     status = modulemgr_rest_api_handler_get(session->json, session->length, &handler);
    
@@ -337,8 +517,7 @@ static BVIEW_STATUS rest_process_http_request (REST_CONTEXT_t *rest,
     {
       status = BVIEW_STATUS_UNSUPPORTED;
       rest_json_error_fn_invoke(fd, status, id);
-      close(fd);
-      session->inUse = false;
+      rest_session_release(rest, session, true);
       return BVIEW_STATUS_SUCCESS;
     }
     else
@@ -348,8 +527,7 @@ static BVIEW_STATUS rest_process_http_request (REST_CONTEXT_t *rest,
       {
         /* send a 404 unsupported back to client */
         rest_send_404(fd);
-        close(fd);
-        session->inUse = false;
+        rest_session_release(rest, session, true);
         return BVIEW_STATUS_SUCCESS;
       }
     }
@@ -360,8 +538,7 @@ static BVIEW_STATUS rest_process_http_request (REST_CONTEXT_t *rest,
     if ((BVIEW_STATUS_SUCCESS == ret) && (BVIEW_STATUS_SUCCESS != status))
     {
       rest_json_error_fn_invoke(fd, status, id);
-      close(fd);
-      session->inUse = false;
+      rest_session_release(rest, session, true);
       return BVIEW_STATUS_SUCCESS;
     }
     else
@@ -378,16 +555,368 @@ static BVIEW_STATUS rest_process_http_request (REST_CONTEXT_t *rest,
           rest_send_400(fd);
         }
 
-        close(fd);
-        session->inUse = false;
+        rest_session_release(rest, session, true);
         return BVIEW_STATUS_SUCCESS;
       }
     }
 
-    /* we keep the session, and keep the fd open. */
+    /* the session is kept busy till the request is answered */
     return BVIEW_STATUS_SUCCESS;
 }
 
+/******************************************************************
+ * @brief  tells if the request of a session is being handled
+ *
+ * @param[in]   rest       REST context for operation
+ * @param[in]   session    session to look at
+ *
+ * @note     The thread answering the request clears it.
+ *********************************************************************/
+static bool rest_session_busy(REST_CONTEXT_t *rest, REST_SESSION_t *session)
+{
+    bool busy;
+
+    pthread_mutex_lock(&rest->session_mutex);
+    busy = session->busy;
+    pthread_mutex_unlock(&rest->session_mutex);
+
+    return busy;
+}
+
+/******************************************************************
+ * @brief  starts or stops reading the connection of a session
+ *
+ * @param[in]   rest       REST context for operation
+ * @param[in]   session    session of the connection
+ * @param[in]   watch      true to read the connection
+ *
+ * @note     The connection is not read while a request on it is being
+ *           handled, a client closing it would wake the server up
+ *           till the request is answered.
+ *********************************************************************/
+static void rest_session_watch(REST_CONTEXT_t *rest, REST_SESSION_t *session, bool watch)
+{
+    struct epoll_event event;
+
+    if (watch == session->watched)
+        return;
+
+    memset(&event, 0, sizeof (event));
+    event.events = EPOLLIN;
+    event.data.u32 = (uint32_t) (session - &rest->sessions[0]);
+
+    if (0 != epoll_ctl(rest->epollFd, (true == watch) ? EPOLL_CTL_ADD : EPOLL_CTL_DEL,
+                       session->connectionFd, &event))
+    {
+        _REST_LOG(_REST_DEBUG_ERROR, "REST : Failed to update the events of a connection [%d : %s] \n",
+                  errno, strerror(errno));
+        return;
+    }
+    session->watched = watch;
+}
+
+/******************************************************************
+ * @brief  closes the connection of a session and frees the session
+ *
+ * @param[in]   rest       REST context for operation
+ * @param[in]   session    session to close
+ *
+ * @note     Only called for sessions without a request being handled
+ *********************************************************************/
+static void rest_session_close(REST_CONTEXT_t *rest, REST_SESSION_t *session)
+{
+    rest_session_watch(rest, session, false);
+    close(session->connectionFd);
+
+    pthread_mutex_lock(&rest->session_mutex);
+    session->inUse = false;
+    pthread_mutex_unlock(&rest->session_mutex);
+}
+
+/******************************************************************
+ * @brief  handles the requests received on a connection, one at a time
+ *
+ * @param[in]   rest       REST context for operation
+ * @param[in]   session    session of the connection
+ * @param[in]   complete   true if no more bytes are expected, the client
+ *                         closed the connection or stopped sending
+ *
+ * @note     Pipelined requests wait in the input of the session till
+ *           the one before them is answered. The session may be closed
+ *           on return.
+ *********************************************************************/
+static void rest_session_input_process(REST_CONTEXT_t *rest, REST_SESSION_t *session,
+                                       bool complete)
+{
+    BVIEW_STATUS status;
+    int requestLength = 0;
+    bool unframed = false, keepAlive = false;
+
+    while ((0 != session->inputLength) && (true == session->keepAlive) &&
+           (false == rest_session_busy(rest, session)))
+    {
+        status = rest_http_request_frame(session->input, session->inputLength,
+                                         &requestLength, &unframed, &keepAlive);
+
+        if (BVIEW_STATUS_INVALID_PARAMETER == status)
+        {
+            _REST_LOG(_REST_DEBUG_ERROR, "REST : Invalid HTTP Request, closing socket \n");
+            rest_send_400(session->connectionFd);
+            rest_session_close(rest, session);
+            return;
+        }
+
+        if (BVIEW_STATUS_RESOURCE_NOT_AVAILABLE == status)
+        {
+            if ((false == complete) && (session->inputLength < REST_MAX_HTTP_BUFFER_LENGTH))
+                return;
+
+            if (false == unframed)
+            {
+                /* the client left in the middle of a request */
+                _REST_LOG(_REST_DEBUG_ERROR, "REST : Incomplete HTTP Request, closing socket \n");
+                rest_session_close(rest, session);
+                return;
+            }
+
+            /* the request is what has been received, the connection can not be kept */
+            requestLength = session->inputLength;
+            keepAlive = false;
+        }
+
+        /* move the request to the session buffer, the rest waits its turn */
+        memcpy(session->buffer, session->input, requestLength);
+        session->buffer[requestLength] = '\0';
+        session->length = requestLength;
+        session->inputLength -= requestLength;
+        memmove(session->input, &session->input[requestLength], session->inputLength);
+        time(&session->creationTime);
+
+        pthread_mutex_lock(&rest->session_mutex);
+        session->busy = true;
+        session->answered = false;
+        session->keepAlive = keepAlive;
+        pthread_mutex_unlock(&rest->session_mutex);
+
+        rest_session_watch(rest, session, false);
+
+        /* a worker parses and dispatches the request */
+        rest_workers_post(rest, session);
+    }
+}
+
+/******************************************************************
+ * @brief  reads the bytes a client sent on its connection
+ *
+ * @param[in]   rest       REST context for operation
+ * @param[in]   session    session of the connection
+ *
+ * @note     The session may be closed on return.
+ *********************************************************************/
+static void rest_session_read(REST_CONTEXT_t *rest, REST_SESSION_t *session)
+{
+    int temp;
+    bool closed = false;
+
+    while (session->inputLength < REST_MAX_HTTP_BUFFER_LENGTH)
+    {
+        temp = recv(session->connectionFd, &session->input[session->inputLength],
+                    REST_MAX_HTTP_BUFFER_LENGTH - session->inputLength, MSG_DONTWAIT);
+        if (temp > 0)
+        {
+            session->inputLength += temp;
+            time(&session->lastActivity);
+            continue;
+        }
+
+        if (temp == 0)
+        {
+            /* the connection has been closed by the peer */
+            closed = true;
+            break;
+        }
+
+        if (errno == EINTR)
+            continue; /* perfectly normal; try again */
+
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            break;
+
+        /* some real error */
+        _REST_LOG(_REST_DEBUG_ERROR,
+            "REST : Socket read error, closing socket [%d : %s] \n",
+            errno, strerror(errno));
+        rest_session_close(rest, session);
+        return;
+    }
+
+    rest_session_input_process(rest, session, closed);
+    if (false == session->inUse)
+        return;
+
+    if (true == closed)
+    {
+        /* a request still being handled closes the connection once answered */
+        pthread_mutex_lock(&rest->session_mutex);
+        session->keepAlive = false;
+        pthread_mutex_unlock(&rest->session_mutex);
+
+        if (false == rest_session_busy(rest, session))
+            rest_session_close(rest, session);
+        return;
+    }
+
+    rest_session_watch(rest, session, !rest_session_busy(rest, session));
+}
+
+/******************************************************************
+ * @brief  accepts the connections waiting on the listening socket
+ *
+ * @param[in]   rest        REST context for operation
+ * @param[in]   listenFd    listening socket
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if the socket is still listening
+ * @retval   BVIEW_STATUS_FAILURE if it is not, e.g. shut down for a
+ *           change of the port
+ * 
+ * @note     
+ *********************************************************************/
+static BVIEW_STATUS rest_sessions_accept(REST_CONTEXT_t *rest, int listenFd)
+{
+    struct sockaddr_in peerAddr;
+    socklen_t peerLen;
+    REST_SESSION_t *session;
+    BVIEW_STATUS status;
+    int sessionId = 0;
+    int fd, flag = 1;
+
+    while (true)
+    {
+        peerLen = sizeof (peerAddr);
+
+        fd = accept(listenFd, (struct sockaddr*) &peerAddr, &peerLen);
+        if (fd == -1)
+        {
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK) ||
+                (errno == EINTR) || (errno == ECONNABORTED))
+                return BVIEW_STATUS_SUCCESS;
+
+            _REST_LOG(_REST_DEBUG_ERROR, "Accept failed with error [%d: %s] \n", errno, strerror(errno));  
+            return BVIEW_STATUS_FAILURE;
+        }
+
+        _REST_LOG(_REST_DEBUG_TRACE, "Received connection \n");
+
+        /* find an available session for this connection */
+        status = rest_allocate_session(rest, &sessionId);
+        if (BVIEW_STATUS_SUCCESS != status)
+        {
+            _REST_LOG(_REST_DEBUG_ERROR, "REST : No available session for incoming connection \n");
+            close(fd);
+            continue;
+        }
+        session = &rest->sessions[sessionId];
+
+        /* responses are written whole, nothing is gained by delaying them */
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof (flag));
+
+        session->connectionFd = fd;
+        session->peerAddr = peerAddr;
+        session->keepAlive = true;
+        session->watched = false;
+        time(&session->lastActivity);
+
+        pthread_mutex_lock(&rest->session_mutex);
+        session->inUse = true;
+        pthread_mutex_unlock(&rest->session_mutex);
+
+        rest_session_watch(rest, session, true);
+        if (false == session->watched)
+            rest_session_close(rest, session);
+    }
+}
+
+/******************************************************************
+ * @brief  takes back the connections of the answered requests
+ *
+ * @param[in]   rest    REST context for operation
+ *
+ * @note     The connection is closed, or its next request handled
+ *********************************************************************/
+static void rest_sessions_answered(REST_CONTEXT_t *rest)
+{
+    REST_SESSION_t *session;
+    bool answered, keepAlive;
+    int i;
+
+    for (i = 0; i < REST_MAX_SESSIONS; i++)
+    {
+        session = &rest->sessions[i];
+
+        pthread_mutex_lock(&rest->session_mutex);
+        answered = session->inUse && session->answered && !session->busy;
+        keepAlive = session->keepAlive;
+        session->answered = false;
+        pthread_mutex_unlock(&rest->session_mutex);
+
+        if (false == answered)
+            continue;
+
+        if (false == keepAlive)
+        {
+            rest_session_close(rest, session);
+            continue;
+        }
+
+        time(&session->lastActivity);
+
+        /* pipelined requests, if any */
+        rest_session_input_process(rest, session, false);
+        if (true == session->inUse)
+            rest_session_watch(rest, session, !rest_session_busy(rest, session));
+    }
+}
+
+/******************************************************************
+ * @brief  handles the connections a client stopped sending on
+ *
+ * @param[in]   rest    REST context for operation
+ * @param[in]   now     current time
+ *
+ * @note     A partial request is handled as it is after
+ *           REST_REQUEST_TIMEOUT, an idle connection is closed after
+ *           REST_KEEPALIVE_TIMEOUT
+ *********************************************************************/
+static void rest_sessions_expire(REST_CONTEXT_t *rest, time_t now)
+{
+    REST_SESSION_t *session;
+    int i;
+
+    for (i = 0; i < REST_MAX_SESSIONS; i++)
+    {
+        session = &rest->sessions[i];
+
+        if ((false == session->inUse) || (false == session->watched) ||
+            (true == rest_session_busy(rest, session)))
+            continue;
+
+        if ((0 != session->inputLength) &&
+            (now - session->lastActivity >= REST_REQUEST_TIMEOUT))
+        {
+            _REST_LOG(_REST_DEBUG_ERROR, "REST : Socket timed out, handling the data received \n");
+            rest_session_input_process(rest, session, true);
+            if (true == session->inUse)
+                rest_session_watch(rest, session, !rest_session_busy(rest, session));
+        }
+        else if ((0 == session->inputLength) &&
+                 (now - session->lastActivity >= REST_KEEPALIVE_TIMEOUT))
+        {
+            _REST_LOG(_REST_DEBUG_TRACE, "REST : Idle connection, closing socket \n");
+            rest_session_close(rest, session);
+        }
+    }
+}
+
 /******************************************************************
  * @brief  This function starts a web server and never returns (unless an error).
  *
@@ -395,20 +924,38 @@ static BVIEW_STATUS rest_process_http_request (REST_CONTEXT_t *rest,
  *                           
  * @retval   BVIEW_STATUS_FAILURE Error creating web server
  *
- * @note     IPv4 only, non-multi-threaded.
+ * @note     IPv4 only. The connections are served from one epoll loop
+ *           which only frames the requests, the workers parse and
+ *           dispatch them and the applications answer them from their
+ *           own threads. A client keeps its connection for further
+ *           requests.
  *********************************************************************/
 BVIEW_STATUS rest_http_server_run(REST_CONTEXT_t *rest)
 {
-    int listenFd, connectionFd;
-    int temp;
+    int listenFd;
+    int temp, count, i;
     struct sockaddr_in serverAddr;
-    struct sockaddr_in peerAddr;
-    socklen_t peerLen;
+    struct epoll_event event;
+    struct epoll_event events[REST_MAX_EVENTS];
     BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
     bool  sock_closed = false;
+    uint64_t wake;
+    time_t now, lastScan = 0;
 
     _REST_ASSERT(rest != NULL);
 
+    /* events of the listening socket, the connections and the answering threads */
+    rest->epollFd = epoll_create(REST_MAX_SESSIONS);
+    _REST_ASSERT_NET_ERROR((rest->epollFd != -1), "Error creating epoll instance");
+
+    rest->wakeFd = eventfd(0, EFD_NONBLOCK);
+    _REST_ASSERT_NET_SOCKET_ERROR((rest->wakeFd != -1), "Error creating eventfd", rest->epollFd);
+
+    memset(&event, 0, sizeof (event));
+    event.events = EPOLLIN;
+    event.data.u32 = REST_EVENT_WAKE;
+    temp = epoll_ctl(rest->epollFd, EPOLL_CTL_ADD, rest->wakeFd, &event);
+    _REST_ASSERT_NET_SOCKET_ERROR((temp != -1), "Error watching eventfd", rest->epollFd);
 
     while (1)
     {
@@ -445,30 +992,65 @@ BVIEW_STATUS rest_http_server_run(REST_CONTEXT_t *rest)
       }
       _REST_ASSERT_NET_SOCKET_ERROR((temp != -1), "Error listening (making socket as passive) ",listenFd);
 
-      /* Every thing set, start accepting connections */
+      /* connections are accepted as long as there are any waiting */
+      temp = fcntl(listenFd, F_GETFL, 0);
+      temp = fcntl(listenFd, F_SETFL, temp | O_NONBLOCK);
+      _REST_ASSERT_NET_SOCKET_ERROR((temp != -1), "Error making the socket non blocking ",listenFd);
+
+      memset(&event, 0, sizeof (event));
+      event.events = EPOLLIN;
+      event.data.u32 = REST_EVENT_LISTEN;
+      temp = epoll_ctl(rest->epollFd, EPOLL_CTL_ADD, listenFd, &event);
+      _REST_ASSERT_NET_SOCKET_ERROR((temp != -1), "Error watching the server socket ",listenFd);
+
+      /* Every thing set, serve the connections */
       while (true)
       {
-        _REST_LOG(_REST_DEBUG_TRACE, "Waiting for HTTP connections on port %d \n", rest->config.localPort);
+        _REST_LOG(_REST_DEBUG_TRACE, "Waiting for HTTP events on port %d \n", rest->config.localPort);
 
-        peerLen = sizeof (peerAddr);
-
-        /* wait for an incoming connection */
-        temp = accept(listenFd, (struct sockaddr*) &peerAddr, &peerLen);
-        if (temp == -1)
-        {   
-          _REST_LOG(_REST_DEBUG_ERROR, "Accept failed with error [%d: %s] \n", errno, strerror(errno));  
-          close(listenFd);
-          sock_closed = true;
-          break; 
+        /* woken up once a second at least, for the timeouts */
+        count = epoll_wait(rest->epollFd, events, REST_MAX_EVENTS, 1000);
+        if ((count == -1) && (errno != EINTR))
+        {
+          _REST_LOG(_REST_DEBUG_ERROR, "Epoll wait failed with error [%d: %s] \n", errno, strerror(errno));  
         }
 
-        _REST_LOG(_REST_DEBUG_TRACE, "Received connection \n");
+        for (i = 0; i < count; i++)
+        {
+          if (REST_EVENT_LISTEN == events[i].data.u32)
+          {
+            if (BVIEW_STATUS_SUCCESS != rest_sessions_accept(rest, listenFd))
+              sock_closed = true;
+          }
+          else if (REST_EVENT_WAKE == events[i].data.u32)
+          {
+            while (sizeof (wake) == read(rest->wakeFd, &wake, sizeof (wake)))
+              ;
+            rest_sessions_answered(rest);
+          }
+          else if (events[i].data.u32 < REST_MAX_SESSIONS)
+          {
+            /* the session may have been closed by an earlier event */
+            if ((true == rest->sessions[events[i].data.u32].inUse) &&
+                (true == rest->sessions[events[i].data.u32].watched))
+              rest_session_read(rest, &rest->sessions[events[i].data.u32]);
+          }
+        }
 
-        /* initialize the connection socket */
-        connectionFd = temp;
+        time(&now);
+        if (now != lastScan)
+        {
+          lastScan = now;
+          rest_sessions_expire(rest, now);
+        }
 
-        /* process the request */
-        rest_process_http_request(rest, connectionFd, peerAddr, peerLen);
+        if (sock_closed == true)
+        {
+          /* the connections of the clients are kept */
+          epoll_ctl(rest->epollFd, EPOLL_CTL_DEL, listenFd, &event);
+          close(listenFd);
+          break;
+        }
       }
       if (sock_closed == true)
       {
@@ -499,14 +1081,16 @@ BVIEW_STATUS rest_get_id_from_request(char * jsonBuffer, int bufLength, int *id)
   JSON_VALIDATE_JSON_POINTER(root,"root",BVIEW_STATUS_INVALID_JSON);
 
 
+  /* every check below frees 'root' before it returns */
   json_id = cJSON_GetObjectItem(root, "id");
-  JSON_VALIDATE_JSON_POINTER(json_id, "id", BVIEW_STATUS_INVALID_JSON);
+  JSON_VALIDATE_JSON_POINTER_AND_CLEANUP(json_id, "id", BVIEW_STATUS_INVALID_JSON);
   JSON_VALIDATE_JSON_AS_NUMBER(json_id, "id");
   temp_id = json_id->valueint;
   /* Ensure  that the number 'id' is within range of [1,100000] */
   JSON_CHECK_VALUE_AND_CLEANUP (temp_id, 1, 100000);
 
   *id = temp_id;
+  cJSON_Delete(root);
   return BVIEW_STATUS_SUCCESS;
 
 }
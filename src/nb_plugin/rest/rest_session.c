@@ -19,6 +19,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
 
 #include "broadview.h"
 #include "rest.h"
@@ -47,6 +49,10 @@ BVIEW_STATUS rest_sessions_init(REST_CONTEXT_t *context)
         session->inUse = false;
     }
 
+    pthread_mutex_init(&context->session_mutex, NULL);
+    context->epollFd = -1;
+    context->wakeFd = -1;
+
     return BVIEW_STATUS_SUCCESS;
 }
 
@@ -88,13 +94,54 @@ BVIEW_STATUS rest_session_validate(REST_CONTEXT_t *context, REST_SESSION_t *sess
     
     for (i = 0; i < REST_MAX_SESSIONS; i++)
     {
-        if (&context->sessions[i] == session)
+        if ((&context->sessions[i] == session) && (true == session->inUse))
             return BVIEW_STATUS_SUCCESS;
     }
     
     return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
 }
 
+/******************************************************************
+ * @brief  hands the connection of an answered request back to the
+ *         server
+ *
+ * @param[in]   context      REST context for operation
+ * @param[in]   session      session whose request is answered
+ * @param[in]   keep         false if the connection is to be closed,
+ *                           e.g. the answer did not make it out
+ *
+ * @note     The server closes the connection, or reads the next
+ *           request from it if the client keeps it alive. This is
+ *           called from the thread answering the request, which must
+ *           not touch the session after.
+ *********************************************************************/
+void rest_session_release(REST_CONTEXT_t *context, REST_SESSION_t *session, bool keep)
+{
+    uint64_t wake = 1;
+
+    if (0 != pthread_mutex_lock(&context->session_mutex))
+    {
+        LOG_POST (BVIEW_LOG_ERROR, "Failed to take the lock for rest sessions \r\n");
+        return;
+    }
+
+    session->busy = false;
+    session->answered = true;
+    if (false == keep)
+    {
+        session->keepAlive = false;
+    }
+
+    pthread_mutex_unlock(&context->session_mutex);
+
+    /* the server looks at the answered sessions once it is woken up */
+    if (sizeof (wake) != write(context->wakeFd, &wake, sizeof (wake)))
+    {
+        _REST_LOG(_REST_DEBUG_ERROR, "REST : Failed to wake up the server [%d : %s] \n",
+                  errno, strerror(errno));
+    }
+}
+
 /******************************************************************
  * @brief  dump a session on console/log
  *
@@ -0,0 +1,248 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <sys/time.h>
+
+#include "broadview.h"
+#include "rest.h"
+
+/* a worker, and the context it works for */
+typedef struct _rest_worker_arg_
+{
+    REST_CONTEXT_t *rest;
+    int index;
+} REST_WORKER_ARG_t;
+
+static REST_WORKER_ARG_t restWorkerArgs[REST_MAX_WORKERS];
+
+/******************************************************************
+ * @brief  gets the time, in microseconds
+ *
+ * @note     Wall clock time, as pthread_cond_timedwait() takes
+ *********************************************************************/
+uint64_t rest_time_usec(void)
+{
+    struct timeval now;
+
+    gettimeofday(&now, NULL);
+    return ((uint64_t) now.tv_sec * 1000000) + now.tv_usec;
+}
+
+/******************************************************************
+ * @brief  parses and dispatches the requests of the queue
+ *
+ * @param[in]   arg      worker, REST_WORKER_ARG_t
+ *
+ * @note     A worker beyond the configured number waits till the
+ *           pool grows again.
+ *********************************************************************/
+static void *rest_worker_run(void *arg)
+{
+    REST_WORKER_ARG_t *worker = (REST_WORKER_ARG_t *) arg;
+    REST_WORKERS_t *workers = &worker->rest->workers;
+    REST_SESSION_t *session;
+    uint64_t wait;
+
+    pthread_mutex_lock(&workers->mutex);
+
+    while (true)
+    {
+        while ((0 == workers->count) || (worker->index >= workers->active))
+        {
+            pthread_cond_wait(&workers->cond, &workers->mutex);
+        }
+
+        session = workers->queue[workers->head];
+        workers->head = (workers->head + 1) % REST_MAX_SESSIONS;
+        workers->count--;
+        workers->dispatching++;
+
+        wait = rest_time_usec();
+        wait = (wait > session->queuedAt) ? (wait - session->queuedAt) : 0;
+        workers->requests++;
+        workers->waitTotal += wait;
+        if (wait > workers->waitMax)
+            workers->waitMax = wait;
+
+        pthread_mutex_unlock(&workers->mutex);
+
+        /* the request is answered here on errors, by the application otherwise */
+        rest_process_http_request(worker->rest, session);
+
+        pthread_mutex_lock(&workers->mutex);
+        workers->dispatching--;
+    }
+
+    return NULL;
+}
+
+/******************************************************************
+ * @brief  sets the number of workers, starting the ones missing
+ *
+ * @param[in]   rest      REST context for operation
+ * @param[in]   count     number of workers, 1 to REST_MAX_WORKERS
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if at least one worker is running
+ * @retval   BVIEW_STATUS_FAILURE otherwise
+ *
+ * @note     Workers are not stopped, the ones beyond the number wait
+ *           without taking requests.
+ *********************************************************************/
+BVIEW_STATUS rest_workers_resize(REST_CONTEXT_t *rest, int count)
+{
+    REST_WORKERS_t *workers = &rest->workers;
+    BVIEW_STATUS status = BVIEW_STATUS_SUCCESS;
+
+    if (count < 1)
+        count = 1;
+    if (count > REST_MAX_WORKERS)
+        count = REST_MAX_WORKERS;
+
+    if (0 != pthread_mutex_lock(&workers->mutex))
+    {
+        LOG_POST (BVIEW_LOG_ERROR, "Failed to take the lock for rest workers \r\n");
+        return BVIEW_STATUS_FAILURE;
+    }
+
+    while (workers->started < count)
+    {
+        restWorkerArgs[workers->started].rest = rest;
+        restWorkerArgs[workers->started].index = workers->started;
+
+        if (0 != pthread_create(&workers->threads[workers->started], NULL,
+                                rest_worker_run, &restWorkerArgs[workers->started]))
+        {
+            _REST_LOG(_REST_DEBUG_ERROR, "REST : Failed to start a worker [%d : %s] \n",
+                      errno, strerror(errno));
+            break;
+        }
+        workers->started++;
+    }
+
+    workers->active = (count < workers->started) ? count : workers->started;
+    if (0 == workers->active)
+        status = BVIEW_STATUS_FAILURE;
+
+    /* parked workers may have to pick up queued requests */
+    pthread_cond_broadcast(&workers->cond);
+    pthread_mutex_unlock(&workers->mutex);
+
+    _REST_LOG(_REST_DEBUG_INFO, "REST : %d workers handle the requests \n", workers->active);
+
+    return status;
+}
+
+/******************************************************************
+ * @brief  sets up the workers parsing and dispatching the requests
+ *
+ * @param[in]   rest      REST context for operation
+ *
+ * @retval   BVIEW_STATUS_SUCCESS on successful initialization
+ *
+ * @note     The number of workers is the configured one
+ *********************************************************************/
+BVIEW_STATUS rest_workers_init(REST_CONTEXT_t *rest)
+{
+    REST_WORKERS_t *workers = &rest->workers;
+
+    memset(workers, 0, sizeof (REST_WORKERS_t));
+    pthread_mutex_init(&workers->mutex, NULL);
+    pthread_cond_init(&workers->cond, NULL);
+
+    return rest_workers_resize(rest, rest->config.workers);
+}
+
+/******************************************************************
+ * @brief  queues a framed request for the workers
+ *
+ * @param[in]   rest       REST context for operation
+ * @param[in]   session    busy session holding the request
+ *
+ * @note     A session has one request handled at a time, the queue
+ *           holds as many as there are sessions and never overflows.
+ *********************************************************************/
+void rest_workers_post(REST_CONTEXT_t *rest, REST_SESSION_t *session)
+{
+    REST_WORKERS_t *workers = &rest->workers;
+
+    session->queuedAt = rest_time_usec();
+
+    pthread_mutex_lock(&workers->mutex);
+
+    workers->queue[(workers->head + workers->count) % REST_MAX_SESSIONS] = session;
+    workers->count++;
+    if (workers->count > workers->countMax)
+        workers->countMax = workers->count;
+
+    /* every waiting worker looks, parked ones would swallow a signal */
+    pthread_cond_broadcast(&workers->cond);
+    pthread_mutex_unlock(&workers->mutex);
+}
+
+/******************************************************************
+ * @brief  gets the depths of the stages a request goes through
+ *
+ * @param[in]   rest       REST context for operation
+ * @param[out]  stats      depths and counters
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ *
+ * @note     The depths are taken one after the other, not at once
+ *********************************************************************/
+BVIEW_STATUS rest_workers_stats(REST_CONTEXT_t *rest, REST_QUEUE_STATS_t *stats)
+{
+    REST_WORKERS_t *workers = &rest->workers;
+    int i, busy = 0, pipelined = 0;
+
+    memset(stats, 0, sizeof (REST_QUEUE_STATS_t));
+
+    pthread_mutex_lock(&rest->session_mutex);
+    for (i = 0; i < REST_MAX_SESSIONS; i++)
+    {
+        if (false == rest->sessions[i].inUse)
+            continue;
+
+        stats->connections++;
+        if (true == rest->sessions[i].busy)
+            busy++;
+        if (0 != rest->sessions[i].inputLength)
+            pipelined++;
+    }
+    pthread_mutex_unlock(&rest->session_mutex);
+
+    pthread_mutex_lock(&workers->mutex);
+    stats->workers = workers->active;
+    stats->queued = workers->count;
+    stats->queuedMax = workers->countMax;
+    stats->dispatching = workers->dispatching;
+    stats->requests = workers->requests;
+    stats->waitTotal = workers->waitTotal;
+    stats->waitMax = workers->waitMax;
+    pthread_mutex_unlock(&workers->mutex);
+
+    stats->buffered = pipelined;
+    stats->pending = busy - stats->queued - stats->dispatching;
+    if (stats->pending < 0)
+        stats->pending = 0;
+
+    return BVIEW_STATUS_SUCCESS;
+}
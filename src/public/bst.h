@@ -42,150 +42,297 @@ typedef struct _bst_device_
     uint64_t bufferCount;
 } BVIEW_BST_DEVICE_DATA_t;
 
+/* Buffer Count for one (Ingress Port, Priority Group) */
+typedef struct _ippg_data_
+{
+    uint64_t umShareBufferCount;
+    uint64_t umHeadroomBufferCount;
+} BVIEW_BST_INGRESS_PORT_PG_ENTRY_t;
+
 /* Buffer Count for Ingress Port + Priority Groups */
 typedef struct _bst_i_p_pg_
 {
-
-    struct _ippg_data_
-    {
-        uint64_t umShareBufferCount;
-        uint64_t umHeadroomBufferCount;
-    } data[BVIEW_ASIC_MAX_PORTS][BVIEW_ASIC_MAX_PRIORITY_GROUPS];
+    BVIEW_BST_INGRESS_PORT_PG_ENTRY_t data[BVIEW_ASIC_MAX_PORTS][BVIEW_ASIC_MAX_PRIORITY_GROUPS];
 
 } BVIEW_BST_INGRESS_PORT_PG_DATA_t;
 
+/* Buffer Count for one (Ingress Port, Service Pool) */
+typedef struct _ipsp_data_
+{
+    uint64_t umShareBufferCount;
+} BVIEW_BST_INGRESS_PORT_SP_ENTRY_t;
+
 /* Buffer Count for Ingress Port + Service Pools */
 typedef struct _bst_i_p_sp_
 {
-
-    struct _ipsp_data_
-    {
-        uint64_t umShareBufferCount;
-    } data[BVIEW_ASIC_MAX_PORTS][BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS];
+    BVIEW_BST_INGRESS_PORT_SP_ENTRY_t data[BVIEW_ASIC_MAX_PORTS][BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS];
 
 } BVIEW_BST_INGRESS_PORT_SP_DATA_t;
 
+/* Buffer Count for one Ingress Service Pool */
+typedef struct _isp_data_
+{
+    uint64_t umShareBufferCount;
+} BVIEW_BST_INGRESS_SP_ENTRY_t;
+
 /* Buffer Count for Ingress Service Pools */
 typedef struct _bst_i_sp_
 {
-
-    struct _isp_data_
-    {
-        uint64_t umShareBufferCount;
-    } data[BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS];
+    BVIEW_BST_INGRESS_SP_ENTRY_t data[BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS];
 
 } BVIEW_BST_INGRESS_SP_DATA_t;
 
+/* Buffer Count for one (Egress Port, Service Pool) */
+typedef struct _epsp_data_
+{
+    uint64_t ucShareBufferCount;
+    uint64_t umShareBufferCount;
+    uint64_t mcShareBufferCount;
+    uint64_t mcShareQueueEntries;
+} BVIEW_BST_EGRESS_PORT_SP_ENTRY_t;
+
 /* Buffer Count for Egress Port + Service Pools */
 typedef struct _bst_e_p_sp_
 {
-
-    struct _epsp_data_
-    {
-        uint64_t ucShareBufferCount;
-        uint64_t umShareBufferCount;
-        uint64_t mcShareBufferCount;
-        uint64_t mcShareQueueEntries;
-    } data[BVIEW_ASIC_MAX_PORTS][BVIEW_ASIC_MAX_SERVICE_POOLS];
+    BVIEW_BST_EGRESS_PORT_SP_ENTRY_t data[BVIEW_ASIC_MAX_PORTS][BVIEW_ASIC_MAX_SERVICE_POOLS];
 
 } BVIEW_BST_EGRESS_PORT_SP_DATA_t;
 
+/* Buffer Count for one Egress Service Pool */
+typedef struct _esp_data_
+{
+    uint64_t umShareBufferCount;
+    uint64_t mcShareBufferCount;
+    uint64_t mcShareQueueEntries;
+} BVIEW_BST_EGRESS_SP_ENTRY_t;
+
 /* Buffer Count for Egress Service Pools */
 typedef struct _bst_e_sp_
 {
-
-    struct _esp_data_
-    {
-        uint64_t umShareBufferCount;
-        uint64_t mcShareBufferCount;
-        uint64_t mcShareQueueEntries;
-    } data[BVIEW_ASIC_MAX_SERVICE_POOLS];
+    BVIEW_BST_EGRESS_SP_ENTRY_t data[BVIEW_ASIC_MAX_SERVICE_POOLS];
 
 } BVIEW_BST_EGRESS_SP_DATA_t;
 
+/* Buffer Count for one Egress Unicast Queue */
+typedef struct _eucq_data_
+{
+    uint64_t ucBufferCount;
+    uint64_t port; /* to indicate the port number using this queue */
+} BVIEW_BST_EGRESS_UC_QUEUE_ENTRY_t;
+
 /* Buffer Count for Egress Unicast Queues */
 typedef struct _bst_e_ucq_
 {
-
-    struct _eucq_data_
-    {
-        uint64_t ucBufferCount;
-        uint64_t port; /* to indicate the port number using this queue */
-    } data[BVIEW_ASIC_MAX_UC_QUEUES];
+    BVIEW_BST_EGRESS_UC_QUEUE_ENTRY_t data[BVIEW_ASIC_MAX_UC_QUEUES];
 
 } BVIEW_BST_EGRESS_UC_QUEUE_DATA_t;
 
+/* Buffer Count for one Egress Unicast Queue Group */
+typedef struct _eucqg_data_
+{
+    uint64_t ucBufferCount;
+} BVIEW_BST_EGRESS_UC_QUEUEGROUPS_ENTRY_t;
+
 /* Buffer Count for Egress Unicast Queue Groups */
 typedef struct _bst_e_ucqg_
 {
-
-    struct _eucqg_data_
-    {
-        uint64_t ucBufferCount;
-    } data[BVIEW_ASIC_MAX_UC_QUEUE_GROUPS];
+    BVIEW_BST_EGRESS_UC_QUEUEGROUPS_ENTRY_t data[BVIEW_ASIC_MAX_UC_QUEUE_GROUPS];
 
 } BVIEW_BST_EGRESS_UC_QUEUEGROUPS_DATA_t;
 
+/* Buffer Count for one Egress Multicast Queue */
+typedef struct _emcq_data_
+{
+    uint64_t mcBufferCount;
+    uint64_t mcQueueEntries;
+    uint64_t port; /* to indicate the port number using this queue */
+} BVIEW_BST_EGRESS_MC_QUEUE_ENTRY_t;
+
 /* Buffer Count for Egress Multicast Queues */
 typedef struct _bst_e_mcq_
 {
-
-    struct _emcq_data_
-    {
-        uint64_t mcBufferCount;
-        uint64_t mcQueueEntries;
-        uint64_t port; /* to indicate the port number using this queue */
-    } data[BVIEW_ASIC_MAX_MC_QUEUES];
+    BVIEW_BST_EGRESS_MC_QUEUE_ENTRY_t data[BVIEW_ASIC_MAX_MC_QUEUES];
 
 } BVIEW_BST_EGRESS_MC_QUEUE_DATA_t;
 
+/* Buffer Count for one CPU Queue */
+typedef struct _cpuq_data_
+{
+    uint64_t cpuBufferCount;
+    uint64_t cpuQueueEntries;
+} BVIEW_BST_EGRESS_CPU_QUEUE_ENTRY_t;
+
 /* Buffer Count for CPU Queues */
 typedef struct _bst_cpu_q_
 {
-
-    struct _cpuq_data_
-    {
-        uint64_t cpuBufferCount;
-        uint64_t cpuQueueEntries;
-    } data[BVIEW_ASIC_MAX_CPU_QUEUES];
+    BVIEW_BST_EGRESS_CPU_QUEUE_ENTRY_t data[BVIEW_ASIC_MAX_CPU_QUEUES];
 
 } BVIEW_BST_EGRESS_CPU_QUEUE_DATA_t;
 
+/* Buffer Count for one RQE Queue */
+typedef struct _rqeq_data_
+{
+    uint64_t rqeBufferCount;
+    uint64_t rqeQueueEntries;
+} BVIEW_BST_EGRESS_RQE_QUEUE_ENTRY_t;
+
 /* Buffer Count for RQE Queues */
 typedef struct _bst_rqe_q_
 {
-
-    struct _rqeq_data_
-    {
-        uint64_t rqeBufferCount;
-        uint64_t rqeQueueEntries;
-    } data[BVIEW_ASIC_MAX_RQE_QUEUES];
+    BVIEW_BST_EGRESS_RQE_QUEUE_ENTRY_t data[BVIEW_ASIC_MAX_RQE_QUEUES];
 
 } BVIEW_BST_EGRESS_RQE_QUEUE_DATA_t;
 
+/* Alignment of every realm inside a snapshot (one cache line) */
+#define BVIEW_BST_SNAPSHOT_ALIGN        64
+
+/* Realms of a snapshot, in the order they are laid out in memory */
+typedef enum _bst_snapshot_realm_
+{
+    BVIEW_BST_SNAPSHOT_DEVICE = 0,
+    BVIEW_BST_SNAPSHOT_IPPG,
+    BVIEW_BST_SNAPSHOT_IPSP,
+    BVIEW_BST_SNAPSHOT_ISP,
+    BVIEW_BST_SNAPSHOT_EPSP,
+    BVIEW_BST_SNAPSHOT_ESP,
+    BVIEW_BST_SNAPSHOT_EUCQ,
+    BVIEW_BST_SNAPSHOT_EUCQG,
+    BVIEW_BST_SNAPSHOT_EMCQ,
+    BVIEW_BST_SNAPSHOT_CPUQ,
+    BVIEW_BST_SNAPSHOT_RQEQ,
+    BVIEW_BST_SNAPSHOT_REALM_MAX
+} BVIEW_BST_SNAPSHOT_REALM_t;
+
+/* Memory layout of a snapshot, derived from the asic capabilities.
+ * Every realm is a packed array of its entry type, starting on a
+ * cache line boundary. Port indexed realms are stored port major.
+ */
+typedef struct _bst_snapshot_layout_
+{
+    /* dimensions, as reported by the asic */
+    unsigned int numPorts;
+    unsigned int numPriorityGroups;
+    unsigned int numIngressServicePools;
+    unsigned int numServicePools;
+    unsigned int numUnicastQueues;
+    unsigned int numUnicastQueueGroups;
+    unsigned int numMulticastQueues;
+    unsigned int numCpuQueues;
+    unsigned int numRqeQueues;
+
+    /* number of entries in each realm */
+    unsigned int entries[BVIEW_BST_SNAPSHOT_REALM_MAX];
+    /* size of one entry of each realm */
+    size_t entrySize[BVIEW_BST_SNAPSHOT_REALM_MAX];
+    /* byte offset of each realm from the start of the snapshot */
+    size_t offset[BVIEW_BST_SNAPSHOT_REALM_MAX];
+    /* total size of the snapshot in bytes */
+    size_t size;
+} BVIEW_BST_SNAPSHOT_LAYOUT_t;
+
 /* A Complete Data set for a 'snapshot' */
 
 typedef struct _bst_asic_data_snapshot_
 {
-    /* Device Section */
-    BVIEW_BST_DEVICE_DATA_t device;
+    /* layout the data below is organized in */
+    const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout;
 
-    /* Ingress Section */
-    BVIEW_BST_INGRESS_PORT_PG_DATA_t iPortPg;
-    BVIEW_BST_INGRESS_PORT_SP_DATA_t iPortSp;
-    BVIEW_BST_INGRESS_SP_DATA_t iSp;
-
-    /* Egress Section */
-    BVIEW_BST_EGRESS_PORT_SP_DATA_t ePortSp;
-    BVIEW_BST_EGRESS_SP_DATA_t eSp;
-    BVIEW_BST_EGRESS_UC_QUEUE_DATA_t eUcQ;
-    BVIEW_BST_EGRESS_UC_QUEUEGROUPS_DATA_t eUcQg;
-    BVIEW_BST_EGRESS_MC_QUEUE_DATA_t eMcQ;
-    BVIEW_BST_EGRESS_CPU_QUEUE_DATA_t cpqQ;
-    BVIEW_BST_EGRESS_RQE_QUEUE_DATA_t rqeQ;
+    /* layout->size bytes, BVIEW_BST_SNAPSHOT_ALIGN aligned */
+    uint8_t *data;
 
 } BVIEW_BST_ASIC_SNAPSHOT_DATA_t;
 
+/* Largest snapshot any supported asic may need, realms padded to a cache line */
+#define _BVIEW_BST_SNAPSHOT_PAD(_size)  \
+        (((_size) + BVIEW_BST_SNAPSHOT_ALIGN - 1) & ~((size_t) BVIEW_BST_SNAPSHOT_ALIGN - 1))
+
+#define BVIEW_BST_SNAPSHOT_MAX_SIZE                                      \
+        (_BVIEW_BST_SNAPSHOT_PAD(sizeof(BVIEW_BST_DEVICE_DATA_t)) +          \
+         _BVIEW_BST_SNAPSHOT_PAD(sizeof(BVIEW_BST_INGRESS_PORT_PG_DATA_t)) + \
+         _BVIEW_BST_SNAPSHOT_PAD(sizeof(BVIEW_BST_INGRESS_PORT_SP_DATA_t)) + \
+         _BVIEW_BST_SNAPSHOT_PAD(sizeof(BVIEW_BST_INGRESS_SP_DATA_t)) +      \
+         _BVIEW_BST_SNAPSHOT_PAD(sizeof(BVIEW_BST_EGRESS_PORT_SP_DATA_t)) +  \
+         _BVIEW_BST_SNAPSHOT_PAD(sizeof(BVIEW_BST_EGRESS_SP_DATA_t)) +       \
+         _BVIEW_BST_SNAPSHOT_PAD(sizeof(BVIEW_BST_EGRESS_UC_QUEUE_DATA_t)) + \
+         _BVIEW_BST_SNAPSHOT_PAD(sizeof(BVIEW_BST_EGRESS_UC_QUEUEGROUPS_DATA_t)) + \
+         _BVIEW_BST_SNAPSHOT_PAD(sizeof(BVIEW_BST_EGRESS_MC_QUEUE_DATA_t)) + \
+         _BVIEW_BST_SNAPSHOT_PAD(sizeof(BVIEW_BST_EGRESS_CPU_QUEUE_DATA_t)) + \
+         _BVIEW_BST_SNAPSHOT_PAD(sizeof(BVIEW_BST_EGRESS_RQE_QUEUE_DATA_t)))
+
+/* Base of a realm inside a snapshot */
+#define BVIEW_BST_SNAPSHOT_REALM(_ss, _realm, _type)  \
+        ((_type *) ((_ss)->data + (_ss)->layout->offset[(_realm)]))
+
+/* Accessors for the entries of a snapshot. Ports and queues are zero based. */
+#define BVIEW_BST_SNAPSHOT_DEVICE_DATA(_ss)  \
+        BVIEW_BST_SNAPSHOT_REALM(_ss, BVIEW_BST_SNAPSHOT_DEVICE, BVIEW_BST_DEVICE_DATA_t)
+
+#define BVIEW_BST_SNAPSHOT_IPPG_DATA(_ss, _port, _pg)                                        \
+        (BVIEW_BST_SNAPSHOT_REALM(_ss, BVIEW_BST_SNAPSHOT_IPPG, BVIEW_BST_INGRESS_PORT_PG_ENTRY_t) + \
+         ((_port) * (_ss)->layout->numPriorityGroups) + (_pg))
+
+#define BVIEW_BST_SNAPSHOT_IPSP_DATA(_ss, _port, _sp)                                        \
+        (BVIEW_BST_SNAPSHOT_REALM(_ss, BVIEW_BST_SNAPSHOT_IPSP, BVIEW_BST_INGRESS_PORT_SP_ENTRY_t) + \
+         ((_port) * (_ss)->layout->numIngressServicePools) + (_sp))
+
+#define BVIEW_BST_SNAPSHOT_ISP_DATA(_ss, _sp)                                                \
+        (BVIEW_BST_SNAPSHOT_REALM(_ss, BVIEW_BST_SNAPSHOT_ISP, BVIEW_BST_INGRESS_SP_ENTRY_t) + (_sp))
+
+#define BVIEW_BST_SNAPSHOT_EPSP_DATA(_ss, _port, _sp)                                        \
+        (BVIEW_BST_SNAPSHOT_REALM(_ss, BVIEW_BST_SNAPSHOT_EPSP, BVIEW_BST_EGRESS_PORT_SP_ENTRY_t) + \
+         ((_port) * (_ss)->layout->numServicePools) + (_sp))
+
+#define BVIEW_BST_SNAPSHOT_ESP_DATA(_ss, _sp)                                                \
+        (BVIEW_BST_SNAPSHOT_REALM(_ss, BVIEW_BST_SNAPSHOT_ESP, BVIEW_BST_EGRESS_SP_ENTRY_t) + (_sp))
+
+#define BVIEW_BST_SNAPSHOT_EUCQ_DATA(_ss, _queue)                                            \
+        (BVIEW_BST_SNAPSHOT_REALM(_ss, BVIEW_BST_SNAPSHOT_EUCQ, BVIEW_BST_EGRESS_UC_QUEUE_ENTRY_t) + (_queue))
+
+#define BVIEW_BST_SNAPSHOT_EUCQG_DATA(_ss, _group)                                           \
+        (BVIEW_BST_SNAPSHOT_REALM(_ss, BVIEW_BST_SNAPSHOT_EUCQG, BVIEW_BST_EGRESS_UC_QUEUEGROUPS_ENTRY_t) + (_group))
+
+#define BVIEW_BST_SNAPSHOT_EMCQ_DATA(_ss, _queue)                                            \
+        (BVIEW_BST_SNAPSHOT_REALM(_ss, BVIEW_BST_SNAPSHOT_EMCQ, BVIEW_BST_EGRESS_MC_QUEUE_ENTRY_t) + (_queue))
+
+#define BVIEW_BST_SNAPSHOT_CPUQ_DATA(_ss, _queue)                                            \
+        (BVIEW_BST_SNAPSHOT_REALM(_ss, BVIEW_BST_SNAPSHOT_CPUQ, BVIEW_BST_EGRESS_CPU_QUEUE_ENTRY_t) + (_queue))
+
+#define BVIEW_BST_SNAPSHOT_RQEQ_DATA(_ss, _queue)                                            \
+        (BVIEW_BST_SNAPSHOT_REALM(_ss, BVIEW_BST_SNAPSHOT_RQEQ, BVIEW_BST_EGRESS_RQE_QUEUE_ENTRY_t) + (_queue))
+
+/* Occupancy histograms are log scaled, with 2^BVIEW_BST_HISTOGRAM_SUB_BITS
+ * buckets per power of two. Values below 2^BVIEW_BST_HISTOGRAM_SUB_BITS
+ * have a bucket each, the last bucket also holds everything above it.
+ */
+#define BVIEW_BST_HISTOGRAM_SUB_BITS    1
+#define BVIEW_BST_HISTOGRAM_BUCKETS     64
+
+/* Lowest value counted in a bucket */
+#define BVIEW_BST_HISTOGRAM_BUCKET_LOW(_bucket)                                          \
+        (((_bucket) < (1U << BVIEW_BST_HISTOGRAM_SUB_BITS)) ? (uint64_t) (_bucket) :     \
+         ((uint64_t) ((1U << BVIEW_BST_HISTOGRAM_SUB_BITS) |                             \
+                      ((_bucket) & ((1U << BVIEW_BST_HISTOGRAM_SUB_BITS) - 1)))          \
+          << (((_bucket) >> BVIEW_BST_HISTOGRAM_SUB_BITS) - 1)))
+
+/* Number of updates of a counter which fell in each bucket */
+typedef struct _bst_histogram_
+{
+    uint32_t count[BVIEW_BST_HISTOGRAM_BUCKETS];
+} BVIEW_BST_HISTOGRAM_t;
+
+/* Occupancy histograms of an asic, one for every 64 bit word of a
+ * snapshot of the layout, i.e. the histogram of a counter is found at
+ * the position of the counter in the snapshot.
+ */
+typedef struct _bst_asic_histogram_data_
+{
+    const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout;
+
+    /* layout->size / sizeof (uint64_t) histograms */
+    BVIEW_BST_HISTOGRAM_t *data;
+
+} BVIEW_BST_ASIC_HISTOGRAM_DATA_t;
+
 /* Statistics collection mode */
 typedef enum _bst_collection_mode_
 {
@@ -241,6 +388,29 @@ typedef struct  _bst_trigger_info_
   int queue;
 } BVIEW_BST_TRIGGER_INFO_t;
 
+/* most entries of each realm a report can be limited to */
+#define BVIEW_BST_REPORT_MAX_TOP_K 1024
+
+/* Entries of a report selected by the agent, all of them when zeroed.
+   The occupancy of an entry is the largest of its buffer counters */
+typedef struct _bst_report_filter_
+{
+  /* least occupancy reported, in the units of the report, 0 for any */
+  uint64_t minValue;
+  /* least occupancy reported, in percent of the max buffer, 0 for any */
+  int minPercentage;
+  /* entries of the highest occupancy reported per realm, 0 for all */
+  int topK;
+  /* ports of the port realms and of the queues reported, if set */
+  bool portRange;
+  int firstPort;
+  int lastPort;
+  /* queues (and queue groups) reported, if set */
+  bool queueRange;
+  int firstQueue;
+  int lastQueue;
+} BVIEW_BST_REPORT_FILTER_t;
+
 
 /* Profile configuration  for Egress Port + Service Pools */
 typedef struct _bst_ep_sp_threshold_
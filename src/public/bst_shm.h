@@ -0,0 +1,109 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_BST_SHM_H
+#define INCLUDE_BST_SHM_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+/* Shared memory region the latest stats snapshot of a unit is published
+ * in, for consumers on the same box. The region holds a header followed
+ * by the snapshot data, laid out as described by the header.
+ *
+ * Only fixed width types are used, so readers built separately from the
+ * agent see the same layout.
+ */
+
+/* Name of the region of a unit, for shm_open() */
+#define BVIEW_BST_SHM_NAME_FORMAT       "/broadview-bst-%d"
+#define BVIEW_BST_SHM_NAME_MAX          32
+
+#define BVIEW_BST_SHM_MAGIC             0x42535453  /* "BSTS" */
+/* bumped whenever the header or the layout descriptor change */
+#define BVIEW_BST_SHM_VERSION           1
+
+/* most realms the layout descriptor can describe */
+#define BVIEW_BST_SHM_MAX_REALMS        16
+
+/* Layout of the snapshot data in the region, see BVIEW_BST_SNAPSHOT_LAYOUT_t.
+ * Realms are described in the order of BVIEW_BST_SNAPSHOT_REALM_t.
+ */
+typedef struct _bst_shm_layout_
+{
+    uint32_t numPorts;
+    uint32_t numPriorityGroups;
+    uint32_t numIngressServicePools;
+    uint32_t numServicePools;
+    uint32_t numUnicastQueues;
+    uint32_t numUnicastQueueGroups;
+    uint32_t numMulticastQueues;
+    uint32_t numCpuQueues;
+    uint32_t numRqeQueues;
+
+    /* number of realms described below */
+    uint32_t realms;
+    uint32_t entries[BVIEW_BST_SHM_MAX_REALMS];
+    uint32_t entrySize[BVIEW_BST_SHM_MAX_REALMS];
+    uint64_t offset[BVIEW_BST_SHM_MAX_REALMS];
+
+    /* size of the snapshot data in bytes */
+    uint64_t size;
+} BVIEW_BST_SHM_LAYOUT_t;
+
+/* Header at the start of the region.
+ *
+ * Everything up to 'seq' is written once, before the region is made
+ * visible. The rest is protected by 'seq', which is odd while the
+ * publisher updates the data. A reader copies what it needs between
+ * two reads of an even, unchanged 'seq'.
+ */
+typedef struct _bst_shm_header_
+{
+    uint32_t magic;
+    uint32_t version;
+    /* size of this header, data follows at dataOffset */
+    uint32_t headerSize;
+    /* unit the region belongs to */
+    uint32_t unit;
+    uint64_t dataOffset;
+
+    BVIEW_BST_SHM_LAYOUT_t layout;
+
+    /* seqlock of the fields below and of the data, on its own cache line */
+    uint32_t seq __attribute__ ((aligned (64)));
+    uint32_t reserved;
+    /* bumped with every snapshot published, 0 until the first one */
+    uint64_t generation;
+    /* collection time of the snapshot, seconds since the epoch */
+    int64_t time;
+} BVIEW_BST_SHM_HEADER_t;
+
+/* Snapshot data of a region */
+#define BVIEW_BST_SHM_DATA(_header)  \
+        ((uint8_t *) (_header) + (_header)->dataOffset)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BST_SHM_H */
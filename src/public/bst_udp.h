@@ -0,0 +1,104 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_BST_UDP_H
+#define INCLUDE_BST_UDP_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+/* Datagrams the stats of a unit are exported in for high rate sampling,
+ * to a collector which can not afford a REST report per sample.
+ *
+ * A datagram holds a header followed by 'records' records, all of them
+ * of the same realm of the same sample of a unit. A realm of a snapshot
+ * (see BVIEW_BST_SNAPSHOT_LAYOUT_t) is a flat array of 64 bit counters,
+ * a record sets the counter at 'index' of that array to 'value'. The
+ * records of a realm come in the order of their index, so a realm
+ * carrying every counter starts over at index 0.
+ *
+ * A sample normally carries the counters changed since the sample
+ * before. Every few datagrams a sample carries every counter of the
+ * exported realms instead, flagged BVIEW_BST_UDP_FLAG_RESYNC, so that a
+ * collector which lost datagrams or joined late gets back in sync.
+ *
+ * Only fixed width types are used and all fields are in network byte
+ * order, so collectors built separately from the agent, on any host,
+ * see the same layout.
+ */
+
+#define BVIEW_BST_UDP_MAGIC             0x42535455  /* "BSTU" */
+/* bumped whenever the header or the records change */
+#define BVIEW_BST_UDP_VERSION           1
+
+/* the counters of the realm are all there, not only the changed ones */
+#define BVIEW_BST_UDP_FLAG_RESYNC       0x01
+/* last datagram of the realm in the sample */
+#define BVIEW_BST_UDP_FLAG_LAST         0x02
+
+/* Header at the start of every datagram */
+typedef struct _bst_udp_header_
+{
+    uint32_t magic;
+    uint8_t version;
+    uint8_t flags;
+    /* realm of the records, see BVIEW_BST_SNAPSHOT_REALM_t */
+    uint8_t realm;
+    /* unit the stats are of */
+    uint8_t unit;
+    /* bumped with every datagram of the unit, a gap is a lost datagram */
+    uint32_t sequence;
+    /* bumped with every sample of the unit */
+    uint32_t snapshot;
+    /* collection time of the sample, micro seconds since the epoch */
+    uint64_t timestamp;
+    /* number of counters of the realm */
+    uint32_t counters;
+    /* number of records following the header */
+    uint16_t records;
+    uint16_t reserved;
+} BVIEW_BST_UDP_HEADER_t;
+
+/* A counter of the realm and its value */
+typedef struct _bst_udp_record_
+{
+    uint32_t index;
+    uint64_t value;
+} __attribute__ ((packed)) BVIEW_BST_UDP_RECORD_t;
+
+/* Records of a datagram */
+#define BVIEW_BST_UDP_RECORDS(_header)  \
+        ((BVIEW_BST_UDP_RECORD_t *) ((uint8_t *) (_header) + sizeof (BVIEW_BST_UDP_HEADER_t)))
+
+/* room the IPv4 and UDP headers take of the mtu */
+#define BVIEW_BST_UDP_OVERHEAD          28
+
+/* most records a datagram carries for an mtu */
+#define BVIEW_BST_UDP_MAX_RECORDS(_mtu)  \
+        (((_mtu) - BVIEW_BST_UDP_OVERHEAD - sizeof (BVIEW_BST_UDP_HEADER_t)) / \
+         sizeof (BVIEW_BST_UDP_RECORD_t))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BST_UDP_H */
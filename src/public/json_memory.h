@@ -0,0 +1,164 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_JSON_MEMORY_H
+#define INCLUDE_JSON_MEMORY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+#include "broadview.h"
+
+/* Buffers for the JSON encoders of the applications. A pool has a few
+ * size classes, a request gets a buffer of the smallest class it fits in.
+ * The buffers are taken from the system when they are needed the first
+ * time, up to the cap of their class, and kept in the pool once freed.
+ * Every thread keeps the last buffer it freed of each class, so that a
+ * thread which encodes one document after the other does not take any
+ * lock. A class at its cap takes these back from the other threads
+ * before it fails.
+ */
+
+/* pools which may be created, one per application */
+#define JSON_MEMORY_MAX_POOLS                4
+
+/* size classes of a pool */
+#define JSON_MEMORY_MAX_CLASSES              4
+
+/* length of the name of a pool, for the dumps */
+#define JSON_MEMORY_MAX_NAME_LENGTH          32
+
+/* size class of a pool */
+typedef struct _json_memory_class_config_
+{
+  /* size of the buffers */
+  unsigned int size;
+  /* buffers which may be taken from the system, at most */
+  unsigned int maxBuffers;
+} JSON_MEMORY_CLASS_CONFIG_t;
+
+/* counters of a size class */
+typedef struct _json_memory_stats_
+{
+  unsigned int size;
+  unsigned int maxBuffers;
+  /* buffers taken from the system so far */
+  unsigned int numBuffers;
+  /* buffers handed out, and the most handed out at a time */
+  unsigned int inUse;
+  unsigned int highWatermark;
+  uint64_t allocations;
+  /* requests which found the class at its cap */
+  uint64_t failures;
+  /* mean time between allocation and free of a buffer */
+  uint64_t avgHoldTimeUsec;
+} JSON_MEMORY_STATS_t;
+
+/*********************************************************************
+* @brief        Creates a pool of buffers
+*
+* @param[in]    name        name of the pool
+* @param[in]    classes     size classes, in increasing size
+* @param[in]    numClasses  number of size classes
+* @param[out]   poolId      pool to allocate from
+*
+* @retval       BVIEW_STATUS_SUCCESS  pool is created, or existed already
+* @retval       BVIEW_STATUS_INVALID_PARAMETER  invalid input parameter
+* @retval       BVIEW_STATUS_TABLE_FULL  JSON_MEMORY_MAX_POOLS are created
+*
+* @note         A pool of the same name is not created again, its id is
+*               returned. No buffer is taken from the system here.
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS json_memory_pool_create(const char *name,
+                                     const JSON_MEMORY_CLASS_CONFIG_t *classes,
+                                     int numClasses, int *poolId);
+
+/*********************************************************************
+* @brief        Allocates a buffer from a pool
+*
+* @param[in]    poolId      pool to allocate from
+* @param[in]    size        size needed
+* @param[out]   buffer      the buffer
+*
+* @retval       BVIEW_STATUS_SUCCESS  buffer is allocated
+* @retval       BVIEW_STATUS_OUTOFMEMORY  the class is at its cap, or the
+*                                         system is out of memory
+* @retval       BVIEW_STATUS_INVALID_PARAMETER  invalid input parameter,
+*                                               or no class is large enough
+*
+* @note         The buffer is not cleared. It must be returned with
+*               json_memory_free().
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS json_memory_allocate(int poolId, unsigned int size, uint8_t **buffer);
+
+/*********************************************************************
+* @brief        Returns a buffer to its pool
+*
+* @param[in]    buffer      buffer from json_memory_allocate()
+*
+* @retval       BVIEW_STATUS_SUCCESS  buffer is returned
+* @retval       BVIEW_STATUS_INVALID_PARAMETER  invalid input parameter
+* @retval       BVIEW_STATUS_INVALID_MEMORY  the buffer is not from a pool,
+*                                            or is freed already
+*
+* @note         Any thread may return the buffer.
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS json_memory_free(uint8_t *buffer);
+
+/*********************************************************************
+* @brief        Gets the counters of a size class of a pool
+*
+* @param[in]    poolId      pool
+* @param[in]    size        size the class is looked up for, as with
+*                           json_memory_allocate()
+* @param[out]   stats       counters of the class
+*
+* @retval       BVIEW_STATUS_SUCCESS  counters are filled in
+* @retval       BVIEW_STATUS_INVALID_PARAMETER  invalid input parameter
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS json_memory_stats_get(int poolId, unsigned int size,
+                                   JSON_MEMORY_STATS_t *stats);
+
+/*********************************************************************
+* @brief        Prints the counters of all classes of a pool
+*
+* @param[in]    poolId      pool
+*
+* @retval       NA
+*
+* @end
+*********************************************************************/
+void json_memory_dump(int poolId);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JSON_MEMORY_H */
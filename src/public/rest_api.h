@@ -24,17 +24,103 @@ extern "C"
 {
 #endif
 
+#include <stdbool.h>
+
 #include "broadview.h"
 
+/* Encodings a report may be sent in */
+typedef enum _bview_rest_format_
+{
+    /* as the client accepts, JSON unless it asks for CBOR */
+    BVIEW_REST_FORMAT_DEFAULT = 0,
+    BVIEW_REST_FORMAT_JSON,
+    BVIEW_REST_FORMAT_CBOR,
+    BVIEW_REST_FORMAT_MAX
+} BVIEW_REST_FORMAT_t;
+
+/* names of the formats in the requests and the configuration */
+#define BVIEW_REST_FORMAT_NAME_JSON     "json"
+#define BVIEW_REST_FORMAT_NAME_CBOR     "cbor"
+
+/* Content encodings a response may be compressed with */
+typedef enum _bview_rest_encoding_
+{
+    BVIEW_REST_ENCODING_IDENTITY = 0,
+    BVIEW_REST_ENCODING_GZIP,
+    BVIEW_REST_ENCODING_DEFLATE,
+    BVIEW_REST_ENCODING_MAX
+} BVIEW_REST_ENCODING_t;
+
+/* names of the encodings in HTTP and the configuration */
+#define BVIEW_REST_ENCODING_NAME_IDENTITY   "identity"
+#define BVIEW_REST_ENCODING_NAME_GZIP       "gzip"
+#define BVIEW_REST_ENCODING_NAME_DEFLATE    "deflate"
+
+/* collectors the asynchronous reports may be sent to, besides the
+   configured one. A report goes to the subscribers named by the bits
+   of a mask, bit n for subscriber n. */
+#define BVIEW_REST_MAX_SUBSCRIBERS      8
+
+/* An asynchronous report of a kind takes the place of the one of the
+ * same kind still queued for its collector, which it supersedes. The
+ * kinds are the applications' own, a report of no kind is never
+ * replaced.
+ */
+#define BVIEW_REST_REPORT_KIND_NONE     0
+
+/* clients the events may be streamed to at the same time */
+#define BVIEW_REST_MAX_EVENT_STREAMS    16
+
+/* A response sent while it is produced, as the chunks of a HTTP/1.1
+ * chunked message. Nothing is sent before the first chunk, so that a
+ * response failing early can still be answered with an error.
+ */
+typedef struct _bview_rest_stream_
+{
+    /* session of the request, NULL for an asynchronous report */
+    void *cookie;
+    /* socket the chunks go to, -1 when they are dropped */
+    int fd;
+    /* is the header sent ? */
+    bool started;
+    /* encoding of the response */
+    BVIEW_REST_FORMAT_t format;
+    /* compression of the response, decided with the first chunk */
+    BVIEW_REST_ENCODING_t encoding;
+    /* compressor held from the first chunk to the last, if any */
+    void *compressor;
+    /* asynchronous report the chunks are gathered in, queued for the
+       client once complete */
+    void *report;
+    /* subscribers the asynchronous report goes to, the configured
+       collector if none */
+    unsigned int subscribers;
+    /* kind of the asynchronous report */
+    unsigned int kind;
+} BVIEW_REST_STREAM_t;
+
 /* Initialize REST component */
 BVIEW_STATUS rest_init(void);
 
 /* API to send the response buffer back to client. 
  * This function adds HTTP header and sends it to 
- * client 
+ * client. A response of the configured minimum size or more is
+ * compressed if the client accepts it, or for an asynchronous
+ * report, if the configuration asks for it.
  */
 BVIEW_STATUS rest_response_send(void *cookie, char *pBuf, int size);
 
+/* API to send a response buffer in the given format back to client.
+ * The HTTP header carries the content type of the format. 
+ */
+BVIEW_STATUS rest_response_send_format(void *cookie, char *pBuf, int size,
+                                       BVIEW_REST_FORMAT_t format);
+
+/* API to get the format the client asked for with the Accept header of
+ * its request, BVIEW_REST_FORMAT_JSON unless it accepts CBOR.
+ */
+BVIEW_STATUS rest_response_format_get(void *cookie, BVIEW_REST_FORMAT_t *format);
+
 /* API to send the response buffer back to client. 
  * This function adds HTTP header along with JSON error code and 
  * sends it to client 
@@ -49,6 +135,62 @@ BVIEW_STATUS rest_response_send_error(void *cookie, BVIEW_STATUS rv, int id);
 
 BVIEW_STATUS rest_response_send_ok (void *cookie);
 
+/* API to start a response which is sent in chunks. The cookie
+ * is the one of rest_response_send(). The stream has to be closed
+ * with rest_response_stream_close(), even if this fails.
+ */
+BVIEW_STATUS rest_response_stream_open(void *cookie, BVIEW_REST_FORMAT_t format,
+                                       BVIEW_REST_STREAM_t *stream);
+
+/* API to send the next chunk of a response */
+BVIEW_STATUS rest_response_stream_send(BVIEW_REST_STREAM_t *stream, const char *pBuf, int size);
+
+/* API to send an asynchronous report of a kind to the subscribers of
+ * the mask, once for all of them. The configured collector gets it if
+ * the mask is 0, as with rest_response_send_format() and a NULL cookie.
+ */
+BVIEW_STATUS rest_report_send(unsigned int subscribers, unsigned int kind,
+                              char *pBuf, int size, BVIEW_REST_FORMAT_t format);
+
+/* API to start an asynchronous report of a kind, sent in chunks, for
+ * the subscribers of the mask. It goes on with rest_response_stream_send()
+ * and rest_response_stream_close().
+ */
+BVIEW_STATUS rest_report_stream_open(unsigned int subscribers, unsigned int kind,
+                                     BVIEW_REST_FORMAT_t format,
+                                     BVIEW_REST_STREAM_t *stream);
+
+/* API to set the collector the reports of a subscriber go to. An
+ * empty ip removes it, its queued reports are dropped.
+ */
+BVIEW_STATUS rest_subscriber_set(int subscriber, const char *ip, int port);
+
+/* API to turn the connection of a request into a stream of
+ * server-sent events (text/event-stream). The client gets the events
+ * sent for the filter, which the application makes of what the client
+ * asked for, till it closes the connection. A stream which is not
+ * started is left to the caller to answer with an error.
+ */
+BVIEW_STATUS rest_event_stream_start(void *cookie, unsigned int filter);
+
+/* API to get the filters of the open event streams, each once, so that
+ * an event is made once for each of them. Returns their number.
+ */
+int rest_event_filters_get(unsigned int *filters, int max);
+
+/* API to send an event to the streams of the filter. It is queued and
+ * the call does not wait for the clients; a stream which does not keep
+ * up loses its oldest events.
+ */
+BVIEW_STATUS rest_event_send(unsigned int filter, const char *name,
+                             const char *pBuf, int size);
+
+/* API to end a response sent in chunks. A failed response which has
+ * not sent anything yet is answered with the JSON error code, one
+ * which has is cut short.
+ */
+BVIEW_STATUS rest_response_stream_close(BVIEW_REST_STREAM_t *stream, BVIEW_STATUS rv, int id);
+
 #ifdef	__cplusplus
 }
 #endif
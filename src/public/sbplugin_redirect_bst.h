@@ -96,6 +96,121 @@ BVIEW_STATUS  sbapi_bst_config_set(int asic, BVIEW_BST_CONFIG_t *config);
 *********************************************************************/
 BVIEW_STATUS  sbapi_bst_snapshot_get(int asic, BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot, BVIEW_TIME_t *time);
 
+/*****************************************************************//**
+* @brief       Bring a BST snapshot up to date
+*
+* @param[in]     asic                  Unit number
+* @param[in,out] snapshot              BST snapshot
+* @param[out]    time                  Time
+* @param[in,out] generation            Generation the snapshot is at,
+*                                      0 if it holds no data
+*
+* @retval   BVIEW_STATUS_FAILURE      Due to lock acquistion failure or 
+*                                     Not able to get asic type of this unit or
+*                                     BST feature is not present or
+*                                     BST south bound function has returned failure
+*
+* @retval   BVIEW_STATUS_SUCCESS      BST snapshot get is successful 
+*
+* @retval   BVIEW_STATUS_UNSUPPORTED  BST incremental snapshot get functionality
+*                                     is not supported on this unit
+*
+*********************************************************************/
+BVIEW_STATUS  sbapi_bst_snapshot_incremental_get(int asic, BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot, BVIEW_TIME_t *time, uint64_t *generation);
+
+/*****************************************************************//**
+* @brief       Start publishing report ready BST snapshots
+*
+* @param[in]     asic                  Unit number
+* @param[in]     layout                Layout of the published snapshots
+*
+* @retval   BVIEW_STATUS_FAILURE      Due to lock acquistion failure or 
+*                                     Not able to get asic type of this unit or
+*                                     BST feature is not present or
+*                                     BST south bound function has returned failure
+*
+* @retval   BVIEW_STATUS_SUCCESS      BST snapshot publication is started 
+*
+* @retval   BVIEW_STATUS_UNSUPPORTED  BST snapshot publication functionality
+*                                     is not supported on this unit
+*
+* @notes    The south bound plugin publishes a snapshot in this layout
+*           at the end of every batch of counter updates.
+*
+*********************************************************************/
+BVIEW_STATUS  sbapi_bst_snapshot_publish_start(int asic, const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout);
+
+/*****************************************************************//**
+* @brief       Take a reference to the latest published BST snapshot
+*
+* @param[in]     asic                  Unit number
+* @param[out]    snapshot              Published snapshot
+* @param[out]    time                  Time of the snapshot
+*
+* @retval   BVIEW_STATUS_FAILURE      Due to lock acquistion failure or 
+*                                     Not able to get asic type of this unit or
+*                                     BST feature is not present or
+*                                     BST south bound function has returned failure
+*
+* @retval   BVIEW_STATUS_SUCCESS      BST published snapshot get is successful 
+*
+* @retval   BVIEW_STATUS_UNSUPPORTED  BST snapshot publication functionality
+*                                     is not supported on this unit
+*
+* @notes    Returns BVIEW_STATUS_NOTREADY until the first snapshot is
+*           published. The snapshot must be released with
+*           sbapi_bst_snapshot_published_put().
+*
+*********************************************************************/
+BVIEW_STATUS  sbapi_bst_snapshot_published_get(int asic, const BVIEW_BST_ASIC_SNAPSHOT_DATA_t **snapshot, BVIEW_TIME_t *time);
+
+/*****************************************************************//**
+* @brief       Release a published BST snapshot
+*
+* @param[in]     asic                  Unit number
+* @param[in]     snapshot              Snapshot from sbapi_bst_snapshot_published_get()
+*
+* @retval   BVIEW_STATUS_FAILURE      Due to lock acquistion failure or 
+*                                     Not able to get asic type of this unit or
+*                                     BST feature is not present or
+*                                     BST south bound function has returned failure
+*
+* @retval   BVIEW_STATUS_SUCCESS      BST published snapshot is released 
+*
+* @retval   BVIEW_STATUS_UNSUPPORTED  BST snapshot publication functionality
+*                                     is not supported on this unit
+*
+* @notes    none
+*
+*********************************************************************/
+BVIEW_STATUS  sbapi_bst_snapshot_published_put(int asic, const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot);
+
+/*****************************************************************//**
+* @brief       Obtain the BST occupancy histograms
+*
+* @param[in]     asic                  Unit number
+* @param[out]    histogram             Histograms of the counters, NULL
+*                                      if they are only to be restarted
+* @param[out]    time                  Time the histograms started at
+* @param[in]     reset                 Start new histograms once read
+*
+* @retval   BVIEW_STATUS_FAILURE      Due to lock acquistion failure or 
+*                                     Not able to get asic type of this unit or
+*                                     BST feature is not present or
+*                                     BST south bound function has returned failure
+*
+* @retval   BVIEW_STATUS_SUCCESS      BST histogram get is successful 
+*
+* @retval   BVIEW_STATUS_UNSUPPORTED  BST histogram functionality
+*                                     is not supported on this unit
+*
+* @notes    The south bound plugin accounts every counter update in the
+*           histograms, starting with sbapi_bst_snapshot_publish_start().
+*           The histograms are in the layout given there.
+*
+*********************************************************************/
+BVIEW_STATUS  sbapi_bst_histogram_get(int asic, BVIEW_BST_ASIC_HISTOGRAM_DATA_t *histogram, BVIEW_TIME_t *time, bool reset);
+
 /*****************************************************************//**
 * @brief  Obtain Device Statistics
 *
@@ -57,6 +57,7 @@ typedef struct __bview_main_thread_params
 #define BVIEW_MACADDR_LEN  6
 #define BVIEW_SYSTEM_TIME_CONVERSION_FACTOR 1000
 #define BVIEW_MAX_IP_ADDR_LENGTH 20
+#define BVIEW_MAX_ENCODING_NAME_LENGTH 16
 
 
 /* file from where the configuration properties are read. */
@@ -71,6 +72,26 @@ typedef struct __bview_main_thread_params
 #define SYSTEM_CONFIG_PROPERTY_LOCAL_PORT "agent_port"
 #define SYSTEM_CONFIG_PROPERTY_LOCAL_PORT_DEFAULT 8080
 
+/* zlib level the responses are compressed at, 0 to not compress */
+#define SYSTEM_CONFIG_PROPERTY_COMPRESSION_LEVEL "compression_level"
+#define SYSTEM_CONFIG_PROPERTY_COMPRESSION_LEVEL_DEFAULT 6
+
+/* responses smaller than this many bytes are not compressed */
+#define SYSTEM_CONFIG_PROPERTY_COMPRESSION_MIN_SIZE "compression_min_size"
+#define SYSTEM_CONFIG_PROPERTY_COMPRESSION_MIN_SIZE_DEFAULT 1024
+
+/* content encoding of the asynchronous reports, identity, gzip or deflate */
+#define SYSTEM_CONFIG_PROPERTY_ASYNC_ENCODING "async_content_encoding"
+#define SYSTEM_CONFIG_PROPERTY_ASYNC_ENCODING_DEFAULT "identity"
+
+/* threads parsing and dispatching the REST requests */
+#define SYSTEM_CONFIG_PROPERTY_REST_WORKERS "rest_workers"
+#define SYSTEM_CONFIG_PROPERTY_REST_WORKERS_DEFAULT 4
+
+/* publish the latest BST stats of every unit in shared memory */
+#define SYSTEM_CONFIG_PROPERTY_BST_SHM_PUBLISH "bst_shm_publish"
+#define SYSTEM_CONFIG_PROPERTY_BST_SHM_PUBLISH_DEFAULT false
+
 
 #define SYSTEM_TCP_MIN_PORT   1
 #define SYSTEM_TCP_MAX_PORT   65535
@@ -83,6 +104,16 @@ typedef struct _system_agent_config_
   int clientPort;
 
   int localPort;
+
+  int compressionLevel;
+
+  int compressionMinSize;
+
+  char asyncEncoding[BVIEW_MAX_ENCODING_NAME_LENGTH];
+
+  int restWorkers;
+
+  bool bstShmPublish;
 } BVIEW_SYSTEM_AGENT_CONFIG_t;
 
 
@@ -486,5 +517,106 @@ BVIEW_STATUS system_agent_port_set(int localPort);
 *********************************************************************/
 BVIEW_STATUS system_agent_client_info_set(char *clientIp, int clientPort);
 
+/*********************************************************************
+* @brief      Function used to get the compression of the responses
+*
+*
+* @param[out]  level          zlib level, 0 if not compressed
+* @param[out]  minSize        smallest response compressed, in bytes
+* @param[out]  asyncEncoding  content encoding of the asynchronous
+*                             reports, BVIEW_MAX_ENCODING_NAME_LENGTH
+*                             bytes
+*
+* @retval     BVIEW_STATUS_SUCCESS
+* @retval     BVIEW_STATUS_FAILURE
+*
+* @note          NA
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS system_agent_compression_get(int *level, int *minSize, char *asyncEncoding);
+
+/*********************************************************************
+* @brief      Function used to set the compression of the responses
+*
+*
+* @param[in]   level          zlib level, 0 if not compressed
+* @param[in]   minSize        smallest response compressed, in bytes
+* @param[in]   asyncEncoding  content encoding of the asynchronous
+*                             reports
+*
+* @retval     BVIEW_STATUS_SUCCESS
+* @retval     BVIEW_STATUS_FAILURE
+*
+* @note          NA
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS system_agent_compression_set(int level, int minSize, const char *asyncEncoding);
+
+/*********************************************************************
+* @brief      Function used to get the number of workers handling the
+*             REST requests
+*
+*
+* @param[out]  workers        number of workers
+*
+* @retval     BVIEW_STATUS_SUCCESS
+* @retval     BVIEW_STATUS_FAILURE
+*
+* @note          NA
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS system_agent_rest_workers_get(int *workers);
+
+/*********************************************************************
+* @brief      Function used to set the number of workers handling the
+*             REST requests
+*
+*
+* @param[in]   workers        number of workers
+*
+* @retval     BVIEW_STATUS_SUCCESS
+* @retval     BVIEW_STATUS_FAILURE
+*
+* @note          NA
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS system_agent_rest_workers_set(int workers);
+
+/*********************************************************************
+* @brief      Function used to get whether the BST stats are published
+*             in shared memory
+*
+*
+* @param[out]  publish        true if they are published
+*
+* @retval     BVIEW_STATUS_SUCCESS
+* @retval     BVIEW_STATUS_FAILURE
+*
+* @note          NA
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS system_agent_bst_shm_publish_get(bool *publish);
+
+/*********************************************************************
+* @brief      Function used to set whether the BST stats are published
+*             in shared memory
+*
+*
+* @param[in]   publish        true to publish them
+*
+* @retval     BVIEW_STATUS_SUCCESS
+* @retval     BVIEW_STATUS_FAILURE
+*
+* @note          NA
+*
+* @end
+*********************************************************************/
+BVIEW_STATUS system_agent_bst_shm_publish_set(bool publish);
+
 #endif /* INCLUDE_SYSTEM_H */
 
@@ -42,6 +42,19 @@ typedef struct _bst_sb_feature_
     /** Obtain Complete ASIC Statistics Report */
     BVIEW_STATUS(*bst_snapshot_get_cb)(int asic, BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot, BVIEW_TIME_t *time);
 
+    /** Refresh an ASIC Statistics Report with the rows changed since a generation */
+    BVIEW_STATUS(*bst_snapshot_incremental_get_cb)(int asic, BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot, BVIEW_TIME_t *time, uint64_t *generation);
+
+    /** Start publishing report ready ASIC Statistics snapshots */
+    BVIEW_STATUS(*bst_snapshot_publish_start_cb)(int asic, const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout);
+
+    /** Take/release a reference to the latest published snapshot */
+    BVIEW_STATUS(*bst_snapshot_published_get_cb)(int asic, const BVIEW_BST_ASIC_SNAPSHOT_DATA_t **snapshot, BVIEW_TIME_t *time);
+    BVIEW_STATUS(*bst_snapshot_published_put_cb)(int asic, const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot);
+
+    /** Obtain, and optionally restart, the occupancy histograms */
+    BVIEW_STATUS(*bst_histogram_get_cb)(int asic, BVIEW_BST_ASIC_HISTOGRAM_DATA_t *histogram, BVIEW_TIME_t *time, bool reset);
+
     /** Obtain Device Statistics */
     BVIEW_STATUS(*bst_device_data_get_cb)(int asic, BVIEW_BST_DEVICE_DATA_t *data, BVIEW_TIME_t *time);
 
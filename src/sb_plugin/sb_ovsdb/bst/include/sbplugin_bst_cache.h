@@ -26,6 +26,7 @@ extern "C"
 #endif
 
 #include "sbplugin.h"
+#include "bst.h"
 #include "sbplugin_ovsdb.h"
 #include "sbplugin_bst_map.h"
 #include "sbplugin_bst_ovsdb.h"
@@ -61,6 +62,64 @@ typedef struct _bst_ovsdb_stat_db_
   BVIEW_OVSDB_BID_INFO_t         rqeQueueEntries[SB_OVSDB_E_RQE_QUEUE_STAT_SIZE];
 } BVIEW_OVSDB_BST_STAT_DB_t;
 
+/* Number of cache generations whose dirty rows are remembered */
+#define BVIEW_OVSDB_BST_DIRTY_HISTORY   4
+
+/* 64 bit words per BID dirty bitmap, sized for the largest BID table
+ * (unicast queues)
+ */
+#define BVIEW_OVSDB_BST_DIRTY_WORDS     ((SB_OVSDB_E_UC_STAT_SIZE + 63) / 64)
+
+/* Rows of the stats cache updated during one generation */
+typedef struct _bst_ovsdb_dirty_map_
+{
+  /* Bit per BID that has at least one dirty row */
+  uint32_t  bids;
+  /* Bit per row, indexed like the BID's database */
+  uint64_t  rows[SB_OVSDB_BST_STAT_ID_MAX_COUNT][BVIEW_OVSDB_BST_DIRTY_WORDS];
+} BVIEW_OVSDB_BST_DIRTY_MAP_t;
+
+/* Snapshot buffers per asic the monitor thread publishes into, enough
+ * for the report records held by the application, the published one
+ * and the one being filled
+ */
+#define BVIEW_OVSDB_BST_PUBLISH_BUFFERS 6
+
+/* Report ready snapshot maintained by the monitor thread */
+typedef struct _bst_ovsdb_publish_buf_
+{
+  BVIEW_BST_ASIC_SNAPSHOT_DATA_t snapshot;
+  BVIEW_TIME_t  time;
+  /* Update batch the contents are at, 0 if never filled */
+  uint64_t      batch;
+  /* References held by readers */
+  uint32_t      refs;
+} BVIEW_OVSDB_BST_PUBLISH_BUF_t;
+
+/* Snapshot publication state of an asic */
+typedef struct _bst_ovsdb_publish_
+{
+  /* Set once the buffers are allocated */
+  bool                           enabled;
+  BVIEW_BST_SNAPSHOT_LAYOUT_t    layout;
+  BVIEW_OVSDB_BST_PUBLISH_BUF_t  buf[BVIEW_OVSDB_BST_PUBLISH_BUFFERS];
+  /* Latest complete snapshot, NULL until the first batch */
+  BVIEW_OVSDB_BST_PUBLISH_BUF_t *published;
+  /* Update batch collecting changes, starts at 1 */
+  uint64_t                       batch;
+  /* Rows updated in each of the last BVIEW_OVSDB_BST_DIRTY_HISTORY
+   * batches, indexed by batch modulo the history size
+   */
+  BVIEW_OVSDB_BST_DIRTY_MAP_t    dirty[BVIEW_OVSDB_BST_DIRTY_HISTORY];
+  /* Occupancy histograms in the layout. The monitor thread counts the
+   * updates in the active set while the other one is read and cleared.
+   */
+  BVIEW_BST_HISTOGRAM_t         *histogram[2];
+  uint32_t                       histogram_active;
+  /* Time the active set of histograms started at */
+  BVIEW_TIME_t                   histogram_start;
+} BVIEW_OVSDB_BST_PUBLISH_t;
+
 /* BST Config cache of OVSDB */
 typedef struct _bst_ovsdb_config_data_
 {
@@ -80,10 +139,25 @@ typedef struct _bst_ovsdb_data_
 { 
   /* Semaphore */
   pthread_rwlock_t  lock;
+  /* Update batch sequence of the stats cache, odd while the monitor
+   * thread is updating rows. Lets snapshots be taken without the lock.
+   */
+  uint32_t          seq;
+  /* Serializes snapshot readers */
+  pthread_mutex_t   snapshot_lock;
   /* BST Configuration data*/
   BVIEW_OVSDB_CONFIG_DATA_t     config_data;  
   /* OVSDB plugin Cache */
   BVIEW_OVSDB_BST_STAT_DB_t     cache[BVIEW_MAX_ASICS_ON_A_PLATFORM];
+  /* Generation currently collecting updates, starts at 1 */
+  uint64_t                      generation[BVIEW_MAX_ASICS_ON_A_PLATFORM];
+  /* Rows updated in each of the last BVIEW_OVSDB_BST_DIRTY_HISTORY
+   * generations, indexed by generation modulo the history size
+   */
+  BVIEW_OVSDB_BST_DIRTY_MAP_t   dirty[BVIEW_MAX_ASICS_ON_A_PLATFORM]
+                                     [BVIEW_OVSDB_BST_DIRTY_HISTORY];
+  /* Report ready snapshots published at the end of each update batch */
+  BVIEW_OVSDB_BST_PUBLISH_t     publish[BVIEW_MAX_ASICS_ON_A_PLATFORM];
 
 } BVIEW_OVSDB_BST_DATA_t;
 
@@ -208,6 +282,137 @@ BVIEW_STATUS bst_ovsdb_row_info_get (int asic, char *ovsdb_key,
                                      int *pbid, int *port,
                                      int *queue);
 
+/*********************************************************************
+* @brief   Start a batch of stats cache updates
+*
+* @param[in]   @none
+*
+* @retval   none
+*
+* @notes    Snapshot readers retry while a batch is in progress, so a
+*           snapshot never mixes rows of two update batches. Batches
+*           are issued by the monitor thread only and must not nest.
+*********************************************************************/
+void bst_ovsdb_cache_write_begin (void);
+
+/*********************************************************************
+* @brief   End a batch of stats cache updates
+*
+* @param[in]   @none
+*
+* @retval   none
+*
+* @notes    Publishes a new snapshot for every asic whose rows changed.
+*********************************************************************/
+void bst_ovsdb_cache_write_end (void);
+
+/*********************************************************************
+* @brief   Copy a point in time view of the stats cache into a snapshot
+*
+* @param[in]   asic        -  asic number
+* @param[out]  snapshot    -  Snapshot to be filled
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_SUCCESS            Snapshot is filled
+*
+* @notes    Lock free for the monitor thread, the copy is retried if an
+*           update batch ran while it was taken.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_cache_snapshot_get (int asic,
+                                 BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot);
+
+/*********************************************************************
+* @brief   Copy the rows changed since a generation into a snapshot
+*
+* @param[in]     asic        -  asic number
+* @param[in,out] snapshot    -  Snapshot holding the cache contents as of
+*                               '*generation'
+* @param[in,out] generation  -  In: generation of the snapshot contents,
+*                               0 if the snapshot holds no data.
+*                               Out: generation the snapshot is now at.
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_FAILURE            Failed to get the snapshot lock
+* @retval BVIEW_STATUS_SUCCESS            Snapshot is up to date
+*
+* @notes    Falls back to copying every row when the generation is 0 or
+*           older than the dirty history kept by the cache. Like
+*           bst_ovsdb_cache_snapshot_get() the copy is consistent with
+*           the update batches and never blocks the monitor thread.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_cache_snapshot_incremental_get (int asic,
+                                 BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                                 uint64_t *generation);
+
+/*********************************************************************
+* @brief   Start publishing report ready snapshots for an asic
+*
+* @param[in]   asic        -  asic number
+* @param[in]   layout      -  Layout of the published snapshots
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_OUTOFMEMORY        Failed to allocate the buffers
+* @retval BVIEW_STATUS_SUCCESS            Publication is enabled
+*
+* @notes    The first snapshot is published at the end of the next
+*           update batch touching the asic.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_cache_publish_start (int asic,
+                                 const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout);
+
+/*********************************************************************
+* @brief   Take a reference to the latest published snapshot
+*
+* @param[in]   asic        -  asic number
+* @param[out]  snapshot    -  Published snapshot
+* @param[out]  time        -  Time the snapshot was published
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_NOTREADY           Nothing is published yet
+* @retval BVIEW_STATUS_SUCCESS            Reference is taken
+*
+* @notes    The snapshot stays unchanged until it is released with
+*           bst_ovsdb_cache_published_put().
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_cache_published_get (int asic,
+                                 const BVIEW_BST_ASIC_SNAPSHOT_DATA_t **snapshot,
+                                 BVIEW_TIME_t *time);
+
+/*********************************************************************
+* @brief   Release a reference to a published snapshot
+*
+* @param[in]   asic        -  asic number
+* @param[in]   snapshot    -  Snapshot from bst_ovsdb_cache_published_get()
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Not a published snapshot
+* @retval BVIEW_STATUS_SUCCESS            Reference is released
+*
+* @notes    none
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_cache_published_put (int asic,
+                                 const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot);
+
+/*********************************************************************
+* @brief   Read, and optionally restart, the occupancy histograms
+*
+* @param[in]   asic        -  asic number
+* @param[out]  histogram   -  Histograms to be filled, NULL if they are
+*                             only to be restarted
+* @param[out]  time        -  Time the histograms started at
+* @param[in]   reset       -  Start new histograms once read
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_NOTREADY           Publication is not started yet
+* @retval BVIEW_STATUS_FAILURE            Failed to get the snapshot lock
+* @retval BVIEW_STATUS_SUCCESS            Histograms are read
+*
+* @notes    The histograms are kept along with the published snapshots,
+*           in their layout. Never blocks the monitor thread.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_cache_histogram_get (int asic,
+                                 BVIEW_BST_ASIC_HISTOGRAM_DATA_t *histogram,
+                                 BVIEW_TIME_t *time, bool reset);
+
 /*********************************************************************
 * @brief   Dumps BST ovsdb cache. 
 *          Non zero Stats and thresholds are dumped
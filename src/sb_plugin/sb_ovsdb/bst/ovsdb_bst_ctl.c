@@ -344,6 +344,13 @@ bst_ovsdb_cache_update_table(const char *table_name, struct json *table_update,
   /* Release lock */
   SB_OVSDB_RWLOCK_UNLOCK(p_cache->lock);
 
+  /* Rows of one bufmon update are published to snapshot readers
+     as a single batch */
+  if (strcmp (table_name, "bufmon") == 0)
+  {
+    bst_ovsdb_cache_write_begin ();
+  }
+
   /* Loop through all Nodes and update the cahce*/
   SHASH_FOR_EACH (node, json_object(table_update))
   {
@@ -458,6 +465,11 @@ bst_ovsdb_cache_update_table(const char *table_name, struct json *table_update,
    }
  } /* SHASH_FOR_EACH (node, json_object(table_update)) */
 
+  if (strcmp (table_name, "bufmon") == 0)
+  {
+    bst_ovsdb_cache_write_end ();
+  }
+
   /* check if there is any diff in old and new track mask */
   if (oldTrackMask != trackMask)
   {
@@ -352,87 +352,148 @@ BVIEW_STATUS sbplugin_ovsdb_bst_snapshot_get (int asic,
                                  BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
                                  BVIEW_TIME_t *time)
 {
-  BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
+  /* Check validity of input data*/
+  BVIEW_BST_INPUT_VALIDATE (asic, snapshot, time);
+
+  /* Update current local time*/
+  sbplugin_ovsdb_system_time_get (time);
 
+  /* All realms are copied from a single cache update batch,
+   * without holding off the monitor thread.
+   */
+  return bst_ovsdb_cache_snapshot_get (asic, snapshot);
+}
+
+/*********************************************************************
+* @brief  Bring a previously obtained ASIC statistics report up to date
+*
+* @param[in]      asic               - unit
+* @param[in,out]  snapshot           - snapshot data structure
+* @param[out]     time               - time
+* @param[in,out]  generation         - generation the snapshot is at,
+*                                      0 if it holds no data
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if snapshot get is failed.
+* @retval BVIEW_STATUS_SUCCESS           if snapshot get is success.
+*
+* @notes    Only the cache rows changed since 'generation' are copied.
+*
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_ovsdb_bst_snapshot_incremental_get (int asic,
+                                 BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                                 BVIEW_TIME_t *time,
+                                 uint64_t *generation)
+{
   /* Check validity of input data*/
   BVIEW_BST_INPUT_VALIDATE (asic, snapshot, time);
+  SB_OVSDB_NULLPTR_CHECK (generation, BVIEW_STATUS_INVALID_PARAMETER);
 
-  /* Obtain Device Statistics */
-  rv = sbplugin_ovsdb_bst_device_data_get (asic, &snapshot->device, time);
-  if (rv != BVIEW_STATUS_SUCCESS)
-  {
-    return BVIEW_STATUS_FAILURE;
-  }
+  /* Update current local time*/
+  sbplugin_ovsdb_system_time_get (time);
 
-  /* Obtain Ingress Port + Priority Groups Statistics */
-  rv = sbplugin_ovsdb_bst_ippg_data_get (asic, &snapshot->iPortPg, time);
-  if (rv != BVIEW_STATUS_SUCCESS)
-  {
-    return BVIEW_STATUS_FAILURE;
-  }
-  /* Obtain Ingress Port + Service Pools Statistics */
-  rv = sbplugin_ovsdb_bst_ipsp_data_get (asic, &snapshot->iPortSp, time);
-  if (rv != BVIEW_STATUS_SUCCESS)
-  {
-    return BVIEW_STATUS_FAILURE;
-  }
+  return bst_ovsdb_cache_snapshot_incremental_get (asic, snapshot, generation);
+}
 
-  /* Obtain Ingress Service Pools Statistics */
-  rv = sbplugin_ovsdb_bst_isp_data_get (asic, &snapshot->iSp,time);
-  if (rv != BVIEW_STATUS_SUCCESS)
-  {
-    return BVIEW_STATUS_FAILURE;
-  }
+/*********************************************************************
+* @brief  Start publishing report ready ASIC statistics snapshots
+*
+* @param[in]      asic               - unit
+* @param[in]      layout             - layout of the published snapshots
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_OUTOFMEMORY       if buffers can't be allocated.
+* @retval BVIEW_STATUS_SUCCESS           if publication is started.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_ovsdb_bst_snapshot_publish_start (int asic,
+                                 const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout)
+{
+  SB_OVSDB_VALID_UNIT_CHECK (asic);
+  SB_OVSDB_NULLPTR_CHECK (layout, BVIEW_STATUS_INVALID_PARAMETER);
 
-  /* Obtain Egress Port + Service Pools Statistics */
-  rv = sbplugin_ovsdb_bst_epsp_data_get (asic, &snapshot->ePortSp, time);
-  if (rv != BVIEW_STATUS_SUCCESS)
-  {
-    return BVIEW_STATUS_FAILURE;
-  }
+  return bst_ovsdb_cache_publish_start (asic, layout);
+}
 
-  /* Obtain Egress Service Pools Statistics */
-  rv = sbplugin_ovsdb_bst_esp_data_get (asic, &snapshot->eSp, time);
-  if (rv != BVIEW_STATUS_SUCCESS)
-  {
-    return BVIEW_STATUS_FAILURE;
-  }
+/*********************************************************************
+* @brief  Take a reference to the latest published ASIC statistics snapshot
+*
+* @param[in]      asic               - unit
+* @param[out]     snapshot           - published snapshot
+* @param[out]     time               - time of the snapshot
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_NOTREADY          if nothing is published yet.
+* @retval BVIEW_STATUS_SUCCESS           if reference is taken.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_ovsdb_bst_snapshot_published_get (int asic,
+                                 const BVIEW_BST_ASIC_SNAPSHOT_DATA_t **snapshot,
+                                 BVIEW_TIME_t *time)
+{
+  /* Check validity of input data*/
+  BVIEW_BST_INPUT_VALIDATE (asic, snapshot, time);
 
-  /* Obtain Egress Egress Unicast Queues Statistics */
-  rv = sbplugin_ovsdb_bst_eucq_data_get (asic, &snapshot->eUcQ, time);
-  if (rv != BVIEW_STATUS_SUCCESS)
-  {
-    return BVIEW_STATUS_FAILURE;
-  }
+  return bst_ovsdb_cache_published_get (asic, snapshot, time);
+}
 
-  /* Obtain Egress Egress Unicast Queue Groups Statistics */
-  rv = sbplugin_ovsdb_bst_eucqg_data_get (asic, &snapshot->eUcQg ,time);
-  if (rv != BVIEW_STATUS_SUCCESS)
-  {
-    return BVIEW_STATUS_FAILURE;
-  }
+/*********************************************************************
+* @brief  Release a published ASIC statistics snapshot
+*
+* @param[in]      asic               - unit
+* @param[in]      snapshot           - published snapshot
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_SUCCESS           if reference is released.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_ovsdb_bst_snapshot_published_put (int asic,
+                                 const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot)
+{
+  SB_OVSDB_VALID_UNIT_CHECK (asic);
+  SB_OVSDB_NULLPTR_CHECK (snapshot, BVIEW_STATUS_INVALID_PARAMETER);
 
-  /* Obtain Egress Egress Multicast Queues Statistics */
-  rv = sbplugin_ovsdb_bst_emcq_data_get (asic, &snapshot->eMcQ, time);
-  if (rv != BVIEW_STATUS_SUCCESS)
-  {
-    return BVIEW_STATUS_FAILURE;
-  }
+  return bst_ovsdb_cache_published_put (asic, snapshot);
+}
 
-  /* Obtain Egress Egress CPU Queues Statistics */
-  rv = sbplugin_ovsdb_bst_cpuq_data_get (asic, &snapshot->cpqQ,time);
-  if (rv != BVIEW_STATUS_SUCCESS)
-  {
-    return BVIEW_STATUS_FAILURE;
-  }
+/*********************************************************************
+* @brief  Obtain, and optionally restart, the occupancy histograms
+*
+* @param[in]      asic               - unit
+* @param[out]     histogram          - histograms, NULL to only restart them
+* @param[out]     time               - time the histograms started at
+* @param[in]      reset              - start new histograms once read
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_NOTREADY          if the histograms are not kept yet.
+* @retval BVIEW_STATUS_SUCCESS           if histograms are obtained.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_ovsdb_bst_histogram_get (int asic,
+                                 BVIEW_BST_ASIC_HISTOGRAM_DATA_t *histogram,
+                                 BVIEW_TIME_t *time, bool reset)
+{
+  SB_OVSDB_VALID_UNIT_CHECK (asic);
 
-  /* Obtain Egress Egress RQE Queues Statistics */
-  rv = sbplugin_ovsdb_bst_rqeq_data_get (asic, &snapshot->rqeQ, time);
-  if (rv != BVIEW_STATUS_SUCCESS)
+  if ((NULL == histogram) && (false == reset))
   {
-    return BVIEW_STATUS_FAILURE;
+    return BVIEW_STATUS_INVALID_PARAMETER;
   }
-  return BVIEW_STATUS_SUCCESS;
+
+  return bst_ovsdb_cache_histogram_get (asic, histogram, time, reset);
 }
 
 /*********************************************************************
@@ -1616,13 +1677,14 @@ BVIEW_STATUS sbplugin_ovsdb_bst_threshold_get (int asic,
 
   /* Check validity of input data*/
   SB_OVSDB_NULLPTR_CHECK (data, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_OVSDB_NULLPTR_CHECK (data->layout, BVIEW_STATUS_INVALID_PARAMETER);
 
    /* Update current local time*/
   sbplugin_ovsdb_system_time_get (time);
 
   /* Device wide threshold configuration*/
   rv = bst_ovsdb_threshold_get(asic, 0, 0,
-                               SB_OVSDB_BST_STAT_ID_DEVICE, &data->device.bufferCount);
+                               SB_OVSDB_BST_STAT_ID_DEVICE, &BVIEW_BST_SNAPSHOT_DEVICE_DATA(data)->bufferCount);
   if (BVIEW_STATUS_SUCCESS != rv)
   {
     return BVIEW_STATUS_FAILURE;
@@ -1638,7 +1700,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_threshold_get (int asic,
        */
       rv = bst_ovsdb_threshold_get (asic, port, index,
                                     SB_OVSDB_BST_STAT_ID_PRI_GROUP_SHARED,
-                                    &data->iPortPg.data[port - 1][index].umShareBufferCount);
+                                    &BVIEW_BST_SNAPSHOT_IPPG_DATA(data, port - 1, index)->umShareBufferCount);
       if (BVIEW_STATUS_SUCCESS != rv)
       {
         return BVIEW_STATUS_FAILURE;
@@ -1648,7 +1710,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_threshold_get (int asic,
        */
       rv = bst_ovsdb_threshold_get (asic, port, index,
                                     SB_OVSDB_BST_STAT_ID_PRI_GROUP_HEADROOM,
-                                    &data->iPortPg.data[port - 1][index].umHeadroomBufferCount);
+                                    &BVIEW_BST_SNAPSHOT_IPPG_DATA(data, port - 1, index)->umHeadroomBufferCount);
       if (BVIEW_STATUS_SUCCESS != rv)
       {
         return BVIEW_STATUS_FAILURE;
@@ -1662,7 +1724,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_threshold_get (int asic,
     {
       rv = bst_ovsdb_threshold_get(asic, port, index,
                                    SB_OVSDB_BST_STAT_ID_PORT_POOL,
-                                   &data->iPortSp.data[port - 1][index].umShareBufferCount);
+                                   &BVIEW_BST_SNAPSHOT_IPSP_DATA(data, port - 1, index)->umShareBufferCount);
       if (BVIEW_STATUS_SUCCESS != rv)
       {
         return BVIEW_STATUS_FAILURE;
@@ -1675,7 +1737,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_threshold_get (int asic,
        * UC shared use-count in units of 8 buffers */
       rv = bst_ovsdb_threshold_get (asic, port, index,
                                     SB_OVSDB_BST_STAT_ID_EGR_UCAST_PORT_SHARED,
-                                    &data->ePortSp.data[port - 1][index].ucShareBufferCount);
+                                    &BVIEW_BST_SNAPSHOT_EPSP_DATA(data, port - 1, index)->ucShareBufferCount);
       if (BVIEW_STATUS_SUCCESS != rv)
       {
         return BVIEW_STATUS_FAILURE;
@@ -1684,7 +1746,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_threshold_get (int asic,
       /* Get threshold configuration for egress based port shared buffers*/
       rv = bst_ovsdb_threshold_get (asic, port, index,
                                     SB_OVSDB_BST_STAT_ID_EGR_PORT_SHARED,
-                                    &data->ePortSp.data[port - 1][index].umShareBufferCount);
+                                    &BVIEW_BST_SNAPSHOT_EPSP_DATA(data, port - 1, index)->umShareBufferCount);
       if (BVIEW_STATUS_SUCCESS != rv)
       {
         return BVIEW_STATUS_FAILURE;
@@ -1697,31 +1759,31 @@ BVIEW_STATUS sbplugin_ovsdb_bst_threshold_get (int asic,
     {
       rv = bst_ovsdb_threshold_get (asic, port, index,
                                     SB_OVSDB_BST_STAT_ID_MCAST,
-                                    &data->eMcQ.data[index].mcBufferCount);
+                                    &BVIEW_BST_SNAPSHOT_EMCQ_DATA(data, index)->mcBufferCount);
       if (SB_OVSDB_RV_ERROR (rv))
       {
         return BVIEW_STATUS_FAILURE;
       }
 
-      data->eMcQ.data[index].port = 0;
+      BVIEW_BST_SNAPSHOT_EMCQ_DATA(data, index)->port = 0;
     }
     /* Get threshold configuration for The BST_Threshold for the Egress UC Queues in units of 8 buffers.*/
     BVIEW_BST_UC_QUEUE_ITER (asic,index)
     {
       rv = bst_ovsdb_threshold_get (asic, port, index,
-          SB_OVSDB_BST_STAT_ID_UCAST, &data->eUcQ.data[index].ucBufferCount);
+          SB_OVSDB_BST_STAT_ID_UCAST, &BVIEW_BST_SNAPSHOT_EUCQ_DATA(data, index)->ucBufferCount);
       if (BVIEW_STATUS_SUCCESS != rv)
       {
         return BVIEW_STATUS_FAILURE;
       }
-      data->eUcQ.data[index].port =  0;
+      BVIEW_BST_SNAPSHOT_EUCQ_DATA(data, index)->port =  0;
     }
 
   BVIEW_BST_SP_ITER (asic, index)
   {
     /*  BST_Threshold for each of the 4 Egress SPs Shared use-counts in units of buffers.*/
     rv = bst_ovsdb_threshold_get (asic, 0, index,
-            SB_OVSDB_BST_STAT_ID_EGR_POOL, &data->eSp.data[index].umShareBufferCount);
+            SB_OVSDB_BST_STAT_ID_EGR_POOL, &BVIEW_BST_SNAPSHOT_ESP_DATA(data, index)->umShareBufferCount);
     if (BVIEW_STATUS_SUCCESS != rv)
     {
       return BVIEW_STATUS_FAILURE;
@@ -1729,7 +1791,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_threshold_get (int asic,
 
     /*  BST_Threshold for each of the 4 Egress SPs Shared use-counts in units of buffers.*/
     rv = bst_ovsdb_threshold_get (asic, 0, index,
-            SB_OVSDB_BST_STAT_ID_EGR_MCAST_POOL, &data->eSp.data[index].mcShareBufferCount);
+            SB_OVSDB_BST_STAT_ID_EGR_MCAST_POOL, &BVIEW_BST_SNAPSHOT_ESP_DATA(data, index)->mcShareBufferCount);
     if (BVIEW_STATUS_SUCCESS != rv)
     {
       return BVIEW_STATUS_FAILURE;
@@ -1742,7 +1804,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_threshold_get (int asic,
   BVIEW_BST_SP_ITER (asic, index)
   {
     rv = bst_ovsdb_threshold_get (asic, 0, index,
-              SB_OVSDB_BST_STAT_ID_ING_POOL, &data->iSp.data[index].umShareBufferCount);
+              SB_OVSDB_BST_STAT_ID_ING_POOL, &BVIEW_BST_SNAPSHOT_ISP_DATA(data, index)->umShareBufferCount);
     if (BVIEW_STATUS_SUCCESS != rv)
     {
       return BVIEW_STATUS_FAILURE;
@@ -1753,7 +1815,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_threshold_get (int asic,
   BVIEW_BST_CPU_QUEUE_ITER (asic, index)
   {
     rv = bst_ovsdb_threshold_get (asic, port, index,
-                   SB_OVSDB_BST_STAT_ID_CPU_QUEUE, &data->cpqQ.data[index].cpuBufferCount);
+                   SB_OVSDB_BST_STAT_ID_CPU_QUEUE, &BVIEW_BST_SNAPSHOT_CPUQ_DATA(data, index)->cpuBufferCount);
     if (BVIEW_STATUS_SUCCESS != rv)
     {
       return BVIEW_STATUS_FAILURE;
@@ -1766,7 +1828,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_threshold_get (int asic,
   BVIEW_BST_RQE_QUEUE_ITER (asic, index)
   {
     rv = bst_ovsdb_threshold_get (asic, 0, index, SB_OVSDB_BST_STAT_ID_RQE_QUEUE,
-                                  &data->rqeQ.data[index].rqeBufferCount);
+                                  &BVIEW_BST_SNAPSHOT_RQEQ_DATA(data, index)->rqeBufferCount);
     if (SB_OVSDB_RV_ERROR (rv))
     {
       return BVIEW_STATUS_FAILURE;
@@ -1777,7 +1839,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_threshold_get (int asic,
   BVIEW_BST_UC_QUEUE_GRP_ITER (asic, index)
   {
     rv = bst_ovsdb_threshold_get (asic, 0, index,
-                                 SB_OVSDB_BST_STAT_ID_UCAST_GROUP, &data->eUcQg.data[index].ucBufferCount);
+                                 SB_OVSDB_BST_STAT_ID_UCAST_GROUP, &BVIEW_BST_SNAPSHOT_EUCQG_DATA(data, index)->ucBufferCount);
     if (SB_OVSDB_RV_ERROR (rv))
     {
       return BVIEW_STATUS_FAILURE;
@@ -1813,6 +1875,11 @@ BVIEW_STATUS sbplugin_ovsdb_bst_init (BVIEW_SB_BST_FEATURE_t *ovsdbBstFeat)
   ovsdbBstFeat->bst_config_set_cb           = sbplugin_ovsdb_bst_config_set;
   ovsdbBstFeat->bst_config_get_cb           = sbplugin_ovsdb_bst_config_get;
   ovsdbBstFeat->bst_snapshot_get_cb         = sbplugin_ovsdb_bst_snapshot_get;
+  ovsdbBstFeat->bst_snapshot_incremental_get_cb = sbplugin_ovsdb_bst_snapshot_incremental_get;
+  ovsdbBstFeat->bst_snapshot_publish_start_cb = sbplugin_ovsdb_bst_snapshot_publish_start;
+  ovsdbBstFeat->bst_snapshot_published_get_cb = sbplugin_ovsdb_bst_snapshot_published_get;
+  ovsdbBstFeat->bst_snapshot_published_put_cb = sbplugin_ovsdb_bst_snapshot_published_put;
+  ovsdbBstFeat->bst_histogram_get_cb        = sbplugin_ovsdb_bst_histogram_get;
   ovsdbBstFeat->bst_device_data_get_cb      = sbplugin_ovsdb_bst_device_data_get;
   ovsdbBstFeat->bst_ippg_data_get_cb        = sbplugin_ovsdb_bst_ippg_data_get;
   ovsdbBstFeat->bst_ipsp_data_get_cb        = sbplugin_ovsdb_bst_ipsp_data_get;
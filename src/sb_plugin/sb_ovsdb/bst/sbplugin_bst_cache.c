@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <inttypes.h>
 #include <pthread.h>
+#include <sched.h>
 #include "sbplugin.h"
 #include "sbplugin_ovsdb.h"
 #include "sbplugin_bst_map.h"
@@ -53,6 +54,8 @@ extern BVIEW_BST_OVSDB_BID_PARAMS_t  bid_tab_params[SB_OVSDB_BST_STAT_ID_MAX_COU
 *********************************************************************/
 BVIEW_STATUS bst_ovsdb_cache_init()
 {
+  int asic = 0;
+
   /* Initialize Read Write lock with default attributes */
   if (pthread_rwlock_init (&bst_ovsdb_cache.lock, NULL) != 0)
   {
@@ -61,6 +64,24 @@ BVIEW_STATUS bst_ovsdb_cache_init()
             
     return BVIEW_STATUS_FAILURE;
   }
+
+  /* Serializes snapshot readers, writers never take it */
+  if (pthread_mutex_init (&bst_ovsdb_cache.snapshot_lock, NULL) != 0)
+  {
+    SB_OVSDB_LOG (BVIEW_LOG_ERROR, 
+	        "Failed to create snapshot mutex with deafault attributes\n")
+    return BVIEW_STATUS_FAILURE;
+  }
+  bst_ovsdb_cache.seq = 0;
+
+  /* Generation 0 is reserved for "no data", start collecting at 1 */
+  for (asic = 0; asic < BVIEW_MAX_ASICS_ON_A_PLATFORM; asic++)
+  {
+    bst_ovsdb_cache.generation[asic] = 1;
+    memset (bst_ovsdb_cache.dirty[asic], 0, sizeof (bst_ovsdb_cache.dirty[asic]));
+    memset (&bst_ovsdb_cache.publish[asic], 0, sizeof (bst_ovsdb_cache.publish[asic]));
+    bst_ovsdb_cache.publish[asic].batch = 1;
+  }
   return BVIEW_STATUS_SUCCESS;
 }
 
@@ -318,6 +339,28 @@ BVIEW_STATUS bst_ovsdb_row_info_get (int asic, char *ovsdb_key,
   return BVIEW_STATUS_SUCCESS;
 }
  
+/*********************************************************************
+* @brief   Mark a row of the stats cache as changed
+*
+* @param[in]   p_dirty   -  Dirty map of the generation or batch
+* @param[in]   bid       -  BID of the row
+* @param[in]   index     -  Index of the row in the BID's database
+*
+* @retval   none
+*
+* @notes    Safe against a concurrent snapshot reader.
+*********************************************************************/
+static void bst_ovsdb_dirty_mark (BVIEW_OVSDB_BST_DIRTY_MAP_t *p_dirty,
+                                  int bid, int index)
+{
+  __atomic_fetch_or (&p_dirty->bids, (1U << bid), __ATOMIC_RELAXED);
+  __atomic_fetch_or (&p_dirty->rows[bid][index / 64], (1ULL << (index % 64)),
+                     __ATOMIC_RELAXED);
+}
+
+static void bst_ovsdb_histogram_update (int asic, int bid, int index,
+                                        uint64_t stat);
+
 /*********************************************************************
 * @brief    Update the stat/threshold of row with key 'ovsdb_key'. 
 *           
@@ -339,7 +382,11 @@ BVIEW_STATUS    bst_ovsdb_row_update (int asic,  int bid,
                                       BVIEW_OVSDB_BID_INFO_t *p_row)
 {
   BVIEW_OVSDB_BID_INFO_t   *p_db_row = NULL;
+  BVIEW_OVSDB_BID_INFO_t   *p_base = NULL;
+  BVIEW_OVSDB_BST_PUBLISH_t *p_pub = NULL;
+  int                       index = 0;
 
+  SB_OVSDB_VALID_UNIT_CHECK(asic);
   SB_OVSDB_NULLPTR_CHECK (p_row, BVIEW_STATUS_INVALID_PARAMETER);
 
   /* Get exact row of ovsdb_key*/
@@ -362,6 +409,19 @@ BVIEW_STATUS    bst_ovsdb_row_update (int asic,  int bid,
   {
     p_db_row->stat      = p_row->stat;
     p_db_row->threshold = p_row->threshold;
+
+    /* Remember the row as changed in the current generation */
+    p_base = BVIEW_OVSDB_BID_BASE_ADDR (bid, &bst_ovsdb_cache.cache[asic]);
+    index = p_db_row - p_base;
+    bst_ovsdb_dirty_mark (&bst_ovsdb_cache.dirty[asic]
+                 [__atomic_load_n (&bst_ovsdb_cache.generation[asic], __ATOMIC_ACQUIRE) %
+                  BVIEW_OVSDB_BST_DIRTY_HISTORY], bid, index);
+    /* and in the current update batch, for the published snapshots */
+    p_pub = &bst_ovsdb_cache.publish[asic];
+    bst_ovsdb_dirty_mark (&p_pub->dirty[p_pub->batch % BVIEW_OVSDB_BST_DIRTY_HISTORY],
+                          bid, index);
+    /* Every update counts in the occupancy histogram of the row */
+    bst_ovsdb_histogram_update (asic, bid, index, p_db_row->stat);
   }
   /* Release lock */
   SB_OVSDB_RWLOCK_UNLOCK(bst_ovsdb_cache.lock);
@@ -369,6 +429,826 @@ BVIEW_STATUS    bst_ovsdb_row_update (int asic,  int bid,
   return BVIEW_STATUS_SUCCESS;
 }  
  
+/*********************************************************************
+* @brief   Locate the counter of a stats cache row in a snapshot
+*
+* @param[in]   bid       -  BID of the row
+* @param[in]   index     -  Index of the row in the BID's database
+* @param[in]   snapshot  -  Snapshot
+*
+* @retval   Counter in the snapshot, NULL if the row is not part of it
+*
+* @notes    Rows outside the snapshot layout are not part of it, nor
+*           are the BIDs which are not reported in a snapshot.
+*********************************************************************/
+static uint64_t *bst_ovsdb_snapshot_row_counter (int bid, int index,
+                                 const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot)
+{
+  const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout = snapshot->layout;
+  unsigned int  port = 0;
+  unsigned int  column = index;
+
+  /* Double indexed tables are stored port major */
+  if (bid_tab_params[bid].is_double_indexed == true)
+  {
+    port = index / bid_tab_params[bid].num_of_columns;
+    column = index % bid_tab_params[bid].num_of_columns;
+    if (port >= layout->numPorts)
+    {
+      return NULL;
+    }
+  }
+
+  switch (bid)
+  {
+    case SB_OVSDB_BST_STAT_ID_DEVICE:
+      return &BVIEW_BST_SNAPSHOT_DEVICE_DATA(snapshot)->bufferCount;
+
+    case SB_OVSDB_BST_STAT_ID_EGR_POOL:
+      if (column < layout->numServicePools)
+      {
+        return &BVIEW_BST_SNAPSHOT_ESP_DATA(snapshot, column)->umShareBufferCount;
+      }
+      break;
+
+    case SB_OVSDB_BST_STAT_ID_EGR_MCAST_POOL:
+      if (column < layout->numServicePools)
+      {
+        return &BVIEW_BST_SNAPSHOT_ESP_DATA(snapshot, column)->mcShareBufferCount;
+      }
+      break;
+
+    case SB_OVSDB_BST_STAT_ID_ING_POOL:
+      if (column < layout->numServicePools)
+      {
+        return &BVIEW_BST_SNAPSHOT_ISP_DATA(snapshot, column)->umShareBufferCount;
+      }
+      break;
+
+    case SB_OVSDB_BST_STAT_ID_PORT_POOL:
+      if (column < layout->numServicePools)
+      {
+        return &BVIEW_BST_SNAPSHOT_IPSP_DATA(snapshot, port, column)->umShareBufferCount;
+      }
+      break;
+
+    case SB_OVSDB_BST_STAT_ID_PRI_GROUP_SHARED:
+      if (column < layout->numPriorityGroups)
+      {
+        return &BVIEW_BST_SNAPSHOT_IPPG_DATA(snapshot, port, column)->umShareBufferCount;
+      }
+      break;
+
+    case SB_OVSDB_BST_STAT_ID_PRI_GROUP_HEADROOM:
+      if (column < layout->numPriorityGroups)
+      {
+        return &BVIEW_BST_SNAPSHOT_IPPG_DATA(snapshot, port, column)->umHeadroomBufferCount;
+      }
+      break;
+
+    case SB_OVSDB_BST_STAT_ID_UCAST:
+      if (column < layout->numUnicastQueues)
+      {
+        return &BVIEW_BST_SNAPSHOT_EUCQ_DATA(snapshot, column)->ucBufferCount;
+      }
+      break;
+
+    case SB_OVSDB_BST_STAT_ID_MCAST:
+      if (column < layout->numMulticastQueues)
+      {
+        return &BVIEW_BST_SNAPSHOT_EMCQ_DATA(snapshot, column)->mcBufferCount;
+      }
+      break;
+
+    case SB_OVSDB_BST_STAT_ID_EGR_UCAST_PORT_SHARED:
+      if (column < layout->numServicePools)
+      {
+        return &BVIEW_BST_SNAPSHOT_EPSP_DATA(snapshot, port, column)->ucShareBufferCount;
+      }
+      break;
+
+    case SB_OVSDB_BST_STAT_ID_EGR_PORT_SHARED:
+      if (column < layout->numServicePools)
+      {
+        return &BVIEW_BST_SNAPSHOT_EPSP_DATA(snapshot, port, column)->umShareBufferCount;
+      }
+      break;
+
+    case SB_OVSDB_BST_STAT_ID_RQE_QUEUE:
+      if (column < layout->numRqeQueues)
+      {
+        return &BVIEW_BST_SNAPSHOT_RQEQ_DATA(snapshot, column)->rqeBufferCount;
+      }
+      break;
+
+    case SB_OVSDB_BST_STAT_ID_UCAST_GROUP:
+      if (column < layout->numUnicastQueueGroups)
+      {
+        return &BVIEW_BST_SNAPSHOT_EUCQG_DATA(snapshot, column)->ucBufferCount;
+      }
+      break;
+
+    case SB_OVSDB_BST_STAT_ID_CPU_QUEUE:
+      if (column < layout->numCpuQueues)
+      {
+        return &BVIEW_BST_SNAPSHOT_CPUQ_DATA(snapshot, column)->cpuBufferCount;
+      }
+      break;
+
+    default:
+      /* RQE pool entries are not part of a snapshot */
+      break;
+  }
+  return NULL;
+}
+
+/*********************************************************************
+* @brief   Copy one row of the stats cache into a snapshot
+*
+* @param[in]   p_db      -  Stats cache of the asic
+* @param[in]   bid       -  BID of the row
+* @param[in]   index     -  Index of the row in the BID's database
+* @param[out]  snapshot  -  Snapshot to be updated
+*
+* @notes    Rows which are not part of the snapshot are ignored.
+*********************************************************************/
+static void bst_ovsdb_snapshot_row_copy (BVIEW_OVSDB_BST_STAT_DB_t *p_db,
+                                         int bid, int index,
+                                         BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot)
+{
+  BVIEW_OVSDB_BID_INFO_t   *p_base = NULL;
+  uint64_t                 *p_counter = NULL;
+
+  p_counter = bst_ovsdb_snapshot_row_counter (bid, index, snapshot);
+  if (NULL != p_counter)
+  {
+    p_base = BVIEW_OVSDB_BID_BASE_ADDR (bid, p_db);
+    *p_counter = p_base[index].stat;
+  }
+}
+
+/*********************************************************************
+* @brief   Histogram bucket of a value
+*
+* @param[in]   value     -  Value
+*
+* @retval   Bucket counting the value
+*
+* @notes    Integer operations only, see BVIEW_BST_HISTOGRAM_BUCKET_LOW().
+*********************************************************************/
+static unsigned int bst_ovsdb_histogram_bucket (uint64_t value)
+{
+  unsigned int  msb = 0;
+  unsigned int  bucket = 0;
+
+  if (value < (1U << BVIEW_BST_HISTOGRAM_SUB_BITS))
+  {
+    return (unsigned int) value;
+  }
+
+  /* power of two, then the bits right below the most significant one */
+  msb = 63 - __builtin_clzll (value);
+  bucket = ((msb - BVIEW_BST_HISTOGRAM_SUB_BITS + 1) << BVIEW_BST_HISTOGRAM_SUB_BITS) |
+           ((value >> (msb - BVIEW_BST_HISTOGRAM_SUB_BITS)) &
+            ((1U << BVIEW_BST_HISTOGRAM_SUB_BITS) - 1));
+
+  return (bucket < BVIEW_BST_HISTOGRAM_BUCKETS) ? bucket :
+                                                  (BVIEW_BST_HISTOGRAM_BUCKETS - 1);
+}
+
+/*********************************************************************
+* @brief   Count a row update in the occupancy histogram of the row
+*
+* @param[in]   asic      -  asic number
+* @param[in]   bid       -  BID of the row
+* @param[in]   index     -  Index of the row in the BID's database
+* @param[in]   stat      -  New value of the row
+*
+* @retval   none
+*
+* @notes    Runs on the monitor thread, within an update batch. Constant
+*           time and no allocation, rows which are not part of a
+*           snapshot are not counted.
+*********************************************************************/
+static void bst_ovsdb_histogram_update (int asic, int bid, int index,
+                                        uint64_t stat)
+{
+  BVIEW_OVSDB_BST_PUBLISH_t *p_pub = &bst_ovsdb_cache.publish[asic];
+  BVIEW_BST_HISTOGRAM_t     *p_hist = NULL;
+  uint64_t                  *p_counter = NULL;
+  uint32_t                  *p_count = NULL;
+
+  if (false == __atomic_load_n (&p_pub->enabled, __ATOMIC_ACQUIRE))
+  {
+    return;
+  }
+
+  /* the histograms are laid out like the snapshots */
+  p_counter = bst_ovsdb_snapshot_row_counter (bid, index, &p_pub->buf[0].snapshot);
+  if (NULL == p_counter)
+  {
+    return;
+  }
+
+  p_hist = p_pub->histogram[__atomic_load_n (&p_pub->histogram_active, __ATOMIC_ACQUIRE)] +
+           (p_counter - (uint64_t *) p_pub->buf[0].snapshot.data);
+  p_count = &p_hist->count[bst_ovsdb_histogram_bucket (stat)];
+  __atomic_store_n (p_count, *p_count + 1, __ATOMIC_RELAXED);
+}
+
+static void bst_ovsdb_cache_publish (int asic);
+
+/*********************************************************************
+* @brief   Start a batch of stats cache updates
+*
+* @param[in]   @none
+*
+* @retval   none
+*
+* @notes    Snapshot readers retry while a batch is in progress, so a
+*           snapshot never mixes rows of two update batches. Batches
+*           are issued by the monitor thread only and must not nest.
+*********************************************************************/
+void bst_ovsdb_cache_write_begin (void)
+{
+  __atomic_store_n (&bst_ovsdb_cache.seq, bst_ovsdb_cache.seq + 1,
+                    __ATOMIC_RELAXED);
+  /* odd sequence must be visible before any of the row updates */
+  __atomic_thread_fence (__ATOMIC_SEQ_CST);
+}
+
+/*********************************************************************
+* @brief   End a batch of stats cache updates
+*
+* @param[in]   @none
+*
+* @retval   none
+*
+* @notes    Publishes a new snapshot for every asic whose rows changed.
+*********************************************************************/
+void bst_ovsdb_cache_write_end (void)
+{
+  int asic = 0;
+
+  __atomic_store_n (&bst_ovsdb_cache.seq, bst_ovsdb_cache.seq + 1,
+                    __ATOMIC_RELEASE);
+
+  for (asic = 0; asic < BVIEW_MAX_ASICS_ON_A_PLATFORM; asic++)
+  {
+    bst_ovsdb_cache_publish (asic);
+  }
+}
+
+/*********************************************************************
+* @brief   Wait for a stable cache and return its sequence
+*
+* @retval   Even sequence number to be passed to
+*           bst_ovsdb_cache_read_retry()
+*
+* @notes    Yields while the monitor thread is in an update batch,
+*           never blocks it.
+*********************************************************************/
+static uint32_t bst_ovsdb_cache_read_begin (void)
+{
+  uint32_t seq;
+
+  while ((seq = __atomic_load_n (&bst_ovsdb_cache.seq, __ATOMIC_ACQUIRE)) & 1)
+  {
+    sched_yield ();
+  }
+  return seq;
+}
+
+/*********************************************************************
+* @brief   Check whether the cache changed during a read
+*
+* @param[in]   seq   -  Sequence returned by bst_ovsdb_cache_read_begin()
+*
+* @retval   true if the data read must be discarded and read again
+*
+* @notes    none
+*********************************************************************/
+static bool bst_ovsdb_cache_read_retry (uint32_t seq)
+{
+  __atomic_thread_fence (__ATOMIC_ACQUIRE);
+  return (__atomic_load_n (&bst_ovsdb_cache.seq, __ATOMIC_RELAXED) != seq);
+}
+
+/*********************************************************************
+* @brief   Copy every row of the stats cache into a snapshot
+*
+* @param[in]   p_db      -  Stats cache of the asic
+* @param[out]  snapshot  -  Snapshot to be filled
+*
+* @retval   none
+*
+* @notes    none
+*********************************************************************/
+static void bst_ovsdb_snapshot_full_copy (BVIEW_OVSDB_BST_STAT_DB_t *p_db,
+                                          BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot)
+{
+  int  bid = 0;
+  int  index = 0;
+
+  memset (snapshot->data, 0, snapshot->layout->size);
+  for (bid = 0; bid < SB_OVSDB_BST_STAT_ID_MAX_COUNT; bid++)
+  {
+    for (index = 0; index < bid_tab_params[bid].size; index++)
+    {
+      bst_ovsdb_snapshot_row_copy (p_db, bid, index, snapshot);
+    }
+  }
+}
+
+/*********************************************************************
+* @brief   Copy the rows marked in a range of dirty maps into a snapshot
+*
+* @param[in]   p_db      -  Stats cache of the asic
+* @param[in]   ring      -  Dirty maps, indexed by generation modulo
+*                           BVIEW_OVSDB_BST_DIRTY_HISTORY
+* @param[in]   first     -  First generation to copy
+* @param[in]   last      -  Last generation to copy
+* @param[out]  snapshot  -  Snapshot to be updated
+*
+* @retval   none
+*
+* @notes    The range must not exceed the history kept in the ring.
+*********************************************************************/
+static void bst_ovsdb_snapshot_dirty_copy (BVIEW_OVSDB_BST_STAT_DB_t *p_db,
+                                           BVIEW_OVSDB_BST_DIRTY_MAP_t *ring,
+                                           uint64_t first, uint64_t last,
+                                           BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot)
+{
+  BVIEW_OVSDB_BST_DIRTY_MAP_t *p_dirty = NULL;
+  uint64_t  gen = 0;
+  uint64_t  bits = 0;
+  int       bid = 0;
+  int       word = 0;
+  int       index = 0;
+
+  for (gen = first; gen <= last; gen++)
+  {
+    p_dirty = &ring[gen % BVIEW_OVSDB_BST_DIRTY_HISTORY];
+    for (bid = 0; bid < SB_OVSDB_BST_STAT_ID_MAX_COUNT; bid++)
+    {
+      if (!(__atomic_load_n (&p_dirty->bids, __ATOMIC_RELAXED) & (1U << bid)))
+      {
+        continue;
+      }
+      for (word = 0; word < BVIEW_OVSDB_BST_DIRTY_WORDS; word++)
+      {
+        bits = __atomic_load_n (&p_dirty->rows[bid][word], __ATOMIC_RELAXED);
+        while (bits)
+        {
+          index = (word * 64) + __builtin_ctzll (bits);
+          bits &= (bits - 1);
+          if (index < bid_tab_params[bid].size)
+          {
+            bst_ovsdb_snapshot_row_copy (p_db, bid, index, snapshot);
+          }
+        }
+      }
+    }
+  }
+}
+
+/*********************************************************************
+* @brief   Copy a point in time view of the stats cache into a snapshot
+*
+* @param[in]   asic        -  asic number
+* @param[out]  snapshot    -  Snapshot to be filled
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_SUCCESS            Snapshot is filled
+*
+* @notes    Lock free for the monitor thread, the copy is retried if an
+*           update batch ran while it was taken.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_cache_snapshot_get (int asic,
+                                 BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot)
+{
+  uint32_t  seq = 0;
+
+  SB_OVSDB_VALID_UNIT_CHECK(asic);
+  SB_OVSDB_NULLPTR_CHECK (snapshot, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_OVSDB_NULLPTR_CHECK (snapshot->layout, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_OVSDB_NULLPTR_CHECK (snapshot->data, BVIEW_STATUS_INVALID_PARAMETER);
+
+  do
+  {
+    seq = bst_ovsdb_cache_read_begin ();
+    bst_ovsdb_snapshot_full_copy (&bst_ovsdb_cache.cache[asic], snapshot);
+  } while (bst_ovsdb_cache_read_retry (seq));
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief   Copy the rows changed since a generation into a snapshot
+*
+* @param[in]     asic        -  asic number
+* @param[in,out] snapshot    -  Snapshot holding the cache contents as of
+*                               '*generation'
+* @param[in,out] generation  -  In: generation of the snapshot contents,
+*                               0 if the snapshot holds no data.
+*                               Out: generation the snapshot is now at.
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_FAILURE            Failed to get the snapshot lock
+* @retval BVIEW_STATUS_SUCCESS            Snapshot is up to date
+*
+* @notes    Falls back to copying every row when the generation is 0 or
+*           older than the dirty history kept by the cache. Like
+*           bst_ovsdb_cache_snapshot_get() the copy is consistent with
+*           the update batches and never blocks the monitor thread.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_cache_snapshot_incremental_get (int asic,
+                                 BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                                 uint64_t *generation)
+{
+  BVIEW_OVSDB_BST_STAT_DB_t   *p_db = NULL;
+  uint64_t  current = 0;
+  uint64_t  since = 0;
+  uint32_t  seq = 0;
+  bool      full = false;
+
+  SB_OVSDB_VALID_UNIT_CHECK(asic);
+  SB_OVSDB_NULLPTR_CHECK (snapshot, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_OVSDB_NULLPTR_CHECK (snapshot->layout, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_OVSDB_NULLPTR_CHECK (snapshot->data, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_OVSDB_NULLPTR_CHECK (generation, BVIEW_STATUS_INVALID_PARAMETER);
+
+  p_db = &bst_ovsdb_cache.cache[asic];
+  since = *generation;
+
+  /* Only one reader may close generations at a time */
+  if (pthread_mutex_lock (&bst_ovsdb_cache.snapshot_lock) != 0)
+  {
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  /* Close the current generation first. Rows the monitor thread updates
+   * from now on are remembered in the next one, and are picked up again
+   * by the following call even if this copy already sees them.
+   */
+  current = bst_ovsdb_cache.generation[asic];
+  memset (&bst_ovsdb_cache.dirty[asic][(current + 1) % BVIEW_OVSDB_BST_DIRTY_HISTORY],
+          0, sizeof (BVIEW_OVSDB_BST_DIRTY_MAP_t));
+  __atomic_store_n (&bst_ovsdb_cache.generation[asic], current + 1,
+                    __ATOMIC_RELEASE);
+
+  /* The map just cleared was the one of generation current + 1 -
+   * BVIEW_OVSDB_BST_DIRTY_HISTORY, the ring holds the generations after it.
+   */
+  full = ((0 == since) || (since > current) ||
+          ((current - since) >= BVIEW_OVSDB_BST_DIRTY_HISTORY));
+
+  do
+  {
+    seq = bst_ovsdb_cache_read_begin ();
+
+    if (true == full)
+    {
+      /* Dirty history does not go back that far, copy everything */
+      bst_ovsdb_snapshot_full_copy (p_db, snapshot);
+      continue;
+    }
+
+    /* Copy the rows touched in any generation after 'since' */
+    bst_ovsdb_snapshot_dirty_copy (p_db, bst_ovsdb_cache.dirty[asic],
+                                   since + 1, current, snapshot);
+  } while (bst_ovsdb_cache_read_retry (seq));
+
+  pthread_mutex_unlock (&bst_ovsdb_cache.snapshot_lock);
+
+  *generation = current;
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief   Publish the snapshot of an asic at the end of an update batch
+*
+* @param[in]   asic        -  asic number
+*
+* @retval   none
+*
+* @notes    Runs on the monitor thread, the only writer of the cache,
+*           so the rows are read without the sequence check. A buffer
+*           nobody references is brought up to date from the dirty maps
+*           of the batches it missed, and made visible by a pointer swap.
+*********************************************************************/
+static void bst_ovsdb_cache_publish (int asic)
+{
+  BVIEW_OVSDB_BST_PUBLISH_t     *p_pub = &bst_ovsdb_cache.publish[asic];
+  BVIEW_OVSDB_BST_PUBLISH_BUF_t *p_buf = NULL;
+  BVIEW_OVSDB_BST_STAT_DB_t     *p_db = &bst_ovsdb_cache.cache[asic];
+  uint64_t  completed = p_pub->batch;
+  int       i = 0;
+
+  if ((true == __atomic_load_n (&p_pub->enabled, __ATOMIC_ACQUIRE)) &&
+      ((NULL == p_pub->published) ||
+       (p_pub->published->batch != (completed - 1)) ||
+       (0 != p_pub->dirty[completed % BVIEW_OVSDB_BST_DIRTY_HISTORY].bids)))
+  {
+    for (i = 0; i < BVIEW_OVSDB_BST_PUBLISH_BUFFERS; i++)
+    {
+      if ((&p_pub->buf[i] != p_pub->published) &&
+          (0 == __atomic_load_n (&p_pub->buf[i].refs, __ATOMIC_SEQ_CST)))
+      {
+        p_buf = &p_pub->buf[i];
+        break;
+      }
+    }
+
+    if (NULL == p_buf)
+    {
+      /* all held by readers, the changes go out with the next batch */
+      SB_OVSDB_DEBUG_PRINT ("No free buffer to publish BST snapshot of asic %d\n",
+                            asic);
+    }
+    else
+    {
+      if ((0 == p_buf->batch) ||
+          ((completed - p_buf->batch) > BVIEW_OVSDB_BST_DIRTY_HISTORY))
+      {
+        bst_ovsdb_snapshot_full_copy (p_db, &p_buf->snapshot);
+      }
+      else
+      {
+        bst_ovsdb_snapshot_dirty_copy (p_db, p_pub->dirty, p_buf->batch + 1,
+                                       completed, &p_buf->snapshot);
+      }
+      p_buf->batch = completed;
+      sbplugin_ovsdb_system_time_get (&p_buf->time);
+
+      __atomic_store_n (&p_pub->published, p_buf, __ATOMIC_SEQ_CST);
+    }
+  }
+  else if (NULL != p_pub->published)
+  {
+    /* nothing changed, the published snapshot is still current */
+    p_pub->published->batch = completed;
+  }
+
+  /* Open the next batch, recycling the oldest dirty map */
+  p_pub->batch = completed + 1;
+  memset (&p_pub->dirty[(completed + 1) % BVIEW_OVSDB_BST_DIRTY_HISTORY], 0,
+          sizeof (BVIEW_OVSDB_BST_DIRTY_MAP_t));
+}
+
+/*********************************************************************
+* @brief   Start publishing report ready snapshots for an asic
+*
+* @param[in]   asic        -  asic number
+* @param[in]   layout      -  Layout of the published snapshots
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_OUTOFMEMORY        Failed to allocate the buffers
+* @retval BVIEW_STATUS_FAILURE            Failed to get the snapshot lock
+* @retval BVIEW_STATUS_SUCCESS            Publication is enabled
+*
+* @notes    The first snapshot is published at the end of the next
+*           update batch.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_cache_publish_start (int asic,
+                                 const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout)
+{
+  BVIEW_OVSDB_BST_PUBLISH_t  *p_pub = NULL;
+  BVIEW_STATUS  rv = BVIEW_STATUS_SUCCESS;
+  void         *data = NULL;
+  size_t        words = 0;
+  int           i = 0;
+
+  SB_OVSDB_VALID_UNIT_CHECK(asic);
+  SB_OVSDB_NULLPTR_CHECK (layout, BVIEW_STATUS_INVALID_PARAMETER);
+
+  p_pub = &bst_ovsdb_cache.publish[asic];
+
+  if (pthread_mutex_lock (&bst_ovsdb_cache.snapshot_lock) != 0)
+  {
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  if (true == __atomic_load_n (&p_pub->enabled, __ATOMIC_ACQUIRE))
+  {
+    /* already publishing */
+    pthread_mutex_unlock (&bst_ovsdb_cache.snapshot_lock);
+    return BVIEW_STATUS_SUCCESS;
+  }
+
+  p_pub->layout = *layout;
+
+  /* one histogram for every 64 bit word of a snapshot */
+  words = layout->size / sizeof (uint64_t);
+  p_pub->histogram[0] = calloc (words, sizeof (BVIEW_BST_HISTOGRAM_t));
+  p_pub->histogram[1] = calloc (words, sizeof (BVIEW_BST_HISTOGRAM_t));
+  p_pub->histogram_active = 0;
+  sbplugin_ovsdb_system_time_get (&p_pub->histogram_start);
+  if ((NULL == p_pub->histogram[0]) || (NULL == p_pub->histogram[1]))
+  {
+    rv = BVIEW_STATUS_OUTOFMEMORY;
+  }
+
+  for (i = 0; (BVIEW_STATUS_SUCCESS == rv) && (i < BVIEW_OVSDB_BST_PUBLISH_BUFFERS); i++)
+  {
+    if (0 != posix_memalign (&data, BVIEW_BST_SNAPSHOT_ALIGN, layout->size))
+    {
+      rv = BVIEW_STATUS_OUTOFMEMORY;
+      break;
+    }
+    memset (data, 0, layout->size);
+    p_pub->buf[i].snapshot.layout = &p_pub->layout;
+    p_pub->buf[i].snapshot.data = data;
+    p_pub->buf[i].batch = 0;
+    p_pub->buf[i].refs = 0;
+  }
+
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    while (i-- > 0)
+    {
+      free (p_pub->buf[i].snapshot.data);
+      p_pub->buf[i].snapshot.data = NULL;
+    }
+    free (p_pub->histogram[0]);
+    free (p_pub->histogram[1]);
+    p_pub->histogram[0] = NULL;
+    p_pub->histogram[1] = NULL;
+  }
+  else
+  {
+    __atomic_store_n (&p_pub->enabled, true, __ATOMIC_RELEASE);
+  }
+
+  pthread_mutex_unlock (&bst_ovsdb_cache.snapshot_lock);
+  return rv;
+}
+
+/*********************************************************************
+* @brief   Take a reference to the latest published snapshot
+*
+* @param[in]   asic        -  asic number
+* @param[out]  snapshot    -  Published snapshot
+* @param[out]  time        -  Time the snapshot was published
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_NOTREADY           Nothing is published yet
+* @retval BVIEW_STATUS_SUCCESS            Reference is taken
+*
+* @notes    Lock free. The reference is only kept if the buffer is
+*           still the published one once it is counted, so the monitor
+*           thread never refills a buffer in use.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_cache_published_get (int asic,
+                                 const BVIEW_BST_ASIC_SNAPSHOT_DATA_t **snapshot,
+                                 BVIEW_TIME_t *time)
+{
+  BVIEW_OVSDB_BST_PUBLISH_t     *p_pub = NULL;
+  BVIEW_OVSDB_BST_PUBLISH_BUF_t *p_buf = NULL;
+
+  SB_OVSDB_VALID_UNIT_CHECK(asic);
+  SB_OVSDB_NULLPTR_CHECK (snapshot, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_OVSDB_NULLPTR_CHECK (time, BVIEW_STATUS_INVALID_PARAMETER);
+
+  p_pub = &bst_ovsdb_cache.publish[asic];
+
+  while (1)
+  {
+    p_buf = __atomic_load_n (&p_pub->published, __ATOMIC_SEQ_CST);
+    if (NULL == p_buf)
+    {
+      return BVIEW_STATUS_NOTREADY;
+    }
+    __atomic_fetch_add (&p_buf->refs, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n (&p_pub->published, __ATOMIC_SEQ_CST) == p_buf)
+    {
+      break;
+    }
+    /* swapped meanwhile, the buffer may be refilled already */
+    __atomic_fetch_sub (&p_buf->refs, 1, __ATOMIC_SEQ_CST);
+  }
+
+  *snapshot = &p_buf->snapshot;
+  *time = p_buf->time;
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief   Release a reference to a published snapshot
+*
+* @param[in]   asic        -  asic number
+* @param[in]   snapshot    -  Snapshot from bst_ovsdb_cache_published_get()
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Not a published snapshot
+* @retval BVIEW_STATUS_SUCCESS            Reference is released
+*
+* @notes    none
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_cache_published_put (int asic,
+                                 const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot)
+{
+  BVIEW_OVSDB_BST_PUBLISH_t  *p_pub = NULL;
+  int  i = 0;
+
+  SB_OVSDB_VALID_UNIT_CHECK(asic);
+  SB_OVSDB_NULLPTR_CHECK (snapshot, BVIEW_STATUS_INVALID_PARAMETER);
+
+  p_pub = &bst_ovsdb_cache.publish[asic];
+  for (i = 0; i < BVIEW_OVSDB_BST_PUBLISH_BUFFERS; i++)
+  {
+    if (&p_pub->buf[i].snapshot == snapshot)
+    {
+      __atomic_fetch_sub (&p_pub->buf[i].refs, 1, __ATOMIC_SEQ_CST);
+      return BVIEW_STATUS_SUCCESS;
+    }
+  }
+  return BVIEW_STATUS_INVALID_PARAMETER;
+}
+
+/*********************************************************************
+* @brief   Read, and optionally restart, the occupancy histograms
+*
+* @param[in]   asic        -  asic number
+* @param[out]  histogram   -  Histograms to be filled, NULL if they are
+*                             only to be restarted
+* @param[out]  time        -  Time the histograms started at
+* @param[in]   reset       -  Start new histograms once read
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_NOTREADY           Publication is not started yet
+* @retval BVIEW_STATUS_FAILURE            Failed to get the snapshot lock
+* @retval BVIEW_STATUS_SUCCESS            Histograms are read
+*
+* @notes    On a reset the monitor thread is switched over to the other
+*           set first, and the set read is cleared once no update batch
+*           can be counting in it any more. Without a reset the counts
+*           are read while they are updated, so counters may be one
+*           update batch apart.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_cache_histogram_get (int asic,
+                                 BVIEW_BST_ASIC_HISTOGRAM_DATA_t *histogram,
+                                 BVIEW_TIME_t *time, bool reset)
+{
+  BVIEW_OVSDB_BST_PUBLISH_t *p_pub = NULL;
+  BVIEW_BST_HISTOGRAM_t     *p_hist = NULL;
+  uint32_t                   active = 0;
+  size_t                     size = 0;
+
+  SB_OVSDB_VALID_UNIT_CHECK(asic);
+
+  p_pub = &bst_ovsdb_cache.publish[asic];
+
+  if (false == __atomic_load_n (&p_pub->enabled, __ATOMIC_ACQUIRE))
+  {
+    return BVIEW_STATUS_NOTREADY;
+  }
+
+  size = (p_pub->layout.size / sizeof (uint64_t)) * sizeof (BVIEW_BST_HISTOGRAM_t);
+
+  if ((NULL != histogram) &&
+      ((NULL == histogram->layout) || (NULL == histogram->data) ||
+       (histogram->layout->size != p_pub->layout.size)))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  /* readers are serialized like the snapshot readers */
+  if (pthread_mutex_lock (&bst_ovsdb_cache.snapshot_lock) != 0)
+  {
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  active = p_pub->histogram_active;
+  p_hist = p_pub->histogram[active];
+
+  if (true == reset)
+  {
+    /* new updates go to the other, cleared, set */
+    __atomic_store_n (&p_pub->histogram_active, active ^ 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence (__ATOMIC_SEQ_CST);
+    /* a batch which picked the set before the switch is done after this */
+    (void) bst_ovsdb_cache_read_begin ();
+  }
+
+  if (NULL != histogram)
+  {
+    memcpy (histogram->data, p_hist, size);
+  }
+  if (NULL != time)
+  {
+    *time = p_pub->histogram_start;
+  }
+
+  if (true == reset)
+  {
+    memset (p_hist, 0, size);
+    sbplugin_ovsdb_system_time_get (&p_pub->histogram_start);
+  }
+
+  pthread_mutex_unlock (&bst_ovsdb_cache.snapshot_lock);
+  return BVIEW_STATUS_SUCCESS;
+}
+
 /*********************************************************************
 * @brief   Get the pointer to BST data
 *
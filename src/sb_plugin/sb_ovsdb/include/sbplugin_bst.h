@@ -161,6 +161,100 @@ BVIEW_STATUS sbplugin_ovsdb_bst_snapshot_get (int asic,
                                  BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot, 
                                  BVIEW_TIME_t *time);
 
+/*********************************************************************
+* @brief  Bring a previously obtained ASIC statistics report up to date
+*
+* @param[in]      asic               - unit
+* @param[in,out]  snapshot           - snapshot data structure
+* @param[out]     time               - time
+* @param[in,out]  generation         - generation the snapshot is at,
+*                                      0 if it holds no data
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if snapshot get is failed.
+* @retval BVIEW_STATUS_SUCCESS           if snapshot get is success.
+*
+* @notes    Only the cache rows changed since 'generation' are copied.
+*
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_ovsdb_bst_snapshot_incremental_get (int asic,
+                                 BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                                 BVIEW_TIME_t *time,
+                                 uint64_t *generation);
+
+/*********************************************************************
+* @brief  Start publishing report ready ASIC statistics snapshots
+*
+* @param[in]      asic               - unit
+* @param[in]      layout             - layout of the published snapshots
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_OUTOFMEMORY       if buffers can't be allocated.
+* @retval BVIEW_STATUS_SUCCESS           if publication is started.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_ovsdb_bst_snapshot_publish_start (int asic,
+                                 const BVIEW_BST_SNAPSHOT_LAYOUT_t *layout);
+
+/*********************************************************************
+* @brief  Take a reference to the latest published ASIC statistics snapshot
+*
+* @param[in]      asic               - unit
+* @param[out]     snapshot           - published snapshot
+* @param[out]     time               - time of the snapshot
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_NOTREADY          if nothing is published yet.
+* @retval BVIEW_STATUS_SUCCESS           if reference is taken.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_ovsdb_bst_snapshot_published_get (int asic,
+                                 const BVIEW_BST_ASIC_SNAPSHOT_DATA_t **snapshot,
+                                 BVIEW_TIME_t *time);
+
+/*********************************************************************
+* @brief  Release a published ASIC statistics snapshot
+*
+* @param[in]      asic               - unit
+* @param[in]      snapshot           - published snapshot
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_SUCCESS           if reference is released.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_ovsdb_bst_snapshot_published_put (int asic,
+                                 const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot);
+
+/*********************************************************************
+* @brief  Obtain, and optionally restart, the occupancy histograms
+*
+* @param[in]      asic               - unit
+* @param[out]     histogram          - histograms, NULL to only restart them
+* @param[out]     time               - time the histograms started at
+* @param[in]      reset              - start new histograms once read
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_NOTREADY          if the histograms are not kept yet.
+* @retval BVIEW_STATUS_SUCCESS           if histograms are obtained.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_ovsdb_bst_histogram_get (int asic,
+                                 BVIEW_BST_ASIC_HISTOGRAM_DATA_t *histogram,
+                                 BVIEW_TIME_t *time, bool reset);
+
 /*********************************************************************
 * @brief  Obtain Device Statistics
 *
@@ -44,3 +44,53 @@ def get_ini_details(filename,section):
     config.read(filename)
     config_dict = dict(config.items(section))
     return config_dict
+
+def cbor_loads(data):
+    '''Decodes the CBOR of a report (unsigned integers, text, arrays, maps).'''
+
+    def item(pos):
+        major, info = ord(data[pos]) >> 5, ord(data[pos]) & 0x1f
+        pos += 1
+        if info == 31:
+            if major != 4: raise ValueError("unexpected indefinite item")
+            val = []
+            while ord(data[pos]) != 0xff:
+                sub, pos = item(pos)
+                val.append(sub)
+            return val, pos + 1
+        if info < 24:
+            arg = info
+        elif info <= 27:
+            size = 1 << (info - 24)
+            arg = 0
+            for b in data[pos:pos + size]:
+                arg = (arg << 8) | ord(b)
+            pos += size
+        else:
+            raise ValueError("invalid additional information %d" % info)
+        if major == 0:
+            return arg, pos
+        if major == 3:
+            return data[pos:pos + arg].decode('utf-8'), pos + arg
+        if major == 4:
+            val = []
+            for i in range(arg):
+                sub, pos = item(pos)
+                val.append(sub)
+            return val, pos
+        if major == 5:
+            val = {}
+            for i in range(arg):
+                key, pos = item(pos)
+                val[key], pos = item(pos)
+            return val, pos
+        raise ValueError("unexpected major type %d" % major)
+
+    val, pos = item(0)
+    return val
+
+''' realm ids of a CBOR report, see src/apps/bst/api/bst_cbor_encoder.h '''
+cbor_realm_names = [ "device", "ingress-port-priority-group", "ingress-port-service-pool",
+                     "ingress-service-pool", "egress-port-service-pool", "egress-service-pool",
+                     "egress-uc-queue", "egress-uc-queue-group", "egress-mc-queue",
+                     "egress-cpu-queue", "egress-rqe-queue" ]
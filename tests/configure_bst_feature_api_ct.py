@@ -98,6 +98,8 @@ class configure_bst_feature_api_ct(object):
     step17, step18 = step1, step2
     step19, step20 = step1, step2
     step21, step22 = step1, step2
+    step23, step24 = step1, step2
+    step25, step26 = step1, step2
 
     def getSteps(self):
         return sorted([ i for i in dir(self) if i.startswith('step') ], key=lambda item: int(item.replace('step','')))
@@ -86,6 +86,56 @@ class get_bst_report_api_ct(object):
 
     step12=step1
 
+    def step13(self,jsonData):
+        """Get BST Report in CBOR, compared to the JSON report"""
+        try:
+            resp = self.obj.postResponse(jsonData)
+            if resp[0] == "INVALID":
+                return "FAIL","Connection refused/Invalid JSON request... Please check the ip address provided in 'ini' file/BroadViewAgent is running or not/JSON data is valid or not ..."
+            jsonDict = json.loads(jsonData)
+            paramsDict = jsonDict['params']
+            del paramsDict['format']
+            jsonResp = self.obj.postResponse(json.dumps(jsonDict))
+        except Exception,e:
+            return "FAIL","Unable to perform the rest call with given JSON data, Occured Exception ... "+str(e)
+
+        if returnStatus(resp[0], 200)[0] == "FAIL": return "FAIL","Obtained {0}".format(resp[0])
+        if returnStatus(jsonResp[0], 200)[0] == "FAIL": return "FAIL","Obtained {0}".format(jsonResp[0])
+        if not resp[1]: return "FAIL","Got null response"
+        try:
+            report = cbor_loads(resp[1])
+        except Exception,e:
+            return "FAIL","Invalid CBOR Response data received ... "+str(e)
+        data_dict = json.loads(jsonResp[1].replace('Content-Type: text/json', ''))
+        if report.get(0) != data_dict['method'] or str(report.get(1)) != data_dict['asic-id']:
+            return "FAIL","Method or asic-id of the CBOR report differs from the JSON report"
+        realms = [ cbor_realm_names[r[0]] for r in report[4] ]
+        jsonRealms = [ r['realm'] for r in data_dict['report'] if 'realm' in r ]
+        msg="Realm(s) of the CBOR report " + " ".join(realms) + " differ from the JSON report"
+        return returnStatus(realms,jsonRealms,"",msg)
+
+    def step14(self,jsonData):
+        """Get BST Report of the top-k entries of each realm"""
+        try:
+            resp = self.obj.postResponse(jsonData)
+            if resp[0] == "INVALID":
+                return "FAIL","Connection refused/Invalid JSON request... Please check the ip address provided in 'ini' file/BroadViewAgent is running or not/JSON data is valid or not ..."
+        except Exception,e:
+            return "FAIL","Unable to perform the rest call with given JSON data, Occured Exception ... "+str(e)
+
+        if returnStatus(resp[0], 200)[0] == "FAIL": return "FAIL","Obtained {0}".format(resp[0])
+        if not resp[1]: return "FAIL","Got null response"
+        data_dict = json.loads(resp[1].replace('Content-Type: text/json', ''))
+        if not "report" in data_dict: return "FAIL","No Report key in Response JSON Data"
+        topK = json.loads(jsonData)['params']['top-k']
+        for r in data_dict['report']:
+            if r.get('realm') == 'device' or not isinstance(r.get('data'), list): continue
+            # entries of the port realms are grouped by port
+            entries = sum([ len(d['data']) if isinstance(d, dict) else 1 for d in r['data'] ])
+            if entries > topK:
+                return "FAIL","Realm {0} carries {1} entries, more than the top-k {2}".format(r['realm'], entries, topK)
+        return "PASS",""
+
     def getSteps(self):
         return sorted([ i for i in dir(self) if i.startswith('step') ], key=lambda item: int(item.replace('step','')))
 
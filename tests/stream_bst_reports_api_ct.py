@@ -0,0 +1,156 @@
+'''
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+'''
+
+#!/usr/bin/env python
+
+import os
+import sys
+
+import ConfigParser
+import httplib
+import json
+import pprint
+
+from bstUtil import *
+
+from BstRestService import *
+import bstRest as rest
+
+class stream_bst_reports_api_ct(object):
+
+    def __init__(self,ip,port,params="",debug=False):
+        self.obj = BstRestService(ip,port)
+        self.ip = ip
+        self.port = port
+        self.debug = debug
+        self.params = params
+
+    def step1(self,jsonData):
+        """Configure BST feature with periodic reports every second"""
+        try:
+            pprint.pprint(jsonData)
+            resp = self.obj.postResponse(jsonData)
+            if resp[0] == "INVALID":
+                return "FAIL","Connection refused/Invalid JSON request... Please check the ip address provided in 'ini' file/BroadViewAgent is running or not/JSON data is valid or not ..."
+        except Exception,e:
+            return "FAIL","Unable to perform the rest call with given JSON data, Occured Exception ... "+str(e)
+
+        try:
+            self.obj.debugJsonPrint(self.debug,jsonData,resp)
+        except:
+            return "FAIL","Invalid JSON Response data received"
+
+        if returnStatus(resp[0], 200)[0] == "FAIL": return "FAIL","Obtained {0}".format(resp[0])
+        return returnStatus(resp[0], 200,"","Unable to get the 200 OK response, got reponse "+str(resp[0]))
+
+    def step2(self,jsonData):
+        """Stream the BST reports of the device realm"""
+        pprint.pprint(jsonData)
+        try:
+            conn = httplib.HTTPConnection(self.ip, int(self.port), timeout=10)
+            conn.request("POST", self.obj.getURL()+"stream-bst-reports", jsonData,
+                         {"Content-type": "application/json", "Accept": "text/event-stream"})
+            response = conn.getresponse()
+        except Exception,e:
+            return "FAIL","Unable to perform the rest call with given JSON data, Occured Exception ... "+str(e)
+
+        if response.status != 200:
+            conn.close()
+            return "FAIL","Unable to get the 200 OK response, got reponse "+str(response.status)
+        if not response.getheader("Content-Type","").startswith("text/event-stream"):
+            conn.close()
+            return "FAIL","Obtained content type {0}".format(response.getheader("Content-Type",""))
+
+        # the stream is read till the first periodic report
+        event, data = "", []
+        try:
+            while True:
+                line = response.fp.readline()
+                if not line:
+                    break
+                line = line.rstrip("\n")
+                if line.startswith("event: "):
+                    event = line[len("event: "):]
+                elif line.startswith("data: "):
+                    data.append(line[len("data: "):])
+                elif line == "" and event == "periodic":
+                    break
+                elif line == "":
+                    event, data = "", []
+        except Exception,e:
+            conn.close()
+            return "FAIL","No periodic report streamed, Occured Exception ... "+str(e)
+        conn.close()
+
+        try:
+            data_dict = json.loads("\n".join(data))
+        except:
+            return "FAIL","Invalid JSON report streamed"
+        if not "report" in data_dict: return "FAIL","No Report key in the streamed report"
+        realms = sorted(set([ r['realm'] for r in data_dict['report'] if 'realm' in r ]))
+        msg="Realm(s) " + " ".join(realms) + " streamed besides device"
+        return returnStatus(realms in ([], ["device"]),True,"",msg)
+
+    def step3(self,jsonData):
+        """Stream the BST reports of an unknown realm"""
+        try:
+            pprint.pprint(jsonData)
+            resp = self.obj.postResponse(jsonData)
+            if resp[0] == "INVALID":
+                return "FAIL","Connection refused/Invalid JSON request... Please check the ip address provided in 'ini' file/BroadViewAgent is running or not/JSON data is valid or not ..."
+        except Exception,e:
+            return "FAIL","Unable to perform the rest call with given JSON data, Occured Exception ... "+str(e)
+
+        return returnStatus(resp[0] != 200,True,"","A stream is started for an unknown realm")
+
+    step4 = step1
+
+    def getSteps(self):
+        return sorted([ i for i in dir(self) if i.startswith('step') ], key=lambda item: int(item.replace('step','')))
+
+def main(ip_address,port):
+    jsonText = ConfigParser.ConfigParser()
+    cwdir, f = os.path.split(__file__)
+    jsonText.read(cwdir + '/testCaseJsonStrings.ini')
+    json_dict = dict(jsonText.items('stream_bst_reports_api_ct'))
+    params=json_dict.get("paramslist","")
+
+    tcObj = stream_bst_reports_api_ct(ip_address,port,params,debug=True)
+
+    stepResultMap = {}
+    printStepHeader()
+    for step in tcObj.getSteps():
+        if step in json_dict:
+            resp=getattr(tcObj,step)(json_dict[step])
+            desc=getattr(tcObj,step).__doc__
+            stepResultMap[step] = resp
+            printStepResult(step,desc,resp[0], resp[1])
+        else:
+            resp=getattr(tcObj,step)()
+            desc=""
+            stepResultMap[step] = resp
+            printStepResult(step,desc,resp[0], resp[1])
+        if resp[0] == 'FAIL': break
+    printStepFooter()
+    statusMsgTuple = [ s for s in stepResultMap.values() if s[0] == "FAIL" ]
+    if statusMsgTuple:
+        return False, statusMsgTuple[0][1]
+    return True, "Test Case Passed"
+
+if __name__ == '__main__':
+    main()
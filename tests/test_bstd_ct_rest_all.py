@@ -53,9 +53,14 @@ import get_bst_feature_api_ct
 import get_bst_tracking_api_ct
 import get_bst_thresholds_api_ct
 import get_bst_report_api_ct
+import get_bst_history_api_ct
+import get_bst_histogram_api_ct
 import clear_bst_statistics_api_ct
 import clear_bst_thresholds_api_ct
 import configure_bst_feature_api_ct
+import configure_bst_subscription_api_ct
+import stream_bst_reports_api_ct
+import configure_bst_udp_export_api_ct
 import configure_bst_tracking_api_ct
 import configure_bst_thresholds_api_ct
 
@@ -109,10 +114,30 @@ class bstTest( OpsVsiTest ):
         result,message = get_bst_report_api_ct.main(self.ip_address,self.port)
         assert result,message
 
+    def get_bst_history(self):
+        result,message = get_bst_history_api_ct.main(self.ip_address,self.port)
+        assert result,message
+
+    def get_bst_histogram(self):
+        result,message = get_bst_histogram_api_ct.main(self.ip_address,self.port)
+        assert result,message
+
     def configure_bst_feature(self):
         result,message = configure_bst_feature_api_ct.main(self.ip_address,self.port)
         assert result,message
 
+    def configure_bst_subscription(self):
+        result,message = configure_bst_subscription_api_ct.main(self.ip_address,self.port)
+        assert result,message
+
+    def stream_bst_reports(self):
+        result,message = stream_bst_reports_api_ct.main(self.ip_address,self.port)
+        assert result,message
+
+    def configure_bst_udp_export(self):
+        result,message = configure_bst_udp_export_api_ct.main(self.ip_address,self.port)
+        assert result,message
+
     def configure_bst_tracking(self):
         result,message = configure_bst_tracking_api_ct.main(self.ip_address,self.port)
         assert result,message
@@ -250,9 +275,24 @@ class Test_bstd:
     def test_get_bst_report(self):
         self.test.get_bst_report()
 
+    def test_get_bst_history(self):
+        self.test.get_bst_history()
+
+    def test_get_bst_histogram(self):
+        self.test.get_bst_histogram()
+
     def test_configure_bst_feature(self):
         self.test.configure_bst_feature()
 
+    def test_configure_bst_subscription(self):
+        self.test.configure_bst_subscription()
+
+    def test_stream_bst_reports(self):
+        self.test.stream_bst_reports()
+
+    def test_configure_bst_udp_export(self):
+        self.test.configure_bst_udp_export()
+
     def test_configure_bst_tracking(self):
         self.test.configure_bst_tracking()
 